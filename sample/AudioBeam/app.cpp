@@ -25,22 +25,20 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
+        [&]( Frame& frame ){ show( frame ); },
         // Key Check
-        if( GetKeyState( VK_ESCAPE ) < 0 ){
-            break;
-        }
-    }
+        [&](){ return GetKeyState( VK_ESCAPE ) >= 0; }
+    );
+
+    // Show Latency of Pipeline Stages
+    pipeline.printStatistics( std::cout );
 }
 
 // Initialize
@@ -93,20 +91,20 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Audio
-    updateAudio();
+    return updateAudio( frame );
 }
 
 // Update Audio
-inline void Kinect::updateAudio()
+inline bool Kinect::updateAudio( Frame& frame )
 {
     // Retrieve Audio Beam Frame List
     ComPtr<IAudioBeamFrameList> audioBeamFrameList;
     const HRESULT ret = audioBeamFrameReader->AcquireLatestBeamFrames( &audioBeamFrameList );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
     //  Retrieve Audio Beam Frame Count
@@ -128,52 +126,54 @@ inline void Kinect::updateAudio()
             ERROR_CHECK( audioBeamFrame->GetSubFrame( j, &audioBeamSubFrame ) );
 
             // Retrieve Beam Angle ( Radian +/- 1.0 )
-            ERROR_CHECK( audioBeamSubFrame->get_BeamAngle( &beamAngle ) );
+            ERROR_CHECK( audioBeamSubFrame->get_BeamAngle( &frame.beamAngle ) );
 
             // Retrieve Beam Angle Confidence ( 0.0 - 1.0 )
-            ERROR_CHECK( audioBeamSubFrame->get_BeamAngleConfidence( &beamAngleConfidence ) );
+            ERROR_CHECK( audioBeamSubFrame->get_BeamAngleConfidence( &frame.beamAngleConfidence ) );
         } );
     } );
+
+    return true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Audio
-    drawAudio();
+    drawAudio( frame );
 }
 
 // Draw Audio
-inline void Kinect::drawAudio()
+inline void Kinect::drawAudio( Frame& frame )
 {
     // Clear Beam Angle Result Buffer
-    beamAngleResult.clear();
+    frame.beamAngleResult.clear();
 
     // Check Beam Angle Confidence
-    if( beamAngleConfidence > confidenceThreshold ){
+    if( frame.beamAngleConfidence > confidenceThreshold ){
         // Convert Degree from Radian
-        const float degree = static_cast<float>( beamAngle * 180.0 / M_PI );
+        const float degree = static_cast<float>( frame.beamAngle * 180.0 / M_PI );
 
         // Add Beam Angle to Result Buffer
-        beamAngleResult = std::to_string( degree ) + " (" + std::to_string( beamAngleConfidence ) + ")";
+        frame.beamAngleResult = std::to_string( degree ) + " (" + std::to_string( frame.beamAngleConfidence ) + ")";
     }
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Audio
-    showAudio();
+    showAudio( frame );
 }
 
 // Show Audio
-inline void Kinect::showAudio()
+inline void Kinect::showAudio( Frame& frame )
 {
     // Check Empty Result Buffer
-    if( !beamAngleResult.size() ){
+    if( !frame.beamAngleResult.size() ){
         return;
     }
 
     // Show Result
-    std::cout << beamAngleResult << std::endl;
+    std::cout << frame.beamAngleResult << std::endl;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #define _USE_MATH_DEFINES
 #include <Windows.h>
 #include <Kinect.h>
+#include "Pipeline.h"
 
 #include <string>
 
@@ -20,11 +21,19 @@ private:
     ComPtr<IAudioBeamFrameReader> audioBeamFrameReader;
 
     // Audio Buffer
-    float beamAngle = 0.f;
-    float beamAngleConfidence = 0.f;
-    std::string beamAngleResult;
     const float confidenceThreshold = 0.3f;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Audio is Updated )
+    struct Frame
+    {
+        float beamAngle = 0.f;
+        float beamAngleConfidence = 0.f;
+        std::string beamAngleResult;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
 public:
     // Constructor
     Kinect();
@@ -49,22 +58,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Audio
-    inline void updateAudio();
+    inline bool updateAudio( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Audio
-    inline void drawAudio();
+    inline void drawAudio( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Audio
-    inline void showAudio();
+    inline void showAudio( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
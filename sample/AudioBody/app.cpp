@@ -4,11 +4,14 @@
 #include <thread>
 #include <chrono>
 #include <limits>
+#include <iostream>
 
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -24,23 +27,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -89,6 +90,9 @@ inline void Kinect::initializeAudio()
 
     // Open Audio Beam Reader
     ERROR_CHECK( audioSource->OpenReader( &audioBeamFrameReader ) );
+
+    // Initialize Tracking Index
+    audioTrackingIndex = -1;
 }
 
 // Initialize Body
@@ -119,8 +123,12 @@ inline void Kinect::initializeBodyIndex()
     ERROR_CHECK( bodyIndexFrameDescription->get_Width( &bodyIndexWidth ) ); // 512
     ERROR_CHECK( bodyIndexFrameDescription->get_Height( &bodyIndexHeight ) ); // 424
 
-    // Allocation BodyIndex Buffer
-    bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+    // Allocation BodyIndex Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+        frame.bodyIndexUpdated = false;
+        frame.audioTrackingIndex = -1;
+    } );
 
     // Color Table for Visualization
     colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
@@ -148,7 +156,7 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Audio
     updateAudio();
@@ -157,7 +165,18 @@ void Kinect::update()
     updateBody();
 
     // Update BodyIndex
-    updateBodyIndex();
+    updateBodyIndex( frame );
+
+    // Wait until BodyIndex is Updated
+    if( !frame.bodyIndexUpdated ){
+        return false;
+    }
+
+    // Pass Tracking Index found since Previous Frame, and Initialize Tracking Index for Next Frame
+    frame.bodyIndexUpdated = false;
+    frame.audioTrackingIndex = audioTrackingIndex;
+    audioTrackingIndex = -1;
+    return true;
 }
 
 // Update Audio
@@ -213,9 +232,6 @@ inline void Kinect::updateAudio()
 // Update Body
 inline void Kinect::updateBody()
 {
-    // Initialize Tracking Index
-    audioTrackingIndex = -1;
-
     // Check Tracking ID
     if( audioTrackingId == std::numeric_limits<unsigned long long>::max() - 1 ){
         return;
@@ -250,7 +266,7 @@ inline void Kinect::updateBody()
 }
 
 // Update BodyIndex
-inline void Kinect::updateBodyIndex()
+inline void Kinect::updateBodyIndex( Frame& frame )
 {
 
     // Retrieve BodyIndex Frame
@@ -261,25 +277,30 @@ inline void Kinect::updateBodyIndex()
     }
 
     // Retrieve BodyIndex Data
-    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( bodyIndexBuffer.size() ), &bodyIndexBuffer[0] ) );
+    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( frame.bodyIndexBuffer.size() ), &frame.bodyIndexBuffer[0] ) );
+    frame.bodyIndexUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw BodyIndex
-    drawBodyIndex();
+    drawBodyIndex( frame );
 }
 
 // Draw BodyIndex
-inline void Kinect::drawBodyIndex()
+inline void Kinect::drawBodyIndex( Frame& frame )
 {
     // Check Tracking Index
+    const int audioTrackingIndex = frame.audioTrackingIndex;
     if( audioTrackingIndex == -1 ){
+        frame.bodyIndexMat = cv::Mat();
         return;
     }
 
     // Visualization BodyIndex
+    const std::vector<BYTE>& bodyIndexBuffer = frame.bodyIndexBuffer;
+    cv::Mat& bodyIndexMat = frame.bodyIndexMat;
     bodyIndexMat = cv::Mat::zeros( bodyIndexHeight, bodyIndexWidth, CV_8UC3 );
     bodyIndexMat.forEach<cv::Vec3b>( [&]( cv::Vec3b &p, const int* position ){
         uchar index = bodyIndexBuffer[position[0] * bodyIndexWidth + position[1]];
@@ -290,19 +311,20 @@ inline void Kinect::drawBodyIndex()
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show BodyIndex
-    showBodyIndex();
+    showBodyIndex( frame );
 }
 
 // Show BodyIndex
-inline void Kinect::showBodyIndex()
+inline void Kinect::showBodyIndex( Frame& frame )
 {
+    const cv::Mat& bodyIndexMat = frame.bodyIndexMat;
     if( bodyIndexMat.empty() ){
         return;
     }
 
     // Show Image
-    cv::imshow( "AudiBody", bodyIndexMat );
+    sink->write( "AudiBody", bodyIndexMat );
 }
\ No newline at end of file
@@ -4,9 +4,13 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -26,19 +30,35 @@ private:
     std::array<IBody*, BODY_COUNT> bodies = { nullptr };
 
     // BodyIndex Buffer
-    std::vector<BYTE> bodyIndexBuffer;
     int bodyIndexWidth;
     int bodyIndexHeight;
-    cv::Mat bodyIndexMat;
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
     // Audio Buffer
     UINT64 audioTrackingId;
     int audioTrackingIndex;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when BodyIndex is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> bodyIndexBuffer;
+        bool bodyIndexUpdated;
+        int audioTrackingIndex;
+        cv::Mat bodyIndexMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -66,31 +86,31 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Body
     inline void updateBody();
 
     // Update BodyIndex
-    inline void updateBodyIndex();
+    inline void updateBodyIndex( Frame& frame );
 
     // Update Audio
     inline void updateAudio();
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw BodyIndex
-    inline void drawBodyIndex();
+    inline void drawBodyIndex( Frame& frame );
 
     // Draw Audio
     inline void drawAudio();
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show BodyIndex
-    inline void showBodyIndex();
+    inline void showBodyIndex( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -3,11 +3,14 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -23,23 +26,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -94,8 +95,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -106,9 +110,12 @@ inline void Kinect::initializeBody()
     ERROR_CHECK( kinect->get_BodyFrameSource( &bodyFrameSource ) );
     ERROR_CHECK( bodyFrameSource->OpenReader( &bodyFrameReader ) );
 
-    // Initialize Body Buffer
-    Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
-        SafeRelease( body );
+    // Initialize Body Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        Concurrency::parallel_for_each( frame.bodies.begin(), frame.bodies.end(), []( IBody*& body ){
+            SafeRelease( body );
+        } );
+        frame.bodyUpdated = false;
     } );
 
     // Color Table for Visualization
@@ -125,9 +132,11 @@ void Kinect::finalize()
 {
     cv::destroyAllWindows();
 
-    // Release Body Buffer
-    Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
-        SafeRelease( body );
+    // Release Body Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        Concurrency::parallel_for_each( frame.bodies.begin(), frame.bodies.end(), []( IBody*& body ){
+            SafeRelease( body );
+        } );
     } );
 
     // Close Sensor
@@ -137,17 +146,26 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
-    updateBody();
+    updateBody( frame );
+
+    // Wait until Both Color and Body are Updated
+    if( !frame.colorUpdated || !frame.bodyUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.bodyUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -157,11 +175,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
-inline void Kinect::updateBody()
+inline void Kinect::updateBody( Frame& frame )
 {
     // Retrieve Body Frame
     ComPtr<IBodyFrame> bodyFrame;
@@ -170,35 +189,40 @@ inline void Kinect::updateBody()
         return;
     }
 
-    // Release Previous Bodies
+    // Release Previous Bodies of This Frame
+    std::array<IBody*, BODY_COUNT>& bodies = frame.bodies;
     Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
         SafeRelease( body );
     } );
 
     // Retrieve Body Data
     ERROR_CHECK( bodyFrame->GetAndRefreshBodyData( static_cast<UINT>( bodies.size() ), &bodies[0] ) );
+    frame.bodyUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Body
-    drawBody();
+    drawBody( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 }
 
 // Draw Body
-inline void Kinect::drawBody()
+inline void Kinect::drawBody( Frame& frame )
 {
+    const std::array<IBody*, BODY_COUNT>& bodies = frame.bodies;
+    cv::Mat& colorMat = frame.colorMat;
+
     // Draw Body Data to Color Data
     Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
         const ComPtr<IBody> body = bodies[count];
@@ -312,15 +336,16 @@ inline void Kinect::drawHandState( cv::Mat& image, const Joint& joint, HandState
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Body
-    showBody();
+    showBody( frame );
 }
 
 // Show Body
-inline void Kinect::showBody()
+inline void Kinect::showBody( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -331,5 +356,5 @@ inline void Kinect::showBody()
     cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
 
     // Show Image
-    cv::imshow( "Body", resizeMat );
+    sink->write( "Body", resizeMat );
 }
\ No newline at end of file
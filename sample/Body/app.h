@@ -4,9 +4,13 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -25,19 +29,35 @@ private:
     ComPtr<IBodyFrameReader> bodyFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Body Buffer
-    std::array<IBody*, BODY_COUNT> bodies = { nullptr };
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Body are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::array<IBody*, BODY_COUNT> bodies = { nullptr };
+        bool colorUpdated;
+        bool bodyUpdated;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -62,22 +82,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
-    inline void updateBody();
+    inline void updateBody( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Body
-    inline void drawBody();
+    inline void drawBody( Frame& frame );
 
     // Draw Circle
     inline void drawEllipse( cv::Mat& image, const Joint& joint, const int radius, const cv::Vec3b& color, const int thickness = -1 );
@@ -86,10 +106,10 @@ private:
     inline void drawHandState( cv::Mat& image, const Joint& joint, HandState handState, TrackingConfidence handConfidence );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Body
-    inline void showBody();
+    inline void showBody( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -3,9 +3,12 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -21,23 +24,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -86,8 +87,14 @@ inline void Kinect::initializeBodyIndex()
     ERROR_CHECK( bodyIndexFrameDescription->get_Height( &bodyIndexHeight ) ); // 424
     ERROR_CHECK( bodyIndexFrameDescription->get_BytesPerPixel( &bodyIndexBytesPerPixel ) ); // 1
 
-    // Allocation BodyIndex Buffer
-    bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+    // Allocation Visualization Frame Buffers ( One Buffer per Frame )
+    bodyIndexPool.allocate( bodyIndexWidth * bodyIndexHeight * sizeof( cv::Vec3b ), pipeline.size() );
+
+    // Allocation BodyIndex Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+        frame.bodyIndexFrameBuffer = bodyIndexPool.acquire();
+    } );
 
     // Color Table for Visualization
     colors[0] = cv::Vec3b( 255,   0,   0 ); // Blue
@@ -110,56 +117,62 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update BodyIndex
-    updateBodyIndex();
+    return updateBodyIndex( frame );
 }
 
 // Update BodyIndex
-inline void Kinect::updateBodyIndex()
+inline bool Kinect::updateBodyIndex( Frame& frame )
 {
     // Retrieve BodyIndex Frame
     ComPtr<IBodyIndexFrame> bodyIndexFrame;
     const HRESULT ret = bodyIndexFrameReader->AcquireLatestFrame( &bodyIndexFrame );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
     // Retrieve BodyIndex Data
-    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( bodyIndexBuffer.size() ), &bodyIndexBuffer[0] ) );
+    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( frame.bodyIndexBuffer.size() ), &frame.bodyIndexBuffer[0] ) );
+
+    return true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw BodyIndex
-    drawBodyIndex();
+    drawBodyIndex( frame );
 }
 
 // Draw BodyIndex
-inline void Kinect::drawBodyIndex()
+inline void Kinect::drawBodyIndex( Frame& frame )
 {
     // Visualization Color to Each Index
-    bodyIndexMat = cv::Mat::zeros( bodyIndexHeight, bodyIndexWidth, CV_8UC3 );
-    bodyIndexMat.forEach<cv::Vec3b>( [&]( cv::Vec3b &p, const int* position ){
+    const std::vector<BYTE>& bodyIndexBuffer = frame.bodyIndexBuffer;
+    frame.bodyIndexMat = cv::Mat( bodyIndexHeight, bodyIndexWidth, CV_8UC3, frame.bodyIndexFrameBuffer.data() );
+    frame.bodyIndexMat.forEach<cv::Vec3b>( [&]( cv::Vec3b &p, const int* position ){
         uchar index = bodyIndexBuffer[position[0] * bodyIndexWidth + position[1]];
         if( index != 0xff ){
             p = colors[index];
         }
+        else{
+            p = cv::Vec3b::all( 0 );
+        }
     } );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show BodyIndex
-    showBodyIndex();
+    showBodyIndex( frame );
 }
 
 // Show BodyIndex
-inline void Kinect::showBodyIndex()
+inline void Kinect::showBodyIndex( Frame& frame )
 {
     // Show Image
-    cv::imshow( "BodyIndex", bodyIndexMat );
+    sink->write( "BodyIndex", frame.bodyIndexMat );
 }
\ No newline at end of file
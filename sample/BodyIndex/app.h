@@ -4,8 +4,13 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "FramePool.h"
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -22,16 +27,34 @@ private:
     ComPtr<IBodyIndexFrameReader> bodyIndexFrameReader;
 
     // BodyIndex Buffer
-    std::vector<BYTE> bodyIndexBuffer;
     int bodyIndexWidth;
     int bodyIndexHeight;
     unsigned int bodyIndexBytesPerPixel;
-    cv::Mat bodyIndexMat;
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
+    // Frame Buffer Pool
+    FramePool bodyIndexPool;
+
+    // Frame ( Buffers Passed between Pipeline Stages )
+    struct Frame
+    {
+        std::vector<BYTE> bodyIndexBuffer;
+        FrameBuffer bodyIndexFrameBuffer;
+        cv::Mat bodyIndexMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -53,22 +76,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update BodyIndex
-    inline void updateBodyIndex();
+    inline bool updateBodyIndex( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw BodyIndex
-    inline void drawBodyIndex();
+    inline void drawBodyIndex( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show BodyIndex
-    inline void showBodyIndex();
+    inline void showBodyIndex( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 
 #include <ppl.h>
 
@@ -11,7 +12,9 @@
 //#define DEPTH
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -27,23 +30,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -63,6 +64,9 @@ void Kinect::initialize()
     // Initialize BodyIndex
     initializeBodyIndex();
 
+    // Initialize Frame Buffer Pool
+    initializeFramePool();
+
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
 }
@@ -101,8 +105,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Depth
@@ -120,8 +127,28 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameDescription->get_Height( &depthHeight ) ); // 424
     ERROR_CHECK( depthFrameDescription->get_BytesPerPixel( &depthBytesPerPixel ) ); // 2
 
-    // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    // Allocation Depth Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.depthUpdated = false;
+    } );
+}
+
+// Initialize Registration
+inline void Kinect::initializeRegistration()
+{
+    // Retrieve Mapped Coordinates at Two Constant Depths
+    const UINT16 nearDepth = 500; // [mm]
+    const UINT16 farDepth = 4500; // [mm]
+    std::vector<UINT16> nearDepthBuffer( depthWidth * depthHeight, nearDepth );
+    std::vector<UINT16> farDepthBuffer( depthWidth * depthHeight, farDepth );
+    std::vector<ColorSpacePoint> nearPoints( depthWidth * depthHeight );
+    std::vector<ColorSpacePoint> farPoints( depthWidth * depthHeight );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( nearDepthBuffer.size(), &nearDepthBuffer[0], nearPoints.size(), &nearPoints[0] ) );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( farDepthBuffer.size(), &farDepthBuffer[0], farPoints.size(), &farPoints[0] ) );
+
+    // Build Calibration Tables
+    registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, &nearPoints[0], nearDepth, &farPoints[0], farDepth );
 }
 
 // Initialize BodyIndex
@@ -139,8 +166,40 @@ inline void Kinect::initializeBodyIndex()
     ERROR_CHECK( bodyIndexFrameDescription->get_Height( &bodyIndexHeight ) ); // 424
     ERROR_CHECK( bodyIndexFrameDescription->get_BytesPerPixel( &bodyIndexBytesPerPixel ) ); // 1
 
-    // Allocation BodyIndex Buffer
-    bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+    // Allocation BodyIndex Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.bodyIndexBuffer.resize( bodyIndexWidth * bodyIndexHeight );
+        frame.bodyIndexUpdated = false;
+    } );
+}
+
+// Initialize Frame Buffer Pool
+inline void Kinect::initializeFramePool()
+{
+#ifdef COLOR
+    // Allocation BodyIndex and ChromaKey Frame Buffers ( Color Resolution, One Buffer per Frame )
+    bodyIndexPool.allocate( colorWidth * colorHeight * bodyIndexBytesPerPixel, pipeline.size() );
+    chromaKeyPool.allocate( colorWidth * colorHeight * colorBytesPerPixel, pipeline.size() );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.bodyIndexFrameBuffer = bodyIndexPool.acquire();
+        frame.chromaKeyFrameBuffer = chromaKeyPool.acquire();
+    } );
+    bodyIndexSpacePoints.resize( colorWidth * colorHeight );
+
+    // Allocation Show Buffer ( Image Kernel Writes into It )
+    const double scale = 0.5;
+    resizeMat.create( static_cast<int>( colorHeight * scale ), static_cast<int>( colorWidth * scale ), CV_8UC4 );
+#endif
+
+#ifdef DEPTH
+    // Allocation Color and ChromaKey Frame Buffers ( Depth Resolution, One Buffer per Frame )
+    colorPool.allocate( depthWidth * depthHeight * colorBytesPerPixel, pipeline.size() );
+    chromaKeyPool.allocate( depthWidth * depthHeight * colorBytesPerPixel, pipeline.size() );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorFrameBuffer = colorPool.acquire();
+        frame.chromaKeyFrameBuffer = chromaKeyPool.acquire();
+    } );
+#endif
 }
 
 // Finalize
@@ -155,20 +214,30 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Depth
-    updateDepth();
+    updateDepth( frame );
 
     // Update BodyIndex
-    updateBodyIndex();
+    updateBodyIndex( frame );
+
+    // Wait until Color, Depth and BodyIndex are Updated
+    if( !frame.colorUpdated || !frame.depthUpdated || !frame.bodyIndexUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.depthUpdated = false;
+    frame.bodyIndexUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -178,11 +247,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Depth
-inline void Kinect::updateDepth()
+inline void Kinect::updateDepth( Frame& frame )
 {
     // Retrieve Depth Frame
     ComPtr<IDepthFrame> depthFrame;
@@ -192,11 +262,12 @@ inline void Kinect::updateDepth()
     }
 
     // Retrieve Depth Data
-    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( frame.depthBuffer.size() ), &frame.depthBuffer[0] ) );
+    frame.depthUpdated = true;
 }
 
 // Update BodyIndex
-inline void Kinect::updateBodyIndex()
+inline void Kinect::updateBodyIndex( Frame& frame )
 {
     // Retrieve BodyIndex Frame
     ComPtr<IBodyIndexFrame> bodyIndexFrame;
@@ -206,146 +277,120 @@ inline void Kinect::updateBodyIndex()
     }
 
     // Retrieve BodyIndex Data
-    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( bodyIndexBuffer.size() ), &bodyIndexBuffer[0] ) );
+    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( frame.bodyIndexBuffer.size() ), &frame.bodyIndexBuffer[0] ) );
+    frame.bodyIndexUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw BodyIndex
-    drawBodyIndex();
+    drawBodyIndex( frame );
 
     // Draw ChromaKey
-    drawChromaKey();
+    drawChromaKey( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
 #ifdef COLOR
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 #endif
 
 #ifdef DEPTH
-    // Retrieve Mapped Coordinates
-    std::vector<ColorSpacePoint> colorSpacePoints( depthWidth * depthHeight );
-    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( depthBuffer.size(), &depthBuffer[0], colorSpacePoints.size(), &colorSpacePoints[0] ) );
+    // Initialize Registration after Coordinate Mapper Received Calibration from Sensor
+    if( !registration.isInitialized() ){
+        initializeRegistration();
+        if( !registration.isInitialized() ){
+            frame.colorMat = cv::Mat();
+            return;
+        }
+    }
 
     // Mapping Color to Depth Resolution
-    std::vector<BYTE> buffer( depthWidth * depthHeight * colorBytesPerPixel );
-
-    Concurrency::parallel_for( 0, depthHeight, [&]( const int depthY ){
-        const unsigned int depthOffset = depthY * depthWidth;
-        for( int depthX = 0; depthX < depthWidth; depthX++ ){
-            unsigned int depthIndex = depthOffset + depthX;
-            const int colorX = static_cast<int>( colorSpacePoints[depthIndex].X + 0.5f );
-            const int colorY = static_cast<int>( colorSpacePoints[depthIndex].Y + 0.5f );
-            if( ( 0 <= colorX ) && ( colorX < colorWidth ) && ( 0 <= colorY ) && ( colorY < colorHeight ) ){
-                const unsigned int colorIndex = ( colorY * colorWidth + colorX ) * colorBytesPerPixel;
-                depthIndex = depthIndex * colorBytesPerPixel;
-                buffer[depthIndex + 0] = colorBuffer[colorIndex + 0];
-                buffer[depthIndex + 1] = colorBuffer[colorIndex + 1];
-                buffer[depthIndex + 2] = colorBuffer[colorIndex + 2];
-                buffer[depthIndex + 3] = colorBuffer[colorIndex + 3];
-            }
-        }
-    } );
+    registration.registerColor( &frame.depthBuffer[0], &frame.colorBuffer[0], frame.colorFrameBuffer.ptr<BYTE>() );
 
-    // Create cv::Mat from Coordinate Buffer
-    colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, &buffer[0] ).clone();
+    // Create cv::Mat from Frame Buffer
+    frame.colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, frame.colorFrameBuffer.data() );
 #endif
 }
 
 // Draw BodyIndex
-inline void Kinect::drawBodyIndex()
+inline void Kinect::drawBodyIndex( Frame& frame )
 {
 #ifdef COLOR
     // Retrieve Mapped Coordinates
-    std::vector<DepthSpacePoint> bodyIndexSpacePoints( colorWidth * colorHeight );
-    ERROR_CHECK( coordinateMapper->MapColorFrameToDepthSpace( depthBuffer.size(), &depthBuffer[0], bodyIndexSpacePoints.size(), &bodyIndexSpacePoints[0] ) );
+    ERROR_CHECK( coordinateMapper->MapColorFrameToDepthSpace( frame.depthBuffer.size(), &frame.depthBuffer[0], bodyIndexSpacePoints.size(), &bodyIndexSpacePoints[0] ) );
 
     // Mapping BodyIndex to Color Resolution
-    std::vector<BYTE> buffer( colorWidth * colorHeight, 0xff );
+    const std::vector<BYTE>& bodyIndexBuffer = frame.bodyIndexBuffer;
+    BYTE* buffer = frame.bodyIndexFrameBuffer.ptr<BYTE>();
 
     Concurrency::parallel_for( 0, colorHeight, [&]( const int colorY ){
-        const unsigned int colorOffset = colorY * colorWidth;
-        for( int colorX = 0; colorX < colorWidth; colorX++ ){
-            const unsigned int colorIndex = colorOffset + colorX;
-            const int bodyIndexX = static_cast<int>( bodyIndexSpacePoints[colorIndex].X + 0.5f );
-            const int bodyIndexY = static_cast<int>( bodyIndexSpacePoints[colorIndex].Y + 0.5f );
-            if( ( 0 <= bodyIndexX ) && ( bodyIndexX < bodyIndexWidth ) && ( 0 <= bodyIndexY ) && ( bodyIndexY < bodyIndexHeight ) ){
-                const unsigned char bodyIndex = bodyIndexBuffer[bodyIndexY * bodyIndexWidth + bodyIndexX];
-                buffer[colorIndex] = bodyIndex;
-            }
-        }
+        const size_t colorOffset = static_cast<size_t>( colorY ) * colorWidth;
+        ImageKernel::remap<BYTE>( &bodyIndexBuffer[0], bodyIndexWidth, bodyIndexHeight, &bodyIndexSpacePoints[colorOffset], colorWidth, 0xff, buffer + colorOffset );
     } );
 
-    // Create cv::Mat from Coordinate Buffer
-    bodyIndexMat = cv::Mat( colorHeight, colorWidth, CV_8UC1, &buffer[0] ).clone();
+    // Create cv::Mat from Frame Buffer
+    frame.bodyIndexMat = cv::Mat( colorHeight, colorWidth, CV_8UC1, buffer );
 #endif
 
 #ifdef DEPTH
     // Create cv::Mat from BodyIndex Buffer
-    bodyIndexMat = cv::Mat( bodyIndexHeight, bodyIndexWidth, CV_8UC1, &bodyIndexBuffer[0] );
+    frame.bodyIndexMat = cv::Mat( bodyIndexHeight, bodyIndexWidth, CV_8UC1, &frame.bodyIndexBuffer[0] );
 #endif
 }
 
 // Draw ChromaKey
-inline void Kinect::drawChromaKey()
+inline void Kinect::drawChromaKey( Frame& frame )
 {
-    if( colorMat.empty() ){
-        return;
-    }
-
-    if( bodyIndexMat.empty() ){
+    const cv::Mat& colorMat = frame.colorMat;
+    const cv::Mat& bodyIndexMat = frame.bodyIndexMat;
+    if( colorMat.empty() || bodyIndexMat.empty() ){
+        frame.chromaKeyMat = cv::Mat();
         return;
     }
 
     // ChromaKey
 #ifdef COLOR
-    chromaKeyMat = cv::Mat::zeros( colorHeight, colorWidth, CV_8UC4 );
+    frame.chromaKeyMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, frame.chromaKeyFrameBuffer.data() );
 #endif
 #ifdef DEPTH
-    chromaKeyMat = cv::Mat::zeros( depthHeight, depthWidth, CV_8UC4 );
+    frame.chromaKeyMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, frame.chromaKeyFrameBuffer.data() );
 #endif
-    chromaKeyMat.forEach<cv::Vec4b>( [&]( cv::Vec4b &p, const int* position ){
-        uchar bodyIndex = bodyIndexMat.at<uchar>( position[0], position[1] );
-        if( bodyIndex != 0xff ){
-            p = colorMat.at<cv::Vec4b>( position[0], position[1] );
-        }
-    } );
+    ImageKernel::chromaKey( colorMat.ptr<uint32_t>(), bodyIndexMat.ptr<uint8_t>(), frame.chromaKeyMat.total(), frame.chromaKeyMat.ptr<uint32_t>() );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show ChromaKey
-    showChromaKey();
+    showChromaKey( frame );
 }
 
 // Show ChromaKey
-inline void Kinect::showChromaKey()
+inline void Kinect::showChromaKey( Frame& frame )
 {
+    const cv::Mat& chromaKeyMat = frame.chromaKeyMat;
     if( chromaKeyMat.empty() ){
         return;
     }
 
 #ifdef COLOR
     // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( chromaKeyMat, resizeMat, cv::Size(), scale, scale );
+    ImageKernel::halve( chromaKeyMat.data, chromaKeyMat.cols, chromaKeyMat.rows, 4, resizeMat.data );
 
     // Show Image
-    cv::imshow( "ChromaKey", resizeMat );
+    sink->write( "ChromaKey", resizeMat );
 #endif
 
 #ifdef DEPTH
     // Show Image
-    cv::imshow( "ChromaKey", chromaKeyMat );
+    sink->write( "ChromaKey", chromaKeyMat );
 #endif
 }
\ No newline at end of file
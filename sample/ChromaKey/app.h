@@ -4,8 +4,15 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Registration.h"
+#include "ImageKernel.h"
+#include "FramePool.h"
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -19,37 +26,67 @@ private:
     // Coordinate Mapper
     ComPtr<ICoordinateMapper> coordinateMapper;
 
+    // Registration
+    Registration registration;
+
     // Reader
     ComPtr<IColorFrameReader> colorFrameReader;
     ComPtr<IDepthFrameReader> depthFrameReader;
     ComPtr<IBodyIndexFrameReader> bodyIndexFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
 
     // BodyIndex Buffer
-    std::vector<BYTE> bodyIndexBuffer;
     int bodyIndexWidth;
     int bodyIndexHeight;
     unsigned int bodyIndexBytesPerPixel;
-    cv::Mat bodyIndexMat;
 
-    // ChromaKey Buffer
-    cv::Mat chromaKeyMat;
+    // Frame Buffer Pool
+    FramePool colorPool;
+    FramePool bodyIndexPool;
+    FramePool chromaKeyPool;
+    std::vector<DepthSpacePoint> bodyIndexSpacePoints;
+
+    // Show Buffer ( Allocated Once, Reused by Show Stage )
+    cv::Mat resizeMat;
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color, Depth and BodyIndex are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::vector<UINT16> depthBuffer;
+        std::vector<BYTE> bodyIndexBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        bool bodyIndexUpdated;
+        FrameBuffer colorFrameBuffer;
+        FrameBuffer bodyIndexFrameBuffer;
+        FrameBuffer chromaKeyFrameBuffer;
+        cv::Mat colorMat;
+        cv::Mat bodyIndexMat;
+        cv::Mat chromaKeyMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -70,41 +107,47 @@ private:
     // Initialize Depth
     inline void initializeDepth();
 
+    // Initialize Registration
+    inline void initializeRegistration();
+
     // Initialize BodyIndex
     inline void initializeBodyIndex();
 
+    // Initialize Frame Buffer Pool
+    inline void initializeFramePool();
+
     // Finalize
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Depth
-    inline void updateDepth();
+    inline void updateDepth( Frame& frame );
 
     // Update BodyIndex
-    inline void updateBodyIndex();
+    inline void updateBodyIndex( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw BodyIndex
-    inline void drawBodyIndex();
+    inline void drawBodyIndex( Frame& frame );
 
     // Draw ChromaKey
-    inline void drawChromaKey();
+    inline void drawChromaKey( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show ChromaKey
-    inline void showChromaKey();
+    inline void showChromaKey( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -0,0 +1,365 @@
+#ifndef __YUY2__
+#define __YUY2__
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "simd.h"
+
+// YUY2 Color Conversion
+// Converts raw YUY2 ( Y0 U Y1 V ) color frame to the format that consumer actually needs.
+// Uses BT.601 video range integer conversion, the same as Microsoft's 8-bit YUV to RGB888 conversion.
+//   R = clip( ( 298 * ( Y - 16 ) + 409 * ( V - 128 ) + 128 ) >> 8 )
+//   G = clip( ( 298 * ( Y - 16 ) - 100 * ( U - 128 ) - 208 * ( V - 128 ) + 128 ) >> 8 )
+//   B = clip( ( 298 * ( Y - 16 ) + 516 * ( U - 128 ) + 128 ) >> 8 )
+class Yuy2
+{
+public:
+    // Convert YUY2 to BGRA ( Destination is width x height x 4 bytes )
+    static void convertToBGRA( const uint8_t* yuy2, const int width, const int height, uint8_t* bgra )
+    {
+        convertToBGRA( yuy2, width, height, 0, 0, width, height, bgra );
+    }
+
+    // Convert ROI of YUY2 to BGRA ( Destination is roiWidth x roiHeight x 4 bytes )
+    static void convertToBGRA( const uint8_t* yuy2, const int width, const int height, const int x, const int y, const int roiWidth, const int roiHeight, uint8_t* bgra )
+    {
+        checkROI( width, height, x, y, roiWidth, roiHeight );
+
+        for( int row = 0; row < roiHeight; row++ ){
+            const uint8_t* src = yuy2 + ( static_cast<size_t>( y + row ) * width ) * 2;
+            uint8_t* dst = bgra + static_cast<size_t>( row ) * roiWidth * 4;
+            int begin = x;
+            const int end = x + roiWidth;
+
+            // Odd Pixel shares Chroma with Previous Pixel
+            if( ( begin & 1 ) && begin < end ){
+                convertRowBGRAScalar( src, begin, begin + 1, dst );
+                begin++;
+                dst += 4;
+            }
+
+#ifdef SIMD_X86
+            if( IsSupportedAVX2() ){
+                convertRowBGRAAVX2( src, begin, end, dst );
+                continue;
+            }
+
+            if( IsSupportedSSE41() ){
+                convertRowBGRASSE41( src, begin, end, dst );
+                continue;
+            }
+#endif
+
+            convertRowBGRAScalar( src, begin, end, dst );
+        }
+    }
+
+    // Convert YUY2 to Gray ( Luma Extraction, Destination is width x height bytes )
+    static void convertToGray( const uint8_t* yuy2, const int width, const int height, uint8_t* gray )
+    {
+        convertToGray( yuy2, width, height, 0, 0, width, height, gray );
+    }
+
+    // Convert ROI of YUY2 to Gray ( Luma Extraction, Destination is roiWidth x roiHeight bytes )
+    static void convertToGray( const uint8_t* yuy2, const int width, const int height, const int x, const int y, const int roiWidth, const int roiHeight, uint8_t* gray )
+    {
+        checkROI( width, height, x, y, roiWidth, roiHeight );
+
+        for( int row = 0; row < roiHeight; row++ ){
+            const uint8_t* src = yuy2 + ( static_cast<size_t>( y + row ) * width + x ) * 2;
+            uint8_t* dst = gray + static_cast<size_t>( row ) * roiWidth;
+
+#ifdef SIMD_X86
+            if( IsSupportedAVX2() ){
+                convertRowGrayAVX2( src, roiWidth, dst );
+                continue;
+            }
+
+            if( IsSupportedSSE41() ){
+                convertRowGraySSE41( src, roiWidth, dst );
+                continue;
+            }
+#endif
+
+            convertRowGrayScalar( src, 0, roiWidth, dst );
+        }
+    }
+
+    // Convert YUY2 to Half Resolution BGR ( 2 x 2 Box Filter, Destination is ( width / 2 ) x ( height / 2 ) x 3 bytes )
+    static void convertToHalfBGR( const uint8_t* yuy2, const int width, const int height, uint8_t* bgr )
+    {
+        checkROI( width, height, 0, 0, width, height );
+
+        const int halfWidth = width / 2;
+        const int halfHeight = height / 2;
+        for( int row = 0; row < halfHeight; row++ ){
+            const uint8_t* src0 = yuy2 + static_cast<size_t>( row * 2 ) * width * 2;
+            const uint8_t* src1 = src0 + static_cast<size_t>( width ) * 2;
+            uint8_t* dst = bgr + static_cast<size_t>( row ) * halfWidth * 3;
+
+#ifdef SIMD_X86
+            if( IsSupportedSSE41() ){
+                convertRowHalfBGRSSE41( src0, src1, halfWidth, dst );
+                continue;
+            }
+#endif
+
+            convertRowHalfBGRScalar( src0, src1, 0, halfWidth, dst );
+        }
+    }
+
+    // Convert YUV to BGR ( Reference )
+    static void convertPixel( const int y, const int u, const int v, uint8_t* bgr )
+    {
+        const int c = y - 16;
+        const int d = u - 128;
+        const int e = v - 128;
+        bgr[0] = clip( ( 298 * c + 516 * d + 128 ) >> 8 );
+        bgr[1] = clip( ( 298 * c - 100 * d - 208 * e + 128 ) >> 8 );
+        bgr[2] = clip( ( 298 * c + 409 * e + 128 ) >> 8 );
+    }
+
+private:
+    // Check ROI is inside Frame
+    static void checkROI( const int width, const int height, const int x, const int y, const int roiWidth, const int roiHeight )
+    {
+        if( width <= 0 || height <= 0 || ( width & 1 ) != 0 ){
+            throw std::invalid_argument( "invalid yuy2 frame size" );
+        }
+
+        if( x < 0 || y < 0 || roiWidth < 0 || roiHeight < 0 || width - x < roiWidth || height - y < roiHeight ){
+            throw std::invalid_argument( "roi is out of yuy2 frame" );
+        }
+    }
+
+    static uint8_t clip( const int value )
+    {
+        return static_cast<uint8_t>( value < 0 ? 0 : ( value > 255 ? 255 : value ) );
+    }
+
+    // Convert Row to BGRA ( Scalar, Pixels [begin, end) of Source Row )
+    static void convertRowBGRAScalar( const uint8_t* src, const int begin, const int end, uint8_t* dst )
+    {
+        for( int x = begin; x < end; x++ ){
+            const uint8_t* pair = src + ( x & ~1 ) * 2;
+            convertPixel( pair[( x & 1 ) * 2], pair[1], pair[3], dst );
+            dst[3] = 255;
+            dst += 4;
+        }
+    }
+
+    // Convert Row to Gray ( Scalar )
+    static void convertRowGrayScalar( const uint8_t* src, const int begin, const int end, uint8_t* dst )
+    {
+        for( int x = begin; x < end; x++ ){
+            dst[x] = src[x * 2];
+        }
+    }
+
+    // Convert Two Rows to Half Resolution BGR ( Scalar, Output Pixels [begin, end) )
+    static void convertRowHalfBGRScalar( const uint8_t* src0, const uint8_t* src1, const int begin, const int end, uint8_t* dst )
+    {
+        for( int x = begin; x < end; x++ ){
+            const uint8_t* a = src0 + x * 4;
+            const uint8_t* b = src1 + x * 4;
+            const int y = ( a[0] + a[2] + b[0] + b[2] + 2 ) >> 2;
+            const int u = ( a[1] + b[1] + 1 ) >> 1;
+            const int v = ( a[3] + b[3] + 1 ) >> 1;
+            convertPixel( y, u, v, dst + x * 3 );
+        }
+    }
+
+#ifdef SIMD_X86
+    // Pair of 16 bits Coefficients for _mm_madd_epi16
+    static int pair( const int a, const int b )
+    {
+        return static_cast<int>( ( static_cast<uint32_t>( static_cast<uint16_t>( b ) ) << 16 ) | static_cast<uint16_t>( a ) );
+    }
+
+    // Convert Row to BGRA ( SSE4.1, 8 Pixels, begin is Even )
+    SIMD_TARGET_SSE41
+    static void convertRowBGRASSE41( const uint8_t* src, const int begin, const int end, uint8_t* dst )
+    {
+        const __m128i low = _mm_set1_epi16( 0x00ff );
+        const __m128i offsetY = _mm_set1_epi16( 16 );
+        const __m128i offsetUV = _mm_set1_epi16( 128 );
+        const __m128i one = _mm_set1_epi16( 1 );
+        const __m128i round = _mm_set1_epi32( 128 );
+        const __m128i alpha = _mm_set1_epi8( -1 );
+        const __m128i duplicateU = _mm_setr_epi8( 0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13 );
+        const __m128i duplicateV = _mm_setr_epi8( 2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15 );
+        const __m128i coefficientR = _mm_set1_epi32( pair( 298, 409 ) );
+        const __m128i coefficientG = _mm_set1_epi32( pair( 298, -100 ) );
+        const __m128i coefficientGV = _mm_set1_epi32( pair( -208, 128 ) );
+        const __m128i coefficientB = _mm_set1_epi32( pair( 298, 516 ) );
+
+        int x = begin;
+        for( ; x + 8 <= end; x += 8 ){
+            // Unpack Y, U, V to 16 bits per Pixel
+            const __m128i yuy2 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 ) );
+            const __m128i uv = _mm_srli_epi16( yuy2, 8 );
+            const __m128i c = _mm_sub_epi16( _mm_and_si128( yuy2, low ), offsetY );
+            const __m128i d = _mm_sub_epi16( _mm_shuffle_epi8( uv, duplicateU ), offsetUV );
+            const __m128i e = _mm_sub_epi16( _mm_shuffle_epi8( uv, duplicateV ), offsetUV );
+
+            // Multiply-Add in 32 bits
+            const __m128i ceLow = _mm_unpacklo_epi16( c, e );
+            const __m128i ceHigh = _mm_unpackhi_epi16( c, e );
+            const __m128i cdLow = _mm_unpacklo_epi16( c, d );
+            const __m128i cdHigh = _mm_unpackhi_epi16( c, d );
+            const __m128i eLow = _mm_unpacklo_epi16( e, one );
+            const __m128i eHigh = _mm_unpackhi_epi16( e, one );
+
+            const __m128i r = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ceLow, coefficientR ), round ), 8 ),
+                                               _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( ceHigh, coefficientR ), round ), 8 ) );
+            const __m128i g = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cdLow, coefficientG ), _mm_madd_epi16( eLow, coefficientGV ) ), 8 ),
+                                               _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cdHigh, coefficientG ), _mm_madd_epi16( eHigh, coefficientGV ) ), 8 ) );
+            const __m128i b = _mm_packs_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cdLow, coefficientB ), round ), 8 ),
+                                               _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( cdHigh, coefficientB ), round ), 8 ) );
+
+            // Saturate and Interleave to BGRA
+            const __m128i bg = _mm_unpacklo_epi8( _mm_packus_epi16( b, b ), _mm_packus_epi16( g, g ) );
+            const __m128i ra = _mm_unpacklo_epi8( _mm_packus_epi16( r, r ), alpha );
+            uint8_t* pixel = dst + ( x - begin ) * 4;
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( pixel ), _mm_unpacklo_epi16( bg, ra ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( pixel + 16 ), _mm_unpackhi_epi16( bg, ra ) );
+        }
+
+        convertRowBGRAScalar( src, x, end, dst + ( x - begin ) * 4 );
+    }
+
+    // Convert Row to BGRA ( AVX2, 16 Pixels, begin is Even )
+    SIMD_TARGET_AVX2
+    static void convertRowBGRAAVX2( const uint8_t* src, const int begin, const int end, uint8_t* dst )
+    {
+        const __m256i low = _mm256_set1_epi16( 0x00ff );
+        const __m256i offsetY = _mm256_set1_epi16( 16 );
+        const __m256i offsetUV = _mm256_set1_epi16( 128 );
+        const __m256i one = _mm256_set1_epi16( 1 );
+        const __m256i round = _mm256_set1_epi32( 128 );
+        const __m256i alpha = _mm256_set1_epi8( -1 );
+        const __m256i duplicateU = _mm256_setr_epi8( 0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13, 0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13 );
+        const __m256i duplicateV = _mm256_setr_epi8( 2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15, 2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15 );
+        const __m256i coefficientR = _mm256_set1_epi32( pair( 298, 409 ) );
+        const __m256i coefficientG = _mm256_set1_epi32( pair( 298, -100 ) );
+        const __m256i coefficientGV = _mm256_set1_epi32( pair( -208, 128 ) );
+        const __m256i coefficientB = _mm256_set1_epi32( pair( 298, 516 ) );
+
+        int x = begin;
+        for( ; x + 16 <= end; x += 16 ){
+            // Unpack Y, U, V to 16 bits per Pixel ( Pixels 0-7 in Lower Lane, 8-15 in Upper Lane )
+            const __m256i yuy2 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + x * 2 ) );
+            const __m256i uv = _mm256_srli_epi16( yuy2, 8 );
+            const __m256i c = _mm256_sub_epi16( _mm256_and_si256( yuy2, low ), offsetY );
+            const __m256i d = _mm256_sub_epi16( _mm256_shuffle_epi8( uv, duplicateU ), offsetUV );
+            const __m256i e = _mm256_sub_epi16( _mm256_shuffle_epi8( uv, duplicateV ), offsetUV );
+
+            // Multiply-Add in 32 bits
+            const __m256i ceLow = _mm256_unpacklo_epi16( c, e );
+            const __m256i ceHigh = _mm256_unpackhi_epi16( c, e );
+            const __m256i cdLow = _mm256_unpacklo_epi16( c, d );
+            const __m256i cdHigh = _mm256_unpackhi_epi16( c, d );
+            const __m256i eLow = _mm256_unpacklo_epi16( e, one );
+            const __m256i eHigh = _mm256_unpackhi_epi16( e, one );
+
+            const __m256i r = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ceLow, coefficientR ), round ), 8 ),
+                                                  _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( ceHigh, coefficientR ), round ), 8 ) );
+            const __m256i g = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( cdLow, coefficientG ), _mm256_madd_epi16( eLow, coefficientGV ) ), 8 ),
+                                                  _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( cdHigh, coefficientG ), _mm256_madd_epi16( eHigh, coefficientGV ) ), 8 ) );
+            const __m256i b = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( cdLow, coefficientB ), round ), 8 ),
+                                                  _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( cdHigh, coefficientB ), round ), 8 ) );
+
+            // Saturate and Interleave to BGRA, then Restore Pixel Order across Lanes
+            const __m256i bg = _mm256_unpacklo_epi8( _mm256_packus_epi16( b, b ), _mm256_packus_epi16( g, g ) );
+            const __m256i ra = _mm256_unpacklo_epi8( _mm256_packus_epi16( r, r ), alpha );
+            const __m256i bgraLow = _mm256_unpacklo_epi16( bg, ra );
+            const __m256i bgraHigh = _mm256_unpackhi_epi16( bg, ra );
+            uint8_t* pixel = dst + ( x - begin ) * 4;
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( pixel ), _mm256_permute2x128_si256( bgraLow, bgraHigh, 0x20 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( pixel + 32 ), _mm256_permute2x128_si256( bgraLow, bgraHigh, 0x31 ) );
+        }
+
+        convertRowBGRAScalar( src, x, end, dst + ( x - begin ) * 4 );
+    }
+
+    // Convert Row to Gray ( SSE4.1, 16 Pixels )
+    SIMD_TARGET_SSE41
+    static void convertRowGraySSE41( const uint8_t* src, const int count, uint8_t* dst )
+    {
+        const __m128i low = _mm_set1_epi16( 0x00ff );
+
+        int x = 0;
+        for( ; x + 16 <= count; x += 16 ){
+            const __m128i a = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 ) ), low );
+            const __m128i b = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 2 + 16 ) ), low );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x ), _mm_packus_epi16( a, b ) );
+        }
+
+        convertRowGrayScalar( src, x, count, dst );
+    }
+
+    // Convert Row to Gray ( AVX2, 32 Pixels )
+    SIMD_TARGET_AVX2
+    static void convertRowGrayAVX2( const uint8_t* src, const int count, uint8_t* dst )
+    {
+        const __m256i low = _mm256_set1_epi16( 0x00ff );
+
+        int x = 0;
+        for( ; x + 32 <= count; x += 32 ){
+            const __m256i a = _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + x * 2 ) ), low );
+            const __m256i b = _mm256_and_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( src + x * 2 + 32 ) ), low );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( dst + x ), _mm256_permute4x64_epi64( _mm256_packus_epi16( a, b ), 0xd8 ) );
+        }
+
+        convertRowGrayScalar( src, x, count, dst );
+    }
+
+    // Convert Two Rows to Half Resolution BGR ( SSE4.1, 4 Pixels )
+    SIMD_TARGET_SSE41
+    static void convertRowHalfBGRSSE41( const uint8_t* src0, const uint8_t* src1, const int count, uint8_t* dst )
+    {
+        const __m128i low = _mm_set1_epi16( 0x00ff );
+        const __m128i ones = _mm_set1_epi16( 1 );
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maximum = _mm_set1_epi32( 255 );
+        const __m128i compact = _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+
+        int x = 0;
+        for( ; x + 4 <= count; x += 4 ){
+            const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src0 + x * 4 ) );
+            const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src1 + x * 4 ) );
+
+            // Average 2 x 2 Luma and 1 x 2 Chroma
+            const __m128i sum = _mm_add_epi32( _mm_madd_epi16( _mm_and_si128( a, low ), ones ), _mm_madd_epi16( _mm_and_si128( b, low ), ones ) );
+            const __m128i y = _mm_srli_epi32( _mm_add_epi32( sum, _mm_set1_epi32( 2 ) ), 2 );
+            const __m128i uv = _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( _mm_srli_epi16( a, 8 ), _mm_srli_epi16( b, 8 ) ), ones ), 1 );
+            const __m128i u = _mm_blend_epi16( uv, zero, 0xaa );
+            const __m128i v = _mm_srli_epi32( uv, 16 );
+
+            const __m128i c = _mm_mullo_epi32( _mm_sub_epi32( y, _mm_set1_epi32( 16 ) ), _mm_set1_epi32( 298 ) );
+            const __m128i d = _mm_sub_epi32( u, _mm_set1_epi32( 128 ) );
+            const __m128i e = _mm_sub_epi32( v, _mm_set1_epi32( 128 ) );
+            const __m128i round = _mm_add_epi32( c, _mm_set1_epi32( 128 ) );
+
+            __m128i r = _mm_srai_epi32( _mm_add_epi32( round, _mm_mullo_epi32( e, _mm_set1_epi32( 409 ) ) ), 8 );
+            __m128i g = _mm_srai_epi32( _mm_sub_epi32( round, _mm_add_epi32( _mm_mullo_epi32( d, _mm_set1_epi32( 100 ) ), _mm_mullo_epi32( e, _mm_set1_epi32( 208 ) ) ) ), 8 );
+            __m128i bl = _mm_srai_epi32( _mm_add_epi32( round, _mm_mullo_epi32( d, _mm_set1_epi32( 516 ) ) ), 8 );
+            r = _mm_min_epi32( _mm_max_epi32( r, zero ), maximum );
+            g = _mm_min_epi32( _mm_max_epi32( g, zero ), maximum );
+            bl = _mm_min_epi32( _mm_max_epi32( bl, zero ), maximum );
+
+            // Pack to BGR ( 12 bytes )
+            const __m128i bgr = _mm_shuffle_epi8( _mm_or_si128( _mm_or_si128( bl, _mm_slli_epi32( g, 8 ) ), _mm_slli_epi32( r, 16 ) ), compact );
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + x * 3 ), bgr );
+            const int tail = _mm_cvtsi128_si32( _mm_srli_si128( bgr, 8 ) );
+            std::memcpy( dst + x * 3 + 8, &tail, sizeof( tail ) );
+        }
+
+        convertRowHalfBGRScalar( src0, src1, x, count, dst );
+    }
+#endif
+};
+
+#endif // __YUY2__
\ No newline at end of file
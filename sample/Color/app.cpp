@@ -3,9 +3,19 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
+
+// Use Synthetic Frames instead of Sensor ( Run without Kinect )
+//#define SYNTHETIC
+
+// Frame Rate of Synthetic Frames ( 0.0 = As Fast As Possible, e.g. to Benchmark Throughput with Null Sink )
+#define SYNTHETIC_FPS 30.0
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : synthetic( SYNTHETIC_FPS ),
+      sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -21,23 +31,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -45,14 +53,18 @@ void Kinect::initialize()
 {
     cv::setUseOptimized( true );
 
+#ifndef SYNTHETIC
     // Initialize Sensor
     initializeSensor();
+#endif
 
     // Initialize Color
     initializeColor();
 
+#ifndef SYNTHETIC
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+#endif
 }
 
 // Initialize Sensor
@@ -74,6 +86,12 @@ inline void Kinect::initializeSensor()
 // Initialize Color
 inline void Kinect::initializeColor()
 {
+#ifdef SYNTHETIC
+    // Retrieve Color Description from Synthetic Source
+    colorWidth = SyntheticSource::colorWidth;
+    colorHeight = SyntheticSource::colorHeight;
+    colorBytesPerPixel = 2;
+#else
     // Open Color Reader
     ComPtr<IColorFrameSource> colorFrameSource;
     ERROR_CHECK( kinect->get_ColorFrameSource( &colorFrameSource ) );
@@ -81,13 +99,16 @@ inline void Kinect::initializeColor()
 
     // Retrieve Color Description
     ComPtr<IFrameDescription> colorFrameDescription;
-    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Bgra, &colorFrameDescription ) );
+    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Yuy2, &colorFrameDescription ) );
     ERROR_CHECK( colorFrameDescription->get_Width( &colorWidth ) ); // 1920
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
-    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
+    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 2
+#endif
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    } );
 }
 
 // Finalize
@@ -102,59 +123,62 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    return updateColor( frame );
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline bool Kinect::updateColor( Frame& frame )
 {
+#ifdef SYNTHETIC
+    // Retrieve Synthetic Color Data
+    return synthetic.acquireColor( &frame.colorBuffer[0] );
+#else
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
     const HRESULT ret = colorFrameReader->AcquireLatestFrame( &colorFrame );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
-    // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    // Retrieve Color Data ( YUY2, Converted on Demand )
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Yuy2 ) );
+
+    return true;
+#endif
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
-    // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    // Convert Format ( YUY2 -> Half Resolution BGR )
+    frame.colorMat.create( colorHeight / 2, colorWidth / 2, CV_8UC3 );
+    Yuy2::convertToHalfBGR( &frame.colorBuffer[0], colorWidth, colorHeight, frame.colorMat.data );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Color
-    showColor();
+    showColor( frame );
 }
 
 // Show Color
-inline void Kinect::showColor()
+inline void Kinect::showColor( Frame& frame )
 {
-    if( colorMat.empty() ){
+    if( frame.colorMat.empty() ){
         return;
     }
 
-    // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
-
-    // Show Image
-    cv::imshow( "Color", resizeMat );
+    // Show Image ( Already Half Resolution )
+    sink->write( "Color", frame.colorMat );
 }
\ No newline at end of file
@@ -4,8 +4,14 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Yuy2.h"
+#include "Pipeline.h"
+#include "SyntheticSource.h"
+#include "FrameSink.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -20,15 +26,32 @@ private:
     ComPtr<IColorFrameReader> colorFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
+
+    // Frame ( Buffers Passed between Pipeline Stages )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Synthetic Source
+    SyntheticSource synthetic;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -50,22 +73,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline bool updateColor( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Color
-    inline void showColor();
+    inline void showColor( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
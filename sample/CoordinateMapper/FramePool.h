@@ -0,0 +1,255 @@
+#ifndef __FRAME_POOL__
+#define __FRAME_POOL__
+
+#include <atomic>
+#include <vector>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+class FramePool;
+
+// Frame Buffer Slot
+struct FrameSlot
+{
+    std::atomic<int> references;
+    unsigned char* data;
+    FramePool* pool;
+};
+
+// Frame Buffer ( Reference-Counted Handle to a Pool Slot )
+// The buffer returns to its pool when the last handle is released, the pool must outlive every handle.
+class FrameBuffer
+{
+private:
+    FrameSlot* slot;
+    size_t bytes;
+
+public:
+    // Constructor
+    FrameBuffer()
+        : slot( nullptr ), bytes( 0 )
+    {
+    }
+
+    FrameBuffer( FrameSlot* slot, const size_t bytes )
+        : slot( slot ), bytes( bytes )
+    {
+    }
+
+    FrameBuffer( const FrameBuffer& other )
+        : slot( other.slot ), bytes( other.bytes )
+    {
+        if( slot != nullptr ){
+            slot->references.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    FrameBuffer( FrameBuffer&& other )
+        : slot( other.slot ), bytes( other.bytes )
+    {
+        other.slot = nullptr;
+        other.bytes = 0;
+    }
+
+    // Destructor
+    ~FrameBuffer()
+    {
+        release();
+    }
+
+    FrameBuffer& operator=( const FrameBuffer& other )
+    {
+        if( this != &other ){
+            FrameBuffer copy( other );
+            swap( copy );
+        }
+        return *this;
+    }
+
+    FrameBuffer& operator=( FrameBuffer&& other )
+    {
+        if( this != &other ){
+            release();
+            swap( other );
+        }
+        return *this;
+    }
+
+    // Release Reference
+    void release()
+    {
+        if( slot != nullptr ){
+            slot->references.fetch_sub( 1, std::memory_order_acq_rel );
+            slot = nullptr;
+            bytes = 0;
+        }
+    }
+
+    // Swap
+    void swap( FrameBuffer& other )
+    {
+        FrameSlot* tempSlot = slot;
+        slot = other.slot;
+        other.slot = tempSlot;
+        const size_t tempBytes = bytes;
+        bytes = other.bytes;
+        other.bytes = tempBytes;
+    }
+
+    // Retrieve Data
+    void* data() const
+    {
+        return ( slot != nullptr ) ? slot->data : nullptr;
+    }
+
+    template<typename T>
+    T* ptr() const
+    {
+        return reinterpret_cast<T*>( data() );
+    }
+
+    // Retrieve Size [bytes]
+    size_t size() const
+    {
+        return bytes;
+    }
+
+    // Retrieve Reference Count
+    int references() const
+    {
+        return ( slot != nullptr ) ? slot->references.load( std::memory_order_relaxed ) : 0;
+    }
+
+    // Check Empty
+    bool empty() const
+    {
+        return slot == nullptr;
+    }
+
+    explicit operator bool() const
+    {
+        return slot != nullptr;
+    }
+};
+
+// Frame Buffer Pool
+// Owns a fixed number of preallocated and aligned buffers.
+// acquire() does no heap allocation and is lock-free, so it can be used from any thread.
+class FramePool
+{
+private:
+    std::vector<FrameSlot> slots;
+    unsigned char* memory;
+    size_t bytes;
+    size_t stride;
+
+public:
+    // Constructor
+    FramePool()
+        : memory( nullptr ), bytes( 0 ), stride( 0 )
+    {
+    }
+
+    FramePool( const size_t bytes, const size_t count, const size_t alignment = 64 )
+        : memory( nullptr ), bytes( 0 ), stride( 0 )
+    {
+        allocate( bytes, count, alignment );
+    }
+
+    // Destructor
+    ~FramePool()
+    {
+        deallocate();
+    }
+
+    FramePool( const FramePool& ) = delete;
+    FramePool& operator=( const FramePool& ) = delete;
+
+    // Allocate Buffers
+    void allocate( const size_t bytes, const size_t count, const size_t alignment = 64 )
+    {
+        deallocate();
+
+        if( bytes == 0 || count == 0 || ( alignment & ( alignment - 1 ) ) != 0 ){
+            throw std::invalid_argument( "invalid frame pool parameters" );
+        }
+
+        this->bytes = bytes;
+        stride = ( bytes + alignment - 1 ) & ~( alignment - 1 );
+#ifdef _MSC_VER
+        memory = static_cast<unsigned char*>( _aligned_malloc( stride * count, alignment ) );
+#else
+        void* pointer = nullptr;
+        memory = ( posix_memalign( &pointer, ( alignment < sizeof( void* ) ) ? sizeof( void* ) : alignment, stride * count ) == 0 ) ? static_cast<unsigned char*>( pointer ) : nullptr;
+#endif
+        if( memory == nullptr ){
+            throw std::bad_alloc();
+        }
+
+        slots = std::vector<FrameSlot>( count );
+        for( size_t i = 0; i < count; i++ ){
+            slots[i].references.store( 0, std::memory_order_relaxed );
+            slots[i].data = memory + i * stride;
+            slots[i].pool = this;
+        }
+    }
+
+    // Acquire Free Buffer ( Empty Buffer if All Buffers are in Use )
+    FrameBuffer acquire()
+    {
+        for( size_t i = 0; i < slots.size(); i++ ){
+            int expected = 0;
+            if( slots[i].references.compare_exchange_strong( expected, 1, std::memory_order_acquire, std::memory_order_relaxed ) ){
+                return FrameBuffer( &slots[i], bytes );
+            }
+        }
+        return FrameBuffer();
+    }
+
+    // Retrieve Number of Free Buffers
+    size_t available() const
+    {
+        size_t count = 0;
+        for( size_t i = 0; i < slots.size(); i++ ){
+            if( slots[i].references.load( std::memory_order_relaxed ) == 0 ){
+                count++;
+            }
+        }
+        return count;
+    }
+
+    // Retrieve Buffer Size [bytes]
+    size_t size() const
+    {
+        return bytes;
+    }
+
+    // Retrieve Number of Buffers
+    size_t capacity() const
+    {
+        return slots.size();
+    }
+
+private:
+    // Deallocate Buffers
+    void deallocate()
+    {
+        slots.clear();
+        if( memory != nullptr ){
+#ifdef _MSC_VER
+            _aligned_free( memory );
+#else
+            free( memory );
+#endif
+            memory = nullptr;
+        }
+        bytes = stride = 0;
+    }
+};
+
+#endif // __FRAME_POOL__
\ No newline at end of file
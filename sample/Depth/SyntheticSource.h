@@ -0,0 +1,136 @@
+#ifndef __SYNTHETIC_SOURCE__
+#define __SYNTHETIC_SOURCE__
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+// Synthetic Frame Source
+// Generates frames in the same formats as Kinect v2 ( Depth/Infrared UINT16 512 x 424, Color YUY2 1920 x 1080 )
+// at a fixed frame rate, so that frame processing can run without sensor ( e.g. headless on Linux ).
+// Like AcquireLatestFrame(), acquire*() returns false until next frame is due. Frame rate 0 generates a frame on every call.
+class SyntheticSource
+{
+public:
+    static const int depthWidth = 512;
+    static const int depthHeight = 424;
+    static const int colorWidth = 1920;
+    static const int colorHeight = 1080;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double fps;
+    Clock::time_point begin;
+    int64_t depthFrame;
+    int64_t infraredFrame;
+    int64_t colorFrame;
+
+public:
+    // Constructor
+    explicit SyntheticSource( const double fps = 30.0 )
+        : fps( fps ), begin( Clock::now() ), depthFrame( -1 ), infraredFrame( -1 ), colorFrame( -1 )
+    {
+    }
+
+    // Acquire Depth ( Sphere moving in front of Slanted Wall, Invalid Border, Depth in Millimeters )
+    bool acquireDepth( uint16_t* depth, int64_t* timestamp = nullptr )
+    {
+        int64_t frame;
+        if( !next( depthFrame, frame, timestamp ) ){
+            return false;
+        }
+
+        const double phase = frame * 0.05;
+        const double centerX = depthWidth * ( 0.5 + 0.3 * std::sin( phase ) );
+        const double centerY = depthHeight * 0.5;
+        const double radius = depthHeight * 0.2;
+        for( int y = 0; y < depthHeight; y++ ){
+            for( int x = 0; x < depthWidth; x++ ){
+                uint16_t value = 0;
+                if( 8 <= x && x < depthWidth - 8 ){
+                    const double dx = x - centerX;
+                    const double dy = y - centerY;
+                    const double distance = dx * dx + dy * dy;
+                    value = static_cast<uint16_t>( 3000.0 + 2.0 * x - 1.0 * y );
+                    if( distance < radius * radius ){
+                        value = static_cast<uint16_t>( 1500.0 - std::sqrt( radius * radius - distance ) * 2.0 );
+                    }
+                }
+                depth[y * depthWidth + x] = value;
+            }
+        }
+
+        return true;
+    }
+
+    // Acquire Infrared ( Moving Gradient )
+    bool acquireInfrared( uint16_t* infrared, int64_t* timestamp = nullptr )
+    {
+        int64_t frame;
+        if( !next( infraredFrame, frame, timestamp ) ){
+            return false;
+        }
+
+        for( int y = 0; y < depthHeight; y++ ){
+            for( int x = 0; x < depthWidth; x++ ){
+                infrared[y * depthWidth + x] = static_cast<uint16_t>( ( ( x + y + frame * 4 ) & 0xff ) << 8 );
+            }
+        }
+
+        return true;
+    }
+
+    // Acquire Color ( YUY2, Scrolling Color Bars )
+    bool acquireColor( uint8_t* yuy2, int64_t* timestamp = nullptr )
+    {
+        int64_t frame;
+        if( !next( colorFrame, frame, timestamp ) ){
+            return false;
+        }
+
+        // Color Bars ( Y, U, V )
+        static const uint8_t bars[8][3] = {
+            { 235, 128, 128 }, { 210, 16, 146 }, { 170, 166, 16 }, { 145, 54, 34 },
+            { 106, 202, 222 }, { 81, 90, 240 }, { 41, 240, 110 }, { 16, 128, 128 }
+        };
+
+        const int offset = static_cast<int>( frame * 8 );
+        for( int y = 0; y < colorHeight; y++ ){
+            uint8_t* row = yuy2 + static_cast<size_t>( y ) * colorWidth * 2;
+            for( int x = 0; x < colorWidth; x += 2 ){
+                const uint8_t* bar = bars[( ( x + offset ) / ( colorWidth / 8 ) ) % 8];
+                row[x * 2 + 0] = bar[0];
+                row[x * 2 + 1] = bar[1];
+                row[x * 2 + 2] = bar[0];
+                row[x * 2 + 3] = bar[2];
+            }
+        }
+
+        return true;
+    }
+
+private:
+    // Check Next Frame is Due ( Timestamp in 100 ns like Kinect Relative Time )
+    bool next( int64_t& last, int64_t& frame, int64_t* timestamp )
+    {
+        if( fps > 0.0 ){
+            const double elapsed = std::chrono::duration<double>( Clock::now() - begin ).count();
+            frame = static_cast<int64_t>( elapsed * fps );
+            if( frame == last ){
+                return false;
+            }
+        }
+        else{
+            frame = last + 1;
+        }
+
+        last = frame;
+        if( timestamp != nullptr ){
+            *timestamp = ( fps > 0.0 ) ? static_cast<int64_t>( frame * 1e7 / fps ) : frame;
+        }
+        return true;
+    }
+};
+
+#endif // __SYNTHETIC_SOURCE__
\ No newline at end of file
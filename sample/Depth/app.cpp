@@ -3,9 +3,19 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
+
+// Use Synthetic Frames instead of Sensor ( Run without Kinect )
+//#define SYNTHETIC
+
+// Frame Rate of Synthetic Frames ( 0.0 = As Fast As Possible, e.g. to Benchmark Throughput with Null Sink )
+#define SYNTHETIC_FPS 30.0
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : synthetic( SYNTHETIC_FPS ),
+      sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -21,23 +31,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -45,14 +53,18 @@ void Kinect::initialize()
 {
     cv::setUseOptimized( true );
 
+#ifndef SYNTHETIC
     // Initialize Sensor
     initializeSensor();
+#endif
 
     // Initialize Depth
     initializeDepth();
 
+#ifndef SYNTHETIC
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+#endif
 }
 
 // Initialize Sensor
@@ -74,6 +86,12 @@ inline void Kinect::initializeSensor()
 // Initialize Depth
 inline void Kinect::initializeDepth()
 {
+#ifdef SYNTHETIC
+    // Retrieve Depth Description from Synthetic Source
+    depthWidth = SyntheticSource::depthWidth;
+    depthHeight = SyntheticSource::depthHeight;
+    depthBytesPerPixel = sizeof( UINT16 );
+#else
     // Open Depth Reader
     ComPtr<IDepthFrameSource> depthFrameSource;
     ERROR_CHECK( kinect->get_DepthFrameSource( &depthFrameSource ) );
@@ -92,9 +110,12 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameSource->get_DepthMinReliableDistance( &minReliableDistance ) ); // 500
     ERROR_CHECK( depthFrameSource->get_DepthMaxReliableDistance( &maxReliableDistance ) ); // 4500
     std::cout << "Depth Reliable Range : " << minReliableDistance << " - " << maxReliableDistance << std::endl;
+#endif
 
-    // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    // Allocation Depth Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+    } );
 }
 
 // Finalize
@@ -109,59 +130,66 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Depth
-    updateDepth();
+    return updateDepth( frame );
 }
 
 // Update Depth
-inline void Kinect::updateDepth()
+inline bool Kinect::updateDepth( Frame& frame )
 {
+#ifdef SYNTHETIC
+    // Retrieve Synthetic Depth Data
+    return synthetic.acquireDepth( &frame.depthBuffer[0] );
+#else
     // Retrieve Depth Frame
     ComPtr<IDepthFrame> depthFrame;
     const HRESULT ret = depthFrameReader->AcquireLatestFrame( &depthFrame );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
     // Retrieve Depth Data
-    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( frame.depthBuffer.size() ), &frame.depthBuffer[0] ) );
+
+    return true;
+#endif
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Depth
-    drawDepth();
+    drawDepth( frame );
 }
 
 // Draw Depth
-inline void Kinect::drawDepth()
+inline void Kinect::drawDepth( Frame& frame )
 {
     // Create cv::Mat from Depth Buffer
-    depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &depthBuffer[0] );
+    frame.depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &frame.depthBuffer[0] );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Depth
-    showDepth();
+    showDepth( frame );
 }
 
 // Show Depth
-inline void Kinect::showDepth()
+inline void Kinect::showDepth( Frame& frame )
 {
-    if( depthMat.empty() ){
+    if( frame.depthMat.empty() ){
         return;
     }
 
     // Scaling ( 0-8000 -> 255-0 )
     cv::Mat scaleMat;
-    depthMat.convertTo( scaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
+    frame.depthMat.convertTo( scaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
     //cv::applyColorMap( scaleMat, scaleMat, cv::COLORMAP_BONE );
 
     // Show Image
-    cv::imshow( "Depth", scaleMat );
+    sink->write( "Depth", scaleMat );
 }
\ No newline at end of file
@@ -4,8 +4,13 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "SyntheticSource.h"
+#include "FrameSink.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -20,15 +25,32 @@ private:
     ComPtr<IDepthFrameReader> depthFrameReader;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
-    cv::Mat depthMat;
+
+    // Frame ( Buffers Passed between Pipeline Stages )
+    struct Frame
+    {
+        std::vector<UINT16> depthBuffer;
+        cv::Mat depthMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Synthetic Source
+    SyntheticSource synthetic;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -50,22 +72,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Depth
-    inline void updateDepth();
+    inline bool updateDepth( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Depth
-    inline void drawDepth();
+    inline void drawDepth( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Depth
-    inline void showDepth();
+    inline void showDepth( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
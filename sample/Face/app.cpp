@@ -3,13 +3,16 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -25,23 +28,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -99,8 +100,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -179,20 +183,31 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
     updateBody();
 
     // Update Face
     updateFace();
+
+    // Wait until Color is Updated
+    if( !frame.colorUpdated ){
+        return false;
+    }
+
+    // Pass Face Results Retrieved since Previous Frame, and ReSet Results for Next Frame
+    frame.colorUpdated = false;
+    frame.results = results;
+    results.fill( nullptr );
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -202,7 +217,8 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
@@ -244,9 +260,6 @@ inline void Kinect::updateBody()
 // Update Face
 inline void Kinect::updateFace()
 {
-    // ReSet Results
-    results.fill( nullptr );
-
     Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
         // Retrieve Face Frame
         ComPtr<IFaceFrame> faceFrame;
@@ -268,25 +281,27 @@ inline void Kinect::updateFace()
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Face
-    drawFace();
+    drawFace( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 }
 
 // Draw Face
-inline void Kinect::drawFace()
+inline void Kinect::drawFace( Frame& frame )
 {
+    const std::array<ComPtr<IFaceFrameResult>, BODY_COUNT>& results = frame.results;
+    cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -417,15 +432,16 @@ inline std::string Kinect::result2string( DetectionResult& result )
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Face
-    showFace();
+    showFace( frame );
 }
 
 // Show Face
-inline void Kinect::showFace()
+inline void Kinect::showFace( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -436,5 +452,5 @@ inline void Kinect::showFace()
     cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
 
     // Show Image
-    cv::imshow( "Face", resizeMat );
+    sink->write( "Face", resizeMat );
 }
\ No newline at end of file
@@ -5,9 +5,13 @@
 #include <Kinect.h>
 #include <Kinect.Face.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -29,11 +33,9 @@ private:
     std::array<ComPtr<IFaceFrameReader>, BODY_COUNT> faceFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Body Buffer
     std::array<IBody*, BODY_COUNT> bodies = { nullptr };
@@ -43,9 +45,27 @@ private:
     std::array<std::string, FaceProperty::FaceProperty_Count> labels;
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        bool colorUpdated;
+        std::array<ComPtr<IFaceFrameResult>, BODY_COUNT> results;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -73,10 +93,10 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
     inline void updateBody();
@@ -85,13 +105,13 @@ private:
     inline void updateFace();
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Face
-    inline void drawFace();
+    inline void drawFace( Frame& frame );
 
     // Draw Face Points
     inline void drawFacePoints( cv::Mat& image, const std::array<PointF, FacePointType::FacePointType_Count>& points, const int radius, const cv::Vec3b& color, const int thickness = -1 );
@@ -112,10 +132,10 @@ private:
     inline std::string Kinect::result2string( DetectionResult& result );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Face
-    inline void showFace();
+    inline void showFace( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -5,9 +5,13 @@
 #include <Kinect.h>
 #include <Kinect.Face.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -29,11 +33,9 @@ private:
     std::array<ComPtr<IFaceFrameReader>, BODY_COUNT> faceFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Body Buffer
     std::array<IBody*, BODY_COUNT> bodies = { nullptr };
@@ -42,9 +44,28 @@ private:
     std::array<ComPtr<IFaceFrameResult>, BODY_COUNT> results;
     std::array<cv::Mat, BODY_COUNT> faceClipMat;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        bool colorUpdated;
+        std::array<ComPtr<IFaceFrameResult>, BODY_COUNT> results;
+        cv::Mat colorMat;
+        std::array<cv::Mat, BODY_COUNT> faceClipMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -72,10 +93,10 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
     inline void updateBody();
@@ -84,22 +105,22 @@ private:
     inline void updateFace();
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Face Clip
-    inline void drawFaceClip();
+    inline void drawFaceClip( Frame& frame );
 
     // Retrieve Face Clip
-    inline void retrieveFaceClip( cv::Mat& image, const RectI& box );
+    inline void retrieveFaceClip( const cv::Mat& colorMat, cv::Mat& image, const RectI& box );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Face Clip
-    inline void showFaceClip();
+    inline void showFaceClip( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
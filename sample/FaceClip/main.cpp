@@ -1,12 +1,17 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "app.h"
 
 int main( int argc, char* argv[] )
 {
     try{
-        Kinect kinect;
+        // Frame Sink ( imshow, null, file:<directory> or shm:<prefix> ) and Number of Frames ( 0 = Until Escape Key )
+        const std::string sink = ( argc > 1 ) ? argv[1] : "imshow";
+        const uint64_t frames = ( argc > 2 ) ? std::stoull( argv[2] ) : 0;
+
+        Kinect kinect( sink, frames );
         kinect.run();
     } catch( std::exception& ex ){
         std::cout << ex.what() << std::endl;
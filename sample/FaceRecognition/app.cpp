@@ -3,13 +3,16 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -25,23 +28,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -97,13 +98,16 @@ inline void Kinect::initializeColor()
 
     // Retrieve Color Description
     ComPtr<IFrameDescription> colorFrameDescription;
-    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Bgra, &colorFrameDescription ) );
+    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Yuy2, &colorFrameDescription ) );
     ERROR_CHECK( colorFrameDescription->get_Width( &colorWidth ) ); // 1920
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
-    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
+    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 2
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -171,10 +175,10 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
     updateBody();
@@ -182,12 +186,20 @@ void Kinect::update()
     // Update Face
     updateFace();
 
-    // Update Recognition
-    updateRecognition();
+    // Wait until Color is Updated
+    if( !frame.colorUpdated ){
+        return false;
+    }
+
+    // Pass Face Results Retrieved since Previous Frame, and ReSet Results for Next Frame
+    frame.colorUpdated = false;
+    frame.results = results;
+    results.fill( nullptr );
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -196,8 +208,9 @@ inline void Kinect::updateColor()
         return;
     }
 
-    // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    // Retrieve Color Data ( YUY2, Converted on Demand )
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Yuy2 ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
@@ -239,9 +252,6 @@ inline void Kinect::updateBody()
 // Update Face
 inline void Kinect::updateFace()
 {
-    // ReSet Results
-    results.fill( nullptr );
-
     Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
         // Retrieve Face Frame
         ComPtr<IFaceFrame> faceFrame;
@@ -262,14 +272,11 @@ inline void Kinect::updateFace()
     } );
 }
 
-// Update Recognition
-inline void Kinect::updateRecognition()
+// Update Recognition ( Called from Draw Stage )
+inline void Kinect::updateRecognition( Frame& frame )
 {
-    // Create cv::Mat from Color Buffer
-    cv::Mat colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
-    if( colorMat.empty() ){
-        return;
-    }
+    const std::array<ComPtr<IFaceFrameResult>, BODY_COUNT>& results = frame.results;
+    const std::vector<BYTE>& colorBuffer = frame.colorBuffer;
 
     // ReSet Labels and Distances
     labels.fill( -1 );
@@ -285,44 +292,49 @@ inline void Kinect::updateRecognition()
         RectI boundingBox;
         ERROR_CHECK( result->get_FaceBoundingBoxInColorSpace( &boundingBox ) );
 
-        // Retrieve Face
-        const cv::Rect roi = { boundingBox.Left, boundingBox.Top, ( boundingBox.Right - boundingBox.Left ), ( boundingBox.Bottom - boundingBox.Top ) };
-        cv::Mat faceMat = colorMat( roi ).clone();
-        if( faceMat.empty() ){
+        // Retrieve Face ( Convert only ROI from YUY2 to Gray )
+        const cv::Rect roi = cv::Rect( boundingBox.Left, boundingBox.Top, ( boundingBox.Right - boundingBox.Left ), ( boundingBox.Bottom - boundingBox.Top ) ) & cv::Rect( 0, 0, colorWidth, colorHeight );
+        if( roi.area() == 0 ){
             return;
         }
 
+        cv::Mat faceMat( roi.height, roi.width, CV_8UC1 );
+        Yuy2::convertToGray( &colorBuffer[0], colorWidth, colorHeight, roi.x, roi.y, roi.width, roi.height, faceMat.data );
+
         // Resize
         //cv::resize( faceMat, faceMat, cv::Size( 200, 200 ) );
 
-        // Convert BGRA to Gray
-        cv::cvtColor( faceMat, faceMat, cv::COLOR_BGRA2GRAY );
-
         // Recognition
         recognizer->predict( faceMat, labels[count], distances[count] );
     } );
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
+    // Update Recognition
+    updateRecognition( frame );
+
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Recognition
-    drawRecognition();
+    drawRecognition( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
-    // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    // Convert Format ( YUY2 -> Half Resolution BGR )
+    frame.colorMat.create( colorHeight / 2, colorWidth / 2, CV_8UC3 );
+    Yuy2::convertToHalfBGR( &frame.colorBuffer[0], colorWidth, colorHeight, frame.colorMat.data );
 }
 
 // Draw Recognition
-inline void Kinect::drawRecognition()
+inline void Kinect::drawRecognition( Frame& frame )
 {
+    const std::array<ComPtr<IFaceFrameResult>, BODY_COUNT>& results = frame.results;
+    cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -342,13 +354,14 @@ inline void Kinect::drawRecognition()
         // Set Draw Color by Recognition Results
         const cv::Vec3b color = ( label != -1 ) ? cv::Vec3b( 0, 255, 0 ) : cv::Vec3b( 0, 0, 255 );
 
-        // Draw Face Bounding Box
+        // Draw Face Bounding Box ( Color Image is Half Resolution )
         RectI boundingBox;
         ERROR_CHECK( result->get_FaceBoundingBoxInColorSpace( &boundingBox ) );
+        boundingBox = { boundingBox.Left / 2, boundingBox.Top / 2, boundingBox.Right / 2, boundingBox.Bottom / 2 };
         drawFaceBoundingBox( colorMat, boundingBox, color );
 
         // Draw Recognition Results
-        drawRecognitionResults( colorMat, label, distance, cv::Point( boundingBox.Left, boundingBox.Top ), 1.0, color );
+        drawRecognitionResults( colorMat, label, distance, cv::Point( boundingBox.Left, boundingBox.Top ), 0.5, color, 1 );
     } );
 }
 
@@ -387,24 +400,20 @@ inline void Kinect::drawRecognitionResults( cv::Mat& image, const int label, con
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Recognition
-    showRecognition();
+    showRecognition( frame );
 }
 
 // Show Recognition
-inline void Kinect::showRecognition()
+inline void Kinect::showRecognition( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
 
-    // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
-
-    // Show Image
-    cv::imshow( "Recognition", resizeMat );
+    // Show Image ( Already Half Resolution )
+    sink->write( "Recognition", colorMat );
 }
\ No newline at end of file
@@ -5,11 +5,15 @@
 #include <Kinect.h>
 #include <Kinect.Face.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 #include <opencv2/face.hpp>
+#include "Yuy2.h"
 
 #include <vector>
 #include <array>
 #include <string>
+#include <memory>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -31,11 +35,9 @@ private:
     std::array<ComPtr<IFaceFrameReader>, BODY_COUNT> faceFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Body Buffer
     std::array<IBody*, BODY_COUNT> bodies = { nullptr };
@@ -50,9 +52,27 @@ private:
     std::array<int, BODY_COUNT> labels;
     std::array<double, BODY_COUNT> distances;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        bool colorUpdated;
+        std::array<ComPtr<IFaceFrameResult>, BODY_COUNT> results;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -83,10 +103,10 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
     inline void updateBody();
@@ -95,16 +115,16 @@ private:
     inline void updateFace();
 
     // Update Recognition
-    inline void updateRecognition();
+    inline void updateRecognition( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Recognition
-    inline void drawRecognition();
+    inline void drawRecognition( Frame& frame );
 
     // Draw Face Bounding Box
     inline void drawFaceBoundingBox( cv::Mat& image, const RectI& box, const cv::Vec3b& color, const int thickness = 1 );
@@ -113,10 +133,10 @@ private:
     inline void drawRecognitionResults( cv::Mat& image, const int label, const double distance, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness = 2 );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Recognition
-    inline void showRecognition();
+    inline void showRecognition( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
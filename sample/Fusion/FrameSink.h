@@ -0,0 +1,129 @@
+#ifndef __FRAME_SINK__
+#define __FRAME_SINK__
+
+#include <opencv2/core.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+// Frame Sink
+// Destination of images that show*() produces, so that samples don't depend on HighGUI.
+// Sinks are used from one thread ( present stage of Pipeline ).
+class FrameSink
+{
+protected:
+    uint64_t count;
+    uint64_t bytes;
+    int pressed;
+
+public:
+    // Constructor
+    FrameSink()
+        : count( 0 ), bytes( 0 ), pressed( -1 )
+    {
+    }
+
+    // Destructor
+    virtual ~FrameSink()
+    {
+    }
+
+    // Write Image to Sink ( name is Window Name, e.g. "Depth" )
+    virtual void write( const std::string& name, const cv::Mat& image ) = 0;
+
+    // Process Events ( Returns false if User Requested to Quit )
+    virtual bool poll()
+    {
+        return true;
+    }
+
+    // Retrieve Key Pressed at Last poll() ( -1 if None, Sinks without Window have no Keys )
+    int key() const { return pressed; }
+
+    // Retrieve Number of Written Images and Bytes
+    uint64_t images() const { return count; }
+    uint64_t size() const { return bytes; }
+
+protected:
+    // Count Written Image
+    void add( const cv::Mat& image )
+    {
+        count++;
+        bytes += image.total() * image.elemSize();
+    }
+};
+
+// Null Sink ( Discards Images, for Measuring Throughput )
+class NullSink : public FrameSink
+{
+public:
+    void write( const std::string& name, const cv::Mat& image ) override;
+};
+
+// File Sink ( Writes Images to Directory as <name>_<number>.<extension> )
+class FileSink : public FrameSink
+{
+private:
+    std::string directory;
+    std::string extension;
+    std::map<std::string, uint64_t> numbers;
+
+public:
+    // Constructor
+    FileSink( const std::string& directory, const std::string& extension = ".png" );
+
+    void write( const std::string& name, const cv::Mat& image ) override;
+};
+
+// Shared Memory Header
+struct SharedFrameHeader
+{
+    uint32_t magic;      // 'K2SM'
+    uint32_t version;
+    uint64_t sequence;   // Odd while Writing
+    uint64_t frame;      // Number of Written Images
+    int32_t width;
+    int32_t height;
+    int32_t type;        // OpenCV Type ( e.g. CV_8UC3 )
+    int32_t step;        // Bytes per Row
+    uint64_t capacity;   // Bytes of Image Data Area
+};
+
+// Shared Memory Sink ( Publishes Latest Image of Each Window to Named Shared Memory <prefix>_<name> )
+// Memory Layout is SharedFrameHeader followed by Image Data, readers retry while sequence is odd or changed during read.
+class SharedMemorySink : public FrameSink
+{
+private:
+    struct Mapping;
+    std::map<std::string, std::unique_ptr<Mapping>> mappings;
+    std::string prefix;
+
+public:
+    // Constructor
+    explicit SharedMemorySink( const std::string& prefix );
+
+    // Destructor
+    ~SharedMemorySink();
+
+    void write( const std::string& name, const cv::Mat& image ) override;
+};
+
+// Imshow Sink ( cv::imshow and cv::waitKey, Quit by Escape Key )
+class ImshowSink : public FrameSink
+{
+public:
+    void write( const std::string& name, const cv::Mat& image ) override;
+
+    bool poll() override;
+};
+
+// Create Frame Sink from Specification
+//   "imshow"            : ImshowSink
+//   "null"              : NullSink
+//   "file:<directory>"  : FileSink
+//   "shm:<prefix>"      : SharedMemorySink
+std::unique_ptr<FrameSink> CreateFrameSink( const std::string& specification );
+
+#endif // __FRAME_SINK__
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef __FUSION_MATH__
+#define __FUSION_MATH__
+
+#include <cmath>
+
+// Matrix ( Same Layout as Matrix4 of Kinect Fusion )
+// Row vector convention, a point is transformed as p' = p * M, so translation is in M41, M42, M43.
+struct Matrix4f
+{
+    float M11, M12, M13, M14;
+    float M21, M22, M23, M24;
+    float M31, M32, M33, M34;
+    float M41, M42, M43, M44;
+};
+
+// Camera Parameters ( Same as NUI_FUSION_CAMERA_PARAMETERS, Normalized by Image Width and Height )
+struct FusionCamera
+{
+    float focalLengthX;
+    float focalLengthY;
+    float principalPointX;
+    float principalPointY;
+};
+
+// Identity Matrix
+inline Matrix4f IdentityMatrix4f()
+{
+    const Matrix4f identity = {
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+    return identity;
+}
+
+// Multiply Matrices ( Transform by a then b )
+inline Matrix4f MultiplyMatrix4f( const Matrix4f& a, const Matrix4f& b )
+{
+    const float* x = &a.M11;
+    const float* y = &b.M11;
+    Matrix4f result;
+    float* r = &result.M11;
+    for( int row = 0; row < 4; row++ ){
+        for( int column = 0; column < 4; column++ ){
+            r[row * 4 + column] = x[row * 4 + 0] * y[0 * 4 + column] + x[row * 4 + 1] * y[1 * 4 + column]
+                                + x[row * 4 + 2] * y[2 * 4 + column] + x[row * 4 + 3] * y[3 * 4 + column];
+        }
+    }
+    return result;
+}
+
+// Invert Rigid Transformation ( Rotation and Translation, e.g. World to Camera <-> Camera to World )
+inline Matrix4f InvertRigidMatrix4f( const Matrix4f& m )
+{
+    Matrix4f result = IdentityMatrix4f();
+
+    // Transpose Rotation
+    result.M11 = m.M11; result.M12 = m.M21; result.M13 = m.M31;
+    result.M21 = m.M12; result.M22 = m.M22; result.M23 = m.M32;
+    result.M31 = m.M13; result.M32 = m.M23; result.M33 = m.M33;
+
+    // Rotate Negated Translation
+    result.M41 = -( m.M41 * result.M11 + m.M42 * result.M21 + m.M43 * result.M31 );
+    result.M42 = -( m.M41 * result.M12 + m.M42 * result.M22 + m.M43 * result.M32 );
+    result.M43 = -( m.M41 * result.M13 + m.M42 * result.M23 + m.M43 * result.M33 );
+    return result;
+}
+
+// Transform Point
+inline void TransformPoint( const Matrix4f& m, const float x, const float y, const float z, float* point )
+{
+    point[0] = m.M41 + m.M11 * x + m.M21 * y + m.M31 * z;
+    point[1] = m.M42 + m.M12 * x + m.M22 * y + m.M32 * z;
+    point[2] = m.M43 + m.M13 * x + m.M23 * y + m.M33 * z;
+}
+
+// Rotate Vector ( Ignore Translation )
+inline void RotateVector( const Matrix4f& m, const float x, const float y, const float z, float* vector )
+{
+    vector[0] = m.M11 * x + m.M21 * y + m.M31 * z;
+    vector[1] = m.M12 * x + m.M22 * y + m.M32 * z;
+    vector[2] = m.M13 * x + m.M23 * y + m.M33 * z;
+}
+
+#endif // __FUSION_MATH__
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include "HashedTsdfVolume.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Rows of Depth Image per Task of Brick Collection
+    const int collectRows = 16;
+
+    // Seek to 64 bit Offset
+    void seekFile( FILE* file, const uint64_t offset )
+    {
+    #ifdef _WIN32
+        const int result = _fseeki64( file, static_cast<__int64>( offset ), SEEK_SET );
+    #else
+        const int result = fseeko( file, static_cast<off_t>( offset ), SEEK_SET );
+    #endif
+        if( result != 0 ){
+            throw std::runtime_error( "failed to seek swap file" );
+        }
+    }
+}
+
+// Constructor
+HashedTsdfVolume::HashedTsdfVolume( const TsdfParameters& parameters, const size_t maxResidentBricks, const std::string& swapPath )
+    : swapPath( swapPath ), swapFile( nullptr ), swapSize( 0 ), maxResidentBricks( maxResidentBricks ), frameCount( 0 )
+{
+    if( parameters.voxelsPerMeter <= 0.0f || parameters.truncationDistance <= 0.0f ){
+        throw std::invalid_argument( "invalid volume parameters" );
+    }
+    if( maxResidentBricks == 0 ){
+        throw std::invalid_argument( "invalid number of resident bricks" );
+    }
+
+    this->parameters = parameters;
+    origin[0] = 0.0f;
+    origin[1] = 0.0f;
+    origin[2] = 0.0f;
+}
+
+// Destructor
+HashedTsdfVolume::~HashedTsdfVolume()
+{
+    if( swapFile != nullptr ){
+        fclose( swapFile );
+        std::remove( swapPath.c_str() );
+    }
+}
+
+// Integrate Depth and Color Frame
+void HashedTsdfVolume::integrate( const TsdfFrame& frame )
+{
+    frameCount++;
+
+    // Allocate or Stream In Bricks around Surface
+    collectBricks( frame );
+    active.resize( keys.size() );
+    for( size_t i = 0; i < keys.size(); i++ ){
+        active[i] = acquireBrick( keys[i] );
+    }
+
+    // Integrate Bricks in Parallel ( 16 Bricks per Task )
+    const size_t bricksPerTask = 16;
+    ThreadPool::global().parallelFor( ( active.size() + bricksPerTask - 1 ) / bricksPerTask, [&]( const size_t task ){
+        const size_t end = std::min( active.size(), ( task + 1 ) * bricksPerTask );
+        for( size_t i = task * bricksPerTask; i < end; i++ ){
+            int x, y, z;
+            UnpackBrickKey( keys[i], x, y, z );
+            integrateBrick( *active[i], x, y, z, frame, parameters, origin );
+        }
+    } );
+
+    // Keep Memory within Budget
+    evictBricks();
+}
+
+// Collect Bricks within Truncation Distance of Depth Samples
+void HashedTsdfVolume::collectBricks( const TsdfFrame& frame )
+{
+    const Matrix4f cameraToWorld = InvertRigidMatrix4f( frame.worldToCamera );
+    const float fx = frame.camera.focalLengthX * frame.width;
+    const float fy = frame.camera.focalLengthY * frame.height;
+    const float cx = frame.camera.principalPointX * frame.width;
+    const float cy = frame.camera.principalPointY * frame.height;
+
+    // Sample Ray Segment [depth - truncation, depth + truncation] at Half Brick Steps
+    const float brickSize = TsdfBrick::size / parameters.voxelsPerMeter;
+    const int steps = static_cast<int>( std::ceil( 2.0f * parameters.truncationDistance / ( brickSize * 0.5f ) ) );
+
+    const int tasks = ( frame.height + collectRows - 1 ) / collectRows;
+    std::vector<std::vector<uint64_t>> collected( tasks );
+    ThreadPool::global().parallelFor( tasks, [&]( const size_t task ){
+        std::vector<uint64_t>& result = collected[task];
+        uint64_t last = ~0ull;
+        const int end = std::min( frame.height, static_cast<int>( task + 1 ) * collectRows );
+        for( int v = static_cast<int>( task ) * collectRows; v < end; v++ ){
+            for( int u = 0; u < frame.width; u++ ){
+                const float depth = frame.depth[v * frame.width + u];
+                if( !( depth >= parameters.minDepth && depth <= parameters.maxDepth ) ){
+                    continue;
+                }
+
+                // Direction of Ray ( z = 1 )
+                const float rayX = ( u - cx ) / fx;
+                const float rayY = ( v - cy ) / fy;
+                for( int step = 0; step <= steps; step++ ){
+                    const float z = depth - parameters.truncationDistance + ( 2.0f * parameters.truncationDistance ) * step / steps;
+                    if( z <= 0.0f ){
+                        continue;
+                    }
+
+                    float world[3];
+                    TransformPoint( cameraToWorld, rayX * z, rayY * z, z, world );
+                    const int x = static_cast<int>( std::floor( ( world[0] * parameters.voxelsPerMeter + origin[0] ) / TsdfBrick::size ) );
+                    const int y = static_cast<int>( std::floor( ( world[1] * parameters.voxelsPerMeter + origin[1] ) / TsdfBrick::size ) );
+                    const int z0 = static_cast<int>( std::floor( ( world[2] * parameters.voxelsPerMeter + origin[2] ) / TsdfBrick::size ) );
+                    const uint64_t key = PackBrickKey( x, y, z0 );
+
+                    // Neighboring Samples mostly Hit Same Brick
+                    if( key != last ){
+                        result.push_back( key );
+                        last = key;
+                    }
+                }
+            }
+        }
+        std::sort( result.begin(), result.end() );
+        result.erase( std::unique( result.begin(), result.end() ), result.end() );
+    } );
+
+    // Merge
+    keys.clear();
+    for( const std::vector<uint64_t>& result : collected ){
+        keys.insert( keys.end(), result.begin(), result.end() );
+    }
+    std::sort( keys.begin(), keys.end() );
+    keys.erase( std::unique( keys.begin(), keys.end() ), keys.end() );
+}
+
+// Retrieve Resident Brick ( Allocated or Streamed In if Necessary )
+TsdfBrick* HashedTsdfVolume::acquireBrick( const uint64_t key )
+{
+    std::unordered_map<uint64_t, Entry>::iterator found = resident.find( key );
+    if( found != resident.end() ){
+        found->second.lastUsed = frameCount;
+        return &pool[found->second.index];
+    }
+
+    // Allocate from Pool
+    uint32_t index;
+    if( !freeBricks.empty() ){
+        index = freeBricks.back();
+        freeBricks.pop_back();
+    }
+    else{
+        index = static_cast<uint32_t>( pool.size() );
+        pool.emplace_back();
+        pool.back().version = 0;
+        pool.back().revision = 0;
+    }
+    TsdfBrick& brick = pool[index];
+
+    // Stream In or Clear
+    std::unordered_map<uint64_t, uint64_t>::iterator stored = swapped.find( key );
+    if( stored != swapped.end() ){
+        readBrick( stored->second, brick );
+        freeOffsets.push_back( stored->second );
+        swapped.erase( stored );
+    }
+    else{
+        brick.clear();
+    }
+
+    Entry entry;
+    entry.index = index;
+    entry.lastUsed = frameCount;
+    resident.emplace( key, entry );
+    return &brick;
+}
+
+// Stream Out Least Recently Used Bricks ( Down to 7/8 of Budget, Bricks of Current Frame Stay )
+void HashedTsdfVolume::evictBricks()
+{
+    if( resident.size() <= maxResidentBricks ){
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> candidates; // Last Used, Key
+    candidates.reserve( resident.size() );
+    for( const std::pair<const uint64_t, Entry>& entry : resident ){
+        if( entry.second.lastUsed != frameCount ){
+            candidates.emplace_back( entry.second.lastUsed, entry.first );
+        }
+    }
+
+    const size_t target = maxResidentBricks - maxResidentBricks / 8;
+    const size_t count = std::min( candidates.size(), resident.size() - std::min( resident.size(), target ) );
+    std::partial_sort( candidates.begin(), candidates.begin() + count, candidates.end() );
+
+    for( size_t i = 0; i < count; i++ ){
+        const uint64_t key = candidates[i].second;
+        std::unordered_map<uint64_t, Entry>::iterator entry = resident.find( key );
+        swapped[key] = writeBrick( pool[entry->second.index] );
+        freeBricks.push_back( entry->second.index );
+        resident.erase( entry );
+    }
+}
+
+// Read Brick from Swap File
+void HashedTsdfVolume::readBrick( const uint64_t offset, TsdfBrick& brick ) const
+{
+    seekFile( swapFile, offset );
+    if( fread( &brick, sizeof( TsdfBrick ), 1, swapFile ) != 1 ){
+        throw std::runtime_error( "failed to read brick from swap file" );
+    }
+}
+
+// Write Brick to Swap File ( Returns Offset )
+uint64_t HashedTsdfVolume::writeBrick( const TsdfBrick& brick )
+{
+    if( swapFile == nullptr ){
+        swapFile = fopen( swapPath.c_str(), "w+b" );
+        if( swapFile == nullptr ){
+            throw std::runtime_error( "failed to open swap file ( " + swapPath + " )" );
+        }
+    }
+
+    uint64_t offset = swapSize;
+    if( !freeOffsets.empty() ){
+        offset = freeOffsets.back();
+        freeOffsets.pop_back();
+    }
+    else{
+        swapSize += sizeof( TsdfBrick );
+    }
+
+    seekFile( swapFile, offset );
+    if( fwrite( &brick, sizeof( TsdfBrick ), 1, swapFile ) != 1 ){
+        throw std::runtime_error( "failed to write brick to swap file" );
+    }
+    return offset;
+}
+
+// Reset All Voxels ( Release Bricks and Swap File )
+void HashedTsdfVolume::reset()
+{
+    pool.clear();
+    freeBricks.clear();
+    resident.clear();
+    swapped.clear();
+    freeOffsets.clear();
+    swapSize = 0;
+    if( swapFile != nullptr ){
+        fclose( swapFile );
+        swapFile = nullptr;
+        std::remove( swapPath.c_str() );
+    }
+}
+
+// Retrieve Resident Brick
+const TsdfBrick* HashedTsdfVolume::findBrick( const int x, const int y, const int z ) const
+{
+    std::unordered_map<uint64_t, Entry>::const_iterator found = resident.find( PackBrickKey( x, y, z ) );
+    if( found == resident.end() ){
+        return nullptr;
+    }
+    return &pool[found->second.index];
+}
+
+// Retrieve Brick to Write
+TsdfBrick* HashedTsdfVolume::acquireBrick( const int x, const int y, const int z )
+{
+    return acquireBrick( PackBrickKey( x, y, z ) );
+}
+
+// Call function for Resident and Swapped Bricks
+void HashedTsdfVolume::forEachBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const
+{
+    forEachResidentBrick( function );
+
+    if( swapped.empty() ){
+        return;
+    }
+
+    if( fflush( swapFile ) != 0 ){
+        throw std::runtime_error( "failed to flush swap file" );
+    }
+    int x, y, z;
+    std::vector<TsdfBrick> brick( 1 );
+    for( const std::pair<const uint64_t, uint64_t>& entry : swapped ){
+        readBrick( entry.second, brick[0] );
+        UnpackBrickKey( entry.first, x, y, z );
+        function( x, y, z, brick[0] );
+    }
+}
+
+// Call function for Resident Bricks
+void HashedTsdfVolume::forEachResidentBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const
+{
+    int x, y, z;
+    for( const std::pair<const uint64_t, Entry>& entry : resident ){
+        UnpackBrickKey( entry.first, x, y, z );
+        function( x, y, z, pool[entry.second.index] );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef __HASHED_TSDF_VOLUME__
+#define __HASHED_TSDF_VOLUME__
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TsdfVolume.h"
+
+// Sparse TSDF Volume ( Voxel Hashing )
+//
+// Bricks are allocated on demand around the observed surface ( within truncation distance of each depth sample )
+// and looked up through a spatial hash of brick coordinates, so memory scales with surface area instead of bounding volume.
+// World origin is voxel ( 0, 0, 0 ), the volume is unbounded within +-2^20 bricks on each axis.
+//
+// When more than maxResidentBricks are in memory, least recently integrated bricks are streamed out to a swap file,
+// and streamed back in when they are observed again. findBrick() returns resident bricks only, forEachBrick() visits swapped bricks too.
+class HashedTsdfVolume : public TsdfGrid
+{
+private:
+    // Resident Brick
+    struct Entry
+    {
+        uint32_t index;    // Index in Brick Pool
+        uint64_t lastUsed; // Frame Number of Last Integration
+    };
+
+    std::deque<TsdfBrick> pool;
+    std::vector<uint32_t> freeBricks;
+    std::unordered_map<uint64_t, Entry> resident;
+
+    // Swapped Brick ( Offset in Swap File )
+    std::unordered_map<uint64_t, uint64_t> swapped;
+    std::vector<uint64_t> freeOffsets;
+    std::string swapPath;
+    FILE* swapFile;
+    uint64_t swapSize;
+
+    size_t maxResidentBricks;
+    uint64_t frameCount;
+
+    // Bricks of Current Frame
+    std::vector<uint64_t> keys;
+    std::vector<TsdfBrick*> active;
+
+public:
+    // Constructor ( Swap File is Created when First Brick is Streamed Out )
+    HashedTsdfVolume( const TsdfParameters& parameters, const size_t maxResidentBricks = 65536, const std::string& swapPath = "volume.swap" );
+
+    // Destructor ( Swap File is Removed )
+    ~HashedTsdfVolume();
+
+    HashedTsdfVolume( const HashedTsdfVolume& ) = delete;
+    HashedTsdfVolume& operator=( const HashedTsdfVolume& ) = delete;
+
+    void integrate( const TsdfFrame& frame ) override;
+
+    void reset() override;
+
+    const TsdfBrick* findBrick( const int x, const int y, const int z ) const override;
+
+    // Retrieve Brick to Write ( Allocated or Streamed In, Budget of Resident Bricks is Restored at Next Integration )
+    TsdfBrick* acquireBrick( const int x, const int y, const int z ) override;
+
+    void forEachBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const override;
+
+    void forEachResidentBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const override;
+
+    // Retrieve Number of Bricks
+    size_t getResidentBricks() const { return resident.size(); }
+    size_t getSwappedBricks() const { return swapped.size(); }
+
+    // Retrieve Memory of Resident Bricks in Bytes
+    size_t getResidentBytes() const { return pool.size() * sizeof( TsdfBrick ); }
+
+private:
+    // Collect Bricks within Truncation Distance of Depth Samples
+    void collectBricks( const TsdfFrame& frame );
+
+    // Retrieve Resident Brick ( Allocated or Streamed In if Necessary )
+    TsdfBrick* acquireBrick( const uint64_t key );
+
+    // Stream Out Least Recently Used Bricks
+    void evictBricks();
+
+    // Read and Write Brick in Swap File
+    void readBrick( const uint64_t offset, TsdfBrick& brick ) const;
+    uint64_t writeBrick( const TsdfBrick& brick );
+};
+
+#endif // __HASHED_TSDF_VOLUME__
\ No newline at end of file
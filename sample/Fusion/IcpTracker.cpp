@@ -0,0 +1,320 @@
+#include "IcpTracker.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace
+{
+    // Columns of Row Buffer ( Jacobian of Rotation and Translation, Residual )
+    const int columnCount = 7;
+
+    // Sums of Normal Equations ( Upper Triangle of J^T J, J^T e, e^T e )
+    const int sumCount = 28;
+
+    // Pairs of Columns in Normal Equations ( Upper Triangle, Row Major )
+    struct Pairs
+    {
+        int first[sumCount];
+        int second[sumCount];
+
+        Pairs()
+        {
+            int index = 0;
+            for( int i = 0; i < columnCount; i++ ){
+                for( int j = i; j < columnCount; j++ ){
+                    first[index] = i;
+                    second[index] = j;
+                    index++;
+                }
+            }
+        }
+    };
+    const Pairs pairs;
+
+    // Reduce Row ( Dot Products of Column Pairs )
+    void reduceRow( const float* columns, const int stride, const int count, double* sums )
+    {
+        for( int pair = 0; pair < sumCount; pair++ ){
+            const float* a = columns + pairs.first[pair] * stride;
+            const float* b = columns + pairs.second[pair] * stride;
+            float sum = 0.0f;
+            for( int i = 0; i < count; i++ ){
+                sum += a[i] * b[i];
+            }
+            sums[pair] = sum;
+        }
+    }
+
+#ifdef SIMD_X86
+    // Reduce Row ( AVX2, Count is Padded to Multiple of 8 with Zeros )
+    SIMD_TARGET_AVX2 void reduceRowAVX2( const float* columns, const int stride, const int count, double* sums )
+    {
+        for( int pair = 0; pair < sumCount; pair++ ){
+            const float* a = columns + pairs.first[pair] * stride;
+            const float* b = columns + pairs.second[pair] * stride;
+            __m256 sum = _mm256_setzero_ps();
+            for( int i = 0; i < count; i += 8 ){
+                sum = _mm256_fmadd_ps( _mm256_loadu_ps( a + i ), _mm256_loadu_ps( b + i ), sum );
+            }
+            __m128 half = _mm_add_ps( _mm256_castps256_ps128( sum ), _mm256_extractf128_ps( sum, 1 ) );
+            half = _mm_add_ps( half, _mm_movehl_ps( half, half ) );
+            half = _mm_add_ss( half, _mm_shuffle_ps( half, half, 1 ) );
+            sums[pair] = _mm_cvtss_f32( half );
+        }
+    }
+#endif
+
+    // Solve A x = b by Cholesky Decomposition ( Returns false if A is not Positive Definite )
+    bool solveCholesky( double a[6][6], const double* b, double* x )
+    {
+        double trace = 0.0;
+        for( int i = 0; i < 6; i++ ){
+            trace += a[i][i];
+        }
+
+        for( int j = 0; j < 6; j++ ){
+            double diagonal = a[j][j];
+            for( int k = 0; k < j; k++ ){
+                diagonal -= a[j][k] * a[j][k];
+            }
+            if( !( diagonal > trace * 1e-12 ) ){
+                return false;
+            }
+            a[j][j] = std::sqrt( diagonal );
+            for( int i = j + 1; i < 6; i++ ){
+                double value = a[i][j];
+                for( int k = 0; k < j; k++ ){
+                    value -= a[i][k] * a[j][k];
+                }
+                a[i][j] = value / a[j][j];
+            }
+        }
+
+        // Forward and Back Substitution ( L y = b, L^T x = y )
+        double y[6];
+        for( int i = 0; i < 6; i++ ){
+            double value = b[i];
+            for( int k = 0; k < i; k++ ){
+                value -= a[i][k] * y[k];
+            }
+            y[i] = value / a[i][i];
+        }
+        for( int i = 5; i >= 0; i-- ){
+            double value = y[i];
+            for( int k = i + 1; k < 6; k++ ){
+                value -= a[k][i] * x[k];
+            }
+            x[i] = value / a[i][i];
+        }
+        return true;
+    }
+
+    // Rigid Transform from Rotation Vector and Translation
+    Matrix4f twistToMatrix4f( const double* x )
+    {
+        const double angle = std::sqrt( x[0] * x[0] + x[1] * x[1] + x[2] * x[2] );
+        double rotation[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+        if( angle > 0.0 ){
+            // Rodrigues ( R = I + sin K + ( 1 - cos ) K^2 for Column Vector )
+            const double k[3] = { x[0] / angle, x[1] / angle, x[2] / angle };
+            const double skew[3][3] = { { 0.0, -k[2], k[1] }, { k[2], 0.0, -k[0] }, { -k[1], k[0], 0.0 } };
+            const double s = std::sin( angle );
+            const double c = 1.0 - std::cos( angle );
+            for( int i = 0; i < 3; i++ ){
+                for( int j = 0; j < 3; j++ ){
+                    double square = 0.0;
+                    for( int l = 0; l < 3; l++ ){
+                        square += skew[i][l] * skew[l][j];
+                    }
+                    rotation[i][j] += s * skew[i][j] + c * square;
+                }
+            }
+        }
+
+        // Transpose for Row Vector
+        Matrix4f result = IdentityMatrix4f();
+        float* m = &result.M11;
+        for( int i = 0; i < 3; i++ ){
+            for( int j = 0; j < 3; j++ ){
+                m[i * 4 + j] = static_cast<float>( rotation[j][i] );
+            }
+            m[12 + i] = static_cast<float>( x[3 + i] );
+        }
+        return result;
+    }
+}
+
+// Constructor
+IcpTracker::IcpTracker( const IcpParameters& parameters )
+    : parameters( parameters )
+{
+    for( int level = 0; level < levelCount; level++ ){
+        statistics[level] = IcpStatistics();
+    }
+}
+
+// Estimate World to Camera Transform of Current Frame
+bool IcpTracker::track( const IcpFrame& frame, Matrix4f& worldToCamera )
+{
+    for( int level = 0; level < levelCount; level++ ){
+        statistics[level] = IcpStatistics();
+    }
+
+    // Transform from Current Camera to Reference Camera
+    Matrix4f currentToReference = MultiplyMatrix4f( InvertRigidMatrix4f( worldToCamera ), frame.referenceWorldToCamera );
+
+    // Coarse to Fine
+    for( int level = levelCount - 1; level >= 0; level-- ){
+        IcpStatistics& levelStatistics = statistics[level];
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for( int iteration = 0; iteration < parameters.iterations[level]; iteration++ ){
+            double sums[sumCount];
+            const unsigned int count = reduce( frame, level, currentToReference, sums, levelStatistics.validPixels );
+            levelStatistics.iterations = iteration + 1;
+            levelStatistics.correspondences = count;
+            levelStatistics.error = ( count > 0 ) ? static_cast<float>( std::sqrt( sums[sumCount - 1] / count ) ) : 0.0f;
+            if( count < 6 ){
+                levelStatistics.milliseconds = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - start ).count();
+                return false;
+            }
+
+            // Normal Equations ( J^T J x = -J^T e )
+            double a[6][6];
+            double b[6];
+            for( int pair = 0; pair < sumCount - 1; pair++ ){
+                const int i = pairs.first[pair];
+                const int j = pairs.second[pair];
+                if( j < 6 ){
+                    a[i][j] = a[j][i] = sums[pair];
+                }
+                else{
+                    b[i] = -sums[pair];
+                }
+            }
+            double x[6];
+            if( !solveCholesky( a, b, x ) ){
+                levelStatistics.milliseconds = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - start ).count();
+                return false;
+            }
+
+            // Apply Increment after Current Estimate
+            currentToReference = MultiplyMatrix4f( currentToReference, twistToMatrix4f( x ) );
+
+            // Converged
+            const double rotation = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+            const double translation = x[3] * x[3] + x[4] * x[4] + x[5] * x[5];
+            if( rotation < 1e-10 && translation < 1e-10 ){
+                break;
+            }
+        }
+        levelStatistics.milliseconds = std::chrono::duration<float, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Too Few Correspondences after Level ( Coarse Iterations may Start with Few Correspondences and Converge )
+        if( levelStatistics.correspondences < parameters.minInlierRatio * levelStatistics.validPixels ){
+            return false;
+        }
+    }
+
+    worldToCamera = MultiplyMatrix4f( frame.referenceWorldToCamera, InvertRigidMatrix4f( currentToReference ) );
+    return true;
+}
+
+// Associate and Reduce Normal Equations of Level
+unsigned int IcpTracker::reduce( const IcpFrame& frame, const int level, const Matrix4f& currentToReference, double* sums, unsigned int& validPixels )
+{
+    const int width = frame.width >> level;
+    const int height = frame.height >> level;
+    const float fx = frame.camera.focalLengthX * width;
+    const float fy = frame.camera.focalLengthY * height;
+    const float cx = ( frame.camera.principalPointX * frame.width + 0.5f ) / ( 1 << level ) - 0.5f;  // Pixel n of Level is Center of Pixels 2^level x n ... 2^level x ( n + 1 ) - 1 of Level 0
+    const float cy = ( frame.camera.principalPointY * frame.height + 0.5f ) / ( 1 << level ) - 0.5f;
+    const float threshold = parameters.distanceThreshold;
+    const float* depth = frame.depth[level];
+    const float* reference = frame.reference[level];
+    float* residual = ( level == 0 ) ? frame.residual : nullptr;
+
+    const int stride = ( width + 7 ) & ~7;
+    rows.resize( static_cast<size_t>( columnCount ) * stride * height );
+    rowSums.resize( static_cast<size_t>( sumCount ) * height );
+    rowCounts.resize( static_cast<size_t>( 2 ) * height );
+
+    const bool avx2 = IsSupportedAVX2();
+    ThreadPool::global().parallelFor( height, [&]( const size_t v ){
+        float* columns = &rows[v * columnCount * stride];
+        int count = 0;
+        unsigned int valid = 0;
+        for( int u = 0; u < width; u++ ){
+            // Residual is 2 for Pixel without Correspondence, 1 for Rejected Correspondence
+            float delta = 2.0f;
+            const float d = depth[v * width + u];
+            if( d > 0.0f ){
+                valid++;
+
+                // Project into Reference
+                float point[3];
+                TransformPoint( currentToReference, ( u - cx ) / fx * d, ( v - cy ) / fy * d, d, point );
+                const float pu = std::floor( point[0] / point[2] * fx + cx + 0.5f );
+                const float pv = std::floor( point[1] / point[2] * fy + cy + 0.5f );
+                if( point[2] > 0.0f && pu >= 0.0f && pu < width && pv >= 0.0f && pv < height ){
+                    const float* target = &reference[( static_cast<size_t>( pv ) * width + static_cast<size_t>( pu ) ) * 6];
+                    const float* normal = target + 3;
+                    if( target[2] > 0.0f && ( normal[0] != 0.0f || normal[1] != 0.0f || normal[2] != 0.0f ) ){
+                        const float difference[3] = { point[0] - target[0], point[1] - target[1], point[2] - target[2] };
+                        delta = 1.0f;
+                        if( difference[0] * difference[0] + difference[1] * difference[1] + difference[2] * difference[2] <= threshold * threshold ){
+                            // Point to Plane Distance and Jacobian ( Rotation: p x n, Translation: n )
+                            const float error = normal[0] * difference[0] + normal[1] * difference[1] + normal[2] * difference[2];
+                            columns[0 * stride + count] = point[1] * normal[2] - point[2] * normal[1];
+                            columns[1 * stride + count] = point[2] * normal[0] - point[0] * normal[2];
+                            columns[2 * stride + count] = point[0] * normal[1] - point[1] * normal[0];
+                            columns[3 * stride + count] = normal[0];
+                            columns[4 * stride + count] = normal[1];
+                            columns[5 * stride + count] = normal[2];
+                            columns[6 * stride + count] = error;
+                            count++;
+                            delta = std::min( std::fabs( error ) / threshold, 1.0f );
+                        }
+                    }
+                }
+            }
+            if( residual != nullptr ){
+                residual[v * width + u] = delta;
+            }
+        }
+
+        // Pad to Multiple of 8
+        const int padded = ( count + 7 ) & ~7;
+        for( int column = 0; column < columnCount; column++ ){
+            std::fill( columns + column * stride + count, columns + column * stride + padded, 0.0f );
+        }
+
+#ifdef SIMD_X86
+        if( avx2 ){
+            reduceRowAVX2( columns, stride, padded, &rowSums[v * sumCount] );
+        }
+        else{
+            reduceRow( columns, stride, count, &rowSums[v * sumCount] );
+        }
+#else
+        reduceRow( columns, stride, count, &rowSums[v * sumCount] );
+#endif
+        rowCounts[v * 2 + 0] = count;
+        rowCounts[v * 2 + 1] = valid;
+    } );
+
+    // Sum Rows
+    unsigned int count = 0;
+    validPixels = 0;
+    std::fill( sums, sums + sumCount, 0.0 );
+    for( int v = 0; v < height; v++ ){
+        for( int pair = 0; pair < sumCount; pair++ ){
+            sums[pair] += rowSums[v * sumCount + pair];
+        }
+        count += rowCounts[v * 2 + 0];
+        validPixels += rowCounts[v * 2 + 1];
+    }
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#ifndef __ICP_TRACKER__
+#define __ICP_TRACKER__
+
+#include <cstdint>
+#include <vector>
+
+#include "FusionMath.h"
+
+// ICP Tracking Parameters
+struct IcpParameters
+{
+    int iterations[3];       // Maximum Iterations per Level ( Level 0 is Full Resolution )
+    float distanceThreshold; // Maximum Distance between Corresponding Points in Meters
+    float minInlierRatio;    // Minimum Ratio of Correspondences to Valid Depth Pixels per Level
+};
+
+// Default Tracking Parameters
+inline IcpParameters DefaultIcpParameters()
+{
+    IcpParameters parameters;
+    parameters.iterations[0] = 10;
+    parameters.iterations[1] = 5;
+    parameters.iterations[2] = 4;
+    parameters.distanceThreshold = 0.1f;
+    parameters.minInlierRatio = 0.1f;
+    return parameters;
+}
+
+// Tracking Frame ( Pyramid of Factor 1, 2, 4 made by Resampler )
+struct IcpFrame
+{
+    const float* depth[3];     // Depth in Meters of Current Frame, 0 is Invalid ( NUI_FUSION_IMAGE_TYPE_FLOAT )
+    const float* reference[3]; // Point Cloud Raycast at Reference Pose ( NUI_FUSION_IMAGE_TYPE_POINT_CLOUD )
+    float* residual;           // Residual of Level 0 for CalculateResidualStatistics ( 0 - 1 Normalized Distance, 2 no Correspondence ), nullptr to Skip
+    int width;                 // Size of Level 0 ( Level n is width >> n, height >> n )
+    int height;
+    FusionCamera camera;
+    Matrix4f referenceWorldToCamera;
+};
+
+// Tracking Statistics of Level
+struct IcpStatistics
+{
+    int iterations;               // Iterations Run
+    float milliseconds;           // Time of All Iterations
+    unsigned int validPixels;     // Pixels that have Depth
+    unsigned int correspondences; // Correspondences of Last Iteration
+    float error;                  // RMS Point to Plane Distance of Last Iteration in Meters
+};
+
+// Point to Plane ICP Camera Tracker
+//
+// Aligns depth of current frame to point cloud raycast from volume at reference pose, coarse to fine ( Level 2 -> 0 ).
+// Correspondences are found by projective data association and rejected by distance.
+// Each row stores Jacobians and residuals of its correspondences, and the 6 x 6 normal equations of the row are reduced by SIMD
+// dot products on the thread pool, then the rows are summed in double and solved by Cholesky decomposition.
+class IcpTracker
+{
+public:
+    static const int levelCount = 3;
+
+private:
+    IcpParameters parameters;
+    IcpStatistics statistics[levelCount];
+
+    // Jacobian and Residual of Correspondences per Row ( 7 Columns of Padded Width ), and Normal Equations and Counts per Row
+    std::vector<float> rows;
+    std::vector<double> rowSums;
+    std::vector<unsigned int> rowCounts;
+
+public:
+    // Constructor
+    explicit IcpTracker( const IcpParameters& parameters = DefaultIcpParameters() );
+
+    // Estimate World to Camera Transform of Current Frame from Initial Estimate in worldToCamera ( Returns false if Tracking Failed, worldToCamera is Unchanged )
+    bool track( const IcpFrame& frame, Matrix4f& worldToCamera );
+
+    // Retrieve Statistics of Level from Last Tracking
+    const IcpStatistics& getStatistics( const int level ) const { return statistics[level]; }
+
+private:
+    // Associate and Reduce Normal Equations of Level ( Returns Number of Correspondences )
+    unsigned int reduce( const IcpFrame& frame, const int level, const Matrix4f& currentToReference, double* sums, unsigned int& validPixels );
+};
+
+#endif // __ICP_TRACKER__
\ No newline at end of file
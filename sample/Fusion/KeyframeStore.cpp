@@ -0,0 +1,261 @@
+#include "KeyframeStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    inline void seekFile( FILE* file, const uint64_t offset )
+    {
+    #ifdef _WIN32
+        const int result = _fseeki64( file, static_cast<__int64>( offset ), SEEK_SET );
+    #else
+        const int result = fseeko( file, static_cast<off_t>( offset ), SEEK_SET );
+    #endif
+        if( result != 0 ){
+            throw std::runtime_error( "failed to seek keyframe spill file" );
+        }
+    }
+
+    // Compressed Size of Keyframe
+    inline size_t compressedSize( const KeyframeInfo& info )
+    {
+        return static_cast<size_t>( info.depthBytes ) + info.colorBytes[0] + info.colorBytes[1] + info.colorBytes[2];
+    }
+}
+
+// Constructor
+KeyframeStore::KeyframeStore( const size_t arenaBytes, const std::string& spillPath )
+    : firstResident( 0 ), arena( arenaBytes ), tail( 0 ), spillPath( spillPath ), spillFile( nullptr ), spillSize( 0 ), rawBytes( 0 ), compressedBytes( 0 )
+{
+}
+
+// Destructor
+KeyframeStore::~KeyframeStore()
+{
+    if( spillFile != nullptr ){
+        fclose( spillFile );
+        std::remove( spillPath.c_str() );
+    }
+}
+
+// Add Keyframe
+size_t KeyframeStore::add( const uint16_t* depth, const uint32_t* color, const int width, const int height, const FusionCamera& camera, const Matrix4f& worldToCamera )
+{
+    if( encoder.getWidth() != width || encoder.getHeight() != height ){
+        encoder.initialize( width, height, 1 );
+    }
+
+    // Convert Color to YCoCg-R Planes ( Offset to Keep 0 for Invalid Pixels )
+    const size_t pixels = static_cast<size_t>( width ) * height;
+    for( std::vector<uint16_t>& plane : planes ){
+        plane.resize( pixels );
+    }
+    for( size_t i = 0; i < pixels; i++ ){
+        const uint32_t pixel = color[i];
+        if( ( pixel & 0xff000000 ) == 0 ){
+            planes[0][i] = planes[1][i] = planes[2][i] = 0;
+            continue;
+        }
+        const int blue = pixel & 0xff;
+        const int green = ( pixel >> 8 ) & 0xff;
+        const int red = ( pixel >> 16 ) & 0xff;
+        const int co = red - blue;
+        const int t = blue + ( co >> 1 );
+        const int cg = green - t;
+        planes[0][i] = static_cast<uint16_t>( t + ( cg >> 1 ) + 1 );
+        planes[1][i] = static_cast<uint16_t>( co + 256 );
+        planes[2][i] = static_cast<uint16_t>( cg + 256 );
+    }
+
+    // Compress Depth and Color Planes
+    KeyframeInfo info;
+    info.width = width;
+    info.height = height;
+    info.camera = camera;
+    info.worldToCamera = worldToCamera;
+    info.depthBytes = static_cast<uint32_t>( encoder.encode( depth, encoded[0] ) );
+    for( int plane = 0; plane < 3; plane++ ){
+        info.colorBytes[plane] = static_cast<uint32_t>( encoder.encode( &planes[plane][0], encoded[plane + 1] ) );
+    }
+    const size_t bytes = compressedSize( info );
+
+    if( bytes <= arena.size() ){
+        // Copy to Arena
+        info.resident = true;
+        info.offset = allocate( bytes );
+        uint8_t* out = &arena[info.offset];
+        for( const std::vector<uint8_t>& part : encoded ){
+            std::memcpy( out, part.data(), part.size() );
+            out += part.size();
+        }
+        tail = info.offset + bytes;
+    }
+    else{
+        // Write Keyframe Larger than Arena to Spill File Directly ( after Resident Keyframes to Keep Order )
+        while( firstResident < keyframes.size() ){
+            spill();
+        }
+        if( spillFile == nullptr ){
+            spillFile = fopen( spillPath.c_str(), "w+b" );
+            if( spillFile == nullptr ){
+                throw std::runtime_error( "failed to open keyframe spill file ( " + spillPath + " )" );
+            }
+        }
+        seekFile( spillFile, spillSize );
+        for( const std::vector<uint8_t>& part : encoded ){
+            if( fwrite( part.data(), 1, part.size(), spillFile ) != part.size() ){
+                throw std::runtime_error( "failed to write keyframe to spill file" );
+            }
+        }
+        info.resident = false;
+        info.offset = spillSize;
+        spillSize += bytes;
+        firstResident++;
+    }
+
+    keyframes.push_back( info );
+    rawBytes += pixels * ( sizeof( uint16_t ) + sizeof( uint32_t ) );
+    compressedBytes += bytes;
+    return keyframes.size() - 1;
+}
+
+// Allocate Space in Arena
+size_t KeyframeStore::allocate( const size_t bytes )
+{
+    while( true ){
+        if( firstResident == keyframes.size() ){
+            return 0;
+        }
+
+        // Resident Keyframes are [ head, tail ) or Wrapped [ head, end ) + [ 0, tail ) ( Full if tail is head )
+        const size_t head = static_cast<size_t>( keyframes[firstResident].offset );
+        if( tail > head ){
+            if( tail + bytes <= arena.size() ){
+                return tail;
+            }
+            if( bytes <= head ){
+                return 0;
+            }
+        }
+        else if( tail < head && tail + bytes <= head ){
+            return tail;
+        }
+        spill();
+    }
+}
+
+// Spill Oldest Resident Keyframe to File
+void KeyframeStore::spill()
+{
+    KeyframeInfo& info = keyframes[firstResident];
+    if( spillFile == nullptr ){
+        spillFile = fopen( spillPath.c_str(), "w+b" );
+        if( spillFile == nullptr ){
+            throw std::runtime_error( "failed to open keyframe spill file ( " + spillPath + " )" );
+        }
+    }
+
+    const size_t bytes = compressedSize( info );
+    seekFile( spillFile, spillSize );
+    if( fwrite( &arena[static_cast<size_t>( info.offset )], 1, bytes, spillFile ) != bytes ){
+        throw std::runtime_error( "failed to write keyframe to spill file" );
+    }
+    info.resident = false;
+    info.offset = spillSize;
+    spillSize += bytes;
+    firstResident++;
+    if( firstResident == keyframes.size() ){
+        tail = 0;
+    }
+}
+
+// Retrieve Compressed Data of Keyframe
+const uint8_t* KeyframeStore::data( const KeyframeInfo& info ) const
+{
+    if( info.resident ){
+        return &arena[static_cast<size_t>( info.offset )];
+    }
+
+    const size_t bytes = compressedSize( info );
+    spilled.resize( bytes );
+    if( fflush( spillFile ) != 0 ){
+        throw std::runtime_error( "failed to flush keyframe spill file" );
+    }
+    seekFile( spillFile, info.offset );
+    if( fread( spilled.data(), 1, bytes, spillFile ) != bytes ){
+        throw std::runtime_error( "failed to read keyframe from spill file" );
+    }
+    return spilled.data();
+}
+
+// Load Keyframe
+void KeyframeStore::load( const size_t index, uint16_t* depth, uint32_t* color ) const
+{
+    const KeyframeInfo& info = keyframes.at( index );
+    const uint8_t* in = data( info );
+    decoder.decode( in, info.depthBytes, depth );
+    in += info.depthBytes;
+
+    // Decode Color Planes and Convert YCoCg-R to BGRA
+    const size_t pixels = static_cast<size_t>( info.width ) * info.height;
+    decoded.resize( pixels * 3 );
+    for( int plane = 0; plane < 3; plane++ ){
+        decoder.decode( in, info.colorBytes[plane], &decoded[pixels * plane] );
+        in += info.colorBytes[plane];
+    }
+    const uint16_t* luma = &decoded[0];
+    const uint16_t* orange = &decoded[pixels];
+    const uint16_t* purple = &decoded[pixels * 2];
+    for( size_t i = 0; i < pixels; i++ ){
+        if( luma[i] == 0 ){
+            color[i] = 0;
+            continue;
+        }
+        const int cg = static_cast<int>( purple[i] ) - 256;
+        const int co = static_cast<int>( orange[i] ) - 256;
+        const int t = static_cast<int>( luma[i] ) - 1 - ( cg >> 1 );
+        const int green = cg + t;
+        const int blue = t - ( co >> 1 );
+        const int red = blue + co;
+        color[i] = 0xff000000 | ( static_cast<uint32_t>( red ) << 16 ) | ( static_cast<uint32_t>( green ) << 8 ) | static_cast<uint32_t>( blue );
+    }
+}
+
+// Load Keyframe for Texture Baking
+void KeyframeStore::load( const size_t index, const float minDepth, const float maxDepth, TextureKeyframe& keyframe ) const
+{
+    const KeyframeInfo& info = keyframes.at( index );
+    const size_t pixels = static_cast<size_t>( info.width ) * info.height;
+    std::vector<uint16_t> depth( pixels );
+    keyframe.color.resize( pixels );
+    load( index, &depth[0], &keyframe.color[0] );
+
+    // Millimeters -> Meters, Out of Range is Invalid
+    keyframe.depth.resize( pixels );
+    for( size_t i = 0; i < pixels; i++ ){
+        const float value = depth[i] * 0.001f;
+        keyframe.depth[i] = ( minDepth <= value && value <= maxDepth ) ? value : 0.0f;
+    }
+    keyframe.width = info.width;
+    keyframe.height = info.height;
+    keyframe.camera = info.camera;
+    keyframe.worldToCamera = info.worldToCamera;
+}
+
+// Discard All Keyframes
+void KeyframeStore::clear()
+{
+    keyframes.clear();
+    firstResident = 0;
+    tail = 0;
+    spillSize = 0;
+    rawBytes = 0;
+    compressedBytes = 0;
+    if( spillFile != nullptr ){
+        fclose( spillFile );
+        spillFile = nullptr;
+        std::remove( spillPath.c_str() );
+    }
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef __KEYFRAME_STORE__
+#define __KEYFRAME_STORE__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "FusionMath.h"
+#include "DepthCodec.h"
+#include "TextureBaker.h"
+
+// Keyframe Information
+struct KeyframeInfo
+{
+    int width;
+    int height;
+    FusionCamera camera;
+    Matrix4f worldToCamera;
+    uint32_t depthBytes;    // Compressed Sizes
+    uint32_t colorBytes[3]; // Y, Co, Cg Planes
+    bool resident;          // In Memory Arena or Spilled to Disk
+    uint64_t offset;        // Offset in Arena or Spill File
+};
+
+// Keyframe Store
+//
+// Keeps depth ( millimeters as captured ) and registered color of keyframes with their poses compressed losslessly,
+// so the volume can be re-integrated or textured later without re-capturing.
+// Depth is compressed by DepthCodec ( key frames only, so each keyframe decodes on its own ), color is converted to YCoCg-R
+// ( reversible ) and each plane is compressed by the same codec with 0 as invalid pixel, so invalid pixels of registration cost nothing.
+// Compressed keyframes are allocated in a fixed size ring arena in capture order, when a keyframe does not fit,
+// the oldest resident keyframes are spilled to a file ( created when first keyframe is spilled ) to make room.
+class KeyframeStore
+{
+private:
+    std::vector<KeyframeInfo> keyframes;
+    size_t firstResident;   // Keyframes before this are Spilled ( Oldest are Spilled First )
+
+    // Ring Arena ( Resident Keyframes Occupy from Offset of First Resident to Tail )
+    std::vector<uint8_t> arena;
+    size_t tail;
+
+    // Spill File
+    std::string spillPath;
+    FILE* spillFile;
+    uint64_t spillSize;
+
+    // Codec
+    DepthEncoder encoder;
+    mutable DepthDecoder decoder;
+    std::vector<uint16_t> planes[3];
+    std::vector<uint8_t> encoded[4];
+    mutable std::vector<uint8_t> spilled;
+    mutable std::vector<uint16_t> decoded;
+
+    uint64_t rawBytes;
+    uint64_t compressedBytes;
+
+public:
+    // Constructor ( Arena Size in Bytes, Spill File is Created when First Keyframe is Spilled )
+    KeyframeStore( const size_t arenaBytes = 64 * 1024 * 1024, const std::string& spillPath = "keyframes.swap" );
+
+    // Destructor ( Spill File is Removed )
+    ~KeyframeStore();
+
+    KeyframeStore( const KeyframeStore& ) = delete;
+    KeyframeStore& operator=( const KeyframeStore& ) = delete;
+
+    // Add Keyframe ( Depth in Millimeters, 0 is Invalid, Color BGRA Registered to Depth, 0 is Invalid ) and Returns Index
+    size_t add( const uint16_t* depth, const uint32_t* color, const int width, const int height, const FusionCamera& camera, const Matrix4f& worldToCamera );
+
+    // Load Keyframe ( Buffers of width x height, Valid Color is Restored with Alpha 255 )
+    void load( const size_t index, uint16_t* depth, uint32_t* color ) const;
+
+    // Load Keyframe for Texture Baking ( Depth out of Range [ minDepth, maxDepth ] Meters is Invalid, Same as Integrated Depth )
+    void load( const size_t index, const float minDepth, const float maxDepth, TextureKeyframe& keyframe ) const;
+
+    // Discard All Keyframes
+    void clear();
+
+    // Retrieve Keyframe Information
+    size_t size() const { return keyframes.size(); }
+    bool empty() const { return keyframes.empty(); }
+    const KeyframeInfo& getInfo( const size_t index ) const { return keyframes.at( index ); }
+
+    // Retrieve Statistics
+    size_t getResidentKeyframes() const { return keyframes.size() - firstResident; }
+    size_t getSpilledKeyframes() const { return firstResident; }
+    uint64_t getRawBytes() const { return rawBytes; }
+    uint64_t getCompressedBytes() const { return compressedBytes; }
+    size_t getArenaBytes() const { return arena.size(); }
+
+private:
+    // Allocate Space in Arena ( Spill Oldest Keyframes until Fits )
+    size_t allocate( const size_t bytes );
+
+    // Spill Oldest Resident Keyframe to File
+    void spill();
+
+    // Retrieve Compressed Data of Keyframe ( Read from Spill File if Spilled )
+    const uint8_t* data( const KeyframeInfo& info ) const;
+};
+
+#endif // __KEYFRAME_STORE__
\ No newline at end of file
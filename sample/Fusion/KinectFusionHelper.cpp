@@ -25,6 +25,7 @@
 
 // Project includes
 #include "KinectFusionHelper.h"
+#include "ResidualStatistics.h"
 
 /// <summary>
 /// Set Identity in a Matrix4
@@ -182,6 +183,57 @@ bool CameraTransformFailed(const Matrix4 &T_initial, const Matrix4 &T_final, flo
     return failRot || failTrans;
 }
 
+/// <summary>
+/// Test whether the camera moved far enough from a keyframe to take a new keyframe, by looking at the keyframe and current transformation matrix.
+/// Translation is the distance between camera positions (translation of the inverted world to camera transforms),
+/// rotation is the largest difference of the Euler angles.
+/// </summary>
+/// <param name="T_keyframe">The world to camera transform matrix of the keyframe.</param>
+/// <param name="T_current">The world to camera transform matrix of the current frame.</param>
+/// <param name="minTrans">The minimum translation in meters of the camera to take a new keyframe.</param>
+/// <param name="minRotDegrees">The minimum rotation in degrees about the x,y,z axes to take a new keyframe.</param>
+/// <returns>true if camera transformation is greater than or equal to either threshold, otherwise false</returns>
+bool CameraTransformChanged(const Matrix4 &T_keyframe, const Matrix4 &T_current, float minTrans, float minRotDegrees)
+{
+    static const float pi = static_cast<float>(M_PI);
+    const float minRot = (minRotDegrees * pi) / 180.0f;
+
+    // Calculate the deltas
+    float eulerKeyframe[3];
+    float eulerCurrent[3];
+
+    ExtractRot2Euler(T_keyframe, eulerKeyframe);
+    ExtractRot2Euler(T_current, eulerCurrent);
+
+    float positionKeyframe[3];
+    float positionCurrent[3];
+
+    ExtractVector3Translation(InvertMatrix4Pose(T_keyframe), positionKeyframe);
+    ExtractVector3Translation(InvertMatrix4Pose(T_current), positionCurrent);
+
+    float squaredTrans = 0.0f;
+
+    for (int i = 0; i < 3; i++)
+    {
+        // Wrap the angle difference into [-PI, PI], as one angle may be near PI and the other near -PI.
+        float rDelta = fabsf(eulerKeyframe[i] - eulerCurrent[i]);
+        if (rDelta > pi)
+        {
+            rDelta = pi * 2 - rDelta;
+        }
+
+        if (rDelta >= minRot)
+        {
+            return true;
+        }
+
+        const float tDelta = positionKeyframe[i] - positionCurrent[i];
+        squaredTrans += tDelta * tDelta;
+    }
+
+    return squaredTrans >= minTrans * minTrans;
+}
+
 /// <summary>
 /// Invert/Transpose the 3x3 Rotation Matrix Component of a 4x4 matrix
 /// </summary>
@@ -1019,6 +1071,18 @@ HRESULT CopyImageFrame(const NUI_FUSION_IMAGE_FRAME *pSrc, const NUI_FUSION_IMAG
     return hr;
 }
 
+/// <summary>
+/// Copy statistics of the shared residual kernel to DeltaFromReferenceImageStatistics.
+/// </summary>
+static void CopyResidualStatistics(const ResidualStatistics &residualStatistics, DeltaFromReferenceImageStatistics *stats)
+{
+    stats->totalPixels = residualStatistics.totalPixels;
+    stats->zeroPixels = residualStatistics.zeroPixels;
+    stats->validPixels = residualStatistics.validPixels;
+    stats->invalidDepthOutsideVolumePixels = residualStatistics.invalidDepthOutsideVolumePixels;
+    stats->totalValidPixelsDistance = residualStatistics.totalValidPixelsDistance;
+}
+
 /// <summary>
 /// Color the residual/delta image from the AlignDepthFloatToReconstruction call
 /// </summary>
@@ -1062,27 +1126,8 @@ HRESULT ColorResiduals(const NUI_FUSION_IMAGE_FRAME *pFloatDeltaFromReference, c
     unsigned int *pColorBuffer = reinterpret_cast<unsigned int *>(pShadedDeltaFromReference->pFrameBuffer->pBits);
     const float *pFloatBuffer = reinterpret_cast<float *>(pFloatDeltaFromReference->pFrameBuffer->pBits);
 
-    Concurrency::parallel_for(0u, height, [&](unsigned int y)
-    {
-        unsigned int* pColorRow = reinterpret_cast<unsigned int*>(reinterpret_cast<unsigned char*>(pColorBuffer) + (y * pShadedDeltaFromReference->pFrameBuffer->Pitch));
-        const float* pFloatRow = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(pFloatBuffer) + (y * pFloatDeltaFromReference->pFrameBuffer->Pitch));
-
-        for (unsigned int x = 0; x < width; ++x)
-        {
-            float residue = pFloatRow[x];
-            unsigned int color = 0;
-
-            if (residue <= 1.0f)   // Pixel byte ordering: ARGB
-            {
-                color |= (255 << 24);                                                                               // a
-                color |= (static_cast<unsigned char>(255.0f * clamp(1.0f + residue, 0.0f, 1.0f)) << 16);            // r
-                color |= (static_cast<unsigned char>(255.0f * clamp(1.0f - std::abs(residue), 0.0f, 1.0f)) << 8);   // g
-                color |= (static_cast<unsigned char>(255.0f * clamp(1.0f - residue, 0.0f, 1.0f)));                  // b
-            }
-
-            pColorRow[x] = color;
-        }
-    });
+    // Pixel byte ordering: ARGB
+    ShadeResiduals(pFloatBuffer, pFloatDeltaFromReference->pFrameBuffer->Pitch, pColorBuffer, pShadedDeltaFromReference->pFrameBuffer->Pitch, static_cast<int>(width), static_cast<int>(height), nullptr);
 
     return S_OK;
 }
@@ -1114,56 +1159,63 @@ HRESULT CalculateResidualStatistics(const NUI_FUSION_IMAGE_FRAME *pFloatDeltaFro
 
     const float *pFloatBuffer = reinterpret_cast<float *>(pFloatDeltaFromReference->pFrameBuffer->pBits);
 
-    // Measurement stats
-    std::vector<unsigned int> zeroPixelsRow;
-    std::vector<unsigned int> validPixelsRow;
-    std::vector<unsigned int> invalidDepthOutsideVolumePixelsRow;
-    std::vector<float> validPixelDistanceRow;
+    ResidualStatistics residualStatistics;
+    ShadeResiduals(pFloatBuffer, pFloatDeltaFromReference->pFrameBuffer->Pitch, nullptr, 0, static_cast<int>(width), static_cast<int>(height), &residualStatistics);
+    CopyResidualStatistics(residualStatistics, stats);
 
-    zeroPixelsRow.resize(height, 0);
-    validPixelsRow.resize(height, 0);
-    invalidDepthOutsideVolumePixelsRow.resize(height, 0);
-    validPixelDistanceRow.resize(height, 0);
+    return S_OK;
+}
 
-    Concurrency::parallel_for(0u, height, [&](unsigned int y)
+/// <summary>
+/// Color the residual/delta image and calculate its statistics in a single pass over the residual image.
+/// </summary>
+/// <param name="pFloatDeltaFromReference">A pointer to the source FloatDeltaFromReference image.</param>
+/// <param name="pShadedDeltaFromReference">A pointer to the destination ShadedDeltaFromReference image.</param>
+/// <param name="stats">A pointer to a DeltaFromReferenceImageStatistics struct to fill with the statistics.</param>
+/// <returns>S_OK on success, otherwise failure code</returns>
+HRESULT ColorResidualsAndCalculateStatistics(const NUI_FUSION_IMAGE_FRAME *pFloatDeltaFromReference, const NUI_FUSION_IMAGE_FRAME *pShadedDeltaFromReference, DeltaFromReferenceImageStatistics *stats)
+{
+    if (nullptr == pShadedDeltaFromReference || 
+        nullptr == pFloatDeltaFromReference ||
+        nullptr == stats)
     {
-        const float* pFloatRow = reinterpret_cast<const float*>(reinterpret_cast<const unsigned char*>(pFloatBuffer) + (y * pFloatDeltaFromReference->pFrameBuffer->Pitch));
+        return E_INVALIDARG;
+    }
 
-        for (unsigned int x = 0; x < width; ++x)
-        {
-            float residue = pFloatRow[x];
+    if (nullptr == pShadedDeltaFromReference->pFrameBuffer ||
+        nullptr == pFloatDeltaFromReference->pFrameBuffer)
+    {
+        return E_NOINTERFACE;
+    }
 
-            // If the depth was invalid or the depth back-projected outside the volume, the residual is set to 2.0f
-            // However, if the voxel contents are 0 the residual will also return 0 here.
-            if (residue == 0.0f)
-            {
-                ++zeroPixelsRow[y];
-            }
-            else if (residue == 2.0f)
-            {
-                ++invalidDepthOutsideVolumePixelsRow[y];
-            }
-            else if (residue <= 1.0f)   // Pixel byte ordering: ARGB
-            {
-                ++validPixelsRow[y];
-                validPixelDistanceRow[y] += residue;
-            }
-        }
-    });
+    if (pFloatDeltaFromReference->imageType !=  NUI_FUSION_IMAGE_TYPE_FLOAT || pShadedDeltaFromReference->imageType !=  NUI_FUSION_IMAGE_TYPE_COLOR)
+    {
+        return E_INVALIDARG;
+    }
 
-    stats->validPixels = stats->zeroPixels = stats->invalidDepthOutsideVolumePixels = 0;
-    stats->totalValidPixelsDistance = 0;
-    stats->totalPixels = width * height;
+    unsigned int width = pFloatDeltaFromReference->width;
+    unsigned int height = pFloatDeltaFromReference->height;
 
-    for (unsigned int y=0; y<height; ++y)
+    if (0 == width || 0 == height
+        || width != pShadedDeltaFromReference->width 
+        || height != pShadedDeltaFromReference->height)
     {
-        stats->zeroPixels += zeroPixelsRow[y];
-        stats->validPixels += validPixelsRow[y];
-        stats->invalidDepthOutsideVolumePixels += invalidDepthOutsideVolumePixelsRow[y];
+        return E_INVALIDARG;
+    }
 
-        stats->totalValidPixelsDistance += validPixelDistanceRow[y];
+    if (pShadedDeltaFromReference->pFrameBuffer->Pitch == 0
+        || pFloatDeltaFromReference->pFrameBuffer->Pitch == 0)
+    {
+        return E_INVALIDARG;
     }
 
+    unsigned int *pColorBuffer = reinterpret_cast<unsigned int *>(pShadedDeltaFromReference->pFrameBuffer->pBits);
+    const float *pFloatBuffer = reinterpret_cast<float *>(pFloatDeltaFromReference->pFrameBuffer->pBits);
+
+    ResidualStatistics residualStatistics;
+    ShadeResiduals(pFloatBuffer, pFloatDeltaFromReference->pFrameBuffer->Pitch, pColorBuffer, pShadedDeltaFromReference->pFrameBuffer->Pitch, static_cast<int>(width), static_cast<int>(height), &residualStatistics);
+    CopyResidualStatistics(residualStatistics, stats);
+
     return S_OK;
 }
 
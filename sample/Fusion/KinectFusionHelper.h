@@ -58,6 +58,18 @@ void ExtractRot2Euler(const Matrix4 &transform, _Out_cap_c_(3) float *rotation);
 /// <returns>true if camera transformation is greater than the threshold, otherwise false</returns>
 bool CameraTransformFailed(const Matrix4 &T_initial, const Matrix4 &T_final, float maxTrans, float maxRotDegrees);
 
+/// <summary>
+/// Test whether the camera moved far enough from a keyframe to take a new keyframe, by looking at the keyframe and current transformation matrix.
+/// Translation is the distance between camera positions (translation of the inverted world to camera transforms),
+/// rotation is the largest difference of the Euler angles.
+/// </summary>
+/// <param name="T_keyframe">The world to camera transform matrix of the keyframe.</param>
+/// <param name="T_current">The world to camera transform matrix of the current frame.</param>
+/// <param name="minTrans">The minimum translation in meters of the camera to take a new keyframe.</param>
+/// <param name="minRotDegrees">The minimum rotation in degrees about the x,y,z axes to take a new keyframe.</param>
+/// <returns>true if camera transformation is greater than or equal to either threshold, otherwise false</returns>
+bool CameraTransformChanged(const Matrix4 &T_keyframe, const Matrix4 &T_current, float minTrans, float minRotDegrees);
+
 /// <summary>
 /// Invert the 3x3 Rotation Matrix Component of a 4x4 matrix
 /// </summary>
@@ -195,6 +207,15 @@ struct DeltaFromReferenceImageStatistics
 /// <returns>S_OK on success, otherwise failure code</returns>
 HRESULT CalculateResidualStatistics(const NUI_FUSION_IMAGE_FRAME *pFloatDeltaFromReference, DeltaFromReferenceImageStatistics *stats);
 
+/// <summary>
+/// Color the residual/delta image and calculate its statistics in a single pass over the residual image.
+/// </summary>
+/// <param name="pFloatDeltaFromReference">A pointer to the source FloatDeltaFromReference image.</param>
+/// <param name="pShadedDeltaFromReference">A pointer to the destination ShadedDeltaFromReference image.</param>
+/// <param name="stats">A pointer to a DeltaFromReferenceImageStatistics struct to fill with the statistics.</param>
+/// <returns>S_OK on success, otherwise failure code</returns>
+HRESULT ColorResidualsAndCalculateStatistics(const NUI_FUSION_IMAGE_FRAME *pFloatDeltaFromReference, const NUI_FUSION_IMAGE_FRAME *pShadedDeltaFromReference, DeltaFromReferenceImageStatistics *stats);
+
 /// <summary>
 /// Down sample color, depth float or point cloud frame with nearest neighbor
 /// </summary>
@@ -0,0 +1,394 @@
+#include "MeshExtractor.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Cube of Cell ( Corner c is at x = c >> 2, y = ( c >> 1 ) & 1, z = c & 1 )
+    // Faces Left/Right ( x ), Bottom/Top ( y ), Near/Far ( z ), Edges are named by 2 Faces they belong to.
+    enum Face { L, R, B, T, N, F };
+    enum Corner { LBN, LBF, LTN, LTF, RBN, RBF, RTN, RTF };
+    enum Edge { LB, LT, LN, LF, RB, RT, RN, RF, BN, BF, TN, TF };
+
+    const int corner1[12] = { LBN, LTN, LBN, LBF, RBN, RTN, RBN, RBF, LBN, LBF, LTN, LTF };
+    const int corner2[12] = { LBF, LTF, LTN, LTF, RBF, RTF, RTN, RTF, RBN, RBF, RTN, RTF };
+    const int leftFace[12] = { B, L, L, F, R, T, N, R, N, B, T, F };
+    const int rightFace[12] = { L, T, N, L, B, R, R, F, B, F, N, T };
+
+    // Next Edge Clockwise around Face
+    int nextEdge( const int edge, const int face )
+    {
+        switch( edge ){
+            case LB: return ( face == L ) ? LF : BN;
+            case LT: return ( face == L ) ? LN : TF;
+            case LN: return ( face == L ) ? LB : TN;
+            case LF: return ( face == L ) ? LT : BF;
+            case RB: return ( face == R ) ? RN : BF;
+            case RT: return ( face == R ) ? RF : TN;
+            case RN: return ( face == R ) ? RT : BN;
+            case RF: return ( face == R ) ? RB : TF;
+            case BN: return ( face == B ) ? RB : LN;
+            case BF: return ( face == B ) ? LB : RF;
+            case TN: return ( face == T ) ? LT : RN;
+            default: return ( face == T ) ? RT : LF;
+        }
+    }
+
+    // Triangle Table of Marching Cubes
+    // Built by walking the intersected edges around the cube faces ( J. Bloomenthal, An Implicit Surface Polygonizer ),
+    // ambiguous faces are resolved the same way from both sides, so the surface is watertight.
+    struct CubeTable
+    {
+        std::vector<uint8_t> triangles[256]; // Edges, 3 per Triangle
+    };
+
+    CubeTable buildCubeTable()
+    {
+        CubeTable table;
+        for( int index = 0; index < 256; index++ ){
+            bool inside[8];
+            for( int corner = 0; corner < 8; corner++ ){
+                inside[corner] = ( ( index >> corner ) & 1 ) != 0;
+            }
+
+            bool done[12] = {};
+            for( int start = 0; start < 12; start++ ){
+                if( done[start] || inside[corner1[start]] == inside[corner2[start]] ){
+                    continue;
+                }
+
+                // Walk Polygon around Faces
+                std::vector<uint8_t> polygon;
+                int edge = start;
+                int face = inside[corner1[start]] ? rightFace[start] : leftFace[start];
+                while( true ){
+                    edge = nextEdge( edge, face );
+                    done[edge] = true;
+                    if( inside[corner1[edge]] != inside[corner2[edge]] ){
+                        polygon.push_back( static_cast<uint8_t>( edge ) );
+                        if( edge == start ){
+                            break;
+                        }
+                        face = ( face == leftFace[edge] ) ? rightFace[edge] : leftFace[edge];
+                    }
+                }
+
+                // Triangle Fan ( Counter Clockwise Seen from Outside )
+                // Fan is started from the edge whose diagonals don't join 2 edges on same face, such a diagonal is
+                // also made by the cube on other side of the face, and the surface would be pinched there.
+                const size_t count = polygon.size();
+                size_t first = 0;
+                int minimum = 12;
+                for( size_t candidate = 0; candidate < count; candidate++ ){
+                    int shared = 0;
+                    for( size_t i = 2; i + 1 < count; i++ ){
+                        const int a = polygon[candidate];
+                        const int b = polygon[( candidate + i ) % count];
+                        shared += ( leftFace[a] == leftFace[b] || leftFace[a] == rightFace[b] || rightFace[a] == leftFace[b] || rightFace[a] == rightFace[b] );
+                    }
+                    if( shared < minimum ){
+                        minimum = shared;
+                        first = candidate;
+                    }
+                }
+                for( size_t i = 1; i + 1 < count; i++ ){
+                    table.triangles[index].push_back( polygon[first] );
+                    table.triangles[index].push_back( polygon[( first + i + 1 ) % count] );
+                    table.triangles[index].push_back( polygon[( first + i ) % count] );
+                }
+            }
+        }
+        return table;
+    }
+
+    const CubeTable& cubeTable()
+    {
+        static const CubeTable table = buildCubeTable();
+        return table;
+    }
+
+    // Voxels of Brick and +X, +Y, +Z Neighbors ( 9 x 9 x 9 )
+    const int blockSize = TsdfBrick::size + 1;
+
+    struct Block
+    {
+        float tsdf[blockSize * blockSize * blockSize];
+        uint32_t color[blockSize * blockSize * blockSize];
+        bool observed[blockSize * blockSize * blockSize];
+    };
+
+    inline int blockIndex( const int x, const int y, const int z )
+    {
+        return ( z * blockSize + y ) * blockSize + x;
+    }
+
+    // Load Block ( Returns false if no Voxel of Brick is Observed )
+    bool loadBlock( const TsdfGrid& grid, const int x, const int y, const int z, Block& block )
+    {
+        const TsdfBrick* bricks[8];
+        for( int i = 0; i < 8; i++ ){
+            bricks[i] = grid.findBrick( x + ( i & 1 ), y + ( ( i >> 1 ) & 1 ), z + ( ( i >> 2 ) & 1 ) );
+        }
+
+        bool observed = false;
+        for( int i = 0; i < TsdfBrick::voxelCount && bricks[0] != nullptr; i++ ){
+            observed |= ( bricks[0]->weight[i] != 0 );
+        }
+        if( !observed ){
+            return false;
+        }
+
+        for( int vz = 0; vz < blockSize; vz++ ){
+            for( int vy = 0; vy < blockSize; vy++ ){
+                for( int vx = 0; vx < blockSize; vx++ ){
+                    const int neighbor = ( vx >> 3 ) | ( ( vy >> 3 ) << 1 ) | ( ( vz >> 3 ) << 2 );
+                    const int index = blockIndex( vx, vy, vz );
+                    const TsdfBrick* brick = bricks[neighbor];
+                    if( brick == nullptr ){
+                        block.observed[index] = false;
+                        continue;
+                    }
+
+                    const int voxel = ( ( vz & 7 ) * TsdfBrick::size + ( vy & 7 ) ) * TsdfBrick::size + ( vx & 7 );
+                    block.tsdf[index] = brick->tsdf[voxel] / 32767.0f;
+                    block.color[index] = brick->color[voxel];
+                    block.observed[index] = ( brick->weight[voxel] != 0 );
+                }
+            }
+        }
+        return true;
+    }
+
+    // Interpolate Colors per Channel
+    inline uint32_t lerpColor( const uint32_t a, const uint32_t b, const float t )
+    {
+        uint32_t result = 0;
+        for( int shift = 0; shift < 32; shift += 8 ){
+            const float ca = static_cast<float>( ( a >> shift ) & 0xff );
+            const float cb = static_cast<float>( ( b >> shift ) & 0xff );
+            result |= static_cast<uint32_t>( ca + ( cb - ca ) * t + 0.5f ) << shift;
+        }
+        return result;
+    }
+
+    // Edge of Vertex on Brick Face ( Global Voxel Coordinates of Minimum Corner and Axis )
+    struct EdgeKey
+    {
+        int32_t voxel[3];
+        int32_t axis;
+
+        bool operator==( const EdgeKey& other ) const
+        {
+            return voxel[0] == other.voxel[0] && voxel[1] == other.voxel[1] && voxel[2] == other.voxel[2] && axis == other.axis;
+        }
+    };
+
+    struct EdgeKeyHash
+    {
+        size_t operator()( const EdgeKey& key ) const
+        {
+            uint64_t hash = static_cast<uint32_t>( key.voxel[0] ) * 0x9e3779b97f4a7c15ull;
+            hash ^= ( hash >> 29 ) ^ ( static_cast<uint32_t>( key.voxel[1] ) * 0xbf58476d1ce4e5b9ull );
+            hash ^= ( hash >> 31 ) ^ ( static_cast<uint32_t>( key.voxel[2] * 3 + key.axis ) * 0x94d049bb133111ebull );
+            return static_cast<size_t>( hash ^ ( hash >> 32 ) );
+        }
+    };
+
+    // Decode Edge of Vertex ( Returns true if Edge is on Brick Face )
+    inline bool decodeEdge( const uint16_t edge, int* voxel, int& axis )
+    {
+        axis = edge % 3;
+        const int index = edge / 3;
+        voxel[0] = index % blockSize;
+        voxel[1] = ( index / blockSize ) % blockSize;
+        voxel[2] = index / ( blockSize * blockSize );
+
+        const int u = voxel[axis == 0 ? 1 : 0];
+        const int v = voxel[axis == 2 ? 1 : 2];
+        return u == 0 || u == TsdfBrick::size || v == 0 || v == TsdfBrick::size;
+    }
+}
+
+// Constructor
+MeshExtractor::MeshExtractor()
+{
+    cubeTable();
+}
+
+// Re-mesh Bricks Changed since Last Update
+size_t MeshExtractor::update( const TsdfGrid& grid )
+{
+    // Changed Bricks and their -X, -Y, -Z Neighbors
+    std::vector<uint64_t> dirty;
+    grid.forEachResidentBrick( [&]( const int x, const int y, const int z, const TsdfBrick& brick ){
+        const uint64_t key = PackBrickKey( x, y, z );
+        std::unordered_map<uint64_t, uint32_t>::iterator found = versions.find( key );
+        if( found != versions.end() && found->second == brick.version ){
+            return;
+        }
+        versions[key] = brick.version;
+
+        for( int i = 0; i < 8; i++ ){
+            dirty.push_back( PackBrickKey( x - ( i & 1 ), y - ( ( i >> 1 ) & 1 ), z - ( ( i >> 2 ) & 1 ) ) );
+        }
+    } );
+    std::sort( dirty.begin(), dirty.end() );
+    dirty.erase( std::unique( dirty.begin(), dirty.end() ), dirty.end() );
+
+    // Keep Mesh of Bricks that are not in Memory
+    dirty.erase( std::remove_if( dirty.begin(), dirty.end(), [&]( const uint64_t key ){
+        int x, y, z;
+        UnpackBrickKey( key, x, y, z );
+        return grid.findBrick( x, y, z ) == nullptr;
+    } ), dirty.end() );
+
+    // Mesh Dirty Bricks in Parallel
+    std::vector<BrickMesh> results( dirty.size() );
+    ThreadPool::global().parallelFor( dirty.size(), [&]( const size_t i ){
+        int x, y, z;
+        UnpackBrickKey( dirty[i], x, y, z );
+        meshBrick( grid, x, y, z, results[i] );
+    } );
+
+    for( size_t i = 0; i < dirty.size(); i++ ){
+        if( results[i].indices.empty() ){
+            meshes.erase( dirty[i] );
+        }
+        else{
+            meshes[dirty[i]] = std::move( results[i] );
+        }
+    }
+    return dirty.size();
+}
+
+// Mesh Cells of Brick
+void MeshExtractor::meshBrick( const TsdfGrid& grid, const int x, const int y, const int z, BrickMesh& mesh )
+{
+    std::vector<Block> blocks( 1 );
+    Block& block = blocks[0];
+    if( !loadBlock( grid, x, y, z, block ) ){
+        return;
+    }
+
+    const CubeTable& table = cubeTable();
+    const float voxelSize = 1.0f / grid.getParameters().voxelsPerMeter;
+    const float* origin = grid.getOrigin();
+
+    // Vertex Index of Edges ( Minimum Corner in Block, Axis )
+    std::vector<int> edgeVertex( blockSize * blockSize * blockSize * 3, -1 );
+
+    for( int cz = 0; cz < TsdfBrick::size; cz++ ){
+        for( int cy = 0; cy < TsdfBrick::size; cy++ ){
+            for( int cx = 0; cx < TsdfBrick::size; cx++ ){
+                // Case of Cell ( Inside is Behind Surface )
+                int index = 0;
+                bool observed = true;
+                for( int corner = 0; corner < 8; corner++ ){
+                    const int voxel = blockIndex( cx + ( corner >> 2 ), cy + ( ( corner >> 1 ) & 1 ), cz + ( corner & 1 ) );
+                    observed &= block.observed[voxel];
+                    index |= ( block.tsdf[voxel] < 0.0f ? 1 : 0 ) << corner;
+                }
+                if( !observed || index == 0 || index == 255 ){
+                    continue;
+                }
+
+                const std::vector<uint8_t>& edges = table.triangles[index];
+                for( size_t i = 0; i < edges.size(); i++ ){
+                    // Minimum Corner and Axis of Edge
+                    const int edge = edges[i];
+                    const int a = corner1[edge];
+                    const int b = corner2[edge];
+                    const int vx = cx + ( a >> 2 );
+                    const int vy = cy + ( ( a >> 1 ) & 1 );
+                    const int vz = cz + ( a & 1 );
+                    const int axis = ( ( a ^ b ) == 4 ) ? 0 : ( ( a ^ b ) == 2 ) ? 1 : 2;
+
+                    int& vertex = edgeVertex[blockIndex( vx, vy, vz ) * 3 + axis];
+                    if( vertex < 0 ){
+                        // Zero Crossing
+                        const int first = blockIndex( vx, vy, vz );
+                        const int second = blockIndex( vx + ( axis == 0 ), vy + ( axis == 1 ), vz + ( axis == 2 ) );
+                        const float t = block.tsdf[first] / ( block.tsdf[first] - block.tsdf[second] );
+                        float position[3] = {
+                            static_cast<float>( x * TsdfBrick::size + vx ),
+                            static_cast<float>( y * TsdfBrick::size + vy ),
+                            static_cast<float>( z * TsdfBrick::size + vz )
+                        };
+                        position[axis] += t;
+
+                        vertex = static_cast<int>( mesh.edges.size() );
+                        for( int k = 0; k < 3; k++ ){
+                            mesh.vertices.push_back( ( position[k] - origin[k] ) * voxelSize );
+                        }
+                        mesh.colors.push_back( lerpColor( block.color[first], block.color[second], t ) );
+                        mesh.edges.push_back( static_cast<uint16_t>( first * 3 + axis ) );
+                    }
+                    mesh.indices.push_back( static_cast<uint16_t>( vertex ) );
+                }
+            }
+        }
+    }
+}
+
+// Retrieve Stitched Mesh of All Bricks
+void MeshExtractor::getMesh( IndexedMesh& mesh ) const
+{
+    mesh.vertices.clear();
+    mesh.colors.clear();
+    mesh.texcoords.clear();
+    mesh.indices.clear();
+
+    // Bricks in Key Order for Deterministic Output
+    std::vector<uint64_t> keys;
+    keys.reserve( meshes.size() );
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for( const std::pair<const uint64_t, BrickMesh>& entry : meshes ){
+        keys.push_back( entry.first );
+        vertexCount += entry.second.edges.size();
+        indexCount += entry.second.indices.size();
+    }
+    std::sort( keys.begin(), keys.end() );
+    mesh.vertices.reserve( vertexCount * 3 );
+    mesh.colors.reserve( vertexCount );
+    mesh.indices.reserve( indexCount );
+
+    // Append Interior Vertices, Weld Vertices on Brick Faces
+    std::unordered_map<EdgeKey, uint32_t, EdgeKeyHash> shared;
+    std::vector<uint32_t> remap;
+    for( const uint64_t key : keys ){
+        int x, y, z;
+        UnpackBrickKey( key, x, y, z );
+        const BrickMesh& brick = meshes.at( key );
+        remap.resize( brick.edges.size() );
+        for( size_t i = 0; i < brick.edges.size(); i++ ){
+            const uint32_t next = static_cast<uint32_t>( mesh.colors.size() );
+            EdgeKey edge;
+            if( decodeEdge( brick.edges[i], edge.voxel, edge.axis ) ){
+                edge.voxel[0] += x * TsdfBrick::size;
+                edge.voxel[1] += y * TsdfBrick::size;
+                edge.voxel[2] += z * TsdfBrick::size;
+                const std::pair<std::unordered_map<EdgeKey, uint32_t, EdgeKeyHash>::iterator, bool> inserted = shared.emplace( edge, next );
+                if( !inserted.second ){
+                    remap[i] = inserted.first->second;
+                    continue;
+                }
+            }
+            remap[i] = next;
+            mesh.vertices.insert( mesh.vertices.end(), &brick.vertices[i * 3], &brick.vertices[i * 3] + 3 );
+            mesh.colors.push_back( brick.colors[i] );
+        }
+
+        for( const uint16_t index : brick.indices ){
+            mesh.indices.push_back( remap[index] );
+        }
+    }
+}
+
+// Discard All Meshes
+void MeshExtractor::reset()
+{
+    versions.clear();
+    meshes.clear();
+}
\ No newline at end of file
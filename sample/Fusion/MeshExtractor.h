@@ -0,0 +1,55 @@
+#ifndef __MESH_EXTRACTOR__
+#define __MESH_EXTRACTOR__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "TsdfVolume.h"
+#include "MeshWriter.h"
+
+// Incremental Marching Cubes Mesh Extractor
+//
+// Keeps a mesh for each brick ( cells whose minimum corner is in the brick ), and re-meshes only bricks that changed since last update.
+// A brick is changed when its version differs from the version at last update, and the cells of a brick also read voxels of its
+// +X, +Y, +Z neighbors, so the bricks at -X, -Y, -Z of a changed brick are re-meshed as well.
+// Vertices on brick faces are also made by neighboring bricks from same voxels, getMesh() welds them by global edge
+// and stitches all bricks into one indexed mesh.
+// Cells are meshed only where all 8 corners are observed, vertex colors are interpolated along edges.
+class MeshExtractor
+{
+private:
+    // Mesh of Brick
+    struct BrickMesh
+    {
+        std::vector<float> vertices;   // x, y, z in World
+        std::vector<uint32_t> colors;  // BGRA
+        std::vector<uint16_t> edges;   // Edge of Vertex ( Index of Minimum Corner in 9 x 9 x 9 Block * 3 + Axis )
+        std::vector<uint16_t> indices; // 3 per Triangle
+    };
+
+    std::unordered_map<uint64_t, uint32_t> versions;
+    std::unordered_map<uint64_t, BrickMesh> meshes;
+
+public:
+    // Constructor
+    MeshExtractor();
+
+    // Re-mesh Bricks Changed since Last Update ( Returns Number of Re-meshed Bricks )
+    size_t update( const TsdfGrid& grid );
+
+    // Retrieve Stitched Mesh of All Bricks
+    void getMesh( IndexedMesh& mesh ) const;
+
+    // Discard All Meshes ( Call when Volume is Reset )
+    void reset();
+
+    // Retrieve Number of Bricks that have Triangles
+    size_t getMeshedBricks() const { return meshes.size(); }
+
+private:
+    // Mesh Cells of Brick
+    static void meshBrick( const TsdfGrid& grid, const int x, const int y, const int z, BrickMesh& mesh );
+};
+
+#endif // __MESH_EXTRACTOR__
\ No newline at end of file
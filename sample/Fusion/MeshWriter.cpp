@@ -0,0 +1,410 @@
+#include "MeshWriter.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // Elements per Encoding Task
+    const size_t chunkSize = 65536;
+
+    size_t chunkCount( const size_t count )
+    {
+        return ( count + chunkSize - 1 ) / chunkSize;
+    }
+
+    // Position Bits ( -0.0 is Normalized to 0.0 )
+    inline void positionBits( const float* vertex, uint32_t* bits )
+    {
+        for( int i = 0; i < 3; i++ ){
+            const float value = vertex[i] + 0.0f;
+            std::memcpy( &bits[i], &value, sizeof( float ) );
+        }
+    }
+
+    inline uint32_t hashPosition( const uint32_t* bits )
+    {
+        uint64_t hash = bits[0] * 0x9e3779b97f4a7c15ull;
+        hash ^= ( hash >> 29 ) ^ ( bits[1] * 0xbf58476d1ce4e5b9ull );
+        hash ^= ( hash >> 31 ) ^ ( bits[2] * 0x94d049bb133111ebull );
+        return static_cast<uint32_t>( hash ^ ( hash >> 32 ) );
+    }
+
+    // Transformed Vertex ( Flip Y and Z, Same as KinectFusionHelper )
+    inline void loadVertex( const IndexedMesh& mesh, const size_t index, const bool flipYZ, float* vertex )
+    {
+        const float* source = &mesh.vertices[index * 3];
+        vertex[0] = source[0];
+        vertex[1] = flipYZ ? -source[1] : source[1];
+        vertex[2] = flipYZ ? -source[2] : source[2];
+    }
+
+    // Write Buffers to File in Order
+    void writeFile( const std::string& fileName, const std::vector<std::vector<char>>& buffers )
+    {
+        FILE* file = fopen( fileName.c_str(), "wb" );
+        if( file == nullptr ){
+            throw std::runtime_error( "failed to open mesh file ( " + fileName + " )" );
+        }
+
+        bool succeeded = true;
+        for( const std::vector<char>& buffer : buffers ){
+            succeeded &= buffer.empty() || fwrite( buffer.data(), 1, buffer.size(), file ) == buffer.size();
+        }
+        succeeded &= ( fclose( file ) == 0 );
+        if( !succeeded ){
+            throw std::runtime_error( "failed to write mesh file ( " + fileName + " )" );
+        }
+    }
+
+    // Append Unsigned Integer
+    inline char* appendUnsigned( char* out, uint64_t value )
+    {
+        char digits[20];
+        int count = 0;
+        do{
+            digits[count++] = static_cast<char>( '0' + value % 10 );
+            value /= 10;
+        } while( value != 0 );
+        while( count > 0 ){
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+
+    // Append Float ( Same Result as %f, Rounding to Nearest Even )
+    inline char* appendFixed( char* out, const float value )
+    {
+        // Product of Float and 10^6 is Exact in Double
+        double magnitude = std::fabs( static_cast<double>( value ) );
+        if( !( magnitude < 1.0e12 ) ){
+            return out + sprintf( out, "%f", value );
+        }
+        if( std::signbit( value ) ){
+            *out++ = '-';
+        }
+        const uint64_t scaled = static_cast<uint64_t>( std::nearbyint( magnitude * 1.0e6 ) );
+        out = appendUnsigned( out, scaled / 1000000 );
+        *out++ = '.';
+        uint64_t fraction = scaled % 1000000;
+        for( int i = 5; i >= 0; i-- ){
+            out[i] = static_cast<char>( '0' + fraction % 10 );
+            fraction /= 10;
+        }
+        return out + 6;
+    }
+
+    // Write ASCII OBJ ( Texture Coordinates are Written if Mesh has them )
+    void writeObj( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ, const std::string& material )
+    {
+        const size_t vertexCount = mesh.vertexCount();
+        const size_t triangleCount = mesh.triangleCount();
+        const bool texture = !mesh.texcoords.empty();
+
+        // Encode Chunks in Parallel, then Write in Order
+        const size_t vertexChunks = chunkCount( vertexCount );
+        std::vector<std::vector<char>> buffers( 1 + vertexChunks + chunkCount( triangleCount ) );
+        const std::string header = "# " + std::to_string( vertexCount ) + " vertices, " + std::to_string( triangleCount ) + " triangles\n" + material;
+        buffers[0].assign( header.begin(), header.end() );
+
+        ThreadPool::global().parallelFor( buffers.size() - 1, [&]( const size_t chunk ){
+            std::vector<char>& buffer = buffers[chunk + 1];
+            if( chunk < vertexChunks ){
+                // "v x y z\n" is at most 2 + 3 * 48 Characters ( FLT_MAX with %f ), "vt u v\n" is at most 3 + 2 * 48 Characters
+                const size_t lineSize = texture ? 245 : 146;
+                const size_t begin = chunk * chunkSize;
+                const size_t end = std::min( vertexCount, begin + chunkSize );
+                buffer.resize( ( end - begin ) * ( texture ? 64 : 40 ) + lineSize );
+                char* out = buffer.data();
+                for( size_t i = begin; i < end; i++ ){
+                    // Grow Buffer for Large Coordinates
+                    if( static_cast<size_t>( buffer.data() + buffer.size() - out ) < lineSize ){
+                        const size_t used = out - buffer.data();
+                        buffer.resize( buffer.size() * 2 );
+                        out = buffer.data() + used;
+                    }
+                    float vertex[3];
+                    loadVertex( mesh, i, flipYZ, vertex );
+                    *out++ = 'v';
+                    for( int axis = 0; axis < 3; axis++ ){
+                        *out++ = ' ';
+                        out = appendFixed( out, vertex[axis] );
+                    }
+                    *out++ = '\n';
+                    if( texture ){
+                        *out++ = 'v';
+                        *out++ = 't';
+                        for( int axis = 0; axis < 2; axis++ ){
+                            *out++ = ' ';
+                            out = appendFixed( out, mesh.texcoords[i * 2 + axis] );
+                        }
+                        *out++ = '\n';
+                    }
+                }
+                buffer.resize( out - buffer.data() );
+            }
+            else{
+                // "f a b c\n" is at most 2 + 3 * 11 Characters, "f a/a b/b c/c\n" is at most 2 + 3 * 23 Characters, Indices are 1 Based
+                const size_t begin = ( chunk - vertexChunks ) * chunkSize;
+                const size_t end = std::min( triangleCount, begin + chunkSize );
+                buffer.resize( ( end - begin ) * ( texture ? 72 : 40 ) );
+                char* out = buffer.data();
+                for( size_t t = begin; t < end; t++ ){
+                    *out++ = 'f';
+                    for( int corner = 0; corner < 3; corner++ ){
+                        const uint64_t index = static_cast<uint64_t>( mesh.indices[t * 3 + corner] ) + 1;
+                        *out++ = ' ';
+                        out = appendUnsigned( out, index );
+                        if( texture ){
+                            *out++ = '/';
+                            out = appendUnsigned( out, index );
+                        }
+                    }
+                    *out++ = '\n';
+                }
+                buffer.resize( out - buffer.data() );
+            }
+        } );
+
+        writeFile( fileName, buffers );
+    }
+}
+
+// Weld Triangle Soup to Indexed Mesh
+void WeldMesh( const float* vertices, const uint32_t* colors, const size_t vertexCount, IndexedMesh& mesh )
+{
+    if( vertexCount % 3 != 0 || vertexCount > 0xffffffffull ){
+        throw std::invalid_argument( "invalid number of vertices" );
+    }
+
+    mesh.vertices.clear();
+    mesh.colors.clear();
+    mesh.texcoords.clear();
+    mesh.indices.clear();
+
+    // Hash Positions in Parallel
+    std::vector<uint32_t> hashes( vertexCount );
+    ThreadPool::global().parallelFor( chunkCount( vertexCount ), [&]( const size_t chunk ){
+        const size_t end = std::min( vertexCount, ( chunk + 1 ) * chunkSize );
+        uint32_t bits[3];
+        for( size_t i = chunk * chunkSize; i < end; i++ ){
+            positionBits( &vertices[i * 3], bits );
+            hashes[i] = hashPosition( bits );
+        }
+    } );
+
+    // Insert to Open Addressing Table ( Typically a Vertex is Shared by 6 Triangles )
+    const uint32_t empty = 0xffffffff;
+    size_t capacity = 1024;
+    while( capacity < vertexCount / 3 ){
+        capacity *= 2;
+    }
+    std::vector<uint32_t> table( capacity, empty );
+    std::vector<uint32_t> uniqueHashes;
+    std::vector<uint32_t> remap( vertexCount );
+    mesh.vertices.reserve( vertexCount / 2 );
+    if( colors != nullptr ){
+        mesh.colors.reserve( vertexCount / 6 );
+    }
+
+    for( size_t i = 0; i < vertexCount; i++ ){
+        uint32_t bits[3];
+        positionBits( &vertices[i * 3], bits );
+
+        size_t slot = hashes[i] & ( capacity - 1 );
+        while( true ){
+            const uint32_t id = table[slot];
+            if( id == empty ){
+                // New Vertex
+                const uint32_t created = static_cast<uint32_t>( uniqueHashes.size() );
+                table[slot] = created;
+                uniqueHashes.push_back( hashes[i] );
+                for( int axis = 0; axis < 3; axis++ ){
+                    float value;
+                    std::memcpy( &value, &bits[axis], sizeof( float ) );
+                    mesh.vertices.push_back( value );
+                }
+                if( colors != nullptr ){
+                    mesh.colors.push_back( colors[i] );
+                }
+                remap[i] = created;
+                break;
+            }
+            if( uniqueHashes[id] == hashes[i] && std::memcmp( &mesh.vertices[id * 3], bits, sizeof( bits ) ) == 0 ){
+                remap[i] = id;
+                break;
+            }
+            slot = ( slot + 1 ) & ( capacity - 1 );
+        }
+
+        // Grow Table at Load Factor 0.5
+        if( uniqueHashes.size() * 2 > capacity ){
+            capacity *= 2;
+            std::fill( table.begin(), table.end(), empty );
+            table.resize( capacity, empty );
+            for( uint32_t id = 0; id < uniqueHashes.size(); id++ ){
+                size_t position = uniqueHashes[id] & ( capacity - 1 );
+                while( table[position] != empty ){
+                    position = ( position + 1 ) & ( capacity - 1 );
+                }
+                table[position] = id;
+            }
+        }
+    }
+
+    // Triangles ( Drop Collapsed )
+    mesh.indices.reserve( vertexCount );
+    for( size_t i = 0; i < vertexCount; i += 3 ){
+        const uint32_t a = remap[i];
+        const uint32_t b = remap[i + 1];
+        const uint32_t c = remap[i + 2];
+        if( a != b && b != c && c != a ){
+            mesh.indices.push_back( a );
+            mesh.indices.push_back( b );
+            mesh.indices.push_back( c );
+        }
+    }
+}
+
+// Write Binary Little Endian PLY
+void WritePlyMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ, const bool outputColor )
+{
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.triangleCount();
+    const bool color = outputColor && !mesh.colors.empty();
+    if( color && mesh.colors.size() != vertexCount ){
+        throw std::invalid_argument( "invalid number of colors" );
+    }
+
+    // Header
+    std::string header = "ply\nformat binary_little_endian 1.0\n";
+    header += "element vertex " + std::to_string( vertexCount ) + "\nproperty float x\nproperty float y\nproperty float z\n";
+    if( color ){
+        header += "property uchar red\nproperty uchar green\nproperty uchar blue\n";
+    }
+    header += "element face " + std::to_string( triangleCount ) + "\nproperty list uchar int vertex_index\nend_header\n";
+
+    // Encode Vertices and Faces into Single Buffer in Parallel ( Fixed Size Records )
+    const size_t vertexSize = 3 * sizeof( float ) + ( color ? 3 : 0 );
+    const size_t faceSize = 1 + 3 * sizeof( int32_t );
+    std::vector<std::vector<char>> buffers( 1 );
+    std::vector<char>& buffer = buffers[0];
+    buffer.resize( header.size() + vertexCount * vertexSize + triangleCount * faceSize );
+    std::memcpy( buffer.data(), header.data(), header.size() );
+    char* vertexData = buffer.data() + header.size();
+    char* faceData = vertexData + vertexCount * vertexSize;
+
+    const size_t vertexChunks = chunkCount( vertexCount );
+    ThreadPool::global().parallelFor( vertexChunks + chunkCount( triangleCount ), [&]( const size_t chunk ){
+        if( chunk < vertexChunks ){
+            const size_t end = std::min( vertexCount, ( chunk + 1 ) * chunkSize );
+            char* out = vertexData + chunk * chunkSize * vertexSize;
+            for( size_t i = chunk * chunkSize; i < end; i++ ){
+                float vertex[3];
+                loadVertex( mesh, i, flipYZ, vertex );
+                std::memcpy( out, vertex, sizeof( vertex ) );
+                out += sizeof( vertex );
+                if( color ){
+                    const uint32_t value = mesh.colors[i];
+                    out[0] = static_cast<char>( ( value >> 16 ) & 255 );
+                    out[1] = static_cast<char>( ( value >> 8 ) & 255 );
+                    out[2] = static_cast<char>( value & 255 );
+                    out += 3;
+                }
+            }
+        }
+        else{
+            const size_t faceChunk = chunk - vertexChunks;
+            const size_t end = std::min( triangleCount, ( faceChunk + 1 ) * chunkSize );
+            char* out = faceData + faceChunk * chunkSize * faceSize;
+            for( size_t t = faceChunk * chunkSize; t < end; t++ ){
+                *out++ = 3;
+                std::memcpy( out, &mesh.indices[t * 3], 3 * sizeof( int32_t ) );
+                out += 3 * sizeof( int32_t );
+            }
+        }
+    } );
+
+    writeFile( fileName, buffers );
+}
+
+// Write Binary STL
+void WriteStlMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ )
+{
+    const size_t triangleCount = mesh.triangleCount();
+    if( triangleCount > 0xffffffffull ){
+        throw std::invalid_argument( "too many triangles for STL" );
+    }
+
+    // 80 Bytes Header, Number of Triangles, then 50 Bytes per Triangle
+    const size_t triangleSize = 12 * sizeof( float ) + sizeof( uint16_t );
+    std::vector<std::vector<char>> buffers( 1 );
+    std::vector<char>& buffer = buffers[0];
+    buffer.assign( 84 + triangleCount * triangleSize, 0 );
+    const uint32_t count = static_cast<uint32_t>( triangleCount );
+    std::memcpy( &buffer[80], &count, sizeof( count ) );
+    char* triangleData = buffer.data() + 84;
+
+    ThreadPool::global().parallelFor( chunkCount( triangleCount ), [&]( const size_t chunk ){
+        const size_t end = std::min( triangleCount, ( chunk + 1 ) * chunkSize );
+        char* out = triangleData + chunk * chunkSize * triangleSize;
+        for( size_t t = chunk * chunkSize; t < end; t++ ){
+            float record[12];
+            float* normal = &record[0];
+            float* a = &record[3];
+            float* b = &record[6];
+            float* c = &record[9];
+            loadVertex( mesh, mesh.indices[t * 3 + 0], flipYZ, a );
+            loadVertex( mesh, mesh.indices[t * 3 + 1], flipYZ, b );
+            loadVertex( mesh, mesh.indices[t * 3 + 2], flipYZ, c );
+
+            // Face Normal
+            const float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            const float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+            normal[0] = u[1] * v[2] - u[2] * v[1];
+            normal[1] = u[2] * v[0] - u[0] * v[2];
+            normal[2] = u[0] * v[1] - u[1] * v[0];
+            const float length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+            if( length > 0.0f ){
+                normal[0] /= length;
+                normal[1] /= length;
+                normal[2] /= length;
+            }
+
+            std::memcpy( out, record, sizeof( record ) );
+            out += triangleSize;
+        }
+    } );
+
+    writeFile( fileName, buffers );
+}
+
+// Write ASCII OBJ
+void WriteObjMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ )
+{
+    writeObj( fileName, mesh, flipYZ, "" );
+}
+
+// Write ASCII OBJ with Texture Coordinates and Material
+void WriteTexturedObjMesh( const std::string& fileName, const IndexedMesh& mesh, const std::string& textureFileName, const bool flipYZ )
+{
+    if( mesh.texcoords.size() != mesh.vertexCount() * 2 ){
+        throw std::invalid_argument( "invalid number of texture coordinates" );
+    }
+
+    // Material File ( Same Name as OBJ )
+    const size_t extension = fileName.find_last_of( '.' );
+    const size_t separator = fileName.find_last_of( "/\\" );
+    const std::string baseName = ( extension != std::string::npos && ( separator == std::string::npos || separator < extension ) ) ? fileName.substr( 0, extension ) : fileName;
+    const std::string materialFileName = baseName + ".mtl";
+    const std::string material = "newmtl texture\nKa 1.000000 1.000000 1.000000\nKd 1.000000 1.000000 1.000000\nKs 0.000000 0.000000 0.000000\nillum 1\nmap_Kd " + textureFileName + "\n";
+    std::vector<std::vector<char>> buffers( 1, std::vector<char>( material.begin(), material.end() ) );
+    writeFile( materialFileName, buffers );
+
+    const std::string materialName = ( separator != std::string::npos ) ? materialFileName.substr( separator + 1 ) : materialFileName;
+    writeObj( fileName, mesh, flipYZ, "mtllib " + materialName + "\nusemtl texture\n" );
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef __MESH_WRITER__
+#define __MESH_WRITER__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Indexed Triangle Mesh
+struct IndexedMesh
+{
+    std::vector<float> vertices;   // x, y, z
+    std::vector<uint32_t> colors;  // Per Vertex, 0xAARRGGBB ( Same as INuiFusionColorMesh ), Empty if no Color
+    std::vector<float> texcoords;  // u, v per Vertex ( Origin at Bottom Left of Texture ), Empty if no Texture
+    std::vector<uint32_t> indices; // 3 per Triangle
+
+    size_t vertexCount() const { return vertices.size() / 3; }
+    size_t triangleCount() const { return indices.size() / 3; }
+};
+
+// Weld Triangle Soup ( 3 Vertices per Triangle, e.g. INuiFusionColorMesh ) to Indexed Mesh
+// Vertices with bit-identical positions are merged ( first color is kept ), triangles collapsed by welding are dropped.
+// Vertices are numbered in order of first appearance, so triangles keep their locality.
+void WeldMesh( const float* vertices, const uint32_t* colors, const size_t vertexCount, IndexedMesh& mesh );
+
+// Write Binary Little Endian PLY ( Indexed )
+void WritePlyMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ = true, const bool outputColor = true );
+
+// Write Binary STL ( Face Normals are Calculated from Vertices )
+void WriteStlMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ = true );
+
+// Write ASCII OBJ ( Indexed, Same Precision as %f )
+void WriteObjMesh( const std::string& fileName, const IndexedMesh& mesh, const bool flipYZ = true );
+
+// Write ASCII OBJ with Texture Coordinates and Material ( Same Name as OBJ with .mtl ) that Refers to Texture File
+// Texture file name is written as is, so it should be relative to OBJ ( e.g. "mesh.png" ), the texture itself is not written.
+void WriteTexturedObjMesh( const std::string& fileName, const IndexedMesh& mesh, const std::string& textureFileName, const bool flipYZ = true );
+
+#endif // __MESH_WRITER__
\ No newline at end of file
@@ -0,0 +1,437 @@
+#include "Raycaster.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace
+{
+    const int16_t emptyMinimum = INT16_MAX;
+    const int16_t emptyMaximum = INT16_MIN;
+
+    // Gray for Surface without Color
+    const uint32_t defaultColor = 0xffc8c8c8;
+
+    // Distance Range of Observed Voxels in Brick
+    void brickRange( const TsdfBrick& brick, int16_t& minimum, int16_t& maximum )
+    {
+        minimum = emptyMinimum;
+        maximum = emptyMaximum;
+        for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+            if( brick.weight[i] != 0 ){
+                minimum = std::min( minimum, brick.tsdf[i] );
+                maximum = std::max( maximum, brick.tsdf[i] );
+            }
+        }
+    }
+
+    // Shade Color by Intensity
+    inline uint32_t shadeColor( const uint32_t color, const float intensity )
+    {
+        uint32_t result = 0xff000000;
+        for( int shift = 0; shift < 24; shift += 8 ){
+            const float channel = static_cast<float>( ( color >> shift ) & 0xff ) * intensity;
+            result |= static_cast<uint32_t>( std::min( channel + 0.5f, 255.0f ) ) << shift;
+        }
+        return result;
+    }
+}
+
+// Constructor
+Raycaster::Raycaster( const bool skipping )
+    : skipping( skipping )
+{
+    for( int axis = 0; axis < 3; axis++ ){
+        minBrick[axis] = 0;
+        brickCount[axis] = 0;
+        origin[axis] = 0.0f;
+    }
+    parameters = DefaultTsdfParameters();
+}
+
+// Update Bricks and Pyramid
+void Raycaster::update( const TsdfGrid& grid )
+{
+    parameters = grid.getParameters();
+    for( int axis = 0; axis < 3; axis++ ){
+        origin[axis] = grid.getOrigin()[axis];
+    }
+
+    // Collect Bricks, Range is Recalculated only for Changed Bricks
+    struct Entry
+    {
+        int x, y, z;
+        const TsdfBrick* brick;
+        BrickState* state;
+        bool changed;
+    };
+    std::vector<Entry> entries;
+    grid.forEachResidentBrick( [&]( const int x, const int y, const int z, const TsdfBrick& brick ){
+        const std::pair<std::unordered_map<uint64_t, BrickState>::iterator, bool> inserted = states.emplace( PackBrickKey( x, y, z ), BrickState() );
+        const Entry entry = { x, y, z, &brick, &inserted.first->second, inserted.second || inserted.first->second.version != brick.version };
+        entries.push_back( entry );
+    } );
+
+    const size_t chunkSize = 1024;
+    ThreadPool::global().parallelFor( ( entries.size() + chunkSize - 1 ) / chunkSize, [&]( const size_t chunk ){
+        const size_t end = std::min( entries.size(), ( chunk + 1 ) * chunkSize );
+        for( size_t i = chunk * chunkSize; i < end; i++ ){
+            if( entries[i].changed ){
+                entries[i].state->version = entries[i].brick->version;
+                brickRange( *entries[i].brick, entries[i].state->range.minimum, entries[i].state->range.maximum );
+            }
+        }
+    } );
+
+    // Bounding Box of Observed Bricks
+    int maxBrick[3] = { INT_MIN, INT_MIN, INT_MIN };
+    for( int axis = 0; axis < 3; axis++ ){
+        minBrick[axis] = INT_MAX;
+    }
+    entries.erase( std::remove_if( entries.begin(), entries.end(), []( const Entry& entry ){
+        return entry.state->range.minimum > entry.state->range.maximum;
+    } ), entries.end() );
+    for( const Entry& entry : entries ){
+        const int coordinate[3] = { entry.x, entry.y, entry.z };
+        for( int axis = 0; axis < 3; axis++ ){
+            minBrick[axis] = std::min( minBrick[axis], coordinate[axis] );
+            maxBrick[axis] = std::max( maxBrick[axis], coordinate[axis] );
+        }
+    }
+    if( entries.empty() ){
+        for( int axis = 0; axis < 3; axis++ ){
+            minBrick[axis] = 0;
+            maxBrick[axis] = -1;
+        }
+    }
+    for( int axis = 0; axis < 3; axis++ ){
+        brickCount[axis] = maxBrick[axis] - minBrick[axis] + 1;
+    }
+
+    // Bricks and Ranges in Bounding Box
+    const size_t count = static_cast<size_t>( brickCount[0] ) * brickCount[1] * brickCount[2];
+    const Range empty = { emptyMinimum, emptyMaximum };
+    std::vector<Range> ranges( count, empty );
+    bricks.assign( count, nullptr );
+    for( const Entry& entry : entries ){
+        const size_t index = ( static_cast<size_t>( entry.z - minBrick[2] ) * brickCount[1] + ( entry.y - minBrick[1] ) ) * brickCount[0] + ( entry.x - minBrick[0] );
+        bricks[index] = entry.brick;
+        ranges[index] = entry.state->range;
+    }
+
+    // Pyramid ( Level 0 includes +X, +Y, +Z Neighbors )
+    for( int level = 0; level < levelCount; level++ ){
+        const int previous = std::max( level - 1, 0 );
+        const int* sourceSize = ( level == 0 ) ? brickCount : levelSize[previous];
+        const std::vector<Range>& source = ( level == 0 ) ? ranges : levels[previous];
+        for( int axis = 0; axis < 3; axis++ ){
+            levelSize[level][axis] = ( level == 0 ) ? brickCount[axis] : ( sourceSize[axis] + 1 ) / 2;
+        }
+        const int* size = levelSize[level];
+        std::vector<Range>& nodes = levels[level];
+        nodes.assign( static_cast<size_t>( size[0] ) * size[1] * size[2], empty );
+
+        const int scale = ( level == 0 ) ? 1 : 2;
+        ThreadPool::global().parallelFor( size[2], [&]( const size_t z ){
+            for( int y = 0; y < size[1]; y++ ){
+                for( int x = 0; x < size[0]; x++ ){
+                    Range range = empty;
+                    for( int i = 0; i < 8; i++ ){
+                        const int sx = x * scale + ( i & 1 );
+                        const int sy = y * scale + ( ( i >> 1 ) & 1 );
+                        const int sz = static_cast<int>( z ) * scale + ( ( i >> 2 ) & 1 );
+                        if( sx >= sourceSize[0] || sy >= sourceSize[1] || sz >= sourceSize[2] ){
+                            continue;
+                        }
+                        const Range& child = source[( static_cast<size_t>( sz ) * sourceSize[1] + sy ) * sourceSize[0] + sx];
+                        range.minimum = std::min( range.minimum, child.minimum );
+                        range.maximum = std::max( range.maximum, child.maximum );
+                    }
+                    nodes[( z * size[1] + y ) * size[0] + x] = range;
+                }
+            }
+        } );
+    }
+}
+
+// Retrieve Brick that has Voxel
+inline const TsdfBrick* Raycaster::findBrick( const int x, const int y, const int z ) const
+{
+    return bricks[( static_cast<size_t>( z >> 3 ) * brickCount[1] + ( y >> 3 ) ) * brickCount[0] + ( x >> 3 )];
+}
+
+// Sample Distance at Voxel Coordinate
+inline bool Raycaster::sample( const float x, const float y, const float z, float& value ) const
+{
+    const float fx = std::floor( x );
+    const float fy = std::floor( y );
+    const float fz = std::floor( z );
+    const int ix = static_cast<int>( fx );
+    const int iy = static_cast<int>( fy );
+    const int iz = static_cast<int>( fz );
+    if( ix < 0 || iy < 0 || iz < 0 || ix + 1 >= brickCount[0] * TsdfBrick::size || iy + 1 >= brickCount[1] * TsdfBrick::size || iz + 1 >= brickCount[2] * TsdfBrick::size ){
+        return false;
+    }
+
+    // Distances of 8 Corners ( x Fastest )
+    float corners[8];
+    if( ( ix & 7 ) != 7 && ( iy & 7 ) != 7 && ( iz & 7 ) != 7 ){
+        // All Corners in Same Brick
+        const TsdfBrick* brick = findBrick( ix, iy, iz );
+        if( brick == nullptr ){
+            return false;
+        }
+        const int base = ( ( iz & 7 ) * TsdfBrick::size + ( iy & 7 ) ) * TsdfBrick::size + ( ix & 7 );
+        for( int i = 0; i < 8; i++ ){
+            const int voxel = base + ( i & 1 ) + ( ( i >> 1 ) & 1 ) * TsdfBrick::size + ( i >> 2 ) * TsdfBrick::size * TsdfBrick::size;
+            if( brick->weight[voxel] == 0 ){
+                return false;
+            }
+            corners[i] = brick->tsdf[voxel];
+        }
+    }
+    else{
+        for( int i = 0; i < 8; i++ ){
+            const int vx = ix + ( i & 1 );
+            const int vy = iy + ( ( i >> 1 ) & 1 );
+            const int vz = iz + ( i >> 2 );
+            const TsdfBrick* brick = findBrick( vx, vy, vz );
+            if( brick == nullptr ){
+                return false;
+            }
+            const int voxel = ( ( vz & 7 ) * TsdfBrick::size + ( vy & 7 ) ) * TsdfBrick::size + ( vx & 7 );
+            if( brick->weight[voxel] == 0 ){
+                return false;
+            }
+            corners[i] = brick->tsdf[voxel];
+        }
+    }
+
+    // Trilinear Interpolation
+    const float tx = x - fx;
+    const float ty = y - fy;
+    const float tz = z - fz;
+    const float c00 = corners[0] + ( corners[1] - corners[0] ) * tx;
+    const float c10 = corners[2] + ( corners[3] - corners[2] ) * tx;
+    const float c01 = corners[4] + ( corners[5] - corners[4] ) * tx;
+    const float c11 = corners[6] + ( corners[7] - corners[6] ) * tx;
+    const float c0 = c00 + ( c10 - c00 ) * ty;
+    const float c1 = c01 + ( c11 - c01 ) * ty;
+    value = ( c0 + ( c1 - c0 ) * tz ) / 32767.0f;
+    return true;
+}
+
+// Raycast Surface from Camera Pose
+void Raycaster::raycast( const RaycastFrame& frame ) const
+{
+    ThreadPool::global().parallelFor( frame.height, [&]( const size_t v ){
+        raycastRow( frame, static_cast<int>( v ) );
+    } );
+}
+
+// Raycast a Row
+void Raycaster::raycastRow( const RaycastFrame& frame, const int v ) const
+{
+    const float fx = frame.camera.focalLengthX * frame.width;
+    const float fy = frame.camera.focalLengthY * frame.height;
+    const float cx = frame.camera.principalPointX * frame.width;
+    const float cy = frame.camera.principalPointY * frame.height;
+    const Matrix4f cameraToWorld = InvertRigidMatrix4f( frame.worldToCamera );
+
+    // Camera Position in Voxel Coordinate ( Relative to Bounding Box )
+    float start[3];
+    const float camera[3] = { cameraToWorld.M41, cameraToWorld.M42, cameraToWorld.M43 };
+    for( int axis = 0; axis < 3; axis++ ){
+        start[axis] = camera[axis] * parameters.voxelsPerMeter + origin[axis] - minBrick[axis] * TsdfBrick::size;
+    }
+    const float truncation = parameters.truncationDistance * parameters.voxelsPerMeter;
+
+    float* point = &frame.pointCloud[static_cast<size_t>( v ) * frame.width * 6];
+    uint32_t* shaded = ( frame.shaded != nullptr ) ? &frame.shaded[static_cast<size_t>( v ) * frame.width] : nullptr;
+    for( int u = 0; u < frame.width; u++, point += 6 ){
+        for( int i = 0; i < 6; i++ ){
+            point[i] = 0.0f;
+        }
+        if( shaded != nullptr ){
+            shaded[u] = 0;
+        }
+
+        // Ray in Voxel Coordinate, Parameter t is Depth ( Camera Z ) in Meters
+        const float ray[3] = { ( u - cx ) / fx, ( v - cy ) / fy, 1.0f };
+        float direction[3];
+        RotateVector( cameraToWorld, ray[0], ray[1], ray[2], direction );
+        for( int axis = 0; axis < 3; axis++ ){
+            direction[axis] *= parameters.voxelsPerMeter;
+        }
+        const float voxelStep = 1.0f / std::sqrt( direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2] );
+
+        // Clip Depth Range by Bounding Box ( No Range if no Bricks )
+        float nearDepth = parameters.minDepth;
+        float farDepth = bricks.empty() ? -1.0f : parameters.maxDepth;
+        for( int axis = 0; axis < 3; axis++ ){
+            const float upper = static_cast<float>( brickCount[axis] * TsdfBrick::size - 1 );
+            if( direction[axis] == 0.0f ){
+                if( start[axis] < 0.0f || start[axis] > upper ){
+                    farDepth = -1.0f;
+                }
+                continue;
+            }
+            const float t0 = ( 0.0f - start[axis] ) / direction[axis];
+            const float t1 = ( upper - start[axis] ) / direction[axis];
+            nearDepth = std::max( nearDepth, std::min( t0, t1 ) );
+            farDepth = std::min( farDepth, std::max( t0, t1 ) );
+        }
+
+        // March
+        bool previousValid = false;
+        float previousT = 0.0f;
+        float previousValue = 0.0f;
+        float hit = -1.0f;
+        float t = nearDepth;
+        while( t <= farDepth ){
+            const float position[3] = { start[0] + direction[0] * t, start[1] + direction[1] * t, start[2] + direction[2] * t };
+
+            // Skip Node without Sign Change ( Negative Node is Sampled if Previous Sample is in Front of Surface )
+            const int brick[3] = {
+                static_cast<int>( std::max( position[0], 0.0f ) ) >> 3,
+                static_cast<int>( std::max( position[1], 0.0f ) ) >> 3,
+                static_cast<int>( std::max( position[2], 0.0f ) ) >> 3
+            };
+            int skip = -1;
+            for( int level = levelCount - 1; level >= 0 && skipping; level-- ){
+                const int* size = levelSize[level];
+                const int nx = std::min( brick[0] >> level, size[0] - 1 );
+                const int ny = std::min( brick[1] >> level, size[1] - 1 );
+                const int nz = std::min( brick[2] >> level, size[2] - 1 );
+                const Range& range = levels[level][( static_cast<size_t>( nz ) * size[1] + ny ) * size[0] + nx];
+                if( range.minimum > 0 || ( range.maximum < 0 && !previousValid ) ){
+                    skip = level;
+                    break;
+                }
+            }
+            if( skip >= 0 ){
+                // Exit of Node
+                float exit = farDepth + 1.0f;
+                const float extent = static_cast<float>( TsdfBrick::size << skip );
+                for( int axis = 0; axis < 3; axis++ ){
+                    const float lower = static_cast<float>( ( brick[axis] >> skip ) ) * extent;
+                    if( direction[axis] > 0.0f ){
+                        exit = std::min( exit, ( lower + extent - start[axis] ) / direction[axis] );
+                    }
+                    else if( direction[axis] < 0.0f ){
+                        exit = std::min( exit, ( lower - start[axis] ) / direction[axis] );
+                    }
+                }
+                t = std::max( exit, t ) + 0.01f * voxelStep;
+                previousValid = false;
+                continue;
+            }
+
+            float value;
+            if( !sample( position[0], position[1], position[2], value ) ){
+                previousValid = false;
+                t += voxelStep;
+                continue;
+            }
+
+            if( value < 0.0f ){
+                // Entered from Skipped or Unobserved Space, Look a Voxel Back
+                if( !previousValid ){
+                    const float back = t - voxelStep;
+                    float backValue;
+                    if( !( back >= nearDepth && sample( start[0] + direction[0] * back, start[1] + direction[1] * back, start[2] + direction[2] * back, backValue ) && backValue >= 0.0f ) ){
+                        // Behind Surface
+                        t += voxelStep;
+                        continue;
+                    }
+                    previousT = back;
+                    previousValue = backValue;
+                }
+
+                // Zero Crossing ( Linear Interpolation and a Secant Refinement )
+                hit = previousT + ( t - previousT ) * previousValue / ( previousValue - value );
+                float hitValue;
+                if( sample( start[0] + direction[0] * hit, start[1] + direction[1] * hit, start[2] + direction[2] * hit, hitValue ) && hitValue != 0.0f ){
+                    if( hitValue > 0.0f ){
+                        hit = hit + ( t - hit ) * hitValue / ( hitValue - value );
+                    }
+                    else{
+                        hit = previousT + ( hit - previousT ) * previousValue / ( previousValue - hitValue );
+                    }
+                }
+                break;
+            }
+
+            // Step by Distance to Surface ( At Least a Voxel )
+            previousValid = true;
+            previousT = t;
+            previousValue = value;
+            t += std::max( value * truncation, 1.0f ) * voxelStep;
+        }
+
+        if( hit < 0.0f ){
+            continue;
+        }
+
+        // Point in Camera Space
+        point[0] = ray[0] * hit;
+        point[1] = ray[1] * hit;
+        point[2] = hit;
+
+        // Normal from Gradient ( Toward Front of Surface )
+        const float position[3] = { start[0] + direction[0] * hit, start[1] + direction[1] * hit, start[2] + direction[2] * hit };
+        float gradient[3];
+        bool valid = true;
+        for( int axis = 0; axis < 3 && valid; axis++ ){
+            float forward[3] = { position[0], position[1], position[2] };
+            float backward[3] = { position[0], position[1], position[2] };
+            forward[axis] += 1.0f;
+            backward[axis] -= 1.0f;
+            float a, b;
+            valid = sample( forward[0], forward[1], forward[2], a ) && sample( backward[0], backward[1], backward[2], b );
+            gradient[axis] = a - b;
+        }
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        if( valid ){
+            RotateVector( frame.worldToCamera, gradient[0], gradient[1], gradient[2], normal );
+            const float length = std::sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+            if( length > 0.0f ){
+                for( int axis = 0; axis < 3; axis++ ){
+                    normal[axis] /= length;
+                }
+            }
+        }
+        point[3] = normal[0];
+        point[4] = normal[1];
+        point[5] = normal[2];
+
+        if( shaded == nullptr ){
+            continue;
+        }
+
+        // Color of Nearest Voxel
+        uint32_t color = defaultColor;
+        const int vx = static_cast<int>( position[0] + 0.5f );
+        const int vy = static_cast<int>( position[1] + 0.5f );
+        const int vz = static_cast<int>( position[2] + 0.5f );
+        if( vx < brickCount[0] * TsdfBrick::size && vy < brickCount[1] * TsdfBrick::size && vz < brickCount[2] * TsdfBrick::size ){
+            const TsdfBrick* brick = findBrick( vx, vy, vz );
+            const int voxel = ( ( vz & 7 ) * TsdfBrick::size + ( vy & 7 ) ) * TsdfBrick::size + ( vx & 7 );
+            if( brick != nullptr && ( brick->color[voxel] & 0x00ffffff ) != 0 ){
+                color = brick->color[voxel];
+            }
+        }
+
+        // Headlight Lambertian
+        const float length = std::sqrt( point[0] * point[0] + point[1] * point[1] + point[2] * point[2] );
+        const float lambert = std::max( 0.0f, -( normal[0] * point[0] + normal[1] * point[1] + normal[2] * point[2] ) / length );
+        shaded[u] = shadeColor( color, 0.2f + 0.8f * lambert );
+    }
+}
+
+// Discard Cached Ranges
+void Raycaster::reset()
+{
+    states.clear();
+}
\ No newline at end of file
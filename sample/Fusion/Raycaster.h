@@ -0,0 +1,87 @@
+#ifndef __RAYCASTER__
+#define __RAYCASTER__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "TsdfVolume.h"
+
+// Raycast Frame ( Depth Resolution )
+struct RaycastFrame
+{
+    float* pointCloud; // x, y, z, nx, ny, nz per Pixel in Camera Space ( Same Layout as NUI_FUSION_IMAGE_TYPE_POINT_CLOUD ), 0 is no Surface
+    uint32_t* shaded;  // BGRA Surface Color Shaded by Normal ( Gray if no Color ), nullptr to Skip
+    int width;
+    int height;
+    FusionCamera camera;
+    Matrix4f worldToCamera;
+};
+
+// TSDF Raycaster
+//
+// Marches rays from camera to first zero crossing ( front to back ) of trilinearly interpolated distance.
+// Empty space is skipped with min/max pyramid of bricks, level 0 node covers a brick and voxels of its +X, +Y, +Z neighbors
+// ( all voxels that cells of the brick read ), and level n node covers 2^n x 2^n x 2^n bricks.
+// A ray skips a node at once if distance in the node has no sign change, otherwise steps by distance to the surface ( at least a voxel ).
+// Min/max of bricks are cached by brick version, so update() reads only changed bricks. Bricks not in memory are not rendered.
+class Raycaster
+{
+public:
+    static const int levelCount = 4;
+
+private:
+    // Distance Range
+    struct Range
+    {
+        int16_t minimum;
+        int16_t maximum;
+    };
+
+    // Cached Range of Brick
+    struct BrickState
+    {
+        uint32_t version;
+        Range range;
+    };
+
+    std::unordered_map<uint64_t, BrickState> states;
+
+    // Bricks and Pyramid in Bounding Box of Bricks
+    int minBrick[3];
+    int brickCount[3];
+    std::vector<const TsdfBrick*> bricks;
+    std::vector<Range> levels[levelCount];
+    int levelSize[levelCount][3];
+
+    TsdfParameters parameters;
+    float origin[3];
+
+    // Empty Space Skipping ( Disabled to Measure Benefit of Pyramid, Rays March Every Node )
+    bool skipping;
+
+public:
+    // Constructor
+    Raycaster( const bool skipping = true );
+
+    // Update Bricks and Pyramid ( Call after Integration )
+    void update( const TsdfGrid& grid );
+
+    // Raycast Surface from Camera Pose ( Rows in Parallel )
+    void raycast( const RaycastFrame& frame ) const;
+
+    // Discard Cached Ranges ( Call when Volume is Reset )
+    void reset();
+
+private:
+    // Retrieve Brick that has Voxel ( Coordinate Relative to Bounding Box )
+    const TsdfBrick* findBrick( const int x, const int y, const int z ) const;
+
+    // Sample Distance at Voxel Coordinate ( Relative to Bounding Box, Returns false if any Voxel is not Observed )
+    bool sample( const float x, const float y, const float z, float& value ) const;
+
+    // Raycast a Row
+    void raycastRow( const RaycastFrame& frame, const int v ) const;
+};
+
+#endif // __RAYCASTER__
\ No newline at end of file
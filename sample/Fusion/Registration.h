@@ -0,0 +1,349 @@
+#ifndef __REGISTRATION__
+#define __REGISTRATION__
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "simd.h"
+
+// Camera Intrinsics ( Pinhole Model with Radial Distortion )
+struct RegistrationIntrinsics
+{
+    float focalLengthX;
+    float focalLengthY;
+    float principalPointX;
+    float principalPointY;
+    float radialDistortionSecondOrder;
+    float radialDistortionFourthOrder;
+    float radialDistortionSixthOrder;
+};
+
+// Camera Extrinsics ( Depth Camera Space -> Color Camera Space, Row-Major Rotation, Translation in Meters )
+struct RegistrationExtrinsics
+{
+    float rotation[9];
+    float translation[3];
+};
+
+// Registration ( Depth -> Color )
+//
+// For a fixed depth pixel, the mapped color coordinate is base + shift / depth.
+// The per-pixel base ( infinite depth ) and shift ( disparity term ) tables are built once,
+// so remapping a depth frame costs one reciprocal and two multiply-adds per pixel.
+class Registration
+{
+private:
+    int depthWidth;
+    int depthHeight;
+    int colorWidth;
+    int colorHeight;
+
+    // Calibration Tables
+    std::vector<float> baseX;
+    std::vector<float> baseY;
+    std::vector<float> shiftX;
+    std::vector<float> shiftY;
+
+public:
+    // Constructor
+    Registration()
+        : depthWidth( 0 ), depthHeight( 0 ), colorWidth( 0 ), colorHeight( 0 )
+    {
+    }
+
+    // Initialize from Color Coordinates Sampled at Two Constant Depths ( e.g. ICoordinateMapper::MapDepthFrameToColorSpace )
+    // Point is any type with float members X and Y ( ColorSpacePoint )
+    template<typename Point>
+    bool initialize( const int depthWidth, const int depthHeight, const int colorWidth, const int colorHeight, const Point* nearPoints, const float nearDepth, const Point* farPoints, const float farDepth )
+    {
+        if( depthWidth <= 0 || depthHeight <= 0 || nearDepth <= 0.0f || farDepth <= 0.0f || nearDepth == farDepth ){
+            throw std::invalid_argument( "invalid registration parameters" );
+        }
+
+        this->depthWidth = depthWidth;
+        this->depthHeight = depthHeight;
+        this->colorWidth = colorWidth;
+        this->colorHeight = colorHeight;
+
+        const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+        baseX.resize( size );
+        baseY.resize( size );
+        shiftX.resize( size );
+        shiftY.resize( size );
+
+        // Solve base + shift / depth from Two Samples
+        const float inverseNear = 1.0f / nearDepth;
+        const float inverseFar = 1.0f / farDepth;
+        const float scale = 1.0f / ( inverseNear - inverseFar );
+        size_t valid = 0;
+        for( size_t index = 0; index < size; index++ ){
+            const Point nearPoint = nearPoints[index];
+            const Point farPoint = farPoints[index];
+            if( !std::isfinite( nearPoint.X ) || !std::isfinite( nearPoint.Y ) || !std::isfinite( farPoint.X ) || !std::isfinite( farPoint.Y ) ){
+                // Unmappable Pixel
+                baseX[index] = baseY[index] = -std::numeric_limits<float>::infinity();
+                shiftX[index] = shiftY[index] = 0.0f;
+                continue;
+            }
+
+            shiftX[index] = ( nearPoint.X - farPoint.X ) * scale;
+            shiftY[index] = ( nearPoint.Y - farPoint.Y ) * scale;
+            baseX[index] = nearPoint.X - shiftX[index] * inverseNear;
+            baseY[index] = nearPoint.Y - shiftY[index] * inverseNear;
+            valid++;
+        }
+
+        // Coordinate Mapper will return only invalid points until it has received the calibration from sensor
+        if( valid == 0 ){
+            baseX.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Initialize from Intrinsics and Extrinsics ( e.g. Synthetic Calibration )
+    bool initialize( const int depthWidth, const int depthHeight, const int colorWidth, const int colorHeight, const RegistrationIntrinsics& depthIntrinsics, const RegistrationIntrinsics& colorIntrinsics, const RegistrationExtrinsics& extrinsics )
+    {
+        struct Point{ float X; float Y; };
+
+        const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+        std::vector<Point> nearPoints( size );
+        std::vector<Point> farPoints( size );
+
+        const float nearDepth = 500.0f; // [mm]
+        const float farDepth = 4500.0f; // [mm]
+
+        for( int depthY = 0; depthY < depthHeight; depthY++ ){
+            for( int depthX = 0; depthX < depthWidth; depthX++ ){
+                // Depth Pixel -> Normalized Ray ( x/z, y/z )
+                float rayX, rayY;
+                undistort( depthIntrinsics, static_cast<float>( depthX ), static_cast<float>( depthY ), rayX, rayY );
+
+                const size_t index = static_cast<size_t>( depthY ) * depthWidth + depthX;
+                project( colorIntrinsics, extrinsics, rayX, rayY, nearDepth * 0.001f, nearPoints[index].X, nearPoints[index].Y );
+                project( colorIntrinsics, extrinsics, rayX, rayY, farDepth * 0.001f, farPoints[index].X, farPoints[index].Y );
+            }
+        }
+
+        return initialize( depthWidth, depthHeight, colorWidth, colorHeight, &nearPoints[0], nearDepth, &farPoints[0], farDepth );
+    }
+
+    // Retrieve Initialized
+    bool isInitialized() const
+    {
+        return !baseX.empty();
+    }
+
+    // Map Depth Frame to Color Space ( Depth in Millimeters, Invalid Depth is Mapped to -Infinity )
+    // Point is any type with float members X and Y ( ColorSpacePoint )
+    template<typename Point>
+    void mapDepthFrameToColorSpace( const uint16_t* depth, Point* points ) const
+    {
+        mapDepthRowsToColorSpace( depth, points, 0, depthHeight );
+    }
+
+    // Map Rows of Depth Frame to Color Space
+    template<typename Point>
+    void mapDepthRowsToColorSpace( const uint16_t* depth, Point* points, const int beginY, const int endY ) const
+    {
+        const float invalid = -std::numeric_limits<float>::infinity();
+        const size_t begin = static_cast<size_t>( beginY ) * depthWidth;
+        const size_t end = static_cast<size_t>( endY ) * depthWidth;
+        for( size_t index = begin; index < end; index++ ){
+            const uint16_t d = depth[index];
+            const float inverseDepth = 1.0f / static_cast<float>( d );
+            points[index].X = ( d != 0 ) ? baseX[index] + shiftX[index] * inverseDepth : invalid;
+            points[index].Y = ( d != 0 ) ? baseY[index] + shiftY[index] * inverseDepth : invalid;
+        }
+    }
+
+    // Register BGRA Color to Depth Resolution ( Pixels Mapped Outside of Color Frame are Zero )
+    void registerColor( const uint16_t* depth, const uint8_t* color, uint8_t* registered ) const
+    {
+        registerColorRows( depth, color, registered, 0, depthHeight );
+    }
+
+    // Register Rows of BGRA Color to Depth Resolution
+    void registerColorRows( const uint16_t* depth, const uint8_t* color, uint8_t* registered, const int beginY, const int endY ) const
+    {
+        const int begin = beginY * depthWidth;
+        const int end = endY * depthWidth;
+        const uint32_t* src = reinterpret_cast<const uint32_t*>( color );
+        uint32_t* dst = reinterpret_cast<uint32_t*>( registered );
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            registerColorAVX2( depth, src, dst, begin, end );
+            return;
+        }
+
+        if( IsSupportedSSE41() ){
+            registerColorSSE41( depth, src, dst, begin, end );
+            return;
+        }
+#endif
+
+        registerColorScalar( depth, src, dst, begin, end );
+    }
+
+    // Retrieve Frame Size
+    int getDepthWidth() const { return depthWidth; }
+    int getDepthHeight() const { return depthHeight; }
+    int getColorWidth() const { return colorWidth; }
+    int getColorHeight() const { return colorHeight; }
+
+private:
+    // Register Color ( Scalar )
+    void registerColorScalar( const uint16_t* depth, const uint32_t* color, uint32_t* registered, const int begin, const int end ) const
+    {
+        const float width = static_cast<float>( colorWidth );
+        const float height = static_cast<float>( colorHeight );
+        for( int index = begin; index < end; index++ ){
+            const uint16_t d = depth[index];
+            const float inverseDepth = 1.0f / static_cast<float>( d );
+
+            // Round to Nearest ( Truncation of x + 0.5 )
+            const float x = baseX[index] + shiftX[index] * inverseDepth + 0.5f;
+            const float y = baseY[index] + shiftY[index] * inverseDepth + 0.5f;
+            if( d != 0 && ( -1.0f < x ) && ( x < width ) && ( -1.0f < y ) && ( y < height ) ){
+                registered[index] = color[static_cast<int>( y ) * colorWidth + static_cast<int>( x )];
+            }
+            else{
+                registered[index] = 0;
+            }
+        }
+    }
+
+#ifdef SIMD_X86
+    // Register Color ( SSE4.1, 4 Pixels x 2 )
+    SIMD_TARGET_SSE41
+    void registerColorSSE41( const uint16_t* depth, const uint32_t* color, uint32_t* registered, const int begin, const int end ) const
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i minusOne = _mm_set1_epi32( -1 );
+        const __m128i width = _mm_set1_epi32( colorWidth );
+        const __m128i height = _mm_set1_epi32( colorHeight );
+        const __m128 one = _mm_set1_ps( 1.0f );
+        const __m128 half = _mm_set1_ps( 0.5f );
+
+        int index = begin;
+        for( ; index + 8 <= end; index += 8 ){
+            const __m128i depth16 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth + index ) );
+            for( int half4 = 0; half4 < 2; half4++ ){
+                const int offset = index + half4 * 4;
+                const __m128i depth32 = ( half4 == 0 ) ? _mm_cvtepu16_epi32( depth16 ) : _mm_cvtepu16_epi32( _mm_srli_si128( depth16, 8 ) );
+                const __m128 inverseDepth = _mm_div_ps( one, _mm_cvtepi32_ps( depth32 ) );
+
+                // Round to Nearest ( Truncation of x + 0.5, Infinity and NaN become INT_MIN )
+                const __m128 x = _mm_add_ps( _mm_add_ps( _mm_loadu_ps( &baseX[offset] ), _mm_mul_ps( _mm_loadu_ps( &shiftX[offset] ), inverseDepth ) ), half );
+                const __m128 y = _mm_add_ps( _mm_add_ps( _mm_loadu_ps( &baseY[offset] ), _mm_mul_ps( _mm_loadu_ps( &shiftY[offset] ), inverseDepth ) ), half );
+                const __m128i colorX = _mm_cvttps_epi32( x );
+                const __m128i colorY = _mm_cvttps_epi32( y );
+
+                // Bounds Mask
+                __m128i mask = _mm_andnot_si128( _mm_cmpeq_epi32( depth32, zero ), minusOne );
+                mask = _mm_and_si128( mask, _mm_and_si128( _mm_cmpgt_epi32( colorX, minusOne ), _mm_cmpgt_epi32( width, colorX ) ) );
+                mask = _mm_and_si128( mask, _mm_and_si128( _mm_cmpgt_epi32( colorY, minusOne ), _mm_cmpgt_epi32( height, colorY ) ) );
+                const __m128i colorIndex = _mm_and_si128( _mm_add_epi32( _mm_mullo_epi32( colorY, width ), colorX ), mask );
+
+                // Gather ( Masked Lanes Load Index 0 and are Cleared )
+                alignas( 16 ) int indices[4];
+                _mm_store_si128( reinterpret_cast<__m128i*>( indices ), colorIndex );
+                const __m128i pixels = _mm_set_epi32( color[indices[3]], color[indices[2]], color[indices[1]], color[indices[0]] );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( registered + offset ), _mm_and_si128( pixels, mask ) );
+            }
+        }
+
+        registerColorScalar( depth, color, registered, index, end );
+    }
+
+    // Register Color ( AVX2, 8 Pixels x 2 )
+    SIMD_TARGET_AVX2
+    void registerColorAVX2( const uint16_t* depth, const uint32_t* color, uint32_t* registered, const int begin, const int end ) const
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i minusOne = _mm256_set1_epi32( -1 );
+        const __m256i width = _mm256_set1_epi32( colorWidth );
+        const __m256i height = _mm256_set1_epi32( colorHeight );
+        const __m256 one = _mm256_set1_ps( 1.0f );
+        const __m256 half = _mm256_set1_ps( 0.5f );
+        const int* base = reinterpret_cast<const int*>( color );
+
+        int index = begin;
+        for( ; index + 16 <= end; index += 16 ){
+            const __m256i depth16 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( depth + index ) );
+            for( int half8 = 0; half8 < 2; half8++ ){
+                const int offset = index + half8 * 8;
+                const __m256i depth32 = _mm256_cvtepu16_epi32( ( half8 == 0 ) ? _mm256_castsi256_si128( depth16 ) : _mm256_extracti128_si256( depth16, 1 ) );
+                const __m256 inverseDepth = _mm256_div_ps( one, _mm256_cvtepi32_ps( depth32 ) );
+
+                // Round to Nearest ( Truncation of x + 0.5, Infinity and NaN become INT_MIN )
+                const __m256 x = _mm256_add_ps( _mm256_add_ps( _mm256_loadu_ps( &baseX[offset] ), _mm256_mul_ps( _mm256_loadu_ps( &shiftX[offset] ), inverseDepth ) ), half );
+                const __m256 y = _mm256_add_ps( _mm256_add_ps( _mm256_loadu_ps( &baseY[offset] ), _mm256_mul_ps( _mm256_loadu_ps( &shiftY[offset] ), inverseDepth ) ), half );
+                const __m256i colorX = _mm256_cvttps_epi32( x );
+                const __m256i colorY = _mm256_cvttps_epi32( y );
+
+                // Bounds Mask
+                __m256i mask = _mm256_andnot_si256( _mm256_cmpeq_epi32( depth32, zero ), minusOne );
+                mask = _mm256_and_si256( mask, _mm256_and_si256( _mm256_cmpgt_epi32( colorX, minusOne ), _mm256_cmpgt_epi32( width, colorX ) ) );
+                mask = _mm256_and_si256( mask, _mm256_and_si256( _mm256_cmpgt_epi32( colorY, minusOne ), _mm256_cmpgt_epi32( height, colorY ) ) );
+                const __m256i colorIndex = _mm256_and_si256( _mm256_add_epi32( _mm256_mullo_epi32( colorY, width ), colorX ), mask );
+
+                // Gather ( Masked Lanes are Zero )
+                const __m256i pixels = _mm256_mask_i32gather_epi32( zero, base, colorIndex, mask, 4 );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( registered + offset ), pixels );
+            }
+        }
+
+        registerColorScalar( depth, color, registered, index, end );
+    }
+#endif
+
+    // Apply Radial Distortion to Normalized Coordinates
+    static void distort( const RegistrationIntrinsics& intrinsics, const float x, const float y, float& distortedX, float& distortedY )
+    {
+        const float r2 = x * x + y * y;
+        const float factor = 1.0f + r2 * ( intrinsics.radialDistortionSecondOrder + r2 * ( intrinsics.radialDistortionFourthOrder + r2 * intrinsics.radialDistortionSixthOrder ) );
+        distortedX = x * factor;
+        distortedY = y * factor;
+    }
+
+    // Pixel -> Undistorted Normalized Coordinates ( Fixed-Point Iteration )
+    static void undistort( const RegistrationIntrinsics& intrinsics, const float pixelX, const float pixelY, float& x, float& y )
+    {
+        const float distortedX = ( pixelX - intrinsics.principalPointX ) / intrinsics.focalLengthX;
+        const float distortedY = ( pixelY - intrinsics.principalPointY ) / intrinsics.focalLengthY;
+        x = distortedX;
+        y = distortedY;
+        for( int iteration = 0; iteration < 10; iteration++ ){
+            const float r2 = x * x + y * y;
+            const float factor = 1.0f + r2 * ( intrinsics.radialDistortionSecondOrder + r2 * ( intrinsics.radialDistortionFourthOrder + r2 * intrinsics.radialDistortionSixthOrder ) );
+            x = distortedX / factor;
+            y = distortedY / factor;
+        }
+    }
+
+    // Depth Ray at Depth [m] -> Color Pixel
+    static void project( const RegistrationIntrinsics& intrinsics, const RegistrationExtrinsics& extrinsics, const float rayX, const float rayY, const float depth, float& pixelX, float& pixelY )
+    {
+        const float* r = extrinsics.rotation;
+        const float* t = extrinsics.translation;
+        const float pointX = rayX * depth;
+        const float pointY = rayY * depth;
+        const float pointZ = depth;
+        const float colorX = r[0] * pointX + r[1] * pointY + r[2] * pointZ + t[0];
+        const float colorY = r[3] * pointX + r[4] * pointY + r[5] * pointZ + t[1];
+        const float colorZ = r[6] * pointX + r[7] * pointY + r[8] * pointZ + t[2];
+
+        float x, y;
+        distort( intrinsics, colorX / colorZ, colorY / colorZ, x, y );
+        pixelX = x * intrinsics.focalLengthX + intrinsics.principalPointX;
+        pixelY = y * intrinsics.focalLengthY + intrinsics.principalPointY;
+    }
+};
+
+#endif // __REGISTRATION__
\ No newline at end of file
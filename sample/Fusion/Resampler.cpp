@@ -0,0 +1,380 @@
+#include "Resampler.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Rows per Parallel Task
+    const int bandHeight = 16;
+
+    // Retrieve Row of Image
+    template<typename T>
+    inline const T* sourceRow( const T* image, const size_t pitch, const int y )
+    {
+        return reinterpret_cast<const T*>( reinterpret_cast<const unsigned char*>( image ) + y * pitch );
+    }
+
+    template<typename T>
+    inline T* destinationRow( T* image, const size_t pitch, const int y )
+    {
+        return reinterpret_cast<T*>( reinterpret_cast<unsigned char*>( image ) + y * pitch );
+    }
+
+    // Accumulate Weighted Row ( First Tap Overwrites )
+    void accumulateRow( float* sum, const float* row, const float weight, const int count, const bool first )
+    {
+        if( first ){
+            for( int i = 0; i < count; i++ ){
+                sum[i] = row[i] * weight;
+            }
+        }
+        else{
+            for( int i = 0; i < count; i++ ){
+                sum[i] += row[i] * weight;
+            }
+        }
+    }
+
+    // Convert Channels of Color to Float and Back ( Rounded and Saturated )
+    inline void unpackColor( const uint32_t color, float* channels )
+    {
+        for( int channel = 0; channel < 4; channel++ ){
+            channels[channel] = static_cast<float>( ( color >> ( channel * 8 ) ) & 0xff );
+        }
+    }
+
+    inline uint32_t packColor( const float* channels )
+    {
+        uint32_t color = 0;
+        for( int channel = 0; channel < 4; channel++ ){
+            const float value = std::min( std::max( channels[channel] + 0.5f, 0.0f ), 255.0f );
+            color |= static_cast<uint32_t>( value ) << ( channel * 8 );
+        }
+        return color;
+    }
+
+    // Filter Color Row Horizontally ( 4 Floats per Pixel )
+    void filterColorRow( const uint32_t* row, const int* offsets, const int* indices, const float* weights, const int width, float* filtered )
+    {
+        for( int x = 0; x < width; x++ ){
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for( int tap = offsets[x]; tap < offsets[x + 1]; tap++ ){
+                float channels[4];
+                unpackColor( row[indices[tap]], channels );
+                for( int channel = 0; channel < 4; channel++ ){
+                    sum[channel] += channels[channel] * weights[tap];
+                }
+            }
+            std::copy( sum, sum + 4, filtered + x * 4 );
+        }
+    }
+
+    void storeColorRow( const float* sum, const int width, uint32_t* row )
+    {
+        for( int x = 0; x < width; x++ ){
+            row[x] = packColor( sum + x * 4 );
+        }
+    }
+
+#ifdef SIMD_X86
+    // Filter Color Row Horizontally ( SSE4.1, Channels of a Pixel in a Vector )
+    SIMD_TARGET_SSE41 void filterColorRowSSE41( const uint32_t* row, const int* offsets, const int* indices, const float* weights, const int width, float* filtered )
+    {
+        for( int x = 0; x < width; x++ ){
+            __m128 sum = _mm_setzero_ps();
+            for( int tap = offsets[x]; tap < offsets[x + 1]; tap++ ){
+                const __m128 channels = _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_cvtsi32_si128( static_cast<int>( row[indices[tap]] ) ) ) );
+                sum = _mm_add_ps( sum, _mm_mul_ps( channels, _mm_set1_ps( weights[tap] ) ) );
+            }
+            _mm_storeu_ps( filtered + x * 4, sum );
+        }
+    }
+
+    // Store Color Row ( SSE4.1, Round and Saturate to 8 bits )
+    SIMD_TARGET_SSE41 void storeColorRowSSE41( const float* sum, const int width, uint32_t* row )
+    {
+        for( int x = 0; x < width; x++ ){
+            const __m128i channels = _mm_cvtps_epi32( _mm_loadu_ps( sum + x * 4 ) );
+            const __m128i packed = _mm_packus_epi16( _mm_packus_epi32( channels, channels ), _mm_setzero_si128() );
+            row[x] = static_cast<uint32_t>( _mm_cvtsi128_si32( packed ) );
+        }
+    }
+
+    // Accumulate Weighted Row ( AVX2 )
+    SIMD_TARGET_AVX2 void accumulateRowAVX2( float* sum, const float* row, const float weight, const int count, const bool first )
+    {
+        const __m256 w = _mm256_set1_ps( weight );
+        int i = 0;
+        if( first ){
+            for( ; i + 8 <= count; i += 8 ){
+                _mm256_storeu_ps( sum + i, _mm256_mul_ps( _mm256_loadu_ps( row + i ), w ) );
+            }
+        }
+        else{
+            for( ; i + 8 <= count; i += 8 ){
+                _mm256_storeu_ps( sum + i, _mm256_fmadd_ps( _mm256_loadu_ps( row + i ), w, _mm256_loadu_ps( sum + i ) ) );
+            }
+        }
+        accumulateRow( sum + i, row + i, weight, count - i, first );
+    }
+#endif
+
+    // Resample Band of Rows Separably
+    // Source rows used by the band are filtered horizontally once into buffer ( row taps increase monotonically ),
+    // then each destination row accumulates its weighted source rows.
+    template<typename FilterRow, typename StoreRow>
+    void resampleBand( const int begin, const int end, const std::vector<int>& offsets, const std::vector<int>& indices, const std::vector<float>& weights,
+                       const int count, const bool avx2, FilterRow filterRow, StoreRow storeRow )
+    {
+        const int first = indices[offsets[begin]];
+        const int last = indices[offsets[end] - 1];
+        std::vector<float> filtered( static_cast<size_t>( last - first + 1 ) * count );
+        for( int row = first; row <= last; row++ ){
+            filterRow( row, &filtered[static_cast<size_t>( row - first ) * count] );
+        }
+
+        std::vector<float> sum( count );
+        for( int y = begin; y < end; y++ ){
+            for( int tap = offsets[y]; tap < offsets[y + 1]; tap++ ){
+                const float* row = &filtered[static_cast<size_t>( indices[tap] - first ) * count];
+#ifdef SIMD_X86
+                if( avx2 ){
+                    accumulateRowAVX2( &sum[0], row, weights[tap], count, tap == offsets[y] );
+                    continue;
+                }
+#endif
+                accumulateRow( &sum[0], row, weights[tap], count, tap == offsets[y] );
+            }
+            storeRow( y, &sum[0] );
+        }
+    }
+}
+
+// Constructor
+Resampler::Resampler( const int sourceWidth, const int sourceHeight, const int destinationWidth, const int destinationHeight, const ResampleFilter filter )
+    : sourceWidth( sourceWidth ), sourceHeight( sourceHeight ), destinationWidth( destinationWidth ), destinationHeight( destinationHeight ), filter( filter )
+{
+    if( sourceWidth <= 0 || sourceHeight <= 0 || destinationWidth <= 0 || destinationHeight <= 0 ){
+        throw std::invalid_argument( "invalid resampling size" );
+    }
+
+    buildTable( sourceWidth, destinationWidth, filter, columns );
+    buildTable( sourceHeight, destinationHeight, filter, rows );
+}
+
+// Build Taps for Axis
+void Resampler::buildTable( const int sourceSize, const int destinationSize, const ResampleFilter filter, Table& table )
+{
+    const double scale = static_cast<double>( sourceSize ) / destinationSize;
+    table.offsets.assign( 1, 0 );
+    table.indices.clear();
+    table.weights.clear();
+    table.nearest.resize( destinationSize );
+
+    for( int i = 0; i < destinationSize; i++ ){
+        table.nearest[i] = std::min( static_cast<int>( ( i + 0.5 ) * scale ), sourceSize - 1 );
+
+        switch( filter ){
+            case ResampleFilter_Box:
+            {
+                // Overlap of Source Pixels with Destination Pixel
+                const double begin = i * scale;
+                const double end = ( i + 1 ) * scale;
+                const int last = std::min( static_cast<int>( std::ceil( end ) ), sourceSize );
+                for( int source = static_cast<int>( begin ); source < last; source++ ){
+                    const double overlap = std::min( end, source + 1.0 ) - std::max( begin, static_cast<double>( source ) );
+                    if( overlap > 1e-6 ){
+                        table.indices.push_back( source );
+                        table.weights.push_back( static_cast<float>( overlap / scale ) );
+                    }
+                }
+                break;
+            }
+            case ResampleFilter_Bilinear:
+            {
+                // Center of Destination Pixel in Source, Clamped to Edge
+                const double center = std::min( std::max( ( i + 0.5 ) * scale - 0.5, 0.0 ), sourceSize - 1.0 );
+                const int first = static_cast<int>( center );
+                const float t = static_cast<float>( center - first );
+                table.indices.push_back( first );
+                table.weights.push_back( 1.0f - t );
+                if( t > 0.0f ){
+                    table.indices.push_back( first + 1 );
+                    table.weights.push_back( t );
+                }
+                break;
+            }
+            default:
+                table.indices.push_back( table.nearest[i] );
+                table.weights.push_back( 1.0f );
+                break;
+        }
+
+        // Normalize ( Rounding of Overlaps )
+        float total = 0.0f;
+        for( size_t tap = table.offsets.back(); tap < table.weights.size(); tap++ ){
+            total += table.weights[tap];
+        }
+        for( size_t tap = table.offsets.back(); tap < table.weights.size(); tap++ ){
+            table.weights[tap] /= total;
+        }
+        table.offsets.push_back( static_cast<int>( table.indices.size() ) );
+    }
+}
+
+// Resample Color
+void Resampler::resampleColor( const uint32_t* source, const size_t sourcePitch, uint32_t* destination, const size_t destinationPitch ) const
+{
+    const int bandCount = ( destinationHeight + bandHeight - 1 ) / bandHeight;
+
+    // Copy Nearest Pixels
+    if( filter == ResampleFilter_Nearest ){
+        ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+            const int end = std::min( destinationHeight, static_cast<int>( band + 1 ) * bandHeight );
+            for( int y = static_cast<int>( band ) * bandHeight; y < end; y++ ){
+                const uint32_t* src = sourceRow( source, sourcePitch, rows.nearest[y] );
+                uint32_t* dst = destinationRow( destination, destinationPitch, y );
+                for( int x = 0; x < destinationWidth; x++ ){
+                    dst[x] = src[columns.nearest[x]];
+                }
+            }
+        } );
+        return;
+    }
+
+    const bool sse41 = IsSupportedSSE41();
+    const bool avx2 = IsSupportedAVX2();
+    ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+        const int begin = static_cast<int>( band ) * bandHeight;
+        const int end = std::min( destinationHeight, begin + bandHeight );
+        resampleBand( begin, end, rows.offsets, rows.indices, rows.weights, destinationWidth * 4, avx2,
+            [&]( const int y, float* filtered ){
+                const uint32_t* src = sourceRow( source, sourcePitch, y );
+#ifdef SIMD_X86
+                if( sse41 ){
+                    filterColorRowSSE41( src, &columns.offsets[0], &columns.indices[0], &columns.weights[0], destinationWidth, filtered );
+                    return;
+                }
+#endif
+                filterColorRow( src, &columns.offsets[0], &columns.indices[0], &columns.weights[0], destinationWidth, filtered );
+            },
+            [&]( const int y, const float* sum ){
+                uint32_t* dst = destinationRow( destination, destinationPitch, y );
+#ifdef SIMD_X86
+                if( sse41 ){
+                    storeColorRowSSE41( sum, destinationWidth, dst );
+                    return;
+                }
+#endif
+                storeColorRow( sum, destinationWidth, dst );
+            } );
+    } );
+}
+
+// Resample Float Image
+void Resampler::resampleFloat( const float* source, const size_t sourcePitch, float* destination, const size_t destinationPitch, const int channels ) const
+{
+    if( channels <= 0 ){
+        throw std::invalid_argument( "invalid number of channels" );
+    }
+
+    const int bandCount = ( destinationHeight + bandHeight - 1 ) / bandHeight;
+
+    // Copy Nearest Pixels
+    if( filter == ResampleFilter_Nearest ){
+        ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+            const int end = std::min( destinationHeight, static_cast<int>( band + 1 ) * bandHeight );
+            for( int y = static_cast<int>( band ) * bandHeight; y < end; y++ ){
+                const float* src = sourceRow( source, sourcePitch, rows.nearest[y] );
+                float* dst = destinationRow( destination, destinationPitch, y );
+                if( channels == 1 ){
+                    for( int x = 0; x < destinationWidth; x++ ){
+                        dst[x] = src[columns.nearest[x]];
+                    }
+                    continue;
+                }
+                for( int x = 0; x < destinationWidth; x++ ){
+                    const float* pixel = src + columns.nearest[x] * channels;
+                    for( int channel = 0; channel < channels; channel++ ){
+                        dst[x * channels + channel] = pixel[channel];
+                    }
+                }
+            }
+        } );
+        return;
+    }
+
+    const bool avx2 = IsSupportedAVX2();
+    ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+        const int begin = static_cast<int>( band ) * bandHeight;
+        const int end = std::min( destinationHeight, begin + bandHeight );
+        resampleBand( begin, end, rows.offsets, rows.indices, rows.weights, destinationWidth * channels, avx2,
+            [&]( const int y, float* filtered ){
+                const float* src = sourceRow( source, sourcePitch, y );
+                if( channels == 1 ){
+                    for( int x = 0; x < destinationWidth; x++ ){
+                        float sum = 0.0f;
+                        for( int tap = columns.offsets[x]; tap < columns.offsets[x + 1]; tap++ ){
+                            sum += src[columns.indices[tap]] * columns.weights[tap];
+                        }
+                        filtered[x] = sum;
+                    }
+                    return;
+                }
+                for( int x = 0; x < destinationWidth; x++ ){
+                    float* pixel = filtered + x * channels;
+                    std::fill( pixel, pixel + channels, 0.0f );
+                    for( int tap = columns.offsets[x]; tap < columns.offsets[x + 1]; tap++ ){
+                        const float* value = src + columns.indices[tap] * channels;
+                        for( int channel = 0; channel < channels; channel++ ){
+                            pixel[channel] += value[channel] * columns.weights[tap];
+                        }
+                    }
+                }
+            },
+            [&]( const int y, const float* sum ){
+                std::copy( sum, sum + destinationWidth * channels, destinationRow( destination, destinationPitch, y ) );
+            } );
+    } );
+}
+
+// Resample Depth Preserving Invalid Pixels and Depth Discontinuities
+void Resampler::resampleDepth( const float* source, const size_t sourcePitch, float* destination, const size_t destinationPitch, const float discontinuity ) const
+{
+    const int bandCount = ( destinationHeight + bandHeight - 1 ) / bandHeight;
+    ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+        const int end = std::min( destinationHeight, static_cast<int>( band + 1 ) * bandHeight );
+        for( int y = static_cast<int>( band ) * bandHeight; y < end; y++ ){
+            const float* center = sourceRow( source, sourcePitch, rows.nearest[y] );
+            float* dst = destinationRow( destination, destinationPitch, y );
+            for( int x = 0; x < destinationWidth; x++ ){
+                // Invalid if Nearest Pixel is Invalid
+                const float reference = center[columns.nearest[x]];
+                if( !( reference > 0.0f ) ){
+                    dst[x] = 0.0f;
+                    continue;
+                }
+
+                // Weighted Average of Valid Pixels on Same Surface
+                float sum = 0.0f;
+                float weight = 0.0f;
+                for( int row = rows.offsets[y]; row < rows.offsets[y + 1]; row++ ){
+                    const float* src = sourceRow( source, sourcePitch, rows.indices[row] );
+                    for( int column = columns.offsets[x]; column < columns.offsets[x + 1]; column++ ){
+                        const float depth = src[columns.indices[column]];
+                        if( depth > 0.0f && std::fabs( depth - reference ) <= discontinuity ){
+                            const float w = rows.weights[row] * columns.weights[column];
+                            sum += depth * w;
+                            weight += w;
+                        }
+                    }
+                }
+                dst[x] = sum / weight;
+            }
+        }
+    } );
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef __RESAMPLER__
+#define __RESAMPLER__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Resampling Filter
+enum ResampleFilter
+{
+    ResampleFilter_Nearest  = 0, // Pixel at Center of Destination Pixel
+    ResampleFilter_Box      = 1, // Area Average ( Anti-Aliased Downsampling )
+    ResampleFilter_Bilinear = 2  // Linear Interpolation of 2 x 2 Pixels at Center of Destination Pixel
+};
+
+// Image Resampler ( Arbitrary Scale Factors )
+//
+// Source and destination sizes are fixed at construction, and the taps ( source index and weight ) of every destination column and row
+// are built once, so resampling a frame does no index math per pixel. Filters are separable, each destination row accumulates
+// its source rows filtered horizontally ( SSE4.1 for color ) with AVX2 multiply-add, rows are processed in parallel on the thread pool.
+// Depth is filtered in 2D and invalid preserving, a destination pixel is invalid if its nearest source pixel is invalid,
+// otherwise it is weighted average of valid source pixels within discontinuity of the nearest one.
+// Pitch is in bytes, so a sub-rectangle of source can be resampled by offsetting source pointer.
+class Resampler
+{
+private:
+    // Taps of Destination Columns or Rows
+    struct Table
+    {
+        std::vector<int> offsets;   // First Tap of Each Destination Pixel ( Size + 1 )
+        std::vector<int> indices;   // Source Pixel of Tap
+        std::vector<float> weights; // Weight of Tap ( Sum to 1 per Destination Pixel )
+        std::vector<int> nearest;   // Source Pixel at Center of Destination Pixel
+    };
+
+    int sourceWidth;
+    int sourceHeight;
+    int destinationWidth;
+    int destinationHeight;
+    ResampleFilter filter;
+    Table columns;
+    Table rows;
+
+public:
+    // Constructor
+    Resampler( const int sourceWidth, const int sourceHeight, const int destinationWidth, const int destinationHeight, const ResampleFilter filter );
+
+    // Resample Color ( BGRA, 8 bits per Channel, e.g. NUI_FUSION_IMAGE_TYPE_COLOR )
+    void resampleColor( const uint32_t* source, const size_t sourcePitch, uint32_t* destination, const size_t destinationPitch ) const;
+
+    // Resample Float Image of Channels per Pixel ( e.g. 1 for NUI_FUSION_IMAGE_TYPE_FLOAT, 6 for NUI_FUSION_IMAGE_TYPE_POINT_CLOUD )
+    void resampleFloat( const float* source, const size_t sourcePitch, float* destination, const size_t destinationPitch, const int channels = 1 ) const;
+
+    // Resample Depth ( Meters, 0 is Invalid ) Preserving Invalid Pixels and Depth Discontinuities ( Meters )
+    void resampleDepth( const float* source, const size_t sourcePitch, float* destination, const size_t destinationPitch, const float discontinuity = 0.1f ) const;
+
+    // Retrieve Sizes
+    int getSourceWidth() const { return sourceWidth; }
+    int getSourceHeight() const { return sourceHeight; }
+    int getDestinationWidth() const { return destinationWidth; }
+    int getDestinationHeight() const { return destinationHeight; }
+
+private:
+    // Build Taps for Axis
+    static void buildTable( const int sourceSize, const int destinationSize, const ResampleFilter filter, Table& table );
+};
+
+#endif // __RESAMPLER__
\ No newline at end of file
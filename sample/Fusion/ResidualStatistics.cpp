@@ -0,0 +1,157 @@
+#include "ResidualStatistics.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Number of Row Bands ( Reduction Slots )
+    const int bandCount = 64;
+
+    // Sums of Band
+    struct Sums
+    {
+        unsigned int zeroPixels;
+        unsigned int validPixels;
+        unsigned int invalidPixels;
+        double distance;
+    };
+
+    // Shade Residual ( ARGB )
+    inline uint32_t shadeResidual( const float residual )
+    {
+        const uint32_t red = static_cast<uint32_t>( static_cast<unsigned char>( 255.0f * std::min( std::max( 1.0f + residual, 0.0f ), 1.0f ) ) );
+        const uint32_t green = static_cast<uint32_t>( static_cast<unsigned char>( 255.0f * std::min( std::max( 1.0f - std::fabs( residual ), 0.0f ), 1.0f ) ) );
+        const uint32_t blue = static_cast<uint32_t>( static_cast<unsigned char>( 255.0f * std::min( std::max( 1.0f - residual, 0.0f ), 1.0f ) ) );
+        return ( 255u << 24 ) | ( red << 16 ) | ( green << 8 ) | blue;
+    }
+
+    // Classify and Shade Row from Column
+    void shadeRow( const float* residual, uint32_t* shaded, const int begin, const int width, Sums& sums )
+    {
+        float distance = 0.0f;
+        for( int x = begin; x < width; x++ ){
+            const float value = residual[x];
+            if( value == 0.0f ){
+                sums.zeroPixels++;
+            }
+            else if( value == 2.0f ){
+                sums.invalidPixels++;
+            }
+            else if( value <= 1.0f ){
+                sums.validPixels++;
+                distance += value;
+            }
+            if( shaded != nullptr ){
+                shaded[x] = ( value <= 1.0f ) ? shadeResidual( value ) : 0;
+            }
+        }
+        sums.distance += distance;
+    }
+
+#ifdef SIMD_X86
+    // Classify and Shade Row ( AVX2, 8 Pixels at Once )
+    SIMD_TARGET_AVX2 void shadeRowAVX2( const float* residual, uint32_t* shaded, const int width, Sums& sums )
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps( 1.0f );
+        const __m256 two = _mm256_set1_ps( 2.0f );
+        const __m256 scale = _mm256_set1_ps( 255.0f );
+        const __m256 sign = _mm256_set1_ps( -0.0f );
+        const __m256i alpha = _mm256_set1_epi32( static_cast<int>( 0xff000000 ) );
+
+        __m256i zeroCount = _mm256_setzero_si256();
+        __m256i validCount = _mm256_setzero_si256();
+        __m256i invalidCount = _mm256_setzero_si256();
+        __m256 distance = _mm256_setzero_ps();
+
+        int x = 0;
+        for( ; x + 8 <= width; x += 8 ){
+            const __m256 value = _mm256_loadu_ps( residual + x );
+
+            // Classify ( Mask is -1, so Subtract to Count )
+            const __m256 isZero = _mm256_cmp_ps( value, zero, _CMP_EQ_OQ );
+            const __m256 isInvalid = _mm256_cmp_ps( value, two, _CMP_EQ_OQ );
+            const __m256 inRange = _mm256_cmp_ps( value, one, _CMP_LE_OQ );
+            const __m256 isValid = _mm256_andnot_ps( isZero, inRange );
+            zeroCount = _mm256_sub_epi32( zeroCount, _mm256_castps_si256( isZero ) );
+            invalidCount = _mm256_sub_epi32( invalidCount, _mm256_castps_si256( isInvalid ) );
+            validCount = _mm256_sub_epi32( validCount, _mm256_castps_si256( isValid ) );
+            distance = _mm256_add_ps( distance, _mm256_and_ps( value, isValid ) );
+
+            if( shaded != nullptr ){
+                // Clamp and Truncate to Byte
+                const __m256 red = _mm256_mul_ps( scale, _mm256_min_ps( _mm256_max_ps( _mm256_add_ps( one, value ), zero ), one ) );
+                const __m256 green = _mm256_mul_ps( scale, _mm256_min_ps( _mm256_max_ps( _mm256_sub_ps( one, _mm256_andnot_ps( sign, value ) ), zero ), one ) );
+                const __m256 blue = _mm256_mul_ps( scale, _mm256_min_ps( _mm256_max_ps( _mm256_sub_ps( one, value ), zero ), one ) );
+                __m256i color = _mm256_or_si256( alpha, _mm256_slli_epi32( _mm256_cvttps_epi32( red ), 16 ) );
+                color = _mm256_or_si256( color, _mm256_slli_epi32( _mm256_cvttps_epi32( green ), 8 ) );
+                color = _mm256_or_si256( color, _mm256_cvttps_epi32( blue ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( shaded + x ), _mm256_and_si256( color, _mm256_castps_si256( inRange ) ) );
+            }
+        }
+
+        // Horizontal Sums
+        alignas( 32 ) uint32_t counts[3][8];
+        alignas( 32 ) float distances[8];
+        _mm256_store_si256( reinterpret_cast<__m256i*>( counts[0] ), zeroCount );
+        _mm256_store_si256( reinterpret_cast<__m256i*>( counts[1] ), validCount );
+        _mm256_store_si256( reinterpret_cast<__m256i*>( counts[2] ), invalidCount );
+        _mm256_store_ps( distances, distance );
+        float rowDistance = 0.0f;
+        for( int i = 0; i < 8; i++ ){
+            sums.zeroPixels += counts[0][i];
+            sums.validPixels += counts[1][i];
+            sums.invalidPixels += counts[2][i];
+            rowDistance += distances[i];
+        }
+        sums.distance += rowDistance;
+
+        shadeRow( residual, shaded, x, width, sums );
+    }
+#endif
+}
+
+// Classify and Shade Residual Image in a Single Pass
+void ShadeResiduals( const float* residual, const size_t residualPitch, uint32_t* shaded, const size_t shadedPitch, const int width, const int height, ResidualStatistics* statistics )
+{
+    Sums bands[bandCount] = {};
+    const int bandHeight = ( height + bandCount - 1 ) / bandCount;
+    const bool avx2 = IsSupportedAVX2();
+    ThreadPool::global().parallelFor( bandCount, [&]( const size_t band ){
+        const int begin = static_cast<int>( band ) * bandHeight;
+        const int end = std::min( height, begin + bandHeight );
+        Sums& sums = bands[band];
+        for( int y = begin; y < end; y++ ){
+            const float* residualRow = reinterpret_cast<const float*>( reinterpret_cast<const unsigned char*>( residual ) + y * residualPitch );
+            uint32_t* shadedRow = ( shaded != nullptr ) ? reinterpret_cast<uint32_t*>( reinterpret_cast<unsigned char*>( shaded ) + y * shadedPitch ) : nullptr;
+#ifdef SIMD_X86
+            if( avx2 ){
+                shadeRowAVX2( residualRow, shadedRow, width, sums );
+                continue;
+            }
+#endif
+            shadeRow( residualRow, shadedRow, 0, width, sums );
+        }
+    } );
+
+    if( statistics == nullptr ){
+        return;
+    }
+
+    // Sum Bands in Order
+    Sums total = {};
+    for( int band = 0; band < bandCount; band++ ){
+        total.zeroPixels += bands[band].zeroPixels;
+        total.validPixels += bands[band].validPixels;
+        total.invalidPixels += bands[band].invalidPixels;
+        total.distance += bands[band].distance;
+    }
+    statistics->totalPixels = width * height;
+    statistics->zeroPixels = total.zeroPixels;
+    statistics->validPixels = total.validPixels;
+    statistics->invalidDepthOutsideVolumePixels = total.invalidPixels;
+    statistics->totalValidPixelsDistance = static_cast<float>( total.distance );
+}
\ No newline at end of file
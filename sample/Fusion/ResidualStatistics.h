@@ -0,0 +1,25 @@
+#ifndef __RESIDUAL_STATISTICS__
+#define __RESIDUAL_STATISTICS__
+
+#include <cstddef>
+#include <cstdint>
+
+// Residual Statistics ( Same Fields as DeltaFromReferenceImageStatistics )
+struct ResidualStatistics
+{
+    unsigned int totalPixels;
+    unsigned int zeroPixels;                      // Residual is 0
+    unsigned int validPixels;                     // Residual is <= 1 and not 0
+    unsigned int invalidDepthOutsideVolumePixels; // Residual is 2 ( Invalid Depth or Outside Volume )
+    float totalValidPixelsDistance;
+};
+
+// Classify and Shade Residual Image in a Single Pass ( Same Results as CalculateResidualStatistics and ColorResiduals )
+//
+// Shaded color is ARGB, red for positive and blue for negative residual, 0 for invalid residual.
+// Rows are split into fixed bands on the thread pool, each band is reduced into its own slot and the slots are summed in order,
+// so nothing is allocated per call and the result does not depend on the number of threads.
+// Pitch is in bytes, shaded or statistics may be nullptr to skip.
+void ShadeResiduals( const float* residual, const size_t residualPitch, uint32_t* shaded, const size_t shadedPitch, const int width, const int height, ResidualStatistics* statistics );
+
+#endif // __RESIDUAL_STATISTICS__
\ No newline at end of file
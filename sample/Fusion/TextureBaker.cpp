@@ -0,0 +1,584 @@
+#include "TextureBaker.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Chart ( Connected Triangles Projected to Plane of Axis )
+    struct Chart
+    {
+        int axis;                        // Dominant Axis of Normal ( Texture is Projected along this Axis )
+        uint32_t firstTriangle;          // Range in Sorted Triangles
+        uint32_t triangleCount;
+        uint32_t firstVertex;            // Range in Textured Mesh Vertices
+        uint32_t vertexCount;
+        float minU;                      // Minimum Plane Coordinates ( Meters )
+        float minV;
+        float scale;                     // Texels per Meter
+        int width;                       // Size in Texels ( Including Padding )
+        int height;
+        int x;                           // Position in Atlas
+        int y;
+    };
+
+    // Keyframe Projection
+    struct View
+    {
+        const TextureKeyframe* keyframe;
+        float fx;
+        float fy;
+        float cx;
+        float cy;
+        float center[3];                 // Camera Position in World
+    };
+
+    // Plane Axes of Projection Axis
+    inline void planeAxes( const int axis, int& u, int& v )
+    {
+        u = ( axis == 0 ) ? 1 : 0;
+        v = ( axis == 2 ) ? 1 : 2;
+    }
+
+    // Find Root of Union-Find ( Path Halving )
+    inline uint32_t findRoot( std::vector<uint32_t>& parents, uint32_t index )
+    {
+        while( parents[index] != index ){
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    }
+
+    // Normalized Dot Product ( Same as dot_normalized of KinectFusionHelper )
+    inline float dotNormalized( const float* a, const float* b )
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    inline bool normalize( float* vector )
+    {
+        const float length = std::sqrt( vector[0] * vector[0] + vector[1] * vector[1] + vector[2] * vector[2] );
+        if( !( length > 0.0f ) ){
+            return false;
+        }
+        vector[0] /= length;
+        vector[1] /= length;
+        vector[2] /= length;
+        return true;
+    }
+
+    // Project Point to Keyframe ( Pixel Centers at Integer Coordinates, Same as TsdfVolume ), Returns Depth ( 0 and x = y = 0 if Behind Camera )
+    inline float project( const View& view, const float* point, float& x, float& y )
+    {
+        float camera[3];
+        TransformPoint( view.keyframe->worldToCamera, point[0], point[1], point[2], camera );
+        if( !( camera[2] > 0.0f ) ){
+            x = 0.0f;
+            y = 0.0f;
+            return 0.0f;
+        }
+        x = ( camera[0] / camera[2] ) * view.fx + view.cx;
+        y = ( camera[1] / camera[2] ) * view.fy + view.cy;
+        return camera[2];
+    }
+
+    // Bilinear Sample of Valid Pixels ( Same Weights as bilinear_sample of KinectFusionHelper, Invalid Pixels are Excluded )
+    inline bool sampleColor( const TextureKeyframe& keyframe, const float x, const float y, float* color )
+    {
+        const int x0 = static_cast<int>( std::floor( x ) );
+        const int y0 = static_cast<int>( std::floor( y ) );
+        const float fractionX = x - x0;
+        const float fractionY = y - y0;
+
+        float sum[3] = { 0.0f, 0.0f, 0.0f };
+        float weight = 0.0f;
+        for( int dy = 0; dy < 2; dy++ ){
+            const int yi = std::min( std::max( y0 + dy, 0 ), keyframe.height - 1 );
+            const float weightY = dy ? fractionY : 1.0f - fractionY;
+            for( int dx = 0; dx < 2; dx++ ){
+                const int xi = std::min( std::max( x0 + dx, 0 ), keyframe.width - 1 );
+                const uint32_t pixel = keyframe.color[yi * keyframe.width + xi];
+                if( ( pixel & 0xff000000 ) == 0 ){
+                    continue;
+                }
+                const float w = weightY * ( dx ? fractionX : 1.0f - fractionX );
+                sum[0] += w * ( pixel & 0xff );
+                sum[1] += w * ( ( pixel >> 8 ) & 0xff );
+                sum[2] += w * ( ( pixel >> 16 ) & 0xff );
+                weight += w;
+            }
+        }
+        if( !( weight > 0.0f ) ){
+            return false;
+        }
+        for( int channel = 0; channel < 3; channel++ ){
+            color[channel] = sum[channel] / weight;
+        }
+        return true;
+    }
+
+    // Pack Color ( BGRA, Full Alpha )
+    inline uint32_t packColor( const float* color )
+    {
+        uint32_t result = 0xff000000;
+        for( int channel = 0; channel < 3; channel++ ){
+            const float value = std::min( std::max( color[channel] + 0.5f, 0.0f ), 255.0f );
+            result |= static_cast<uint32_t>( value ) << ( channel * 8 );
+        }
+        return result;
+    }
+
+    // Interpolate Vertex Colors by Barycentric Weights
+    inline uint32_t interpolateColor( const uint32_t* colors, const float* weights )
+    {
+        float color[3] = { 0.0f, 0.0f, 0.0f };
+        for( int corner = 0; corner < 3; corner++ ){
+            for( int channel = 0; channel < 3; channel++ ){
+                color[channel] += weights[corner] * ( ( colors[corner] >> ( channel * 8 ) ) & 0xff );
+            }
+        }
+        return packColor( color );
+    }
+}
+
+// Constructor
+TextureBaker::TextureBaker( const TextureBakerParameters& parameters )
+    : parameters( parameters ),
+      statistics()
+{
+    if( !( parameters.texelsPerMeter > 0.0f ) || parameters.padding < 0 || parameters.atlasWidth <= 2 * parameters.padding + 1 ){
+        throw std::invalid_argument( "invalid texture baker parameters" );
+    }
+}
+
+// Bake Atlas from Keyframes
+void TextureBaker::bake( const IndexedMesh& mesh, const std::vector<TextureKeyframe>& keyframes, IndexedMesh& texturedMesh, TextureAtlas& atlas )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const size_t vertexCount = mesh.vertexCount();
+    const size_t triangleCount = mesh.triangleCount();
+    const bool color = !mesh.colors.empty();
+    if( color && mesh.colors.size() != vertexCount ){
+        throw std::invalid_argument( "invalid number of colors" );
+    }
+    if( triangleCount > 0x7fffffff ){
+        throw std::invalid_argument( "too many triangles" );
+    }
+    for( const TextureKeyframe& keyframe : keyframes ){
+        const size_t pixels = static_cast<size_t>( keyframe.width ) * keyframe.height;
+        if( keyframe.width <= 0 || keyframe.height <= 0 || keyframe.color.size() != pixels || keyframe.depth.size() != pixels ){
+            throw std::invalid_argument( "invalid keyframe" );
+        }
+    }
+
+    statistics = TextureBakeStatistics();
+    statistics.triangles = triangleCount;
+
+    // Smoothed Vertex Normals ( Sum of Area Weighted Face Normals )
+    const float* vertices = mesh.vertices.data();
+    const uint32_t* indices = mesh.indices.data();
+    std::vector<float> normals( vertexCount * 3, 0.0f );
+    for( size_t t = 0; t < triangleCount; t++ ){
+        const float* a = &vertices[indices[t * 3 + 0] * 3];
+        const float* b = &vertices[indices[t * 3 + 1] * 3];
+        const float* c = &vertices[indices[t * 3 + 2] * 3];
+        const float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const float normal[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        for( int corner = 0; corner < 3; corner++ ){
+            float* n = &normals[indices[t * 3 + corner] * 3];
+            n[0] += normal[0];
+            n[1] += normal[1];
+            n[2] += normal[2];
+        }
+    }
+    for( size_t i = 0; i < vertexCount; i++ ){
+        normalize( &normals[i * 3] );
+    }
+
+    // Label Triangles by Dominant Axis and Direction of Smoothed Normal ( 0 - 5 )
+    std::vector<uint8_t> labels( triangleCount );
+    for( size_t t = 0; t < triangleCount; t++ ){
+        float normal[3] = { 0.0f, 0.0f, 0.0f };
+        for( int corner = 0; corner < 3; corner++ ){
+            const float* n = &normals[indices[t * 3 + corner] * 3];
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+        int axis = 0;
+        for( int k = 1; k < 3; k++ ){
+            if( std::fabs( normal[k] ) > std::fabs( normal[axis] ) ){
+                axis = k;
+            }
+        }
+        labels[t] = static_cast<uint8_t>( axis * 2 + ( ( normal[axis] < 0.0f ) ? 1 : 0 ) );
+    }
+
+    // Connect Triangles of Same Label Sharing a Vertex ( Union-Find )
+    const uint32_t empty = 0xffffffff;
+    std::vector<uint32_t> parents( triangleCount );
+    for( size_t t = 0; t < triangleCount; t++ ){
+        parents[t] = static_cast<uint32_t>( t );
+    }
+    {
+        std::vector<uint32_t> owners( vertexCount * 6, empty );
+        for( size_t t = 0; t < triangleCount; t++ ){
+            for( int corner = 0; corner < 3; corner++ ){
+                uint32_t& owner = owners[indices[t * 3 + corner] * 6 + labels[t]];
+                if( owner == empty ){
+                    owner = static_cast<uint32_t>( t );
+                    continue;
+                }
+                const uint32_t first = findRoot( parents, owner );
+                const uint32_t second = findRoot( parents, static_cast<uint32_t>( t ) );
+                if( first != second ){
+                    parents[std::max( first, second )] = std::min( first, second );
+                }
+            }
+        }
+    }
+
+    // Number Charts in Order of First Triangle, and Sort Triangles by Chart ( Counting Sort )
+    std::vector<Chart> charts;
+    std::vector<uint32_t> chartOfTriangle( triangleCount );
+    for( size_t t = 0; t < triangleCount; t++ ){
+        const uint32_t root = findRoot( parents, static_cast<uint32_t>( t ) );
+        if( root == t ){
+            Chart chart = {};
+            chart.axis = labels[t] / 2;
+            chartOfTriangle[t] = static_cast<uint32_t>( charts.size() );
+            charts.push_back( chart );
+        }
+        else{
+            chartOfTriangle[t] = chartOfTriangle[root];
+        }
+        charts[chartOfTriangle[t]].triangleCount++;
+    }
+    std::vector<uint32_t> triangles( triangleCount );
+    {
+        uint32_t offset = 0;
+        for( Chart& chart : charts ){
+            chart.firstTriangle = offset;
+            offset += chart.triangleCount;
+            chart.triangleCount = 0;
+        }
+        for( size_t t = 0; t < triangleCount; t++ ){
+            Chart& chart = charts[chartOfTriangle[t]];
+            triangles[chart.firstTriangle + chart.triangleCount++] = static_cast<uint32_t>( t );
+        }
+    }
+    statistics.charts = charts.size();
+
+    // Duplicate Vertices per Chart ( Textured Mesh Indices Refer to Chart Vertices )
+    texturedMesh.vertices.clear();
+    texturedMesh.colors.clear();
+    texturedMesh.texcoords.clear();
+    texturedMesh.indices.resize( triangleCount * 3 );
+    std::vector<uint32_t> sources;
+    {
+        std::vector<uint32_t> stamps( vertexCount, empty );
+        std::vector<uint32_t> remap( vertexCount );
+        for( uint32_t c = 0; c < charts.size(); c++ ){
+            Chart& chart = charts[c];
+            chart.firstVertex = static_cast<uint32_t>( sources.size() );
+            for( uint32_t i = 0; i < chart.triangleCount; i++ ){
+                const uint32_t t = triangles[chart.firstTriangle + i];
+                for( int corner = 0; corner < 3; corner++ ){
+                    const uint32_t vertex = indices[t * 3 + corner];
+                    if( stamps[vertex] != c ){
+                        stamps[vertex] = c;
+                        remap[vertex] = static_cast<uint32_t>( sources.size() );
+                        sources.push_back( vertex );
+                    }
+                    texturedMesh.indices[t * 3 + corner] = remap[vertex];
+                }
+            }
+            chart.vertexCount = static_cast<uint32_t>( sources.size() ) - chart.firstVertex;
+        }
+    }
+    const size_t texturedVertexCount = sources.size();
+    texturedMesh.vertices.resize( texturedVertexCount * 3 );
+    texturedMesh.texcoords.resize( texturedVertexCount * 2 );
+    if( color ){
+        texturedMesh.colors.resize( texturedVertexCount );
+    }
+
+    // Size Charts in Parallel ( Texel Coordinates are Stored in Texture Coordinates until Atlas Size is Known )
+    const int padding = parameters.padding;
+    ThreadPool::global().parallelFor( charts.size(), [&]( const size_t c ){
+        Chart& chart = charts[c];
+        int u, v;
+        planeAxes( chart.axis, u, v );
+        float minimum[2] = { vertices[sources[chart.firstVertex] * 3 + u], vertices[sources[chart.firstVertex] * 3 + v] };
+        float maximum[2] = { minimum[0], minimum[1] };
+        for( uint32_t i = chart.firstVertex; i < chart.firstVertex + chart.vertexCount; i++ ){
+            const float* position = &vertices[sources[i] * 3];
+            minimum[0] = std::min( minimum[0], position[u] );
+            minimum[1] = std::min( minimum[1], position[v] );
+            maximum[0] = std::max( maximum[0], position[u] );
+            maximum[1] = std::max( maximum[1], position[v] );
+        }
+
+        // Scale Down Chart Wider than Atlas
+        const float extent = std::max( maximum[0] - minimum[0], maximum[1] - minimum[1] );
+        const float available = static_cast<float>( parameters.atlasWidth - 2 * padding - 1 );
+        chart.scale = ( extent * parameters.texelsPerMeter > available ) ? available / extent : parameters.texelsPerMeter;
+        chart.minU = minimum[0];
+        chart.minV = minimum[1];
+        chart.width = std::min( static_cast<int>( std::ceil( ( maximum[0] - minimum[0] ) * chart.scale ) ) + 1 + 2 * padding, parameters.atlasWidth );
+        chart.height = std::min( static_cast<int>( std::ceil( ( maximum[1] - minimum[1] ) * chart.scale ) ) + 1 + 2 * padding, parameters.atlasWidth );
+
+        // Vertices are at Least Half Texel Inside Padding
+        for( uint32_t i = chart.firstVertex; i < chart.firstVertex + chart.vertexCount; i++ ){
+            const uint32_t source = sources[i];
+            const float* position = &vertices[source * 3];
+            std::copy( position, position + 3, &texturedMesh.vertices[i * 3] );
+            texturedMesh.texcoords[i * 2 + 0] = padding + 0.5f + ( position[u] - chart.minU ) * chart.scale;
+            texturedMesh.texcoords[i * 2 + 1] = padding + 0.5f + ( position[v] - chart.minV ) * chart.scale;
+            if( color ){
+                texturedMesh.colors[i] = mesh.colors[source];
+            }
+        }
+    } );
+    const std::chrono::steady_clock::time_point charted = std::chrono::steady_clock::now();
+
+    // Pack Charts to Shelves in Order of Height ( then Width, Index for Stable Order )
+    std::vector<uint32_t> order( charts.size() );
+    for( uint32_t c = 0; c < order.size(); c++ ){
+        order[c] = c;
+    }
+    std::sort( order.begin(), order.end(), [&]( const uint32_t a, const uint32_t b ){
+        if( charts[a].height != charts[b].height ){
+            return charts[a].height > charts[b].height;
+        }
+        if( charts[a].width != charts[b].width ){
+            return charts[a].width > charts[b].width;
+        }
+        return a < b;
+    } );
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
+    for( const uint32_t c : order ){
+        Chart& chart = charts[c];
+        if( shelfX + chart.width > parameters.atlasWidth ){
+            shelfX = 0;
+            shelfY += shelfHeight;
+            shelfHeight = 0;
+        }
+        chart.x = shelfX;
+        chart.y = shelfY;
+        shelfX += chart.width;
+        shelfHeight = std::max( shelfHeight, chart.height );
+    }
+    atlas.width = parameters.atlasWidth;
+    atlas.height = std::max( shelfY + shelfHeight, 1 );
+    atlas.pixels.assign( static_cast<size_t>( atlas.width ) * atlas.height, 0 );
+    const std::chrono::steady_clock::time_point packed = std::chrono::steady_clock::now();
+
+    // Keyframe Projections
+    std::vector<View> views( keyframes.size() );
+    for( size_t k = 0; k < keyframes.size(); k++ ){
+        const TextureKeyframe& keyframe = keyframes[k];
+        View& view = views[k];
+        view.keyframe = &keyframe;
+        view.fx = keyframe.camera.focalLengthX * keyframe.width;
+        view.fy = keyframe.camera.focalLengthY * keyframe.height;
+        view.cx = keyframe.camera.principalPointX * keyframe.width;
+        view.cy = keyframe.camera.principalPointY * keyframe.height;
+        const Matrix4f cameraToWorld = InvertRigidMatrix4f( keyframe.worldToCamera );
+        view.center[0] = cameraToWorld.M41;
+        view.center[1] = cameraToWorld.M42;
+        view.center[2] = cameraToWorld.M43;
+    }
+
+    // Bake Charts in Parallel ( Largest First, Charts Own Disjoint Rectangles of Atlas )
+    std::vector<size_t> texels( charts.size() );
+    std::vector<size_t> projectedTexels( charts.size() );
+    ThreadPool::global().parallelFor( order.size(), [&]( const size_t o ){
+        const Chart& chart = charts[order[o]];
+        uint32_t* pixels = &atlas.pixels[static_cast<size_t>( chart.y ) * atlas.width + chart.x];
+        std::vector<uint8_t> masks( static_cast<size_t>( chart.width ) * chart.height, 0 );
+        std::vector<const View*> candidates;
+        candidates.reserve( views.size() );
+
+        for( uint32_t i = 0; i < chart.triangleCount; i++ ){
+            const uint32_t t = triangles[chart.firstTriangle + i];
+            const uint32_t* corners = &texturedMesh.indices[t * 3];
+            const float* position[3];
+            const float* normal[3];
+            const float* texel[3];
+            uint32_t colors[3] = { 0xff808080, 0xff808080, 0xff808080 };
+            for( int corner = 0; corner < 3; corner++ ){
+                position[corner] = &texturedMesh.vertices[corners[corner] * 3];
+                normal[corner] = &normals[sources[corners[corner]] * 3];
+                texel[corner] = &texturedMesh.texcoords[corners[corner] * 2];
+                if( color ){
+                    colors[corner] = texturedMesh.colors[corners[corner]];
+                }
+            }
+
+            // Keyframes that may See Triangle ( Front of Camera and not All Corners Outside Same Side of Image )
+            candidates.clear();
+            for( const View& view : views ){
+                int outside[4] = { 0, 0, 0, 0 };
+                bool behind = false;
+                for( int corner = 0; corner < 3; corner++ ){
+                    float x, y;
+                    behind = !( project( view, position[corner], x, y ) > 0.0f );
+                    if( behind ){
+                        break;
+                    }
+                    outside[0] += ( x < -0.5f );
+                    outside[1] += ( y < -0.5f );
+                    outside[2] += ( x > view.keyframe->width - 0.5f );
+                    outside[3] += ( y > view.keyframe->height - 0.5f );
+                }
+                if( !behind && outside[0] < 3 && outside[1] < 3 && outside[2] < 3 && outside[3] < 3 ){
+                    candidates.push_back( &view );
+                }
+            }
+
+            // Rasterize Texel Centers Inside Triangle ( Edge Functions )
+            const float area = ( texel[1][0] - texel[0][0] ) * ( texel[2][1] - texel[0][1] ) - ( texel[2][0] - texel[0][0] ) * ( texel[1][1] - texel[0][1] );
+            if( std::fabs( area ) < 1.0e-12f ){
+                continue;
+            }
+            const int beginX = std::max( static_cast<int>( std::floor( std::min( { texel[0][0], texel[1][0], texel[2][0] } ) ) ), 0 );
+            const int beginY = std::max( static_cast<int>( std::floor( std::min( { texel[0][1], texel[1][1], texel[2][1] } ) ) ), 0 );
+            const int endX = std::min( static_cast<int>( std::ceil( std::max( { texel[0][0], texel[1][0], texel[2][0] } ) ) ), chart.width );
+            const int endY = std::min( static_cast<int>( std::ceil( std::max( { texel[0][1], texel[1][1], texel[2][1] } ) ) ), chart.height );
+            for( int y = beginY; y < endY; y++ ){
+                const float py = y + 0.5f;
+                for( int x = beginX; x < endX; x++ ){
+                    const float px = x + 0.5f;
+                    float weights[3];
+                    for( int corner = 0; corner < 3; corner++ ){
+                        const float* a = texel[( corner + 1 ) % 3];
+                        const float* b = texel[( corner + 2 ) % 3];
+                        weights[corner] = ( ( b[0] - a[0] ) * ( py - a[1] ) - ( px - a[0] ) * ( b[1] - a[1] ) ) / area;
+                    }
+                    if( weights[0] < 0.0f || weights[1] < 0.0f || weights[2] < 0.0f ){
+                        continue;
+                    }
+
+                    // Surface Point and Normal
+                    float point[3];
+                    float surfaceNormal[3];
+                    for( int k = 0; k < 3; k++ ){
+                        point[k] = weights[0] * position[0][k] + weights[1] * position[1][k] + weights[2] * position[2][k];
+                        surfaceNormal[k] = weights[0] * normal[0][k] + weights[1] * normal[1][k] + weights[2] * normal[2][k];
+                    }
+                    const bool oriented = normalize( surfaceNormal );
+
+                    // Weighted Average of Keyframes that See Point
+                    float sum[3] = { 0.0f, 0.0f, 0.0f };
+                    float weight = 0.0f;
+                    for( const View* view : candidates ){
+                        float direction[3] = { view->center[0] - point[0], view->center[1] - point[1], view->center[2] - point[2] };
+                        normalize( direction );
+                        const float cosine = oriented ? dotNormalized( surfaceNormal, direction ) : 0.0f;
+                        if( cosine < parameters.minViewCosine ){
+                            continue;
+                        }
+                        float u, v;
+                        const float z = project( *view, point, u, v );
+                        const int nearestX = static_cast<int>( std::floor( u + 0.5f ) );
+                        const int nearestY = static_cast<int>( std::floor( v + 0.5f ) );
+                        if( !( z > 0.0f ) || nearestX < 0 || nearestY < 0 || nearestX >= view->keyframe->width || nearestY >= view->keyframe->height ){
+                            continue;
+                        }
+                        const float depth = view->keyframe->depth[nearestY * view->keyframe->width + nearestX];
+                        float sample[3];
+                        if( depth == 0.0f || std::fabs( depth - z ) > parameters.depthTolerance || !sampleColor( *view->keyframe, u, v, sample ) ){
+                            continue;
+                        }
+                        const float w = cosine * cosine;
+                        sum[0] += w * sample[0];
+                        sum[1] += w * sample[1];
+                        sum[2] += w * sample[2];
+                        weight += w;
+                    }
+
+                    const size_t index = static_cast<size_t>( y ) * chart.width + x;
+                    uint32_t& pixel = pixels[static_cast<size_t>( y ) * atlas.width + x];
+                    if( weight > 0.0f ){
+                        sum[0] /= weight;
+                        sum[1] /= weight;
+                        sum[2] /= weight;
+                        pixel = packColor( sum );
+                        projectedTexels[order[o]] += ( masks[index] == 0 );
+                    }
+                    else{
+                        pixel = interpolateColor( colors, weights );
+                    }
+                    texels[order[o]] += ( masks[index] == 0 );
+                    masks[index] = 1;
+                }
+            }
+        }
+
+        // Dilate into Gutter and Gaps between Texel Centers ( Average of 4 Neighbors Filled in Earlier Passes )
+        for( int pass = 0; pass < padding; pass++ ){
+            const uint8_t filled = static_cast<uint8_t>( std::min( pass + 2, 255 ) );
+            for( int y = 0; y < chart.height; y++ ){
+                for( int x = 0; x < chart.width; x++ ){
+                    const size_t index = static_cast<size_t>( y ) * chart.width + x;
+                    if( masks[index] != 0 ){
+                        continue;
+                    }
+                    const int neighbors[4][2] = { { x - 1, y }, { x + 1, y }, { x, y - 1 }, { x, y + 1 } };
+                    float sum[3] = { 0.0f, 0.0f, 0.0f };
+                    int count = 0;
+                    for( const int* neighbor : neighbors ){
+                        if( neighbor[0] < 0 || neighbor[1] < 0 || neighbor[0] >= chart.width || neighbor[1] >= chart.height ){
+                            continue;
+                        }
+                        const uint8_t mask = masks[static_cast<size_t>( neighbor[1] ) * chart.width + neighbor[0]];
+                        if( mask == 0 || mask >= filled ){
+                            continue;
+                        }
+                        const uint32_t value = pixels[static_cast<size_t>( neighbor[1] ) * atlas.width + neighbor[0]];
+                        for( int channel = 0; channel < 3; channel++ ){
+                            sum[channel] += ( value >> ( channel * 8 ) ) & 0xff;
+                        }
+                        count++;
+                    }
+                    if( count > 0 ){
+                        sum[0] /= count;
+                        sum[1] /= count;
+                        sum[2] /= count;
+                        pixels[static_cast<size_t>( y ) * atlas.width + x] = packColor( sum );
+                        masks[index] = filled;
+                    }
+                }
+            }
+        }
+    } );
+
+    // Normalize Texture Coordinates ( OBJ Origin is Bottom Left, Atlas Row 0 is Top )
+    ThreadPool::global().parallelFor( charts.size(), [&]( const size_t c ){
+        const Chart& chart = charts[c];
+        for( uint32_t i = chart.firstVertex; i < chart.firstVertex + chart.vertexCount; i++ ){
+            float* texcoord = &texturedMesh.texcoords[i * 2];
+            texcoord[0] = ( chart.x + texcoord[0] ) / atlas.width;
+            texcoord[1] = 1.0f - ( chart.y + texcoord[1] ) / atlas.height;
+        }
+    } );
+
+    for( size_t c = 0; c < charts.size(); c++ ){
+        statistics.texels += texels[c];
+        statistics.projectedTexels += projectedTexels[c];
+    }
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    statistics.chartMilliseconds = std::chrono::duration<double, std::milli>( charted - start ).count();
+    statistics.packMilliseconds = std::chrono::duration<double, std::milli>( packed - charted ).count();
+    statistics.bakeMilliseconds = std::chrono::duration<double, std::milli>( end - packed ).count();
+    statistics.totalMilliseconds = std::chrono::duration<double, std::milli>( end - start ).count();
+    statistics.millisecondsPerMillionTriangles = ( triangleCount > 0 ) ? statistics.totalMilliseconds * 1.0e6 / triangleCount : 0.0;
+}
\ No newline at end of file
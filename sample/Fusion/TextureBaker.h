@@ -0,0 +1,94 @@
+#ifndef __TEXTURE_BAKER__
+#define __TEXTURE_BAKER__
+
+#include <cstdint>
+#include <vector>
+
+#include "FusionMath.h"
+#include "MeshWriter.h"
+
+// Keyframe for Texture Baking ( Copy of Frame, so Frame Buffers can be Reused )
+struct TextureKeyframe
+{
+    std::vector<uint32_t> color; // BGRA Registered to Depth, 0 is Invalid ( NUI_FUSION_IMAGE_TYPE_COLOR )
+    std::vector<float> depth;    // Depth in Meters, 0 is Invalid ( NUI_FUSION_IMAGE_TYPE_FLOAT )
+    int width;
+    int height;
+    FusionCamera camera;
+    Matrix4f worldToCamera;
+};
+
+// Texture Baker Parameters
+struct TextureBakerParameters
+{
+    float texelsPerMeter;  // Texel Density ( Chart is Scaled Down if it does not Fit in Atlas Width )
+    int atlasWidth;        // Width of Atlas in Texels ( Height Grows with Charts )
+    int padding;           // Gutter around Each Chart in Texels ( Filled by Dilation against Bleeding of Bilinear Filtering and Mipmaps )
+    float depthTolerance;  // Maximum Difference between Keyframe Depth and Surface for Visibility ( Meters )
+    float minViewCosine;   // Minimum Cosine between Surface Normal and View Direction
+};
+
+// Default Parameters ( 2 mm Texels, Half Size of Voxels at 256 Voxels per Meter )
+inline TextureBakerParameters DefaultTextureBakerParameters()
+{
+    TextureBakerParameters parameters;
+    parameters.texelsPerMeter = 512.0f;
+    parameters.atlasWidth = 4096;
+    parameters.padding = 2;
+    parameters.depthTolerance = 0.02f;
+    parameters.minViewCosine = 0.2f;
+    return parameters;
+}
+
+// Texture Atlas ( BGRA, Row 0 is Top, e.g. for cv::Mat of CV_8UC4 )
+struct TextureAtlas
+{
+    std::vector<uint32_t> pixels;
+    int width;
+    int height;
+};
+
+// Statistics of Last Bake
+struct TextureBakeStatistics
+{
+    size_t triangles;
+    size_t charts;
+    size_t texels;                  // Texels Covered by Triangles
+    size_t projectedTexels;         // Texels Colored from Keyframes ( Others have Interpolated Vertex Color )
+    double chartMilliseconds;
+    double packMilliseconds;
+    double bakeMilliseconds;
+    double totalMilliseconds;
+    double millisecondsPerMillionTriangles;
+};
+
+// Texture Atlas Baker
+//
+// Charts the mesh by grouping connected triangles whose smoothed normal has the same dominant axis and direction ( 6 directions ),
+// so each chart is projected orthographically to its axis plane without flipped triangles. Vertices on chart boundaries are duplicated.
+// Charts are packed into atlas rows ( shelves ) in order of height, then each chart is rasterized in parallel on the thread pool.
+// A texel is the average of keyframe colors where the surface is visible ( keyframe depth matches within tolerance ), weighted by
+// squared cosine between surface normal and view direction ( dot_normalized of KinectFusionHelper ), colors are sampled bilinearly
+// from valid pixels ( bilinear_sample of KinectFusionHelper ). Texels that no keyframe sees keep the vertex color of mesh.
+// Charts own disjoint atlas rectangles, so charts are baked and dilated into their gutters without synchronization.
+class TextureBaker
+{
+private:
+    TextureBakerParameters parameters;
+    TextureBakeStatistics statistics;
+
+public:
+    // Constructor
+    TextureBaker( const TextureBakerParameters& parameters = DefaultTextureBakerParameters() );
+
+    // Bake Atlas from Keyframes ( Textured Mesh has Texture Coordinates, and Vertices Duplicated on Chart Boundaries )
+    void bake( const IndexedMesh& mesh, const std::vector<TextureKeyframe>& keyframes, IndexedMesh& texturedMesh, TextureAtlas& atlas );
+
+    // Retrieve Statistics of Last Bake
+    const TextureBakeStatistics& getStatistics() const { return statistics; }
+
+    // Retrieve Parameters
+    const TextureBakerParameters& getParameters() const { return parameters; }
+};
+
+#endif // __TEXTURE_BAKER__
\ No newline at end of file
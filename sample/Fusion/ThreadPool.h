@@ -0,0 +1,173 @@
+#ifndef __THREAD_POOL__
+#define __THREAD_POOL__
+
+#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread Pool for Data Parallel Loops ( Portable Replacement of Concurrency::parallel_for )
+// Workers are created once and sleep between loops, so a loop costs a wake-up instead of thread creation.
+// The calling thread takes part in the loop. A loop called from inside a loop runs serially on the calling thread.
+class ThreadPool
+{
+private:
+    std::vector<std::thread> threads;
+    std::mutex call;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void( size_t )>* task;
+    std::atomic<size_t> next;
+    size_t count;
+    size_t pending;
+    uint64_t generation;
+    bool quit;
+    std::exception_ptr exception;
+
+public:
+    // Constructor ( Number of Threads including Calling Thread, 0 = Hardware Concurrency )
+    explicit ThreadPool( size_t size = 0 )
+        : task( nullptr ), next( 0 ), count( 0 ), pending( 0 ), generation( 0 ), quit( false )
+    {
+        if( size == 0 ){
+            size = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+        }
+
+        for( size_t i = 1; i < size; i++ ){
+            threads.emplace_back( [this](){ worker(); } );
+        }
+    }
+
+    // Destructor
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            quit = true;
+        }
+        wake.notify_all();
+
+        for( std::thread& thread : threads ){
+            thread.join();
+        }
+    }
+
+    ThreadPool( const ThreadPool& ) = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+
+    // Retrieve Number of Threads including Calling Thread
+    size_t size() const
+    {
+        return threads.size() + 1;
+    }
+
+    // Call function( index ) for index in [0, count) on All Threads and Wait ( First Exception is Rethrown )
+    void parallelFor( const size_t count, const std::function<void( size_t )>& function )
+    {
+        if( count == 0 ){
+            return;
+        }
+
+        if( threads.empty() || count == 1 || inside() ){
+            for( size_t index = 0; index < count; index++ ){
+                function( index );
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> serialize( call );
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            task = &function;
+            next.store( 0 );
+            this->count = count;
+            pending = threads.size();
+            exception = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+
+        run( function, count );
+
+        std::unique_lock<std::mutex> lock( mutex );
+        done.wait( lock, [this](){ return pending == 0; } );
+        task = nullptr;
+
+        if( exception != nullptr ){
+            std::rethrow_exception( exception );
+        }
+    }
+
+    // Retrieve Shared Thread Pool ( Hardware Concurrency )
+    static ThreadPool& global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    // Check Calling Thread is Running a Loop
+    static bool& inside()
+    {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    // Run Indices until Loop is Exhausted
+    void run( const std::function<void( size_t )>& function, const size_t count )
+    {
+        inside() = true;
+        size_t index;
+        while( ( index = next.fetch_add( 1 ) ) < count ){
+            try{
+                function( index );
+            }
+            catch( ... ){
+                std::lock_guard<std::mutex> lock( mutex );
+                if( exception == nullptr ){
+                    exception = std::current_exception();
+                }
+                next.store( count );
+            }
+        }
+        inside() = false;
+    }
+
+    // Worker Thread
+    void worker()
+    {
+        uint64_t seen = 0;
+        while( true ){
+            const std::function<void( size_t )>* function;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock( mutex );
+                wake.wait( lock, [&](){ return quit || generation != seen; } );
+                if( quit ){
+                    return;
+                }
+                seen = generation;
+                function = task;
+                count = this->count;
+            }
+
+            run( *function, count );
+
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                pending--;
+            }
+            done.notify_one();
+        }
+    }
+};
+
+#endif // __THREAD_POOL__
\ No newline at end of file
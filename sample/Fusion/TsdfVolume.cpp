@@ -0,0 +1,341 @@
+#include "TsdfVolume.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // Camera Intrinsics in Pixels
+    struct Projection
+    {
+        float fx;
+        float fy;
+        float cx;
+        float cy;
+    };
+
+    Projection makeProjection( const TsdfFrame& frame )
+    {
+        Projection projection;
+        projection.fx = frame.camera.focalLengthX * frame.width;
+        projection.fy = frame.camera.focalLengthY * frame.height;
+        projection.cx = frame.camera.principalPointX * frame.width;
+        projection.cy = frame.camera.principalPointY * frame.height;
+        return projection;
+    }
+
+    // Blend Color by Running Average
+    inline uint32_t blendColor( const uint32_t current, const uint32_t sample, const uint32_t weight )
+    {
+        uint32_t result = 0;
+        for( int shift = 0; shift < 32; shift += 8 ){
+            const uint32_t a = ( current >> shift ) & 0xff;
+            const uint32_t b = ( sample >> shift ) & 0xff;
+            result |= ( ( a * weight + b ) / ( weight + 1 ) ) << shift;
+        }
+        return result;
+    }
+
+    // Integrate Row of 8 Voxels ( Scalar, Returns true if Distance Changed, modified is Set if any Voxel Changed )
+    // Camera coordinate of voxel i is base + i * step
+    bool integrateRow( const float* base, const float* step, const Projection& projection, const TsdfFrame& frame, const TsdfParameters& parameters,
+                       int16_t* tsdf, uint16_t* weight, uint32_t* color, bool& modified )
+    {
+        bool changed = false;
+        for( int i = 0; i < TsdfBrick::size; i++ ){
+            const float lane = static_cast<float>( i );
+            const float x = base[0] + lane * step[0];
+            const float y = base[1] + lane * step[1];
+            const float z = base[2] + lane * step[2];
+            if( !( z > 0.0f ) ){
+                continue;
+            }
+
+            // Project to Nearest Pixel
+            const float u = std::floor( ( x / z ) * projection.fx + projection.cx + 0.5f );
+            const float v = std::floor( ( y / z ) * projection.fy + projection.cy + 0.5f );
+            if( !( u >= 0.0f && u < frame.width && v >= 0.0f && v < frame.height ) ){
+                continue;
+            }
+            const int index = static_cast<int>( v ) * frame.width + static_cast<int>( u );
+
+            // Signed Distance along Z
+            const float depth = frame.depth[index];
+            const float distance = depth - z;
+            if( !( depth > 0.0f ) || !( distance >= -parameters.truncationDistance ) ){
+                continue;
+            }
+
+            // Running Average
+            const float sample = std::min( distance / parameters.truncationDistance, 1.0f );
+            const float w = static_cast<float>( weight[i] );
+            const float value = ( ( tsdf[i] / 32767.0f ) * w + sample ) / ( w + 1.0f );
+            const int16_t quantized = static_cast<int16_t>( std::lrint( value * 32767.0f ) );
+            changed |= ( quantized != tsdf[i] ) || ( weight[i] == 0 );
+
+            if( frame.color != nullptr && distance < parameters.truncationDistance ){
+                color[i] = blendColor( color[i], frame.color[index], weight[i] );
+                modified = true;
+            }
+            const uint16_t updated = static_cast<uint16_t>( std::min( w + 1.0f, static_cast<float>( parameters.maxWeight ) ) );
+            modified |= changed || ( updated != weight[i] );
+            tsdf[i] = quantized;
+            weight[i] = updated;
+        }
+        return changed;
+    }
+
+#ifdef SIMD_X86
+    // Integrate Row of 8 Voxels ( AVX2, Same Math as Scalar )
+    SIMD_TARGET_AVX2 bool integrateRowAVX2( const float* base, const float* step, const Projection& projection, const TsdfFrame& frame, const TsdfParameters& parameters,
+                                            int16_t* tsdf, uint16_t* weight, uint32_t* color, bool& modified )
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps( 1.0f );
+        const __m256 half = _mm256_set1_ps( 0.5f );
+        const __m256 scale = _mm256_set1_ps( 32767.0f );
+        const __m256 lanes = _mm256_setr_ps( 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f );
+        const __m256 truncation = _mm256_set1_ps( parameters.truncationDistance );
+
+        const __m256 x = _mm256_add_ps( _mm256_set1_ps( base[0] ), _mm256_mul_ps( lanes, _mm256_set1_ps( step[0] ) ) );
+        const __m256 y = _mm256_add_ps( _mm256_set1_ps( base[1] ), _mm256_mul_ps( lanes, _mm256_set1_ps( step[1] ) ) );
+        const __m256 z = _mm256_add_ps( _mm256_set1_ps( base[2] ), _mm256_mul_ps( lanes, _mm256_set1_ps( step[2] ) ) );
+
+        // Project to Nearest Pixel
+        const __m256 u = _mm256_floor_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_div_ps( x, z ), _mm256_set1_ps( projection.fx ) ), _mm256_set1_ps( projection.cx ) ), half ) );
+        const __m256 v = _mm256_floor_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_div_ps( y, z ), _mm256_set1_ps( projection.fy ) ), _mm256_set1_ps( projection.cy ) ), half ) );
+        __m256 inside = _mm256_cmp_ps( z, zero, _CMP_GT_OQ );
+        inside = _mm256_and_ps( inside, _mm256_cmp_ps( u, zero, _CMP_GE_OQ ) );
+        inside = _mm256_and_ps( inside, _mm256_cmp_ps( u, _mm256_set1_ps( static_cast<float>( frame.width ) ), _CMP_LT_OQ ) );
+        inside = _mm256_and_ps( inside, _mm256_cmp_ps( v, zero, _CMP_GE_OQ ) );
+        inside = _mm256_and_ps( inside, _mm256_cmp_ps( v, _mm256_set1_ps( static_cast<float>( frame.height ) ), _CMP_LT_OQ ) );
+        if( _mm256_movemask_ps( inside ) == 0 ){
+            return false;
+        }
+
+        // Gather Depth of Projected Pixels
+        const __m256i index = _mm256_add_epi32( _mm256_mullo_epi32( _mm256_cvttps_epi32( _mm256_and_ps( v, inside ) ), _mm256_set1_epi32( frame.width ) ), _mm256_cvttps_epi32( _mm256_and_ps( u, inside ) ) );
+        const __m256 depth = _mm256_mask_i32gather_ps( zero, frame.depth, index, inside, 4 );
+
+        // Signed Distance along Z
+        const __m256 distance = _mm256_sub_ps( depth, z );
+        __m256 valid = _mm256_and_ps( inside, _mm256_cmp_ps( depth, zero, _CMP_GT_OQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( distance, _mm256_sub_ps( zero, truncation ), _CMP_GE_OQ ) );
+        const int validMask = _mm256_movemask_ps( valid );
+        if( validMask == 0 ){
+            return false;
+        }
+
+        // Running Average
+        const __m128i tsdfOld16 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( tsdf ) );
+        const __m128i weightOld16 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( weight ) );
+        const __m256i tsdfOld = _mm256_cvtepi16_epi32( tsdfOld16 );
+        const __m256i weightOld = _mm256_cvtepu16_epi32( weightOld16 );
+        const __m256 w = _mm256_cvtepi32_ps( weightOld );
+        const __m256 sample = _mm256_min_ps( _mm256_div_ps( distance, truncation ), one );
+        const __m256 value = _mm256_div_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_div_ps( _mm256_cvtepi32_ps( tsdfOld ), scale ), w ), sample ), _mm256_add_ps( w, one ) );
+        const __m256i quantized = _mm256_cvtps_epi32( _mm256_mul_ps( value, scale ) );
+        const __m256i weightNew = _mm256_cvttps_epi32( _mm256_min_ps( _mm256_add_ps( w, one ), _mm256_set1_ps( static_cast<float>( parameters.maxWeight ) ) ) );
+
+        const __m256i validInteger = _mm256_castps_si256( valid );
+        const __m256i tsdfResult = _mm256_blendv_epi8( tsdfOld, quantized, validInteger );
+        const __m256i weightResult = _mm256_blendv_epi8( weightOld, weightNew, validInteger );
+
+        // Changed if Distance Changed or First Observation
+        const __m256i difference = _mm256_or_si256( _mm256_xor_si256( _mm256_cmpeq_epi32( tsdfResult, tsdfOld ), _mm256_set1_epi32( -1 ) ), _mm256_cmpeq_epi32( weightOld, _mm256_setzero_si256() ) );
+        const bool changed = ( _mm256_movemask_ps( _mm256_and_ps( _mm256_castsi256_ps( difference ), valid ) ) != 0 );
+        modified |= changed || ( _mm256_movemask_epi8( _mm256_cmpeq_epi32( weightResult, weightOld ) ) != -1 );
+
+        // Color of Voxels Near Surface ( Uses Weight before Update )
+        if( frame.color != nullptr ){
+            const int nearMask = validMask & _mm256_movemask_ps( _mm256_cmp_ps( distance, truncation, _CMP_LT_OQ ) );
+            if( nearMask != 0 ){
+                alignas( 32 ) int indices[8];
+                _mm256_store_si256( reinterpret_cast<__m256i*>( indices ), index );
+                for( int i = 0; i < TsdfBrick::size; i++ ){
+                    if( nearMask & ( 1 << i ) ){
+                        color[i] = blendColor( color[i], frame.color[indices[i]], weight[i] );
+                    }
+                }
+                modified = true;
+            }
+        }
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( tsdf ), _mm_packs_epi32( _mm256_castsi256_si128( tsdfResult ), _mm256_extracti128_si256( tsdfResult, 1 ) ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( weight ), _mm_packus_epi32( _mm256_castsi256_si128( weightResult ), _mm256_extracti128_si256( weightResult, 1 ) ) );
+
+        return changed;
+    }
+#endif
+}
+
+// Check Brick Overlaps Camera Frustum within Depth Range
+bool TsdfGrid::isBrickVisible( const int x, const int y, const int z, const TsdfFrame& frame, const TsdfParameters& parameters, const float* origin )
+{
+    const Projection projection = makeProjection( frame );
+    const float voxelSize = 1.0f / parameters.voxelsPerMeter;
+
+    float minU = static_cast<float>( frame.width );
+    float maxU = -1.0f;
+    float minV = static_cast<float>( frame.height );
+    float maxV = -1.0f;
+    float minZ = parameters.maxDepth;
+    for( int corner = 0; corner < 8; corner++ ){
+        const float vx = static_cast<float>( ( x + ( corner & 1 ) ) * TsdfBrick::size );
+        const float vy = static_cast<float>( ( y + ( ( corner >> 1 ) & 1 ) ) * TsdfBrick::size );
+        const float vz = static_cast<float>( ( z + ( ( corner >> 2 ) & 1 ) ) * TsdfBrick::size );
+        float point[3];
+        TransformPoint( frame.worldToCamera, ( vx - origin[0] ) * voxelSize, ( vy - origin[1] ) * voxelSize, ( vz - origin[2] ) * voxelSize, point );
+
+        // Corner behind Camera, Brick may Straddle Image Plane
+        if( point[2] <= 0.0f ){
+            return true;
+        }
+
+        const float u = ( point[0] / point[2] ) * projection.fx + projection.cx;
+        const float v = ( point[1] / point[2] ) * projection.fy + projection.cy;
+        minU = std::min( minU, u );
+        maxU = std::max( maxU, u );
+        minV = std::min( minV, v );
+        maxV = std::max( maxV, v );
+        minZ = std::min( minZ, point[2] );
+    }
+
+    if( maxU < -0.5f || minU >= frame.width - 0.5f || maxV < -0.5f || minV >= frame.height - 0.5f ){
+        return false;
+    }
+
+    // Beyond Maximum Depth plus Truncation
+    return minZ <= parameters.maxDepth + parameters.truncationDistance;
+}
+
+// Integrate Frame into Brick
+bool TsdfGrid::integrateBrick( TsdfBrick& brick, const int x, const int y, const int z, const TsdfFrame& frame, const TsdfParameters& parameters, const float* origin )
+{
+    const Projection projection = makeProjection( frame );
+    const float voxelSize = 1.0f / parameters.voxelsPerMeter;
+
+    // Camera Step per Voxel along X
+    float step[3];
+    RotateVector( frame.worldToCamera, voxelSize, 0.0f, 0.0f, step );
+
+#ifdef SIMD_X86
+    const bool avx2 = IsSupportedAVX2();
+#endif
+
+    bool changed = false;
+    bool modified = false;
+    for( int vz = 0; vz < TsdfBrick::size; vz++ ){
+        for( int vy = 0; vy < TsdfBrick::size; vy++ ){
+            // Camera Coordinate of First Voxel of Row
+            float base[3];
+            const float wx = ( x * TsdfBrick::size - origin[0] ) * voxelSize;
+            const float wy = ( y * TsdfBrick::size + vy - origin[1] ) * voxelSize;
+            const float wz = ( z * TsdfBrick::size + vz - origin[2] ) * voxelSize;
+            TransformPoint( frame.worldToCamera, wx, wy, wz, base );
+
+            const int offset = ( vz * TsdfBrick::size + vy ) * TsdfBrick::size;
+        #ifdef SIMD_X86
+            if( avx2 ){
+                changed |= integrateRowAVX2( base, step, projection, frame, parameters, &brick.tsdf[offset], &brick.weight[offset], &brick.color[offset], modified );
+                continue;
+            }
+        #endif
+            changed |= integrateRow( base, step, projection, frame, parameters, &brick.tsdf[offset], &brick.weight[offset], &brick.color[offset], modified );
+        }
+    }
+
+    if( changed ){
+        brick.version++;
+    }
+    if( modified ){
+        brick.revision++;
+    }
+    return changed;
+}
+
+// Constructor
+TsdfVolume::TsdfVolume( const int voxelCountX, const int voxelCountY, const int voxelCountZ, const TsdfParameters& parameters )
+{
+    if( voxelCountX <= 0 || voxelCountY <= 0 || voxelCountZ <= 0 || voxelCountX % TsdfBrick::size != 0 || voxelCountY % TsdfBrick::size != 0 || voxelCountZ % TsdfBrick::size != 0 ){
+        throw std::invalid_argument( "voxel count of volume must be positive multiple of 8" );
+    }
+    if( parameters.voxelsPerMeter <= 0.0f || parameters.truncationDistance <= 0.0f ){
+        throw std::invalid_argument( "invalid volume parameters" );
+    }
+
+    this->parameters = parameters;
+    brickCountX = voxelCountX / TsdfBrick::size;
+    brickCountY = voxelCountY / TsdfBrick::size;
+    brickCountZ = voxelCountZ / TsdfBrick::size;
+
+    // World Origin at Center of Front Face
+    origin[0] = voxelCountX * 0.5f;
+    origin[1] = voxelCountY * 0.5f;
+    origin[2] = 0.0f;
+
+    bricks.resize( static_cast<size_t>( brickCountX ) * brickCountY * brickCountZ );
+    for( TsdfBrick& brick : bricks ){
+        brick.version = 0;
+        brick.revision = 0;
+    }
+    reset();
+}
+
+// Integrate Depth and Color Frame ( Z Slabs in Parallel )
+void TsdfVolume::integrate( const TsdfFrame& frame )
+{
+    ThreadPool::global().parallelFor( brickCountZ, [&]( const size_t z ){
+        for( int y = 0; y < brickCountY; y++ ){
+            for( int x = 0; x < brickCountX; x++ ){
+                if( !isBrickVisible( x, y, static_cast<int>( z ), frame, parameters, origin ) ){
+                    continue;
+                }
+
+                TsdfBrick& brick = bricks[( z * brickCountY + y ) * brickCountX + x];
+                integrateBrick( brick, x, y, static_cast<int>( z ), frame, parameters, origin );
+            }
+        }
+    } );
+}
+
+// Reset All Voxels
+void TsdfVolume::reset()
+{
+    ThreadPool::global().parallelFor( brickCountZ, [&]( const size_t z ){
+        const size_t begin = z * brickCountY * brickCountX;
+        for( size_t i = begin; i < begin + brickCountY * brickCountX; i++ ){
+            bricks[i].clear();
+        }
+    } );
+}
+
+// Retrieve Brick
+const TsdfBrick* TsdfVolume::findBrick( const int x, const int y, const int z ) const
+{
+    if( x < 0 || y < 0 || z < 0 || x >= brickCountX || y >= brickCountY || z >= brickCountZ ){
+        return nullptr;
+    }
+    return &bricks[( static_cast<size_t>( z ) * brickCountY + y ) * brickCountX + x];
+}
+
+// Retrieve Brick to Write
+TsdfBrick* TsdfVolume::acquireBrick( const int x, const int y, const int z )
+{
+    return const_cast<TsdfBrick*>( findBrick( x, y, z ) );
+}
+
+// Call function for All Bricks
+void TsdfVolume::forEachBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const
+{
+    for( int z = 0; z < brickCountZ; z++ ){
+        for( int y = 0; y < brickCountY; y++ ){
+            for( int x = 0; x < brickCountX; x++ ){
+                function( x, y, z, bricks[( static_cast<size_t>( z ) * brickCountY + y ) * brickCountX + x] );
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef __TSDF_VOLUME__
+#define __TSDF_VOLUME__
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "FusionMath.h"
+
+// TSDF Brick ( 8 x 8 x 8 Voxels, x Fastest, Structure of Arrays )
+struct TsdfBrick
+{
+    static const int size = 8;
+    static const int voxelCount = size * size * size;
+
+    int16_t tsdf[voxelCount];    // Truncated Signed Distance ( -32767 - 32767 = -1.0 - 1.0 of Truncation Distance )
+    uint16_t weight[voxelCount]; // Integration Weight ( 0 = Never Observed )
+    uint32_t color[voxelCount];  // BGRA
+    uint32_t version;            // Incremented when Distance of any Voxel Changed
+    uint32_t revision;           // Incremented when any Voxel Changed ( Weight and Color can Change without Distance )
+
+    // Clear Voxels to Unobserved Free Space
+    void clear()
+    {
+        for( int i = 0; i < voxelCount; i++ ){
+            tsdf[i] = 32767;
+            weight[i] = 0;
+            color[i] = 0;
+        }
+        version++;
+        revision++;
+    }
+};
+
+// Integration Parameters
+struct TsdfParameters
+{
+    float voxelsPerMeter;     // Resolution ( 256 = 3.9 mm Voxel )
+    float truncationDistance; // Distance from Surface in Meters that is Stored
+    uint16_t maxWeight;       // Maximum Weight of Running Average ( Same Meaning as NUI_FUSION_DEFAULT_INTEGRATION_WEIGHT )
+    float minDepth;           // Valid Depth Range in Meters
+    float maxDepth;
+};
+
+// Default Integration Parameters ( Same Depth Range and Weight as Kinect Fusion Defaults )
+inline TsdfParameters DefaultTsdfParameters( const float voxelsPerMeter = 256.0f )
+{
+    TsdfParameters parameters;
+    parameters.voxelsPerMeter = voxelsPerMeter;
+    parameters.truncationDistance = 6.0f / voxelsPerMeter;
+    parameters.maxWeight = 200;
+    parameters.minDepth = 0.5f;
+    parameters.maxDepth = 8.0f;
+    return parameters;
+}
+
+// Frame to Integrate ( Depth Resolution )
+struct TsdfFrame
+{
+    const float* depth;    // Depth in Meters, 0 is Invalid ( NUI_FUSION_IMAGE_TYPE_FLOAT )
+    const uint32_t* color; // BGRA Registered to Depth, nullptr if no Color ( NUI_FUSION_IMAGE_TYPE_COLOR )
+    int width;
+    int height;
+    FusionCamera camera;
+    Matrix4f worldToCamera;
+};
+
+// Pack Brick Coordinates to Key ( 21 bits per Axis, -2^20 - 2^20 - 1 )
+inline uint64_t PackBrickKey( const int x, const int y, const int z )
+{
+    const uint64_t mask = ( 1ull << 21 ) - 1;
+    return ( static_cast<uint64_t>( ( x + ( 1 << 20 ) ) & mask ) << 42 )
+         | ( static_cast<uint64_t>( ( y + ( 1 << 20 ) ) & mask ) << 21 )
+         | ( static_cast<uint64_t>( ( z + ( 1 << 20 ) ) & mask ) );
+}
+
+// Unpack Key to Brick Coordinates
+inline void UnpackBrickKey( const uint64_t key, int& x, int& y, int& z )
+{
+    const uint64_t mask = ( 1ull << 21 ) - 1;
+    x = static_cast<int>( ( key >> 42 ) & mask ) - ( 1 << 20 );
+    y = static_cast<int>( ( key >> 21 ) & mask ) - ( 1 << 20 );
+    z = static_cast<int>( key & mask ) - ( 1 << 20 );
+}
+
+// TSDF Grid
+// Base of dense and sparse volumes. Bricks are addressed by brick coordinates,
+// voxel coordinate of a world point is world * voxelsPerMeter + origin, voxel ( x, y, z ) belongs to brick ( x / 8, y / 8, z / 8 ).
+class TsdfGrid
+{
+protected:
+    TsdfParameters parameters;
+    float origin[3];
+
+public:
+    // Destructor
+    virtual ~TsdfGrid()
+    {
+    }
+
+    // Integrate Depth and Color Frame
+    virtual void integrate( const TsdfFrame& frame ) = 0;
+
+    // Reset All Voxels
+    virtual void reset() = 0;
+
+    // Retrieve Brick ( nullptr if not Allocated )
+    virtual const TsdfBrick* findBrick( const int x, const int y, const int z ) const = 0;
+
+    // Retrieve Brick to Write ( Allocated if Necessary, nullptr if Outside Volume ), Increment Version of Brick after Writing
+    virtual TsdfBrick* acquireBrick( const int x, const int y, const int z ) = 0;
+
+    // Call function( x, y, z, brick ) for All Allocated Bricks
+    virtual void forEachBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const = 0;
+
+    // Call function( x, y, z, brick ) for Bricks in Memory ( Only these can Change by Integration )
+    virtual void forEachResidentBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const
+    {
+        forEachBrick( function );
+    }
+
+    // Retrieve Parameters
+    const TsdfParameters& getParameters() const
+    {
+        return parameters;
+    }
+
+    // Retrieve Voxel Coordinate of World Origin
+    const float* getOrigin() const
+    {
+        return origin;
+    }
+
+protected:
+    // Check Brick Overlaps Camera Frustum within Depth Range
+    static bool isBrickVisible( const int x, const int y, const int z, const TsdfFrame& frame, const TsdfParameters& parameters, const float* origin );
+
+    // Integrate Frame into Brick ( Returns true if Distance of any Voxel Changed )
+    static bool integrateBrick( TsdfBrick& brick, const int x, const int y, const int z, const TsdfFrame& frame, const TsdfParameters& parameters, const float* origin );
+};
+
+// Dense TSDF Volume ( Same Layout as Kinect Fusion Reconstruction )
+// All bricks are allocated, world origin is at center of front face ( Same as Default World to Volume Transform of Kinect Fusion ).
+// Integration runs Z slabs of bricks in parallel, and projects a row of 8 voxels at once with AVX2.
+class TsdfVolume : public TsdfGrid
+{
+private:
+    int brickCountX;
+    int brickCountY;
+    int brickCountZ;
+    std::vector<TsdfBrick> bricks;
+
+public:
+    // Constructor ( Voxel Counts must be Multiple of 8, e.g. 512 x 384 x 512 )
+    TsdfVolume( const int voxelCountX, const int voxelCountY, const int voxelCountZ, const TsdfParameters& parameters );
+
+    void integrate( const TsdfFrame& frame ) override;
+
+    void reset() override;
+
+    const TsdfBrick* findBrick( const int x, const int y, const int z ) const override;
+
+    TsdfBrick* acquireBrick( const int x, const int y, const int z ) override;
+
+    void forEachBrick( const std::function<void( int, int, int, const TsdfBrick& )>& function ) const override;
+
+    // Retrieve Voxel Counts
+    int getVoxelCountX() const { return brickCountX * TsdfBrick::size; }
+    int getVoxelCountY() const { return brickCountY * TsdfBrick::size; }
+    int getVoxelCountZ() const { return brickCountZ * TsdfBrick::size; }
+};
+
+#endif // __TSDF_VOLUME__
\ No newline at end of file
@@ -0,0 +1,830 @@
+#include "VolumeCheckpoint.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char fileMagic[8] = { 'K', '2', 'V', 'O', 'L', 0, 0, 0 };
+    const char footerMagic[8] = { 'K', '2', 'V', 'O', 'L', 'E', 'N', 'D' };
+    const uint32_t indexMagic = 0x4956324b; // 'K2VI'
+    const uint32_t version = 1;
+
+    // Brick Compression Modes
+    const uint8_t observedVoxels = 0;
+    const uint8_t allVoxels = 1;
+    const int maskBytes = TsdfBrick::voxelCount / 8;
+
+    inline void seekFile( FILE* file, const uint64_t offset )
+    {
+    #ifdef _WIN32
+        const int result = _fseeki64( file, static_cast<__int64>( offset ), SEEK_SET );
+    #else
+        const int result = fseeko( file, static_cast<off_t>( offset ), SEEK_SET );
+    #endif
+        if( result != 0 ){
+            throw std::runtime_error( "failed to seek volume checkpoint file" );
+        }
+    }
+
+    // Replace File by Renaming ( Atomic, Either Old or New File Remains if Interrupted )
+    inline bool replaceFile( const std::string& source, const std::string& destination )
+    {
+    #ifdef _WIN32
+        return MoveFileExA( source.c_str(), destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) != 0;
+    #else
+        return std::rename( source.c_str(), destination.c_str() ) == 0;
+    #endif
+    }
+
+    inline uint32_t zigzag( const int32_t value )
+    {
+        return ( static_cast<uint32_t>( value ) << 1 ) ^ static_cast<uint32_t>( value >> 31 );
+    }
+
+    inline int32_t unzigzag( const uint32_t value )
+    {
+        return static_cast<int32_t>( value >> 1 ) ^ -static_cast<int32_t>( value & 1 );
+    }
+
+    // Value Stream Writer ( Varints, Runs of Zeros are 0 Byte and Varint of Length - 1 )
+    class ValueWriter
+    {
+    private:
+        std::vector<uint8_t>& out;
+        uint32_t zeros;
+
+    public:
+        explicit ValueWriter( std::vector<uint8_t>& out )
+            : out( out ), zeros( 0 )
+        {
+        }
+
+        void put( const uint32_t value )
+        {
+            if( value == 0 ){
+                zeros++;
+                return;
+            }
+            flush();
+            putVarint( value );
+        }
+
+        void flush()
+        {
+            if( zeros == 0 ){
+                return;
+            }
+            out.push_back( 0 );
+            putVarint( zeros - 1 );
+            zeros = 0;
+        }
+
+    private:
+        // First Byte of Non-Zero Value is Non-Zero
+        void putVarint( uint32_t value )
+        {
+            while( value >= 0x80 ){
+                out.push_back( static_cast<uint8_t>( value | 0x80 ) );
+                value >>= 7;
+            }
+            out.push_back( static_cast<uint8_t>( value ) );
+        }
+    };
+
+    // Value Stream Reader
+    class ValueReader
+    {
+    private:
+        const uint8_t* in;
+        const uint8_t* end;
+        uint32_t zeros;
+
+    public:
+        ValueReader( const uint8_t* in, const uint8_t* end )
+            : in( in ), end( end ), zeros( 0 )
+        {
+        }
+
+        uint32_t get()
+        {
+            if( zeros != 0 ){
+                zeros--;
+                return 0;
+            }
+            const uint32_t value = getVarint();
+            if( value == 0 ){
+                zeros = getVarint();
+            }
+            return value;
+        }
+
+    private:
+        uint32_t getVarint()
+        {
+            uint32_t value = 0;
+            for( int shift = 0; shift < 35; shift += 7 ){
+                if( in == end ){
+                    throw std::runtime_error( "corrupted brick in volume checkpoint file" );
+                }
+                const uint8_t byte = *in++;
+                value |= static_cast<uint32_t>( byte & 0x7f ) << shift;
+                if( ( byte & 0x80 ) == 0 ){
+                    return value;
+                }
+            }
+            throw std::runtime_error( "corrupted brick in volume checkpoint file" );
+        }
+    };
+
+    // Compress Brick ( Voxels are Deltas from Previous Voxel of Same Mode )
+    void encodeBrick( const TsdfBrick& brick, std::vector<uint8_t>& out )
+    {
+        // Unobserved Voxels are Skipped if they have Default Values
+        uint8_t mode = observedVoxels;
+        for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+            if( brick.weight[i] == 0 && ( brick.tsdf[i] != 32767 || brick.color[i] != 0 ) ){
+                mode = allVoxels;
+                break;
+            }
+        }
+
+        out.clear();
+        out.push_back( mode );
+        ValueWriter writer( out );
+
+        int voxels[TsdfBrick::voxelCount];
+        int count = 0;
+        if( mode == observedVoxels ){
+            for( int i = 0; i < maskBytes; i++ ){
+                uint32_t mask = 0;
+                for( int bit = 0; bit < 8; bit++ ){
+                    if( brick.weight[i * 8 + bit] != 0 ){
+                        mask |= 1 << bit;
+                        voxels[count++] = i * 8 + bit;
+                    }
+                }
+                writer.put( mask );
+            }
+        }
+        else{
+            for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+                voxels[count++] = i;
+            }
+        }
+
+        int32_t previous = 0;
+        for( int i = 0; i < count; i++ ){
+            writer.put( zigzag( brick.tsdf[voxels[i]] - previous ) );
+            previous = brick.tsdf[voxels[i]];
+        }
+        previous = 0;
+        for( int i = 0; i < count; i++ ){
+            writer.put( zigzag( brick.weight[voxels[i]] - previous ) );
+            previous = brick.weight[voxels[i]];
+        }
+        for( int shift = 0; shift < 32; shift += 8 ){
+            uint8_t last = 0;
+            for( int i = 0; i < count; i++ ){
+                const uint8_t channel = static_cast<uint8_t>( brick.color[voxels[i]] >> shift );
+                writer.put( zigzag( static_cast<int8_t>( channel - last ) ) );
+                last = channel;
+            }
+        }
+        writer.flush();
+    }
+
+    // Decompress Brick ( Version and Revision are not Modified )
+    void decodeBrick( const uint8_t* in, const uint32_t bytes, TsdfBrick& brick )
+    {
+        if( bytes == 0 || ( in[0] != observedVoxels && in[0] != allVoxels ) ){
+            throw std::runtime_error( "corrupted brick in volume checkpoint file" );
+        }
+        ValueReader reader( in + 1, in + bytes );
+
+        int voxels[TsdfBrick::voxelCount];
+        int count = 0;
+        if( in[0] == observedVoxels ){
+            for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+                brick.tsdf[i] = 32767;
+                brick.weight[i] = 0;
+                brick.color[i] = 0;
+            }
+            for( int i = 0; i < maskBytes; i++ ){
+                const uint32_t mask = reader.get();
+                for( int bit = 0; bit < 8; bit++ ){
+                    if( mask & ( 1 << bit ) ){
+                        voxels[count++] = i * 8 + bit;
+                    }
+                }
+            }
+        }
+        else{
+            for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+                voxels[count++] = i;
+            }
+        }
+
+        // Wrap Around instead of Overflow on Corrupted Deltas
+        uint32_t previous = 0;
+        for( int i = 0; i < count; i++ ){
+            previous += static_cast<uint32_t>( unzigzag( reader.get() ) );
+            brick.tsdf[voxels[i]] = static_cast<int16_t>( previous );
+        }
+        previous = 0;
+        for( int i = 0; i < count; i++ ){
+            previous += static_cast<uint32_t>( unzigzag( reader.get() ) );
+            brick.weight[voxels[i]] = static_cast<uint16_t>( previous );
+        }
+        for( int i = 0; i < count; i++ ){
+            brick.color[voxels[i]] = 0;
+        }
+        for( int shift = 0; shift < 32; shift += 8 ){
+            uint8_t last = 0;
+            for( int i = 0; i < count; i++ ){
+                last = static_cast<uint8_t>( last + static_cast<uint32_t>( unzigzag( reader.get() ) ) );
+                brick.color[voxels[i]] |= static_cast<uint32_t>( last ) << shift;
+            }
+        }
+    }
+
+    // Elapsed Milliseconds
+    inline double elapsed( const std::chrono::steady_clock::time_point& start )
+    {
+        return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    }
+}
+
+// Constructor
+VolumeCheckpointWriter::VolumeCheckpointWriter( const std::string& path )
+    : path( path ), file( nullptr ), fileSize( 0 ), sequence( 0 ), liveBytes( 0 ), pending( false ), quit( false ), statistics()
+{
+    thread = std::thread( [this](){ worker(); } );
+}
+
+// Destructor
+VolumeCheckpointWriter::~VolumeCheckpointWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        quit = true;
+    }
+    wake.notify_all();
+    thread.join();
+
+    if( file != nullptr ){
+        fclose( file );
+    }
+}
+
+// Capture Changed Bricks and Write them in Background
+bool VolumeCheckpointWriter::checkpoint( const TsdfGrid& grid, const Matrix4f& worldToCamera )
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( exception ){
+            std::exception_ptr error = exception;
+            exception = nullptr;
+            discard();
+            std::rethrow_exception( error );
+        }
+        if( pending ){
+            statistics.skipped++;
+            return false;
+        }
+    }
+
+    // Copy Bricks whose Revision Changed ( Stall of Integration Thread )
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    capturing.keys.clear();
+    capturing.bricks.clear();
+    grid.forEachBrick( [&]( const int x, const int y, const int z, const TsdfBrick& brick ){
+        const uint64_t key = PackBrickKey( x, y, z );
+        std::unordered_map<uint64_t, uint32_t>::iterator found = revisions.find( key );
+        if( found != revisions.end() && found->second == brick.revision ){
+            return;
+        }
+
+        // Unobserved Bricks are Remembered to Skip them by Revision Next Time
+        revisions[key] = brick.revision;
+        bool observed = false;
+        for( int i = 0; i < TsdfBrick::voxelCount && !observed; i++ ){
+            observed = ( brick.weight[i] != 0 );
+        }
+        if( !observed ){
+            return;
+        }
+
+        capturing.keys.push_back( key );
+        capturing.bricks.push_back( brick );
+    } );
+
+    // Volume Information
+    VolumeIndexHeader& header = capturing.header;
+    const TsdfParameters& parameters = grid.getParameters();
+    header.magic = indexMagic;
+    header.reserved = 0;
+    header.voxelsPerMeter = parameters.voxelsPerMeter;
+    header.truncationDistance = parameters.truncationDistance;
+    header.minDepth = parameters.minDepth;
+    header.maxDepth = parameters.maxDepth;
+    header.maxWeight = parameters.maxWeight;
+    const TsdfVolume* dense = dynamic_cast<const TsdfVolume*>( &grid );
+    header.voxelCount[0] = dense ? dense->getVoxelCountX() : 0;
+    header.voxelCount[1] = dense ? dense->getVoxelCountY() : 0;
+    header.voxelCount[2] = dense ? dense->getVoxelCountZ() : 0;
+    for( int axis = 0; axis < 3; axis++ ){
+        header.origin[axis] = grid.getOrigin()[axis];
+    }
+    header.worldToCamera = worldToCamera;
+    const double stall = elapsed( start );
+
+    // Hand Over to Background Thread
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        std::swap( capturing, writing );
+        pending = true;
+        statistics.stallMilliseconds = stall;
+        statistics.maxStallMilliseconds = ( std::max )( statistics.maxStallMilliseconds, stall );
+    }
+    wake.notify_one();
+    return true;
+}
+
+// Wait until Checkpoint being Written is Completed
+void VolumeCheckpointWriter::wait()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    done.wait( lock, [this](){ return !pending; } );
+    if( exception ){
+        std::exception_ptr error = exception;
+        exception = nullptr;
+        discard();
+        std::rethrow_exception( error );
+    }
+}
+
+// Close File
+void VolumeCheckpointWriter::reset()
+{
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        done.wait( lock, [this](){ return !pending; } );
+        exception = nullptr;
+    }
+    discard();
+}
+
+// Close File and Forget Written Bricks ( Background Thread is Idle )
+void VolumeCheckpointWriter::discard()
+{
+    if( file != nullptr ){
+        fclose( file );
+        file = nullptr;
+    }
+    fileSize = 0;
+    sequence = 0;
+    liveBytes = 0;
+    index.clear();
+    revisions.clear();
+}
+
+// Retrieve Statistics
+VolumeCheckpointStatistics VolumeCheckpointWriter::getStatistics()
+{
+    std::lock_guard<std::mutex> lock( mutex );
+    return statistics;
+}
+
+// Background Thread
+void VolumeCheckpointWriter::worker()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while( true ){
+        wake.wait( lock, [this](){ return pending || quit; } );
+        if( !pending ){
+            return;
+        }
+
+        lock.unlock();
+        std::exception_ptr error;
+        try{
+            write( writing );
+        }
+        catch( ... ){
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if( error ){
+            exception = error;
+        }
+        pending = false;
+        done.notify_all();
+    }
+}
+
+// Compress and Append Snapshot
+void VolumeCheckpointWriter::write( const Snapshot& snapshot )
+{
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Create File
+    if( file == nullptr ){
+        file = fopen( path.c_str(), "w+b" );
+        if( file == nullptr ){
+            throw std::runtime_error( "failed to open volume checkpoint file ( " + path + " )" );
+        }
+        fileSize = 0;
+        sequence = 0;
+        liveBytes = 0;
+        index.clear();
+
+        VolumeFileHeader header = {};
+        std::memcpy( header.magic, fileMagic, sizeof( fileMagic ) );
+        header.version = version;
+        append( &header, sizeof( header ) );
+    }
+    const uint64_t begin = fileSize;
+    seekFile( file, fileSize );
+
+    // Append Bricks
+    for( size_t i = 0; i < snapshot.keys.size(); i++ ){
+        encodeBrick( snapshot.bricks[i], encoded );
+
+        VolumeIndexEntry& entry = index[snapshot.keys[i]];
+        liveBytes -= entry.bytes; // Zero for New Brick
+        entry.key = snapshot.keys[i];
+        entry.offset = fileSize;
+        entry.bytes = static_cast<uint32_t>( encoded.size() );
+        entry.version = snapshot.bricks[i].version;
+        liveBytes += entry.bytes;
+        append( encoded.data(), encoded.size() );
+    }
+
+    // Append Index
+    sequence++;
+    writeIndex( snapshot.header );
+    if( fflush( file ) != 0 ){
+        throw std::runtime_error( "failed to flush volume checkpoint file" );
+    }
+    const uint64_t written = fileSize - begin;
+
+    // Compact if Garbage Exceeds Live Bricks and Index
+    const uint64_t indexBytes = sizeof( VolumeIndexHeader ) + index.size() * sizeof( VolumeIndexEntry ) + sizeof( VolumeFileFooter );
+    const uint64_t used = sizeof( VolumeFileHeader ) + liveBytes + indexBytes;
+    const bool compacted = ( fileSize - used > used );
+    if( compacted ){
+        compact( snapshot.header );
+    }
+    const double milliseconds = elapsed( start );
+
+    std::lock_guard<std::mutex> lock( mutex );
+    statistics.checkpoints++;
+    statistics.compactions += compacted ? 1 : 0;
+    statistics.bricks = snapshot.keys.size();
+    statistics.rawBytes = snapshot.keys.size() * ( sizeof( TsdfBrick::tsdf ) + sizeof( TsdfBrick::weight ) + sizeof( TsdfBrick::color ) );
+    statistics.writtenBytes = written;
+    statistics.writeMilliseconds = milliseconds;
+    statistics.megabytesPerSecond = ( milliseconds > 0.0 ) ? written / ( milliseconds * 1000.0 ) : 0.0;
+    statistics.fileBytes = fileSize;
+    statistics.liveBytes = liveBytes;
+}
+
+// Append Index of All Bricks and Footer
+void VolumeCheckpointWriter::writeIndex( VolumeIndexHeader header )
+{
+    entries.clear();
+    entries.reserve( index.size() );
+    for( const std::pair<const uint64_t, VolumeIndexEntry>& entry : index ){
+        entries.push_back( entry.second );
+    }
+    std::sort( entries.begin(), entries.end(), []( const VolumeIndexEntry& a, const VolumeIndexEntry& b ){
+        return a.key < b.key;
+    } );
+
+    VolumeFileFooter footer;
+    footer.indexOffset = fileSize;
+    std::memcpy( footer.magic, footerMagic, sizeof( footerMagic ) );
+
+    header.sequence = sequence;
+    header.entries = entries.size();
+    append( &header, sizeof( header ) );
+    if( !entries.empty() ){
+        append( entries.data(), entries.size() * sizeof( VolumeIndexEntry ) );
+    }
+    append( &footer, sizeof( footer ) );
+}
+
+// Rewrite File with Live Bricks and Index
+void VolumeCheckpointWriter::compact( const VolumeIndexHeader& header )
+{
+    // Copy Live Bricks to Temporary File
+    const std::string temporary = path + ".tmp";
+    FILE* source = file;
+    file = fopen( temporary.c_str(), "w+b" );
+    if( file == nullptr ){
+        file = source;
+        throw std::runtime_error( "failed to open volume checkpoint file ( " + temporary + " )" );
+    }
+    fileSize = 0;
+
+    try{
+        VolumeFileHeader fileHeader = {};
+        std::memcpy( fileHeader.magic, fileMagic, sizeof( fileMagic ) );
+        fileHeader.version = version;
+        append( &fileHeader, sizeof( fileHeader ) );
+
+        for( std::pair<const uint64_t, VolumeIndexEntry>& entry : index ){
+            encoded.resize( entry.second.bytes );
+            seekFile( source, entry.second.offset );
+            if( fread( encoded.data(), 1, encoded.size(), source ) != encoded.size() ){
+                throw std::runtime_error( "failed to read volume checkpoint file" );
+            }
+            seekFile( file, fileSize );
+            entry.second.offset = fileSize;
+            append( encoded.data(), encoded.size() );
+        }
+        writeIndex( header );
+    }
+    catch( ... ){
+        fclose( file );
+        std::remove( temporary.c_str() );
+        file = nullptr;
+        fclose( source );
+        throw;
+    }
+    fclose( source );
+    if( fclose( file ) != 0 ){
+        file = nullptr;
+        throw std::runtime_error( "failed to write volume checkpoint file ( " + temporary + " )" );
+    }
+
+    // Replace File ( Previous File Remains until Rename, Temporary File Remains if Interrupted )
+    if( !replaceFile( temporary, path ) ){
+        file = nullptr;
+        throw std::runtime_error( "failed to rename volume checkpoint file ( " + temporary + " )" );
+    }
+    file = fopen( path.c_str(), "r+b" );
+    if( file == nullptr ){
+        throw std::runtime_error( "failed to open volume checkpoint file ( " + path + " )" );
+    }
+}
+
+// Write Bytes at End of File
+void VolumeCheckpointWriter::append( const void* data, const size_t bytes )
+{
+    if( fwrite( data, 1, bytes, file ) != bytes ){
+        throw std::runtime_error( "failed to write volume checkpoint file ( " + path + " )" );
+    }
+    fileSize += bytes;
+}
+
+// Constructor
+VolumeCheckpointReader::VolumeCheckpointReader()
+    : memory( nullptr ), length( 0 )
+#ifdef _WIN32
+    , fileHandle( nullptr ), mappingHandle( nullptr )
+#else
+    , fileDescriptor( -1 )
+#endif
+    , header( nullptr ), entries( nullptr )
+{
+}
+
+// Destructor
+VolumeCheckpointReader::~VolumeCheckpointReader()
+{
+    // Close File
+    close();
+}
+
+// Open File
+void VolumeCheckpointReader::open( const std::string& path )
+{
+    close();
+
+    // Map File
+    map( path );
+
+    // Check File Header
+    if( length < sizeof( VolumeFileHeader ) ){
+        close();
+        throw std::runtime_error( "invalid volume checkpoint file " + path );
+    }
+
+    const VolumeFileHeader* fileHeader = reinterpret_cast<const VolumeFileHeader*>( memory );
+    if( std::memcmp( fileHeader->magic, fileMagic, sizeof( fileMagic ) ) != 0 || fileHeader->version != version ){
+        close();
+        throw std::runtime_error( "invalid volume checkpoint file " + path );
+    }
+
+    // Find Index of Last Complete Checkpoint
+    if( !findIndex() ){
+        close();
+        throw std::runtime_error( "no complete checkpoint in volume checkpoint file " + path );
+    }
+}
+
+// Close File
+void VolumeCheckpointReader::close()
+{
+    header = nullptr;
+    entries = nullptr;
+
+    unmap();
+}
+
+// Check Open
+bool VolumeCheckpointReader::isOpen() const
+{
+    return memory != nullptr;
+}
+
+// Retrieve Parameters
+TsdfParameters VolumeCheckpointReader::getParameters() const
+{
+    TsdfParameters parameters;
+    parameters.voxelsPerMeter = header->voxelsPerMeter;
+    parameters.truncationDistance = header->truncationDistance;
+    parameters.maxWeight = static_cast<uint16_t>( header->maxWeight );
+    parameters.minDepth = header->minDepth;
+    parameters.maxDepth = header->maxDepth;
+    return parameters;
+}
+
+// Decode Brick
+void VolumeCheckpointReader::loadBrick( const size_t i, int& x, int& y, int& z, TsdfBrick& brick ) const
+{
+    const VolumeIndexEntry& entry = entries[i];
+    UnpackBrickKey( entry.key, x, y, z );
+    decodeBrick( memory + entry.offset, entry.bytes, brick );
+}
+
+// Load All Bricks into Grid
+void VolumeCheckpointReader::load( TsdfGrid& grid ) const
+{
+    if( !isOpen() ){
+        throw std::runtime_error( "volume checkpoint file is not open" );
+    }
+
+    // Check Brick Coordinates Address Same Voxels
+    const TsdfParameters& parameters = grid.getParameters();
+    const float* origin = grid.getOrigin();
+    if( parameters.voxelsPerMeter != header->voxelsPerMeter || parameters.truncationDistance != header->truncationDistance
+     || origin[0] != header->origin[0] || origin[1] != header->origin[1] || origin[2] != header->origin[2] ){
+        throw std::invalid_argument( "resolution or origin of volume does not match volume checkpoint" );
+    }
+
+    // Allocate Bricks ( Serial, Volume is not Thread Safe )
+    const size_t count = size();
+    std::vector<TsdfBrick*> bricks( count );
+    for( size_t i = 0; i < count; i++ ){
+        int x, y, z;
+        UnpackBrickKey( entries[i].key, x, y, z );
+        bricks[i] = grid.acquireBrick( x, y, z );
+        if( bricks[i] == nullptr ){
+            throw std::runtime_error( "brick of volume checkpoint is outside volume" );
+        }
+    }
+
+    // Decode Bricks in Parallel
+    ThreadPool::global().parallelFor( count, [&]( const size_t i ){
+        TsdfBrick& brick = *bricks[i];
+        decodeBrick( memory + entries[i].offset, entries[i].bytes, brick );
+        brick.version++;
+        brick.revision++;
+    } );
+}
+
+// Map File
+void VolumeCheckpointReader::map( const std::string& path )
+{
+#ifdef _WIN32
+    fileHandle = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    if( fileHandle == INVALID_HANDLE_VALUE ){
+        fileHandle = nullptr;
+        throw std::runtime_error( "failed open volume checkpoint file " + path );
+    }
+
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( fileHandle, &size ) || size.QuadPart == 0 ){
+        unmap();
+        throw std::runtime_error( "failed retrieve size of volume checkpoint file " + path );
+    }
+    length = static_cast<uint64_t>( size.QuadPart );
+
+    mappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( mappingHandle == nullptr ){
+        unmap();
+        throw std::runtime_error( "failed map volume checkpoint file " + path );
+    }
+
+    memory = static_cast<const unsigned char*>( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+    if( memory == nullptr ){
+        unmap();
+        throw std::runtime_error( "failed map volume checkpoint file " + path );
+    }
+#else
+    fileDescriptor = ::open( path.c_str(), O_RDONLY );
+    if( fileDescriptor < 0 ){
+        throw std::runtime_error( "failed open volume checkpoint file " + path );
+    }
+
+    struct stat status;
+    if( fstat( fileDescriptor, &status ) != 0 || status.st_size == 0 ){
+        unmap();
+        throw std::runtime_error( "failed retrieve size of volume checkpoint file " + path );
+    }
+    length = static_cast<uint64_t>( status.st_size );
+
+    void* address = mmap( nullptr, static_cast<size_t>( length ), PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+    if( address == MAP_FAILED ){
+        unmap();
+        throw std::runtime_error( "failed map volume checkpoint file " + path );
+    }
+    memory = static_cast<const unsigned char*>( address );
+#endif
+}
+
+// Unmap File
+void VolumeCheckpointReader::unmap()
+{
+#ifdef _WIN32
+    if( memory != nullptr ){
+        UnmapViewOfFile( memory );
+    }
+    if( mappingHandle != nullptr ){
+        CloseHandle( mappingHandle );
+        mappingHandle = nullptr;
+    }
+    if( fileHandle != nullptr ){
+        CloseHandle( fileHandle );
+        fileHandle = nullptr;
+    }
+#else
+    if( memory != nullptr ){
+        munmap( const_cast<unsigned char*>( memory ), static_cast<size_t>( length ) );
+    }
+    if( fileDescriptor >= 0 ){
+        ::close( fileDescriptor );
+        fileDescriptor = -1;
+    }
+#endif
+    memory = nullptr;
+    length = 0;
+}
+
+// Find Index of Last Complete Checkpoint ( Trailing Footer, or Last Valid Footer if Checkpoint was Interrupted )
+bool VolumeCheckpointReader::findIndex()
+{
+    const uint64_t first = sizeof( VolumeFileHeader ) + sizeof( VolumeIndexHeader );
+    if( length < first + sizeof( VolumeFileFooter ) ){
+        return false;
+    }
+
+    for( uint64_t position = length - sizeof( VolumeFileFooter ); position >= first; position-- ){
+        const VolumeFileFooter* footer = reinterpret_cast<const VolumeFileFooter*>( memory + position );
+        if( std::memcmp( footer->magic, footerMagic, sizeof( footerMagic ) ) != 0 ){
+            continue;
+        }
+
+        // Check Index Fills Space before Footer, and Bricks Precede Index
+        const uint64_t offset = footer->indexOffset;
+        if( offset < sizeof( VolumeFileHeader ) || position < offset + sizeof( VolumeIndexHeader ) ){
+            continue;
+        }
+        const VolumeIndexHeader* candidate = reinterpret_cast<const VolumeIndexHeader*>( memory + offset );
+        const uint64_t indexBytes = position - offset - sizeof( VolumeIndexHeader );
+        if( candidate->magic != indexMagic || indexBytes % sizeof( VolumeIndexEntry ) != 0 || candidate->entries != indexBytes / sizeof( VolumeIndexEntry ) ){
+            continue;
+        }
+        const VolumeIndexEntry* candidateEntries = reinterpret_cast<const VolumeIndexEntry*>( memory + offset + sizeof( VolumeIndexHeader ) );
+        bool valid = true;
+        for( uint64_t i = 0; i < candidate->entries && valid; i++ ){
+            valid = candidateEntries[i].offset >= sizeof( VolumeFileHeader ) && candidateEntries[i].bytes != 0
+                 && candidateEntries[i].offset + candidateEntries[i].bytes <= offset;
+        }
+        if( !valid ){
+            continue;
+        }
+
+        header = candidate;
+        entries = candidateEntries;
+        return true;
+    }
+    return false;
+}
\ No newline at end of file
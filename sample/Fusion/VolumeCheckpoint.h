@@ -0,0 +1,243 @@
+#ifndef __VOLUME_CHECKPOINT__
+#define __VOLUME_CHECKPOINT__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "TsdfVolume.h"
+
+// Volume Checkpoint File ( .k2vol )
+//
+// File Layout
+//   VolumeFileHeader ( 64 bytes )
+//   Checkpoint ( Compressed Bricks Changed since Previous Checkpoint + VolumeIndexHeader + VolumeIndexEntry x N + VolumeFileFooter ) x M
+//
+// Each checkpoint appends bricks whose revision changed since previous checkpoint, then the index of all bricks ( sorted by key ),
+// so the last footer describes the whole volume, and a checkpoint interrupted by crash leaves the previous one readable.
+// Bricks superseded by later checkpoints are garbage, the file is compacted when garbage exceeds live bricks.
+// Unobserved bricks ( all weights are 0 ) are not stored.
+//
+// Brick Compression
+//   Mode ( 1 byte, 0 = Observed Voxels Only, 1 = All Voxels ), then a stream of unsigned values, each is a varint,
+//   or a 0 byte followed by a varint of run length - 1 of zeros. Values are observed mask ( 64 bytes, mode 0 only ),
+//   then zigzag deltas of tsdf, weight, and of each color channel ( 8 bits ) from previous voxel in x fastest order.
+
+#pragma pack( push, 1 )
+// File Header
+struct VolumeFileHeader
+{
+    char magic[8];         // "K2VOL\0\0\0"
+    uint32_t version;
+    uint32_t reserved0;
+    uint8_t reserved1[48];
+};
+
+// Index Header
+struct VolumeIndexHeader
+{
+    uint32_t magic;        // 'K2VI'
+    uint32_t reserved;
+    uint64_t sequence;     // Number of Checkpoint in File
+    uint64_t entries;
+    float voxelsPerMeter;
+    float truncationDistance;
+    float minDepth;
+    float maxDepth;
+    uint32_t maxWeight;
+    int32_t voxelCount[3]; // Size of Dense Volume ( TsdfVolume ), 0 for Sparse Volume
+    float origin[3];
+    Matrix4f worldToCamera;// Camera Pose at Checkpoint ( for Resuming Tracking )
+};
+
+// Index Entry
+struct VolumeIndexEntry
+{
+    uint64_t key;          // PackBrickKey
+    uint64_t offset;       // Offset of Compressed Brick
+    uint32_t bytes;
+    uint32_t version;      // Version of Brick at Checkpoint
+};
+
+// File Footer
+struct VolumeFileFooter
+{
+    uint64_t indexOffset;
+    char magic[8];         // "K2VOLEND"
+};
+#pragma pack( pop )
+
+// Checkpoint Statistics
+struct VolumeCheckpointStatistics
+{
+    uint64_t checkpoints;        // Written Checkpoints
+    uint64_t skipped;            // Checkpoints Skipped because Previous one was still being Written
+    uint64_t compactions;
+    size_t bricks;               // Bricks of Last Checkpoint
+    uint64_t rawBytes;           // Uncompressed Size of Bricks of Last Checkpoint ( tsdf, weight, color )
+    uint64_t writtenBytes;       // Bytes Written by Last Checkpoint ( Bricks, Index and Footer )
+    double stallMilliseconds;    // Time of Last Capture on Calling ( Integration ) Thread
+    double maxStallMilliseconds;
+    double writeMilliseconds;    // Time of Last Compression and Write on Background Thread
+    double megabytesPerSecond;   // Written Bytes / Write Time of Last Checkpoint
+    uint64_t fileBytes;
+    uint64_t liveBytes;          // Bytes of Bricks Referred by Last Index
+};
+
+// Volume Checkpoint Writer
+//
+// checkpoint() runs on the integration thread, it copies bricks whose revision changed since previous checkpoint ( the stall ),
+// then a background thread compresses and appends them with a new index, so integration continues while writing.
+// Only one checkpoint is written at a time, checkpoint() returns false without capturing while previous one is being written.
+// The background thread runs serially ( not on the thread pool ), so it does not contend with integration.
+// Errors of background thread are rethrown by next checkpoint() or wait(), then the file is rewritten by the following checkpoint.
+class VolumeCheckpointWriter
+{
+private:
+    // Captured Bricks
+    struct Snapshot
+    {
+        std::vector<uint64_t> keys;
+        std::vector<TsdfBrick> bricks;
+        VolumeIndexHeader header;
+    };
+
+    std::string path;
+
+    // Integration Thread
+    std::unordered_map<uint64_t, uint32_t> revisions;
+    Snapshot capturing;
+
+    // Background Thread
+    Snapshot writing;
+    FILE* file;
+    uint64_t fileSize;
+    uint64_t sequence;
+    uint64_t liveBytes;
+    std::unordered_map<uint64_t, VolumeIndexEntry> index;
+    std::vector<uint8_t> encoded;
+    std::vector<VolumeIndexEntry> entries;
+
+    // Synchronization
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool pending;
+    bool quit;
+    std::exception_ptr exception;
+    VolumeCheckpointStatistics statistics;
+
+public:
+    // Constructor ( File is Created by First Checkpoint )
+    explicit VolumeCheckpointWriter( const std::string& path = "volume.k2vol" );
+
+    // Destructor ( Waits for Checkpoint being Written )
+    ~VolumeCheckpointWriter();
+
+    VolumeCheckpointWriter( const VolumeCheckpointWriter& ) = delete;
+    VolumeCheckpointWriter& operator=( const VolumeCheckpointWriter& ) = delete;
+
+    // Capture Bricks Changed since Previous Checkpoint and Write them in Background ( Returns false if Skipped )
+    bool checkpoint( const TsdfGrid& grid, const Matrix4f& worldToCamera );
+
+    // Wait until Checkpoint being Written is Completed
+    void wait();
+
+    // Close File after Waiting ( Errors are Discarded ), Next Checkpoint Rewrites File with All Bricks ( Call when Volume is Reset or Replaced )
+    void reset();
+
+    // Retrieve Statistics
+    VolumeCheckpointStatistics getStatistics();
+
+    // Retrieve Path
+    const std::string& getPath() const { return path; }
+
+private:
+    // Background Thread
+    void worker();
+
+    // Compress and Append Snapshot
+    void write( const Snapshot& snapshot );
+
+    // Close File and Forget Written Bricks
+    void discard();
+
+    // Append Index of All Bricks and Footer
+    void writeIndex( VolumeIndexHeader header );
+
+    // Rewrite File with Live Bricks and Index
+    void compact( const VolumeIndexHeader& header );
+
+    // Write Bytes at End of File
+    void append( const void* data, const size_t bytes );
+};
+
+// Volume Checkpoint Reader ( Memory-Mapped )
+class VolumeCheckpointReader
+{
+private:
+    const unsigned char* memory;
+    uint64_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    const VolumeIndexHeader* header;
+    const VolumeIndexEntry* entries;
+
+public:
+    // Constructor
+    VolumeCheckpointReader();
+
+    // Destructor
+    ~VolumeCheckpointReader();
+
+    VolumeCheckpointReader( const VolumeCheckpointReader& ) = delete;
+    VolumeCheckpointReader& operator=( const VolumeCheckpointReader& ) = delete;
+
+    // Open File ( Last Complete Checkpoint is Used )
+    void open( const std::string& path );
+
+    // Close File
+    void close();
+
+    // Check Open
+    bool isOpen() const;
+
+    // Retrieve Volume Information of Checkpoint
+    TsdfParameters getParameters() const;
+    const VolumeIndexHeader& getHeader() const { return *header; }
+    bool isDense() const { return header->voxelCount[0] > 0; }
+
+    // Retrieve Number of Bricks
+    size_t size() const { return static_cast<size_t>( header->entries ); }
+
+    // Decode Brick ( Version and Revision are not Modified )
+    void loadBrick( const size_t i, int& x, int& y, int& z, TsdfBrick& brick ) const;
+
+    // Load All Bricks into Grid in Parallel ( Grid should be Reset, and have Same Resolution and Origin )
+    // Bricks of sparse volume stay resident until next integration streams them out.
+    void load( TsdfGrid& grid ) const;
+
+private:
+    // Map File
+    void map( const std::string& path );
+
+    // Unmap File
+    void unmap();
+
+    // Find Index of Last Complete Checkpoint
+    bool findIndex();
+};
+
+#endif // __VOLUME_CHECKPOINT__
\ No newline at end of file
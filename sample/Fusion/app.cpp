@@ -3,12 +3,54 @@
 
 #include <thread>
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
 
 #include <ppl.h>
 #include <atlbase.h>
 
+// Use CPU TSDF Volume instead of Kinect Fusion ( NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE_AMP )
+//#define CPU_FUSION
+
+// Use Sparse ( Voxel Hashing ) Volume for CPU TSDF Volume, Unbounded instead of 512 x 384 x 512 Voxels
+//#define SPARSE_VOLUME
+
+// Convert Matrix4 of Kinect Fusion to Matrix4f ( Same Layout )
+static inline Matrix4f toMatrix4f( const Matrix4& matrix )
+{
+    static_assert( sizeof( Matrix4f ) == sizeof( Matrix4 ), "layout of Matrix4f must be same as Matrix4" );
+    Matrix4f result;
+    std::memcpy( &result, &matrix, sizeof( Matrix4f ) );
+    return result;
+}
+
+// Convert Matrix4f to Matrix4 of Kinect Fusion ( Same Layout )
+static inline Matrix4 toMatrix4( const Matrix4f& matrix )
+{
+    Matrix4 result;
+    std::memcpy( &result, &matrix, sizeof( Matrix4 ) );
+    return result;
+}
+
+// Convert Camera Parameters of Kinect Fusion to FusionCamera
+static inline FusionCamera toFusionCamera( const NUI_FUSION_CAMERA_PARAMETERS& parameters )
+{
+    FusionCamera camera;
+    camera.focalLengthX = parameters.focalLengthX;
+    camera.focalLengthY = parameters.focalLengthY;
+    camera.principalPointX = parameters.principalPointX;
+    camera.principalPointY = parameters.principalPointY;
+    return camera;
+}
+
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : checkpoints( "../volume.k2vol" ),
+      sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -24,31 +66,29 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-        else if( key == 'r' ){
-            std::cout << "Reset Reconstruction" << std::endl;
-            reset();
-        }
-        else if( key == 's' ){
-            std::cout << "Save Mesh Data to File" << std::endl;
-            save();
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){
+            const bool running = sink->poll();
+            const int key = sink->key();
+            if( key == 'r' || key == 's' || key == 'i' || key == 'l' ){
+                // Request Command to Draw Stage ( Reconstruction is Used by Draw Stage )
+                command = key;
+            }
+            return running && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames );
         }
-    }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -106,8 +146,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Depth
@@ -125,8 +168,28 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameDescription->get_Height( &depthHeight ) ); // 424
     ERROR_CHECK( depthFrameDescription->get_BytesPerPixel( &depthBytesPerPixel ) ); // 2
 
-    // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    // Allocation Depth Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.depthUpdated = false;
+    } );
+}
+
+// Initialize Registration
+inline void Kinect::initializeRegistration()
+{
+    // Retrieve Mapped Coordinates at Two Constant Depths
+    const UINT16 nearDepth = 500; // [mm]
+    const UINT16 farDepth = 4500; // [mm]
+    std::vector<UINT16> nearDepthBuffer( depthWidth * depthHeight, nearDepth );
+    std::vector<UINT16> farDepthBuffer( depthWidth * depthHeight, farDepth );
+    std::vector<ColorSpacePoint> nearPoints( depthWidth * depthHeight );
+    std::vector<ColorSpacePoint> farPoints( depthWidth * depthHeight );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( nearDepthBuffer.size(), &nearDepthBuffer[0], nearPoints.size(), &nearPoints[0] ) );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( farDepthBuffer.size(), &farDepthBuffer[0], farPoints.size(), &farPoints[0] ) );
+
+    // Build Calibration Tables
+    registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, &nearPoints[0], nearDepth, &farPoints[0], farDepth );
 }
 
 // Initialize Fusion
@@ -140,7 +203,13 @@ inline void Kinect::initializeFusion()
 
     // Create Reconstruction
     SetIdentityMatrix( worldToCameraTransform );
+#if defined( CPU_FUSION ) && defined( SPARSE_VOLUME )
+    volume.reset( new HashedTsdfVolume( DefaultTsdfParameters( reconstructionParameters.voxelsPerMeter ) ) );
+#elif defined( CPU_FUSION )
+    volume.reset( new TsdfVolume( reconstructionParameters.voxelCountX, reconstructionParameters.voxelCountY, reconstructionParameters.voxelCountZ, DefaultTsdfParameters( reconstructionParameters.voxelsPerMeter ) ) );
+#else
     ERROR_CHECK( NuiFusionCreateColorReconstruction( &reconstructionParameters, NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE::NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE_AMP, -1, &worldToCameraTransform, &reconstruction ) );
+#endif
 
     // Set Camera Parameters
     cameraParameters.focalLengthX = NUI_KINECT_DEPTH_NORM_FOCAL_LENGTH_X;
@@ -155,6 +224,25 @@ inline void Kinect::initializeFusion()
     ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_POINT_CLOUD, depthWidth, depthHeight, &cameraParameters, &pointCloudImageFrame ) );
     ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_COLOR, depthWidth, depthHeight, &cameraParameters, &surfaceImageFrame ) );
     /*ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_COLOR, depthWidth, depthHeight, &cameraParameters, &normalImageFrame ) );*/
+
+#ifdef CPU_FUSION
+    // Create Tracking Pyramid ( Factor 2, 4 ) and Residual Frame Buffers
+    for( int level = 1; level < IcpTracker::levelCount; level++ ){
+        ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_FLOAT, depthWidth >> level, depthHeight >> level, &cameraParameters, &depthPyramidImageFrames[level - 1] ) );
+        ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_POINT_CLOUD, depthWidth >> level, depthHeight >> level, &cameraParameters, &pointCloudPyramidImageFrames[level - 1] ) );
+
+        // Depth is Area Averaged within Surface ( Less Noise and Aliasing ), Point Cloud Keeps Nearest Points ( Normals are not Averaged across Edges )
+        depthPyramidResamplers[level - 1].reset( new Resampler( depthWidth, depthHeight, depthWidth >> level, depthHeight >> level, ResampleFilter_Box ) );
+        pointCloudPyramidResamplers[level - 1].reset( new Resampler( depthWidth, depthHeight, depthWidth >> level, depthHeight >> level, ResampleFilter_Nearest ) );
+    }
+    ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_FLOAT, depthWidth, depthHeight, &cameraParameters, &deltaFromReferenceImageFrame ) );
+    ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_COLOR, depthWidth, depthHeight, &cameraParameters, &shadedDeltaFromReferenceImageFrame ) );
+    residualStatistics = DeltaFromReferenceImageStatistics();
+    trackingReference = false;
+    trackingErrorCount = 0;
+    integratedFrameCount = 0;
+    trackingLost = false;
+#endif
 }
 
 // Finalize
@@ -169,6 +257,14 @@ void Kinect::finalize()
     ERROR_CHECK( NuiFusionReleaseImageFrame( pointCloudImageFrame ) );
     ERROR_CHECK( NuiFusionReleaseImageFrame( surfaceImageFrame ) );
     /*ERROR_CHECK( NuiFusionReleaseImageFrame( normalImageFrame ) );*/
+#ifdef CPU_FUSION
+    for( int level = 1; level < IcpTracker::levelCount; level++ ){
+        ERROR_CHECK( NuiFusionReleaseImageFrame( depthPyramidImageFrames[level - 1] ) );
+        ERROR_CHECK( NuiFusionReleaseImageFrame( pointCloudPyramidImageFrames[level - 1] ) );
+    }
+    ERROR_CHECK( NuiFusionReleaseImageFrame( deltaFromReferenceImageFrame ) );
+    ERROR_CHECK( NuiFusionReleaseImageFrame( shadedDeltaFromReferenceImageFrame ) );
+#endif
 
     // Close Sensor
     if( kinect != nullptr ){
@@ -177,20 +273,26 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Depth
-    updateDepth();
+    updateDepth( frame );
 
-    // Update Fusion
-    updateFusion();
+    // Wait until Both Color and Depth are Updated
+    if( !frame.colorUpdated || !frame.depthUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.depthUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -200,11 +302,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Depth
-inline void Kinect::updateDepth()
+inline void Kinect::updateDepth( Frame& frame )
 {
     // Retrieve Depth Frame
     ComPtr<IDepthFrame> depthFrame;
@@ -214,40 +317,96 @@ inline void Kinect::updateDepth()
     }
 
     // Retrieve Depth Data
-    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( frame.depthBuffer.size() ), &frame.depthBuffer[0] ) );
+    frame.depthUpdated = true;
 }
 
-// Update Fusion
-inline void Kinect::updateFusion()
+// Update Fusion ( Called from Draw Stage )
+inline void Kinect::updateFusion( Frame& frame )
 {
+    const std::vector<BYTE>& colorBuffer = frame.colorBuffer;
+    const std::vector<UINT16>& depthBuffer = frame.depthBuffer;
+
+#ifdef CPU_FUSION
+    // Set Depth Data to Depth Float Frame Buffer ( Millimeters -> Meters, Out of Range is Invalid )
+    float* depthFloat = reinterpret_cast<float*>( depthImageFrame->pFrameBuffer->pBits );
+    for( size_t i = 0; i < depthBuffer.size(); i++ ){
+        const float depth = depthBuffer[i] * 0.001f;
+        depthFloat[i] = ( NUI_FUSION_DEFAULT_MINIMUM_DEPTH <= depth && depth <= NUI_FUSION_DEFAULT_MAXIMUM_DEPTH ) ? depth : 0.0f;
+    }
+#else
     // Set Depth Data to Depth Float Frame Buffer
     ERROR_CHECK( reconstruction->DepthToDepthFloatFrame( &depthBuffer[0], static_cast<UINT>( depthBuffer.size() * depthBytesPerPixel ), depthImageFrame, NUI_FUSION_DEFAULT_MINIMUM_DEPTH/* 0.5[m] */, NUI_FUSION_DEFAULT_MAXIMUM_DEPTH/* 8.0[m] */, true ) );
 
     // Smoothing Depth Float Frame
     ERROR_CHECK( reconstruction->SmoothDepthFloatFrame( depthImageFrame, smoothDepthImageFrame, NUI_FUSION_DEFAULT_SMOOTHING_KERNEL_WIDTH, NUI_FUSION_DEFAULT_SMOOTHING_DISTANCE_THRESHOLD ) );
+#endif
 
-    // Retrieve Mapped Coordinates
-    std::vector<ColorSpacePoint> points( depthWidth * depthHeight );
-    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( depthWidth * depthHeight, &depthBuffer[0], depthWidth * depthHeight, &points[0] ) );
+    // Initialize Registration after Coordinate Mapper Received Calibration from Sensor
+    if( !registration.isInitialized() ){
+        initializeRegistration();
+        if( !registration.isInitialized() ){
+            return;
+        }
+    }
 
     // Mapping Color to Depth Resolution and Set Color Data to Color Frame Buffer
     NUI_FUSION_BUFFER* colorImageFrameBuffer = colorImageFrame->pFrameBuffer;
-    RGBQUAD* src = reinterpret_cast<RGBQUAD*>( &colorBuffer[0] );
-    RGBQUAD* dst = reinterpret_cast<RGBQUAD*>( colorImageFrameBuffer->pBits );
-    Concurrency::parallel_for( 0, depthHeight, [&]( const int y ){
-        for( int x = 0; x < depthWidth; x++ ){
-            unsigned int index = y * depthWidth + x;
-            const ColorSpacePoint point = points[index];
-            int colorX = static_cast<int>( point.X + 0.5f );
-            int colorY = static_cast<int>( point.Y + 0.5f );
-            if( ( 0 <= colorX ) && ( colorX < colorWidth ) && ( 0 <= colorY ) && ( colorY < colorHeight ) ){
-                dst[index] = src[colorY * colorWidth + colorX];
-            }
-            else{
-                dst[index] = {};
-            }
+    registration.registerColor( &depthBuffer[0], &colorBuffer[0], colorImageFrameBuffer->pBits );
+
+#ifdef CPU_FUSION
+    // Track Camera against Surface Raycast at Previous Pose ( Frame is not Integrated if Tracking Failed )
+    if( trackingReference && !trackCamera() ){
+        // Reset Reconstruction when Tracking Failed Many Frames in a Row ( Over 100 Frames )
+        if( ++trackingErrorCount >= 100 ){
+            trackingErrorCount = 0;
+
+            // Keep Volume before Reset as Checkpoint of Lost Tracking ( Resumed by 'l' Key )
+            checkpoints.wait();
+            checkpoints.checkpoint( *volume, toMatrix4f( worldToCameraTransform ) );
+            checkpoints.wait();
+            checkpoints.reset();
+            MoveFileExA( checkpoints.getPath().c_str(), "../volume_lost.k2vol", MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH );
+            trackingLost = true;
+            std::cout << "Tracking Lost, Volume is Saved to Checkpoint ( Press 'l' to Resume )" << std::endl;
+
+            reset();
         }
-    } );
+        return;
+    }
+    trackingErrorCount = 0;
+
+    // Integrate Depth and Color into Volume at Tracked Pose
+    TsdfFrame tsdfFrame;
+    tsdfFrame.depth = reinterpret_cast<const float*>( depthImageFrame->pFrameBuffer->pBits );
+    tsdfFrame.color = reinterpret_cast<const uint32_t*>( colorImageFrameBuffer->pBits );
+    tsdfFrame.width = depthWidth;
+    tsdfFrame.height = depthHeight;
+    tsdfFrame.camera = toFusionCamera( cameraParameters );
+    tsdfFrame.worldToCamera = toMatrix4f( worldToCameraTransform );
+    volume->integrate( tsdfFrame );
+
+    // Raycast Surface from Volume
+    raycaster.update( *volume );
+    RaycastFrame raycastFrame;
+    raycastFrame.pointCloud = reinterpret_cast<float*>( pointCloudImageFrame->pFrameBuffer->pBits );
+    raycastFrame.shaded = reinterpret_cast<uint32_t*>( surfaceImageFrame->pFrameBuffer->pBits );
+    raycastFrame.width = depthWidth;
+    raycastFrame.height = depthHeight;
+    raycastFrame.camera = tsdfFrame.camera;
+    raycastFrame.worldToCamera = tsdfFrame.worldToCamera;
+    raycaster.raycast( raycastFrame );
+    trackingReference = true;
+
+    // Capture Keyframe for Re-integration and Texture Baking
+    captureKeyframe( depthBuffer );
+
+    // Write Checkpoint of Volume in Background ( Every 300 Integrated Frames )
+    if( ++integratedFrameCount % 300 == 0 ){
+        checkpoint();
+    }
+    return;
+#endif
 
     // Retrieve Transformation Matrix to Camera Coordinate System from World Coordinate System
     ERROR_CHECK( reconstruction->GetCurrentWorldToCameraTransform( &worldToCameraTransform ) );
@@ -282,29 +441,252 @@ inline void Kinect::updateFusion()
     */
 }
 
+// Track Camera
+inline bool Kinect::trackCamera()
+{
+    // Build Pyramid of Depth and Reference Point Cloud ( Factor 2, 4 )
+    for( int level = 1; level < IcpTracker::levelCount; level++ ){
+        const NUI_FUSION_BUFFER* depthImageFrameBuffer = depthImageFrame->pFrameBuffer;
+        const NUI_FUSION_BUFFER* depthPyramidImageFrameBuffer = depthPyramidImageFrames[level - 1]->pFrameBuffer;
+        depthPyramidResamplers[level - 1]->resampleDepth( reinterpret_cast<const float*>( depthImageFrameBuffer->pBits ), depthImageFrameBuffer->Pitch, reinterpret_cast<float*>( depthPyramidImageFrameBuffer->pBits ), depthPyramidImageFrameBuffer->Pitch );
+
+        const NUI_FUSION_BUFFER* pointCloudImageFrameBuffer = pointCloudImageFrame->pFrameBuffer;
+        const NUI_FUSION_BUFFER* pointCloudPyramidImageFrameBuffer = pointCloudPyramidImageFrames[level - 1]->pFrameBuffer;
+        pointCloudPyramidResamplers[level - 1]->resampleFloat( reinterpret_cast<const float*>( pointCloudImageFrameBuffer->pBits ), pointCloudImageFrameBuffer->Pitch, reinterpret_cast<float*>( pointCloudPyramidImageFrameBuffer->pBits ), pointCloudPyramidImageFrameBuffer->Pitch, 6 );
+    }
+
+    // Align Depth to Point Cloud Raycast at Previous Pose
+    IcpFrame frame;
+    frame.depth[0] = reinterpret_cast<const float*>( depthImageFrame->pFrameBuffer->pBits );
+    frame.reference[0] = reinterpret_cast<const float*>( pointCloudImageFrame->pFrameBuffer->pBits );
+    for( int level = 1; level < IcpTracker::levelCount; level++ ){
+        frame.depth[level] = reinterpret_cast<const float*>( depthPyramidImageFrames[level - 1]->pFrameBuffer->pBits );
+        frame.reference[level] = reinterpret_cast<const float*>( pointCloudPyramidImageFrames[level - 1]->pFrameBuffer->pBits );
+    }
+    frame.residual = reinterpret_cast<float*>( deltaFromReferenceImageFrame->pFrameBuffer->pBits );
+    frame.width = depthWidth;
+    frame.height = depthHeight;
+    frame.camera = toFusionCamera( cameraParameters );
+    frame.referenceWorldToCamera = toMatrix4f( worldToCameraTransform );
+    Matrix4f worldToCamera = frame.referenceWorldToCamera;
+    const bool tracked = tracker.track( frame, worldToCamera );
+
+    // Residual Statistics and Shaded Residual ( Residual Frame is Written only if Full Resolution Level was Reached )
+    residualStatistics = DeltaFromReferenceImageStatistics();
+    if( tracker.getStatistics( 0 ).iterations > 0 ){
+        ERROR_CHECK( ColorResidualsAndCalculateStatistics( deltaFromReferenceImageFrame, shadedDeltaFromReferenceImageFrame, &residualStatistics ) );
+    }
+
+    // Validate Camera Pose ( Reject Jump between Frames )
+    const float maxTranslation = 0.3f; // [m]
+    const float maxRotation = 20.0f; // [degree]
+    const Matrix4 transform = toMatrix4( worldToCamera );
+    if( !tracked || CameraTransformFailed( worldToCameraTransform, transform, maxTranslation, maxRotation ) ){
+        return false;
+    }
+    worldToCameraTransform = transform;
+    return true;
+}
+
+// Capture Keyframe for Re-integration and Texture Baking
+inline void Kinect::captureKeyframe( const std::vector<UINT16>& depthBuffer )
+{
+    // Take Keyframe when Camera Moved or Rotated from Last Keyframe ( Over 10 cm or 10 Degrees )
+    const float minTranslation = 0.1f; // [m]
+    const float minRotation = 10.0f; // [degree]
+    if( !keyframes.empty() && !CameraTransformChanged( toMatrix4( keyframes.getInfo( keyframes.size() - 1 ).worldToCamera ), worldToCameraTransform, minTranslation, minRotation ) ){
+        return;
+    }
+
+    // Store Compressed Depth ( Millimeters as Captured ) and Registered Color at Integrated Pose
+    const uint32_t* color = reinterpret_cast<const uint32_t*>( colorImageFrame->pFrameBuffer->pBits );
+    keyframes.add( &depthBuffer[0], color, depthWidth, depthHeight, toFusionCamera( cameraParameters ), toMatrix4f( worldToCameraTransform ) );
+}
+
+// Re-integrate Keyframes
+inline void Kinect::reintegrate()
+{
+#ifdef CPU_FUSION
+    // Reset Volume and Integrate Keyframes at Stored Poses
+    volume->reset();
+    extractor.reset();
+    raycaster.reset();
+    TextureKeyframe keyframe;
+    for( size_t i = 0; i < keyframes.size(); i++ ){
+        keyframes.load( i, NUI_FUSION_DEFAULT_MINIMUM_DEPTH, NUI_FUSION_DEFAULT_MAXIMUM_DEPTH, keyframe );
+        TsdfFrame frame;
+        frame.depth = &keyframe.depth[0];
+        frame.color = &keyframe.color[0];
+        frame.width = keyframe.width;
+        frame.height = keyframe.height;
+        frame.camera = keyframe.camera;
+        frame.worldToCamera = keyframe.worldToCamera;
+        volume->integrate( frame );
+    }
+
+    // Next Checkpoint Rewrites All Bricks of Re-integrated Volume
+    checkpoints.reset();
+
+    // Raycast Surface at Current Pose as Tracking Reference
+    raycastReference();
+    trackingReference = !keyframes.empty();
+
+    std::cout << "Re-integrated Keyframes : " << keyframes.size() << " ( " << keyframes.getResidentKeyframes() << " in Memory, " << keyframes.getSpilledKeyframes() << " Spilled, "
+              << keyframes.getCompressedBytes() / 1024 << " / " << keyframes.getRawBytes() / 1024 << " KB Compressed )" << std::endl;
+#endif
+}
+
+// Write Checkpoint of Volume in Background
+inline void Kinect::checkpoint()
+{
+#ifdef CPU_FUSION
+    // Skipped while Previous Checkpoint is being Written
+    if( !checkpoints.checkpoint( *volume, toMatrix4f( worldToCameraTransform ) ) ){
+        return;
+    }
+
+    // Stall of this Checkpoint, and Bandwidth of Previous Checkpoint ( Written in Background )
+    const VolumeCheckpointStatistics statistics = checkpoints.getStatistics();
+    std::cout << "Checkpoint : " << std::fixed << std::setprecision( 1 ) << statistics.stallMilliseconds << " ms Stall ( Max " << statistics.maxStallMilliseconds << " ms ), Previous "
+              << statistics.bricks << " Bricks " << statistics.writtenBytes / 1024 << " / " << statistics.rawBytes / 1024 << " KB Compressed in " << statistics.writeMilliseconds << " ms ( "
+              << statistics.megabytesPerSecond << " MB/s ), File " << statistics.fileBytes / 1024 << " KB" << std::endl;
+#endif
+}
+
+// Resume Volume from Checkpoint
+inline void Kinect::resume()
+{
+#ifdef CPU_FUSION
+    // Checkpoint of Lost Tracking, or Latest Checkpoint of Current Volume ( Writer Closes File before Reader Opens it )
+    const std::string path = trackingLost ? "../volume_lost.k2vol" : checkpoints.getPath();
+    checkpoints.reset();
+    VolumeCheckpointReader reader;
+    try{
+        reader.open( path );
+    }
+    catch( const std::exception& ex ){
+        std::cout << ex.what() << std::endl;
+        return;
+    }
+
+    // Replace Volume, and Resume Tracking from Pose at Checkpoint
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    volume->reset();
+    extractor.reset();
+    raycaster.reset();
+    keyframes.clear();
+    reader.load( *volume );
+    const double milliseconds = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+    worldToCameraTransform = toMatrix4( reader.getHeader().worldToCamera );
+    raycastReference();
+    trackingReference = reader.size() > 0;
+    trackingErrorCount = 0;
+    trackingLost = false;
+
+    std::cout << "Resumed Volume : " << reader.size() << " Bricks from " << path << " in " << std::fixed << std::setprecision( 1 ) << milliseconds << " ms" << std::endl;
+#endif
+}
+
+// Raycast Surface at Current Pose as Tracking Reference
+inline void Kinect::raycastReference()
+{
+#ifdef CPU_FUSION
+    raycaster.update( *volume );
+    RaycastFrame raycastFrame;
+    raycastFrame.pointCloud = reinterpret_cast<float*>( pointCloudImageFrame->pFrameBuffer->pBits );
+    raycastFrame.shaded = reinterpret_cast<uint32_t*>( surfaceImageFrame->pFrameBuffer->pBits );
+    raycastFrame.width = depthWidth;
+    raycastFrame.height = depthHeight;
+    raycastFrame.camera = toFusionCamera( cameraParameters );
+    raycastFrame.worldToCamera = toMatrix4f( worldToCameraTransform );
+    raycaster.raycast( raycastFrame );
+#endif
+}
+
 // Reset Reconstruction
 inline void Kinect::reset()
 {
     // Set Identity Matrix
     SetIdentityMatrix( worldToCameraTransform );
 
+#ifdef CPU_FUSION
+    // Reset Volume
+    volume->reset();
+    extractor.reset();
+    raycaster.reset();
+    trackingReference = false;
+    keyframes.clear();
+    checkpoints.reset();
+    integratedFrameCount = 0;
+#else
     // Reset Reconstruction
     ERROR_CHECK( reconstruction->ResetReconstruction( &worldToCameraTransform, nullptr ) );
+#endif
+}
+
+// Execute Command Requested by Key Check
+inline void Kinect::executeCommand()
+{
+    const int key = command.exchange( 0 );
+    if( key == 'r' ){
+        std::cout << "Reset Reconstruction" << std::endl;
+        reset();
+    }
+    else if( key == 's' ){
+        std::cout << "Save Mesh Data to File" << std::endl;
+        save();
+    }
+    else if( key == 'i' ){
+        std::cout << "Re-integrate Keyframes" << std::endl;
+        reintegrate();
+    }
+    else if( key == 'l' ){
+        std::cout << "Resume Volume from Checkpoint" << std::endl;
+        resume();
+    }
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
+    // Execute Command Requested by Key Check
+    executeCommand();
+
+    // Update Fusion
+    updateFusion( frame );
+
     // Draw Fusion
-    drawFusion();
+    drawFusion( frame );
 }
 
 // Draw Fusion
-inline void Kinect::drawFusion()
+inline void Kinect::drawFusion( Frame& frame )
 {
-    // Retrive Surface Image from Surface Frame Buffer
+    // Retrive Surface Image from Surface Frame Buffer ( Copied to Frame, Surface Frame Buffer is Overwritten by Next Frame )
     NUI_FUSION_BUFFER* surfaceImageFrameBuffer = surfaceImageFrame->pFrameBuffer;
-    surfaceMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, surfaceImageFrameBuffer->pBits );
+    cv::Mat& surfaceMat = frame.surfaceMat;
+    cv::Mat( depthHeight, depthWidth, CV_8UC4, surfaceImageFrameBuffer->pBits ).copyTo( surfaceMat );
+
+#ifdef CPU_FUSION
+    // Draw Tracking Statistics of Each Level and Residual ( Average Normalized Distance of Correspondences )
+    int offset = 15;
+    for( int level = IcpTracker::levelCount - 1; level >= 0; level-- ){
+        const IcpStatistics& statistics = tracker.getStatistics( level );
+        std::ostringstream oss;
+        oss << "Level " << level << " : " << statistics.iterations << " it " << std::fixed << std::setprecision( 1 ) << statistics.milliseconds << " ms "
+            << statistics.correspondences << " / " << statistics.validPixels << " px RMS " << statistics.error * 1000.0f << " mm";
+        cv::putText( surfaceMat, oss.str(), cv::Point( 5, offset ), cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar( 255, 255, 255 ), 1, cv::LINE_AA );
+        offset += 15;
+    }
+    std::ostringstream oss;
+    oss << "Residual : " << residualStatistics.validPixels << " / " << residualStatistics.totalPixels << " px Average " << std::fixed << std::setprecision( 3 )
+        << ( ( residualStatistics.validPixels > 0 ) ? residualStatistics.totalValidPixelsDistance / residualStatistics.validPixels : 0.0f );
+    cv::putText( surfaceMat, oss.str(), cv::Point( 5, offset ), cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar( 255, 255, 255 ), 1, cv::LINE_AA );
+
+    // Retrive Shaded Residual Image ( Red is Positive, Blue is Negative ) from Shaded Residual Frame Buffer
+    NUI_FUSION_BUFFER* shadedDeltaFromReferenceImageFrameBuffer = shadedDeltaFromReferenceImageFrame->pFrameBuffer;
+    cv::Mat( depthHeight, depthWidth, CV_8UC4, shadedDeltaFromReferenceImageFrameBuffer->pBits ).copyTo( frame.residualMat );
+#endif
 
     /*
     // Retrive Normal Image from Normal Frame Buffer
@@ -314,21 +696,28 @@ inline void Kinect::drawFusion()
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Fusion
-    showFusion();
+    showFusion( frame );
 }
 
 // Show Fusion
-inline void Kinect::showFusion()
+inline void Kinect::showFusion( Frame& frame )
 {
+    const cv::Mat& surfaceMat = frame.surfaceMat;
+    const cv::Mat& residualMat = frame.residualMat;
     if( surfaceMat.empty() ){
         return;
     }
 
     // Show Surface Image
-    cv::imshow( "Surface", surfaceMat );
+    sink->write( "Surface", surfaceMat );
+
+    // Show Residual Image
+    if( !residualMat.empty() ){
+        sink->write( "Residual", residualMat );
+    }
 
     /*
     if( normalMat.empty() ){
@@ -336,30 +725,67 @@ inline void Kinect::showFusion()
     }
 
     // Show Normal Image
-    cv::imshow( "Normal", normalMat );
+    sink->write( "Normal", normalMat );
     */
 }
 
 // Save Mesh
 inline void Kinect::save()
 {
+    IndexedMesh indexedMesh;
+#ifdef CPU_FUSION
+    // Re-mesh Bricks Changed since Last Save
+    const size_t bricks = extractor.update( *volume );
+    extractor.getMesh( indexedMesh );
+    std::cout << "Re-meshed Bricks : " << bricks << std::endl;
+#else
     // Calculate Mesh Data
     ComPtr<INuiFusionColorMesh> mesh;
     ERROR_CHECK( reconstruction->CalculateMesh( 1, &mesh ) );
 
-    // Save Mesh Data to PLY File
-    wchar_t* fileName = L"../mesh.ply";
-    WriteAsciiPlyMeshFile( mesh.Get(), W2OLE( fileName ), true, true );
+    // Weld Triangle Soup to Indexed Mesh
+    const Vector3* vertices = nullptr;
+    const int* colors = nullptr;
+    ERROR_CHECK( mesh->GetVertices( &vertices ) );
+    ERROR_CHECK( mesh->GetColors( &colors ) );
+    WeldMesh( &vertices->x, reinterpret_cast<const uint32_t*>( colors ), mesh->VertexCount(), indexedMesh );
+#endif
+
+    // Save Mesh Data to PLY File ( Binary )
+    WritePlyMesh( "../mesh.ply", indexedMesh, true, true );
+
+#ifdef CPU_FUSION
+    // Bake Texture Atlas from Keyframes, and Save Textured Mesh Data to Obj File and Atlas to PNG File
+    if( !keyframes.empty() && indexedMesh.triangleCount() > 0 ){
+        // Decode Keyframes ( Evenly Spaced, at Most 64 Keyframes )
+        const size_t maxKeyframes = 64;
+        const size_t count = ( std::min )( keyframes.size(), maxKeyframes );
+        std::vector<TextureKeyframe> textureKeyframes( count );
+        for( size_t i = 0; i < count; i++ ){
+            keyframes.load( i * keyframes.size() / count, NUI_FUSION_DEFAULT_MINIMUM_DEPTH, NUI_FUSION_DEFAULT_MAXIMUM_DEPTH, textureKeyframes[i] );
+        }
+
+        IndexedMesh texturedMesh;
+        TextureAtlas atlas;
+        baker.bake( indexedMesh, textureKeyframes, texturedMesh, atlas );
+        WriteTexturedObjMesh( "../mesh_textured.obj", texturedMesh, "mesh_textured.png", true );
+        cv::Mat atlasMat;
+        cv::cvtColor( cv::Mat( atlas.height, atlas.width, CV_8UC4, &atlas.pixels[0] ), atlasMat, cv::COLOR_BGRA2BGR );
+        cv::imwrite( "../mesh_textured.png", atlasMat );
+
+        const TextureBakeStatistics& statistics = baker.getStatistics();
+        std::cout << "Baked Texture : " << count << " keyframes " << statistics.charts << " charts " << atlas.width << " x " << atlas.height << " texels "
+                  << std::fixed << std::setprecision( 1 ) << statistics.totalMilliseconds << " ms ( " << statistics.millisecondsPerMillionTriangles << " ms per Million Triangles )" << std::endl;
+    }
+#endif
 
     /*
-    // Save Mesh Data to STL File
-    wchar_t* fileName = L"../mesh.stl";
-    ERROR_CHECK( WriteBinarySTLMeshFile( mesh, W2OLE( fileName ), true ) );
+    // Save Mesh Data to STL File ( Binary )
+    WriteStlMesh( "../mesh.stl", indexedMesh, true );
     */
 
     /*
     // Save Mesh Data to Obj File
-    wchar_t* fileName = L"../mesh.obj";
-    ERROR_CHECK( WriteAsciiObjMeshFile( mesh, W2OLE( fileName ), true ) );
+    WriteObjMesh( "../mesh.obj", indexedMesh, true );
     */
 }
\ No newline at end of file
@@ -8,8 +8,25 @@
 // KinectFusionHelper is: Copyright (c) Microsoft Corporation. All rights reserved.
 #include "KinectFusionHelper.h"
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
+#include "Registration.h"
+#include "TsdfVolume.h"
+#include "HashedTsdfVolume.h"
+#include "MeshWriter.h"
+#include "MeshExtractor.h"
+#include "Raycaster.h"
+#include "IcpTracker.h"
+#include "TextureBaker.h"
+#include "KeyframeStore.h"
+#include "VolumeCheckpoint.h"
+#include "Resampler.h"
+#include "Pipeline.h"
 
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -23,6 +40,9 @@ private:
     // Coordinate Mapper
     ComPtr<ICoordinateMapper> coordinateMapper;
 
+    // Registration
+    Registration registration;
+
     // Reader
     ComPtr<IColorFrameReader> colorFrameReader;
     ComPtr<IDepthFrameReader> depthFrameReader;
@@ -30,14 +50,32 @@ private:
     // Fusion
     ComPtr<INuiFusionColorReconstruction> reconstruction;
 
+    // CPU Fusion ( Open TSDF Volume instead of Kinect Fusion Reconstruction )
+    std::unique_ptr<TsdfGrid> volume;
+    MeshExtractor extractor;
+    Raycaster raycaster;
+    IcpTracker tracker;
+    NUI_FUSION_IMAGE_FRAME* depthPyramidImageFrames[IcpTracker::levelCount - 1];
+    NUI_FUSION_IMAGE_FRAME* pointCloudPyramidImageFrames[IcpTracker::levelCount - 1];
+    std::unique_ptr<Resampler> depthPyramidResamplers[IcpTracker::levelCount - 1];
+    std::unique_ptr<Resampler> pointCloudPyramidResamplers[IcpTracker::levelCount - 1];
+    NUI_FUSION_IMAGE_FRAME* deltaFromReferenceImageFrame;
+    NUI_FUSION_IMAGE_FRAME* shadedDeltaFromReferenceImageFrame;
+    DeltaFromReferenceImageStatistics residualStatistics;
+    bool trackingReference;
+    unsigned int trackingErrorCount;
+    TextureBaker baker;
+    KeyframeStore keyframes;
+    VolumeCheckpointWriter checkpoints;
+    unsigned int integratedFrameCount;
+    bool trackingLost;
+
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
@@ -52,12 +90,34 @@ private:
     NUI_FUSION_RECONSTRUCTION_PARAMETERS reconstructionParameters;
     NUI_FUSION_CAMERA_PARAMETERS cameraParameters;
     Matrix4 worldToCameraTransform;
-    cv::Mat surfaceMat;
     /*cv::Mat normalMat;*/
 
+    // Command Requested by Key Check ( Executed by Draw Stage )
+    std::atomic<int> command = { 0 };
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Depth are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::vector<UINT16> depthBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        cv::Mat surfaceMat;
+        cv::Mat residualMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -78,6 +138,9 @@ private:
     // Initialize Depth
     inline void initializeDepth();
 
+    // Initialize Registration
+    inline void initializeRegistration();
+
     // Initialize Fusion
     inline void initializeFusion();
 
@@ -85,31 +148,52 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Depth
-    inline void updateDepth();
+    inline void updateDepth( Frame& frame );
 
     // Update Fusion
-    inline void updateFusion();
+    inline void updateFusion( Frame& frame );
+
+    // Track Camera
+    inline bool trackCamera();
+
+    // Capture Keyframe for Re-integration and Texture Baking
+    inline void captureKeyframe( const std::vector<UINT16>& depthBuffer );
+
+    // Re-integrate Keyframes
+    inline void reintegrate();
+
+    // Write Checkpoint of Volume in Background
+    inline void checkpoint();
+
+    // Resume Volume from Checkpoint
+    inline void resume();
+
+    // Raycast Surface at Current Pose as Tracking Reference
+    inline void raycastReference();
 
     // Reset Reconstruction
     inline void reset();
 
+    // Execute Command Requested by Key Check
+    inline void executeCommand();
+
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Fusion
-    inline void drawFusion();
+    inline void drawFusion( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Fusion
-    inline void showFusion();
+    inline void showFusion( Frame& frame );
 
     // Save Mesh
     inline void save();
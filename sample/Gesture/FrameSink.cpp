@@ -0,0 +1,222 @@
+#include "FrameSink.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/highgui.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Null Sink
+void NullSink::write( const std::string& name, const cv::Mat& image )
+{
+    add( image );
+}
+
+// File Sink
+FileSink::FileSink( const std::string& directory, const std::string& extension )
+    : directory( directory ), extension( extension )
+{
+    if( this->directory.empty() ){
+        throw std::invalid_argument( "empty directory of file sink" );
+    }
+
+    const char last = this->directory.back();
+    if( last != '/' && last != '\\' ){
+        this->directory += '/';
+    }
+}
+
+void FileSink::write( const std::string& name, const cv::Mat& image )
+{
+    // Create File Name ( <directory>/<name>_000000.png )
+    std::ostringstream path;
+    path << directory << name << "_" << std::setw( 6 ) << std::setfill( '0' ) << numbers[name]++ << extension;
+
+    if( !cv::imwrite( path.str(), image ) ){
+        throw std::runtime_error( "failed cv::imwrite( " + path.str() + " )" );
+    }
+
+    add( image );
+}
+
+// Shared Memory Mapping
+struct SharedMemorySink::Mapping
+{
+#ifdef _WIN32
+    HANDLE handle = nullptr;
+#else
+    int descriptor = -1;
+    std::string name;
+#endif
+    uint8_t* memory = nullptr;
+    size_t bytes = 0;
+
+    // Create Named Shared Memory
+    Mapping( const std::string& name, const size_t bytes )
+        : bytes( bytes )
+    {
+#ifdef _WIN32
+        const uint64_t size = bytes;
+        handle = CreateFileMappingA( INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>( size >> 32 ), static_cast<DWORD>( size ), name.c_str() );
+        if( handle == nullptr ){
+            throw std::runtime_error( "failed CreateFileMapping( " + name + " )" );
+        }
+
+        memory = static_cast<uint8_t*>( MapViewOfFile( handle, FILE_MAP_ALL_ACCESS, 0, 0, bytes ) );
+        if( memory == nullptr ){
+            CloseHandle( handle );
+            throw std::runtime_error( "failed MapViewOfFile( " + name + " )" );
+        }
+#else
+        this->name = "/" + name;
+        descriptor = shm_open( this->name.c_str(), O_CREAT | O_RDWR, 0600 );
+        if( descriptor < 0 ){
+            throw std::runtime_error( "failed shm_open( " + this->name + " )" );
+        }
+
+        void* address = MAP_FAILED;
+        if( ftruncate( descriptor, static_cast<off_t>( bytes ) ) == 0 ){
+            address = mmap( nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0 );
+        }
+        if( address == MAP_FAILED ){
+            close( descriptor );
+            shm_unlink( this->name.c_str() );
+            throw std::runtime_error( "failed mmap( " + this->name + " )" );
+        }
+        memory = static_cast<uint8_t*>( address );
+#endif
+    }
+
+    // Release Shared Memory ( Readers keep their Mapping until They Close It )
+    ~Mapping()
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( memory );
+        CloseHandle( handle );
+#else
+        munmap( memory, bytes );
+        close( descriptor );
+        shm_unlink( name.c_str() );
+#endif
+    }
+
+    SharedFrameHeader* header()
+    {
+        return reinterpret_cast<SharedFrameHeader*>( memory );
+    }
+
+    uint8_t* data()
+    {
+        return memory + sizeof( SharedFrameHeader );
+    }
+};
+
+// Shared Memory Sink
+SharedMemorySink::SharedMemorySink( const std::string& prefix )
+    : prefix( prefix )
+{
+    if( prefix.empty() ){
+        throw std::invalid_argument( "empty prefix of shared memory sink" );
+    }
+}
+
+SharedMemorySink::~SharedMemorySink()
+{
+}
+
+void SharedMemorySink::write( const std::string& name, const cv::Mat& image )
+{
+    const int step = static_cast<int>( image.cols * image.elemSize() );
+    const size_t bytes = static_cast<size_t>( step ) * image.rows;
+
+    // Create Shared Memory at First Image of Window ( Image Size is Fixed for Lifetime of Mapping )
+    std::unique_ptr<Mapping>& mapping = mappings[name];
+    if( mapping == nullptr ){
+        mapping.reset( new Mapping( prefix + "_" + name, sizeof( SharedFrameHeader ) + bytes ) );
+
+        SharedFrameHeader* header = mapping->header();
+        std::memset( header, 0, sizeof( SharedFrameHeader ) );
+        header->magic = 0x4d53324b; // 'K2SM'
+        header->version = 1;
+        header->capacity = bytes;
+    }
+
+    SharedFrameHeader* header = mapping->header();
+    if( bytes > header->capacity ){
+        throw std::runtime_error( "image exceeds capacity of shared memory ( " + name + " )" );
+    }
+
+    // Write Image between Odd and Even Sequence ( Seqlock )
+    volatile uint64_t* sequence = &header->sequence;
+    const uint64_t begin = *sequence + 1;
+    *sequence = begin;
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+
+    header->width = image.cols;
+    header->height = image.rows;
+    header->type = image.type();
+    header->step = step;
+    header->frame++;
+    if( image.isContinuous() ){
+        std::memcpy( mapping->data(), image.data, bytes );
+    }
+    else{
+        for( int y = 0; y < image.rows; y++ ){
+            std::memcpy( mapping->data() + static_cast<size_t>( y ) * step, image.ptr( y ), step );
+        }
+    }
+
+    std::atomic_thread_fence( std::memory_order_release );
+    *sequence = begin + 1;
+
+    add( image );
+}
+
+// Imshow Sink
+void ImshowSink::write( const std::string& name, const cv::Mat& image )
+{
+    cv::imshow( name, image );
+    add( image );
+}
+
+bool ImshowSink::poll()
+{
+    // Escape Key
+    pressed = cv::waitKey( 1 );
+    return pressed != 27;
+}
+
+// Create Frame Sink from Specification
+std::unique_ptr<FrameSink> CreateFrameSink( const std::string& specification )
+{
+    const size_t separator = specification.find( ':' );
+    const std::string type = specification.substr( 0, separator );
+    const std::string argument = ( separator != std::string::npos ) ? specification.substr( separator + 1 ) : "";
+
+    if( type == "imshow" ){
+        return std::unique_ptr<FrameSink>( new ImshowSink() );
+    }
+    if( type == "null" ){
+        return std::unique_ptr<FrameSink>( new NullSink() );
+    }
+    if( type == "file" ){
+        return std::unique_ptr<FrameSink>( new FileSink( argument.empty() ? "." : argument ) );
+    }
+    if( type == "shm" ){
+        return std::unique_ptr<FrameSink>( new SharedMemorySink( argument.empty() ? "Kinect" : argument ) );
+    }
+
+    throw std::invalid_argument( "unknown frame sink ( " + specification + " ), use imshow, null, file:<directory> or shm:<prefix>" );
+}
\ No newline at end of file
@@ -9,7 +9,9 @@
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -25,23 +27,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -99,8 +99,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -172,20 +175,30 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
     updateBody();
 
     // Update Gesture
     updateGesture();
+
+    // Wait until Color is Updated
+    if( !frame.colorUpdated ){
+        return false;
+    }
+
+    // Pass Latest Gesture Results to Frame
+    frame.colorUpdated = false;
+    frame.results = results;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -195,7 +208,8 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
@@ -235,10 +249,6 @@ inline void Kinect::updateBody()
 inline void Kinect::updateGesture()
 {
     Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
-        // Clear Gesture Result Buffer
-        std::vector<std::string>& result = results[count];
-        result.clear();
-
         // Retrieve Gesture Frame
         ComPtr<IVisualGestureBuilderFrame> gestureFrame;
         HRESULT ret = gestureFrameReader[count]->CalculateAndAcquireLatestFrame( &gestureFrame );
@@ -246,6 +256,10 @@ inline void Kinect::updateGesture()
             return;
         }
 
+        // Clear Gesture Result Buffer ( Kept until New Gesture Frame is Retrieved )
+        std::vector<std::string>& result = results[count];
+        result.clear();
+
         // Check Tracking ID is Valid
         BOOLEAN tracked;
         ERROR_CHECK( gestureFrame->get_IsTrackingIdValid( &tracked ) );
@@ -355,25 +369,27 @@ inline std::string Kinect::gesture2string( const ComPtr<IGesture>& gesture )
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Gesture
-    drawGesture();
+    drawGesture( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 }
 
 // Draw Gesture
-inline void Kinect::drawGesture()
+inline void Kinect::drawGesture( Frame& frame )
 {
+    const std::array<std::vector<std::string>, BODY_COUNT>& results = frame.results;
+    cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -408,15 +424,16 @@ inline void Kinect::drawResult( cv::Mat& image, const std::vector<std::string>&
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Gesture
-    showGesture();
+    showGesture( frame );
 }
 
 // Show Gesture
-inline void Kinect::showGesture()
+inline void Kinect::showGesture( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -427,5 +444,5 @@ inline void Kinect::showGesture()
     cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
 
     // Show Image
-    cv::imshow( "Gesture", resizeMat );
+    sink->write( "Gesture", resizeMat );
 }
\ No newline at end of file
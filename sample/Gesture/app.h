@@ -5,9 +5,13 @@
 #include <Kinect.h>
 #include <Kinect.VisualGestureBuilder.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -29,11 +33,9 @@ private:
     std::array<ComPtr<IVisualGestureBuilderFrameReader>, BODY_COUNT> gestureFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Gesture Buffer
     std::vector<ComPtr<IGesture>> gestures;
@@ -42,9 +44,27 @@ private:
     std::array<cv::Vec3b, BODY_COUNT> colors;
     int offset;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        bool colorUpdated;
+        std::array<std::vector<std::string>, BODY_COUNT> results;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -72,10 +92,10 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
     inline void updateBody();
@@ -93,22 +113,22 @@ private:
     inline std::string gesture2string( const ComPtr<IGesture>& gesture );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Gesture
-    inline void drawGesture();
+    inline void drawGesture( Frame& frame );
 
     // Draw Results
     inline void drawResult( cv::Mat& image, const std::vector<std::string>& results, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness = 2 );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Gesture
-    inline void showGesture();
+    inline void showGesture( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
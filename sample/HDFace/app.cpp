@@ -4,13 +4,16 @@
 #include <thread>
 #include <chrono>
 #include <limits>
+#include <iostream>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
 #include <ppl.h>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -26,23 +29,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -100,8 +101,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -130,6 +134,11 @@ inline void Kinect::initializeHDFace()
     ERROR_CHECK( CreateFaceModel( 1.0f, FaceShapeDeformations::FaceShapeDeformations_Count, &faceShapeUnits[0], &faceModel ) );
     ERROR_CHECK( GetFaceModelVertexCount( &vertexCount ) ); // 1347
 
+    // Allocation Vertex Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.vertexes.resize( vertexCount );
+    } );
+
     // Create and Start Face Model Builder
     FaceModelBuilderAttributes attribures = FaceModelBuilderAttributes::FaceModelBuilderAttributes_None;
     ERROR_CHECK( hdFaceFrameSource->OpenModelBuilder( attribures, &faceModelBuilder ) );
@@ -156,20 +165,31 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
     updateBody();
 
     // Update HDFace
     updateHDFace();
+
+    // Wait until Color is Updated
+    if( !frame.colorUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+
+    // Retrieve HDFace Results to Frame ( Face Alignment and Face Model are Refreshed by Next Update )
+    retrieveHDFace( frame );
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -179,7 +199,8 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
@@ -281,37 +302,51 @@ inline void Kinect::updateHDFace()
     produced = true;
 }
 
+// Retrieve HDFace
+inline void Kinect::retrieveHDFace( Frame& frame )
+{
+    // Retrieve Vertexes
+    ERROR_CHECK( faceModel->CalculateVerticesForAlignment( faceAlignment.Get(), vertexCount, &frame.vertexes[0] ) );
+
+    // Retrieve Face Model Builder Status
+    frame.trackingCount = trackingCount;
+    frame.produced = produced;
+    if( !produced ){
+        ERROR_CHECK( faceModelBuilder->get_CollectionStatus( &frame.collection ) );
+        ERROR_CHECK( faceModelBuilder->get_CaptureStatus( &frame.capture ) );
+    }
+}
+
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw HDFace
-    drawHDFace();
+    drawHDFace( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 }
 
 // Draw HDFace
-inline void Kinect::drawHDFace()
+inline void Kinect::drawHDFace( Frame& frame )
 {
+    cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
 
     // Draw Face Model Builder Status
-    drawFaceModelBuilderStatus( colorMat, cv::Point( 50, 50 ), 1.0, colors[trackingCount] );
+    drawFaceModelBuilderStatus( colorMat, frame, cv::Point( 50, 50 ), 1.0, colors[frame.trackingCount] );
 
-    // Retrieve Vertexes
-    std::vector<CameraSpacePoint> vertexes( vertexCount );
-    ERROR_CHECK( faceModel->CalculateVerticesForAlignment( faceAlignment.Get(), vertexCount, &vertexes[0] ) );
-    drawVertexes( colorMat, vertexes, 2, colors[trackingCount] );
+    // Draw Vertexes ( Retrieved by Update Stage )
+    drawVertexes( colorMat, frame.vertexes, 2, colors[frame.trackingCount] );
 
     /*
     // Retrieve Head Pivot Point
@@ -368,29 +403,21 @@ inline void Kinect::drawHDFace()
 }
 
 // Draw Face Model Builder Status
-inline void Kinect::drawFaceModelBuilderStatus( cv::Mat& image, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness )
+inline void Kinect::drawFaceModelBuilderStatus( cv::Mat& image, const Frame& frame, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness )
 {
     if( image.empty() ){
         return;
     }
 
     // Check Produced
-    if( produced ){
+    if( frame.produced ){
         cv::putText( image, "Collection Complete", cv::Point( point.x, point.y ), cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA );
         return;
     }
 
-    // Retrieve Face Model Builder Collection Status
-    FaceModelBuilderCollectionStatus collection;
-    ERROR_CHECK( faceModelBuilder->get_CollectionStatus( &collection ) );
-
-    // Retrieve Face Model Builder Capture Status
-    FaceModelBuilderCaptureStatus capture;
-    ERROR_CHECK( faceModelBuilder->get_CaptureStatus( &capture ) );
-
-    // Draw Status
-    cv::putText( image, status2string( collection ), cv::Point( point.x, point.y ), cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA );
-    cv::putText( image, status2string( capture ), cv::Point( point.x, point.y + 30 ), cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA );
+    // Draw Status ( Face Model Builder Collection and Capture Status Retrieved by Update Stage )
+    cv::putText( image, status2string( frame.collection ), cv::Point( point.x, point.y ), cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA );
+    cv::putText( image, status2string( frame.capture ), cv::Point( point.x, point.y + 30 ), cv::FONT_HERSHEY_SIMPLEX, scale, color, thickness, cv::LINE_AA );
 }
 
 // Convert Collection Status to String
@@ -436,7 +463,7 @@ inline std::string Kinect::status2string( const FaceModelBuilderCaptureStatus ca
 }
 
 // Draw Vertexes
-inline void Kinect::drawVertexes( cv::Mat& image, const std::vector<CameraSpacePoint> vertexes, const int radius, const cv::Vec3b& color, const int thickness )
+inline void Kinect::drawVertexes( cv::Mat& image, const std::vector<CameraSpacePoint>& vertexes, const int radius, const cv::Vec3b& color, const int thickness )
 {
     if( image.empty() ){
         return;
@@ -455,15 +482,16 @@ inline void Kinect::drawVertexes( cv::Mat& image, const std::vector<CameraSpaceP
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show HDFace
-    showHDFace();
+    showHDFace( frame );
 }
 
 // Show HDFace
-inline void Kinect::showHDFace()
+inline void Kinect::showHDFace( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -474,5 +502,5 @@ inline void Kinect::showHDFace()
     cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
 
     // Show Image
-    cv::imshow( "HDFace", resizeMat );
+    sink->write( "HDFace", resizeMat );
 }
\ No newline at end of file
@@ -5,9 +5,13 @@
 #include <Kinect.h>
 #include <Kinect.Face.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -29,11 +33,9 @@ private:
     ComPtr<IHighDefinitionFaceFrameReader> hdFaceFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // HDFace Buffer
     ComPtr<IFaceModelBuilder> faceModelBuilder;
@@ -47,9 +49,31 @@ private:
 
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Color is Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        bool colorUpdated;
+        std::vector<CameraSpacePoint> vertexes;
+        int trackingCount;
+        bool produced;
+        FaceModelBuilderCollectionStatus collection;
+        FaceModelBuilderCaptureStatus capture;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -77,10 +101,10 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
     inline void updateBody();
@@ -91,17 +115,20 @@ private:
     // Update HDFace
     inline void updateHDFace();
 
+    // Retrieve HDFace
+    inline void retrieveHDFace( Frame& frame );
+
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw HDFace
-    inline void drawHDFace();
+    inline void drawHDFace( Frame& frame );
 
     // Draw Face Model Builder Status
-    inline void drawFaceModelBuilderStatus( cv::Mat& image, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness = 2 );
+    inline void drawFaceModelBuilderStatus( cv::Mat& image, const Frame& frame, const cv::Point& point, const double scale, const cv::Vec3b& color, const int thickness = 2 );
 
     // Convert Collection Status to String
     inline std::string status2string( const FaceModelBuilderCollectionStatus collection );
@@ -110,13 +137,13 @@ private:
     inline std::string status2string( const FaceModelBuilderCaptureStatus capture );
 
     // Draw Vertexes
-    inline void Kinect::drawVertexes( cv::Mat& image, const std::vector<CameraSpacePoint> vertexes, const int radius, const cv::Vec3b& color, const int thickness = -1 );
+    inline void Kinect::drawVertexes( cv::Mat& image, const std::vector<CameraSpacePoint>& vertexes, const int radius, const cv::Vec3b& color, const int thickness = -1 );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show HDFace
-    inline void showHDFace();
+    inline void showHDFace( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
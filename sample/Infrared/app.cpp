@@ -3,9 +3,19 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
+
+// Use Synthetic Frames instead of Sensor ( Run without Kinect )
+//#define SYNTHETIC
+
+// Frame Rate of Synthetic Frames ( 0.0 = As Fast As Possible, e.g. to Benchmark Throughput with Null Sink )
+#define SYNTHETIC_FPS 30.0
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : synthetic( SYNTHETIC_FPS ),
+      sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -21,23 +31,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -45,14 +53,18 @@ void Kinect::initialize()
 {
     cv::setUseOptimized( true );
 
+#ifndef SYNTHETIC
     // Initialize Sensor
     initializeSensor();
+#endif
 
     // Initialize Infrared
     initializeInfrared();
 
+#ifndef SYNTHETIC
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
+#endif
 }
 
 // Initialize Sensor
@@ -74,6 +86,12 @@ inline void Kinect::initializeSensor()
 // Initialize Infrared
 inline void Kinect::initializeInfrared()
 {
+#ifdef SYNTHETIC
+    // Retrieve Infrared Description from Synthetic Source
+    infraredWidth = SyntheticSource::depthWidth;
+    infraredHeight = SyntheticSource::depthHeight;
+    infraredBytesPerPixel = sizeof( UINT16 );
+#else
     // Open Infrared Reader
     ComPtr<IInfraredFrameSource> infraredFrameSource;
     ERROR_CHECK( kinect->get_InfraredFrameSource( &infraredFrameSource ) );
@@ -85,9 +103,12 @@ inline void Kinect::initializeInfrared()
     ERROR_CHECK( infraredFrameDescription->get_Width( &infraredWidth ) ); // 512
     ERROR_CHECK( infraredFrameDescription->get_Height( &infraredHeight ) ); // 424
     ERROR_CHECK( infraredFrameDescription->get_BytesPerPixel( &infraredBytesPerPixel ) ); // 2
+#endif
 
-    // Allocation Depth Buffer
-    infraredBuffer.resize( infraredWidth * infraredHeight );
+    // Allocation Infrared Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.infraredBuffer.resize( infraredWidth * infraredHeight );
+    } );
 }
 
 // Finalize
@@ -102,60 +123,67 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Infrared
-    updateInfrared();
+    return updateInfrared( frame );
 }
 
 // Update Infrared
-inline void Kinect::updateInfrared()
+inline bool Kinect::updateInfrared( Frame& frame )
 {
+#ifdef SYNTHETIC
+    // Retrieve Synthetic Infrared Data
+    return synthetic.acquireInfrared( &frame.infraredBuffer[0] );
+#else
     // Retrieve Infrared Frame
     ComPtr<IInfraredFrame> infraredFrame;
     const HRESULT ret = infraredFrameReader->AcquireLatestFrame( &infraredFrame );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
     // Retrieve Infrared Data
-    ERROR_CHECK( infraredFrame->CopyFrameDataToArray( static_cast<UINT>( infraredBuffer.size() ), &infraredBuffer[0] ) );
+    ERROR_CHECK( infraredFrame->CopyFrameDataToArray( static_cast<UINT>( frame.infraredBuffer.size() ), &frame.infraredBuffer[0] ) );
+
+    return true;
+#endif
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Infrared
-    drawInfrared();
+    drawInfrared( frame );
 }
 
 // Draw Infrared
-inline void Kinect::drawInfrared()
+inline void Kinect::drawInfrared( Frame& frame )
 {
     // Create cv::Mat from Infrared Buffer
-    infraredMat = cv::Mat( infraredHeight, infraredWidth, CV_16UC1, &infraredBuffer[0] );
+    frame.infraredMat = cv::Mat( infraredHeight, infraredWidth, CV_16UC1, &frame.infraredBuffer[0] );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Infrared
-    showInfrared();
+    showInfrared( frame );
 }
 
 // Show Infrared
-inline void Kinect::showInfrared()
+inline void Kinect::showInfrared( Frame& frame )
 {
-    if( infraredMat.empty() ){
+    if( frame.infraredMat.empty() ){
         return;
     }
 
     // Scaling ( 0b1111'1111'0000'0000 -> 0b1111'1111 )
     cv::Mat scaleMat( infraredHeight, infraredWidth, CV_8UC1 );
     scaleMat.forEach<uchar>([&]( uchar &p, const int* position ){
-        p = infraredMat.at<ushort>( position[0], position[1] ) >> 8;
+        p = frame.infraredMat.at<ushort>( position[0], position[1] ) >> 8;
     });
 
     // Show Image
-    cv::imshow( "Infrared", scaleMat );
+    sink->write( "Infrared", scaleMat );
 }
\ No newline at end of file
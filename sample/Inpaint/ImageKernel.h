@@ -0,0 +1,79 @@
+#ifndef __IMAGE_KERNEL__
+#define __IMAGE_KERNEL__
+
+#include <cstdint>
+#include <cstddef>
+
+// Image Kernels
+// Per-frame image operations of draw and show stages that write into a preallocated destination.
+// They replace cv::resize, convertTo and forEach on the frame loop, because these allocate working buffers or parallel jobs on every call.
+// Kernels use only the standard library, so they are tested with the allocation check on any platform.
+class ImageKernel
+{
+public:
+    // Scale Depth to Gray ( 0-8000 -> 255-0, Same as convertTo( CV_8U, -255.0 / 8000.0, 255.0 ) )
+    static void scaleDepth( const uint16_t* depth, const size_t count, uint8_t* gray )
+    {
+        const float scale = 255.0f / 8000.0f;
+        for( size_t index = 0; index < count; index++ ){
+            // Round to Nearest ( Truncation of Value + 0.5 ), Saturate Far Depth to 0
+            const float value = 255.5f - depth[index] * scale;
+            gray[index] = ( value > 0.0f ) ? static_cast<uint8_t>( value ) : 0;
+        }
+    }
+
+    // Halve Image ( 2 x 2 Box Filter, Same as cv::resize with INTER_LINEAR at Scale 0.5, Destination is ( width / 2 ) x ( height / 2 ) x channels bytes )
+    static void halve( const uint8_t* src, const int width, const int height, const int channels, uint8_t* dst )
+    {
+        const int halfWidth = width / 2;
+        const int halfHeight = height / 2;
+        const size_t stride = static_cast<size_t>( width ) * channels;
+        for( int row = 0; row < halfHeight; row++ ){
+            const uint8_t* src0 = src + static_cast<size_t>( row * 2 ) * stride;
+            const uint8_t* src1 = src0 + stride;
+            uint8_t* dstRow = dst + static_cast<size_t>( row ) * halfWidth * channels;
+            for( int column = 0; column < halfWidth; column++ ){
+                for( int channel = 0; channel < channels; channel++ ){
+                    const int offset = column * 2 * channels + channel;
+                    const int sum = src0[offset] + src0[offset + channels] + src1[offset] + src1[offset + channels];
+                    dstRow[column * channels + channel] = static_cast<uint8_t>( ( sum + 2 ) >> 2 );
+                }
+            }
+        }
+    }
+
+    // Mask Invalid Depth ( 255 where Depth <= threshold, 0 Elsewhere, Same as cv::compare( CMP_LE ) )
+    static void maskDepth( const uint16_t* depth, const size_t count, const uint16_t threshold, uint8_t* mask )
+    {
+        for( size_t index = 0; index < count; index++ ){
+            mask[index] = ( depth[index] <= threshold ) ? 255 : 0;
+        }
+    }
+
+    // Compose Chroma Key ( BGRA Color where Body Index is Valid, Zero Elsewhere )
+    static void chromaKey( const uint32_t* color, const uint8_t* bodyIndex, const size_t count, uint32_t* composed )
+    {
+        for( size_t index = 0; index < count; index++ ){
+            composed[index] = ( bodyIndex[index] != 0xff ) ? color[index] : 0;
+        }
+    }
+
+    // Remap Source to Mapped Coordinates ( Nearest Source Pixel, outside Value where Coordinate is outside of Source )
+    // Point is any type with float members X and Y ( DepthSpacePoint )
+    template<typename T, typename Point>
+    static void remap( const T* source, const int sourceWidth, const int sourceHeight, const Point* points, const size_t count, const T outside, T* destination )
+    {
+        for( size_t index = 0; index < count; index++ ){
+            const int x = static_cast<int>( points[index].X + 0.5f );
+            const int y = static_cast<int>( points[index].Y + 0.5f );
+            if( ( 0 <= x ) && ( x < sourceWidth ) && ( 0 <= y ) && ( y < sourceHeight ) ){
+                destination[index] = source[y * sourceWidth + x];
+            }
+            else{
+                destination[index] = outside;
+            }
+        }
+    }
+};
+
+#endif // __IMAGE_KERNEL__
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 
 #include <ppl.h>
 
@@ -11,7 +12,9 @@
 #define DEPTH
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -27,26 +30,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
-        // Draw Data
-        draw();
-
-        // Inpaint Depth
-        inpaintDepth();
-
+        [&]( Frame& frame ){ return update( frame ); },
+        // Draw Data and Inpaint Depth
+        [&]( Frame& frame ){ draw( frame ); inpaintDepth( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -63,6 +61,9 @@ void Kinect::initialize()
     // Initialize Depth
     initializeDepth();
 
+    // Initialize Frame Buffer Pool
+    initializeFramePool();
+
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
 }
@@ -101,8 +102,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Depth
@@ -120,8 +124,79 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameDescription->get_Height( &depthHeight ) ); // 424
     ERROR_CHECK( depthFrameDescription->get_BytesPerPixel( &depthBytesPerPixel ) ); // 2
 
-    // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    // Allocation Depth Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.depthUpdated = false;
+    } );
+}
+
+// Initialize Registration
+inline void Kinect::initializeRegistration()
+{
+    // Retrieve Mapped Coordinates at Two Constant Depths
+    const UINT16 nearDepth = 500; // [mm]
+    const UINT16 farDepth = 4500; // [mm]
+    std::vector<UINT16> nearDepthBuffer( depthWidth * depthHeight, nearDepth );
+    std::vector<UINT16> farDepthBuffer( depthWidth * depthHeight, farDepth );
+    std::vector<ColorSpacePoint> nearPoints( depthWidth * depthHeight );
+    std::vector<ColorSpacePoint> farPoints( depthWidth * depthHeight );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( nearDepthBuffer.size(), &nearDepthBuffer[0], nearPoints.size(), &nearPoints[0] ) );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( farDepthBuffer.size(), &farDepthBuffer[0], farPoints.size(), &farPoints[0] ) );
+
+    // Build Calibration Tables
+    registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, &nearPoints[0], nearDepth, &farPoints[0], farDepth );
+}
+
+// Initialize Frame Buffer Pool
+inline void Kinect::initializeFramePool()
+{
+#ifdef DEPTH
+    // Allocation Color Frame Buffers ( Depth Resolution, One Buffer per Frame )
+    colorPool.allocate( depthWidth * depthHeight * colorBytesPerPixel, pipeline.size() );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorFrameBuffer = colorPool.acquire();
+    } );
+#endif
+
+#ifdef COLOR
+    // Allocation Depth Frame Buffers ( Color Resolution, One Buffer per Frame )
+    depthPool.allocate( colorWidth * colorHeight * depthBytesPerPixel, pipeline.size() );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthFrameBuffer = depthPool.acquire();
+    } );
+    depthSpacePoints.resize( colorWidth * colorHeight );
+#endif
+
+    // Allocation Inpaint Buffers ( Inpaint Result is One Buffer per Frame, cv::resize and copyTo Reuse Destination of Same Size and Type )
+#ifdef COLOR
+    const int width = colorWidth;
+    const int height = colorHeight;
+    const double inpaintScale = 0.3;
+    resizeDepthMat.create( static_cast<int>( height * inpaintScale ), static_cast<int>( width * inpaintScale ), CV_16UC1 );
+    resizeMaskMat.create( resizeDepthMat.size(), CV_8UC1 );
+    resizeInpaintMat.create( resizeDepthMat.size(), CV_16UC1 );
+    scaleUpMat.create( height, width, CV_16UC1 );
+#endif
+
+#ifdef DEPTH
+    const int width = depthWidth;
+    const int height = depthHeight;
+#endif
+    maskMat.create( height, width, CV_8UC1 );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.inpaintMat.create( height, width, CV_16UC1 );
+    } );
+
+    // Allocation Show Buffers
+#ifdef COLOR
+    const double scale = 0.5;
+    colorResizeMat.create( static_cast<int>( colorHeight * scale ), static_cast<int>( colorWidth * scale ), CV_8UC4 );
+    depthResizeMat.create( static_cast<int>( height * scale ), static_cast<int>( width * scale ), CV_8UC1 );
+    inpaintResizeMat.create( depthResizeMat.size(), CV_8UC1 );
+#endif
+    depthScaleMat.create( height, width, CV_8UC1 );
+    inpaintScaleMat.create( height, width, CV_8UC1 );
 }
 
 // Finalize
@@ -136,17 +211,26 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Depth
-    updateDepth();
+    updateDepth( frame );
+
+    // Wait until Both Color and Depth are Updated
+    if( !frame.colorUpdated || !frame.depthUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.depthUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -156,11 +240,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Depth
-inline void Kinect::updateDepth()
+inline void Kinect::updateDepth( Frame& frame )
 {
     // Retrieve Depth Frame
     ComPtr<IDepthFrame> depthFrame;
@@ -170,119 +255,98 @@ inline void Kinect::updateDepth()
     }
 
     // Retrieve Depth Data
-    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( frame.depthBuffer.size() ), &frame.depthBuffer[0] ) );
+    frame.depthUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Depth
-    drawDepth();
+    drawDepth( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
 #ifdef DEPTH
-    // Retrieve Mapped Coordinates
-    std::vector<ColorSpacePoint> colorSpacePoints( depthWidth * depthHeight );
-    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( depthBuffer.size(), &depthBuffer[0], colorSpacePoints.size(), &colorSpacePoints[0] ) );
+    // Initialize Registration after Coordinate Mapper Received Calibration from Sensor
+    if( !registration.isInitialized() ){
+        initializeRegistration();
+        if( !registration.isInitialized() ){
+            frame.colorMat = cv::Mat();
+            return;
+        }
+    }
 
     // Mapping Color to Depth Resolution
-    std::vector<BYTE> buffer( depthWidth * depthHeight * colorBytesPerPixel );
-
-    Concurrency::parallel_for( 0, depthHeight, [&]( const int depthY ){
-        const unsigned int depthOffset = depthY * depthWidth;
-        for( int depthX = 0; depthX < depthWidth; depthX++ ){
-            unsigned int depthIndex = depthOffset + depthX;
-            const int colorX = static_cast<int>( colorSpacePoints[depthIndex].X + 0.5f );
-            const int colorY = static_cast<int>( colorSpacePoints[depthIndex].Y + 0.5f );
-            if( ( 0 <= colorX ) && ( colorX < colorWidth ) && ( 0 <= colorY ) && ( colorY < colorHeight ) ){
-                const unsigned int colorIndex = ( colorY * colorWidth + colorX ) * colorBytesPerPixel;
-                depthIndex = depthIndex * colorBytesPerPixel;
-                buffer[depthIndex + 0] = colorBuffer[colorIndex + 0];
-                buffer[depthIndex + 1] = colorBuffer[colorIndex + 1];
-                buffer[depthIndex + 2] = colorBuffer[colorIndex + 2];
-                buffer[depthIndex + 3] = colorBuffer[colorIndex + 3];
-            }
-        }
-    } );
+    registration.registerColor( &frame.depthBuffer[0], &frame.colorBuffer[0], frame.colorFrameBuffer.ptr<BYTE>() );
 
-    // Create cv::Mat from Coordinate Buffer
-    colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, &buffer[0] ).clone();
+    // Create cv::Mat from Frame Buffer
+    frame.colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, frame.colorFrameBuffer.data() );
 #else
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0]);
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0]);
 #endif
 
 }
 
 // Draw Depth
-inline void Kinect::drawDepth()
+inline void Kinect::drawDepth( Frame& frame )
 {
 #ifdef COLOR
+    const std::vector<UINT16>& depthBuffer = frame.depthBuffer;
+
     // Retrieve Mapped Coordinates
-    std::vector<DepthSpacePoint> depthSpacePoints( colorWidth * colorHeight );
     ERROR_CHECK( coordinateMapper->MapColorFrameToDepthSpace( depthBuffer.size(), &depthBuffer[0], depthSpacePoints.size(), &depthSpacePoints[0] ) );
 
     // Mapping Depth to Color Resolution
-    std::vector<UINT16> buffer( colorWidth * colorHeight );
+    UINT16* buffer = frame.depthFrameBuffer.ptr<UINT16>();
 
     Concurrency::parallel_for( 0, colorHeight, [&]( const int colorY ){
-        const unsigned int colorOffset = colorY * colorWidth;
-        for( int colorX = 0; colorX < colorWidth; colorX++ ){
-            const unsigned int colorIndex = colorOffset + colorX;
-            const int depthX = static_cast<int>( depthSpacePoints[colorIndex].X + 0.5f );
-            const int depthY = static_cast<int>( depthSpacePoints[colorIndex].Y + 0.5f );
-            if( ( 0 <= depthX ) && ( depthX < depthWidth ) && ( 0 <= depthY ) && ( depthY < depthHeight ) ){
-                const unsigned int depthIndex = depthY * depthWidth + depthX;
-                buffer[colorIndex] = depthBuffer[depthIndex];
-            }
-        }
+        const size_t colorOffset = static_cast<size_t>( colorY ) * colorWidth;
+        ImageKernel::remap<UINT16>( &depthBuffer[0], depthWidth, depthHeight, &depthSpacePoints[colorOffset], colorWidth, 0, buffer + colorOffset );
     } );
 
-    // Create cv::Mat from Coordinate Buffer
-    depthMat = cv::Mat( colorHeight, colorWidth, CV_16UC1, &buffer[0] ).clone();
+    // Create cv::Mat from Frame Buffer
+    frame.depthMat = cv::Mat( colorHeight, colorWidth, CV_16UC1, buffer );
 #else
     // Create cv::Mat from Depth Buffer
-    depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &depthBuffer[0]);
+    frame.depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &frame.depthBuffer[0]);
 #endif
 }
 
 // Inpaint Depth
-void Kinect::inpaintDepth()
+void Kinect::inpaintDepth( Frame& frame )
 {
+    const cv::Mat& depthMat = frame.depthMat;
+    cv::Mat& inpaintMat = frame.inpaintMat;
     if( depthMat.empty() ){
+        inpaintMat = cv::Mat();
         return;
     }
 
     // Create Inpaint Mask ( This mask is area where depth couldn't be retrieved becauses shadow, noise, or outside of range. )
-    cv::Mat maskMat;
-    cv::threshold( depthMat, maskMat, 500, std::numeric_limits<unsigned short>::max(), cv::THRESH_BINARY_INV );
-    maskMat.convertTo( maskMat, CV_8U, 255.0 / std::numeric_limits<unsigned short>::max() );
+    ImageKernel::maskDepth( depthMat.ptr<UINT16>(), depthMat.total(), 500, maskMat.data );
 
 #ifdef COLOR
     // Scale Down
-    const double scale = 0.3;
-    cv::Mat resizeDepthMat;
-    cv::Mat resizeMaskMat;
-    cv::resize( depthMat, resizeDepthMat, cv::Size(), scale, scale );
-    cv::resize( maskMat, resizeMaskMat, cv::Size(), scale, scale );
+    cv::resize( depthMat, resizeDepthMat, resizeDepthMat.size() );
+    cv::resize( maskMat, resizeMaskMat, resizeMaskMat.size() );
 
     // Inpaint Depth
     const double radius = 5.0;
-    cv::inpaint( resizeDepthMat, resizeMaskMat, inpaintMat, radius, cv::INPAINT_NS );
+    cv::inpaint( resizeDepthMat, resizeMaskMat, resizeInpaintMat, radius, cv::INPAINT_NS );
 
     // Scale Up
-    cv::resize( inpaintMat, inpaintMat, depthMat.size() );
+    cv::resize( resizeInpaintMat, scaleUpMat, scaleUpMat.size() );
 
-    // Add Copy
-    cv::Mat tmpMat = depthMat.clone();
-    inpaintMat.copyTo( tmpMat, maskMat );
-    inpaintMat = tmpMat.clone();
+    // Add Copy ( Inpainted Depth in Mask, Original Depth Elsewhere )
+    depthMat.copyTo( inpaintMat );
+    scaleUpMat.copyTo( inpaintMat, maskMat );
 #else
     // Inpaint Depth
     const double radius = 5.0;
@@ -291,87 +355,82 @@ void Kinect::inpaintDepth()
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Color
-    showColor();
+    showColor( frame );
 
     // Show Depth
-    showDepth();
+    showDepth( frame );
 
     // Show Inpaint
-    showInpaint();
+    showInpaint( frame );
 }
 
 // Show Color
-inline void Kinect::showColor()
+inline void Kinect::showColor( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
 
 #ifdef COLOR
     // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
+    ImageKernel::halve( colorMat.data, colorMat.cols, colorMat.rows, 4, colorResizeMat.data );
 
     // Show Image
-    cv::imshow( "Color", resizeMat );
+    sink->write( "Color", colorResizeMat );
 #else
     // Show Image
-    cv::imshow( "Color", colorMat );
+    sink->write( "Color", colorMat );
 #endif
 }
 
 // Show Depth
-inline void Kinect::showDepth()
+inline void Kinect::showDepth( Frame& frame )
 {
+    const cv::Mat& depthMat = frame.depthMat;
     if( depthMat.empty() ){
         return;
     }
 
     // Scaling ( 0-8000 -> 255-0 )
-    cv::Mat scaleMat;
-    depthMat.convertTo( scaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
-    //cv::applyColorMap( scaleMat, scaleMat, cv::COLORMAP_BONE );
+    ImageKernel::scaleDepth( depthMat.ptr<UINT16>(), depthMat.total(), depthScaleMat.data );
+    //cv::applyColorMap( depthScaleMat, depthScaleMat, cv::COLORMAP_BONE );
 
 #ifdef COLOR
     // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( scaleMat, resizeMat, cv::Size(), scale, scale );
+    ImageKernel::halve( depthScaleMat.data, depthScaleMat.cols, depthScaleMat.rows, 1, depthResizeMat.data );
 
     // Show Image
-    cv::imshow( "Depth", resizeMat );
+    sink->write( "Depth", depthResizeMat );
 #else
     // Show Image
-    cv::imshow( "Depth", scaleMat );
+    sink->write( "Depth", depthScaleMat );
 #endif
 }
 
 // Show Inpaint
-inline void Kinect::showInpaint()
+inline void Kinect::showInpaint( Frame& frame )
 {
+    const cv::Mat& inpaintMat = frame.inpaintMat;
     if( inpaintMat.empty() ){
         return;
     }
 
     // Scaling ( 0-8000 -> 255-0 )
-    cv::Mat scaleMat;
-    inpaintMat.convertTo( scaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
-    //cv::applyColorMap( scaleMat, scaleMat, cv::COLORMAP_BONE );
+    ImageKernel::scaleDepth( inpaintMat.ptr<UINT16>(), inpaintMat.total(), inpaintScaleMat.data );
+    //cv::applyColorMap( inpaintScaleMat, inpaintScaleMat, cv::COLORMAP_BONE );
 
 #ifdef COLOR
     // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( scaleMat, resizeMat, cv::Size(), scale, scale );
+    ImageKernel::halve( inpaintScaleMat.data, inpaintScaleMat.cols, inpaintScaleMat.rows, 1, inpaintResizeMat.data );
 
     // Show Image
-    cv::imshow( "Inpaint", resizeMat );
+    sink->write( "Inpaint", inpaintResizeMat );
 #else
     // Show Image
-    cv::imshow( "Inpaint", scaleMat );
+    sink->write( "Inpaint", inpaintScaleMat );
 #endif
 }
\ No newline at end of file
@@ -4,8 +4,15 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Registration.h"
+#include "ImageKernel.h"
+#include "FramePool.h"
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -19,30 +26,68 @@ private:
     // Coordinate Mapper
     ComPtr<ICoordinateMapper> coordinateMapper;
 
+    // Registration
+    Registration registration;
+
     // Reader
     ComPtr<IColorFrameReader> colorFrameReader;
     ComPtr<IDepthFrameReader> depthFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
-    cv::Mat depthMat;
 
-    // Inpaint Buffer
-    cv::Mat inpaintMat;
+    // Frame Buffer Pool
+    FramePool colorPool;
+    FramePool depthPool;
+    std::vector<DepthSpacePoint> depthSpacePoints;
+
+    // Inpaint Buffer ( Allocated Once, Reused by Draw Stage )
+    cv::Mat maskMat;
+    cv::Mat resizeDepthMat;
+    cv::Mat resizeMaskMat;
+    cv::Mat resizeInpaintMat;
+    cv::Mat scaleUpMat;
+
+    // Show Buffer ( Allocated Once, Reused by Show Stage )
+    cv::Mat colorResizeMat;
+    cv::Mat depthScaleMat;
+    cv::Mat depthResizeMat;
+    cv::Mat inpaintScaleMat;
+    cv::Mat inpaintResizeMat;
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Depth are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::vector<UINT16> depthBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        FrameBuffer colorFrameBuffer;
+        FrameBuffer depthFrameBuffer;
+        cv::Mat colorMat;
+        cv::Mat depthMat;
+        cv::Mat inpaintMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -63,41 +108,47 @@ private:
     // Initialize Depth
     inline void initializeDepth();
 
+    // Initialize Registration
+    inline void initializeRegistration();
+
+    // Initialize Frame Buffer Pool
+    inline void initializeFramePool();
+
     // Finalize
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Depth
-    inline void updateDepth();
+    inline void updateDepth( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Depth
-    inline void drawDepth();
+    inline void drawDepth( Frame& frame );
 
     // Inpaint Depth
-    void inpaintDepth();
+    void inpaintDepth( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Color
-    inline void showColor();
+    inline void showColor( Frame& frame );
 
     // Show Depth
-    inline void showDepth();
+    inline void showDepth( Frame& frame );
 
     // Show Inpaint
-    inline void showInpaint();
+    inline void showInpaint( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
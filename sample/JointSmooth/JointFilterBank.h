@@ -0,0 +1,337 @@
+#ifndef __JOINT_FILTER_BANK__
+#define __JOINT_FILTER_BANK__
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "simd.h"
+
+// Smoothing Parameters ( Same Meaning as TRANSFORM_SMOOTH_PARAMETERS of KinectJointFilter )
+struct JointFilterParameters
+{
+    float smoothing;          // [0..1], lower values closer to raw data
+    float correction;         // [0..1], lower values slower to correct towards the raw data
+    float prediction;         // [0..n], the number of frames to predict into the future
+    float jitterRadius;       // The radius in meters for jitter reduction
+    float maxDeviationRadius; // The maximum radius in meters that filtered positions are allowed to deviate from raw data
+};
+
+// Holt Double Exponential Smoothing Filter Bank
+//
+// Smooths the joints of all bodies in one pass.
+// Same math as FilterDoubleExponential::Update( Joint[], UINT, TRANSFORM_SMOOTH_PARAMETERS ) of KinectJointFilter
+// ( Copyright (c) Microsoft Corporation ), but state is stored as structure of arrays ( one lane per body and joint ),
+// and branches of jitter filter, initial frames and deviation clamp are replaced by blends, so 8 joints are filtered at once with AVX2.
+// State is kept per tracking ID, it is reset when a body is lost or another body takes its index.
+class JointFilterBank
+{
+public:
+    static const int bodyCount = 6;   // BODY_COUNT
+    static const int jointCount = 25; // JointType_Count
+    static const int laneCount = ( bodyCount * jointCount + 7 ) / 8 * 8;
+    static const int inferredState = 1; // TrackingState_Inferred
+
+private:
+    // Lane Arrays
+    enum Array
+    {
+        Array_InputX, Array_InputY, Array_InputZ, Array_Inferred,
+        Array_RawX, Array_RawY, Array_RawZ,
+        Array_FilteredX, Array_FilteredY, Array_FilteredZ,
+        Array_TrendX, Array_TrendY, Array_TrendZ,
+        Array_FrameCount,
+        Array_OutputX, Array_OutputY, Array_OutputZ,
+        Array_Count
+    };
+
+    alignas( 32 ) float lanes[Array_Count][laneCount];
+    uint64_t trackingIds[bodyCount];
+    bool active[bodyCount];
+    JointFilterParameters parameters;
+
+public:
+    // Constructor
+    JointFilterBank()
+    {
+        const JointFilterParameters defaults = { 0.25f, 0.25f, 0.25f, 0.03f, 0.05f };
+        initialize( defaults );
+    }
+
+    // Initialize Parameters and Reset State
+    void initialize( const JointFilterParameters& parameters )
+    {
+        this->parameters = parameters;
+
+        // Check for divide by zero. Use an epsilon of a 10th of a millimeter
+        this->parameters.jitterRadius = ( std::max )( 0.0001f, parameters.jitterRadius );
+
+        reset();
+    }
+
+    // Reset State of All Bodies
+    void reset()
+    {
+        std::memset( lanes, 0, sizeof( lanes ) );
+        std::fill( trackingIds, trackingIds + bodyCount, 0 );
+        std::fill( active, active + bodyCount, false );
+    }
+
+    // Set Joints of Tracked Body for Next update()
+    // Body is index of body ( 0 - 5, Kinect keeps a tracked body in same index ), state is reset when tracking ID of body changed.
+    // Joint is any type with members Position.X/Y/Z and TrackingState ( Joint of Kinect SDK )
+    template<typename Joint>
+    void setJoints( const int body, const uint64_t trackingId, const Joint* joints )
+    {
+        if( body < 0 || bodyCount <= body ){
+            throw std::out_of_range( "invalid body of joint filter bank" );
+        }
+
+        // Another Body
+        if( trackingIds[body] != trackingId ){
+            resetBody( body );
+            trackingIds[body] = trackingId;
+        }
+
+        const int begin = body * jointCount;
+        for( int joint = 0; joint < jointCount; joint++ ){
+            lanes[Array_InputX][begin + joint] = joints[joint].Position.X;
+            lanes[Array_InputY][begin + joint] = joints[joint].Position.Y;
+            lanes[Array_InputZ][begin + joint] = joints[joint].Position.Z;
+            lanes[Array_Inferred][begin + joint] = ( joints[joint].TrackingState == inferredState ) ? 1.0f : 0.0f;
+        }
+        active[body] = true;
+    }
+
+    // Filter Joints of All Bodies Set since Last update() ( Bodies not Set are Reset )
+    void update()
+    {
+        for( int body = 0; body < bodyCount; body++ ){
+            if( !active[body] ){
+                resetBody( body );
+                trackingIds[body] = 0;
+            }
+        }
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            filterAVX2();
+            std::fill( active, active + bodyCount, false );
+            return;
+        }
+#endif
+
+        filterScalar();
+        std::fill( active, active + bodyCount, false );
+    }
+
+    // Retrieve Filtered Joints of Body ( Overwrites Position.X/Y/Z )
+    template<typename Joint>
+    void getJoints( const int body, Joint* joints ) const
+    {
+        if( body < 0 || bodyCount <= body ){
+            throw std::out_of_range( "invalid body of joint filter bank" );
+        }
+
+        const int begin = body * jointCount;
+        for( int joint = 0; joint < jointCount; joint++ ){
+            joints[joint].Position.X = lanes[Array_OutputX][begin + joint];
+            joints[joint].Position.Y = lanes[Array_OutputY][begin + joint];
+            joints[joint].Position.Z = lanes[Array_OutputZ][begin + joint];
+        }
+    }
+
+private:
+    // Reset State and Input of Body ( Zero Position is Invalid Joint )
+    void resetBody( const int body )
+    {
+        for( int array = 0; array < Array_Count; array++ ){
+            std::fill( &lanes[array][body * jointCount], &lanes[array][( body + 1 ) * jointCount], 0.0f );
+        }
+    }
+
+    // Filter Lanes ( Scalar )
+    void filterScalar()
+    {
+        const float smoothing = parameters.smoothing;
+        const float correction = parameters.correction;
+        const float prediction = parameters.prediction;
+
+        for( int i = 0; i < laneCount; i++ ){
+            // If inferred, we smooth a bit more by using a bigger jitter radius
+            const float scale = 1.0f + lanes[Array_Inferred][i];
+            const float jitterRadius = parameters.jitterRadius * scale;
+            const float maxDeviationRadius = parameters.maxDeviationRadius * scale;
+
+            const float raw[3] = { lanes[Array_InputX][i], lanes[Array_InputY][i], lanes[Array_InputZ][i] };
+            const float prevRaw[3] = { lanes[Array_RawX][i], lanes[Array_RawY][i], lanes[Array_RawZ][i] };
+            const float prevFiltered[3] = { lanes[Array_FilteredX][i], lanes[Array_FilteredY][i], lanes[Array_FilteredZ][i] };
+            const float prevTrend[3] = { lanes[Array_TrendX][i], lanes[Array_TrendY][i], lanes[Array_TrendZ][i] };
+            float frameCount = lanes[Array_FrameCount][i];
+
+            // If joint is invalid, reset the filter
+            if( raw[0] == 0.0f && raw[1] == 0.0f && raw[2] == 0.0f ){
+                frameCount = 0.0f;
+            }
+
+            float filtered[3];
+            float trend[3];
+            if( frameCount == 0.0f ){
+                // Initial start values
+                for( int c = 0; c < 3; c++ ){
+                    filtered[c] = raw[c];
+                    trend[c] = 0.0f;
+                }
+                frameCount = 1.0f;
+            }
+            else if( frameCount == 1.0f ){
+                for( int c = 0; c < 3; c++ ){
+                    filtered[c] = ( raw[c] + prevRaw[c] ) * 0.5f;
+                    trend[c] = ( filtered[c] - prevFiltered[c] ) * correction + prevTrend[c] * ( 1.0f - correction );
+                }
+                frameCount = 2.0f;
+            }
+            else{
+                // First apply jitter filter
+                const float diff = length( raw[0] - prevFiltered[0], raw[1] - prevFiltered[1], raw[2] - prevFiltered[2] );
+                const float ratio = diff / jitterRadius;
+                for( int c = 0; c < 3; c++ ){
+                    filtered[c] = ( diff <= jitterRadius ) ? raw[c] * ratio + prevFiltered[c] * ( 1.0f - ratio ) : raw[c];
+                }
+
+                // Now the double exponential smoothing filter
+                for( int c = 0; c < 3; c++ ){
+                    filtered[c] = filtered[c] * ( 1.0f - smoothing ) + ( prevFiltered[c] + prevTrend[c] ) * smoothing;
+                    trend[c] = ( filtered[c] - prevFiltered[c] ) * correction + prevTrend[c] * ( 1.0f - correction );
+                }
+            }
+
+            // Predict into the future to reduce latency
+            float predicted[3];
+            for( int c = 0; c < 3; c++ ){
+                predicted[c] = filtered[c] + trend[c] * prediction;
+            }
+
+            // Check that we are not too far away from raw data
+            const float diff = length( predicted[0] - raw[0], predicted[1] - raw[1], predicted[2] - raw[2] );
+            if( diff > maxDeviationRadius ){
+                const float ratio = maxDeviationRadius / diff;
+                for( int c = 0; c < 3; c++ ){
+                    predicted[c] = predicted[c] * ratio + raw[c] * ( 1.0f - ratio );
+                }
+            }
+
+            // Save the data from this frame
+            lanes[Array_RawX][i] = raw[0];
+            lanes[Array_RawY][i] = raw[1];
+            lanes[Array_RawZ][i] = raw[2];
+            lanes[Array_FilteredX][i] = filtered[0];
+            lanes[Array_FilteredY][i] = filtered[1];
+            lanes[Array_FilteredZ][i] = filtered[2];
+            lanes[Array_TrendX][i] = trend[0];
+            lanes[Array_TrendY][i] = trend[1];
+            lanes[Array_TrendZ][i] = trend[2];
+            lanes[Array_FrameCount][i] = frameCount;
+
+            // Output the data
+            lanes[Array_OutputX][i] = predicted[0];
+            lanes[Array_OutputY][i] = predicted[1];
+            lanes[Array_OutputZ][i] = predicted[2];
+        }
+    }
+
+    static float length( const float x, const float y, const float z )
+    {
+        return std::sqrt( x * x + y * y + z * z );
+    }
+
+#ifdef SIMD_X86
+    // Filter Lanes ( AVX2, 8 Lanes per Iteration, Branches are Computed for All Lanes and Blended )
+    SIMD_TARGET_AVX2 void filterAVX2()
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps( 1.0f );
+        const __m256 two = _mm256_set1_ps( 2.0f );
+        const __m256 half = _mm256_set1_ps( 0.5f );
+        const __m256 smoothing = _mm256_set1_ps( parameters.smoothing );
+        const __m256 smoothingInverse = _mm256_set1_ps( 1.0f - parameters.smoothing );
+        const __m256 correction = _mm256_set1_ps( parameters.correction );
+        const __m256 correctionInverse = _mm256_set1_ps( 1.0f - parameters.correction );
+        const __m256 prediction = _mm256_set1_ps( parameters.prediction );
+        const __m256 jitterBase = _mm256_set1_ps( parameters.jitterRadius );
+        const __m256 deviationBase = _mm256_set1_ps( parameters.maxDeviationRadius );
+
+        for( int i = 0; i < laneCount; i += 8 ){
+            // If inferred, we smooth a bit more by using a bigger jitter radius
+            const __m256 scale = _mm256_add_ps( one, _mm256_loadu_ps( &lanes[Array_Inferred][i] ) );
+            const __m256 jitterRadius = _mm256_mul_ps( jitterBase, scale );
+            const __m256 maxDeviationRadius = _mm256_mul_ps( deviationBase, scale );
+
+            __m256 raw[3], prevRaw[3], prevFiltered[3], prevTrend[3];
+            for( int c = 0; c < 3; c++ ){
+                raw[c] = _mm256_loadu_ps( &lanes[Array_InputX + c][i] );
+                prevRaw[c] = _mm256_loadu_ps( &lanes[Array_RawX + c][i] );
+                prevFiltered[c] = _mm256_loadu_ps( &lanes[Array_FilteredX + c][i] );
+                prevTrend[c] = _mm256_loadu_ps( &lanes[Array_TrendX + c][i] );
+            }
+
+            // If joint is invalid, reset the filter
+            const __m256 valid = _mm256_or_ps( _mm256_or_ps( _mm256_cmp_ps( raw[0], zero, _CMP_NEQ_UQ ), _mm256_cmp_ps( raw[1], zero, _CMP_NEQ_UQ ) ), _mm256_cmp_ps( raw[2], zero, _CMP_NEQ_UQ ) );
+            const __m256 frameCount = _mm256_and_ps( _mm256_loadu_ps( &lanes[Array_FrameCount][i] ), valid );
+            const __m256 first = _mm256_cmp_ps( frameCount, zero, _CMP_EQ_OQ );
+            const __m256 second = _mm256_cmp_ps( frameCount, one, _CMP_EQ_OQ );
+
+            // First apply jitter filter
+            const __m256 jitterDiff = length( _mm256_sub_ps( raw[0], prevFiltered[0] ), _mm256_sub_ps( raw[1], prevFiltered[1] ), _mm256_sub_ps( raw[2], prevFiltered[2] ) );
+            const __m256 jitterRatio = _mm256_div_ps( jitterDiff, jitterRadius );
+            const __m256 jitterRatioInverse = _mm256_sub_ps( one, jitterRatio );
+            const __m256 jitter = _mm256_cmp_ps( jitterDiff, jitterRadius, _CMP_LE_OQ );
+
+            __m256 filtered[3], trend[3], predicted[3];
+            for( int c = 0; c < 3; c++ ){
+                // Later frames ( Jitter Filter and Double Exponential Smoothing Filter )
+                __m256 value = _mm256_blendv_ps( raw[c], _mm256_add_ps( _mm256_mul_ps( raw[c], jitterRatio ), _mm256_mul_ps( prevFiltered[c], jitterRatioInverse ) ), jitter );
+                value = _mm256_add_ps( _mm256_mul_ps( value, smoothingInverse ), _mm256_mul_ps( _mm256_add_ps( prevFiltered[c], prevTrend[c] ), smoothing ) );
+
+                // Second frame
+                value = _mm256_blendv_ps( value, _mm256_mul_ps( _mm256_add_ps( raw[c], prevRaw[c] ), half ), second );
+
+                // Initial start values
+                filtered[c] = _mm256_blendv_ps( value, raw[c], first );
+                trend[c] = _mm256_add_ps( _mm256_mul_ps( _mm256_sub_ps( filtered[c], prevFiltered[c] ), correction ), _mm256_mul_ps( prevTrend[c], correctionInverse ) );
+                trend[c] = _mm256_andnot_ps( first, trend[c] );
+
+                // Predict into the future to reduce latency
+                predicted[c] = _mm256_add_ps( filtered[c], _mm256_mul_ps( trend[c], prediction ) );
+            }
+
+            // Check that we are not too far away from raw data
+            const __m256 deviationDiff = length( _mm256_sub_ps( predicted[0], raw[0] ), _mm256_sub_ps( predicted[1], raw[1] ), _mm256_sub_ps( predicted[2], raw[2] ) );
+            const __m256 deviation = _mm256_cmp_ps( deviationDiff, maxDeviationRadius, _CMP_GT_OQ );
+            const __m256 deviationRatio = _mm256_div_ps( maxDeviationRadius, deviationDiff );
+            const __m256 deviationRatioInverse = _mm256_sub_ps( one, deviationRatio );
+            for( int c = 0; c < 3; c++ ){
+                predicted[c] = _mm256_blendv_ps( predicted[c], _mm256_add_ps( _mm256_mul_ps( predicted[c], deviationRatio ), _mm256_mul_ps( raw[c], deviationRatioInverse ) ), deviation );
+            }
+
+            // Save the data from this frame and Output the data
+            for( int c = 0; c < 3; c++ ){
+                _mm256_storeu_ps( &lanes[Array_RawX + c][i], raw[c] );
+                _mm256_storeu_ps( &lanes[Array_FilteredX + c][i], filtered[c] );
+                _mm256_storeu_ps( &lanes[Array_TrendX + c][i], trend[c] );
+                _mm256_storeu_ps( &lanes[Array_OutputX + c][i], predicted[c] );
+            }
+            _mm256_storeu_ps( &lanes[Array_FrameCount][i], _mm256_min_ps( _mm256_add_ps( frameCount, one ), two ) );
+        }
+    }
+
+    SIMD_TARGET_AVX2 static __m256 length( const __m256 x, const __m256 y, const __m256 z )
+    {
+        return _mm256_sqrt_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) ) );
+    }
+#endif
+};
+
+#endif // __JOINT_FILTER_BANK__
\ No newline at end of file
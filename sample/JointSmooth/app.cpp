@@ -3,6 +3,7 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 
 #include <ppl.h>
 
@@ -10,7 +11,9 @@
 #define SMOOTH
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames )
+    : sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
     // Initialize
     initialize();
@@ -26,23 +29,21 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
-        }
-    }
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){ return sink->poll() && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames ); }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -97,8 +98,11 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Body
@@ -109,24 +113,25 @@ inline void Kinect::initializeBody()
     ERROR_CHECK( kinect->get_BodyFrameSource( &bodyFrameSource ) );
     ERROR_CHECK( bodyFrameSource->OpenReader( &bodyFrameReader ) );
 
-    // Initialize Body Buffer
-    Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
-        SafeRelease( body );
+    // Initialize Body Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        Concurrency::parallel_for_each( frame.bodies.begin(), frame.bodies.end(), []( IBody*& body ){
+            SafeRelease( body );
+        } );
+        frame.bodyUpdated = false;
     } );
 
 #ifdef SMOOTH
     // Set Smoothing Fileter Parameters
-    Sample::TRANSFORM_SMOOTH_PARAMETERS smoothingParams;
-    smoothingParams.fSmoothing          = 0.25f; // [0..1], lower values closer to raw data
-    smoothingParams.fCorrection         = 0.25f; // [0..1], lower values slower to correct towards the raw data
-    smoothingParams.fPrediction         = 0.25f; // [0..n], the number of frames to predict into the future
-    smoothingParams.fJitterRadius       = 0.03f; // The radius in meters for jitter reduction
-    smoothingParams.fMaxDeviationRadius = 0.05f; // The maximum radius in meters that filtered positions are allowed to deviate from raw data
-
-    // Create Holt Double Exponential Smoothing Filter
-    for( Sample::FilterDoubleExponential filter : filters ){
-        filter.Init( smoothingParams.fSmoothing, smoothingParams.fCorrection, smoothingParams.fPrediction, smoothingParams.fJitterRadius, smoothingParams.fMaxDeviationRadius );
-    }
+    JointFilterParameters smoothingParams;
+    smoothingParams.smoothing          = 0.25f; // [0..1], lower values closer to raw data
+    smoothingParams.correction         = 0.25f; // [0..1], lower values slower to correct towards the raw data
+    smoothingParams.prediction         = 0.25f; // [0..n], the number of frames to predict into the future
+    smoothingParams.jitterRadius       = 0.03f; // The radius in meters for jitter reduction
+    smoothingParams.maxDeviationRadius = 0.05f; // The maximum radius in meters that filtered positions are allowed to deviate from raw data
+
+    // Initialize Holt Double Exponential Smoothing Filter of All Bodies
+    filter.initialize( smoothingParams );
 #endif
 
     // Color Table for Visualization
@@ -143,9 +148,11 @@ void Kinect::finalize()
 {
     cv::destroyAllWindows();
 
-    // Release Body Buffer
-    Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
-        SafeRelease( body );
+    // Release Body Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        Concurrency::parallel_for_each( frame.bodies.begin(), frame.bodies.end(), []( IBody*& body ){
+            SafeRelease( body );
+        } );
     } );
 
     // Close Sensor
@@ -155,17 +162,26 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Body
-    updateBody();
+    updateBody( frame );
+
+    // Wait until Both Color and Body are Updated
+    if( !frame.colorUpdated || !frame.bodyUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.bodyUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -175,11 +191,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Body
-inline void Kinect::updateBody()
+inline void Kinect::updateBody( Frame& frame )
 {
     // Retrieve Body Frame
     ComPtr<IBodyFrame> bodyFrame;
@@ -188,77 +205,93 @@ inline void Kinect::updateBody()
         return;
     }
 
-    // Release Previous Bodies
+    // Release Previous Bodies of This Frame
+    std::array<IBody*, BODY_COUNT>& bodies = frame.bodies;
     Concurrency::parallel_for_each( bodies.begin(), bodies.end(), []( IBody*& body ){
         SafeRelease( body );
     } );
 
     // Retrieve Body Data
     ERROR_CHECK( bodyFrame->GetAndRefreshBodyData( BODY_COUNT, &bodies[0] ) );
+    frame.bodyUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Body
-    drawBody();
+    drawBody( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
     // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    frame.colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &frame.colorBuffer[0] );
 }
 
 // Draw Body
-inline void Kinect::drawBody()
+inline void Kinect::drawBody( Frame& frame )
 {
-    // Draw Body Data to Color Data
-    Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
+    const std::array<IBody*, BODY_COUNT>& bodies = frame.bodies;
+    cv::Mat& colorMat = frame.colorMat;
+
+    // Retrieve Joints of Tracked Bodies
+    std::array<std::array<Joint, JointType::JointType_Count>, BODY_COUNT> bodyJoints;
+    std::array<bool, BODY_COUNT> bodyTracked = { false };
+    for( int count = 0; count < BODY_COUNT; count++ ){
         const ComPtr<IBody> body = bodies[count];
         if( body == nullptr ){
-            return;
+            continue;
         }
 
         // Check Body Tracked
         BOOLEAN tracked = FALSE;
         ERROR_CHECK( body->get_IsTracked( &tracked ) );
         if( !tracked ){
-            return;
+            continue;
         }
 
         // Retrieve Joints
-        std::array<Joint, JointType::JointType_Count> joints;
-        ERROR_CHECK( body->GetJoints( JointType::JointType_Count, &joints[0] ) );
+        ERROR_CHECK( body->GetJoints( JointType::JointType_Count, &bodyJoints[count][0] ) );
+        bodyTracked[count] = true;
 
 #ifdef SMOOTH
-        // Update Joints
-        Sample::FilterDoubleExponential filter = filters[count];
-        filter.Update( &joints[0] );
+        // Set Joints to Filter ( Filter State is Kept while Same Tracking ID )
+        UINT64 trackingId;
+        ERROR_CHECK( body->get_TrackingId( &trackingId ) );
+        filter.setJoints( count, trackingId, &bodyJoints[count][0] );
+#endif
+    }
+
+#ifdef SMOOTH
+    // Update Joints of All Bodies
+    filter.update();
+#endif
+
+    // Draw Body Data to Color Data
+    Concurrency::parallel_for( 0, BODY_COUNT, [&]( const int count ){
+        if( !bodyTracked[count] ){
+            return;
+        }
+        const ComPtr<IBody> body = bodies[count];
+        std::array<Joint, JointType::JointType_Count>& joints = bodyJoints[count];
 
+#ifdef SMOOTH
         // Retrive Filtered Joints
-        const DirectX::XMVECTOR* filteredJoints = filter.GetFilteredJoints();
+        filter.getJoints( count, &joints[0] );
 #endif
 
         Concurrency::parallel_for( 0, static_cast<int>( JointType::JointType_Count ), [&]( const int type ){
             // Check Joint Tracked
-            Joint joint = joints[type];
+            const Joint joint = joints[type];
             if( joint.TrackingState == TrackingState::TrackingState_NotTracked ){
                 return;
             }
 
-#ifdef SMOOTH
-            // Retrive Filtered Joint
-            const DirectX::XMVECTOR filteredJoint = filteredJoints[type];
-            DirectX::XMVectorGetXPtr( &joint.Position.X, filteredJoint );
-            DirectX::XMVectorGetYPtr( &joint.Position.Y, filteredJoint );
-            DirectX::XMVectorGetZPtr( &joint.Position.Z, filteredJoint );
-#endif
-
             // Draw Joint Position
             drawEllipse( colorMat, joint, 5, colors[count] );
 
@@ -348,15 +381,16 @@ inline void Kinect::drawHandState( cv::Mat& image, const Joint& joint, HandState
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Body
-    showBody();
+    showBody( frame );
 }
 
 // Show Body
-inline void Kinect::showBody()
+inline void Kinect::showBody( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
@@ -367,5 +401,5 @@ inline void Kinect::showBody()
     cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
 
     // Show Image
-    cv::imshow( "JointSmooth", resizeMat );
+    sink->write( "JointSmooth", resizeMat );
 }
\ No newline at end of file
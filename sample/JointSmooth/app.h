@@ -3,14 +3,18 @@
 
 #include <Windows.h>
 #include <Kinect.h>
-// Quote from MSDN Forums - Joint Smoothing code, and Partial Modification
+// Port of MSDN Forums - Joint Smoothing code ( KinectJointFilter ) to Structure of Arrays
 // KinectJointFilter is: Copyright (c) Microsoft Corporation. All rights reserved.
 // https://social.msdn.microsoft.com/Forums/en-US/045b058a-ae3a-4d01-beb6-b756631b4b42
-#include "KinectJointFilter.h"
+#include "JointFilterBank.h"
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
 
 #include <vector>
 #include <array>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -29,22 +33,38 @@ private:
     ComPtr<IBodyFrameReader> bodyFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Body Buffer
-    std::array<IBody*, BODY_COUNT> bodies = { nullptr };
     std::array<cv::Vec3b, BODY_COUNT> colors;
 
-    // Smoothing Filter
-    std::array<Sample::FilterDoubleExponential, BODY_COUNT> filters;
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Body are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::array<IBody*, BODY_COUNT> bodies = { nullptr };
+        bool colorUpdated;
+        bool bodyUpdated;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
+
+    // Smoothing Filter ( All Bodies )
+    JointFilterBank filter;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink() )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0 );
 
     // Destructor
     ~Kinect();
@@ -69,22 +89,22 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Body
-    inline void updateBody();
+    inline void updateBody( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Body
-    inline void drawBody();
+    inline void drawBody( Frame& frame );
 
     // Draw Smooth
     inline void drawSmooth();
@@ -96,10 +116,10 @@ private:
     inline void drawHandState( cv::Mat& image, const Joint& joint, HandState handState, TrackingConfidence handConfidence );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Body
-    inline void showBody();
+    inline void showBody( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -0,0 +1,870 @@
+#include "DepthCodec.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    const uint32_t codecMagic = 0x3243444b; // 'KDC2'
+
+    // Huffman Code
+    const int symbolCount = 256;
+    const int maxCodeLength = 12;
+    const int literalCount = 238;
+    const int escapeSymbol = 238;
+    const int runSymbol = 239;
+    const uint32_t maxRun = ( 1u << 18 ) - 1;
+    const size_t lengthBytes = symbolCount / 2;
+
+    // Row Prediction Mode ( 2 bits per Row )
+    enum RowMode
+    {
+        RowMode_Gradient = 0, // Left + Up - Upper Left
+        RowMode_Temporal = 1, // Previous Frame
+        RowMode_Left = 2,     // Left ( First Pixel from Up )
+        RowMode_Up = 3        // Up
+    };
+
+    inline size_t modeBytes( const int height )
+    {
+        return ( height + 3 ) / 4;
+    }
+
+    inline int rowMode( const uint8_t* modes, const int y )
+    {
+        return ( modes[y >> 2] >> ( ( y & 3 ) * 2 ) ) & 3;
+    }
+
+    // Zigzag ( -1 -> 1, 1 -> 2, -2 -> 3, ... )
+    inline uint16_t zigzag( const uint16_t difference )
+    {
+        const int16_t value = static_cast<int16_t>( difference );
+        return static_cast<uint16_t>( ( static_cast<uint16_t>( value ) << 1 ) ^ static_cast<uint16_t>( value >> 15 ) );
+    }
+
+    inline uint16_t unzigzag( const uint16_t value )
+    {
+        return static_cast<uint16_t>( ( value >> 1 ) ^ static_cast<uint16_t>( -( value & 1 ) ) );
+    }
+
+    // Floor of Log2 ( value > 0 )
+    inline int floorLog2( uint32_t value )
+    {
+        int log = 0;
+        while( value >>= 1 ){
+            log++;
+        }
+        return log;
+    }
+
+    // Cost of Residual ( Approximate Code Length, Zero is Free as Zero Runs are Coded Once per Run )
+    struct BitLengthTable
+    {
+        uint8_t lengths[256];
+
+        BitLengthTable()
+        {
+            lengths[0] = 0;
+            for( uint32_t value = 1; value < 256; value++ ){
+                lengths[value] = static_cast<uint8_t>( floorLog2( value ) + 2 );
+            }
+        }
+    };
+    const BitLengthTable bitLengthTable;
+
+    inline uint32_t bitLength( const uint16_t value )
+    {
+        return ( value < 256 ) ? bitLengthTable.lengths[value] : bitLengthTable.lengths[value >> 8] + 8u;
+    }
+
+    // Token ( Symbol : 8 bits, Number of Extra Bits : 5 bits, Extra Bits : 19 bits )
+    inline uint32_t makeToken( const uint32_t symbol, const uint32_t extraBits = 0, const uint32_t extra = 0 )
+    {
+        return symbol | ( extraBits << 8 ) | ( extra << 13 );
+    }
+
+    // Variable Length Integer
+    inline void writeVarint( std::vector<uint8_t>& buffer, uint32_t value )
+    {
+        while( value >= 0x80 ){
+            buffer.push_back( static_cast<uint8_t>( value | 0x80 ) );
+            value >>= 7;
+        }
+        buffer.push_back( static_cast<uint8_t>( value ) );
+    }
+
+    inline uint32_t readVarint( const uint8_t*& data, const uint8_t* end )
+    {
+        uint32_t value = 0;
+        for( int shift = 0; shift < 35; shift += 7 ){
+            if( data == end ){
+                throw std::runtime_error( "corrupted depth codec mask" );
+            }
+            const uint8_t byte = *data++;
+            value |= static_cast<uint32_t>( byte & 0x7f ) << shift;
+            if( ( byte & 0x80 ) == 0 ){
+                return value;
+            }
+        }
+        throw std::runtime_error( "corrupted depth codec mask" );
+    }
+
+    // Build Length Limited Huffman Code Lengths
+    void buildCodeLengths( const uint32_t* histogram, uint8_t* lengths )
+    {
+        std::vector<uint64_t> frequencies( histogram, histogram + symbolCount );
+        std::fill( lengths, lengths + symbolCount, static_cast<uint8_t>( 0 ) );
+
+        std::vector<int> symbols;
+        for( int symbol = 0; symbol < symbolCount; symbol++ ){
+            if( frequencies[symbol] > 0 ){
+                symbols.push_back( symbol );
+            }
+        }
+
+        if( symbols.empty() ){
+            return;
+        }
+
+        if( symbols.size() == 1 ){
+            lengths[symbols[0]] = 1;
+            return;
+        }
+
+        const int leaves = static_cast<int>( symbols.size() );
+        std::vector<int> parents( 2 * leaves - 1 );
+        std::vector<int> depths( 2 * leaves - 1 );
+        while( true ){
+            // Merge Two Lightest Nodes until Root
+            typedef std::pair<uint64_t, int> Node;
+            std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+            for( int i = 0; i < leaves; i++ ){
+                queue.push( Node( frequencies[symbols[i]], i ) );
+            }
+
+            int next = leaves;
+            while( queue.size() > 1 ){
+                const Node a = queue.top();
+                queue.pop();
+                const Node b = queue.top();
+                queue.pop();
+                parents[a.second] = next;
+                parents[b.second] = next;
+                queue.push( Node( a.first + b.first, next++ ) );
+            }
+
+            // Depth of Nodes ( Parent is always Created after Children )
+            int maxDepth = 0;
+            depths[next - 1] = 0;
+            for( int i = next - 2; i >= 0; i-- ){
+                depths[i] = depths[parents[i]] + 1;
+                if( i < leaves ){
+                    maxDepth = std::max( maxDepth, depths[i] );
+                }
+            }
+
+            if( maxDepth <= maxCodeLength ){
+                for( int i = 0; i < leaves; i++ ){
+                    lengths[symbols[i]] = static_cast<uint8_t>( depths[i] );
+                }
+                return;
+            }
+
+            // Flatten Distribution and Retry
+            for( int i = 0; i < leaves; i++ ){
+                frequencies[symbols[i]] = ( frequencies[symbols[i]] + 1 ) / 2;
+            }
+        }
+    }
+
+    // Build Canonical Huffman Codes ( Bit Reversed for LSB-First Bit Stream )
+    void buildCodes( const uint8_t* lengths, uint16_t* codes )
+    {
+        int counts[maxCodeLength + 1] = {};
+        for( int symbol = 0; symbol < symbolCount; symbol++ ){
+            counts[lengths[symbol]]++;
+        }
+        counts[0] = 0;
+
+        int nexts[maxCodeLength + 1] = {};
+        int code = 0;
+        for( int length = 1; length <= maxCodeLength; length++ ){
+            code = ( code + counts[length - 1] ) << 1;
+            nexts[length] = code;
+        }
+
+        for( int symbol = 0; symbol < symbolCount; symbol++ ){
+            const int length = lengths[symbol];
+            if( length == 0 ){
+                codes[symbol] = 0;
+                continue;
+            }
+
+            const int canonical = nexts[length]++;
+            int reversed = 0;
+            for( int bit = 0; bit < length; bit++ ){
+                reversed |= ( ( canonical >> bit ) & 1 ) << ( length - 1 - bit );
+            }
+            codes[symbol] = static_cast<uint16_t>( reversed );
+        }
+    }
+
+    // Bit Writer ( LSB-First )
+    class BitWriter
+    {
+    private:
+        std::vector<uint8_t>& buffer;
+        uint64_t bits;
+        int count;
+
+    public:
+        explicit BitWriter( std::vector<uint8_t>& buffer )
+            : buffer( buffer ), bits( 0 ), count( 0 )
+        {
+        }
+
+        inline void put( const uint32_t value, const int length )
+        {
+            bits |= static_cast<uint64_t>( value ) << count;
+            count += length;
+            if( count >= 32 ){
+                const uint32_t word = static_cast<uint32_t>( bits );
+                const uint8_t bytes[4] = { static_cast<uint8_t>( word ), static_cast<uint8_t>( word >> 8 ), static_cast<uint8_t>( word >> 16 ), static_cast<uint8_t>( word >> 24 ) };
+                buffer.insert( buffer.end(), bytes, bytes + 4 );
+                bits >>= 32;
+                count -= 32;
+            }
+        }
+
+        inline void flush()
+        {
+            while( count > 0 ){
+                buffer.push_back( static_cast<uint8_t>( bits ) );
+                bits >>= 8;
+                count -= 8;
+            }
+            bits = 0;
+            count = 0;
+        }
+    };
+
+    // Bit Reader ( LSB-First, Reads Zero Past End )
+    class BitReader
+    {
+    private:
+        const uint8_t* data;
+        const uint8_t* end;
+        uint64_t bits;
+        int count;
+        size_t padding;
+
+    public:
+        BitReader( const uint8_t* data, const size_t bytes )
+            : data( data ), end( data + bytes ), bits( 0 ), count( 0 ), padding( 0 )
+        {
+        }
+
+        // Ensure at least 56 bits are Buffered
+        inline void refill()
+        {
+            if( end - data >= 8 ){
+                uint64_t word;
+                std::memcpy( &word, data, sizeof( word ) );
+                bits |= word << count;
+                const int bytes = ( 63 - count ) >> 3;
+                data += bytes;
+                count += bytes << 3;
+                return;
+            }
+
+            while( count <= 56 ){
+                if( data < end ){
+                    bits |= static_cast<uint64_t>( *data++ ) << count;
+                }
+                else{
+                    padding++;
+                }
+                count += 8;
+            }
+        }
+
+        inline uint32_t peek( const int length ) const
+        {
+            return static_cast<uint32_t>( bits & ( ( 1ull << length ) - 1 ) );
+        }
+
+        inline void consume( const int length )
+        {
+            bits >>= length;
+            count -= length;
+        }
+
+        // Check Reader did not Consume Padding
+        bool overrun() const
+        {
+            return static_cast<size_t>( count ) < padding * 8;
+        }
+    };
+
+    // Reconstruct Spatial Row ( Prefix Sum of Residuals from Base + Upper Row )
+    void reconstructSpatialScalar( const uint16_t* residuals, const uint16_t* up, uint16_t* row, const int begin, const int end, uint16_t sum )
+    {
+        for( int x = begin; x < end; x++ ){
+            sum = static_cast<uint16_t>( sum + unzigzag( residuals[x] ) );
+            row[x] = static_cast<uint16_t>( ( up != nullptr ? up[x] : 0 ) + sum );
+        }
+    }
+
+    // Reconstruct Temporal Row ( Previous Frame + Residuals )
+    void reconstructTemporalScalar( const uint16_t* residuals, uint16_t* row, const int begin, const int end )
+    {
+        for( int x = begin; x < end; x++ ){
+            row[x] = static_cast<uint16_t>( row[x] + unzigzag( residuals[x] ) );
+        }
+    }
+
+#ifdef SIMD_X86
+    // Reconstruct Spatial Row ( SSE4.1, 8 Pixels )
+    SIMD_TARGET_SSE41
+    void reconstructSpatialSSE41( const uint16_t* residuals, const uint16_t* up, uint16_t* row, const int width, const uint16_t base )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16( 1 );
+        const __m128i last = _mm_set1_epi16( 0x0f0e );
+
+        __m128i carry = _mm_set1_epi16( static_cast<short>( base ) );
+        int x = 0;
+        for( ; x + 8 <= width; x += 8 ){
+            // Unzigzag
+            const __m128i z = _mm_loadu_si128( reinterpret_cast<const __m128i*>( residuals + x ) );
+            __m128i r = _mm_xor_si128( _mm_srli_epi16( z, 1 ), _mm_sub_epi16( zero, _mm_and_si128( z, one ) ) );
+
+            // Prefix Sum
+            r = _mm_add_epi16( r, _mm_slli_si128( r, 2 ) );
+            r = _mm_add_epi16( r, _mm_slli_si128( r, 4 ) );
+            r = _mm_add_epi16( r, _mm_slli_si128( r, 8 ) );
+            const __m128i sum = _mm_add_epi16( r, carry );
+            carry = _mm_shuffle_epi8( sum, last );
+
+            // Add Upper Row
+            const __m128i u = ( up != nullptr ) ? _mm_loadu_si128( reinterpret_cast<const __m128i*>( up + x ) ) : zero;
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( row + x ), _mm_add_epi16( sum, u ) );
+        }
+
+        reconstructSpatialScalar( residuals, up, row, x, width, static_cast<uint16_t>( _mm_extract_epi16( carry, 0 ) ) );
+    }
+
+    // Reconstruct Temporal Row ( SSE4.1, 8 Pixels )
+    SIMD_TARGET_SSE41
+    void reconstructTemporalSSE41( const uint16_t* residuals, uint16_t* row, const int width )
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16( 1 );
+
+        int x = 0;
+        for( ; x + 8 <= width; x += 8 ){
+            const __m128i z = _mm_loadu_si128( reinterpret_cast<const __m128i*>( residuals + x ) );
+            const __m128i r = _mm_xor_si128( _mm_srli_epi16( z, 1 ), _mm_sub_epi16( zero, _mm_and_si128( z, one ) ) );
+            const __m128i p = _mm_loadu_si128( reinterpret_cast<const __m128i*>( row + x ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( row + x ), _mm_add_epi16( p, r ) );
+        }
+
+        reconstructTemporalScalar( residuals, row, x, width );
+    }
+
+    // Reconstruct Spatial Row ( AVX2, 16 Pixels )
+    SIMD_TARGET_AVX2
+    void reconstructSpatialAVX2( const uint16_t* residuals, const uint16_t* up, uint16_t* row, const int width, const uint16_t base )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi16( 1 );
+        const __m256i last = _mm256_set1_epi16( 0x0f0e );
+
+        __m256i carry = _mm256_set1_epi16( static_cast<short>( base ) );
+        int x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            // Unzigzag
+            const __m256i z = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( residuals + x ) );
+            __m256i r = _mm256_xor_si256( _mm256_srli_epi16( z, 1 ), _mm256_sub_epi16( zero, _mm256_and_si256( z, one ) ) );
+
+            // Prefix Sum in each 128 bits Lane, then Carry Lower Lane into Upper Lane
+            r = _mm256_add_epi16( r, _mm256_slli_si256( r, 2 ) );
+            r = _mm256_add_epi16( r, _mm256_slli_si256( r, 4 ) );
+            r = _mm256_add_epi16( r, _mm256_slli_si256( r, 8 ) );
+            const __m256i lane = _mm256_shuffle_epi8( r, last );
+            r = _mm256_add_epi16( r, _mm256_permute2x128_si256( lane, lane, 0x08 ) );
+            const __m256i sum = _mm256_add_epi16( r, carry );
+            carry = _mm256_permute4x64_epi64( _mm256_shuffle_epi8( sum, last ), 0xff );
+
+            // Add Upper Row
+            const __m256i u = ( up != nullptr ) ? _mm256_loadu_si256( reinterpret_cast<const __m256i*>( up + x ) ) : zero;
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( row + x ), _mm256_add_epi16( sum, u ) );
+        }
+
+        reconstructSpatialScalar( residuals, up, row, x, width, static_cast<uint16_t>( _mm_extract_epi16( _mm256_castsi256_si128( carry ), 0 ) ) );
+    }
+
+    // Reconstruct Temporal Row ( AVX2, 16 Pixels )
+    SIMD_TARGET_AVX2
+    void reconstructTemporalAVX2( const uint16_t* residuals, uint16_t* row, const int width )
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi16( 1 );
+
+        int x = 0;
+        for( ; x + 16 <= width; x += 16 ){
+            const __m256i z = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( residuals + x ) );
+            const __m256i r = _mm256_xor_si256( _mm256_srli_epi16( z, 1 ), _mm256_sub_epi16( zero, _mm256_and_si256( z, one ) ) );
+            const __m256i p = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( row + x ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( row + x ), _mm256_add_epi16( p, r ) );
+        }
+
+        reconstructTemporalScalar( residuals, row, x, width );
+    }
+#endif
+
+    // Reconstruct Row
+    inline void reconstructSpatial( const uint16_t* residuals, const uint16_t* up, uint16_t* row, const int width, const uint16_t base )
+    {
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            reconstructSpatialAVX2( residuals, up, row, width, base );
+            return;
+        }
+
+        if( IsSupportedSSE41() ){
+            reconstructSpatialSSE41( residuals, up, row, width, base );
+            return;
+        }
+#endif
+
+        reconstructSpatialScalar( residuals, up, row, 0, width, base );
+    }
+
+    inline void reconstructTemporal( const uint16_t* residuals, uint16_t* row, const int width )
+    {
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            reconstructTemporalAVX2( residuals, row, width );
+            return;
+        }
+
+        if( IsSupportedSSE41() ){
+            reconstructTemporalSSE41( residuals, row, width );
+            return;
+        }
+#endif
+
+        reconstructTemporalScalar( residuals, row, 0, width );
+    }
+
+    // Predict Spatial Row ( Invalid Pixels are Filled with Prediction, Returns Cost of Residuals )
+    uint64_t predictSpatial( const int mode, const uint16_t* src, const uint16_t* up, uint16_t* row, uint16_t* residuals, const int width )
+    {
+        uint64_t cost = 0;
+        for( int x = 0; x < width; x++ ){
+            uint16_t prediction;
+            if( x == 0 || mode == RowMode_Up ){
+                prediction = ( up != nullptr ) ? up[x] : 0;
+            }
+            else if( mode == RowMode_Left || up == nullptr ){
+                prediction = row[x - 1];
+            }
+            else{
+                prediction = static_cast<uint16_t>( row[x - 1] + up[x] - up[x - 1] );
+            }
+
+            row[x] = ( src[x] != 0 ) ? src[x] : prediction;
+            residuals[x] = zigzag( static_cast<uint16_t>( row[x] - prediction ) );
+            cost += bitLength( residuals[x] );
+        }
+        return cost;
+    }
+}
+
+// Constructor
+DepthEncoder::DepthEncoder()
+    : width( 0 ), height( 0 ), keyFrameInterval( 30 ), frameCount( 0 )
+{
+}
+
+DepthEncoder::DepthEncoder( const int width, const int height, const int keyFrameInterval )
+    : width( 0 ), height( 0 ), keyFrameInterval( 30 ), frameCount( 0 )
+{
+    initialize( width, height, keyFrameInterval );
+}
+
+// Initialize
+void DepthEncoder::initialize( const int width, const int height, const int keyFrameInterval )
+{
+    if( width <= 0 || height <= 0 || 0xffff < width || 0xffff < height || keyFrameInterval <= 0 ){
+        throw std::invalid_argument( "invalid depth codec parameters" );
+    }
+
+    this->width = width;
+    this->height = height;
+    this->keyFrameInterval = keyFrameInterval;
+    frameCount = 0;
+
+    reference.assign( width * height, 0 );
+    residuals.resize( width * height );
+    spatialRow.resize( width );
+    spatialResiduals.resize( width );
+    candidateRow.resize( width );
+    candidateResiduals.resize( width );
+    modes.resize( modeBytes( height ) );
+    tokens.reserve( width * height );
+}
+
+// Force Next Frame to be Key Frame
+void DepthEncoder::reset()
+{
+    frameCount = 0;
+}
+
+// Encode Frame
+size_t DepthEncoder::encode( const uint16_t* depth, std::vector<uint8_t>& encoded )
+{
+    if( width == 0 ){
+        throw std::runtime_error( "depth encoder is not initialized" );
+    }
+
+    const bool keyFrame = ( frameCount % keyFrameInterval ) == 0;
+    frameCount = keyFrame ? 1 : frameCount + 1;
+
+    // Predict Rows
+    std::fill( modes.begin(), modes.end(), static_cast<uint8_t>( 0 ) );
+    for( int y = 0; y < height; y++ ){
+        const uint16_t* src = depth + y * width;
+        uint16_t* row = &reference[y * width];
+        const uint16_t* up = ( y > 0 ) ? row - width : nullptr;
+        uint16_t* dst = &residuals[y * width];
+
+        // Spatial ( Cheapest of Gradient, Left and Up Predictor, Invalid Pixels are Filled with Prediction )
+        int spatialMode = RowMode_Gradient;
+        uint64_t spatialCost = predictSpatial( RowMode_Gradient, src, up, &spatialRow[0], &spatialResiduals[0], width );
+        if( up != nullptr ){
+            const int candidates[] = { RowMode_Left, RowMode_Up };
+            for( const int candidate : candidates ){
+                const uint64_t cost = predictSpatial( candidate, src, up, &candidateRow[0], &candidateResiduals[0], width );
+                if( cost < spatialCost ){
+                    spatialMode = candidate;
+                    spatialCost = cost;
+                    spatialRow.swap( candidateRow );
+                    spatialResiduals.swap( candidateResiduals );
+                }
+            }
+        }
+
+        // Temporal ( Previous Frame, Invalid Pixels are Filled with Previous Frame )
+        if( !keyFrame ){
+            uint64_t temporalCost = 0;
+            for( int x = 0; x < width && temporalCost < spatialCost; x++ ){
+                if( src[x] != 0 ){
+                    temporalCost += bitLength( zigzag( static_cast<uint16_t>( src[x] - row[x] ) ) );
+                }
+            }
+
+            if( temporalCost < spatialCost ){
+                modes[y >> 2] |= static_cast<uint8_t>( RowMode_Temporal << ( ( y & 3 ) * 2 ) );
+                for( int x = 0; x < width; x++ ){
+                    if( src[x] != 0 ){
+                        dst[x] = zigzag( static_cast<uint16_t>( src[x] - row[x] ) );
+                        row[x] = src[x];
+                    }
+                    else{
+                        dst[x] = 0;
+                    }
+                }
+                continue;
+            }
+        }
+
+        modes[y >> 2] |= static_cast<uint8_t>( spatialMode << ( ( y & 3 ) * 2 ) );
+        std::copy( spatialRow.begin(), spatialRow.end(), row );
+        std::copy( spatialResiduals.begin(), spatialResiduals.end(), dst );
+    }
+
+    // Tokenize Residuals
+    const uint32_t total = static_cast<uint32_t>( width * height );
+    uint32_t histogram[symbolCount] = {};
+    tokens.clear();
+    for( uint32_t i = 0; i < total; ){
+        const uint16_t value = residuals[i];
+        if( value == 0 ){
+            uint32_t run = 1;
+            while( i + run < total && residuals[i + run] == 0 && run < maxRun ){
+                run++;
+            }
+
+            if( run == 1 ){
+                tokens.push_back( makeToken( 0 ) );
+                histogram[0]++;
+            }
+            else{
+                const uint32_t bits = floorLog2( run );
+                const uint32_t symbol = runSymbol + bits - 1;
+                tokens.push_back( makeToken( symbol, bits, run - ( 1u << bits ) ) );
+                histogram[symbol]++;
+            }
+            i += run;
+        }
+        else if( value < literalCount ){
+            tokens.push_back( makeToken( value ) );
+            histogram[value]++;
+            i++;
+        }
+        else{
+            tokens.push_back( makeToken( escapeSymbol, 16, value ) );
+            histogram[escapeSymbol]++;
+            i++;
+        }
+    }
+
+    // Build Huffman Code
+    uint8_t lengths[symbolCount];
+    uint16_t codes[symbolCount];
+    buildCodeLengths( histogram, lengths );
+    buildCodes( lengths, codes );
+
+    // Write Header and Row Modes
+    encoded.resize( sizeof( DepthCodecHeader ) );
+    encoded.insert( encoded.end(), modes.begin(), modes.end() );
+
+    // Write Code Lengths ( 4 bits per Symbol )
+    for( int symbol = 0; symbol < symbolCount; symbol += 2 ){
+        encoded.push_back( static_cast<uint8_t>( lengths[symbol] | ( lengths[symbol + 1] << 4 ) ) );
+    }
+
+    // Write Mask ( Alternating Run Lengths of Valid and Invalid Pixels )
+    const size_t maskBegin = encoded.size();
+    bool valid = true;
+    uint32_t run = 0;
+    for( uint32_t i = 0; i < total; i++ ){
+        if( ( depth[i] != 0 ) != valid ){
+            writeVarint( encoded, run );
+            valid = !valid;
+            run = 0;
+        }
+        run++;
+    }
+    writeVarint( encoded, run );
+    const size_t maskBytes = encoded.size() - maskBegin;
+
+    // Write Bit Stream
+    const size_t streamBegin = encoded.size();
+    BitWriter writer( encoded );
+    for( size_t i = 0; i < tokens.size(); i++ ){
+        const uint32_t token = tokens[i];
+        const uint32_t symbol = token & 0xff;
+        writer.put( codes[symbol], lengths[symbol] );
+
+        const int extraBits = static_cast<int>( ( token >> 8 ) & 0x1f );
+        if( extraBits > 0 ){
+            writer.put( token >> 13, extraBits );
+        }
+    }
+    writer.flush();
+    const size_t streamBytes = encoded.size() - streamBegin;
+
+    // Fill Header
+    DepthCodecHeader header;
+    std::memset( &header, 0, sizeof( header ) );
+    header.magic = codecMagic;
+    header.width = static_cast<uint16_t>( width );
+    header.height = static_cast<uint16_t>( height );
+    header.flags = keyFrame ? DepthCodecFlag_KeyFrame : 0;
+    header.maskBytes = static_cast<uint32_t>( maskBytes );
+    header.streamBytes = static_cast<uint32_t>( streamBytes );
+    std::memcpy( &encoded[0], &header, sizeof( header ) );
+
+    return encoded.size();
+}
+
+// Constructor
+DepthDecoder::DepthDecoder()
+    : width( 0 ), height( 0 ), hasReference( false )
+{
+    table.resize( 1 << maxCodeLength );
+}
+
+// Discard Reference Frame
+void DepthDecoder::reset()
+{
+    hasReference = false;
+}
+
+// Retrieve Frame Header
+bool DepthDecoder::readHeader( const void* data, const size_t bytes, DepthCodecHeader& header )
+{
+    if( data == nullptr || bytes < sizeof( DepthCodecHeader ) ){
+        return false;
+    }
+
+    std::memcpy( &header, data, sizeof( header ) );
+    if( header.magic != codecMagic || header.width == 0 || header.height == 0 ){
+        return false;
+    }
+
+    const uint64_t required = static_cast<uint64_t>( sizeof( DepthCodecHeader ) ) + modeBytes( header.height ) + lengthBytes + header.maskBytes + header.streamBytes;
+    return required <= bytes;
+}
+
+// Check Key Frame
+bool DepthDecoder::isKeyFrame( const void* data, const size_t bytes )
+{
+    DepthCodecHeader header;
+    return readHeader( data, bytes, header ) && ( header.flags & DepthCodecFlag_KeyFrame ) != 0;
+}
+
+// Decode Frame
+void DepthDecoder::decode( const void* data, const size_t bytes, uint16_t* depth )
+{
+    DepthCodecHeader header;
+    if( !readHeader( data, bytes, header ) ){
+        throw std::runtime_error( "invalid depth codec frame" );
+    }
+
+    // Check Reference Frame
+    const bool keyFrame = ( header.flags & DepthCodecFlag_KeyFrame ) != 0;
+    if( !keyFrame && ( !hasReference || header.width != width || header.height != height ) ){
+        throw std::runtime_error( "depth codec reference frame is missing" );
+    }
+
+    if( header.width != width || header.height != height ){
+        width = header.width;
+        height = header.height;
+        reference.resize( width * height );
+        residuals.resize( width * height );
+    }
+    hasReference = false;
+
+    const uint8_t* modes = static_cast<const uint8_t*>( data ) + sizeof( DepthCodecHeader );
+    const uint8_t* lengths = modes + modeBytes( height );
+    const uint8_t* mask = lengths + lengthBytes;
+    const uint8_t* stream = mask + header.maskBytes;
+
+    // Build Decoding Table ( Symbol << 4 | Length )
+    std::fill( table.begin(), table.end(), static_cast<uint16_t>( 0 ) );
+    uint8_t codeLengths[symbolCount];
+    uint32_t kraft = 0;
+    for( int symbol = 0; symbol < symbolCount; symbol++ ){
+        codeLengths[symbol] = ( lengths[symbol >> 1] >> ( ( symbol & 1 ) * 4 ) ) & 0x0f;
+        if( maxCodeLength < codeLengths[symbol] ){
+            throw std::runtime_error( "corrupted depth codec code lengths" );
+        }
+        if( codeLengths[symbol] > 0 ){
+            kraft += 1u << ( maxCodeLength - codeLengths[symbol] );
+        }
+    }
+    if( ( 1u << maxCodeLength ) < kraft ){
+        throw std::runtime_error( "corrupted depth codec code lengths" );
+    }
+
+    uint16_t codes[symbolCount];
+    buildCodes( codeLengths, codes );
+    for( int symbol = 0; symbol < symbolCount; symbol++ ){
+        const int length = codeLengths[symbol];
+        if( length == 0 ){
+            continue;
+        }
+
+        const uint16_t entry = static_cast<uint16_t>( ( symbol << 4 ) | length );
+        for( int i = codes[symbol]; i < ( 1 << maxCodeLength ); i += ( 1 << length ) ){
+            table[i] = entry;
+        }
+    }
+
+    // Decode Residuals
+    const uint32_t total = static_cast<uint32_t>( width * height );
+    uint16_t* dst = &residuals[0];
+    BitReader reader( stream, header.streamBytes );
+    for( uint32_t i = 0; i < total; ){
+        reader.refill();
+        const uint16_t entry = table[reader.peek( maxCodeLength )];
+        const int length = entry & 0x0f;
+        if( length == 0 ){
+            throw std::runtime_error( "corrupted depth codec stream" );
+        }
+        reader.consume( length );
+
+        const int symbol = entry >> 4;
+        if( symbol < literalCount ){
+            dst[i++] = static_cast<uint16_t>( symbol );
+        }
+        else if( symbol == escapeSymbol ){
+            dst[i++] = static_cast<uint16_t>( reader.peek( 16 ) );
+            reader.consume( 16 );
+        }
+        else{
+            const int bits = symbol - runSymbol + 1;
+            const uint32_t run = ( 1u << bits ) + reader.peek( bits );
+            reader.consume( bits );
+            if( total - i < run ){
+                throw std::runtime_error( "corrupted depth codec stream" );
+            }
+            std::memset( dst + i, 0, run * sizeof( uint16_t ) );
+            i += run;
+        }
+    }
+
+    if( reader.overrun() ){
+        throw std::runtime_error( "corrupted depth codec stream" );
+    }
+
+    // Reconstruct Rows into Reference Frame
+    for( int y = 0; y < height; y++ ){
+        uint16_t* row = &reference[y * width];
+        const uint16_t* src = &residuals[y * width];
+        const uint16_t* up = ( y > 0 ) ? row - width : nullptr;
+        switch( rowMode( modes, y ) ){
+        case RowMode_Temporal:
+            if( keyFrame ){
+                throw std::runtime_error( "corrupted depth codec row modes" );
+            }
+            reconstructTemporal( src, row, width );
+            break;
+        case RowMode_Left:
+            reconstructSpatial( src, nullptr, row, width, ( up != nullptr ) ? up[0] : 0 );
+            break;
+        case RowMode_Up:
+            if( up != nullptr ){
+                std::memcpy( row, up, width * sizeof( uint16_t ) );
+            }
+            else{
+                std::memset( row, 0, width * sizeof( uint16_t ) );
+            }
+            reconstructTemporal( src, row, width );
+            break;
+        default:
+            reconstructSpatial( src, up, row, width, 0 );
+            break;
+        }
+    }
+
+    // Apply Mask
+    std::memcpy( depth, &reference[0], total * sizeof( uint16_t ) );
+    const uint8_t* maskEnd = mask + header.maskBytes;
+    bool valid = true;
+    uint32_t i = 0;
+    while( mask < maskEnd ){
+        const uint32_t run = readVarint( mask, maskEnd );
+        if( total - i < run ){
+            throw std::runtime_error( "corrupted depth codec mask" );
+        }
+        if( !valid ){
+            std::memset( depth + i, 0, run * sizeof( uint16_t ) );
+        }
+        i += run;
+        valid = !valid;
+    }
+    if( i != total ){
+        throw std::runtime_error( "corrupted depth codec mask" );
+    }
+
+    hasReference = true;
+}
\ No newline at end of file
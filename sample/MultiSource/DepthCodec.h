@@ -0,0 +1,120 @@
+#ifndef __DEPTH_CODEC__
+#define __DEPTH_CODEC__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Lossless Depth Codec ( UINT16 Depth Frame, e.g. 512 x 424 )
+//
+// Prediction
+//   Each row is predicted either spatially ( Gradient left + up - upleft, Left or Up Predictor ) or temporally ( Previous Frame ).
+//   The encoder selects the cheapest predictor per row. Key frames use only spatial prediction.
+//   Gradient suits smooth surfaces, Left and Up have half the noise of Gradient on noisy far surfaces.
+//   Invalid pixels ( 0 ) are stored as a run-length mask and are replaced by their prediction, so they cost nothing in the residuals.
+//
+// Entropy Coding
+//   Zigzag residuals are coded with a canonical Huffman code ( max 12 bits ) of 256 symbols.
+//   0-237 : Literal Residual
+//   238   : Escape ( Followed by 16 bits Residual )
+//   239-  : Zero Run ( Length 2^(k+1) + Extra, k+1 Extra bits )
+//
+// Decoding
+//   Entropy decoding writes zigzag residuals, the reconstruction ( prefix sum of row + upper row, or previous frame or upper row + residual ) runs with SSE4.1/AVX2.
+//   Encoder and decoder are stateful, encoded frames of the same stream must be decoded in order starting from a key frame.
+
+#pragma pack( push, 1 )
+// Encoded Frame Header
+struct DepthCodecHeader
+{
+    uint32_t magic;        // 'KDC2'
+    uint16_t width;
+    uint16_t height;
+    uint8_t flags;         // DepthCodecFlag
+    uint8_t reserved[3];
+    uint32_t maskBytes;    // Size of Mask Runs
+    uint32_t streamBytes;  // Size of Huffman Bit Stream
+};
+#pragma pack( pop )
+
+// Encoded Frame Flag
+enum DepthCodecFlag
+{
+    DepthCodecFlag_KeyFrame = 1
+};
+
+// Depth Encoder
+class DepthEncoder
+{
+private:
+    int width;
+    int height;
+    int keyFrameInterval;
+    int frameCount;
+
+    // Reconstructed Previous Frame ( Invalid Pixels are Filled with Prediction )
+    std::vector<uint16_t> reference;
+
+    // Work Buffers
+    std::vector<uint16_t> residuals;
+    std::vector<uint16_t> spatialRow;
+    std::vector<uint16_t> spatialResiduals;
+    std::vector<uint16_t> candidateRow;
+    std::vector<uint16_t> candidateResiduals;
+    std::vector<uint8_t> modes;
+    std::vector<uint32_t> tokens;
+
+public:
+    // Constructor
+    DepthEncoder();
+    DepthEncoder( const int width, const int height, const int keyFrameInterval = 30 );
+
+    // Initialize ( Key Frame every keyFrameInterval Frames, 1 = Key Frame Only )
+    void initialize( const int width, const int height, const int keyFrameInterval = 30 );
+
+    // Encode Frame ( Returns Encoded Size [bytes] )
+    size_t encode( const uint16_t* depth, std::vector<uint8_t>& encoded );
+
+    // Force Next Frame to be Key Frame
+    void reset();
+
+    // Retrieve Frame Size
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+// Depth Decoder
+class DepthDecoder
+{
+private:
+    int width;
+    int height;
+    bool hasReference;
+
+    // Reconstructed Previous Frame ( Invalid Pixels are Filled with Prediction )
+    std::vector<uint16_t> reference;
+
+    // Work Buffers
+    std::vector<uint16_t> residuals;
+    std::vector<uint16_t> table;
+
+public:
+    // Constructor
+    DepthDecoder();
+
+    // Decode Frame ( depth must have width x height of Encoded Frame )
+    void decode( const void* data, const size_t bytes, uint16_t* depth );
+
+    // Discard Reference Frame ( Next Frame must be Key Frame )
+    void reset();
+
+    // Retrieve Frame Information without Decoding
+    static bool readHeader( const void* data, const size_t bytes, DepthCodecHeader& header );
+    static bool isKeyFrame( const void* data, const size_t bytes );
+
+    // Retrieve Frame Size of Last Decoded Frame
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+#endif // __DEPTH_CODEC__
\ No newline at end of file
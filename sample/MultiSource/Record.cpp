@@ -0,0 +1,686 @@
+#include "Record.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Alignment of Chunks and Payloads
+    const uint64_t alignment = 64;
+
+    const char fileMagic[8] = { 'K', '2', 'R', 'E', 'C', 0, 0, 0 };
+    const char footerMagic[8] = { 'K', '2', 'R', 'E', 'C', 'E', 'N', 'D' };
+    const uint32_t chunkMagic = 0x4843324b; // 'K2CH'
+    const uint32_t indexMagic = 0x5849324b; // 'K2IX'
+    const uint32_t version = 1;
+
+    inline uint64_t align( const uint64_t value )
+    {
+        return ( value + alignment - 1 ) & ~( alignment - 1 );
+    }
+
+    // Check Payload Size Matches Format and Frame Size of Chunk ( Payload must be inside File )
+    inline bool checkPayload( const RecordChunkHeader* chunk )
+    {
+        const uint64_t elements = static_cast<uint64_t>( chunk->width ) * chunk->height;
+        switch( chunk->format ){
+            case RecordFormat_UInt16:
+                return chunk->bytes == elements * sizeof( uint16_t );
+            case RecordFormat_UInt8:
+                return chunk->bytes == elements;
+            case RecordFormat_Bgra:
+                return chunk->bytes == elements * 4;
+            case RecordFormat_Yuy2:
+                return chunk->bytes == elements * 2;
+            case RecordFormat_Body:
+                return chunk->bytes == elements * sizeof( RecordBody );
+            case RecordFormat_Float32:
+                return chunk->bytes == elements * sizeof( float );
+            case RecordFormat_DepthCodec:
+            {
+                // Compressed Frame must have Same Frame Size as Chunk, Decoder Checks Rest of Payload
+                DepthCodecHeader header;
+                return DepthDecoder::readHeader( chunk + 1, static_cast<size_t>( chunk->bytes ), header ) && header.width == chunk->width && header.height == chunk->height;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Compare Index Entries by Timestamp
+    inline bool compareTimestamp( const RecordIndexEntry& a, const RecordIndexEntry& b )
+    {
+        return a.timestamp < b.timestamp;
+    }
+}
+
+static_assert( sizeof( RecordFileHeader ) == 64, "RecordFileHeader must be 64 bytes" );
+static_assert( sizeof( RecordChunkHeader ) == 64, "RecordChunkHeader must be 64 bytes" );
+static_assert( sizeof( RecordJoint ) == 20, "RecordJoint must have same layout as Joint" );
+
+// Constructor
+RecordWriter::RecordWriter()
+    : file( nullptr ), offset( 0 ), queuedBytes( 0 ), quit( false )
+{
+}
+
+// Destructor
+RecordWriter::~RecordWriter()
+{
+    // Close File
+    try{
+        close();
+    }
+    catch( ... ){
+    }
+}
+
+// Open File
+void RecordWriter::open( const std::string& path )
+{
+    close();
+
+    // Open File
+    file = fopen( path.c_str(), "wb" );
+    if( file == nullptr ){
+        throw std::runtime_error( "failed open recording file " + path );
+    }
+
+    // Large Stream Buffer ( Chunks are Written Sequentially )
+    buffer.resize( 4 * 1024 * 1024 );
+    setvbuf( file, &buffer[0], _IOFBF, buffer.size() );
+
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        index[stream].clear();
+    }
+
+    // Write File Header
+    RecordFileHeader header;
+    std::memset( &header, 0, sizeof( header ) );
+    std::memcpy( header.magic, fileMagic, sizeof( fileMagic ) );
+    header.version = version;
+
+    offset = 0;
+    try{
+        writeBytes( &header, sizeof( header ) );
+    }
+    catch( ... ){
+        fclose( file );
+        file = nullptr;
+        throw;
+    }
+
+    // Start Background Thread
+    queued.clear();
+    queuedBytes = 0;
+    quit = false;
+    exception = nullptr;
+    thread = std::thread( [this](){ worker(); } );
+}
+
+// Close File ( Write Queued Chunks, Index and Footer )
+void RecordWriter::close()
+{
+    if( file == nullptr ){
+        return;
+    }
+
+    // Wait until Queued Chunks are Written
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        quit = true;
+    }
+    wake.notify_all();
+    thread.join();
+
+    if( exception ){
+        fclose( file );
+        file = nullptr;
+        std::exception_ptr error = exception;
+        exception = nullptr;
+        std::rethrow_exception( error );
+    }
+
+    // Sort Index by Timestamp
+    RecordIndexHeader header;
+    std::memset( &header, 0, sizeof( header ) );
+    header.magic = indexMagic;
+    header.streams = RecordStream_Count;
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        std::stable_sort( index[stream].begin(), index[stream].end(), compareTimestamp );
+        header.begin[stream] = header.entries;
+        header.count[stream] = index[stream].size();
+        header.entries += index[stream].size();
+    }
+
+    // Write Index and Footer
+    try{
+        const uint64_t indexOffset = offset;
+        writeBytes( &header, sizeof( header ) );
+        for( int stream = 0; stream < RecordStream_Count; stream++ ){
+            if( !index[stream].empty() ){
+                writeBytes( &index[stream][0], index[stream].size() * sizeof( RecordIndexEntry ) );
+            }
+        }
+
+        RecordFileFooter footer;
+        footer.indexOffset = indexOffset;
+        std::memcpy( footer.magic, footerMagic, sizeof( footerMagic ) );
+        writeBytes( &footer, sizeof( footer ) );
+    }
+    catch( ... ){
+        fclose( file );
+        file = nullptr;
+        throw;
+    }
+
+    // Close File
+    const int ret = fclose( file );
+    file = nullptr;
+    if( ret != 0 ){
+        throw std::runtime_error( "failed close recording file" );
+    }
+}
+
+// Check Open
+bool RecordWriter::isOpen() const
+{
+    return file != nullptr;
+}
+
+// Write Frame ( Queued to Background Thread )
+void RecordWriter::write( const RecordStream stream, const RecordFormat format, const int width, const int height, const int64_t timestamp, const void* data, const size_t bytes, const float parameter0, const float parameter1 )
+{
+    if( file == nullptr ){
+        throw std::runtime_error( "recording file is not open" );
+    }
+
+    if( stream < 0 || RecordStream_Count <= stream ){
+        throw std::invalid_argument( "invalid recording stream" );
+    }
+
+    // Retrieve Free Block ( Wait while Writer is Behind )
+    const size_t chunkBytes = static_cast<size_t>( align( sizeof( RecordChunkHeader ) + bytes ) );
+    std::vector<char> block;
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        done.wait( lock, [&](){ return queuedBytes == 0 || queuedBytes + chunkBytes <= maxQueuedBytes || exception; } );
+        if( exception ){
+            std::rethrow_exception( exception );
+        }
+
+        for( size_t i = 0; i < available.size(); i++ ){
+            if( chunkBytes <= available[i].capacity() || i + 1 == available.size() ){
+                block.swap( available[i] );
+                available.erase( available.begin() + i );
+                break;
+            }
+        }
+    }
+
+    // Chunk Header
+    RecordChunkHeader header;
+    std::memset( &header, 0, sizeof( header ) );
+    header.magic = chunkMagic;
+    header.stream = static_cast<uint16_t>( stream );
+    header.format = static_cast<uint16_t>( format );
+    header.width = static_cast<uint32_t>( width );
+    header.height = static_cast<uint32_t>( height );
+    header.timestamp = timestamp;
+    header.bytes = bytes;
+    header.parameters[0] = parameter0;
+    header.parameters[1] = parameter1;
+
+    // Copy Chunk Header, Payload and Zero Padding to Block
+    block.resize( chunkBytes );
+    std::memcpy( &block[0], &header, sizeof( header ) );
+    if( bytes > 0 ){
+        std::memcpy( &block[sizeof( header )], data, bytes );
+    }
+    std::memset( &block[0] + sizeof( header ) + bytes, 0, chunkBytes - sizeof( header ) - bytes );
+
+    // Add Index Entry ( Offset is Fixed by Queue Order )
+    RecordIndexEntry entry;
+    entry.timestamp = timestamp;
+    entry.offset = offset;
+    index[stream].push_back( entry );
+    offset += chunkBytes;
+
+    // Hand Over to Background Thread
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        queuedBytes += chunkBytes;
+        queued.push_back( std::move( block ) );
+    }
+    wake.notify_one();
+}
+
+// Retrieve Number of Written Frames
+size_t RecordWriter::count( const RecordStream stream ) const
+{
+    return index[stream].size();
+}
+
+// Background Thread ( Writes Queued Chunks before Quit )
+void RecordWriter::worker()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    while( true ){
+        wake.wait( lock, [this](){ return !queued.empty() || quit; } );
+        if( queued.empty() ){
+            return;
+        }
+
+        std::vector<char> block = std::move( queued.front() );
+        queued.pop_front();
+        const bool failed = static_cast<bool>( exception );
+        lock.unlock();
+
+        // Skip Remaining Chunks after Error
+        std::exception_ptr error;
+        if( !failed && fwrite( &block[0], 1, block.size(), file ) != block.size() ){
+            error = std::make_exception_ptr( std::runtime_error( "failed write recording file" ) );
+        }
+
+        lock.lock();
+        if( error && !exception ){
+            exception = error;
+        }
+        queuedBytes -= block.size();
+        available.push_back( std::move( block ) );
+        done.notify_all();
+    }
+}
+
+// Write Bytes
+void RecordWriter::writeBytes( const void* data, const size_t bytes )
+{
+    if( bytes == 0 ){
+        return;
+    }
+
+    if( fwrite( data, 1, bytes, file ) != bytes ){
+        throw std::runtime_error( "failed write recording file" );
+    }
+
+    offset += bytes;
+}
+
+// Constructor
+RecordReader::RecordReader()
+    : memory( nullptr ), length( 0 )
+#ifdef _WIN32
+    , fileHandle( nullptr ), mappingHandle( nullptr )
+#else
+    , fileDescriptor( -1 )
+#endif
+{
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        entries[stream] = nullptr;
+        counts[stream] = 0;
+    }
+}
+
+// Destructor
+RecordReader::~RecordReader()
+{
+    // Close File
+    close();
+}
+
+// Open File
+void RecordReader::open( const std::string& path )
+{
+    close();
+
+    // Map File
+    map( path );
+
+    // Check File Header
+    if( length < sizeof( RecordFileHeader ) ){
+        close();
+        throw std::runtime_error( "invalid recording file " + path );
+    }
+
+    const RecordFileHeader* header = reinterpret_cast<const RecordFileHeader*>( memory );
+    if( std::memcmp( header->magic, fileMagic, sizeof( fileMagic ) ) != 0 || header->version != version ){
+        close();
+        throw std::runtime_error( "invalid recording file " + path );
+    }
+
+    // Load Trailing Index, or Recover it from Chunks if Recording was Interrupted
+    if( !loadIndex() ){
+        recoverIndex();
+    }
+}
+
+// Close File
+void RecordReader::close()
+{
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        entries[stream] = nullptr;
+        counts[stream] = 0;
+        recovered[stream].clear();
+    }
+
+    unmap();
+}
+
+// Check Open
+bool RecordReader::isOpen() const
+{
+    return memory != nullptr;
+}
+
+// Retrieve Number of Frames
+size_t RecordReader::count( const RecordStream stream ) const
+{
+    return counts[stream];
+}
+
+// Retrieve Frame
+RecordFrame RecordReader::frame( const RecordStream stream, const size_t i ) const
+{
+    RecordFrame frame;
+    if( counts[stream] <= i ){
+        return frame;
+    }
+
+    const uint64_t offset = entries[stream][i].offset;
+    frame.header = reinterpret_cast<const RecordChunkHeader*>( memory + offset );
+    frame.data = memory + offset + sizeof( RecordChunkHeader );
+    return frame;
+}
+
+// Seek Frame ( Latest Key Frame at or before Timestamp, O(log n) )
+RecordFrame RecordReader::seek( const RecordStream stream, const int64_t timestamp ) const
+{
+    return frame( stream, findKeyFrame( stream, find( stream, timestamp ) ) );
+}
+
+// Retrieve Frame Number of Latest Frame at or before Timestamp ( Returns count() if None )
+size_t RecordReader::find( const RecordStream stream, const int64_t timestamp ) const
+{
+    RecordIndexEntry key;
+    key.timestamp = timestamp;
+    key.offset = 0;
+
+    const RecordIndexEntry* begin = entries[stream];
+    const RecordIndexEntry* end = entries[stream] + counts[stream];
+    const RecordIndexEntry* it = std::upper_bound( begin, end, key, compareTimestamp );
+    if( it == begin ){
+        return counts[stream];
+    }
+
+    return static_cast<size_t>( it - begin ) - 1;
+}
+
+// Check Frame can be Decoded Alone ( Raw Frame, or Key Frame of Compressed Frames )
+bool RecordReader::isKeyFrame( const RecordStream stream, const size_t i ) const
+{
+    const RecordFrame frame = this->frame( stream, i );
+    if( !frame.valid() ){
+        return false;
+    }
+
+    if( frame.header->format != RecordFormat_DepthCodec ){
+        return true;
+    }
+
+    return DepthDecoder::isKeyFrame( frame.data, frame.size() );
+}
+
+// Retrieve Frame Number of Latest Key Frame at or before Frame i ( Returns count() if None )
+size_t RecordReader::findKeyFrame( const RecordStream stream, const size_t i ) const
+{
+    if( counts[stream] <= i ){
+        return counts[stream];
+    }
+
+    // Scan Backward ( At most Key Frame Interval )
+    for( size_t j = i + 1; j > 0; j-- ){
+        if( isKeyFrame( stream, j - 1 ) ){
+            return j - 1;
+        }
+    }
+
+    return counts[stream];
+}
+
+// Map File
+void RecordReader::map( const std::string& path )
+{
+#ifdef _WIN32
+    fileHandle = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    if( fileHandle == INVALID_HANDLE_VALUE ){
+        fileHandle = nullptr;
+        throw std::runtime_error( "failed open recording file " + path );
+    }
+
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( fileHandle, &size ) || size.QuadPart == 0 ){
+        unmap();
+        throw std::runtime_error( "failed retrieve size of recording file " + path );
+    }
+    length = static_cast<uint64_t>( size.QuadPart );
+
+    mappingHandle = CreateFileMappingA( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+    if( mappingHandle == nullptr ){
+        unmap();
+        throw std::runtime_error( "failed map recording file " + path );
+    }
+
+    memory = static_cast<const unsigned char*>( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+    if( memory == nullptr ){
+        unmap();
+        throw std::runtime_error( "failed map recording file " + path );
+    }
+#else
+    fileDescriptor = ::open( path.c_str(), O_RDONLY );
+    if( fileDescriptor < 0 ){
+        throw std::runtime_error( "failed open recording file " + path );
+    }
+
+    struct stat status;
+    if( fstat( fileDescriptor, &status ) != 0 || status.st_size == 0 ){
+        unmap();
+        throw std::runtime_error( "failed retrieve size of recording file " + path );
+    }
+    length = static_cast<uint64_t>( status.st_size );
+
+    void* address = mmap( nullptr, static_cast<size_t>( length ), PROT_READ, MAP_SHARED, fileDescriptor, 0 );
+    if( address == MAP_FAILED ){
+        unmap();
+        throw std::runtime_error( "failed map recording file " + path );
+    }
+    memory = static_cast<const unsigned char*>( address );
+#endif
+}
+
+// Unmap File
+void RecordReader::unmap()
+{
+#ifdef _WIN32
+    if( memory != nullptr ){
+        UnmapViewOfFile( memory );
+    }
+    if( mappingHandle != nullptr ){
+        CloseHandle( mappingHandle );
+        mappingHandle = nullptr;
+    }
+    if( fileHandle != nullptr ){
+        CloseHandle( fileHandle );
+        fileHandle = nullptr;
+    }
+#else
+    if( memory != nullptr ){
+        munmap( const_cast<unsigned char*>( memory ), static_cast<size_t>( length ) );
+    }
+    if( fileDescriptor >= 0 ){
+        ::close( fileDescriptor );
+        fileDescriptor = -1;
+    }
+#endif
+    memory = nullptr;
+    length = 0;
+}
+
+// Load Trailing Index
+bool RecordReader::loadIndex()
+{
+    // Check Footer
+    if( length < sizeof( RecordFileHeader ) + sizeof( RecordIndexHeader ) + sizeof( RecordFileFooter ) ){
+        return false;
+    }
+
+    const RecordFileFooter* footer = reinterpret_cast<const RecordFileFooter*>( memory + length - sizeof( RecordFileFooter ) );
+    if( std::memcmp( footer->magic, footerMagic, sizeof( footerMagic ) ) != 0 ){
+        return false;
+    }
+
+    // Check Index Header
+    const uint64_t indexOffset = footer->indexOffset;
+    if( indexOffset < sizeof( RecordFileHeader ) || length - sizeof( RecordFileFooter ) < indexOffset + sizeof( RecordIndexHeader ) ){
+        return false;
+    }
+
+    const RecordIndexHeader* header = reinterpret_cast<const RecordIndexHeader*>( memory + indexOffset );
+    const uint64_t available = ( length - sizeof( RecordFileFooter ) - indexOffset - sizeof( RecordIndexHeader ) ) / sizeof( RecordIndexEntry );
+    if( header->magic != indexMagic || header->streams != RecordStream_Count || available < header->entries ){
+        return false;
+    }
+
+    // Retrieve Index Entries of Each Stream
+    const RecordIndexEntry* all = reinterpret_cast<const RecordIndexEntry*>( memory + indexOffset + sizeof( RecordIndexHeader ) );
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        if( header->entries < header->begin[stream] || header->entries - header->begin[stream] < header->count[stream] ){
+            return false;
+        }
+
+        // Check Chunks are inside File
+        for( uint64_t i = 0; i < header->count[stream]; i++ ){
+            const uint64_t offset = all[header->begin[stream] + i].offset;
+            if( indexOffset < offset + sizeof( RecordChunkHeader ) ){
+                return false;
+            }
+
+            const RecordChunkHeader* chunk = reinterpret_cast<const RecordChunkHeader*>( memory + offset );
+            if( chunk->magic != chunkMagic || chunk->stream != stream || indexOffset - offset - sizeof( RecordChunkHeader ) < chunk->bytes || !checkPayload( chunk ) ){
+                return false;
+            }
+        }
+
+        entries[stream] = all + header->begin[stream];
+        counts[stream] = static_cast<size_t>( header->count[stream] );
+    }
+
+    return true;
+}
+
+// Recover Index by Scanning Chunks ( File was not Closed )
+void RecordReader::recoverIndex()
+{
+    uint64_t offset = sizeof( RecordFileHeader );
+    while( offset + sizeof( RecordChunkHeader ) <= length ){
+        const RecordChunkHeader* chunk = reinterpret_cast<const RecordChunkHeader*>( memory + offset );
+        if( chunk->magic != chunkMagic || RecordStream_Count <= chunk->stream ){
+            break;
+        }
+
+        // Truncated or Corrupted Chunk
+        if( length - offset - sizeof( RecordChunkHeader ) < chunk->bytes || !checkPayload( chunk ) ){
+            break;
+        }
+
+        RecordIndexEntry entry;
+        entry.timestamp = chunk->timestamp;
+        entry.offset = offset;
+        recovered[chunk->stream].push_back( entry );
+
+        offset = align( offset + sizeof( RecordChunkHeader ) + chunk->bytes );
+    }
+
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        std::stable_sort( recovered[stream].begin(), recovered[stream].end(), compareTimestamp );
+        entries[stream] = recovered[stream].empty() ? nullptr : &recovered[stream][0];
+        counts[stream] = recovered[stream].size();
+    }
+}
+
+// Constructor
+RecordDepthDecoder::RecordDepthDecoder()
+    : decodedHeader( nullptr ), decoded( 0 )
+{
+}
+
+// Retrieve Frame i as UINT16 ( Valid until Next Call or Reader is Closed, nullptr if None )
+const uint16_t* RecordDepthDecoder::decode( const RecordReader& reader, const RecordStream stream, const size_t i )
+{
+    const RecordFrame target = reader.frame( stream, i );
+    if( !target.valid() ){
+        return nullptr;
+    }
+
+    // Raw Frame is View into Mapped File
+    if( target.header->format == RecordFormat_UInt16 ){
+        return target.ptr<uint16_t>();
+    }
+
+    if( target.header->format != RecordFormat_DepthCodec ){
+        throw std::runtime_error( "recording frame is not depth or infrared" );
+    }
+
+    // Decode from Key Frame, or Continue from Last Decoded Frame if it is between Key Frame and Target
+    const size_t key = reader.findKeyFrame( stream, i );
+    if( key == reader.count( stream ) ){
+        throw std::runtime_error( "key frame of recording frame is missing" );
+    }
+
+    size_t begin = key;
+    if( decodedHeader != nullptr && key <= decoded && decoded <= i && reader.frame( stream, decoded ).header == decodedHeader ){
+        if( decoded == i ){
+            return &buffer[0];
+        }
+        begin = decoded + 1;
+    }
+
+    decodedHeader = nullptr;
+    buffer.resize( static_cast<size_t>( target.width() ) * target.height() );
+    for( size_t j = begin; j <= i; j++ ){
+        const RecordFrame frame = reader.frame( stream, j );
+        DepthCodecHeader header;
+        if( frame.header->format != RecordFormat_DepthCodec || !DepthDecoder::readHeader( frame.data, frame.size(), header ) || header.width != target.header->width || header.height != target.header->height ){
+            throw std::runtime_error( "invalid compressed recording frame" );
+        }
+
+        decoder.decode( frame.data, frame.size(), &buffer[0] );
+        decodedHeader = frame.header;
+        decoded = j;
+    }
+
+    return &buffer[0];
+}
+
+// Retrieve Latest Frame at or before Timestamp as UINT16 ( nullptr if None )
+const uint16_t* RecordDepthDecoder::seek( const RecordReader& reader, const RecordStream stream, const int64_t timestamp )
+{
+    return decode( reader, stream, reader.find( stream, timestamp ) );
+}
+
+// Forget Last Decoded Frame
+void RecordDepthDecoder::reset()
+{
+    decodedHeader = nullptr;
+    decoder.reset();
+}
\ No newline at end of file
@@ -0,0 +1,301 @@
+#ifndef __RECORD__
+#define __RECORD__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DepthCodec.h"
+
+// Kinect Recording File ( .k2rec )
+//
+// File Layout
+//   RecordFileHeader ( 64 bytes )
+//   Chunk ( RecordChunkHeader ( 64 bytes ) + Payload ( Padded to 64 bytes ) ) x N
+//   RecordIndexHeader + RecordIndexEntry x N ( Grouped by Stream, Sorted by Timestamp )
+//   RecordFileFooter ( 16 bytes )
+//
+// Every payload starts at a 64 bytes aligned offset, so a memory-mapped payload can be used directly
+// as UINT16 depth/infrared, BYTE body index, BGRA/YUY2 color, joints or float audio samples.
+// Compressed depth/infrared frames depend on previous frames, RecordDepthDecoder decodes them forward from the key frame.
+
+// Stream Type
+enum RecordStream
+{
+    RecordStream_Depth     = 0,
+    RecordStream_Infrared  = 1,
+    RecordStream_BodyIndex = 2,
+    RecordStream_Color     = 3,
+    RecordStream_Body      = 4,
+    RecordStream_AudioBeam = 5,
+    RecordStream_Count     = 6
+};
+
+// Payload Format
+enum RecordFormat
+{
+    RecordFormat_UInt16  = 0, // Depth, Infrared ( width x height x UINT16 )
+    RecordFormat_UInt8   = 1, // Body Index ( width x height x BYTE )
+    RecordFormat_Bgra    = 2, // Color ( width x height x 4 BYTE )
+    RecordFormat_Yuy2    = 3, // Color ( width x height x 2 BYTE )
+    RecordFormat_Body    = 4, // Body ( width = Number of Bodies, RecordBody x width )
+    RecordFormat_Float32 = 5, // Audio Beam ( width = Number of Samples, float x width )
+    RecordFormat_DepthCodec = 6 // Compressed Depth, Infrared ( see DepthCodec.h, Decode with RecordDepthDecoder )
+};
+
+#pragma pack( push, 1 )
+// Joint ( Same Layout as Joint of Kinect SDK )
+struct RecordJoint
+{
+    int32_t type;
+    float x;
+    float y;
+    float z;
+    int32_t trackingState;
+};
+
+// Body
+struct RecordBody
+{
+    uint64_t trackingId;
+    uint8_t tracked;
+    uint8_t handLeftState;
+    uint8_t handRightState;
+    uint8_t reserved[5];
+    RecordJoint joints[25];
+};
+
+// File Header
+struct RecordFileHeader
+{
+    char magic[8];         // "K2REC\0\0\0"
+    uint32_t version;
+    uint32_t reserved0;
+    uint8_t reserved1[48];
+};
+
+// Chunk Header
+struct RecordChunkHeader
+{
+    uint32_t magic;        // 'K2CH'
+    uint16_t stream;       // RecordStream
+    uint16_t format;       // RecordFormat
+    uint32_t width;
+    uint32_t height;
+    int64_t timestamp;     // Relative Time ( 100 ns )
+    uint64_t bytes;        // Payload Size
+    float parameters[2];   // Audio Beam Angle and Confidence
+    uint8_t reserved[24];
+};
+
+// Index Entry
+struct RecordIndexEntry
+{
+    int64_t timestamp;
+    uint64_t offset;       // Offset of Chunk Header
+};
+
+// Index Header
+struct RecordIndexHeader
+{
+    uint32_t magic;        // 'K2IX'
+    uint32_t streams;      // RecordStream_Count
+    uint64_t entries;
+    uint64_t begin[RecordStream_Count];
+    uint64_t count[RecordStream_Count];
+};
+
+// File Footer
+struct RecordFileFooter
+{
+    uint64_t indexOffset;
+    char magic[8];         // "K2RECEND"
+};
+#pragma pack( pop )
+
+// Recording Frame ( Zero-Copy View into Mapped File )
+struct RecordFrame
+{
+    const RecordChunkHeader* header;
+    const void* data;
+
+    RecordFrame()
+        : header( nullptr ), data( nullptr )
+    {
+    }
+
+    bool valid() const { return header != nullptr; }
+    int64_t timestamp() const { return header->timestamp; }
+    int width() const { return static_cast<int>( header->width ); }
+    int height() const { return static_cast<int>( header->height ); }
+    size_t size() const { return static_cast<size_t>( header->bytes ); }
+
+    template<typename T>
+    const T* ptr() const
+    {
+        return reinterpret_cast<const T*>( data );
+    }
+};
+
+// Recording Writer
+//
+// write() copies the chunk into a pooled block and returns, a background thread writes blocks to the file in order.
+// When the queued blocks exceed maxQueuedBytes ( disk is slower than the sensor ), write() waits for the writer ( back-pressure ),
+// so no frame is dropped. An error of background thread stops writing, and is rethrown by every following write() and by close().
+class RecordWriter
+{
+private:
+    static const size_t maxQueuedBytes = 256 * 1024 * 1024;
+
+    FILE* file;
+    uint64_t offset;
+    std::vector<RecordIndexEntry> index[RecordStream_Count];
+    std::vector<char> buffer;
+
+    // Background Thread
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::deque<std::vector<char>> queued;     // Chunks to Write in File Order
+    std::vector<std::vector<char>> available; // Free Blocks ( Reused )
+    size_t queuedBytes;
+    bool quit;
+    std::exception_ptr exception;
+
+public:
+    // Constructor
+    RecordWriter();
+
+    // Destructor
+    ~RecordWriter();
+
+    RecordWriter( const RecordWriter& ) = delete;
+    RecordWriter& operator=( const RecordWriter& ) = delete;
+
+    // Open File
+    void open( const std::string& path );
+
+    // Close File ( Write Queued Chunks, Index and Footer )
+    void close();
+
+    // Check Open
+    bool isOpen() const;
+
+    // Write Frame ( Queued to Background Thread )
+    void write( const RecordStream stream, const RecordFormat format, const int width, const int height, const int64_t timestamp, const void* data, const size_t bytes, const float parameter0 = 0.0f, const float parameter1 = 0.0f );
+
+    // Retrieve Number of Written Frames
+    size_t count( const RecordStream stream ) const;
+
+private:
+    // Background Thread ( Writes Queued Chunks before Quit )
+    void worker();
+
+    // Write Bytes
+    void writeBytes( const void* data, const size_t bytes );
+};
+
+// Recording Reader ( Memory-Mapped Replay )
+class RecordReader
+{
+private:
+    const unsigned char* memory;
+    uint64_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    // Index ( Points into Mapped File, or into Recovered Index )
+    const RecordIndexEntry* entries[RecordStream_Count];
+    size_t counts[RecordStream_Count];
+    std::vector<RecordIndexEntry> recovered[RecordStream_Count];
+
+public:
+    // Constructor
+    RecordReader();
+
+    // Destructor
+    ~RecordReader();
+
+    // Open File
+    void open( const std::string& path );
+
+    // Close File
+    void close();
+
+    // Check Open
+    bool isOpen() const;
+
+    // Retrieve Number of Frames
+    size_t count( const RecordStream stream ) const;
+
+    // Retrieve Frame
+    RecordFrame frame( const RecordStream stream, const size_t i ) const;
+
+    // Seek Frame ( Latest Key Frame at or before Timestamp, O(log n) )
+    // Raw frames are all key frames, compressed frames after the key frame are decoded by RecordDepthDecoder.
+    RecordFrame seek( const RecordStream stream, const int64_t timestamp ) const;
+
+    // Retrieve Frame Number of Latest Frame at or before Timestamp ( Returns count() if None )
+    size_t find( const RecordStream stream, const int64_t timestamp ) const;
+
+    // Check Frame can be Decoded Alone ( Raw Frame, or Key Frame of Compressed Frames )
+    bool isKeyFrame( const RecordStream stream, const size_t i ) const;
+
+    // Retrieve Frame Number of Latest Key Frame at or before Frame i ( Returns count() if None )
+    size_t findKeyFrame( const RecordStream stream, const size_t i ) const;
+
+private:
+    // Map File
+    void map( const std::string& path );
+
+    // Unmap File
+    void unmap();
+
+    // Load Trailing Index
+    bool loadIndex();
+
+    // Recover Index by Scanning Chunks ( File was not Closed )
+    void recoverIndex();
+};
+
+// Recording Depth Decoder ( Depth, Infrared )
+//
+// Raw UINT16 frames are returned as zero-copy views into the mapped file.
+// Compressed frames are decoded forward from the latest key frame, or from the last decoded frame when playing forward,
+// so sequential replay decodes each frame once and random access decodes at most one key frame interval.
+class RecordDepthDecoder
+{
+private:
+    DepthDecoder decoder;
+    std::vector<uint16_t> buffer;
+
+    // Last Decoded Frame ( Header Identifies Reader and Stream )
+    const RecordChunkHeader* decodedHeader;
+    size_t decoded;
+
+public:
+    // Constructor
+    RecordDepthDecoder();
+
+    // Retrieve Frame i as UINT16 ( Valid until Next Call or Reader is Closed, nullptr if None )
+    const uint16_t* decode( const RecordReader& reader, const RecordStream stream, const size_t i );
+
+    // Retrieve Latest Frame at or before Timestamp as UINT16 ( nullptr if None )
+    const uint16_t* seek( const RecordReader& reader, const RecordStream stream, const int64_t timestamp );
+
+    // Forget Last Decoded Frame ( Call when Reader is Reopened )
+    void reset();
+};
+
+#endif // __RECORD__
\ No newline at end of file
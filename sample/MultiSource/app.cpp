@@ -3,10 +3,20 @@
 
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <iostream>
 
 // Constructor
-Kinect::Kinect()
+Kinect::Kinect( const std::string& sink, const uint64_t frames, const std::string& replay )
+    : replayFrame( 0 ),
+      sink( CreateFrameSink( sink ) ),
+      frames( frames )
 {
+    // Open Recording to Replay
+    if( !replay.empty() ){
+        player.open( replay );
+    }
+
     // Initialize
     initialize();
 }
@@ -21,23 +31,28 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( true ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
-
-        // Key Check
-        const int key = cv::waitKey( 10 );
-        if( key == VK_ESCAPE ){
-            break;
+        [&]( Frame& frame ){ show( frame ); },
+        // Poll Sink ( Key Check of imshow Sink ) and Check Number of Frames
+        [&](){
+            const bool running = sink->poll();
+            if( sink->key() == 'r' ){
+                // Request Toggle Recording to Update Stage ( Recorder is Used by Update Stage )
+                recordToggle = true;
+            }
+            return running && ( frames == 0 || pipeline.statistics( PipelineStage_Present ).frames < frames );
         }
-    }
+    );
+
+    // Show Latency of Pipeline Stages and Throughput
+    pipeline.printStatistics( std::cout );
+    std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
 }
 
 // Initialize
@@ -45,6 +60,12 @@ void Kinect::initialize()
 {
     cv::setUseOptimized( true );
 
+    // Initialize Replay ( Sensor is not Used )
+    if( player.isOpen() ){
+        initializeReplay();
+        return;
+    }
+
     // Initialize Sensor
     initializeSensor();
 
@@ -57,6 +78,9 @@ void Kinect::initialize()
     // Initialize Depth
     initializeDepth();
 
+    // Initialize Infrared, Body Index and Audio Beam
+    initializeRecordStreams();
+
     // Wait a Few Seconds until begins to Retrieve Data from Sensor ( about 2000-[ms] )
     std::this_thread::sleep_for( std::chrono::seconds( 2 ) );
 }
@@ -77,13 +101,58 @@ inline void Kinect::initializeSensor()
     }
 }
 
+// Initialize Replay
+inline void Kinect::initializeReplay()
+{
+    // Retrieve Frame Size from First Frames of Recording
+    const RecordFrame colorFrame = player.frame( RecordStream_Color, 0 );
+    const RecordFrame depthFrame = player.frame( RecordStream_Depth, 0 );
+    if( !colorFrame.valid() || colorFrame.header->format != RecordFormat_Yuy2 || !depthFrame.valid() ){
+        throw std::runtime_error( "recording has no color ( YUY2 ) or depth frames" );
+    }
+
+    colorWidth = colorFrame.width();
+    colorHeight = colorFrame.height();
+    colorBytesPerPixel = 2;
+    depthWidth = depthFrame.width();
+    depthHeight = depthFrame.height();
+    depthBytesPerPixel = 2;
+
+    // Allocation Depth Buffer of Each Frame ( Color is View into Mapped Recording, Decoded Depth is Copied )
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorData = nullptr;
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.colorUpdated = false;
+        frame.depthUpdated = false;
+    } );
+
+    // Allocation Show Buffer
+    depthScaleMat.create( depthHeight, depthWidth, CV_8UC1 );
+
+    // Start Replay from First Frame
+    replayFrame = 0;
+    replayBegin = std::chrono::steady_clock::now();
+}
+
 // Initialize Multi Source
 inline void Kinect::initializeMultiSource()
 {
-    // Open Multi Source Reader
+    // Open Multi Source Reader ( Color and Depth )
+    openMultiSource( false );
+}
+
+// Open Multi Source Reader ( Infrared, Body Index and Body are Opened Only while Recording )
+inline void Kinect::openMultiSource( const bool record )
+{
     DWORD types = FrameSourceTypes::FrameSourceTypes_Color
                 | FrameSourceTypes::FrameSourceTypes_Depth;
+    if( record ){
+        types |= FrameSourceTypes::FrameSourceTypes_Infrared
+               | FrameSourceTypes::FrameSourceTypes_BodyIndex
+               | FrameSourceTypes::FrameSourceTypes_Body;
+    }
 
+    multiSourceFrameReader.Reset();
     ERROR_CHECK( kinect->OpenMultiSourceFrameReader( types, &multiSourceFrameReader ) );
 }
 
@@ -94,15 +163,19 @@ inline void Kinect::initializeColor()
     ComPtr<IColorFrameSource> colorFrameSource;
     ERROR_CHECK( kinect->get_ColorFrameSource( &colorFrameSource ) );
 
-    // Retrieve Color Description
+    // Retrieve Color Description ( YUY2 is Raw Format of Sensor, Half Size of BGRA for Recording )
     ComPtr<IFrameDescription> colorFrameDescription;
-    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Bgra, &colorFrameDescription ) );
+    ERROR_CHECK( colorFrameSource->CreateFrameDescription( ColorImageFormat::ColorImageFormat_Yuy2, &colorFrameDescription ) );
     ERROR_CHECK( colorFrameDescription->get_Width( &colorWidth ) ); // 1920
     ERROR_CHECK( colorFrameDescription->get_Height( &colorHeight ) ); // 1080
-    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
-
-    // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 2
+
+    // Allocation Color Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorData = &frame.colorBuffer[0];
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Depth
@@ -119,8 +192,53 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameDescription->get_Height( &depthHeight ) ); // 424
     ERROR_CHECK( depthFrameDescription->get_BytesPerPixel( &depthBytesPerPixel ) ); // 2
 
-    // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    // Allocation Depth Buffer of Each Frame
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.depthUpdated = false;
+    } );
+
+    // Allocation Show Buffer
+    depthScaleMat.create( depthHeight, depthWidth, CV_8UC1 );
+
+    // Initialize Depth Encoder for Recording ( Key Frame every 30 Frames )
+    depthEncoder.initialize( depthWidth, depthHeight, 30 );
+}
+
+// Initialize Infrared, Body Index and Audio Beam ( Recorded Only, Readers are Opened when Recording Starts )
+inline void Kinect::initializeRecordStreams()
+{
+    // Allocation Infrared and Body Index Buffer ( Same Resolution as Depth )
+    infraredBuffer.resize( depthWidth * depthHeight );
+    bodyIndexBuffer.resize( depthWidth * depthHeight );
+}
+
+// Toggle Recording
+inline void Kinect::toggleRecording()
+{
+    if( !recorder.isOpen() ){
+        // Start Recording ( First Depth Frame is Key Frame )
+        recorder.open( "../record.k2rec" );
+        depthEncoder.reset();
+
+        // Open Recorded Streams ( Audio is not Part of Multi Source )
+        openMultiSource( true );
+        ComPtr<IAudioSource> audioSource;
+        ERROR_CHECK( kinect->get_AudioSource( &audioSource ) );
+        ERROR_CHECK( audioSource->OpenReader( &audioBeamFrameReader ) );
+        std::cout << "Start Recording" << std::endl;
+    }
+    else{
+        // Stop Recording ( Write Index )
+        std::cout << "Stop Recording ( Color " << recorder.count( RecordStream_Color ) << " frames, Depth " << recorder.count( RecordStream_Depth ) << " frames, "
+                  << "Infrared " << recorder.count( RecordStream_Infrared ) << " frames, Body Index " << recorder.count( RecordStream_BodyIndex ) << " frames, "
+                  << "Body " << recorder.count( RecordStream_Body ) << " frames, Audio Beam " << recorder.count( RecordStream_AudioBeam ) << " sub frames )" << std::endl;
+        recorder.close();
+
+        // Close Recorded Streams
+        audioBeamFrameReader.Reset();
+        openMultiSource( false );
+    }
 }
 
 // Finalize
@@ -128,6 +246,11 @@ void Kinect::finalize()
 {
     cv::destroyAllWindows();
 
+    // Close Recording
+    if( recorder.isOpen() ){
+        recorder.close();
+    }
+
     // Close Sensor
     if( kinect != nullptr ){
         kinect->Close();
@@ -135,24 +258,91 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
+    // Update from Recording ( Recording during Replay is not Supported )
+    if( player.isOpen() ){
+        return updateReplay( frame );
+    }
+
+    // Toggle Recording if Requested by Key Check
+    if( recordToggle.exchange( false ) ){
+        toggleRecording();
+    }
+
     // Retrieve Multi Source Frame
     ComPtr<IMultiSourceFrame> multiSourceFrame;
     const HRESULT ret = multiSourceFrameReader->AcquireLatestFrame( &multiSourceFrame );
     if( FAILED( ret ) ){
-        return;
+        return false;
     }
 
     // Update Color
-    updateColor( multiSourceFrame );
+    updateColor( frame, multiSourceFrame );
 
     // Update Depth
-    updateDepth( multiSourceFrame );
+    updateDepth( frame, multiSourceFrame );
+
+    // Update Infrared
+    updateInfrared( multiSourceFrame );
+
+    // Update Body Index
+    updateBodyIndex( multiSourceFrame );
+
+    // Update Body
+    updateBody( multiSourceFrame );
+
+    // Update Audio Beam
+    updateAudioBeam();
+
+    // Wait until Both Color and Depth are Updated
+    if( !frame.colorUpdated || !frame.depthUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.depthUpdated = false;
+    return true;
+}
+
+// Update Replay ( Color Frames are Played at Recorded Timing with Latest Depth Frame at or before Color, Recording is Looped )
+inline bool Kinect::updateReplay( Frame& frame )
+{
+    // Loop Recording
+    if( replayFrame == player.count( RecordStream_Color ) ){
+        replayFrame = 0;
+        replayBegin = std::chrono::steady_clock::now();
+    }
+
+    // Wait until Color Frame is Due ( Relative Time in 100 ns )
+    const RecordFrame colorFrame = player.frame( RecordStream_Color, replayFrame );
+    const int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - replayBegin ).count() / 100;
+    if( elapsed < colorFrame.timestamp() - player.frame( RecordStream_Color, 0 ).timestamp() ){
+        return false;
+    }
+    replayFrame++;
+
+    // Skip Frames of Different Format or Size
+    const size_t depthIndex = player.find( RecordStream_Depth, colorFrame.timestamp() );
+    const RecordFrame depthFrame = player.frame( RecordStream_Depth, depthIndex );
+    if( colorFrame.header->format != RecordFormat_Yuy2 || colorFrame.width() != colorWidth || colorFrame.height() != colorHeight ){
+        return false;
+    }
+    if( !depthFrame.valid() || depthFrame.width() != depthWidth || depthFrame.height() != depthHeight ){
+        return false;
+    }
+
+    // Retrieve Color ( View into Mapped Recording, Valid while Recording is Open )
+    frame.colorData = colorFrame.ptr<BYTE>();
+
+    // Retrieve Depth ( Decoded Forward from Last Decoded Frame, or from Key Frame after Loop )
+    const uint16_t* depth = depthDecoder.decode( player, RecordStream_Depth, depthIndex );
+    std::memcpy( &frame.depthBuffer[0], depth, frame.depthBuffer.size() * sizeof( UINT16 ) );
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor( const ComPtr<IMultiSourceFrame>& multiSourceFrame )
+inline void Kinect::updateColor( Frame& frame, const ComPtr<IMultiSourceFrame>& multiSourceFrame )
 {
     if( multiSourceFrame == nullptr ){
         return;
@@ -172,12 +362,21 @@ inline void Kinect::updateColor( const ComPtr<IMultiSourceFrame>& multiSourceFra
         return;
     }
 
-    // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    // Retrieve Color Data ( YUY2, Converted in drawColor() )
+    std::vector<BYTE>& colorBuffer = frame.colorBuffer;
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Yuy2 ) );
+    frame.colorUpdated = true;
+
+    // Record Color Frame
+    if( recorder.isOpen() ){
+        TIMESPAN timestamp;
+        ERROR_CHECK( colorFrame->get_RelativeTime( &timestamp ) );
+        recorder.write( RecordStream_Color, RecordFormat_Yuy2, colorWidth, colorHeight, timestamp, &colorBuffer[0], colorBuffer.size() );
+    }
 }
 
 // Update Depth
-inline void Kinect::updateDepth( const ComPtr<IMultiSourceFrame>& multiSourceFrame )
+inline void Kinect::updateDepth( Frame& frame, const ComPtr<IMultiSourceFrame>& multiSourceFrame )
 {
     if( multiSourceFrame == nullptr ){
         return;
@@ -198,71 +397,249 @@ inline void Kinect::updateDepth( const ComPtr<IMultiSourceFrame>& multiSourceFra
     }
 
     // Retrieve Depth Data
+    std::vector<UINT16>& depthBuffer = frame.depthBuffer;
     ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    frame.depthUpdated = true;
+
+    // Record Depth Frame
+    if( recorder.isOpen() ){
+        TIMESPAN timestamp;
+        ERROR_CHECK( depthFrame->get_RelativeTime( &timestamp ) );
+        depthEncoder.encode( &depthBuffer[0], depthEncoded );
+        recorder.write( RecordStream_Depth, RecordFormat_DepthCodec, depthWidth, depthHeight, timestamp, &depthEncoded[0], depthEncoded.size() );
+    }
+}
+
+// Update Infrared
+inline void Kinect::updateInfrared( const ComPtr<IMultiSourceFrame>& multiSourceFrame )
+{
+    if( multiSourceFrame == nullptr || !recorder.isOpen() ){
+        return;
+    }
+
+    // Retrieve Infrared Frame Reference
+    ComPtr<IInfraredFrameReference> infraredFrameReference;
+    HRESULT ret = multiSourceFrame->get_InfraredFrameReference( &infraredFrameReference );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Infrared Frame
+    ComPtr<IInfraredFrame> infraredFrame;
+    ret = infraredFrameReference->AcquireFrame( &infraredFrame );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Infrared Data
+    ERROR_CHECK( infraredFrame->CopyFrameDataToArray( static_cast<UINT>( infraredBuffer.size() ), &infraredBuffer[0] ) );
+
+    // Record Infrared Frame
+    TIMESPAN timestamp;
+    ERROR_CHECK( infraredFrame->get_RelativeTime( &timestamp ) );
+    recorder.write( RecordStream_Infrared, RecordFormat_UInt16, depthWidth, depthHeight, timestamp, &infraredBuffer[0], infraredBuffer.size() * sizeof( UINT16 ) );
+}
+
+// Update Body Index
+inline void Kinect::updateBodyIndex( const ComPtr<IMultiSourceFrame>& multiSourceFrame )
+{
+    if( multiSourceFrame == nullptr || !recorder.isOpen() ){
+        return;
+    }
+
+    // Retrieve Body Index Frame Reference
+    ComPtr<IBodyIndexFrameReference> bodyIndexFrameReference;
+    HRESULT ret = multiSourceFrame->get_BodyIndexFrameReference( &bodyIndexFrameReference );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Body Index Frame
+    ComPtr<IBodyIndexFrame> bodyIndexFrame;
+    ret = bodyIndexFrameReference->AcquireFrame( &bodyIndexFrame );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Body Index Data
+    ERROR_CHECK( bodyIndexFrame->CopyFrameDataToArray( static_cast<UINT>( bodyIndexBuffer.size() ), &bodyIndexBuffer[0] ) );
+
+    // Record Body Index Frame
+    TIMESPAN timestamp;
+    ERROR_CHECK( bodyIndexFrame->get_RelativeTime( &timestamp ) );
+    recorder.write( RecordStream_BodyIndex, RecordFormat_UInt8, depthWidth, depthHeight, timestamp, &bodyIndexBuffer[0], bodyIndexBuffer.size() );
+}
+
+// Update Body
+inline void Kinect::updateBody( const ComPtr<IMultiSourceFrame>& multiSourceFrame )
+{
+    if( multiSourceFrame == nullptr || !recorder.isOpen() ){
+        return;
+    }
+
+    // Retrieve Body Frame Reference
+    ComPtr<IBodyFrameReference> bodyFrameReference;
+    HRESULT ret = multiSourceFrame->get_BodyFrameReference( &bodyFrameReference );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Body Frame
+    ComPtr<IBodyFrame> bodyFrame;
+    ret = bodyFrameReference->AcquireFrame( &bodyFrame );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Body Data
+    std::array<IBody*, BODY_COUNT> bodies = { nullptr };
+    ERROR_CHECK( bodyFrame->GetAndRefreshBodyData( static_cast<UINT>( bodies.size() ), &bodies[0] ) );
+
+    // Convert to Record Layout ( Joint has Same Layout as RecordJoint )
+    for( int count = 0; count < BODY_COUNT; count++ ){
+        ComPtr<IBody> body;
+        body.Attach( bodies[count] );
+
+        RecordBody& record = bodyBuffer[count];
+        std::memset( &record, 0, sizeof( record ) );
+        if( body == nullptr ){
+            continue;
+        }
+
+        BOOLEAN tracked = FALSE;
+        ERROR_CHECK( body->get_IsTracked( &tracked ) );
+        record.tracked = tracked ? 1 : 0;
+        if( !tracked ){
+            continue;
+        }
+
+        UINT64 trackingId;
+        HandState handLeftState;
+        HandState handRightState;
+        ERROR_CHECK( body->get_TrackingId( &trackingId ) );
+        ERROR_CHECK( body->get_HandLeftState( &handLeftState ) );
+        ERROR_CHECK( body->get_HandRightState( &handRightState ) );
+        record.trackingId = trackingId;
+        record.handLeftState = static_cast<uint8_t>( handLeftState );
+        record.handRightState = static_cast<uint8_t>( handRightState );
+
+        std::array<Joint, JointType::JointType_Count> joints;
+        ERROR_CHECK( body->GetJoints( static_cast<UINT>( joints.size() ), &joints[0] ) );
+        std::memcpy( record.joints, &joints[0], sizeof( record.joints ) );
+    }
+
+    // Record Body Frame
+    TIMESPAN timestamp;
+    ERROR_CHECK( bodyFrame->get_RelativeTime( &timestamp ) );
+    recorder.write( RecordStream_Body, RecordFormat_Body, BODY_COUNT, 1, timestamp, &bodyBuffer[0], sizeof( bodyBuffer ) );
+}
+
+// Update Audio Beam
+inline void Kinect::updateAudioBeam()
+{
+    if( !recorder.isOpen() ){
+        return;
+    }
+
+    // Retrieve Audio Beam Frame List
+    ComPtr<IAudioBeamFrameList> audioBeamFrameList;
+    const HRESULT ret = audioBeamFrameReader->AcquireLatestBeamFrames( &audioBeamFrameList );
+    if( FAILED( ret ) ){
+        return;
+    }
+
+    // Retrieve Audio Beam Frame Count
+    UINT beamCount;
+    ERROR_CHECK( audioBeamFrameList->get_BeamCount( &beamCount ) );
+    for( UINT i = 0; i < beamCount; i++ ){
+        // Retrieve Audio Beam Frame
+        ComPtr<IAudioBeamFrame> audioBeamFrame;
+        ERROR_CHECK( audioBeamFrameList->OpenAudioBeamFrame( i, &audioBeamFrame ) );
+
+        // Retrieve Audio Beam SubFrame Count
+        UINT subFrameCount;
+        ERROR_CHECK( audioBeamFrame->get_SubFrameCount( &subFrameCount ) );
+        for( UINT j = 0; j < subFrameCount; j++ ){
+            // Retrieve Audio Beam SubFrame
+            ComPtr<IAudioBeamSubFrame> audioBeamSubFrame;
+            ERROR_CHECK( audioBeamFrame->GetSubFrame( j, &audioBeamSubFrame ) );
+
+            // Retrieve Samples ( 32 bit float ), Beam Angle and Confidence
+            UINT length;
+            BYTE* buffer;
+            float beamAngle;
+            float beamAngleConfidence;
+            TIMESPAN timestamp;
+            ERROR_CHECK( audioBeamSubFrame->AccessUnderlyingBuffer( &length, &buffer ) );
+            ERROR_CHECK( audioBeamSubFrame->get_BeamAngle( &beamAngle ) );
+            ERROR_CHECK( audioBeamSubFrame->get_BeamAngleConfidence( &beamAngleConfidence ) );
+            ERROR_CHECK( audioBeamSubFrame->get_RelativeTime( &timestamp ) );
+
+            // Record Audio Beam Sub Frame
+            recorder.write( RecordStream_AudioBeam, RecordFormat_Float32, static_cast<int>( length / sizeof( float ) ), 1, timestamp, buffer, length, beamAngle, beamAngleConfidence );
+        }
+    }
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Depth
-    drawDepth();
+    drawDepth( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
-    // Create cv::Mat from Color Buffer
-    colorMat = cv::Mat( colorHeight, colorWidth, CV_8UC4, &colorBuffer[0] );
+    // Convert Format ( YUY2 -> Half Resolution BGR )
+    frame.colorMat.create( colorHeight / 2, colorWidth / 2, CV_8UC3 );
+    Yuy2::convertToHalfBGR( frame.colorData, colorWidth, colorHeight, frame.colorMat.data );
 }
 
 // Draw Depth
-inline void Kinect::drawDepth()
+inline void Kinect::drawDepth( Frame& frame )
 {
     // Create cv::Mat from Depth Buffer
-    depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &depthBuffer[0] );
+    frame.depthMat = cv::Mat( depthHeight, depthWidth, CV_16UC1, &frame.depthBuffer[0] );
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Color
-    showColor();
+    showColor( frame );
 
     // Show Depth
-    showDepth();
+    showDepth( frame );
 }
 
 // Show Color
-inline void Kinect::showColor()
+inline void Kinect::showColor( Frame& frame )
 {
+    const cv::Mat& colorMat = frame.colorMat;
     if( colorMat.empty() ){
         return;
     }
 
-    // Resize Image
-    cv::Mat resizeMat;
-    const double scale = 0.5;
-    cv::resize( colorMat, resizeMat, cv::Size(), scale, scale );
-
-    // Show Image
-    cv::imshow( "Color", resizeMat );
+    // Show Image ( Half Resolution )
+    sink->write( "Color", colorMat );
 }
 
 // Show Depth
-inline void Kinect::showDepth()
+inline void Kinect::showDepth( Frame& frame )
 {
+    const cv::Mat& depthMat = frame.depthMat;
     if( depthMat.empty() ){
         return;
     }
 
     // Scaling ( 0-8000 -> 255-0 )
-    cv::Mat scaleMat;
-    depthMat.convertTo( scaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
-    //cv::applyColorMap( scaleMat, scaleMat, cv::COLORMAP_BONE );
+    depthMat.convertTo( depthScaleMat, CV_8U, -255.0 / 8000.0, 255.0 );
+    //cv::applyColorMap( depthScaleMat, depthScaleMat, cv::COLORMAP_BONE );
 
     // Show Image
-    cv::imshow( "Depth", scaleMat );
+    sink->write( "Depth", depthScaleMat );
 }
\ No newline at end of file
@@ -4,8 +4,18 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Pipeline.h"
+#include "FrameSink.h"
+#include "Record.h"
+#include "DepthCodec.h"
+#include "Yuy2.h"
 
 #include <vector>
+#include <array>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <string>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -19,23 +29,63 @@ private:
     // Reader
     ComPtr<IMultiSourceFrameReader> multiSourceFrameReader;
 
-    // Color Buffer
-    std::vector<BYTE> colorBuffer;
+    // Audio Beam Reader ( Recorded Only, Open while Recording )
+    ComPtr<IAudioBeamFrameReader> audioBeamFrameReader;
+
+    // Color Buffer ( YUY2 )
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
-    cv::Mat depthMat;
+
+    // Infrared, Body Index, Body Buffer ( Recorded Only )
+    std::vector<UINT16> infraredBuffer;
+    std::vector<BYTE> bodyIndexBuffer;
+    std::array<RecordBody, BODY_COUNT> bodyBuffer;
+
+    // Recorder
+    RecordWriter recorder;
+    DepthEncoder depthEncoder;
+    std::vector<uint8_t> depthEncoded;
+    std::atomic<bool> recordToggle = { false };
+
+    // Replay ( Memory-Mapped Recording is Played instead of Sensor )
+    RecordReader player;
+    RecordDepthDecoder depthDecoder;
+    size_t replayFrame;
+    std::chrono::steady_clock::time_point replayBegin;
+
+    // Show Buffer ( Allocated Once, Reused by Show Stage )
+    cv::Mat depthScaleMat;
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Depth are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        const BYTE* colorData; // Color Buffer, or View into Mapped Recording on Replay
+        std::vector<UINT16> depthBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        cv::Mat colorMat;
+        cv::Mat depthMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame Sink ( Destination of Shown Images )
+    std::unique_ptr<FrameSink> sink;
+
+    // Number of Frames to Run ( 0 = Until Escape Key )
+    uint64_t frames;
 
 public:
-    // Constructor
-    Kinect();
+    // Constructor ( Frame Sink Specification, see CreateFrameSink(), and Recording to Replay instead of Sensor )
+    Kinect( const std::string& sink = "imshow", const uint64_t frames = 0, const std::string& replay = "" );
 
     // Destructor
     ~Kinect();
@@ -50,44 +100,71 @@ private:
     // Initialize Sensor
     inline void initializeSensor();
 
+    // Initialize Replay
+    inline void initializeReplay();
+
     // Initialize Multi Source
     inline void initializeMultiSource();
 
+    // Open Multi Source Reader
+    inline void openMultiSource( const bool record );
+
     // Initialize Color
     inline void initializeColor();
 
     // Initialize Depth
     inline void initializeDepth();
 
+    // Initialize Infrared, Body Index and Audio Beam ( Recorded Only )
+    inline void initializeRecordStreams();
+
+    // Toggle Recording
+    inline void toggleRecording();
+
     // Finalize
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
+
+    // Update Replay
+    inline bool updateReplay( Frame& frame );
 
     // Update Color
-    inline void updateColor( const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+    inline void updateColor( Frame& frame, const ComPtr<IMultiSourceFrame>& multiSourceFrame );
 
     // Update Depth
-    inline void updateDepth( const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+    inline void updateDepth( Frame& frame, const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+
+    // Update Infrared
+    inline void updateInfrared( const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+
+    // Update Body Index
+    inline void updateBodyIndex( const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+
+    // Update Body
+    inline void updateBody( const ComPtr<IMultiSourceFrame>& multiSourceFrame );
+
+    // Update Audio Beam
+    inline void updateAudioBeam();
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Depth
-    inline void drawDepth();
+    inline void drawDepth( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Color
-    inline void showColor();
+    inline void showColor( Frame& frame );
 
     // Show Depth
-    inline void showDepth();
+    inline void showDepth( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
@@ -1,12 +1,19 @@
 #include <iostream>
 #include <sstream>
+#include <string>
 
 #include "app.h"
 
 int main( int argc, char* argv[] )
 {
     try{
-        Kinect kinect;
+        // Frame Sink ( imshow, null, file:<directory> or shm:<prefix> ), Number of Frames ( 0 = Until Escape Key )
+        // and Recording to Replay instead of Sensor ( e.g. ../record.k2rec )
+        const std::string sink = ( argc > 1 ) ? argv[1] : "imshow";
+        const uint64_t frames = ( argc > 2 ) ? std::stoull( argv[2] ) : 0;
+        const std::string replay = ( argc > 3 ) ? argv[3] : "";
+
+        Kinect kinect( sink, frames, replay );
         kinect.run();
     } catch( std::exception& ex ){
         std::cout << ex.what() << std::endl;
@@ -0,0 +1,520 @@
+#ifndef __NORMAL_ESTIMATOR__
+#define __NORMAL_ESTIMATOR__
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "simd.h"
+#include "ThreadPool.h"
+
+// Normal Estimator for Organized Point Clouds
+//
+// Normal of a pixel is the eigenvector of the smallest eigenvalue of the covariance of valid points in a square window around it.
+// Window sums of count, XYZ and XYZ outer products are read from integral images ( 4 corners ), so a window costs the same at any size.
+// Window half size is smoothingRadius projected at depth of the pixel, and is limited so the window does not reach a depth discontinuity
+// ( jump between neighbor pixels larger than maxDepthChange x depth ), so normals are not blended across object boundaries.
+// Pixels next to a discontinuity or without enough points get NaN, as invalid points of the cloud.
+// Normals are oriented toward the camera. Integral images are summed in double, so covariance of small windows does not lose precision.
+// Passes run in parallel over tiles of rows ( columns for vertical integration ), results do not depend on the number of threads.
+class NormalEstimator
+{
+private:
+    // Channels of Integral Image ( Count, X, Y, Z, XX, XY, XZ, YY, YZ, ZZ, Padding to 3 AVX Vectors )
+    static const int channels = 12;
+    static const int tileRows = 8;
+    static const int tileColumns = 16;
+    static const int minPoints = 4;
+
+    float focalLength;
+    float smoothingRadius;
+    float maxDepthChange;
+    int maxRadius;
+
+    int width;
+    int height;
+    std::vector<double> integral;  // ( width + 1 ) x ( height + 1 ) x channels
+    std::vector<uint8_t> edges;    // Pixel has Discontinuity to Right or Bottom Neighbor
+    std::vector<uint8_t> horizontal; // Distance to Nearest Edge in Row ( Capped )
+    std::vector<uint8_t> distance; // Chessboard Distance to Nearest Edge ( Capped )
+    std::vector<float> scratch;    // Covariance, Point and Normal of a Row per Tile
+
+public:
+    // Constructor ( Focal Length in Pixels, Smoothing Radius in Meters, Max Depth Change Relative to Depth, Max Radius in Pixels )
+    NormalEstimator( const float focalLength = 365.0f, const float smoothingRadius = 0.015f, const float maxDepthChange = 0.02f, const int maxRadius = 8 )
+        : focalLength( focalLength ), smoothingRadius( smoothingRadius ), maxDepthChange( maxDepthChange ), maxRadius( maxRadius ), width( 0 ), height( 0 )
+    {
+        if( !( focalLength > 0.0f ) || !( smoothingRadius > 0.0f ) || !( maxDepthChange > 0.0f ) || maxRadius < 1 || maxRadius > 100 ){
+            throw std::invalid_argument( "invalid normal estimator parameters" );
+        }
+    }
+
+    // Estimate Normals of Organized Point Cloud
+    // Points are XYZ with pointStride floats per pixel ( NaN for invalid ), normals are written as XYZ with normalStride floats per pixel,
+    // e.g. stride 3 for cv::Mat of CV_32FC3, or stride 6 into normals of NUI_FUSION_IMAGE_TYPE_POINT_CLOUD layout ( normals = points + 3 ).
+    void estimate( const float* points, const int width, const int height, float* normals, const int pointStride = 3, const int normalStride = 3 )
+    {
+        if( points == nullptr || normals == nullptr || width <= 0 || height <= 0 || pointStride < 3 || normalStride < 3 ){
+            throw std::invalid_argument( "invalid normal estimation parameters" );
+        }
+
+        this->width = width;
+        this->height = height;
+        const size_t size = static_cast<size_t>( width ) * height;
+        integral.resize( static_cast<size_t>( width + 1 ) * ( height + 1 ) * channels );
+        edges.resize( size );
+        horizontal.resize( size );
+        distance.resize( size );
+        const size_t rowTiles = ( height + tileRows - 1 ) / tileRows;
+        scratch.resize( rowTiles * 12 * width );
+
+        ThreadPool& pool = ThreadPool::global();
+
+        // Integral Images ( Prefix Sums of Rows, then of Columns )
+        std::fill( integral.begin(), integral.begin() + static_cast<size_t>( width + 1 ) * channels, 0.0 );
+        pool.parallelFor( rowTiles, [&]( const size_t tile ){
+            const int end = ( std::min )( static_cast<int>( tile + 1 ) * tileRows, height );
+            for( int y = static_cast<int>( tile ) * tileRows; y < end; y++ ){
+                sumRow( points + static_cast<size_t>( y ) * width * pointStride, pointStride, &integral[static_cast<size_t>( y + 1 ) * ( width + 1 ) * channels] );
+            }
+        } );
+        const size_t columnTiles = ( width + 1 + tileColumns - 1 ) / tileColumns;
+        pool.parallelFor( columnTiles, [&]( const size_t tile ){
+            const int begin = static_cast<int>( tile ) * tileColumns;
+            const int end = ( std::min )( begin + tileColumns, width + 1 );
+            sumColumns( begin, end );
+        } );
+
+        // Depth Discontinuities and Horizontal Distance
+        const int cap = maxRadius + 1;
+        pool.parallelFor( rowTiles, [&]( const size_t tile ){
+            const int end = ( std::min )( static_cast<int>( tile + 1 ) * tileRows, height );
+            for( int y = static_cast<int>( tile ) * tileRows; y < end; y++ ){
+                findEdges( points, pointStride, y, cap );
+            }
+        } );
+
+        // Chessboard Distance ( Minimum of Horizontal Distance of Rows within Cap )
+        pool.parallelFor( rowTiles, [&]( const size_t tile ){
+            const int end = ( std::min )( static_cast<int>( tile + 1 ) * tileRows, height );
+            for( int y = static_cast<int>( tile ) * tileRows; y < end; y++ ){
+                uint8_t* row = &distance[static_cast<size_t>( y ) * width];
+                std::fill( row, row + width, static_cast<uint8_t>( cap ) );
+                const int beginY = ( std::max )( y - cap + 1, 0 );
+                const int endY = ( std::min )( y + cap, height );
+                for( int neighbor = beginY; neighbor < endY; neighbor++ ){
+                    const uint8_t offset = static_cast<uint8_t>( std::abs( neighbor - y ) );
+                    const uint8_t* source = &horizontal[static_cast<size_t>( neighbor ) * width];
+                    for( int x = 0; x < width; x++ ){
+                        row[x] = ( std::min )( row[x], ( std::max )( source[x], offset ) );
+                    }
+                }
+            }
+        } );
+
+        // Covariance and Normal per Pixel
+        pool.parallelFor( rowTiles, [&]( const size_t tile ){
+            float* buffer = &scratch[tile * 12 * width];
+            const int end = ( std::min )( static_cast<int>( tile + 1 ) * tileRows, height );
+            for( int y = static_cast<int>( tile ) * tileRows; y < end; y++ ){
+                estimateRow( points, pointStride, y, buffer, normals + static_cast<size_t>( y ) * width * normalStride, normalStride );
+            }
+        } );
+    }
+
+private:
+    // Check Point is Valid
+    static bool isValid( const float* point )
+    {
+        return point[2] > 0.0f && std::isfinite( point[0] + point[1] + point[2] );
+    }
+
+    // Prefix Sums of Row ( Column 0 is Zero )
+    void sumRow( const float* points, const int pointStride, double* row ) const
+    {
+        std::fill( row, row + channels, 0.0 );
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            sumRowAVX2( points, pointStride, row );
+            return;
+        }
+#endif
+
+        double sums[channels] = { 0.0 };
+        for( int x = 0; x < width; x++ ){
+            const float* point = points + static_cast<size_t>( x ) * pointStride;
+            if( isValid( point ) ){
+                const double px = point[0];
+                const double py = point[1];
+                const double pz = point[2];
+                sums[0] += 1.0;
+                sums[1] += px;
+                sums[2] += py;
+                sums[3] += pz;
+                sums[4] += px * px;
+                sums[5] += px * py;
+                sums[6] += px * pz;
+                sums[7] += py * py;
+                sums[8] += py * pz;
+                sums[9] += pz * pz;
+            }
+            std::copy( sums, sums + channels, row + ( x + 1 ) * channels );
+        }
+    }
+
+    // Prefix Sums of Columns [begin, end) over Rows
+    void sumColumns( const int begin, const int end )
+    {
+        const size_t stride = static_cast<size_t>( width + 1 ) * channels;
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            sumColumnsAVX2( begin, end, stride );
+            return;
+        }
+#endif
+
+        for( int y = 1; y <= height; y++ ){
+            double* row = &integral[y * stride];
+            const double* previous = row - stride;
+            for( int i = begin * channels; i < end * channels; i++ ){
+                row[i] += previous[i];
+            }
+        }
+    }
+
+    // Find Discontinuities of Row and Horizontal Distance to Them
+    void findEdges( const float* points, const int pointStride, const int y, const int cap )
+    {
+        uint8_t* edge = &edges[static_cast<size_t>( y ) * width];
+        for( int x = 0; x < width; x++ ){
+            const float* point = points + ( static_cast<size_t>( y ) * width + x ) * pointStride;
+            edge[x] = 0;
+            if( !isValid( point ) ){
+                continue;
+            }
+
+            const float threshold = maxDepthChange * point[2];
+            if( x + 1 < width ){
+                const float* right = point + pointStride;
+                if( isValid( right ) && std::abs( right[2] - point[2] ) > threshold ){
+                    edge[x] = 1;
+                }
+            }
+            if( y + 1 < height ){
+                const float* bottom = point + static_cast<size_t>( width ) * pointStride;
+                if( isValid( bottom ) && std::abs( bottom[2] - point[2] ) > threshold ){
+                    edge[x] = 1;
+                }
+            }
+        }
+
+        // Distance to Nearest Edge in Row ( Forward and Backward )
+        uint8_t* row = &horizontal[static_cast<size_t>( y ) * width];
+        int last = -cap;
+        for( int x = 0; x < width; x++ ){
+            if( edge[x] ){
+                last = x;
+            }
+            row[x] = static_cast<uint8_t>( ( std::min )( x - last, cap ) );
+        }
+        last = width - 1 + cap;
+        for( int x = width - 1; x >= 0; x-- ){
+            if( edge[x] ){
+                last = x;
+            }
+            row[x] = ( std::min )( row[x], static_cast<uint8_t>( ( std::min )( last - x, cap ) ) );
+        }
+    }
+
+    // Estimate Normals of Row
+    void estimateRow( const float* points, const int pointStride, const int y, float* buffer, float* normals, const int normalStride ) const
+    {
+        // Buffer of Row ( Normalized Covariance a b c / d e / f, Point, Normal )
+        float* a = buffer;
+        float* b = a + width;
+        float* c = b + width;
+        float* d = c + width;
+        float* e = d + width;
+        float* f = e + width;
+        float* px = f + width;
+        float* py = px + width;
+        float* pz = py + width;
+        float* nx = pz + width;
+        float* ny = nx + width;
+        float* nz = ny + width;
+
+        // Covariance of Window
+        const size_t stride = static_cast<size_t>( width + 1 ) * channels;
+        const float scale = smoothingRadius * focalLength;
+        for( int x = 0; x < width; x++ ){
+            const float* point = points + ( static_cast<size_t>( y ) * width + x ) * pointStride;
+            a[x] = b[x] = c[x] = d[x] = e[x] = f[x] = 0.0f;
+            px[x] = point[0];
+            py[x] = point[1];
+            pz[x] = point[2];
+            if( !isValid( point ) ){
+                continue;
+            }
+
+            // Window Half Size ( Projected Smoothing Radius, within Distance to Discontinuity )
+            const int projected = static_cast<int>( scale / point[2] );
+            const int radius = ( std::min )( ( std::min )( projected, maxRadius ), distance[static_cast<size_t>( y ) * width + x] - 1 );
+            if( radius < 1 ){
+                continue;
+            }
+
+            const int x0 = ( std::max )( x - radius, 0 );
+            const int x1 = ( std::min )( x + radius + 1, width );
+            const int y0 = ( std::max )( y - radius, 0 );
+            const int y1 = ( std::min )( y + radius + 1, height );
+            double sums[channels];
+            sumWindow( &integral[y0 * stride + x0 * channels], &integral[y0 * stride + x1 * channels], &integral[y1 * stride + x0 * channels], &integral[y1 * stride + x1 * channels], sums );
+            if( sums[0] < minPoints ){
+                continue;
+            }
+
+            // Covariance Normalized by Trace
+            const double inverse = 1.0 / sums[0];
+            const double mx = sums[1] * inverse;
+            const double my = sums[2] * inverse;
+            const double mz = sums[3] * inverse;
+            const double xx = sums[4] * inverse - mx * mx;
+            const double xy = sums[5] * inverse - mx * my;
+            const double xz = sums[6] * inverse - mx * mz;
+            const double yy = sums[7] * inverse - my * my;
+            const double yz = sums[8] * inverse - my * mz;
+            const double zz = sums[9] * inverse - mz * mz;
+            const double trace = xx + yy + zz;
+            if( !( trace > 0.0 ) ){
+                continue;
+            }
+            const double normalize = 1.0 / trace;
+            a[x] = static_cast<float>( xx * normalize );
+            b[x] = static_cast<float>( xy * normalize );
+            c[x] = static_cast<float>( xz * normalize );
+            d[x] = static_cast<float>( yy * normalize );
+            e[x] = static_cast<float>( yz * normalize );
+            f[x] = static_cast<float>( zz * normalize );
+        }
+
+        // Smallest Eigenvector
+        int x = 0;
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            for( ; x + 8 <= width; x += 8 ){
+                solveAVX2( a + x, b + x, c + x, d + x, e + x, f + x, px + x, py + x, pz + x, nx + x, ny + x, nz + x );
+            }
+        }
+#endif
+
+        for( ; x < width; x++ ){
+            solve( a[x], b[x], c[x], d[x], e[x], f[x], px[x], py[x], pz[x], nx[x], ny[x], nz[x] );
+        }
+
+        // Write Normals
+        for( x = 0; x < width; x++ ){
+            float* normal = normals + static_cast<size_t>( x ) * normalStride;
+            normal[0] = nx[x];
+            normal[1] = ny[x];
+            normal[2] = nz[x];
+        }
+    }
+
+    // Sum of Window from Corners of Integral Image
+    static void sumWindow( const double* topLeft, const double* topRight, const double* bottomLeft, const double* bottomRight, double* sums )
+    {
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            sumWindowAVX2( topLeft, topRight, bottomLeft, bottomRight, sums );
+            return;
+        }
+#endif
+
+        for( int i = 0; i < channels; i++ ){
+            sums[i] = bottomRight[i] - bottomLeft[i] - topRight[i] + topLeft[i];
+        }
+    }
+
+    // Eigenvector of Smallest Eigenvalue of Symmetric Matrix ( a b c / b d e / c e f, Trace 1 ), Oriented toward Camera ( NaN if Degenerate )
+    //
+    // Smallest eigenvalue is root of characteristic polynomial q( l ) = l^3 - l^2 + m l - det by Newton iterations from 0.
+    // q is increasing and concave left of its smallest root, so iterations approach it from left without overshoot.
+    // Eigenvector is the longest cross product of rows of ( C - l I ).
+    static void solve( const float a, const float b, const float c, const float d, const float e, const float f,
+                       const float px, const float py, const float pz, float& nx, float& ny, float& nz )
+    {
+        const float m = ( a * d - b * b ) + ( a * f - c * c ) + ( d * f - e * e );
+        const float determinant = a * ( d * f - e * e ) - b * ( b * f - c * e ) + c * ( b * e - c * d );
+        float lambda = 0.0f;
+        for( int i = 0; i < 4; i++ ){
+            const float q = ( ( lambda - 1.0f ) * lambda + m ) * lambda - determinant;
+            const float slope = ( 3.0f * lambda - 2.0f ) * lambda + m;
+            if( slope > 1e-12f ){
+                lambda -= q / slope;
+            }
+        }
+
+        // Rows of ( C - l I )
+        const float r0[3] = { a - lambda, b, c };
+        const float r1[3] = { b, d - lambda, e };
+        const float r2[3] = { c, e, f - lambda };
+        float candidates[3][3] = {
+            { r0[1] * r1[2] - r0[2] * r1[1], r0[2] * r1[0] - r0[0] * r1[2], r0[0] * r1[1] - r0[1] * r1[0] },
+            { r0[1] * r2[2] - r0[2] * r2[1], r0[2] * r2[0] - r0[0] * r2[2], r0[0] * r2[1] - r0[1] * r2[0] },
+            { r1[1] * r2[2] - r1[2] * r2[1], r1[2] * r2[0] - r1[0] * r2[2], r1[0] * r2[1] - r1[1] * r2[0] }
+        };
+        int best = 0;
+        float bestLength = 0.0f;
+        for( int i = 0; i < 3; i++ ){
+            const float length = candidates[i][0] * candidates[i][0] + candidates[i][1] * candidates[i][1] + candidates[i][2] * candidates[i][2];
+            if( length > bestLength ){
+                best = i;
+                bestLength = length;
+            }
+        }
+        if( !( bestLength > 1e-8f ) ){
+            nx = ny = nz = std::numeric_limits<float>::quiet_NaN();
+            return;
+        }
+
+        // Normalize and Orient toward Camera
+        float inverse = 1.0f / std::sqrt( bestLength );
+        if( candidates[best][0] * px + candidates[best][1] * py + candidates[best][2] * pz > 0.0f ){
+            inverse = -inverse;
+        }
+        nx = candidates[best][0] * inverse;
+        ny = candidates[best][1] * inverse;
+        nz = candidates[best][2] * inverse;
+    }
+
+#ifdef SIMD_X86
+    // Prefix Sums of Row ( 3 AVX Vectors per Pixel )
+    SIMD_TARGET_AVX2
+    void sumRowAVX2( const float* points, const int pointStride, double* row ) const
+    {
+        __m256d sums0 = _mm256_setzero_pd();
+        __m256d sums1 = _mm256_setzero_pd();
+        __m256d sums2 = _mm256_setzero_pd();
+        for( int x = 0; x < width; x++ ){
+            const float* point = points + static_cast<size_t>( x ) * pointStride;
+            if( isValid( point ) ){
+                const __m256d p = _mm256_setr_pd( 1.0, point[0], point[1], point[2] );
+                const __m256d xxxy = _mm256_permute4x64_pd( p, _MM_SHUFFLE( 2, 1, 1, 1 ) );     // x x x y
+                const __m256d xyzy = _mm256_permute4x64_pd( p, _MM_SHUFFLE( 2, 3, 2, 1 ) );     // x y z y
+                const __m256d yz = _mm256_permute4x64_pd( p, _MM_SHUFFLE( 0, 0, 3, 2 ) );       // y z 1 1
+                const __m256d zz = _mm256_setr_pd( point[2], point[2], 0.0, 0.0 );
+                sums0 = _mm256_add_pd( sums0, p );
+                sums1 = _mm256_fmadd_pd( xxxy, xyzy, sums1 );
+                sums2 = _mm256_fmadd_pd( yz, zz, sums2 );
+            }
+            double* target = row + ( x + 1 ) * channels;
+            _mm256_storeu_pd( target + 0, sums0 );
+            _mm256_storeu_pd( target + 4, sums1 );
+            _mm256_storeu_pd( target + 8, sums2 );
+        }
+    }
+
+    // Prefix Sums of Columns
+    SIMD_TARGET_AVX2
+    void sumColumnsAVX2( const int begin, const int end, const size_t stride )
+    {
+        for( int y = 1; y <= height; y++ ){
+            double* row = &integral[y * stride];
+            const double* previous = row - stride;
+            for( int i = begin * channels; i < end * channels; i += 4 ){
+                _mm256_storeu_pd( row + i, _mm256_add_pd( _mm256_loadu_pd( row + i ), _mm256_loadu_pd( previous + i ) ) );
+            }
+        }
+    }
+
+    // Sum of Window
+    SIMD_TARGET_AVX2
+    static void sumWindowAVX2( const double* topLeft, const double* topRight, const double* bottomLeft, const double* bottomRight, double* sums )
+    {
+        for( int i = 0; i < channels; i += 4 ){
+            const __m256d outer = _mm256_add_pd( _mm256_loadu_pd( bottomRight + i ), _mm256_loadu_pd( topLeft + i ) );
+            const __m256d inner = _mm256_add_pd( _mm256_loadu_pd( bottomLeft + i ), _mm256_loadu_pd( topRight + i ) );
+            _mm256_storeu_pd( sums + i, _mm256_sub_pd( outer, inner ) );
+        }
+    }
+
+    // Eigenvector of Smallest Eigenvalue of 8 Matrices ( Same Steps as solve )
+    SIMD_TARGET_AVX2
+    static void solveAVX2( const float* a, const float* b, const float* c, const float* d, const float* e, const float* f,
+                           const float* px, const float* py, const float* pz, float* nx, float* ny, float* nz )
+    {
+        const __m256 va = _mm256_loadu_ps( a );
+        const __m256 vb = _mm256_loadu_ps( b );
+        const __m256 vc = _mm256_loadu_ps( c );
+        const __m256 vd = _mm256_loadu_ps( d );
+        const __m256 ve = _mm256_loadu_ps( e );
+        const __m256 vf = _mm256_loadu_ps( f );
+        const __m256 one = _mm256_set1_ps( 1.0f );
+        const __m256 two = _mm256_set1_ps( 2.0f );
+        const __m256 three = _mm256_set1_ps( 3.0f );
+
+        const __m256 df_ee = _mm256_fmsub_ps( vd, vf, _mm256_mul_ps( ve, ve ) );
+        const __m256 bf_ce = _mm256_fmsub_ps( vb, vf, _mm256_mul_ps( vc, ve ) );
+        const __m256 be_cd = _mm256_fmsub_ps( vb, ve, _mm256_mul_ps( vc, vd ) );
+        const __m256 m = _mm256_add_ps( _mm256_add_ps( _mm256_fmsub_ps( va, vd, _mm256_mul_ps( vb, vb ) ), _mm256_fmsub_ps( va, vf, _mm256_mul_ps( vc, vc ) ) ), df_ee );
+        const __m256 determinant = _mm256_fmadd_ps( vc, be_cd, _mm256_fmsub_ps( va, df_ee, _mm256_mul_ps( vb, bf_ce ) ) );
+        __m256 lambda = _mm256_setzero_ps();
+        for( int i = 0; i < 4; i++ ){
+            const __m256 q = _mm256_fmsub_ps( _mm256_fmadd_ps( _mm256_sub_ps( lambda, one ), lambda, m ), lambda, determinant );
+            const __m256 slope = _mm256_fmadd_ps( _mm256_fmsub_ps( three, lambda, two ), lambda, m );
+            const __m256 valid = _mm256_cmp_ps( slope, _mm256_set1_ps( 1e-12f ), _CMP_GT_OQ );
+            lambda = _mm256_blendv_ps( lambda, _mm256_sub_ps( lambda, _mm256_div_ps( q, slope ) ), valid );
+        }
+
+        // Cross Products of Rows of ( C - l I )
+        const __m256 al = _mm256_sub_ps( va, lambda );
+        const __m256 dl = _mm256_sub_ps( vd, lambda );
+        const __m256 fl = _mm256_sub_ps( vf, lambda );
+        // r0 x r1 = ( a b c ) x ( b d e )
+        const __m256 x01 = _mm256_fmsub_ps( vb, ve, _mm256_mul_ps( vc, dl ) );
+        const __m256 y01 = _mm256_fmsub_ps( vc, vb, _mm256_mul_ps( al, ve ) );
+        const __m256 z01 = _mm256_fmsub_ps( al, dl, _mm256_mul_ps( vb, vb ) );
+        // r0 x r2 = ( a b c ) x ( c e f )
+        const __m256 x02 = _mm256_fmsub_ps( vb, fl, _mm256_mul_ps( vc, ve ) );
+        const __m256 y02 = _mm256_fmsub_ps( vc, vc, _mm256_mul_ps( al, fl ) );
+        const __m256 z02 = _mm256_fmsub_ps( al, ve, _mm256_mul_ps( vb, vc ) );
+        // r1 x r2 = ( b d e ) x ( c e f )
+        const __m256 x12 = _mm256_fmsub_ps( dl, fl, _mm256_mul_ps( ve, ve ) );
+        const __m256 y12 = _mm256_fmsub_ps( ve, vc, _mm256_mul_ps( vb, fl ) );
+        const __m256 z12 = _mm256_fmsub_ps( vb, ve, _mm256_mul_ps( dl, vc ) );
+        const __m256 length01 = _mm256_fmadd_ps( z01, z01, _mm256_fmadd_ps( y01, y01, _mm256_mul_ps( x01, x01 ) ) );
+        const __m256 length02 = _mm256_fmadd_ps( z02, z02, _mm256_fmadd_ps( y02, y02, _mm256_mul_ps( x02, x02 ) ) );
+        const __m256 length12 = _mm256_fmadd_ps( z12, z12, _mm256_fmadd_ps( y12, y12, _mm256_mul_ps( x12, x12 ) ) );
+
+        // Longest ( First on Tie, as solve )
+        const __m256 use02 = _mm256_cmp_ps( length02, length01, _CMP_GT_OQ );
+        __m256 length = _mm256_blendv_ps( length01, length02, use02 );
+        __m256 vx = _mm256_blendv_ps( x01, x02, use02 );
+        __m256 vy = _mm256_blendv_ps( y01, y02, use02 );
+        __m256 vz = _mm256_blendv_ps( z01, z02, use02 );
+        const __m256 use12 = _mm256_cmp_ps( length12, length, _CMP_GT_OQ );
+        length = _mm256_blendv_ps( length, length12, use12 );
+        vx = _mm256_blendv_ps( vx, x12, use12 );
+        vy = _mm256_blendv_ps( vy, y12, use12 );
+        vz = _mm256_blendv_ps( vz, z12, use12 );
+
+        // Normalize and Orient toward Camera ( NaN if Degenerate )
+        const __m256 facing = _mm256_fmadd_ps( vz, _mm256_loadu_ps( pz ), _mm256_fmadd_ps( vy, _mm256_loadu_ps( py ), _mm256_mul_ps( vx, _mm256_loadu_ps( px ) ) ) );
+        __m256 inverse = _mm256_div_ps( one, _mm256_sqrt_ps( length ) );
+        inverse = _mm256_blendv_ps( inverse, _mm256_sub_ps( _mm256_setzero_ps(), inverse ), _mm256_cmp_ps( facing, _mm256_setzero_ps(), _CMP_GT_OQ ) );
+        inverse = _mm256_blendv_ps( _mm256_set1_ps( std::numeric_limits<float>::quiet_NaN() ), inverse, _mm256_cmp_ps( length, _mm256_set1_ps( 1e-8f ), _CMP_GT_OQ ) );
+        _mm256_storeu_ps( nx, _mm256_mul_ps( vx, inverse ) );
+        _mm256_storeu_ps( ny, _mm256_mul_ps( vy, inverse ) );
+        _mm256_storeu_ps( nz, _mm256_mul_ps( vz, inverse ) );
+    }
+#endif
+};
+
+#endif // __NORMAL_ESTIMATOR__
\ No newline at end of file
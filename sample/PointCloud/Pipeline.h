@@ -0,0 +1,422 @@
+#ifndef __PIPELINE__
+#define __PIPELINE__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Bounded Lock-Free Single Producer Single Consumer Queue with Drop-Oldest Policy
+// When the queue is full, push() removes the oldest value and returns it to the producer.
+// T must be trivially copyable ( e.g. index of a frame ), so a value is read before it is claimed by CAS on the read index.
+template<typename T>
+class DropOldestQueue
+{
+private:
+    static_assert( std::is_trivially_copyable<T>::value, "DropOldestQueue requires trivially copyable type" );
+
+    std::vector<std::atomic<T>> slots;
+    alignas( 64 ) std::atomic<uint64_t> head;
+    alignas( 64 ) std::atomic<uint64_t> tail;
+
+public:
+    // Constructor
+    explicit DropOldestQueue( const size_t capacity )
+        : slots( capacity ), head( 0 ), tail( 0 )
+    {
+        if( capacity == 0 ){
+            throw std::invalid_argument( "invalid queue capacity" );
+        }
+    }
+
+    DropOldestQueue( const DropOldestQueue& ) = delete;
+    DropOldestQueue& operator=( const DropOldestQueue& ) = delete;
+
+    // Push Value ( Producer Only, Returns true if Oldest Value was Dropped )
+    bool push( const T value, T& dropped )
+    {
+        const uint64_t write = tail.load( std::memory_order_relaxed );
+        bool drop = false;
+
+        uint64_t read = head.load( std::memory_order_acquire );
+        while( write - read >= slots.size() ){
+            const T oldest = slots[read % slots.size()].load( std::memory_order_relaxed );
+            if( head.compare_exchange_weak( read, read + 1, std::memory_order_acq_rel, std::memory_order_acquire ) ){
+                dropped = oldest;
+                drop = true;
+                break;
+            }
+        }
+
+        slots[write % slots.size()].store( value, std::memory_order_relaxed );
+        tail.store( write + 1, std::memory_order_release );
+        return drop;
+    }
+
+    // Pop Value ( Consumer Only, Returns false if Empty )
+    bool pop( T& value )
+    {
+        uint64_t read = head.load( std::memory_order_acquire );
+        while( read != tail.load( std::memory_order_acquire ) ){
+            const T oldest = slots[read % slots.size()].load( std::memory_order_relaxed );
+            if( head.compare_exchange_weak( read, read + 1, std::memory_order_acq_rel, std::memory_order_acquire ) ){
+                value = oldest;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Retrieve Number of Values ( Approximate )
+    size_t size() const
+    {
+        return static_cast<size_t>( tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire ) );
+    }
+
+    // Retrieve Capacity
+    size_t capacity() const
+    {
+        return slots.size();
+    }
+};
+
+// Pipeline Stage
+enum PipelineStage
+{
+    PipelineStage_Acquire  = 0,
+    PipelineStage_Process  = 1,
+    PipelineStage_Present  = 2,
+    PipelineStage_EndToEnd = 3, // Acquire Begin -> Present End
+    PipelineStage_Count    = 4
+};
+
+// Pipeline Statistics ( Latency in Milliseconds )
+struct PipelineStatistics
+{
+    uint64_t frames;
+    uint64_t dropped; // Frames Dropped from Input Queue of Stage
+    double averageLatency;
+    double maxLatency;
+};
+
+// Asynchronous Frame Pipeline ( Acquire -> Process -> Present )
+// Acquire and process stages run on dedicated threads, present stage runs on the thread that calls run(),
+// because GUI ( e.g. cv::imshow and cv::waitKey ) has to stay on one thread.
+// Frames are preallocated and recycled, stages are connected by DropOldestQueue, so a slow stage drops old frames instead of stalling acquisition.
+template<typename Frame>
+class Pipeline
+{
+public:
+    // Stage Functions
+    typedef std::function<bool( Frame& )> AcquireFunction; // Returns false if no New Frame
+    typedef std::function<void( Frame& )> ProcessFunction;
+    typedef std::function<void( Frame& )> PresentFunction;
+    typedef std::function<bool()> IdleFunction; // Called every Present Loop, Returns false to Stop
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // Frame Slot
+    struct Slot
+    {
+        Frame frame;
+        Clock::time_point acquired;
+        std::atomic<int> used;
+    };
+
+    // Latency Counter ( Single Writer )
+    struct Counter
+    {
+        std::atomic<uint64_t> frames;
+        std::atomic<uint64_t> dropped;
+        std::atomic<uint64_t> total;
+        std::atomic<uint64_t> maximum;
+
+        void reset()
+        {
+            frames.store( 0 );
+            dropped.store( 0 );
+            total.store( 0 );
+            maximum.store( 0 );
+        }
+
+        void add( const Clock::duration latency )
+        {
+            const uint64_t nanoseconds = static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>( latency ).count() );
+            frames.store( frames.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+            total.store( total.load( std::memory_order_relaxed ) + nanoseconds, std::memory_order_relaxed );
+            if( maximum.load( std::memory_order_relaxed ) < nanoseconds ){
+                maximum.store( nanoseconds, std::memory_order_relaxed );
+            }
+        }
+
+        void drop()
+        {
+            dropped.store( dropped.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+        }
+    };
+
+    std::vector<Slot> slots;
+    DropOldestQueue<uint32_t> acquired;
+    DropOldestQueue<uint32_t> processed;
+    Counter counters[PipelineStage_Count];
+
+    std::atomic<bool> running;
+    Clock::time_point begin;
+    Clock::time_point end;
+    std::mutex mutex;
+    std::exception_ptr exception;
+
+public:
+    // Constructor ( Capacity of Queues between Stages )
+    explicit Pipeline( const size_t capacity = 2 )
+        : slots( capacity * 2 + 3 ), acquired( capacity ), processed( capacity ), running( false )
+    {
+        for( size_t i = 0; i < slots.size(); i++ ){
+            slots[i].used.store( 0 );
+        }
+
+        for( int stage = 0; stage < PipelineStage_Count; stage++ ){
+            counters[stage].reset();
+        }
+    }
+
+    Pipeline( const Pipeline& ) = delete;
+    Pipeline& operator=( const Pipeline& ) = delete;
+
+    // Retrieve Frames ( e.g. to Allocate Buffers before run() )
+    template<typename Function>
+    void forEachFrame( Function function )
+    {
+        for( size_t i = 0; i < slots.size(); i++ ){
+            function( slots[i].frame );
+        }
+    }
+
+    // Retrieve Number of Frames ( e.g. to Allocate Frame Buffer Pool with One Buffer per Frame )
+    size_t size() const
+    {
+        return slots.size();
+    }
+
+    // Run Pipeline until idle() Returns false or stop() is Called ( Exceptions of Stages are Rethrown )
+    void run( AcquireFunction acquire, ProcessFunction process, PresentFunction present, IdleFunction idle )
+    {
+        exception = nullptr;
+        running.store( true );
+        begin = Clock::now();
+        end = begin;
+
+        std::thread acquireThread( [&](){
+            guard( [&](){ acquireLoop( acquire ); } );
+        } );
+        std::thread processThread( [&](){
+            guard( [&](){ processLoop( process ); } );
+        } );
+
+        guard( [&](){ presentLoop( present, idle ); } );
+
+        running.store( false );
+        end = Clock::now();
+        acquireThread.join();
+        processThread.join();
+
+        // Return Frames Remaining in Queues
+        uint32_t index;
+        while( acquired.pop( index ) ){
+            release( index );
+        }
+        while( processed.pop( index ) ){
+            release( index );
+        }
+
+        if( exception != nullptr ){
+            std::rethrow_exception( exception );
+        }
+    }
+
+    // Stop Pipeline ( Any Thread )
+    void stop()
+    {
+        running.store( false );
+    }
+
+    // Check Running
+    bool isRunning() const
+    {
+        return running.load();
+    }
+
+    // Retrieve Statistics
+    PipelineStatistics statistics( const PipelineStage stage ) const
+    {
+        const Counter& counter = counters[stage];
+        PipelineStatistics statistics;
+        statistics.frames = counter.frames.load( std::memory_order_relaxed );
+        statistics.dropped = counter.dropped.load( std::memory_order_relaxed );
+        statistics.averageLatency = ( statistics.frames > 0 ) ? counter.total.load( std::memory_order_relaxed ) * 1e-6 / statistics.frames : 0.0;
+        statistics.maxLatency = counter.maximum.load( std::memory_order_relaxed ) * 1e-6;
+        return statistics;
+    }
+
+    // Retrieve Throughput of Last run() ( Presented Frames per Second )
+    double throughput() const
+    {
+        const double seconds = std::chrono::duration<double>( end - begin ).count();
+        return ( seconds > 0.0 ) ? counters[PipelineStage_Present].frames.load( std::memory_order_relaxed ) / seconds : 0.0;
+    }
+
+    // Print Statistics
+    void printStatistics( std::ostream& stream ) const
+    {
+        static const char* names[PipelineStage_Count] = { "Acquire", "Process", "Present", "End-to-End" };
+        for( int stage = 0; stage < PipelineStage_Count; stage++ ){
+            const PipelineStatistics statistics = this->statistics( static_cast<PipelineStage>( stage ) );
+            stream << names[stage] << " : " << statistics.frames << " frames, " << statistics.dropped << " dropped, "
+                   << statistics.averageLatency << " ms average, " << statistics.maxLatency << " ms max" << std::endl;
+        }
+        stream << "Throughput : " << throughput() << " fps" << std::endl;
+    }
+
+    // Reset Statistics
+    void resetStatistics()
+    {
+        for( int stage = 0; stage < PipelineStage_Count; stage++ ){
+            counters[stage].reset();
+        }
+    }
+
+private:
+    // Run Stage and Stop Pipeline on Exception
+    template<typename Function>
+    void guard( Function function )
+    {
+        try{
+            function();
+        }
+        catch( ... ){
+            std::lock_guard<std::mutex> lock( mutex );
+            if( exception == nullptr ){
+                exception = std::current_exception();
+            }
+            running.store( false );
+        }
+    }
+
+    // Wait with Backoff while Queue is Empty
+    static void wait( int& spins )
+    {
+        if( spins++ < 64 ){
+            std::this_thread::yield();
+        }
+        else{
+            std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        }
+    }
+
+    // Acquire Free Slot ( Always Succeeds, because Slots outnumber Frames in Flight )
+    uint32_t allocate()
+    {
+        while( true ){
+            for( size_t i = 0; i < slots.size(); i++ ){
+                int expected = 0;
+                if( slots[i].used.compare_exchange_strong( expected, 1, std::memory_order_acquire, std::memory_order_relaxed ) ){
+                    return static_cast<uint32_t>( i );
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Release Slot
+    void release( const uint32_t index )
+    {
+        slots[index].used.store( 0, std::memory_order_release );
+    }
+
+    // Acquire Stage
+    void acquireLoop( AcquireFunction& acquire )
+    {
+        int spins = 0;
+        uint32_t index = allocate();
+        while( running.load( std::memory_order_relaxed ) ){
+            Slot& slot = slots[index];
+            const Clock::time_point begin = Clock::now();
+            if( !acquire( slot.frame ) ){
+                wait( spins );
+                continue;
+            }
+            spins = 0;
+
+            slot.acquired = begin;
+            counters[PipelineStage_Acquire].add( Clock::now() - begin );
+
+            uint32_t dropped;
+            if( acquired.push( index, dropped ) ){
+                counters[PipelineStage_Process].drop();
+                release( dropped );
+            }
+            index = allocate();
+        }
+        release( index );
+    }
+
+    // Process Stage
+    void processLoop( ProcessFunction& process )
+    {
+        int spins = 0;
+        while( running.load( std::memory_order_relaxed ) ){
+            uint32_t index;
+            if( !acquired.pop( index ) ){
+                wait( spins );
+                continue;
+            }
+            spins = 0;
+
+            const Clock::time_point begin = Clock::now();
+            process( slots[index].frame );
+            counters[PipelineStage_Process].add( Clock::now() - begin );
+
+            uint32_t dropped;
+            if( processed.push( index, dropped ) ){
+                counters[PipelineStage_Present].drop();
+                release( dropped );
+            }
+        }
+    }
+
+    // Present Stage
+    void presentLoop( PresentFunction& present, IdleFunction& idle )
+    {
+        int spins = 0;
+        while( running.load( std::memory_order_relaxed ) ){
+            uint32_t index;
+            if( !processed.pop( index ) ){
+                wait( spins );
+            }
+            else{
+                spins = 0;
+                Slot& slot = slots[index];
+                const Clock::time_point begin = Clock::now();
+                present( slot.frame );
+                const Clock::time_point end = Clock::now();
+                counters[PipelineStage_Present].add( end - begin );
+                counters[PipelineStage_EndToEnd].add( end - slot.acquired );
+                release( index );
+            }
+
+            if( !idle() ){
+                break;
+            }
+        }
+    }
+};
+
+#endif // __PIPELINE__
\ No newline at end of file
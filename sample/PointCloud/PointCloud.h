@@ -0,0 +1,318 @@
+#ifndef __POINT_CLOUD__
+#define __POINT_CLOUD__
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "simd.h"
+
+// Point Cloud ( Structure of Arrays of Valid Points )
+// Buffers are allocated for a whole frame once and reused, only the first size elements are valid.
+struct PointCloud
+{
+    std::vector<float> x;          // Camera Space [m]
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<uint32_t> color;   // BGRA Registered to Depth ( 0 if no Color )
+    std::vector<uint32_t> indices; // Depth Pixel Index of Point ( y * width + x )
+    size_t size;
+    int width;                     // Size of Depth Frame
+    int height;
+
+    // Constructor
+    PointCloud()
+        : size( 0 ), width( 0 ), height( 0 )
+    {
+    }
+
+    // Allocate Buffers for Frame ( Padded for Vector Stores )
+    void allocate( const int width, const int height )
+    {
+        this->width = width;
+        this->height = height;
+        const size_t capacity = static_cast<size_t>( width ) * height + 8;
+        if( x.size() < capacity ){
+            x.resize( capacity );
+            y.resize( capacity );
+            z.resize( capacity );
+            color.resize( capacity );
+            indices.resize( capacity );
+        }
+        size = 0;
+    }
+};
+
+// Point Cloud Generator
+//
+// Back-projects depth with per-pixel ray tables ( x/z, y/z, e.g. ICoordinateMapper::GetDepthFrameToCameraSpaceTable ),
+// so a point costs two multiplies instead of a call of ICoordinateMapper::MapDepthFrameToCameraSpace for every frame.
+// Organized output keeps the frame layout with NaN for invalid pixels ( cv::Mat of CV_32FC3 for cv::viz::WCloud ),
+// compacted output stores valid points only, so consumers iterate only valid points.
+class PointCloudGenerator
+{
+private:
+    int width;
+    int height;
+    uint16_t minDepth;
+    uint16_t maxDepth;
+
+    // Ray Tables ( NaN for Pixels without Ray )
+    std::vector<float> rayX;
+    std::vector<float> rayY;
+
+public:
+    // Constructor ( Valid Depth Range [ minDepth, maxDepth ) in Millimeters )
+    PointCloudGenerator( const uint16_t minDepth = 500, const uint16_t maxDepth = 8000 )
+        : width( 0 ), height( 0 ), minDepth( minDepth ), maxDepth( maxDepth )
+    {
+    }
+
+    // Initialize from Ray Table ( Point is any type with float members X and Y, PointF of GetDepthFrameToCameraSpaceTable )
+    template<typename Point>
+    bool initialize( const int width, const int height, const Point* table )
+    {
+        if( width <= 0 || height <= 0 || table == nullptr ){
+            throw std::invalid_argument( "invalid point cloud generator parameters" );
+        }
+
+        this->width = width;
+        this->height = height;
+
+        const size_t size = static_cast<size_t>( width ) * height;
+        rayX.resize( size );
+        rayY.resize( size );
+        size_t valid = 0;
+        for( size_t index = 0; index < size; index++ ){
+            const float x = table[index].X;
+            const float y = table[index].Y;
+            if( !std::isfinite( x ) || !std::isfinite( y ) ){
+                rayX[index] = rayY[index] = std::numeric_limits<float>::quiet_NaN();
+                continue;
+            }
+
+            rayX[index] = x;
+            rayY[index] = y;
+            if( x != 0.0f || y != 0.0f ){
+                valid++;
+            }
+        }
+
+        // Coordinate Mapper will return empty table until it has received the calibration from sensor
+        if( valid == 0 ){
+            rayX.clear();
+            rayY.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Retrieve Initialized
+    bool isInitialized() const
+    {
+        return !rayX.empty();
+    }
+
+    // Generate Organized Point Cloud ( XYZ per Pixel, NaN for Invalid Depth )
+    void generateOrganized( const uint16_t* depth, float* points ) const
+    {
+        generateOrganizedRows( depth, points, 0, height );
+    }
+
+    // Generate Rows of Organized Point Cloud
+    void generateOrganizedRows( const uint16_t* depth, float* points, const int beginY, const int endY ) const
+    {
+        const int begin = beginY * width;
+        const int end = endY * width;
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            generateOrganizedAVX2( depth, points, begin, end );
+            return;
+        }
+#endif
+
+        generateOrganizedScalar( depth, points, begin, end );
+    }
+
+    // Generate Compacted Point Cloud ( Valid Points Only, Color is Registered BGRA or nullptr ) and Returns Number of Points
+    size_t generateCompact( const uint16_t* depth, const uint32_t* color, PointCloud& cloud ) const
+    {
+        cloud.allocate( width, height );
+        const int end = width * height;
+
+#ifdef SIMD_X86
+        if( IsSupportedAVX2() ){
+            cloud.size = generateCompactAVX2( depth, color, cloud, 0, end );
+            return cloud.size;
+        }
+#endif
+
+        cloud.size = generateCompactScalar( depth, color, cloud, 0, end, 0 );
+        return cloud.size;
+    }
+
+    // Retrieve Frame Size
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    // Generate Organized Point Cloud ( Scalar )
+    void generateOrganizedScalar( const uint16_t* depth, float* points, const int begin, const int end ) const
+    {
+        const float invalid = std::numeric_limits<float>::quiet_NaN();
+        for( int index = begin; index < end; index++ ){
+            const uint16_t d = depth[index];
+            float* point = points + static_cast<size_t>( index ) * 3;
+            if( minDepth <= d && d < maxDepth && !std::isnan( rayX[index] ) ){
+                const float z = d * 0.001f;
+                point[0] = rayX[index] * z;
+                point[1] = rayY[index] * z;
+                point[2] = z;
+            }
+            else{
+                point[0] = point[1] = point[2] = invalid;
+            }
+        }
+    }
+
+    // Generate Compacted Point Cloud ( Scalar ) from Count Points
+    size_t generateCompactScalar( const uint16_t* depth, const uint32_t* color, PointCloud& cloud, const int begin, const int end, size_t count ) const
+    {
+        for( int index = begin; index < end; index++ ){
+            const uint16_t d = depth[index];
+            if( d < minDepth || maxDepth <= d || std::isnan( rayX[index] ) ){
+                continue;
+            }
+
+            const float z = d * 0.001f;
+            cloud.x[count] = rayX[index] * z;
+            cloud.y[count] = rayY[index] * z;
+            cloud.z[count] = z;
+            cloud.color[count] = ( color != nullptr ) ? color[index] : 0;
+            cloud.indices[count] = static_cast<uint32_t>( index );
+            count++;
+        }
+        return count;
+    }
+
+#ifdef SIMD_X86
+    // Left-Packing Permutations for 8 Lanes ( 4 bits per Lane Index ) and Number of Set Bits of Mask
+    struct PackTable
+    {
+        uint32_t permutation[256];
+        uint8_t count[256];
+
+        PackTable()
+        {
+            for( int mask = 0; mask < 256; mask++ ){
+                uint32_t packed = 0;
+                int lanes = 0;
+                for( int lane = 0; lane < 8; lane++ ){
+                    if( mask & ( 1 << lane ) ){
+                        packed |= static_cast<uint32_t>( lane ) << ( lanes * 4 );
+                        lanes++;
+                    }
+                }
+                permutation[mask] = packed;
+                count[mask] = static_cast<uint8_t>( lanes );
+            }
+        }
+    };
+
+    static const PackTable& packTable()
+    {
+        static const PackTable table;
+        return table;
+    }
+
+    // Valid Mask of 8 Pixels ( In Depth Range and Ray Exists )
+    SIMD_TARGET_AVX2
+    __m256i validMask( const __m256i depth32, const __m256 rays ) const
+    {
+        const __m256i lower = _mm256_cmpgt_epi32( depth32, _mm256_set1_epi32( static_cast<int>( minDepth ) - 1 ) );
+        const __m256i upper = _mm256_cmpgt_epi32( _mm256_set1_epi32( maxDepth ), depth32 );
+        const __m256i ordered = _mm256_castps_si256( _mm256_cmp_ps( rays, rays, _CMP_ORD_Q ) );
+        return _mm256_and_si256( _mm256_and_si256( lower, upper ), ordered );
+    }
+
+    // Generate Organized Point Cloud ( AVX2, 8 Pixels )
+    SIMD_TARGET_AVX2
+    void generateOrganizedAVX2( const uint16_t* depth, float* points, const int begin, const int end ) const
+    {
+        const __m256 scale = _mm256_set1_ps( 0.001f );
+        const __m256 invalid = _mm256_set1_ps( std::numeric_limits<float>::quiet_NaN() );
+
+        int index = begin;
+        for( ; index + 8 <= end; index += 8 ){
+            const __m256i depth32 = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth + index ) ) );
+            const __m256 rx = _mm256_loadu_ps( &rayX[index] );
+            const __m256 ry = _mm256_loadu_ps( &rayY[index] );
+            const __m256 valid = _mm256_castsi256_ps( validMask( depth32, rx ) );
+            const __m256 z = _mm256_blendv_ps( invalid, _mm256_mul_ps( _mm256_cvtepi32_ps( depth32 ), scale ), valid );
+            const __m256 x = _mm256_mul_ps( rx, z );
+            const __m256 y = _mm256_mul_ps( ry, z );
+
+            // Interleave to XYZ ( 3 x 8 Transpose )
+            // x = x0..x7, after shuffles t0 = x0 y0 z0 x1 | x4 y4 z4 x5, t1 = y1 z1 x2 y2 | y5 z5 x6 y6, t2 = z2 x3 y3 z3 | z6 x7 y7 z7
+            const __m256 xy = _mm256_shuffle_ps( x, y, _MM_SHUFFLE( 2, 0, 2, 0 ) ); // x0 x2 y0 y2 | x4 x6 y4 y6
+            const __m256 yz = _mm256_shuffle_ps( y, z, _MM_SHUFFLE( 3, 1, 3, 1 ) ); // y1 y3 z1 z3 | y5 y7 z5 z7
+            const __m256 zx = _mm256_shuffle_ps( z, x, _MM_SHUFFLE( 3, 1, 2, 0 ) ); // z0 z2 x1 x3 | z4 z6 x5 x7
+            const __m256 t0 = _mm256_shuffle_ps( xy, zx, _MM_SHUFFLE( 2, 0, 2, 0 ) ); // x0 y0 z0 x1 | x4 y4 z4 x5
+            const __m256 t1 = _mm256_shuffle_ps( yz, xy, _MM_SHUFFLE( 3, 1, 2, 0 ) ); // y1 z1 x2 y2 | y5 z5 x6 y6
+            const __m256 t2 = _mm256_shuffle_ps( zx, yz, _MM_SHUFFLE( 3, 1, 3, 1 ) ); // z2 x3 y3 z3 | z6 x7 y7 z7
+
+            float* point = points + static_cast<size_t>( index ) * 3;
+            _mm256_storeu_ps( point, _mm256_permute2f128_ps( t0, t1, 0x20 ) );
+            _mm256_storeu_ps( point + 8, _mm256_permute2f128_ps( t2, t0, 0x30 ) );
+            _mm256_storeu_ps( point + 16, _mm256_permute2f128_ps( t1, t2, 0x31 ) );
+        }
+
+        generateOrganizedScalar( depth, points, index, end );
+    }
+
+    // Generate Compacted Point Cloud ( AVX2, 8 Pixels, Valid Lanes are Left-Packed and Stored Unaligned )
+    SIMD_TARGET_AVX2
+    size_t generateCompactAVX2( const uint16_t* depth, const uint32_t* color, PointCloud& cloud, const int begin, const int end ) const
+    {
+        const PackTable& table = packTable();
+        const __m256 scale = _mm256_set1_ps( 0.001f );
+        const __m256i shifts = _mm256_setr_epi32( 0, 4, 8, 12, 16, 20, 24, 28 );
+        const __m256i lanes = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+        const __m256i nibble = _mm256_set1_epi32( 0xf );
+
+        size_t count = 0;
+        int index = begin;
+        for( ; index + 8 <= end; index += 8 ){
+            const __m256i depth32 = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i*>( depth + index ) ) );
+            const __m256 rx = _mm256_loadu_ps( &rayX[index] );
+            const int mask = _mm256_movemask_ps( _mm256_castsi256_ps( validMask( depth32, rx ) ) );
+            if( mask == 0 ){
+                continue;
+            }
+
+            const __m256 z = _mm256_mul_ps( _mm256_cvtepi32_ps( depth32 ), scale );
+            const __m256 x = _mm256_mul_ps( rx, z );
+            const __m256 y = _mm256_mul_ps( _mm256_loadu_ps( &rayY[index] ), z );
+            const __m256i permutation = _mm256_and_si256( _mm256_srlv_epi32( _mm256_set1_epi32( static_cast<int>( table.permutation[mask] ) ), shifts ), nibble );
+
+            _mm256_storeu_ps( &cloud.x[count], _mm256_permutevar8x32_ps( x, permutation ) );
+            _mm256_storeu_ps( &cloud.y[count], _mm256_permutevar8x32_ps( y, permutation ) );
+            _mm256_storeu_ps( &cloud.z[count], _mm256_permutevar8x32_ps( z, permutation ) );
+            const __m256i pixels = ( color != nullptr ) ? _mm256_loadu_si256( reinterpret_cast<const __m256i*>( color + index ) ) : _mm256_setzero_si256();
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( &cloud.color[count] ), _mm256_permutevar8x32_epi32( pixels, permutation ) );
+            const __m256i indices = _mm256_add_epi32( _mm256_set1_epi32( index ), lanes );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( &cloud.indices[count] ), _mm256_permutevar8x32_epi32( indices, permutation ) );
+            count += table.count[mask];
+        }
+
+        return generateCompactScalar( depth, color, cloud, index, end, count );
+    }
+#endif
+};
+
+#endif // __POINT_CLOUD__
\ No newline at end of file
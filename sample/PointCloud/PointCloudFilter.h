@@ -0,0 +1,482 @@
+#ifndef __POINT_CLOUD_FILTER__
+#define __POINT_CLOUD_FILTER__
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+
+#include "PointCloud.h"
+#include "ThreadPool.h"
+
+// Point Grid ( Hashed Uniform Grid of Point Indices )
+//
+// Built in parallel over tiles of points. Each tile hashes its points into local cells, the merge step assigns global cells
+// in order of first point, then each tile scatters its point indices into the cells. Tiles have a fixed number of points,
+// so cells and their members ( ascending point index ) do not depend on the number of threads.
+class PointGrid
+{
+public:
+    static const size_t tileSize = 8192;
+
+private:
+    // Open Addressing Hash Table ( Cell Key -> Cell Index )
+    class CellHash
+    {
+    private:
+        // Slot ( Key and Value in Same Cache Line )
+        struct Slot
+        {
+            uint64_t key;
+            uint32_t value;
+        };
+
+        static const uint64_t empty = ~0ull;
+        std::vector<Slot> slots;
+        size_t mask;
+        int shift;
+        size_t count;
+
+    public:
+        CellHash()
+            : mask( 0 ), shift( 63 ), count( 0 )
+        {
+        }
+
+        // Clear for Number of Keys ( Load Factor at most 1/2 )
+        void clear( const size_t capacity )
+        {
+            size_t size = 16;
+            shift = 60;
+            while( size < capacity * 2 ){
+                size <<= 1;
+                shift--;
+            }
+            const Slot slot = { empty, 0 };
+            slots.assign( size, slot );
+            mask = size - 1;
+            count = 0;
+        }
+
+        // Find Value of Key or Insert value ( Returns Value in Table )
+        uint32_t insert( const uint64_t key, const uint32_t value )
+        {
+            size_t slot = hash( key );
+            while( slots[slot].key != empty ){
+                if( slots[slot].key == key ){
+                    return slots[slot].value;
+                }
+                slot = ( slot + 1 ) & mask;
+            }
+            slots[slot].key = key;
+            slots[slot].value = value;
+            count++;
+            return value;
+        }
+
+        // Find Value of Key ( Returns -1 if not Found )
+        int64_t find( const uint64_t key ) const
+        {
+            size_t slot = hash( key );
+            while( slots[slot].key != empty ){
+                if( slots[slot].key == key ){
+                    return slots[slot].value;
+                }
+                slot = ( slot + 1 ) & mask;
+            }
+            return -1;
+        }
+
+        size_t size() const
+        {
+            return count;
+        }
+
+    private:
+        // Fibonacci Hashing ( High Bits of Product Depend on All Axes )
+        size_t hash( const uint64_t key ) const
+        {
+            return static_cast<size_t>( ( key * 0x9e3779b97f4a7c15ull ) >> shift );
+        }
+    };
+
+    // Tile of Points
+    struct Tile
+    {
+        CellHash hash;
+        std::vector<uint64_t> keys;    // Key of Local Cell
+        std::vector<uint32_t> counts;  // Points of Local Cell
+        std::vector<uint32_t> cursors; // Scatter Position of Local Cell
+    };
+
+    float inverseCellSize;
+    std::vector<Tile> tiles;
+    std::vector<uint32_t> local;       // Local Cell of Point
+    CellHash global;
+    std::vector<uint64_t> cellKeys;
+    std::vector<uint32_t> cellStart;   // Range of Cell in members ( cellStart[i], cellStart[i + 1] )
+    std::vector<uint32_t> members;     // Point Indices Sorted by Cell
+    std::vector<uint32_t> cursor;
+
+public:
+    // Constructor
+    PointGrid()
+        : inverseCellSize( 0.0f )
+    {
+    }
+
+    // Pack Cell Coordinates to Key ( 21 bits per Axis )
+    static uint64_t packKey( const int x, const int y, const int z )
+    {
+        const uint64_t mask = ( 1ull << 21 ) - 1;
+        return ( static_cast<uint64_t>( ( x + ( 1 << 20 ) ) & mask ) << 42 )
+             | ( static_cast<uint64_t>( ( y + ( 1 << 20 ) ) & mask ) << 21 )
+             | ( static_cast<uint64_t>( ( z + ( 1 << 20 ) ) & mask ) );
+    }
+
+    // Retrieve Cell Coordinate of Position
+    int cellCoordinate( const float value ) const
+    {
+        return static_cast<int>( std::floor( value * inverseCellSize ) );
+    }
+
+    // Build Grid of Points with Cell Size [m]
+    void build( const PointCloud& cloud, const float cellSize )
+    {
+        if( !( cellSize > 0.0f ) ){
+            throw std::invalid_argument( "cell size must be positive" );
+        }
+        inverseCellSize = 1.0f / cellSize;
+
+        const size_t points = cloud.size;
+        const size_t tileCount = ( points + tileSize - 1 ) / tileSize;
+        if( tiles.size() < tileCount ){
+            tiles.resize( tileCount );
+        }
+        local.resize( points );
+
+        // Hash Points into Local Cells of Each Tile
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            Tile& tile = tiles[t];
+            const size_t begin = t * tileSize;
+            const size_t end = ( std::min )( begin + tileSize, points );
+            tile.hash.clear( end - begin );
+            tile.keys.clear();
+            tile.counts.clear();
+            for( size_t i = begin; i < end; i++ ){
+                const uint64_t key = packKey( cellCoordinate( cloud.x[i] ), cellCoordinate( cloud.y[i] ), cellCoordinate( cloud.z[i] ) );
+                const uint32_t cell = tile.hash.insert( key, static_cast<uint32_t>( tile.keys.size() ) );
+                if( cell == tile.keys.size() ){
+                    tile.keys.push_back( key );
+                    tile.counts.push_back( 0 );
+                }
+                tile.counts[cell]++;
+                local[i] = cell;
+            }
+        } );
+
+        // Merge Local Cells into Global Cells ( Ordered by First Point )
+        size_t localCells = 0;
+        for( size_t t = 0; t < tileCount; t++ ){
+            localCells += tiles[t].keys.size();
+        }
+        global.clear( localCells );
+        cellKeys.clear();
+        std::vector<uint32_t>& counts = cellStart;
+        counts.clear();
+        for( size_t t = 0; t < tileCount; t++ ){
+            Tile& tile = tiles[t];
+            tile.cursors.resize( tile.keys.size() );
+            for( size_t c = 0; c < tile.keys.size(); c++ ){
+                const uint32_t cell = global.insert( tile.keys[c], static_cast<uint32_t>( cellKeys.size() ) );
+                if( cell == cellKeys.size() ){
+                    cellKeys.push_back( tile.keys[c] );
+                    counts.push_back( 0 );
+                }
+                tile.cursors[c] = cell; // Global Cell for Now
+                counts[cell] += tile.counts[c];
+            }
+        }
+
+        // Exclusive Scan of Counts, then Scatter Positions of Local Cells in Tile Order
+        uint32_t sum = 0;
+        for( uint32_t& value : counts ){
+            const uint32_t count = value;
+            value = sum;
+            sum += count;
+        }
+        counts.push_back( sum );
+        cursor.assign( cellStart.begin(), cellStart.end() - 1 );
+        for( size_t t = 0; t < tileCount; t++ ){
+            Tile& tile = tiles[t];
+            for( size_t c = 0; c < tile.keys.size(); c++ ){
+                const uint32_t cell = tile.cursors[c];
+                tile.cursors[c] = cursor[cell];
+                cursor[cell] += tile.counts[c];
+            }
+        }
+
+        // Scatter Point Indices into Cells
+        members.resize( points );
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            Tile& tile = tiles[t];
+            const size_t begin = t * tileSize;
+            const size_t end = ( std::min )( begin + tileSize, points );
+            for( size_t i = begin; i < end; i++ ){
+                members[tile.cursors[local[i]]++] = static_cast<uint32_t>( i );
+            }
+        } );
+    }
+
+    // Retrieve Number of Cells
+    size_t size() const
+    {
+        return cellKeys.size();
+    }
+
+    // Retrieve Points of Cell ( Ascending Point Index )
+    const uint32_t* begin( const size_t cell ) const
+    {
+        return &members[0] + cellStart[cell];
+    }
+
+    const uint32_t* end( const size_t cell ) const
+    {
+        return &members[0] + cellStart[cell + 1];
+    }
+
+    // Find Cell of Cell Coordinates ( Returns -1 if Empty )
+    int64_t find( const int x, const int y, const int z ) const
+    {
+        return global.find( packKey( x, y, z ) );
+    }
+};
+
+// Voxel Grid Filter Modes
+enum VoxelGridMode
+{
+    VoxelGridMode_Centroid = 0, // Average Position and Color of Points in Voxel
+    VoxelGridMode_First    = 1  // First Point of Voxel in Scan Order ( Keeps Measured Positions )
+};
+
+// Point Cloud Filter
+//
+// Voxel grid and radius outlier filters use PointGrid, the stride filter works on depth pixel coordinates.
+// Filters run in parallel over tiles of points, and results are compacted by a count, scan and write pass over the same tiles,
+// so output is deterministic. Output must not be the same cloud as input, buffers of output are reused between frames.
+class PointCloudFilter
+{
+private:
+    PointGrid grid;
+    std::vector<uint8_t> keep;
+    std::vector<uint8_t> inliers;
+    std::vector<size_t> offsets;
+
+public:
+    // Voxel Grid Filter ( One Point per Voxel of Leaf Size [m], Ordered by First Point of Voxel )
+    void voxelGrid( const PointCloud& input, const float leafSize, const VoxelGridMode mode, PointCloud& output )
+    {
+        grid.build( input, leafSize );
+
+        const size_t cells = grid.size();
+        prepare( input, output );
+        output.size = cells;
+        const size_t tileCount = ( cells + PointGrid::tileSize - 1 ) / PointGrid::tileSize;
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            const size_t begin = t * PointGrid::tileSize;
+            const size_t end = ( std::min )( begin + PointGrid::tileSize, cells );
+            for( size_t cell = begin; cell < end; cell++ ){
+                const uint32_t* first = grid.begin( cell );
+                const uint32_t* last = grid.end( cell );
+                output.indices[cell] = input.indices[*first];
+                if( mode == VoxelGridMode_First || last - first == 1 ){
+                    output.x[cell] = input.x[*first];
+                    output.y[cell] = input.y[*first];
+                    output.z[cell] = input.z[*first];
+                    output.color[cell] = input.color[*first];
+                    continue;
+                }
+
+                // Centroid ( Sums in Point Order )
+                float x = 0.0f, y = 0.0f, z = 0.0f;
+                uint32_t channels[4] = { 0, 0, 0, 0 };
+                for( const uint32_t* point = first; point != last; point++ ){
+                    x += input.x[*point];
+                    y += input.y[*point];
+                    z += input.z[*point];
+                    const uint32_t color = input.color[*point];
+                    for( int channel = 0; channel < 4; channel++ ){
+                        channels[channel] += ( color >> ( channel * 8 ) ) & 0xff;
+                    }
+                }
+                const uint32_t count = static_cast<uint32_t>( last - first );
+                const float inverse = 1.0f / static_cast<float>( count );
+                output.x[cell] = x * inverse;
+                output.y[cell] = y * inverse;
+                output.z[cell] = z * inverse;
+                uint32_t color = 0;
+                for( int channel = 0; channel < 4; channel++ ){
+                    color |= ( ( channels[channel] + count / 2 ) / count ) << ( channel * 8 );
+                }
+                output.color[cell] = color;
+            }
+        } );
+    }
+
+    // Stride Filter ( Points of Every stride-th Depth Pixel in X and Y, or Every stride x stride-th Point if Cloud has no Frame Size )
+    void stride( const PointCloud& input, const int stride, PointCloud& output )
+    {
+        if( stride <= 0 ){
+            throw std::invalid_argument( "stride must be positive" );
+        }
+
+        const uint32_t width = static_cast<uint32_t>( input.width );
+        const uint32_t step = static_cast<uint32_t>( stride );
+        compact( input, output, [&]( const size_t i ){
+            if( width == 0 ){
+                return i % ( static_cast<size_t>( step ) * step ) == 0;
+            }
+            const uint32_t index = input.indices[i];
+            return ( index % width ) % step == 0 && ( index / width ) % step == 0;
+        } );
+    }
+
+    // Radius Outlier Filter ( Removes Points with less than minNeighbors Other Points within Radius [m] )
+    void radiusOutlier( const PointCloud& input, const float radius, const int minNeighbors, PointCloud& output )
+    {
+        grid.build( input, radius );
+
+        // Evaluate Points per Cell ( Neighbor Cells are Found once per Cell )
+        const float radius2 = radius * radius;
+        const size_t required = static_cast<size_t>( ( std::max )( minNeighbors, 0 ) );
+        const size_t cells = grid.size();
+        const size_t tileCount = ( cells + PointGrid::tileSize - 1 ) / PointGrid::tileSize;
+        inliers.resize( input.size );
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            const size_t begin = t * PointGrid::tileSize;
+            const size_t end = ( std::min )( begin + PointGrid::tileSize, cells );
+            const uint32_t* ranges[27][2];
+            for( size_t cell = begin; cell < end; cell++ ){
+                const uint32_t* first = grid.begin( cell );
+                const uint32_t* last = grid.end( cell );
+
+                // Own Cell First, as it Contains Most Neighbors
+                const int cellX = grid.cellCoordinate( input.x[*first] );
+                const int cellY = grid.cellCoordinate( input.y[*first] );
+                const int cellZ = grid.cellCoordinate( input.z[*first] );
+                int count = 0;
+                ranges[count][0] = first;
+                ranges[count][1] = last;
+                count++;
+                for( int dz = -1; dz <= 1; dz++ ){
+                    for( int dy = -1; dy <= 1; dy++ ){
+                        for( int dx = -1; dx <= 1; dx++ ){
+                            if( dx == 0 && dy == 0 && dz == 0 ){
+                                continue;
+                            }
+                            const int64_t neighbor = grid.find( cellX + dx, cellY + dy, cellZ + dz );
+                            if( neighbor >= 0 ){
+                                ranges[count][0] = grid.begin( static_cast<size_t>( neighbor ) );
+                                ranges[count][1] = grid.end( static_cast<size_t>( neighbor ) );
+                                count++;
+                            }
+                        }
+                    }
+                }
+
+                // Count Neighbors until Enough
+                for( const uint32_t* point = first; point != last; point++ ){
+                    const uint32_t i = *point;
+                    const float x = input.x[i];
+                    const float y = input.y[i];
+                    const float z = input.z[i];
+                    size_t neighbors = 0;
+                    for( int r = 0; r < count && neighbors < required; r++ ){
+                        for( const uint32_t* other = ranges[r][0]; other != ranges[r][1]; other++ ){
+                            const float ex = input.x[*other] - x;
+                            const float ey = input.y[*other] - y;
+                            const float ez = input.z[*other] - z;
+                            if( ex * ex + ey * ey + ez * ez <= radius2 && *other != i ){
+                                if( ++neighbors >= required ){
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                    inliers[i] = neighbors >= required ? 1 : 0;
+                }
+            }
+        } );
+
+        compact( input, output, [&]( const size_t i ){
+            return inliers[i] != 0;
+        } );
+    }
+
+private:
+    // Allocate Output for Points of Input
+    static void prepare( const PointCloud& input, PointCloud& output )
+    {
+        if( &input == &output ){
+            throw std::invalid_argument( "output must not be input" );
+        }
+        output.allocate( input.width, input.height );
+        if( output.x.size() < input.size ){
+            output.x.resize( input.size );
+            output.y.resize( input.size );
+            output.z.resize( input.size );
+            output.color.resize( input.size );
+            output.indices.resize( input.size );
+        }
+    }
+
+    // Copy Points that Predicate Accepts ( Count, Scan and Write over Tiles )
+    template<typename Predicate>
+    void compact( const PointCloud& input, PointCloud& output, const Predicate& predicate )
+    {
+        const size_t points = input.size;
+        const size_t tileCount = ( points + PointGrid::tileSize - 1 ) / PointGrid::tileSize;
+        keep.resize( points );
+        offsets.assign( tileCount + 1, 0 );
+
+        // Evaluate and Count
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            const size_t begin = t * PointGrid::tileSize;
+            const size_t end = ( std::min )( begin + PointGrid::tileSize, points );
+            size_t count = 0;
+            for( size_t i = begin; i < end; i++ ){
+                keep[i] = predicate( i ) ? 1 : 0;
+                count += keep[i];
+            }
+            offsets[t + 1] = count;
+        } );
+
+        // Scan
+        for( size_t t = 0; t < tileCount; t++ ){
+            offsets[t + 1] += offsets[t];
+        }
+
+        // Write
+        prepare( input, output );
+        output.size = offsets[tileCount];
+        ThreadPool::global().parallelFor( tileCount, [&]( const size_t t ){
+            const size_t begin = t * PointGrid::tileSize;
+            const size_t end = ( std::min )( begin + PointGrid::tileSize, points );
+            size_t count = offsets[t];
+            for( size_t i = begin; i < end; i++ ){
+                if( keep[i] ){
+                    output.x[count] = input.x[i];
+                    output.y[count] = input.y[i];
+                    output.z[count] = input.z[i];
+                    output.color[count] = input.color[i];
+                    output.indices[count] = input.indices[i];
+                    count++;
+                }
+            }
+        } );
+    }
+};
+
+#endif // __POINT_CLOUD_FILTER__
\ No newline at end of file
@@ -0,0 +1,346 @@
+#ifndef __POINT_CLOUD_RECORDER__
+#define __POINT_CLOUD_RECORDER__
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "PointCloud.h"
+
+// Point Cloud File Formats ( Binary Little Endian )
+enum PointCloudFormat
+{
+    PointCloudFormat_PCD = 0, // x y z ( float ), rgba ( uint32 0xAARRGGBB ), Same as PCL PointXYZRGBA
+    PointCloudFormat_PLY = 1  // x y z ( float ), red green blue ( uchar )
+};
+
+// Recording Statistics
+struct PointCloudRecorderStatistics
+{
+    uint64_t frames;             // Frames Passed to record()
+    uint64_t written;            // Frames Written to File
+    uint64_t dropped;            // Frames Dropped because All Staging Buffers were in Use
+    uint64_t points;             // Points Written
+    uint64_t bytes;              // Bytes Written
+    double stallMilliseconds;    // Time of Last Copy to Staging Buffer on Calling Thread
+    double maxStallMilliseconds;
+    double writeMilliseconds;    // Time of Last Encoding and Write on Background Thread
+    double megabytesPerSecond;   // Written Bytes / Write Time of All Frames
+};
+
+// Point Cloud Recorder
+//
+// Writes every recorded frame to its own binary file ( prefix + frame number + extension ), so a sequence can be loaded frame by frame
+// by PCL or any PLY reader. record() only copies the cloud into a free staging buffer, a background thread encodes and writes it.
+// With two staging buffers one frame is written while the next is queued, when both are in use the frame is dropped instead of
+// blocking the caller ( back-pressure ), and the file number of the dropped frame is skipped, so gaps in the sequence show drops.
+// Errors of background thread are rethrown by next record() or close().
+class PointCloudRecorder
+{
+private:
+    static const size_t stagingCount = 2;
+
+    // Staging Buffer
+    struct Staging
+    {
+        PointCloud cloud;
+        uint64_t frame;
+    };
+
+    std::string prefix;
+    PointCloudFormat format;
+    Staging staging[stagingCount];
+    std::vector<char> encoded;
+
+    // Synchronization
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<size_t> available;  // Free Staging Buffers
+    std::deque<size_t> queued;      // Staging Buffers to Write in Frame Order
+    bool writing;
+    bool quit;
+    std::exception_ptr exception;
+    PointCloudRecorderStatistics statistics;
+    double totalWriteMilliseconds;
+
+public:
+    // Constructor
+    PointCloudRecorder()
+        : format( PointCloudFormat_PCD ), writing( false ), quit( false ), statistics(), totalWriteMilliseconds( 0.0 )
+    {
+    }
+
+    // Destructor ( Writes Queued Frames, Errors are Discarded )
+    ~PointCloudRecorder()
+    {
+        try{
+            close();
+        }
+        catch( ... ){
+        }
+    }
+
+    PointCloudRecorder( const PointCloudRecorder& ) = delete;
+    PointCloudRecorder& operator=( const PointCloudRecorder& ) = delete;
+
+    // Start Recording Sequence ( Files are prefix + 6 Digits Frame Number + .pcd or .ply )
+    void open( const std::string& prefix, const PointCloudFormat format = PointCloudFormat_PCD )
+    {
+        close();
+
+        this->prefix = prefix;
+        this->format = format;
+        available.clear();
+        for( size_t i = 0; i < stagingCount; i++ ){
+            available.push_back( stagingCount - 1 - i );
+        }
+        queued.clear();
+        writing = false;
+        quit = false;
+        exception = nullptr;
+        statistics = PointCloudRecorderStatistics();
+        totalWriteMilliseconds = 0.0;
+        thread = std::thread( [this](){ worker(); } );
+    }
+
+    // Stop Recording after Queued Frames are Written ( Error of Background Thread is Rethrown )
+    void close()
+    {
+        if( !thread.joinable() ){
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            quit = true;
+        }
+        wake.notify_all();
+        thread.join();
+
+        if( exception ){
+            std::exception_ptr error = exception;
+            exception = nullptr;
+            std::rethrow_exception( error );
+        }
+    }
+
+    // Check Recording
+    bool isOpen() const
+    {
+        return thread.joinable();
+    }
+
+    // Record Frame ( Returns false if Dropped because Writer is Behind )
+    bool record( const PointCloud& cloud )
+    {
+        if( !isOpen() ){
+            throw std::runtime_error( "point cloud recorder is not open" );
+        }
+
+        size_t index;
+        uint64_t frame;
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            if( exception ){
+                std::exception_ptr error = exception;
+                exception = nullptr;
+                std::rethrow_exception( error );
+            }
+
+            frame = statistics.frames++;
+            if( available.empty() ){
+                statistics.dropped++;
+                return false;
+            }
+            index = available.back();
+            available.pop_back();
+        }
+
+        // Copy to Staging Buffer ( Stall of Calling Thread )
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Staging& target = staging[index];
+        target.frame = frame;
+        target.cloud.allocate( cloud.width, cloud.height );
+        if( target.cloud.x.size() < cloud.size ){
+            target.cloud.x.resize( cloud.size );
+            target.cloud.y.resize( cloud.size );
+            target.cloud.z.resize( cloud.size );
+            target.cloud.color.resize( cloud.size );
+            target.cloud.indices.resize( cloud.size );
+        }
+        target.cloud.size = cloud.size;
+        if( cloud.size > 0 ){
+            std::memcpy( &target.cloud.x[0], &cloud.x[0], cloud.size * sizeof( float ) );
+            std::memcpy( &target.cloud.y[0], &cloud.y[0], cloud.size * sizeof( float ) );
+            std::memcpy( &target.cloud.z[0], &cloud.z[0], cloud.size * sizeof( float ) );
+            std::memcpy( &target.cloud.color[0], &cloud.color[0], cloud.size * sizeof( uint32_t ) );
+        }
+        const double stall = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+        // Hand Over to Background Thread
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            queued.push_back( index );
+            statistics.stallMilliseconds = stall;
+            statistics.maxStallMilliseconds = ( std::max )( statistics.maxStallMilliseconds, stall );
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    // Wait until Queued Frames are Written
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        done.wait( lock, [this](){ return queued.empty() && !writing; } );
+    }
+
+    // Retrieve Statistics
+    PointCloudRecorderStatistics getStatistics()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        return statistics;
+    }
+
+private:
+    // Background Thread ( Writes Queued Frames before Quit )
+    void worker()
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( true ){
+            wake.wait( lock, [this](){ return !queued.empty() || quit; } );
+            if( queued.empty() ){
+                return;
+            }
+
+            const size_t index = queued.front();
+            queued.pop_front();
+            writing = true;
+            lock.unlock();
+
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            std::exception_ptr error;
+            size_t bytes = 0;
+            try{
+                bytes = write( staging[index] );
+            }
+            catch( ... ){
+                error = std::current_exception();
+            }
+            const double milliseconds = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+            lock.lock();
+            if( error ){
+                if( !exception ){
+                    exception = error;
+                }
+            }
+            else{
+                statistics.written++;
+                statistics.points += staging[index].cloud.size;
+                statistics.bytes += bytes;
+                statistics.writeMilliseconds = milliseconds;
+                totalWriteMilliseconds += milliseconds;
+                statistics.megabytesPerSecond = totalWriteMilliseconds > 0.0 ? statistics.bytes / ( totalWriteMilliseconds * 1000.0 ) : 0.0;
+            }
+            available.push_back( index );
+            writing = false;
+            done.notify_all();
+        }
+    }
+
+    // Encode and Write Frame ( Returns Written Bytes )
+    size_t write( const Staging& frame )
+    {
+        const PointCloud& cloud = frame.cloud;
+        const size_t count = cloud.size;
+
+        // Header
+        char header[512];
+        int length;
+        char number[32];
+        snprintf( number, sizeof( number ), "%06llu", static_cast<unsigned long long>( frame.frame ) );
+        std::string path = prefix + number;
+        size_t pointBytes;
+        if( format == PointCloudFormat_PCD ){
+            path += ".pcd";
+            pointBytes = 16;
+            length = snprintf( header, sizeof( header ),
+                               "# .PCD v0.7 - Point Cloud Data file format\n"
+                               "VERSION 0.7\n"
+                               "FIELDS x y z rgba\n"
+                               "SIZE 4 4 4 4\n"
+                               "TYPE F F F U\n"
+                               "COUNT 1 1 1 1\n"
+                               "WIDTH %llu\n"
+                               "HEIGHT 1\n"
+                               "VIEWPOINT 0 0 0 1 0 0 0\n"
+                               "POINTS %llu\n"
+                               "DATA binary\n",
+                               static_cast<unsigned long long>( count ), static_cast<unsigned long long>( count ) );
+        }
+        else{
+            path += ".ply";
+            pointBytes = 15;
+            length = snprintf( header, sizeof( header ),
+                               "ply\n"
+                               "format binary_little_endian 1.0\n"
+                               "element vertex %llu\n"
+                               "property float x\n"
+                               "property float y\n"
+                               "property float z\n"
+                               "property uchar red\n"
+                               "property uchar green\n"
+                               "property uchar blue\n"
+                               "end_header\n",
+                               static_cast<unsigned long long>( count ) );
+        }
+
+        // Interleave Points ( Little Endian, BGRA Color in Memory is 0xAARRGGBB )
+        const size_t bytes = static_cast<size_t>( length ) + count * pointBytes;
+        encoded.resize( bytes );
+        std::memcpy( &encoded[0], header, length );
+        char* out = &encoded[0] + length;
+        for( size_t i = 0; i < count; i++ ){
+            std::memcpy( out + 0, &cloud.x[i], sizeof( float ) );
+            std::memcpy( out + 4, &cloud.y[i], sizeof( float ) );
+            std::memcpy( out + 8, &cloud.z[i], sizeof( float ) );
+            if( format == PointCloudFormat_PCD ){
+                std::memcpy( out + 12, &cloud.color[i], sizeof( uint32_t ) );
+            }
+            else{
+                const uint32_t color = cloud.color[i];
+                out[12] = static_cast<char>( ( color >> 16 ) & 0xff );
+                out[13] = static_cast<char>( ( color >> 8 ) & 0xff );
+                out[14] = static_cast<char>( color & 0xff );
+            }
+            out += pointBytes;
+        }
+
+        // Write File
+        FILE* file = fopen( path.c_str(), "wb" );
+        if( file == nullptr ){
+            throw std::runtime_error( "failed to open point cloud file ( " + path + " )" );
+        }
+        bool succeeded = fwrite( &encoded[0], 1, bytes, file ) == bytes;
+        succeeded &= ( fclose( file ) == 0 );
+        if( !succeeded ){
+            throw std::runtime_error( "failed to write point cloud file ( " + path + " )" );
+        }
+        return bytes;
+    }
+};
+
+#endif // __POINT_CLOUD_RECORDER__
\ No newline at end of file
@@ -0,0 +1,680 @@
+#ifndef __POINT_OCTREE__
+#define __POINT_OCTREE__
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <stdexcept>
+
+#include "PointCloud.h"
+
+// Octree Point
+struct OctreePoint
+{
+    float x;        // [m]
+    float y;
+    float z;
+    uint32_t color; // BGRA
+};
+
+// Chunked Pool ( Elements never Move, so Growing does not Copy, and Chunks are Kept by clear() for Reuse )
+template<typename T>
+class OctreePool
+{
+private:
+    static const size_t chunkBits = 14;
+    static const size_t chunkSize = static_cast<size_t>( 1 ) << chunkBits;
+    std::vector<std::unique_ptr<T[]>> chunks;
+    size_t count;
+
+public:
+    OctreePool()
+        : count( 0 )
+    {
+    }
+
+    uint32_t allocate()
+    {
+        if( count == chunks.size() * chunkSize ){
+            if( count + chunkSize > 0xffffffff ){
+                throw std::runtime_error( "octree pool is full" );
+            }
+            chunks.emplace_back( new T[chunkSize] );
+        }
+        return static_cast<uint32_t>( count++ );
+    }
+
+    T& operator[]( const uint32_t index )
+    {
+        return chunks[index >> chunkBits][index & ( chunkSize - 1 )];
+    }
+
+    const T& operator[]( const uint32_t index ) const
+    {
+        return chunks[index >> chunkBits][index & ( chunkSize - 1 )];
+    }
+
+    void clear()
+    {
+        count = 0;
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    size_t capacityBytes() const
+    {
+        return chunks.size() * chunkSize * sizeof( T );
+    }
+};
+
+// Point Octree
+//
+// Incremental octree for accumulating point clouds of many frames. Leaves are cubes of leaf size on a fixed grid, and keep their points
+// in buckets chained newest first ( first bucket of smallBucketCapacity points, as most leaves of a moving sensor get only a few points,
+// then buckets of largeBucketCapacity points ), nodes, leaves and buckets are allocated from chunked pools.
+// The root grows upward when a point falls outside ( up to +-2^30 leaves per axis ), so the extent does not have to be known beforehand.
+// Consecutive points of a frame are close to each other, so insertion starts from the lowest common ancestor with previous point
+// instead of the root.
+// Each insert() is a revision, leaves and nodes remember the revision of their last change ( ancestors are never older than descendants ),
+// so changed parts are found without visiting unchanged subtrees. Leaves keep sums of positions and colors, and nodes cache sums of their
+// subtree until it changes, so level of detail ( centroid and mean color of each node of a level ) costs only the changed subtrees.
+// Queries are const and can run concurrently, but not concurrently with insert().
+class PointOctree
+{
+public:
+    static const uint32_t smallBucketCapacity = 4;
+    static const uint32_t largeBucketCapacity = 16;
+
+private:
+    static const uint32_t invalid = 0xffffffff;
+    static const uint32_t bias = 1u << 30;
+    static const uint32_t largeBucket = 1u << 31; // Flag of Bucket Index in Large Pool
+    static const int maxDepth = 31;
+
+    // Bucket of Points
+    template<uint32_t capacity>
+    struct Bucket
+    {
+        OctreePoint points[capacity];
+        uint32_t next;
+        uint32_t count;
+    };
+    typedef Bucket<smallBucketCapacity> SmallBucket;
+    typedef Bucket<largeBucketCapacity> LargeBucket;
+
+    // Leaf ( Level 0 )
+    struct Leaf
+    {
+        uint32_t parent;
+        uint32_t bucket;      // Newest Bucket
+        uint32_t count;
+        uint32_t revision;
+        double sum[3];
+        uint64_t colorSum[3]; // B, G, R
+    };
+
+    // Node ( Level 1 to depth, Children of Level 1 are Leaves )
+    struct Node
+    {
+        uint32_t children[8]; // Index is x | y << 1 | z << 2 of Child in Node
+        uint32_t parent;
+        uint32_t revision;
+        uint32_t cachedRevision; // Revision of Cached Sums
+        uint64_t count;
+        double sum[3];
+        uint64_t colorSum[3];
+    };
+
+    // Search Entry of k-NN
+    struct Entry
+    {
+        float distance;       // Squared
+        uint32_t index;
+        int level;
+        uint32_t coordinate[3];
+
+        bool operator<( const Entry& entry ) const
+        {
+            return distance > entry.distance;
+        }
+    };
+
+    // Candidate of k-NN
+    struct Candidate
+    {
+        float distance;       // Squared
+        OctreePoint point;
+
+        bool operator<( const Candidate& candidate ) const
+        {
+            return distance < candidate.distance;
+        }
+    };
+
+    float leafSize;
+    float inverseLeafSize;
+    OctreePool<Node> nodes;
+    OctreePool<Leaf> leaves;
+    OctreePool<SmallBucket> smallBuckets;
+    OctreePool<LargeBucket> largeBuckets;
+    uint32_t root;
+    int depth;
+    uint32_t rootCoordinate[3]; // Grid Coordinate of Root at Its Level
+    uint32_t revision;
+    size_t count;
+
+    // Path of Previous Point ( Node of Each Level, path[0] is Leaf )
+    uint32_t path[maxDepth + 1];
+    uint32_t lastCoordinate[3];
+    bool pathValid;
+
+public:
+    // Constructor ( Leaf Size in Meters )
+    explicit PointOctree( const float leafSize = 0.01f )
+        : leafSize( leafSize ), inverseLeafSize( 1.0f / leafSize ), root( invalid ), depth( 0 ), revision( 0 ), count( 0 ), pathValid( false )
+    {
+        if( !( leafSize > 0.0f ) ){
+            throw std::invalid_argument( "leaf size must be positive" );
+        }
+    }
+
+    PointOctree( const PointOctree& ) = delete;
+    PointOctree& operator=( const PointOctree& ) = delete;
+
+    // Remove All Points ( Memory is Kept for Reuse )
+    void clear()
+    {
+        nodes.clear();
+        leaves.clear();
+        smallBuckets.clear();
+        largeBuckets.clear();
+        root = invalid;
+        depth = 0;
+        revision = 0;
+        count = 0;
+        pathValid = false;
+    }
+
+    // Insert Points ( Points with Non-Finite or Out of Range Coordinates are Skipped ), Returns Number of Inserted Points
+    size_t insert( const OctreePoint* points, const size_t size )
+    {
+        revision++;
+        size_t inserted = 0;
+        for( size_t i = 0; i < size; i++ ){
+            inserted += insertPoint( points[i] ) ? 1 : 0;
+        }
+        return inserted;
+    }
+
+    // Insert Points of Point Cloud
+    size_t insert( const PointCloud& cloud )
+    {
+        revision++;
+        size_t inserted = 0;
+        for( size_t i = 0; i < cloud.size; i++ ){
+            const OctreePoint point = { cloud.x[i], cloud.y[i], cloud.z[i], cloud.color[i] };
+            inserted += insertPoint( point ) ? 1 : 0;
+        }
+        return inserted;
+    }
+
+    // Retrieve Revision of Last insert() ( Changes after Revision r are Extracted by sinceRevision = r )
+    uint32_t getRevision() const { return revision; }
+
+    // Retrieve Number of Points
+    size_t size() const { return count; }
+
+    // Retrieve Structure
+    float getLeafSize() const { return leafSize; }
+    int getDepth() const { return depth; }
+    size_t getNodeCount() const { return nodes.size(); }
+    size_t getLeafCount() const { return leaves.size(); }
+    size_t getMemoryBytes() const { return nodes.capacityBytes() + leaves.capacityBytes() + smallBuckets.capacityBytes() + largeBuckets.capacityBytes(); }
+
+    // Find Points within Radius [m] ( Unordered )
+    void radiusSearch( const float x, const float y, const float z, const float radius, std::vector<OctreePoint>& points ) const
+    {
+        points.clear();
+        if( root == invalid || !( radius >= 0.0f ) ){
+            return;
+        }
+
+        const float query[3] = { x, y, z };
+        radiusSearch( root, depth, rootCoordinate, query, radius * radius, points );
+    }
+
+    // Find k Nearest Points ( Ascending Distance, Squared Distances in Meters^2 )
+    void nearestKSearch( const float x, const float y, const float z, const int k, std::vector<OctreePoint>& points, std::vector<float>& squaredDistances ) const
+    {
+        points.clear();
+        squaredDistances.clear();
+        if( root == invalid || k <= 0 ){
+            return;
+        }
+
+        // Best First Search ( Nearest Node First, until Nearest Node is Farther than k-th Point )
+        const float query[3] = { x, y, z };
+        const size_t limit = static_cast<size_t>( k );
+        std::vector<Entry> queue;
+        std::vector<Candidate> candidates;
+        Entry entry = { boxDistance( query, rootCoordinate, depth ), root, depth, { rootCoordinate[0], rootCoordinate[1], rootCoordinate[2] } };
+        queue.push_back( entry );
+        while( !queue.empty() ){
+            std::pop_heap( queue.begin(), queue.end() );
+            entry = queue.back();
+            queue.pop_back();
+            if( candidates.size() == limit && entry.distance > candidates.front().distance ){
+                break;
+            }
+
+            // Points of Leaf
+            if( entry.level == 0 ){
+                forEachBucket( leaves[entry.index], [&]( const OctreePoint* bucket, const uint32_t size ){
+                    for( uint32_t i = 0; i < size; i++ ){
+                        const float distance = squaredDistance( query, bucket[i] );
+                        if( candidates.size() < limit ){
+                            const Candidate candidate = { distance, bucket[i] };
+                            candidates.push_back( candidate );
+                            std::push_heap( candidates.begin(), candidates.end() );
+                        }
+                        else if( distance < candidates.front().distance ){
+                            std::pop_heap( candidates.begin(), candidates.end() );
+                            candidates.back().distance = distance;
+                            candidates.back().point = bucket[i];
+                            std::push_heap( candidates.begin(), candidates.end() );
+                        }
+                    }
+                } );
+                continue;
+            }
+
+            // Children within k-th Distance
+            const Node& node = nodes[entry.index];
+            for( int child = 0; child < 8; child++ ){
+                if( node.children[child] == invalid ){
+                    continue;
+                }
+                Entry next;
+                next.index = node.children[child];
+                next.level = entry.level - 1;
+                childCoordinate( entry.coordinate, child, next.coordinate );
+                next.distance = boxDistance( query, next.coordinate, next.level );
+                if( candidates.size() == limit && next.distance > candidates.front().distance ){
+                    continue;
+                }
+                queue.push_back( next );
+                std::push_heap( queue.begin(), queue.end() );
+            }
+        }
+
+        std::sort_heap( candidates.begin(), candidates.end() );
+        points.reserve( candidates.size() );
+        squaredDistances.reserve( candidates.size() );
+        for( const Candidate& candidate : candidates ){
+            points.push_back( candidate.point );
+            squaredDistances.push_back( candidate.distance );
+        }
+    }
+
+    // Extract Level of Detail ( Centroid and Mean Color of Each Node of Level, 0 is Leaves, Size is leafSize x 2^level )
+    // Only nodes changed after sinceRevision are extracted, e.g. sinceRevision = 0 for all nodes.
+    void extractLevelOfDetail( const int level, std::vector<OctreePoint>& points, const uint32_t sinceRevision = 0 )
+    {
+        points.clear();
+        if( root == invalid || nodes[root].revision <= sinceRevision ){
+            return;
+        }
+
+        collect( root, depth, ( std::min )( ( std::max )( level, 0 ), depth ), sinceRevision, points );
+    }
+
+private:
+    // Insert Point
+    bool insertPoint( const OctreePoint& point )
+    {
+        // Leaf Grid Coordinate ( Biased to Unsigned )
+        uint32_t coordinate[3];
+        const float position[3] = { point.x, point.y, point.z };
+        for( int axis = 0; axis < 3; axis++ ){
+            const float cell = std::floor( position[axis] * inverseLeafSize );
+            if( !( std::abs( cell ) < static_cast<float>( bias ) ) ){
+                return false;
+            }
+            coordinate[axis] = static_cast<uint32_t>( static_cast<int64_t>( cell ) + bias );
+        }
+
+        // Create Root at Level 1, or Grow Root until it Contains Point
+        if( root == invalid ){
+            root = newNode( invalid );
+            depth = 1;
+            for( int axis = 0; axis < 3; axis++ ){
+                rootCoordinate[axis] = coordinate[axis] >> 1;
+            }
+            path[depth] = root;
+            pathValid = false;
+        }
+        while( ( coordinate[0] >> depth ) != rootCoordinate[0] || ( coordinate[1] >> depth ) != rootCoordinate[1] || ( coordinate[2] >> depth ) != rootCoordinate[2] ){
+            grow();
+        }
+
+        // Descend from Lowest Common Ancestor with Previous Point
+        int level = depth;
+        if( pathValid ){
+            const uint32_t difference = ( coordinate[0] ^ lastCoordinate[0] ) | ( coordinate[1] ^ lastCoordinate[1] ) | ( coordinate[2] ^ lastCoordinate[2] );
+            level = 0;
+            while( level < depth && ( difference >> level ) != 0 ){
+                level++;
+            }
+        }
+        for( ; level > 0; level-- ){
+            const int child = static_cast<int>( ( ( coordinate[0] >> ( level - 1 ) ) & 1 ) | ( ( ( coordinate[1] >> ( level - 1 ) ) & 1 ) << 1 ) | ( ( ( coordinate[2] >> ( level - 1 ) ) & 1 ) << 2 ) );
+            const uint32_t parent = path[level];
+            uint32_t next = nodes[parent].children[child];
+            if( next == invalid ){
+                next = ( level == 1 ) ? newLeaf( parent ) : newNode( parent );
+                nodes[parent].children[child] = next;
+            }
+            path[level - 1] = next;
+        }
+        lastCoordinate[0] = coordinate[0];
+        lastCoordinate[1] = coordinate[1];
+        lastCoordinate[2] = coordinate[2];
+        pathValid = true;
+
+        // Append to Newest Bucket of Leaf ( Small Bucket First, then Large Buckets )
+        Leaf& leaf = leaves[path[0]];
+        if( leaf.bucket == invalid ){
+            const uint32_t index = smallBuckets.allocate();
+            smallBuckets[index].next = invalid;
+            smallBuckets[index].count = 0;
+            leaf.bucket = index;
+        }
+        else if( ( leaf.bucket & largeBucket ) ? largeBuckets[leaf.bucket & ~largeBucket].count == largeBucketCapacity : smallBuckets[leaf.bucket].count == smallBucketCapacity ){
+            const uint32_t index = largeBuckets.allocate();
+            largeBuckets[index].next = leaf.bucket;
+            largeBuckets[index].count = 0;
+            leaf.bucket = index | largeBucket;
+        }
+        if( leaf.bucket & largeBucket ){
+            LargeBucket& bucket = largeBuckets[leaf.bucket & ~largeBucket];
+            bucket.points[bucket.count++] = point;
+        }
+        else{
+            SmallBucket& bucket = smallBuckets[leaf.bucket];
+            bucket.points[bucket.count++] = point;
+        }
+        leaf.count++;
+        leaf.sum[0] += point.x;
+        leaf.sum[1] += point.y;
+        leaf.sum[2] += point.z;
+        leaf.colorSum[0] += point.color & 0xff;
+        leaf.colorSum[1] += ( point.color >> 8 ) & 0xff;
+        leaf.colorSum[2] += ( point.color >> 16 ) & 0xff;
+        count++;
+
+        // Mark Leaf and Ancestors Changed ( Stops at First Ancestor already Marked in this Revision )
+        if( leaf.revision != revision ){
+            leaf.revision = revision;
+            for( uint32_t node = leaf.parent; node != invalid && nodes[node].revision != revision; node = nodes[node].parent ){
+                nodes[node].revision = revision;
+            }
+        }
+        return true;
+    }
+
+    // Add Level above Root ( Old Root is Child at its Position in Grid of New Level )
+    void grow()
+    {
+        if( depth >= maxDepth ){
+            throw std::runtime_error( "octree depth exceeded" );
+        }
+
+        const uint32_t node = newNode( invalid );
+        const int child = static_cast<int>( ( rootCoordinate[0] & 1 ) | ( ( rootCoordinate[1] & 1 ) << 1 ) | ( ( rootCoordinate[2] & 1 ) << 2 ) );
+        nodes[node].children[child] = root;
+        nodes[node].revision = nodes[root].revision;
+        nodes[root].parent = node;
+        root = node;
+        depth++;
+        for( int axis = 0; axis < 3; axis++ ){
+            rootCoordinate[axis] >>= 1;
+        }
+        path[depth] = root;
+    }
+
+    // Allocate Node
+    uint32_t newNode( const uint32_t parent )
+    {
+        const uint32_t index = nodes.allocate();
+        Node& node = nodes[index];
+        for( int child = 0; child < 8; child++ ){
+            node.children[child] = invalid;
+        }
+        node.parent = parent;
+        node.revision = 0;
+        node.cachedRevision = 0;
+        node.count = 0;
+        return index;
+    }
+
+    // Allocate Leaf
+    uint32_t newLeaf( const uint32_t parent )
+    {
+        const uint32_t index = leaves.allocate();
+        Leaf& leaf = leaves[index];
+        leaf.parent = parent;
+        leaf.bucket = invalid;
+        leaf.count = 0;
+        leaf.revision = 0;
+        leaf.sum[0] = leaf.sum[1] = leaf.sum[2] = 0.0;
+        leaf.colorSum[0] = leaf.colorSum[1] = leaf.colorSum[2] = 0;
+        return index;
+    }
+
+    // Call function( points, size ) for Each Bucket of Leaf
+    template<typename Function>
+    void forEachBucket( const Leaf& leaf, const Function& function ) const
+    {
+        uint32_t index = leaf.bucket;
+        while( index != invalid ){
+            if( index & largeBucket ){
+                const LargeBucket& bucket = largeBuckets[index & ~largeBucket];
+                function( bucket.points, bucket.count );
+                index = bucket.next;
+            }
+            else{
+                const SmallBucket& bucket = smallBuckets[index];
+                function( bucket.points, bucket.count );
+                index = bucket.next;
+            }
+        }
+    }
+
+    // Grid Coordinate of Child
+    static void childCoordinate( const uint32_t* coordinate, const int child, uint32_t* result )
+    {
+        result[0] = ( coordinate[0] << 1 ) | ( child & 1 );
+        result[1] = ( coordinate[1] << 1 ) | ( ( child >> 1 ) & 1 );
+        result[2] = ( coordinate[2] << 1 ) | ( ( child >> 2 ) & 1 );
+    }
+
+    // Minimum Corner of Cube of Grid Coordinate at Level [m]
+    float cubeMinimum( const uint32_t coordinate, const int level ) const
+    {
+        return static_cast<float>( ( static_cast<double>( static_cast<uint64_t>( coordinate ) << level ) - bias ) * leafSize );
+    }
+
+    // Squared Distance from Query to Cube ( 0 if Inside )
+    float boxDistance( const float* query, const uint32_t* coordinate, const int level ) const
+    {
+        const float size = leafSize * static_cast<float>( static_cast<uint64_t>( 1 ) << level );
+        float distance = 0.0f;
+        for( int axis = 0; axis < 3; axis++ ){
+            const float minimum = cubeMinimum( coordinate[axis], level );
+            const float outside = ( std::max )( ( std::max )( minimum - query[axis], query[axis] - ( minimum + size ) ), 0.0f );
+            distance += outside * outside;
+        }
+        return distance;
+    }
+
+    // Squared Distance from Query to Farthest Corner of Cube
+    float farthestDistance( const float* query, const uint32_t* coordinate, const int level ) const
+    {
+        const float size = leafSize * static_cast<float>( static_cast<uint64_t>( 1 ) << level );
+        float distance = 0.0f;
+        for( int axis = 0; axis < 3; axis++ ){
+            const float minimum = cubeMinimum( coordinate[axis], level );
+            const float farthest = ( std::max )( std::abs( query[axis] - minimum ), std::abs( query[axis] - ( minimum + size ) ) );
+            distance += farthest * farthest;
+        }
+        return distance;
+    }
+
+    static float squaredDistance( const float* query, const OctreePoint& point )
+    {
+        const float dx = point.x - query[0];
+        const float dy = point.y - query[1];
+        const float dz = point.z - query[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Radius Search in Subtree
+    void radiusSearch( const uint32_t index, const int level, const uint32_t* coordinate, const float* query, const float radius2, std::vector<OctreePoint>& points ) const
+    {
+        if( boxDistance( query, coordinate, level ) > radius2 ){
+            return;
+        }
+
+        // Whole Cube is Inside Sphere
+        if( farthestDistance( query, coordinate, level ) <= radius2 ){
+            appendSubtree( index, level, points );
+            return;
+        }
+
+        if( level == 0 ){
+            forEachBucket( leaves[index], [&]( const OctreePoint* bucket, const uint32_t size ){
+                for( uint32_t i = 0; i < size; i++ ){
+                    if( squaredDistance( query, bucket[i] ) <= radius2 ){
+                        points.push_back( bucket[i] );
+                    }
+                }
+            } );
+            return;
+        }
+
+        const Node& node = nodes[index];
+        for( int child = 0; child < 8; child++ ){
+            if( node.children[child] != invalid ){
+                uint32_t next[3];
+                childCoordinate( coordinate, child, next );
+                radiusSearch( node.children[child], level - 1, next, query, radius2, points );
+            }
+        }
+    }
+
+    // Append All Points of Subtree
+    void appendSubtree( const uint32_t index, const int level, std::vector<OctreePoint>& points ) const
+    {
+        if( level == 0 ){
+            forEachBucket( leaves[index], [&]( const OctreePoint* bucket, const uint32_t size ){
+                points.insert( points.end(), bucket, bucket + size );
+            } );
+            return;
+        }
+
+        const Node& node = nodes[index];
+        for( int child = 0; child < 8; child++ ){
+            if( node.children[child] != invalid ){
+                appendSubtree( node.children[child], level - 1, points );
+            }
+        }
+    }
+
+    // Update Cached Sums of Node from Changed Children
+    void refresh( const uint32_t index, const int level )
+    {
+        Node& node = nodes[index];
+        if( node.cachedRevision == node.revision ){
+            return;
+        }
+
+        node.count = 0;
+        node.sum[0] = node.sum[1] = node.sum[2] = 0.0;
+        node.colorSum[0] = node.colorSum[1] = node.colorSum[2] = 0;
+        for( int child = 0; child < 8; child++ ){
+            const uint32_t next = node.children[child];
+            if( next == invalid ){
+                continue;
+            }
+            if( level == 1 ){
+                const Leaf& leaf = leaves[next];
+                node.count += leaf.count;
+                for( int i = 0; i < 3; i++ ){
+                    node.sum[i] += leaf.sum[i];
+                    node.colorSum[i] += leaf.colorSum[i];
+                }
+            }
+            else{
+                refresh( next, level - 1 );
+                const Node& subtree = nodes[next];
+                node.count += subtree.count;
+                for( int i = 0; i < 3; i++ ){
+                    node.sum[i] += subtree.sum[i];
+                    node.colorSum[i] += subtree.colorSum[i];
+                }
+            }
+        }
+        node.cachedRevision = node.revision;
+    }
+
+    // Representative Point of Sums
+    static OctreePoint representative( const uint64_t count, const double* sum, const uint64_t* colorSum )
+    {
+        const double inverse = 1.0 / static_cast<double>( count );
+        OctreePoint point;
+        point.x = static_cast<float>( sum[0] * inverse );
+        point.y = static_cast<float>( sum[1] * inverse );
+        point.z = static_cast<float>( sum[2] * inverse );
+        point.color = 0xff000000;
+        for( int channel = 0; channel < 3; channel++ ){
+            point.color |= static_cast<uint32_t>( ( colorSum[channel] + count / 2 ) / count ) << ( channel * 8 );
+        }
+        return point;
+    }
+
+    // Collect Representative Points of Changed Nodes of Level in Subtree
+    void collect( const uint32_t index, const int nodeLevel, const int level, const uint32_t sinceRevision, std::vector<OctreePoint>& points )
+    {
+        if( nodeLevel == level ){
+            refresh( index, nodeLevel );
+            const Node& node = nodes[index];
+            points.push_back( representative( node.count, node.sum, node.colorSum ) );
+            return;
+        }
+
+        const Node& node = nodes[index];
+        for( int child = 0; child < 8; child++ ){
+            const uint32_t next = node.children[child];
+            if( next == invalid ){
+                continue;
+            }
+            if( nodeLevel == 1 ){
+                const Leaf& leaf = leaves[next];
+                if( leaf.revision > sinceRevision ){
+                    points.push_back( representative( leaf.count, leaf.sum, leaf.colorSum ) );
+                }
+            }
+            else if( nodes[next].revision > sinceRevision ){
+                collect( next, nodeLevel - 1, level, sinceRevision, points );
+            }
+        }
+    }
+};
+
+#endif // __POINT_OCTREE__
\ No newline at end of file
@@ -3,14 +3,25 @@
 
 #include <thread>
 #include <chrono>
+#include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <string>
-
-#include <ppl.h>
+#include <cmath>
 
 // Constructor
 Kinect::Kinect()
+    : filtering( true ),
+      shading( false ),
+      recording( false ),
+      sequence( 0 ),
+      recordingWidget( false ),
+      octree( 0.01f ),
+      level( 1 ),
+      accumulating( false ),
+      accumulateReset( false ),
+      presentedFrame( nullptr ),
+      saved( 0 )
 {
     // Initialize
     initialize();
@@ -26,20 +37,20 @@ Kinect::~Kinect()
 // Processing
 void Kinect::run()
 {
-    // Main Loop
-    while( !viewer.wasStopped() ){
+    // Main Loop ( Update, Draw and Show run on Pipeline Stages, Viewer Events are Handled by spinOnce() in Show )
+    pipeline.run(
         // Update Data
-        update();
-
+        [&]( Frame& frame ){ return update( frame ); },
         // Draw Data
-        draw();
-
+        [&]( Frame& frame ){ draw( frame ); },
         // Show Data
-        show();
+        [&]( Frame& frame ){ show( frame ); },
+        // Viewer Check
+        [&](){ return !viewer.wasStopped(); }
+    );
 
-        // Wait a Few Time
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
+    // Show Latency of Pipeline Stages
+    pipeline.printStatistics( std::cout );
 }
 
 // Initialize
@@ -56,6 +67,9 @@ void Kinect::initialize()
     // Initialize Depth
     initializeDepth();
 
+    // Initialize Frame Buffer Pool
+    initializeFramePool();
+
     // Initialize Point Cloud
     initializePointCloud();
 
@@ -98,7 +112,10 @@ inline void Kinect::initializeColor()
     ERROR_CHECK( colorFrameDescription->get_BytesPerPixel( &colorBytesPerPixel ) ); // 4
 
     // Allocation Color Buffer
-    colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorBuffer.resize( colorWidth * colorHeight * colorBytesPerPixel );
+        frame.colorUpdated = false;
+    } );
 }
 
 // Initialize Depth
@@ -117,7 +134,60 @@ inline void Kinect::initializeDepth()
     ERROR_CHECK( depthFrameDescription->get_BytesPerPixel( &depthBytesPerPixel ) ); // 2
 
     // Allocation Depth Buffer
-    depthBuffer.resize( depthWidth * depthHeight );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.depthBuffer.resize( depthWidth * depthHeight );
+        frame.depthUpdated = false;
+    } );
+}
+
+// Initialize Registration
+inline void Kinect::initializeRegistration()
+{
+    // Retrieve Mapped Coordinates at Two Constant Depths
+    const UINT16 nearDepth = 500; // [mm]
+    const UINT16 farDepth = 4500; // [mm]
+    std::vector<UINT16> nearDepthBuffer( depthWidth * depthHeight, nearDepth );
+    std::vector<UINT16> farDepthBuffer( depthWidth * depthHeight, farDepth );
+    std::vector<ColorSpacePoint> nearPoints( depthWidth * depthHeight );
+    std::vector<ColorSpacePoint> farPoints( depthWidth * depthHeight );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( nearDepthBuffer.size(), &nearDepthBuffer[0], nearPoints.size(), &nearPoints[0] ) );
+    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( farDepthBuffer.size(), &farDepthBuffer[0], farPoints.size(), &farPoints[0] ) );
+
+    // Build Calibration Tables
+    registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, &nearPoints[0], nearDepth, &farPoints[0], farDepth );
+}
+
+// Initialize Point Cloud Generator
+inline void Kinect::initializeGenerator()
+{
+    // Retrieve Ray Table ( x/z, y/z of Each Depth Pixel )
+    UINT32 tableEntryCount = 0;
+    PointF* tableEntries = nullptr;
+    ERROR_CHECK( coordinateMapper->GetDepthFrameToCameraSpaceTable( &tableEntryCount, &tableEntries ) );
+    if( tableEntryCount == static_cast<UINT32>( depthWidth * depthHeight ) ){
+        generator.initialize( depthWidth, depthHeight, tableEntries );
+    }
+    CoTaskMemFree( tableEntries );
+
+    // Scale Normal Estimation Windows by Focal Length of Depth Camera
+    CameraIntrinsics intrinsics;
+    ERROR_CHECK( coordinateMapper->GetDepthCameraIntrinsics( &intrinsics ) );
+    if( intrinsics.FocalLengthX > 0.0f ){
+        normalEstimator = NormalEstimator( intrinsics.FocalLengthX );
+    }
+}
+
+// Initialize Frame Buffer Pool
+inline void Kinect::initializeFramePool()
+{
+    // Allocation Color and Point Cloud Frame Buffers ( Depth Resolution, One Buffer per Frame )
+    colorPool.allocate( depthWidth * depthHeight * colorBytesPerPixel, pipeline.size() );
+    cloudPool.allocate( depthWidth * depthHeight * sizeof( cv::Vec3f ), pipeline.size() );
+    pipeline.forEachFrame( [&]( Frame& frame ){
+        frame.colorFrameBuffer = colorPool.acquire();
+        frame.cloudFrameBuffer = cloudPool.acquire();
+    } );
+    pointCloud.allocate( depthWidth, depthHeight );
 }
 
 // Initialize Point Cloud
@@ -133,7 +203,7 @@ inline void Kinect::initializePointCloud()
     viewer.showWidget( "CoordinateSystem", cv::viz::WCameraPosition::WCameraPosition( 0.5 ) );
 }
 
-// Keyboard Callback Function
+// Keyboard Callback Function ( Called from spinOnce() on Show Stage, Toggles are Read by Draw Stage )
 void Kinect::keyboardCallback( const cv::viz::KeyboardEvent& event, void* cookie )
 {
     // Exit Viewer when Pressed ESC key
@@ -146,19 +216,46 @@ void Kinect::keyboardCallback( const cv::viz::KeyboardEvent& event, void* cookie
     }
     // Save Point Cloud to File when Pressed 's' key
     else if( event.code == 's' && event.action == cv::viz::KeyboardEvent::Action::KEY_DOWN ){
-        // Retrieve Point Cloud and Color
-        cv::Mat cloud = static_cast<Kinect*>( cookie )->cloudMat;
-        cv::Mat color = static_cast<Kinect*>( cookie )->colorMat;
+        // Retrieve Point Cloud and Color of Frame being Shown
+        Kinect* kinect = static_cast<Kinect*>( cookie );
+        const Frame* frame = kinect->presentedFrame;
+        if( frame == nullptr ){
+            return;
+        }
+        cv::Mat cloud = frame->cloudMat;
+        cv::Mat color = frame->colorMat;
 
         // Generate File Name
-        static int i = 0;
         std::ostringstream oss;
-        oss << std::setfill( '0' ) << std::setw( 3 ) << i++;
+        oss << std::setfill( '0' ) << std::setw( 3 ) << kinect->saved++;
         std::string file = oss.str() + ".ply";
 
         // Write Point Cloud to File
         cv::viz::writeCloud( file, cloud, color, cv::noArray(), false );
     }
+    // Toggle Filtered and Full Resolution Point Cloud when Pressed 'f' key
+    else if( event.code == 'f' && event.action == cv::viz::KeyboardEvent::Action::KEY_DOWN ){
+        Kinect* kinect = static_cast<Kinect*>( cookie );
+        kinect->filtering = !kinect->filtering;
+    }
+    // Toggle Coloring Point Cloud by Normals when Pressed 'n' key
+    else if( event.code == 'n' && event.action == cv::viz::KeyboardEvent::Action::KEY_DOWN ){
+        Kinect* kinect = static_cast<Kinect*>( cookie );
+        kinect->shading = !kinect->shading;
+    }
+    // Start and Stop Continuous Capture to Binary PCD Sequence when Pressed 'c' key
+    else if( event.code == 'c' && event.action == cv::viz::KeyboardEvent::Action::KEY_DOWN ){
+        Kinect* kinect = static_cast<Kinect*>( cookie );
+        kinect->recording = !kinect->recording;
+    }
+    // Start ( from Empty ) and Stop Accumulating Point Clouds when Pressed 'a' key
+    else if( event.code == 'a' && event.action == cv::viz::KeyboardEvent::Action::KEY_DOWN ){
+        Kinect* kinect = static_cast<Kinect*>( cookie );
+        kinect->accumulating = !kinect->accumulating;
+        if( kinect->accumulating ){
+            kinect->accumulateReset = true;
+        }
+    }
 };
 
 // Finalize
@@ -173,17 +270,26 @@ void Kinect::finalize()
 }
 
 // Update Data
-void Kinect::update()
+bool Kinect::update( Frame& frame )
 {
     // Update Color
-    updateColor();
+    updateColor( frame );
 
     // Update Depth
-    updateDepth();
+    updateDepth( frame );
+
+    // Wait until Both Color and Depth are Updated
+    if( !frame.colorUpdated || !frame.depthUpdated ){
+        return false;
+    }
+
+    frame.colorUpdated = false;
+    frame.depthUpdated = false;
+    return true;
 }
 
 // Update Color
-inline void Kinect::updateColor()
+inline void Kinect::updateColor( Frame& frame )
 {
     // Retrieve Color Frame
     ComPtr<IColorFrame> colorFrame;
@@ -193,11 +299,12 @@ inline void Kinect::updateColor()
     }
 
     // Convert Format ( YUY2 -> BGRA )
-    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( colorBuffer.size() ), &colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    ERROR_CHECK( colorFrame->CopyConvertedFrameDataToArray( static_cast<UINT>( frame.colorBuffer.size() ), &frame.colorBuffer[0], ColorImageFormat::ColorImageFormat_Bgra ) );
+    frame.colorUpdated = true;
 }
 
 // Update Depth
-inline void Kinect::updateDepth()
+inline void Kinect::updateDepth( Frame& frame )
 {
     // Retrieve Depth Frame
     ComPtr<IDepthFrame> depthFrame;
@@ -207,98 +314,220 @@ inline void Kinect::updateDepth()
     }
 
     // Retrieve Depth Data
-    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0] ) );
+    ERROR_CHECK( depthFrame->CopyFrameDataToArray( static_cast<UINT>( frame.depthBuffer.size() ), &frame.depthBuffer[0] ) );
+    frame.depthUpdated = true;
 }
 
 // Draw Data
-void Kinect::draw()
+void Kinect::draw( Frame& frame )
 {
     // Draw Color
-    drawColor();
+    drawColor( frame );
 
     // Draw Point Cloud
-    drawPointCloud();
+    drawPointCloud( frame );
 }
 
 // Draw Color
-inline void Kinect::drawColor()
+inline void Kinect::drawColor( Frame& frame )
 {
-    // Retrieve Mapped Coordinates
-    std::vector<ColorSpacePoint> colorSpacePoints( depthWidth * depthHeight );
-    ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( depthBuffer.size(), &depthBuffer[0], colorSpacePoints.size(), &colorSpacePoints[0] ) );
+    // Initialize Registration after Coordinate Mapper Received Calibration from Sensor
+    if( !registration.isInitialized() ){
+        initializeRegistration();
+        if( !registration.isInitialized() ){
+            return;
+        }
+    }
 
     // Mapping Color to Depth Resolution
-    std::vector<BYTE> buffer( depthWidth * depthHeight * colorBytesPerPixel );
-
-    Concurrency::parallel_for( 0, depthHeight, [&]( const int depthY ){
-        const unsigned int depthOffset = depthY * depthWidth;
-        for( int depthX = 0; depthX < depthWidth; depthX++ ){
-            unsigned int depthIndex = depthOffset + depthX;
-            const int colorX = static_cast<int>( colorSpacePoints[depthIndex].X + 0.5f );
-            const int colorY = static_cast<int>( colorSpacePoints[depthIndex].Y + 0.5f );
-            if( ( 0 <= colorX ) && ( colorX < colorWidth ) && ( 0 <= colorY ) && ( colorY < colorHeight ) ){
-                const unsigned int colorIndex = ( colorY * colorWidth + colorX ) * colorBytesPerPixel;
-                depthIndex = depthIndex * colorBytesPerPixel;
-                buffer[depthIndex + 0] = colorBuffer[colorIndex + 0];
-                buffer[depthIndex + 1] = colorBuffer[colorIndex + 1];
-                buffer[depthIndex + 2] = colorBuffer[colorIndex + 2];
-                buffer[depthIndex + 3] = colorBuffer[colorIndex + 3];
-            }
-        }
-    } );
+    registration.registerColor( &frame.depthBuffer[0], &frame.colorBuffer[0], frame.colorFrameBuffer.ptr<BYTE>() );
 
-    // Create cv::Mat from Coordinate Buffer
-    colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, &buffer[0] ).clone();
+    // Create cv::Mat from Frame Buffer
+    frame.colorMat = cv::Mat( depthHeight, depthWidth, CV_8UC4, frame.colorFrameBuffer.data() );
 }
 
 // Draw Point Cloud
-inline void Kinect::drawPointCloud()
+inline void Kinect::drawPointCloud( Frame& frame )
 {
-    // Retrieve Mapped Coordinates
-    std::vector<CameraSpacePoint> cameraSpacePoints( depthWidth * depthHeight );
-    ERROR_CHECK( coordinateMapper->MapDepthFrameToCameraSpace( depthBuffer.size(), &depthBuffer[0], cameraSpacePoints.size(), &cameraSpacePoints[0] ) );
+    // Initialize Point Cloud Generator after Coordinate Mapper Received Calibration from Sensor
+    if( !generator.isInitialized() ){
+        initializeGenerator();
+        if( !generator.isInitialized() ){
+            return;
+        }
+    }
 
-    // Mapping Color to Depth Resolution
-    std::vector<cv::Vec3f> buffer( depthWidth * depthHeight, cv::Vec3f::all( std::numeric_limits<float>::quiet_NaN() ) );
-
-    Concurrency::parallel_for( 0, depthHeight, [&]( const int depthY ){
-        const unsigned int depthOffset = depthY * depthWidth;
-        for( int depthX = 0; depthX < depthWidth; depthX++ ){
-            unsigned int depthIndex = depthOffset + depthX;
-            UINT16 depth = depthBuffer[depthIndex];
-            if( 500 <= depth && depth < 8000 ){
-                CameraSpacePoint cameraSpacePoint = cameraSpacePoints[depthIndex];
-                buffer[depthIndex] = cv::Vec3f( cameraSpacePoint.X, cameraSpacePoint.Y, cameraSpacePoint.Z );
-            }
+    // Back-project Depth to Organized Point Cloud ( Invalid Depth is NaN, Serial as a Frame Takes less than Scheduling Rows )
+    float* buffer = frame.cloudFrameBuffer.ptr<float>();
+    generator.generateOrganized( &frame.depthBuffer[0], buffer );
+
+    // Create cv::Mat from Frame Buffer
+    frame.cloudMat = cv::Mat( depthHeight, depthWidth, CV_32FC3, buffer );
+
+    // Back-project Valid Depth to Compacted Point Cloud with Registered Color for Processing
+    generator.generateCompact( &frame.depthBuffer[0], frame.colorFrameBuffer.ptr<uint32_t>(), pointCloud );
+
+    // Take Snapshot of Keyboard Toggles, so Draw and Show of this Frame use the Same Modes
+    frame.filtering = filtering;
+    frame.shading = shading;
+    frame.recording = recording;
+    frame.accumulating = accumulating;
+
+    // Record Point Cloud
+    recordPointCloud( frame );
+
+    // Filter Point Cloud
+    if( frame.filtering ){
+        filterPointCloud( frame );
+    }
+
+    // Estimate Normals
+    if( frame.shading ){
+        estimateNormals( frame );
+    }
+
+    // Accumulate Point Cloud
+    if( frame.accumulating ){
+        accumulatePointCloud( frame );
+    }
+}
+
+// Filter Point Cloud
+inline void Kinect::filterPointCloud( Frame& frame )
+{
+    // Downsample to 1 cm Voxels, then Remove Flying Pixels at Depth Edges
+    filter.voxelGrid( pointCloud, 0.01f, VoxelGridMode_Centroid, downsampledCloud );
+    filter.radiusOutlier( downsampledCloud, 0.02f, 4, filteredCloud );
+
+    // Interleave Points for cv::viz::WCloud
+    frame.filteredPoints.resize( filteredCloud.size );
+    frame.filteredColors.resize( filteredCloud.size );
+    for( size_t i = 0; i < filteredCloud.size; i++ ){
+        frame.filteredPoints[i] = cv::Vec3f( filteredCloud.x[i], filteredCloud.y[i], filteredCloud.z[i] );
+        frame.filteredColors[i] = filteredCloud.color[i];
+    }
+}
+
+// Estimate Normals
+inline void Kinect::estimateNormals( Frame& frame )
+{
+    // Estimate Normals of Organized Point Cloud ( NaN at Depth Discontinuities and Invalid Pixels )
+    normalMat.create( depthHeight, depthWidth, CV_32FC3 );
+    normalEstimator.estimate( frame.cloudMat.ptr<float>(), depthWidth, depthHeight, normalMat.ptr<float>() );
+
+    // Color by Normals ( BGR = ( Z, Y, X ) Mapped from [-1, 1] to [0, 255], Black for Invalid )
+    frame.normalColorMat.create( depthHeight, depthWidth, CV_8UC3 );
+    const cv::Vec3f* normals = normalMat.ptr<cv::Vec3f>();
+    cv::Vec3b* colors = frame.normalColorMat.ptr<cv::Vec3b>();
+    for( int i = 0; i < depthWidth * depthHeight; i++ ){
+        const cv::Vec3f& normal = normals[i];
+        if( std::isnan( normal[0] ) ){
+            colors[i] = cv::Vec3b( 0, 0, 0 );
+            continue;
         }
-    } );
+        colors[i] = cv::Vec3b( cv::saturate_cast<uchar>( ( normal[2] + 1.0f ) * 127.5f ), cv::saturate_cast<uchar>( ( normal[1] + 1.0f ) * 127.5f ), cv::saturate_cast<uchar>( ( normal[0] + 1.0f ) * 127.5f ) );
+    }
+}
+
+// Record Point Cloud
+inline void Kinect::recordPointCloud( Frame& frame )
+{
+    // Start Sequence ( capture000_000000.pcd, capture000_000001.pcd, ... )
+    if( frame.recording && !recorder.isOpen() ){
+        std::ostringstream oss;
+        oss << "capture" << std::setfill( '0' ) << std::setw( 3 ) << sequence++ << "_";
+        recorder.open( oss.str(), PointCloudFormat_PCD );
+    }
+
+    // Stop Sequence after Queued Frames are Written
+    if( !frame.recording && recorder.isOpen() ){
+        recorder.close();
+        return;
+    }
+
+    // Hand Over Frame to Writer Thread ( Dropped if Writer is Behind )
+    if( frame.recording ){
+        recorder.record( pointCloud );
+        frame.statistics = recorder.getStatistics();
+    }
+}
+
+// Accumulate Point Cloud
+inline void Kinect::accumulatePointCloud( Frame& frame )
+{
+    // Start from Empty Octree when Accumulating was Turned On
+    if( accumulateReset.exchange( false ) ){
+        octree.clear();
+        level = 1;
+    }
+
+    // Insert Filtered Cloud ( or Full Cloud if Filter is Off ) in Camera Space, assuming Sensor does not Move
+    octree.insert( frame.filtering ? filteredCloud : pointCloud );
+
+    // Extract Level of Detail, Coarser Level when it Exceeds 500k Points for Next Frames
+    octree.extractLevelOfDetail( level, levelOfDetail );
+    if( levelOfDetail.size() > 500000 && level < octree.getDepth() ){
+        level++;
+    }
 
-    // Create cv::Mat from Coordinate Buffer
-    cloudMat = cv::Mat( depthHeight, depthWidth, CV_32FC3, &buffer[0] ).clone();
+    // Split Points and Colors for cv::viz::WCloud
+    frame.accumulatedPoints.resize( levelOfDetail.size() );
+    frame.accumulatedColors.resize( levelOfDetail.size() );
+    for( size_t i = 0; i < levelOfDetail.size(); i++ ){
+        frame.accumulatedPoints[i] = cv::Vec3f( levelOfDetail[i].x, levelOfDetail[i].y, levelOfDetail[i].z );
+        frame.accumulatedColors[i] = levelOfDetail[i].color;
+    }
 }
 
 // Show Data
-void Kinect::show()
+void Kinect::show( Frame& frame )
 {
     // Show Point Cloud
-    showPointCloud();
+    showPointCloud( frame );
 }
 
 // Show Point Cloud
-inline void Kinect::showPointCloud()
+inline void Kinect::showPointCloud( Frame& frame )
 {
-    if( colorMat.empty() ){
+    // Show Recording Status
+    if( frame.recording ){
+        std::ostringstream oss;
+        oss << "Recording " << frame.statistics.written << " frames ( " << frame.statistics.dropped << " dropped )";
+        viewer.showWidget( "Recording", cv::viz::WText( oss.str(), cv::Point( 10, 10 ), 16 ) );
+        recordingWidget = true;
+    }
+    else if( recordingWidget ){
+        viewer.removeWidget( "Recording" );
+        recordingWidget = false;
+    }
+
+    if( frame.colorMat.empty() ){
         return;
     }
 
-    if( cloudMat.empty() ){
+    if( frame.cloudMat.empty() ){
         return;
     }
 
-    // Create Point Cloud
-    cv::viz::WCloud cloud( cloudMat, colorMat );
+    // Create Point Cloud ( Accumulated and Filtered Clouds are 1 x N, Normal Colors are for Organized Cloud )
+    cv::Mat points = frame.cloudMat;
+    cv::Mat colors = frame.colorMat;
+    if( frame.accumulating && !frame.accumulatedPoints.empty() ){
+        points = cv::Mat( 1, static_cast<int>( frame.accumulatedPoints.size() ), CV_32FC3, &frame.accumulatedPoints[0] );
+        colors = cv::Mat( 1, static_cast<int>( frame.accumulatedColors.size() ), CV_8UC4, &frame.accumulatedColors[0] );
+    }
+    else if( frame.shading && !frame.normalColorMat.empty() ){
+        colors = frame.normalColorMat;
+    }
+    else if( frame.filtering && !frame.filteredPoints.empty() ){
+        points = cv::Mat( 1, static_cast<int>( frame.filteredPoints.size() ), CV_32FC3, &frame.filteredPoints[0] );
+        colors = cv::Mat( 1, static_cast<int>( frame.filteredColors.size() ), CV_8UC4, &frame.filteredColors[0] );
+    }
+    cv::viz::WCloud cloud( points, colors );
 
-    // Show Point Cloud
+    // Show Point Cloud ( Keyboard Callback can Save this Frame during spinOnce() )
     viewer.showWidget( "Cloud", cloud );
+    presentedFrame = &frame;
     viewer.spinOnce();
+    presentedFrame = nullptr;
 }
\ No newline at end of file
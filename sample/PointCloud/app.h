@@ -4,9 +4,18 @@
 #include <Windows.h>
 #include <Kinect.h>
 #include <opencv2/opencv.hpp>
+#include "Registration.h"
+#include "FramePool.h"
+#include "Pipeline.h"
+#include "PointCloud.h"
+#include "PointCloudFilter.h"
+#include "NormalEstimator.h"
+#include "PointCloudRecorder.h"
+#include "PointOctree.h"
 #include <opencv2/viz.hpp>
 
 #include <vector>
+#include <atomic>
 
 #include <wrl/client.h>
 using namespace Microsoft::WRL;
@@ -20,26 +29,89 @@ private:
     // Coordinate Mapper
     ComPtr<ICoordinateMapper> coordinateMapper;
 
+    // Registration
+    Registration registration;
+
     // Reader
     ComPtr<IColorFrameReader> colorFrameReader;
     ComPtr<IDepthFrameReader> depthFrameReader;
 
     // Color Buffer
-    std::vector<BYTE> colorBuffer;
     int colorWidth;
     int colorHeight;
     unsigned int colorBytesPerPixel;
-    cv::Mat colorMat;
 
     // Depth Buffer
-    std::vector<UINT16> depthBuffer;
     int depthWidth;
     int depthHeight;
     unsigned int depthBytesPerPixel;
 
     // Point Cloud Buffer
     cv::viz::Viz3d viewer;
-    cv::Mat cloudMat;
+    PointCloudGenerator generator;
+    PointCloud pointCloud;
+
+    // Point Cloud Filter ( Downsampled Cloud for Viewer )
+    PointCloudFilter filter;
+    PointCloud downsampledCloud;
+    PointCloud filteredCloud;
+    std::atomic<bool> filtering;
+
+    // Normal Estimator ( Normals of Organized Cloud for Shading )
+    NormalEstimator normalEstimator;
+    cv::Mat normalMat;
+    std::atomic<bool> shading;
+
+    // Point Cloud Recorder ( Continuous Capture of Compacted Cloud )
+    PointCloudRecorder recorder;
+    std::atomic<bool> recording;
+    int sequence;
+    bool recordingWidget;
+
+    // Point Octree ( Accumulated Cloud of Many Frames, Shown as Level of Detail )
+    PointOctree octree;
+    std::vector<OctreePoint> levelOfDetail;
+    int level;
+    std::atomic<bool> accumulating;
+    std::atomic<bool> accumulateReset;
+
+    // Frame Buffer Pool
+    FramePool colorPool;
+    FramePool cloudPool;
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Depth are Updated )
+    struct Frame
+    {
+        std::vector<BYTE> colorBuffer;
+        std::vector<UINT16> depthBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        FrameBuffer colorFrameBuffer;
+        FrameBuffer cloudFrameBuffer;
+        cv::Mat colorMat;
+        cv::Mat cloudMat;
+
+        // Modes of Draw Stage ( Snapshot of Keyboard Toggles ) and Outputs for Show Stage
+        bool filtering;
+        bool shading;
+        bool recording;
+        bool accumulating;
+        std::vector<cv::Vec3f> filteredPoints;
+        std::vector<uint32_t> filteredColors;
+        cv::Mat normalColorMat;
+        PointCloudRecorderStatistics statistics;
+        std::vector<cv::Vec3f> accumulatedPoints;
+        std::vector<uint32_t> accumulatedColors;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Frame being Shown ( Saved by Keyboard Callback during spinOnce() )
+    const Frame* presentedFrame;
+
+    // Number of Saved Point Clouds ( Sequence Number of File Saved by Keyboard Callback )
+    int saved;
 
 public:
     // Constructor
@@ -64,6 +136,15 @@ private:
     // Initialize Depth
     inline void initializeDepth();
 
+    // Initialize Registration
+    inline void initializeRegistration();
+
+    // Initialize Point Cloud Generator
+    inline void initializeGenerator();
+
+    // Initialize Frame Buffer Pool
+    inline void initializeFramePool();
+
     // Initialize Point Cloud
     inline void initializePointCloud();
 
@@ -74,28 +155,40 @@ private:
     void finalize();
 
     // Update Data
-    void update();
+    bool update( Frame& frame );
 
     // Update Color
-    inline void updateColor();
+    inline void updateColor( Frame& frame );
 
     // Update Depth
-    inline void updateDepth();
+    inline void updateDepth( Frame& frame );
 
     // Draw Data
-    void draw();
+    void draw( Frame& frame );
 
     // Draw Color
-    inline void drawColor();
+    inline void drawColor( Frame& frame );
 
     // Draw Point Cloud
-    inline void drawPointCloud();
+    inline void drawPointCloud( Frame& frame );
+
+    // Filter Point Cloud
+    inline void filterPointCloud( Frame& frame );
+
+    // Estimate Normals
+    inline void estimateNormals( Frame& frame );
+
+    // Record Point Cloud
+    inline void recordPointCloud( Frame& frame );
+
+    // Accumulate Point Cloud
+    inline void accumulatePointCloud( Frame& frame );
 
     // Show Data
-    void show();
+    void show( Frame& frame );
 
     // Show Point Cloud
-    inline void showPointCloud();
+    inline void showPointCloud( Frame& frame );
 };
 
 #endif // __APP__
\ No newline at end of file
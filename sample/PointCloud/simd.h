@@ -0,0 +1,84 @@
+#ifndef __SIMD__
+#define __SIMD__
+
+// x86 SIMD Intrinsics
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Function Target Attribute
+// MSVC always emits every instruction set, GCC and Clang have to enable it per function
+#if defined( SIMD_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define SIMD_TARGET_SSE41 __attribute__( ( target( "sse4.1" ) ) )
+#define SIMD_TARGET_AVX2 __attribute__( ( target( "avx2,fma" ) ) )
+#else
+#define SIMD_TARGET_SSE41
+#define SIMD_TARGET_AVX2
+#endif
+
+#ifdef SIMD_X86
+// Check CPU Supports SSE4.1
+inline bool CheckSSE41()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 1 );
+    return ( info[2] & ( 1 << 19 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "sse4.1" ) != 0;
+#endif
+}
+
+// Check CPU and OS Support AVX2 and FMA
+inline bool CheckAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 1 );
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool fma = ( info[2] & ( 1 << 12 ) ) != 0;
+    if( !osxsave || !fma ){
+        return false;
+    }
+
+    // YMM Registers are Saved by OS
+    if( ( _xgetbv( 0 ) & 0x6 ) != 0x6 ){
+        return false;
+    }
+
+    __cpuidex( info, 7, 0 );
+    return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+    return __builtin_cpu_supports( "avx2" ) != 0 && __builtin_cpu_supports( "fma" ) != 0;
+#endif
+}
+
+// Supported Instruction Set ( Checked Once )
+inline bool IsSupportedSSE41()
+{
+    static const bool supported = CheckSSE41();
+    return supported;
+}
+
+inline bool IsSupportedAVX2()
+{
+    static const bool supported = CheckAVX2();
+    return supported;
+}
+#else
+inline bool IsSupportedSSE41()
+{
+    return false;
+}
+
+inline bool IsSupportedAVX2()
+{
+    return false;
+}
+#endif
+
+#endif // __SIMD__
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "Test.h"
+#include "AllocationCounter.h"
+#include "FramePool.h"
+#include "Pipeline.h"
+#include "SyntheticSource.h"
+#include "Registration.h"
+#include "ImageKernel.h"
+#include "Yuy2.h"
+
+#include <vector>
+#include <cstdint>
+#include <string>
+
+// Allocation Check
+// Runs the frame loop of the samples on synthetic frames ( Update, Draw and Show on Pipeline Stages, Draw Results in Frame Buffer Pool, Show Buffers Allocated Once ),
+// and counts heap allocations after warm-up. Draw and show call the same helpers as the samples.
+//   Color : Yuy2::convertToBGRA
+//   CoordinateMapper, ChromaKey, Inpaint ( DEPTH ) : Registration::registerColor, ImageKernel::chromaKey, ImageKernel::maskDepth, ImageKernel::scaleDepth
+//   CoordinateMapper, ChromaKey, Inpaint ( COLOR ) : ImageKernel::remap, ImageKernel::halve
+// Not covered are calls to Kinect SDK, cv::Mat headers and frame sink, and cv::inpaint of Inpaint that allocates its working buffers inside OpenCV.
+class AllocationCheck
+{
+private:
+    // Synthetic Source
+    SyntheticSource synthetic;
+
+    // Color Buffer
+    int colorWidth;
+    int colorHeight;
+
+    // Depth Buffer
+    int depthWidth;
+    int depthHeight;
+
+    // Registration
+    Registration registration;
+
+    // Mapped Coordinates of Color Pixels in Depth Space ( Same Role as ICoordinateMapper::MapColorFrameToDepthSpace )
+    struct Point{ float X; float Y; };
+    std::vector<Point> depthSpacePoints;
+
+    // Frame Buffer Pool
+    FramePool colorPool;
+    FramePool registeredPool;
+    FramePool chromaKeyPool;
+    FramePool maskPool;
+    FramePool remapPool;
+
+    // Show Buffer ( Allocated Once, Reused by Show Stage )
+    std::vector<uint8_t> colorResizeBuffer;
+    std::vector<uint8_t> depthScaleBuffer;
+    std::vector<uint8_t> remapScaleBuffer;
+    std::vector<uint8_t> remapResizeBuffer;
+
+    // Frame ( Buffers Passed between Pipeline Stages, Passed to Draw when Both Color and Depth are Updated )
+    struct Frame
+    {
+        std::vector<uint8_t> colorBuffer;
+        std::vector<uint16_t> depthBuffer;
+        std::vector<uint8_t> bodyIndexBuffer;
+        bool colorUpdated;
+        bool depthUpdated;
+        FrameBuffer colorFrameBuffer;
+        FrameBuffer registeredFrameBuffer;
+        FrameBuffer chromaKeyFrameBuffer;
+        FrameBuffer maskFrameBuffer;
+        FrameBuffer remapFrameBuffer;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Number of Frames
+    uint64_t frames;
+    uint64_t warmup;
+    uint64_t presented;
+
+    // Result
+    uint64_t baseline;    // Allocations at End of Warm-up
+    uint64_t allocations; // Allocations during Checked Frames
+
+public:
+    // Constructor ( Number of Checked Frames and Warm-up Frames )
+    AllocationCheck( const uint64_t frames = 300, const uint64_t warmup = 30 )
+        : synthetic( 0.0 ),
+          frames( frames ),
+          warmup( warmup ),
+          presented( 0 ),
+          baseline( 0 ),
+          allocations( 0 )
+    {
+        // Initialize
+        initialize();
+    }
+
+    // Processing ( Returns Number of Allocations during Checked Frames )
+    uint64_t run()
+    {
+        // Main Loop ( Update, Draw and Show run on Pipeline Stages )
+        pipeline.run(
+            // Update Data
+            [&]( Frame& frame ){ return update( frame ); },
+            // Draw Data
+            [&]( Frame& frame ){ draw( frame ); },
+            // Show Data
+            [&]( Frame& frame ){ show( frame ); },
+            // Check Number of Frames
+            [&](){ return presented < warmup + frames; }
+        );
+
+        // Show Result
+        pipeline.printStatistics( std::cout );
+        std::cout << "Allocations : " << allocations << " in " << frames << " frames ( " << ( AllocationCounter::countsMalloc() ? "malloc and operator new" : "operator new only" ) << " )" << std::endl;
+
+        return allocations;
+    }
+
+private:
+    // Initialize
+    void initialize()
+    {
+        colorWidth = SyntheticSource::colorWidth;
+        colorHeight = SyntheticSource::colorHeight;
+        depthWidth = SyntheticSource::depthWidth;
+        depthHeight = SyntheticSource::depthHeight;
+
+        // Initialize Registration from Synthetic Calibration ( Similar to Kinect v2 )
+        const RegistrationIntrinsics depthIntrinsics = { 365.5f, 365.5f, 257.0f, 204.5f, 0.092f, -0.271f, 0.095f };
+        const RegistrationIntrinsics colorIntrinsics = { 1062.0f, 1062.0f, 963.0f, 534.0f, 0.025f, -0.020f, 0.0f };
+        const RegistrationExtrinsics extrinsics = { { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f }, { 0.052f, 0.0f, 0.0f } };
+        registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, depthIntrinsics, colorIntrinsics, extrinsics );
+
+        // Initialize Mapped Coordinates ( Color Frame Scaled to Depth Frame )
+        depthSpacePoints.resize( static_cast<size_t>( colorWidth ) * colorHeight );
+        for( int colorY = 0; colorY < colorHeight; colorY++ ){
+            for( int colorX = 0; colorX < colorWidth; colorX++ ){
+                Point& point = depthSpacePoints[static_cast<size_t>( colorY ) * colorWidth + colorX];
+                point.X = ( colorX - colorWidth * 0.5f ) * 0.35f + depthWidth * 0.5f;
+                point.Y = ( colorY - colorHeight * 0.5f ) * 0.35f + depthHeight * 0.5f;
+            }
+        }
+
+        // Allocation Color ( YUY2 ), Depth and Body Index Buffers
+        pipeline.forEachFrame( [&]( Frame& frame ){
+            frame.colorBuffer.resize( static_cast<size_t>( colorWidth ) * colorHeight * 2 );
+            frame.depthBuffer.resize( static_cast<size_t>( depthWidth ) * depthHeight );
+            frame.bodyIndexBuffer.resize( static_cast<size_t>( depthWidth ) * depthHeight );
+            frame.colorUpdated = false;
+            frame.depthUpdated = false;
+        } );
+
+        // Allocation Frame Buffers ( One Buffer per Frame )
+        const size_t colorSize = static_cast<size_t>( colorWidth ) * colorHeight;
+        const size_t depthSize = static_cast<size_t>( depthWidth ) * depthHeight;
+        colorPool.allocate( colorSize * 4, pipeline.size() );
+        registeredPool.allocate( depthSize * 4, pipeline.size() );
+        chromaKeyPool.allocate( depthSize * 4, pipeline.size() );
+        maskPool.allocate( depthSize, pipeline.size() );
+        remapPool.allocate( colorSize * 2, pipeline.size() );
+        pipeline.forEachFrame( [&]( Frame& frame ){
+            frame.colorFrameBuffer = colorPool.acquire();
+            frame.registeredFrameBuffer = registeredPool.acquire();
+            frame.chromaKeyFrameBuffer = chromaKeyPool.acquire();
+            frame.maskFrameBuffer = maskPool.acquire();
+            frame.remapFrameBuffer = remapPool.acquire();
+        } );
+
+        // Allocation Show Buffers
+        colorResizeBuffer.resize( ( colorSize / 4 ) * 4 );
+        depthScaleBuffer.resize( depthSize );
+        remapScaleBuffer.resize( colorSize );
+        remapResizeBuffer.resize( colorSize / 4 );
+    }
+
+    // Update Data
+    bool update( Frame& frame )
+    {
+        // Update Color
+        if( synthetic.acquireColor( &frame.colorBuffer[0] ) ){
+            frame.colorUpdated = true;
+        }
+
+        // Update Depth and Body Index ( Body is Sphere in front of Wall )
+        if( synthetic.acquireDepth( &frame.depthBuffer[0] ) ){
+            for( size_t index = 0; index < frame.depthBuffer.size(); index++ ){
+                const uint16_t depth = frame.depthBuffer[index];
+                frame.bodyIndexBuffer[index] = ( depth != 0 && depth < 2000 ) ? 0 : 0xff;
+            }
+            frame.depthUpdated = true;
+        }
+
+        // Wait until Both Color and Depth are Updated
+        if( !frame.colorUpdated || !frame.depthUpdated ){
+            return false;
+        }
+
+        frame.colorUpdated = false;
+        frame.depthUpdated = false;
+        return true;
+    }
+
+    // Draw Data
+    void draw( Frame& frame )
+    {
+        const size_t depthSize = frame.depthBuffer.size();
+
+        // Convert Color ( YUY2 -> BGRA ) into Frame Buffer
+        Yuy2::convertToBGRA( &frame.colorBuffer[0], colorWidth, colorHeight, frame.colorFrameBuffer.ptr<uint8_t>() );
+
+        // Mapping Color to Depth Resolution ( DEPTH )
+        registration.registerColor( &frame.depthBuffer[0], frame.colorFrameBuffer.ptr<uint8_t>(), frame.registeredFrameBuffer.ptr<uint8_t>() );
+
+        // ChromaKey ( DEPTH )
+        ImageKernel::chromaKey( frame.registeredFrameBuffer.ptr<uint32_t>(), &frame.bodyIndexBuffer[0], depthSize, frame.chromaKeyFrameBuffer.ptr<uint32_t>() );
+
+        // Create Inpaint Mask
+        ImageKernel::maskDepth( &frame.depthBuffer[0], depthSize, 500, frame.maskFrameBuffer.ptr<uint8_t>() );
+
+        // Mapping Depth to Color Resolution ( COLOR, Row by Row like parallel_for of Samples )
+        for( int colorY = 0; colorY < colorHeight; colorY++ ){
+            const size_t colorOffset = static_cast<size_t>( colorY ) * colorWidth;
+            ImageKernel::remap<uint16_t>( &frame.depthBuffer[0], depthWidth, depthHeight, &depthSpacePoints[colorOffset], colorWidth, 0, frame.remapFrameBuffer.ptr<uint16_t>() + colorOffset );
+        }
+    }
+
+    // Show Data
+    void show( Frame& frame )
+    {
+        // Resize Color ( COLOR )
+        ImageKernel::halve( frame.colorFrameBuffer.ptr<uint8_t>(), colorWidth, colorHeight, 4, &colorResizeBuffer[0] );
+
+        // Scaling Depth ( DEPTH, 0-8000 -> 255-0 )
+        ImageKernel::scaleDepth( &frame.depthBuffer[0], frame.depthBuffer.size(), &depthScaleBuffer[0] );
+
+        // Scaling and Resize Depth ( COLOR )
+        ImageKernel::scaleDepth( frame.remapFrameBuffer.ptr<uint16_t>(), remapScaleBuffer.size(), &remapScaleBuffer[0] );
+        ImageKernel::halve( &remapScaleBuffer[0], colorWidth, colorHeight, 1, &remapResizeBuffer[0] );
+
+        // Count Allocations of Checked Frames
+        presented++;
+        if( presented == warmup ){
+            baseline = AllocationCounter::count();
+        }
+        else if( presented == warmup + frames ){
+            allocations = AllocationCounter::count() - baseline;
+        }
+    }
+};
+
+int main( int argc, char* argv[] )
+{
+    // Number of Checked Frames ( after 30 Warm-up Frames )
+    const uint64_t frames = ( argc > 1 ) ? std::stoull( argv[1] ) : 300;
+
+    // Check Counter Detects Allocation ( Volatile Pointers Keep Compiler from Removing Pair of Allocation and Deallocation )
+    const uint64_t before = AllocationCounter::count();
+    std::vector<uint8_t>* volatile vector = new std::vector<uint8_t>( 1024 );
+    delete vector;
+    void* volatile pointer = std::malloc( 1024 );
+    std::free( pointer );
+    CHECK( AllocationCounter::count() - before >= ( AllocationCounter::countsMalloc() ? 3u : 2u ) );
+
+    // Check Frame Loop does not Allocate
+    AllocationCheck check( frames );
+    CHECK( check.run() == 0 );
+
+    return Test::result( "Allocation Check" );
+}
\ No newline at end of file
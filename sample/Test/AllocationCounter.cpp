@@ -0,0 +1,139 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined( _MSC_VER ) && defined( _DEBUG )
+#include <crtdbg.h>
+#endif
+
+// Number of Allocations ( Constant Initialized, so It can be Used before Static Constructors Run )
+static std::atomic<uint64_t> allocations( 0 );
+
+uint64_t AllocationCounter::count()
+{
+    return allocations.load();
+}
+
+#if defined( __GLIBC__ )
+// Replacement of malloc Family ( Forwards to glibc Implementation )
+extern "C"
+{
+    void* __libc_malloc( size_t size );
+    void* __libc_calloc( size_t count, size_t size );
+    void* __libc_realloc( void* pointer, size_t size );
+    void* __libc_memalign( size_t alignment, size_t size );
+    void __libc_free( void* pointer );
+
+    void* malloc( size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_malloc( size );
+    }
+
+    void* calloc( size_t count, size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_calloc( count, size );
+    }
+
+    void* realloc( void* pointer, size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_realloc( pointer, size );
+    }
+
+    void* memalign( size_t alignment, size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_memalign( alignment, size );
+    }
+
+    void* aligned_alloc( size_t alignment, size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        return __libc_memalign( alignment, size );
+    }
+
+    int posix_memalign( void** pointer, size_t alignment, size_t size )
+    {
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+        void* result = __libc_memalign( alignment, size );
+        if( result == nullptr ){
+            return ENOMEM;
+        }
+        *pointer = result;
+        return 0;
+    }
+
+    void free( void* pointer )
+    {
+        __libc_free( pointer );
+    }
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return true;
+}
+#elif defined( _MSC_VER ) && defined( _DEBUG )
+// Allocation Hook of Debug CRT ( Installed before main )
+static int hook( int type, void*, size_t, int, long, const unsigned char*, int )
+{
+    if( type == _HOOK_ALLOC || type == _HOOK_REALLOC ){
+        allocations.fetch_add( 1, std::memory_order_relaxed );
+    }
+    return 1;
+}
+
+static const _CRT_ALLOC_HOOK previous = _CrtSetAllocHook( hook );
+
+bool AllocationCounter::countsMalloc()
+{
+    return true;
+}
+#else
+// Replacement of Global Operator New/Delete ( nothrow Versions Call These )
+void* operator new( std::size_t size )
+{
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    void* pointer = std::malloc( ( size != 0 ) ? size : 1 );
+    if( pointer == nullptr ){
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[]( std::size_t size )
+{
+    return operator new( size );
+}
+
+void operator delete( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete( void* pointer, std::size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+void operator delete[]( void* pointer, std::size_t ) noexcept
+{
+    std::free( pointer );
+}
+
+bool AllocationCounter::countsMalloc()
+{
+    return false;
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef __ALLOCATION_COUNTER__
+#define __ALLOCATION_COUNTER__
+
+#include <cstdint>
+
+// Allocation Counter
+// AllocationCounter.cpp counts every heap allocation on any thread.
+//   glibc : replaces malloc, calloc, realloc and aligned allocations ( operator new and cv::fastMalloc call these ).
+//   MSVC Debug CRT : counts allocations by allocation hook of CRT.
+//   Others : replaces global operator new only.
+namespace AllocationCounter
+{
+    // Retrieve Number of Allocations since Start of Program
+    uint64_t count();
+
+    // Retrieve Allocations by malloc() are Counted
+    bool countsMalloc();
+}
+
+#endif // __ALLOCATION_COUNTER__
\ No newline at end of file
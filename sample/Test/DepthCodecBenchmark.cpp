@@ -0,0 +1,92 @@
+#include "Test.h"
+#include "SyntheticDepth.h"
+#include "DepthCodec.h"
+#include "Record.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <iomanip>
+
+// Measure Compression Ratio and Encode/Decode Throughput of Sequence ( Key Frame every 30 Frames as Recording )
+void measure( const std::string& name, const int width, const int height, const std::vector<std::vector<uint16_t>>& frames )
+{
+    DepthEncoder encoder( width, height, 30 );
+    DepthDecoder decoder;
+    std::vector<std::vector<uint8_t>> encoded( frames.size() );
+    std::vector<uint16_t> decoded( static_cast<size_t>( width ) * height );
+
+    // Encode
+    const std::chrono::steady_clock::time_point encodeBegin = std::chrono::steady_clock::now();
+    size_t encodedBytes = 0;
+    for( size_t frame = 0; frame < frames.size(); frame++ ){
+        encodedBytes += encoder.encode( &frames[frame][0], encoded[frame] );
+    }
+    const double encodeTime = std::chrono::duration<double>( std::chrono::steady_clock::now() - encodeBegin ).count();
+
+    // Decode ( Whole Sequence, after One Warm-up Pass )
+    const double decodeTime = Test::measure( 3, [&](){
+        for( size_t frame = 0; frame < frames.size(); frame++ ){
+            decoder.decode( &encoded[frame][0], encoded[frame].size(), &decoded[0] );
+        }
+    } ) / 1000.0;
+
+    // Check Lossless
+    for( size_t frame = 0; frame < frames.size(); frame++ ){
+        decoder.decode( &encoded[frame][0], encoded[frame].size(), &decoded[0] );
+        CHECK( decoded == frames[frame] );
+    }
+
+    const double rawBytes = static_cast<double>( frames.size() ) * width * height * sizeof( uint16_t );
+    std::cout << std::fixed << std::setprecision( 2 );
+    std::cout << name << " : " << rawBytes / encodedBytes << ":1, " << encodedBytes / 1024.0 / frames.size() << " KB/frame, "
+              << "encode " << frames.size() / encodeTime << " frames/s, decode " << frames.size() / decodeTime << " frames/s" << std::endl;
+}
+
+// Depth Codec Benchmark ( Usage : DepthCodecBenchmark [frames] [recording.k2rec] )
+// Synthetic sequences are measured with Kinect-like noise, half noise and no noise.
+// Depth of recording is measured if given ( e.g. recorded by MultiSource sample ).
+int main( int argc, char* argv[] )
+{
+    const int count = Test::iterations( argc, argv, 90 );
+    const int width = 512;
+    const int height = 424;
+
+    // Synthetic Depth
+    const float noises[] = { 1.0f, 0.5f, 0.0f };
+    for( const float noise : noises ){
+        SyntheticDepth synthetic( width, height, noise );
+        std::vector<std::vector<uint16_t>> frames;
+        for( int frame = 0; frame < count; frame++ ){
+            frames.push_back( synthetic.generate( frame ) );
+        }
+        measure( "Synthetic ( Noise x" + std::to_string( noise ).substr( 0, 3 ) + " )", width, height, frames );
+    }
+
+    // Recorded Depth
+    if( argc > 2 ){
+        RecordReader reader;
+        reader.open( argv[2] );
+        RecordDepthDecoder recordDecoder;
+
+        std::vector<std::vector<uint16_t>> frames;
+        const size_t frameCount = std::min<size_t>( reader.count( RecordStream_Depth ), count );
+        const RecordFrame first = reader.frame( RecordStream_Depth, 0 );
+        for( size_t frame = 0; frame < frameCount; frame++ ){
+            const RecordFrame record = reader.frame( RecordStream_Depth, frame );
+            const uint16_t* depth = recordDecoder.decode( reader, RecordStream_Depth, frame );
+            if( depth == nullptr || record.width() != first.width() || record.height() != first.height() ){
+                continue;
+            }
+            frames.push_back( std::vector<uint16_t>( depth, depth + static_cast<size_t>( record.width() ) * record.height() ) );
+        }
+
+        CHECK( !frames.empty() );
+        if( !frames.empty() ){
+            measure( "Recording ( " + std::string( argv[2] ) + " )", first.width(), first.height(), frames );
+        }
+    }
+
+    return Test::result( "Depth Codec Benchmark" );
+}
\ No newline at end of file
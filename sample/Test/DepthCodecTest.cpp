@@ -0,0 +1,181 @@
+#include "Test.h"
+#include "SyntheticDepth.h"
+#include "DepthCodec.h"
+
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <algorithm>
+
+// Encode and Decode Sequence, Check Decoded Frames are Identical
+void checkRoundTrip( const int width, const int height, const int keyFrameInterval, const std::vector<std::vector<uint16_t>>& frames )
+{
+    DepthEncoder encoder( width, height, keyFrameInterval );
+    DepthDecoder decoder;
+    std::vector<uint8_t> encoded;
+    std::vector<uint16_t> decoded( static_cast<size_t>( width ) * height );
+    for( size_t frame = 0; frame < frames.size(); frame++ ){
+        encoder.encode( &frames[frame][0], encoded );
+        CHECK( DepthDecoder::isKeyFrame( &encoded[0], encoded.size() ) == ( frame % keyFrameInterval == 0 ) );
+
+        decoder.decode( &encoded[0], encoded.size(), &decoded[0] );
+        CHECK( decoded == frames[frame] );
+        CHECK( decoder.getWidth() == width && decoder.getHeight() == height );
+    }
+}
+
+// Generate Random Sequence ( Uniform Values in Range, Some Invalid )
+std::vector<std::vector<uint16_t>> generateRandom( const int width, const int height, const int count, const int minimum, const int maximum, std::mt19937& random )
+{
+    std::uniform_int_distribution<int> distribution( minimum, maximum );
+    std::vector<std::vector<uint16_t>> frames( count, std::vector<uint16_t>( static_cast<size_t>( width ) * height ) );
+    for( std::vector<uint16_t>& frame : frames ){
+        for( uint16_t& depth : frame ){
+            const int value = distribution( random );
+            depth = static_cast<uint16_t>( ( value % 17 == 0 ) ? 0 : value );
+        }
+    }
+    return frames;
+}
+
+int main( int argc, char* argv[] )
+{
+    std::mt19937 random( 0 );
+
+    // Synthetic Kinect Depth ( Full Size, Key Frame Only and Key Frame every 8 Frames )
+    {
+        SyntheticDepth synthetic( 512, 424 );
+        std::vector<std::vector<uint16_t>> frames;
+        for( int frame = 0; frame < 20; frame++ ){
+            frames.push_back( synthetic.generate( frame ) );
+        }
+        checkRoundTrip( 512, 424, 1, frames );
+        checkRoundTrip( 512, 424, 8, frames );
+    }
+
+    // Odd Sizes ( Rows are not Multiple of SIMD Width )
+    {
+        const int sizes[][2] = { { 1, 1 }, { 1, 37 }, { 37, 1 }, { 15, 9 }, { 17, 33 }, { 101, 7 } };
+        for( const auto& size : sizes ){
+            SyntheticDepth synthetic( size[0], size[1] );
+            std::vector<std::vector<uint16_t>> frames;
+            for( int frame = 0; frame < 6; frame++ ){
+                frames.push_back( synthetic.generate( frame ) );
+            }
+            checkRoundTrip( size[0], size[1], 3, frames );
+        }
+    }
+
+    // Extreme Values ( Full 16 bits Range Escapes, Small Range Literals )
+    checkRoundTrip( 64, 48, 4, generateRandom( 64, 48, 10, 0, 0xffff, random ) );
+    checkRoundTrip( 64, 48, 4, generateRandom( 64, 48, 10, 1000, 1003, random ) );
+
+    // Constant Frames ( All Invalid, All Same, Long Zero Runs )
+    {
+        std::vector<std::vector<uint16_t>> frames;
+        frames.push_back( std::vector<uint16_t>( 512 * 424, 0 ) );
+        frames.push_back( std::vector<uint16_t>( 512 * 424, 0xffff ) );
+        frames.push_back( std::vector<uint16_t>( 512 * 424, 1 ) );
+        frames.push_back( std::vector<uint16_t>( 512 * 424, 0 ) );
+        frames.push_back( std::vector<uint16_t>( 512 * 424, 2000 ) );
+        checkRoundTrip( 512, 424, 2, frames );
+    }
+
+    // Stateful Decoding ( Delta Frame without Reference is Rejected, Reset Forces Key Frame )
+    {
+        SyntheticDepth synthetic( 64, 48 );
+        DepthEncoder encoder( 64, 48, 30 );
+        std::vector<uint8_t> key, delta;
+        std::vector<uint16_t> decoded( 64 * 48 );
+        encoder.encode( &synthetic.generate( 0 )[0], key );
+        encoder.encode( &synthetic.generate( 1 )[0], delta );
+
+        DepthDecoder decoder;
+        bool thrown = false;
+        try{
+            decoder.decode( &delta[0], delta.size(), &decoded[0] );
+        } catch( std::runtime_error& ){
+            thrown = true;
+        }
+        CHECK( thrown );
+
+        const std::vector<uint16_t> frame = synthetic.generate( 2 );
+        encoder.reset();
+        encoder.encode( &frame[0], key );
+        CHECK( DepthDecoder::isKeyFrame( &key[0], key.size() ) );
+        decoder.decode( &key[0], key.size(), &decoded[0] );
+        CHECK( decoded == frame );
+
+        CHECK( !DepthDecoder::isKeyFrame( nullptr, 0 ) );
+        CHECK( !DepthDecoder::isKeyFrame( &key[0], sizeof( DepthCodecHeader ) - 1 ) );
+    }
+
+    // Fuzz ( Corrupted and Truncated Frames must be Rejected or Decoded within Frame, Decoder Recovers at Next Key Frame )
+    {
+        const int width = 96;
+        const int height = 64;
+        SyntheticDepth synthetic( width, height, 1.0f, 1 );
+        DepthEncoder encoder( width, height, 4 );
+        std::vector<std::vector<uint8_t>> encoded( 8 );
+        std::vector<std::vector<uint16_t>> frames;
+        for( size_t frame = 0; frame < encoded.size(); frame++ ){
+            frames.push_back( synthetic.generate( static_cast<int>( frame ) ) );
+            encoder.encode( &frames[frame][0], encoded[frame] );
+        }
+
+        const int iterations = Test::iterations( argc, argv, 3000 );
+        std::vector<uint16_t> decoded( width * height + 1 );
+        const uint16_t guard = 0xa5a5;
+        int rejected = 0;
+        for( int iteration = 0; iteration < iterations; iteration++ ){
+            DepthDecoder decoder;
+            const size_t target = iteration % encoded.size();
+            for( size_t frame = target - target % 4; frame <= target; frame++ ){
+                std::vector<uint8_t> data = encoded[frame];
+                if( frame == target ){
+                    switch( iteration % 3 ){
+                    case 0: // Flip Bits
+                        for( int flip = 0; flip < 1 + iteration % 4; flip++ ){
+                            data[random() % data.size()] ^= static_cast<uint8_t>( 1 << ( random() % 8 ) );
+                        }
+                        break;
+                    case 1: // Random Bytes after Header
+                        for( size_t index = sizeof( DepthCodecHeader ) + random() % ( data.size() - sizeof( DepthCodecHeader ) ); index < data.size(); index += 1 + random() % 64 ){
+                            data[index] = static_cast<uint8_t>( random() );
+                        }
+                        break;
+                    default: // Truncate
+                        data.resize( random() % data.size() );
+                        break;
+                    }
+                }
+
+                // Frame Size is Checked by Caller before Decoding into Buffer ( as RecordDepthDecoder )
+                DepthCodecHeader header;
+                if( DepthDecoder::readHeader( data.empty() ? nullptr : &data[0], data.size(), header ) && ( header.width != width || header.height != height ) ){
+                    rejected++;
+                    break;
+                }
+
+                decoded[width * height] = guard;
+                try{
+                    decoder.decode( data.empty() ? nullptr : &data[0], data.size(), &decoded[0] );
+                } catch( std::runtime_error& ){
+                    rejected++;
+                    break;
+                }
+                CHECK( decoded[width * height] == guard );
+            }
+
+            // Next Key Frame Decodes Correctly after Corrupted Frame
+            const size_t key = ( target / 4 + 1 ) % ( encoded.size() / 4 ) * 4;
+            decoder.decode( &encoded[key][0], encoded[key].size(), &decoded[0] );
+            CHECK( std::equal( frames[key].begin(), frames[key].end(), decoded.begin() ) );
+        }
+        CHECK( rejected > iterations / 2 );
+        std::cout << "Fuzz : " << rejected << " / " << iterations << " corrupted frames rejected" << std::endl;
+    }
+
+    return Test::result( "Depth Codec Test" );
+}
\ No newline at end of file
@@ -0,0 +1,352 @@
+#include "Test.h"
+#include "Record.h"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <string>
+#include <iomanip>
+
+// Each Code Path of JointFilterBank ( JointFilterBank.h is Included in Namespace with AVX2 Disabled )
+#include "simd.h"
+#include "JointFilterBank.h"
+
+namespace Scalar
+{
+#undef __JOINT_FILTER_BANK__
+#define IsSupportedAVX2() false
+#include "JointFilterBank.h"
+#undef IsSupportedAVX2
+}
+
+// Joint ( Same Members as Joint of Kinect SDK )
+struct CameraSpacePoint
+{
+    float X;
+    float Y;
+    float Z;
+};
+
+struct Joint
+{
+    int JointType;
+    CameraSpacePoint Position;
+    int TrackingState;
+};
+
+const int bodyCount = JointFilterBank::bodyCount;
+const int jointCount = JointFilterBank::jointCount;
+const int TrackingState_Inferred = JointFilterBank::inferredState;
+
+// Body Frame ( Joints of Tracked Bodies, Tracking ID 0 is not Tracked )
+struct BodyFrame
+{
+    std::array<uint64_t, bodyCount> trackingIds;
+    std::array<std::array<Joint, jointCount>, bodyCount> joints;
+};
+
+// Legacy Filter
+// FilterDoubleExponential of KinectJointFilter ( Copyright (C) Microsoft Corporation ) that JointSmooth used before JointFilterBank.
+// Update( Joint[], UINT, TRANSFORM_SMOOTH_PARAMETERS ) is kept operation by operation, DirectXMath is replaced by scalar functions of same math.
+namespace Legacy
+{
+    struct XMVECTOR
+    {
+        float x, y, z, w;
+    };
+
+    inline XMVECTOR XMVectorSet( const float x, const float y, const float z, const float w ){ XMVECTOR v = { x, y, z, w }; return v; }
+    inline XMVECTOR XMVectorZero(){ return XMVectorSet( 0.0f, 0.0f, 0.0f, 0.0f ); }
+    inline XMVECTOR XMVectorAdd( const XMVECTOR a, const XMVECTOR b ){ return XMVectorSet( a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w ); }
+    inline XMVECTOR XMVectorSubtract( const XMVECTOR a, const XMVECTOR b ){ return XMVectorSet( a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w ); }
+    inline XMVECTOR XMVectorScale( const XMVECTOR a, const float s ){ return XMVectorSet( a.x * s, a.y * s, a.z * s, a.w * s ); }
+    inline XMVECTOR XMVector3Length( const XMVECTOR a ){ const float l = std::sqrt( a.x * a.x + a.y * a.y + a.z * a.z ); return XMVectorSet( l, l, l, l ); }
+    inline float XMVectorGetX( const XMVECTOR a ){ return a.x; }
+
+    struct TRANSFORM_SMOOTH_PARAMETERS
+    {
+        float fSmoothing;
+        float fCorrection;
+        float fPrediction;
+        float fJitterRadius;
+        float fMaxDeviationRadius;
+    };
+
+    struct FilterDoubleExponentialData
+    {
+        XMVECTOR m_vRawPosition;
+        XMVECTOR m_vFilteredPosition;
+        XMVECTOR m_vTrend;
+        uint32_t m_dwFrameCount;
+    };
+
+    class FilterDoubleExponential
+    {
+    public:
+        XMVECTOR m_pFilteredJoints[jointCount];
+        FilterDoubleExponentialData m_pHistory[jointCount];
+        float m_fSmoothing;
+        float m_fCorrection;
+        float m_fPrediction;
+        float m_fJitterRadius;
+        float m_fMaxDeviationRadius;
+
+        FilterDoubleExponential()
+        {
+            Reset();
+        }
+
+        void Reset( const float fSmoothing = 0.25f, const float fCorrection = 0.25f, const float fPrediction = 0.25f, const float fJitterRadius = 0.03f, const float fMaxDeviationRadius = 0.05f )
+        {
+            m_fMaxDeviationRadius = fMaxDeviationRadius;
+            m_fSmoothing = fSmoothing;
+            m_fCorrection = fCorrection;
+            m_fPrediction = fPrediction;
+            m_fJitterRadius = fJitterRadius;
+
+            std::memset( m_pFilteredJoints, 0, sizeof( m_pFilteredJoints ) );
+            std::memset( m_pHistory, 0, sizeof( m_pHistory ) );
+        }
+
+        void Update( Joint joints[] )
+        {
+            // Check for divide by zero. Use an epsilon of a 10th of a millimeter
+            m_fJitterRadius = std::max( 0.0001f, m_fJitterRadius );
+
+            TRANSFORM_SMOOTH_PARAMETERS SmoothingParams;
+            for( int i = 0; i < jointCount; i++ ){
+                SmoothingParams.fSmoothing = m_fSmoothing;
+                SmoothingParams.fCorrection = m_fCorrection;
+                SmoothingParams.fPrediction = m_fPrediction;
+                SmoothingParams.fJitterRadius = m_fJitterRadius;
+                SmoothingParams.fMaxDeviationRadius = m_fMaxDeviationRadius;
+
+                // If inferred, we smooth a bit more by using a bigger jitter radius
+                const Joint joint = joints[i];
+                if( joint.TrackingState == TrackingState_Inferred ){
+                    SmoothingParams.fJitterRadius *= 2.0f;
+                    SmoothingParams.fMaxDeviationRadius *= 2.0f;
+                }
+
+                Update( joints, i, SmoothingParams );
+            }
+        }
+
+        void Update( Joint joints[], const unsigned int JointID, const TRANSFORM_SMOOTH_PARAMETERS smoothingParams )
+        {
+            XMVECTOR vFilteredPosition;
+            XMVECTOR vTrend;
+            XMVECTOR vDiff;
+            float fDiff;
+
+            const Joint joint = joints[JointID];
+            const XMVECTOR vRawPosition = XMVectorSet( joint.Position.X, joint.Position.Y, joint.Position.Z, 0.0f );
+            const XMVECTOR vPrevFilteredPosition = m_pHistory[JointID].m_vFilteredPosition;
+            const XMVECTOR vPrevTrend = m_pHistory[JointID].m_vTrend;
+            const XMVECTOR vPrevRawPosition = m_pHistory[JointID].m_vRawPosition;
+            const bool bJointIsValid = vRawPosition.x != 0.0f || vRawPosition.y != 0.0f || vRawPosition.z != 0.0f;
+
+            // If joint is invalid, reset the filter
+            if( !bJointIsValid ){
+                m_pHistory[JointID].m_dwFrameCount = 0;
+            }
+
+            // Initial start values
+            if( m_pHistory[JointID].m_dwFrameCount == 0 ){
+                vFilteredPosition = vRawPosition;
+                vTrend = XMVectorZero();
+                m_pHistory[JointID].m_dwFrameCount++;
+            }
+            else if( m_pHistory[JointID].m_dwFrameCount == 1 ){
+                vFilteredPosition = XMVectorScale( XMVectorAdd( vRawPosition, vPrevRawPosition ), 0.5f );
+                vDiff = XMVectorSubtract( vFilteredPosition, vPrevFilteredPosition );
+                vTrend = XMVectorAdd( XMVectorScale( vDiff, smoothingParams.fCorrection ), XMVectorScale( vPrevTrend, 1.0f - smoothingParams.fCorrection ) );
+                m_pHistory[JointID].m_dwFrameCount++;
+            }
+            else{
+                // First apply jitter filter
+                vDiff = XMVectorSubtract( vRawPosition, vPrevFilteredPosition );
+                fDiff = std::fabs( XMVectorGetX( XMVector3Length( vDiff ) ) );
+
+                if( fDiff <= smoothingParams.fJitterRadius ){
+                    vFilteredPosition = XMVectorAdd( XMVectorScale( vRawPosition, fDiff / smoothingParams.fJitterRadius ),
+                                                     XMVectorScale( vPrevFilteredPosition, 1.0f - fDiff / smoothingParams.fJitterRadius ) );
+                }
+                else{
+                    vFilteredPosition = vRawPosition;
+                }
+
+                // Now the double exponential smoothing filter
+                vFilteredPosition = XMVectorAdd( XMVectorScale( vFilteredPosition, 1.0f - smoothingParams.fSmoothing ),
+                                                 XMVectorScale( XMVectorAdd( vPrevFilteredPosition, vPrevTrend ), smoothingParams.fSmoothing ) );
+
+                vDiff = XMVectorSubtract( vFilteredPosition, vPrevFilteredPosition );
+                vTrend = XMVectorAdd( XMVectorScale( vDiff, smoothingParams.fCorrection ), XMVectorScale( vPrevTrend, 1.0f - smoothingParams.fCorrection ) );
+            }
+
+            // Predict into the future to reduce latency
+            XMVECTOR vPredictedPosition = XMVectorAdd( vFilteredPosition, XMVectorScale( vTrend, smoothingParams.fPrediction ) );
+
+            // Check that we are not too far away from raw data
+            vDiff = XMVectorSubtract( vPredictedPosition, vRawPosition );
+            fDiff = std::fabs( XMVectorGetX( XMVector3Length( vDiff ) ) );
+
+            if( fDiff > smoothingParams.fMaxDeviationRadius ){
+                vPredictedPosition = XMVectorAdd( XMVectorScale( vPredictedPosition, smoothingParams.fMaxDeviationRadius / fDiff ),
+                                                  XMVectorScale( vRawPosition, 1.0f - smoothingParams.fMaxDeviationRadius / fDiff ) );
+            }
+
+            // Save the data from this frame
+            m_pHistory[JointID].m_vRawPosition = vRawPosition;
+            m_pHistory[JointID].m_vFilteredPosition = vFilteredPosition;
+            m_pHistory[JointID].m_vTrend = vTrend;
+
+            // Output the data
+            m_pFilteredJoints[JointID] = vPredictedPosition;
+            m_pFilteredJoints[JointID].w = 1.0f;
+        }
+    };
+}
+
+// Generate Synthetic Joint Stream
+// Bodies enter and leave ( Tracking ID Changes ), joints move with noise, sudden jumps, inferred and invalid ( 0, 0, 0 ) joints.
+std::vector<BodyFrame> generateStream( const int count )
+{
+    std::mt19937 random( 0 );
+    std::uniform_real_distribution<float> noise( -0.005f, 0.005f );
+    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+
+    std::vector<BodyFrame> frames( count );
+    uint64_t nextId = 1;
+    std::array<uint64_t, bodyCount> ids = {};
+    for( int frame = 0; frame < count; frame++ ){
+        for( int body = 0; body < bodyCount; body++ ){
+            // Body Enters or Leaves
+            if( uniform( random ) < 0.01f ){
+                ids[body] = ( ids[body] == 0 ) ? nextId++ : 0;
+            }
+            frames[frame].trackingIds[body] = ids[body];
+
+            for( int joint = 0; joint < jointCount; joint++ ){
+                Joint& value = frames[frame].joints[body][joint];
+                value.JointType = joint;
+                const float phase = frame * 0.05f + joint * 0.3f + body;
+                const float jump = ( uniform( random ) < 0.01f ) ? 0.2f : 0.0f;
+                value.Position.X = body * 0.8f - 2.0f + 0.3f * std::sin( phase ) + noise( random ) + jump;
+                value.Position.Y = joint * 0.05f - 0.6f + 0.1f * std::cos( phase * 1.3f ) + noise( random );
+                value.Position.Z = 2.5f + 0.2f * std::sin( phase * 0.7f ) + noise( random );
+                value.TrackingState = ( uniform( random ) < 0.1f ) ? TrackingState_Inferred : 2;
+                if( uniform( random ) < 0.02f ){
+                    value.Position.X = value.Position.Y = value.Position.Z = 0.0f;
+                    value.TrackingState = 0;
+                }
+            }
+        }
+    }
+    return frames;
+}
+
+// Read Joint Stream of Recording ( Body Frames Recorded by MultiSource Sample )
+std::vector<BodyFrame> readStream( const std::string& path )
+{
+    RecordReader reader;
+    reader.open( path );
+
+    std::vector<BodyFrame> frames;
+    for( size_t i = 0; i < reader.count( RecordStream_Body ); i++ ){
+        const RecordFrame record = reader.frame( RecordStream_Body, i );
+        if( !record.valid() || record.header->format != RecordFormat_Body ){
+            continue;
+        }
+
+        BodyFrame frame = {};
+        const RecordBody* bodies = record.ptr<RecordBody>();
+        for( int body = 0; body < std::min<int>( record.width(), bodyCount ); body++ ){
+            frame.trackingIds[body] = bodies[body].tracked ? bodies[body].trackingId : 0;
+            for( int joint = 0; joint < jointCount; joint++ ){
+                const RecordJoint& source = bodies[body].joints[joint];
+                frame.joints[body][joint] = { source.type, { source.x, source.y, source.z }, source.trackingState };
+            }
+        }
+        frames.push_back( frame );
+    }
+    return frames;
+}
+
+// Filter Stream with Filter Bank and Legacy Filter per Body ( Reset when Tracking ID Changed ), Returns Maximum Difference [m]
+template<typename FilterBank>
+double compare( const std::vector<BodyFrame>& frames )
+{
+    FilterBank bank;
+    std::array<Legacy::FilterDoubleExponential, bodyCount> legacy;
+    std::array<uint64_t, bodyCount> ids = {};
+
+    double maximum = 0.0;
+    for( const BodyFrame& frame : frames ){
+        for( int body = 0; body < bodyCount; body++ ){
+            if( frame.trackingIds[body] == 0 ){
+                ids[body] = 0;
+                continue;
+            }
+
+            if( frame.trackingIds[body] != ids[body] ){
+                legacy[body].Reset();
+                ids[body] = frame.trackingIds[body];
+            }
+
+            bank.setJoints( body, frame.trackingIds[body], &frame.joints[body][0] );
+            std::array<Joint, jointCount> joints = frame.joints[body];
+            legacy[body].Update( &joints[0] );
+        }
+        bank.update();
+
+        for( int body = 0; body < bodyCount; body++ ){
+            if( frame.trackingIds[body] == 0 ){
+                continue;
+            }
+
+            std::array<Joint, jointCount> joints = frame.joints[body];
+            bank.getJoints( body, &joints[0] );
+            for( int joint = 0; joint < jointCount; joint++ ){
+                const Legacy::XMVECTOR& expected = legacy[body].m_pFilteredJoints[joint];
+                maximum = std::max( maximum, static_cast<double>( std::fabs( joints[joint].Position.X - expected.x ) ) );
+                maximum = std::max( maximum, static_cast<double>( std::fabs( joints[joint].Position.Y - expected.y ) ) );
+                maximum = std::max( maximum, static_cast<double>( std::fabs( joints[joint].Position.Z - expected.z ) ) );
+            }
+        }
+    }
+    return maximum;
+}
+
+// Joint Filter Test ( Usage : JointFilterTest [recording.k2rec] )
+// Filter bank is compared with the legacy filter on synthetic joint stream, and on body frames of recording if given.
+int main( int argc, char* argv[] )
+{
+    // Epsilon ( Operation Order is Same, AVX2 Path may Fuse Multiply-Add )
+    const double epsilon = 1e-5;
+
+    std::vector<std::pair<std::string, std::vector<BodyFrame>>> streams;
+    streams.push_back( std::make_pair( std::string( "Synthetic" ), generateStream( 3000 ) ) );
+    if( argc > 1 ){
+        streams.push_back( std::make_pair( std::string( argv[1] ), readStream( argv[1] ) ) );
+        CHECK( !streams.back().second.empty() );
+    }
+
+    std::cout << std::scientific << std::setprecision( 2 );
+    for( const auto& stream : streams ){
+        if( IsSupportedAVX2() ){
+            const double difference = compare<JointFilterBank>( stream.second );
+            CHECK( difference <= epsilon );
+            std::cout << stream.first << " ( AVX2 ) : max difference " << difference << " m" << std::endl;
+        }
+
+        const double difference = compare<Scalar::JointFilterBank>( stream.second );
+        CHECK( difference <= epsilon );
+        std::cout << stream.first << " ( Scalar ) : max difference " << difference << " m" << std::endl;
+    }
+
+    return Test::result( "Joint Filter Test" );
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "Test.h"
+#include "MeshWriter.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <iomanip>
+#include <thread>
+
+// Legacy Writer ( WriteAsciiPlyMeshFile of KinectFusionHelper with Flip Y and Z and Color, sprintf_s is Replaced by snprintf )
+namespace Legacy
+{
+    void WriteAsciiPlyMeshFile( const std::string& fileName, const float* vertices, const uint32_t* colors, const unsigned int numVertices )
+    {
+        const unsigned int numTriangles = numVertices / 3;
+        FILE* meshFile = fopen( fileName.c_str(), "wt" );
+        if( meshFile == nullptr ){
+            throw std::runtime_error( "failed to open mesh file ( " + fileName + " )" );
+        }
+
+        // Write the header line
+        std::string header = "ply\nformat ascii 1.0\ncomment file created by Microsoft Kinect Fusion\n";
+        fwrite( header.c_str(), sizeof( char ), header.length(), meshFile );
+
+        const unsigned int bufSize = 260 * 3;
+        char outStr[bufSize];
+        int written = snprintf( outStr, bufSize, "element vertex %u\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\n", numVertices );
+        fwrite( outStr, sizeof( char ), written, meshFile );
+        written = snprintf( outStr, bufSize, "element face %u\nproperty list uchar int vertex_index\nend_header\n", numTriangles );
+        fwrite( outStr, sizeof( char ), written, meshFile );
+
+        // Sequentially write the 3 vertices of the triangle, for each triangle
+        for( unsigned int t = 0, vertexIndex = 0; t < numTriangles; ++t, vertexIndex += 3 ){
+            const float* v = &vertices[vertexIndex * 3];
+            const unsigned int color0 = colors[vertexIndex];
+            const unsigned int color1 = colors[vertexIndex + 1];
+            const unsigned int color2 = colors[vertexIndex + 2];
+            written = snprintf( outStr, bufSize, "%f %f %f %u %u %u\n%f %f %f %u %u %u\n%f %f %f %u %u %u\n",
+                v[0], -v[1], -v[2], ( ( color0 >> 16 ) & 255 ), ( ( color0 >> 8 ) & 255 ), ( color0 & 255 ),
+                v[3], -v[4], -v[5], ( ( color1 >> 16 ) & 255 ), ( ( color1 >> 8 ) & 255 ), ( color1 & 255 ),
+                v[6], -v[7], -v[8], ( ( color2 >> 16 ) & 255 ), ( ( color2 >> 8 ) & 255 ), ( color2 & 255 ) );
+            fwrite( outStr, sizeof( char ), written, meshFile );
+        }
+
+        // Sequentially write the 3 vertex indices of the triangle face, for each triangle
+        for( unsigned int t = 0, baseIndex = 0; t < numTriangles; ++t, baseIndex += 3 ){
+            written = snprintf( outStr, bufSize, "3 %u %u %u\n", baseIndex, baseIndex + 1, baseIndex + 2 );
+            fwrite( outStr, sizeof( char ), written, meshFile );
+        }
+
+        fflush( meshFile );
+        fclose( meshFile );
+    }
+}
+
+// Synthetic Triangle Soup ( Height Field of grid x grid Quads, 3 Vertices per Triangle as INuiFusionColorMesh )
+// Degenerate triangles are appended at end, that have to be dropped by welding.
+void generateSoup( const int grid, std::vector<float>& vertices, std::vector<uint32_t>& colors )
+{
+    auto point = [&]( const int x, const int y, std::vector<float>& out ){
+        const float u = static_cast<float>( x ) / grid;
+        const float v = static_cast<float>( y ) / grid;
+        out.push_back( u * 2.0f - 1.0f );
+        out.push_back( v * 2.0f - 1.0f );
+        out.push_back( 1.5f + 0.1f * std::sin( u * 17.0f ) * std::cos( v * 13.0f ) );
+    };
+    auto color = [&]( const int x, const int y ){
+        return 0xff000000u | ( static_cast<uint32_t>( x & 255 ) << 16 ) | ( static_cast<uint32_t>( y & 255 ) << 8 ) | static_cast<uint32_t>( ( x + y ) & 255 );
+    };
+
+    vertices.clear();
+    colors.clear();
+    vertices.reserve( static_cast<size_t>( grid ) * grid * 18 + 18 );
+    colors.reserve( static_cast<size_t>( grid ) * grid * 6 + 6 );
+    const int corners[6][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 0 }, { 1, 1 }, { 0, 1 } };
+    for( int y = 0; y < grid; y++ ){
+        for( int x = 0; x < grid; x++ ){
+            for( const auto& corner : corners ){
+                point( x + corner[0], y + corner[1], vertices );
+                colors.push_back( color( x + corner[0], y + corner[1] ) );
+            }
+        }
+    }
+
+    const int degenerate[6][2] = { { 0, 0 }, { 0, 0 }, { 1, 0 }, { 2, 2 }, { 3, 3 }, { 2, 2 } };
+    for( const auto& corner : degenerate ){
+        point( corner[0], corner[1], vertices );
+        colors.push_back( color( corner[0], corner[1] ) );
+    }
+}
+
+// Measure Time of Function [ms] ( Single Call, File Writes are Not Repeated )
+template<typename Function>
+double measureOnce( Function function )
+{
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+// Read Whole File
+std::string readFile( const std::string& fileName )
+{
+    std::ifstream file( fileName, std::ios::binary );
+    return std::string( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+}
+
+// Check Welded Mesh Reproduces Soup ( Bit-exact Positions and Colors, Degenerate Triangles are Dropped )
+void checkWeld( const int grid, const std::vector<float>& vertices, const std::vector<uint32_t>& colors, const IndexedMesh& mesh )
+{
+    const size_t triangleCount = static_cast<size_t>( grid ) * grid * 2;
+    CHECK( mesh.vertexCount() == static_cast<size_t>( grid + 1 ) * ( grid + 1 ) );
+    CHECK( mesh.triangleCount() == triangleCount );
+    CHECK( mesh.colors.size() == mesh.vertexCount() );
+
+    size_t mismatches = 0;
+    for( size_t t = 0; t < std::min( triangleCount, mesh.triangleCount() ); t++ ){
+        for( int corner = 0; corner < 3; corner++ ){
+            const size_t soupIndex = t * 3 + corner;
+            const uint32_t index = mesh.indices[soupIndex];
+            mismatches += ( index >= mesh.vertexCount() || std::memcmp( &mesh.vertices[index * 3], &vertices[soupIndex * 3], 3 * sizeof( float ) ) != 0 || mesh.colors[index] != colors[soupIndex] ) ? 1 : 0;
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+// Check Binary PLY Reads Back to Mesh ( Y and Z are Flipped )
+void checkPly( const std::string& fileName, const IndexedMesh& mesh )
+{
+    const std::string data = readFile( fileName );
+    std::ostringstream header;
+    header << "ply\nformat binary_little_endian 1.0\nelement vertex " << mesh.vertexCount()
+           << "\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\nelement face " << mesh.triangleCount()
+           << "\nproperty list uchar int vertex_index\nend_header\n";
+    const size_t headerSize = header.str().size();
+    CHECK( data.compare( 0, headerSize, header.str() ) == 0 );
+    CHECK( data.size() == headerSize + mesh.vertexCount() * 15 + mesh.triangleCount() * 13 );
+    if( data.size() != headerSize + mesh.vertexCount() * 15 + mesh.triangleCount() * 13 ){
+        return;
+    }
+
+    size_t mismatches = 0;
+    const char* vertex = &data[headerSize];
+    for( size_t i = 0; i < mesh.vertexCount(); i++, vertex += 15 ){
+        float position[3];
+        std::memcpy( position, vertex, sizeof( position ) );
+        const uint32_t color = mesh.colors[i];
+        const uint8_t* rgb = reinterpret_cast<const uint8_t*>( vertex + 12 );
+        mismatches += ( position[0] != mesh.vertices[i * 3] || position[1] != -mesh.vertices[i * 3 + 1] || position[2] != -mesh.vertices[i * 3 + 2] ) ? 1 : 0;
+        mismatches += ( rgb[0] != ( ( color >> 16 ) & 255 ) || rgb[1] != ( ( color >> 8 ) & 255 ) || rgb[2] != ( color & 255 ) ) ? 1 : 0;
+    }
+    const char* face = vertex;
+    for( size_t t = 0; t < mesh.triangleCount(); t++, face += 13 ){
+        int32_t indices[3];
+        std::memcpy( indices, face + 1, sizeof( indices ) );
+        mismatches += ( face[0] != 3 || std::memcmp( indices, &mesh.indices[t * 3], sizeof( indices ) ) != 0 ) ? 1 : 0;
+    }
+    CHECK( mismatches == 0 );
+}
+
+// Check OBJ is Same as printf( "%f" ) ( Includes Rounding Ties like 2^-7 = 0.0078125 and Negative Zero after Flip )
+void checkObj()
+{
+    IndexedMesh mesh;
+    const float values[] = { 0.0078125f, -0.0078125f, 0.0234375f, 1.0000005f, 0.0f, 123456.789f, -3.9999995f, 1.0e-7f, 2.5e-6f, 0.5f };
+    for( const float x : values ){
+        for( const float y : values ){
+            mesh.vertices.insert( mesh.vertices.end(), { x, y, -x * 3.0f } );
+        }
+    }
+    const size_t vertexCount = mesh.vertexCount();
+    for( uint32_t i = 0; i + 2 < vertexCount; i++ ){
+        mesh.indices.insert( mesh.indices.end(), { i, i + 1, i + 2 } );
+    }
+
+    std::string expected = "# " + std::to_string( vertexCount ) + " vertices, " + std::to_string( mesh.triangleCount() ) + " triangles\n";
+    char line[512];
+    for( size_t i = 0; i < vertexCount; i++ ){
+        snprintf( line, sizeof( line ), "v %f %f %f\n", mesh.vertices[i * 3], -mesh.vertices[i * 3 + 1], -mesh.vertices[i * 3 + 2] );
+        expected += line;
+    }
+    for( size_t t = 0; t < mesh.triangleCount(); t++ ){
+        snprintf( line, sizeof( line ), "f %u %u %u\n", mesh.indices[t * 3] + 1, mesh.indices[t * 3 + 1] + 1, mesh.indices[t * 3 + 2] + 1 );
+        expected += line;
+    }
+
+    const std::string fileName = "MeshWriterBenchmarkTies.obj";
+    WriteObjMesh( fileName, mesh );
+    CHECK( readFile( fileName ) == expected );
+    std::remove( fileName.c_str() );
+}
+
+// Mesh Writer Benchmark ( Usage : MeshWriterBenchmark [grid] )
+// Writes synthetic mesh of 2 x grid x grid triangles with legacy ASCII PLY writer of KinectFusionHelper and with MeshWriter.
+// Files are written to working directory and removed at end.
+int main( int argc, char* argv[] )
+{
+    const int grid = Test::iterations( argc, argv, 1200 );
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> colors;
+    generateSoup( grid, vertices, colors );
+    const size_t soupCount = colors.size();
+    std::cout << "Mesh : " << soupCount / 3 << " triangles ( soup ), " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision( 1 );
+
+    struct Output
+    {
+        std::string name;
+        std::string fileName;
+        double time;
+    };
+    std::vector<Output> outputs;
+
+    // Legacy ASCII PLY ( Triangle Soup )
+    outputs.push_back( { "ascii ply, sprintf + fwrite per triangle", "MeshWriterBenchmarkLegacy.ply", 0.0 } );
+    outputs.back().time = measureOnce( [&](){ Legacy::WriteAsciiPlyMeshFile( outputs.back().fileName, &vertices[0], &colors[0], static_cast<unsigned int>( soupCount ) ); } );
+
+    // Weld
+    IndexedMesh mesh;
+    const double weldTime = measureOnce( [&](){ WeldMesh( &vertices[0], &colors[0], soupCount, mesh ); } );
+    std::cout << "weld : " << weldTime << " ms, " << mesh.vertexCount() << " vertices, " << mesh.triangleCount() << " triangles" << std::endl;
+    checkWeld( grid, vertices, colors, mesh );
+
+    // MeshWriter
+    outputs.push_back( { "binary ply", "MeshWriterBenchmark.ply", 0.0 } );
+    outputs.back().time = measureOnce( [&](){ WritePlyMesh( outputs.back().fileName, mesh ); } );
+    outputs.push_back( { "binary stl", "MeshWriterBenchmark.stl", 0.0 } );
+    outputs.back().time = measureOnce( [&](){ WriteStlMesh( outputs.back().fileName, mesh ); } );
+    outputs.push_back( { "obj", "MeshWriterBenchmark.obj", 0.0 } );
+    outputs.back().time = measureOnce( [&](){ WriteObjMesh( outputs.back().fileName, mesh ); } );
+
+    for( const Output& output : outputs ){
+        std::ifstream file( output.fileName, std::ios::binary | std::ios::ate );
+        const double size = static_cast<double>( file.tellg() ) / ( 1024.0 * 1024.0 );
+        std::cout << output.name << " : " << output.time << " ms, " << size << " MB" << std::endl;
+    }
+
+    // Checks
+    checkPly( "MeshWriterBenchmark.ply", mesh );
+    std::ifstream stl( "MeshWriterBenchmark.stl", std::ios::binary | std::ios::ate );
+    CHECK( static_cast<size_t>( stl.tellg() ) == 84 + mesh.triangleCount() * 50 );
+    checkObj();
+
+    for( const Output& output : outputs ){
+        std::remove( output.fileName.c_str() );
+    }
+
+    return Test::result( "Mesh Writer Benchmark" );
+}
\ No newline at end of file
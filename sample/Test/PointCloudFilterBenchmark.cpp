@@ -0,0 +1,189 @@
+#include "Test.h"
+#include "PointCloudFilter.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <random>
+#include <iomanip>
+
+// Synthetic Cloud of Depth Frame ( Smooth Surface with Flying Pixels, All Pixels Valid )
+PointCloud generateCloud( const int width, const int height, const float flying )
+{
+    PointCloud cloud;
+    cloud.allocate( width, height );
+    std::mt19937 random( 1 );
+    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+    for( int v = 0; v < height; v++ ){
+        for( int u = 0; u < width; u++ ){
+            float z = 1.5f + 0.5f * std::sin( u * 0.01f ) + 0.3f * std::cos( v * 0.013f );
+            if( uniform( random ) < flying ){
+                z += ( uniform( random ) - 0.5f ) * 2.0f;
+            }
+            const size_t i = cloud.size++;
+            cloud.x[i] = ( u - width / 2 ) / 365.5f * z;
+            cloud.y[i] = ( height / 2 - v ) / 365.5f * z;
+            cloud.z[i] = z;
+            cloud.color[i] = static_cast<uint32_t>( random() );
+            cloud.indices[i] = static_cast<uint32_t>( v * width + u );
+        }
+    }
+    return cloud;
+}
+
+// Check Clouds are Same Point by Point
+bool same( const PointCloud& a, const PointCloud& b )
+{
+    if( a.size != b.size ){
+        return false;
+    }
+    for( size_t i = 0; i < a.size; i++ ){
+        if( a.x[i] != b.x[i] || a.y[i] != b.y[i] || a.z[i] != b.z[i] || a.color[i] != b.color[i] || a.indices[i] != b.indices[i] ){
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check Voxel Grid against Brute Force ( One Point per Voxel Ordered by First Point, Centroid of Points in Voxel )
+void checkVoxelGrid( PointCloudFilter& filter, const PointCloud& input, const float leafSize )
+{
+    typedef std::tuple<int, int, int> Voxel;
+    std::map<Voxel, std::vector<size_t>> voxels;
+    std::vector<Voxel> order;
+    for( size_t i = 0; i < input.size; i++ ){
+        const Voxel voxel( static_cast<int>( std::floor( input.x[i] * ( 1.0f / leafSize ) ) ), static_cast<int>( std::floor( input.y[i] * ( 1.0f / leafSize ) ) ), static_cast<int>( std::floor( input.z[i] * ( 1.0f / leafSize ) ) ) );
+        std::vector<size_t>& points = voxels[voxel];
+        if( points.empty() ){
+            order.push_back( voxel );
+        }
+        points.push_back( i );
+    }
+
+    PointCloud first;
+    PointCloud centroid;
+    filter.voxelGrid( input, leafSize, VoxelGridMode_First, first );
+    filter.voxelGrid( input, leafSize, VoxelGridMode_Centroid, centroid );
+    CHECK( first.size == order.size() );
+    CHECK( centroid.size == order.size() );
+
+    size_t mismatches = 0;
+    for( size_t cell = 0; cell < std::min( order.size(), centroid.size ); cell++ ){
+        const std::vector<size_t>& points = voxels[order[cell]];
+        double x = 0.0, y = 0.0, z = 0.0;
+        for( const size_t i : points ){
+            x += input.x[i];
+            y += input.y[i];
+            z += input.z[i];
+        }
+        const double tolerance = 1e-5;
+        const size_t i = points.front();
+        const bool firstSame = first.x[cell] == input.x[i] && first.y[cell] == input.y[i] && first.z[cell] == input.z[i] && first.indices[cell] == input.indices[i];
+        const bool centroidSame = std::fabs( centroid.x[cell] - x / points.size() ) < tolerance && std::fabs( centroid.y[cell] - y / points.size() ) < tolerance
+                               && std::fabs( centroid.z[cell] - z / points.size() ) < tolerance && centroid.indices[cell] == input.indices[i];
+        mismatches += ( firstSame && centroidSame ) ? 0 : 1;
+    }
+    CHECK( mismatches == 0 );
+}
+
+// Check Radius Outlier Filter against Brute Force ( Same Points Kept in Same Order )
+void checkRadiusOutlier( PointCloudFilter& filter, const PointCloud& input, const float radius, const int minNeighbors )
+{
+    std::vector<uint32_t> expected;
+    for( size_t i = 0; i < input.size; i++ ){
+        int neighbors = 0;
+        for( size_t j = 0; j < input.size; j++ ){
+            const float ex = input.x[j] - input.x[i];
+            const float ey = input.y[j] - input.y[i];
+            const float ez = input.z[j] - input.z[i];
+            neighbors += ( j != i && ex * ex + ey * ey + ez * ez <= radius * radius ) ? 1 : 0;
+        }
+        if( neighbors >= minNeighbors ){
+            expected.push_back( input.indices[i] );
+        }
+    }
+
+    PointCloud output;
+    filter.radiusOutlier( input, radius, minNeighbors, output );
+    CHECK( output.size == expected.size() );
+    CHECK( output.size == expected.size() && std::equal( expected.begin(), expected.end(), output.indices.begin() ) );
+}
+
+// Point Cloud Filter Benchmark ( Usage : PointCloudFilterBenchmark [iterations] )
+// Filters synthetic 512 x 424 cloud with 2% flying pixels with filters of PointCloud sample, and reports throughput in points per second.
+// Filters are checked against brute force on small random clouds, and outputs have to be same in every run.
+int main( int argc, char* argv[] )
+{
+    const int iterations = Test::iterations( argc, argv, 20 );
+    PointCloudFilter filter;
+
+    // Brute Force Checks ( Random Cloud of Several Tiles, and Cloud without Frame Size )
+    {
+        std::mt19937 random( 3 );
+        std::uniform_real_distribution<float> uniform( -0.2f, 0.2f );
+        PointCloud cloud;
+        cloud.allocate( PointGrid::tileSize * 2 + 1000, 1 );
+        cloud.size = PointGrid::tileSize * 2 + 1000;
+        cloud.width = cloud.height = 0;
+        for( size_t i = 0; i < cloud.size; i++ ){
+            cloud.x[i] = uniform( random );
+            cloud.y[i] = uniform( random );
+            cloud.z[i] = uniform( random );
+            cloud.color[i] = static_cast<uint32_t>( i );
+            cloud.indices[i] = static_cast<uint32_t>( i );
+        }
+        checkVoxelGrid( filter, cloud, 0.05f );
+        checkVoxelGrid( filter, cloud, 0.013f );
+        checkRadiusOutlier( filter, cloud, 0.02f, 3 );
+        checkRadiusOutlier( filter, cloud, 0.01f, 1 );
+
+        PointCloud output;
+        filter.stride( cloud, 3, output );
+        CHECK( output.size == ( cloud.size + 8 ) / 9 );
+    }
+
+    // Synthetic Frame
+    const int width = 512;
+    const int height = 424;
+    const PointCloud cloud = generateCloud( width, height, 0.02f );
+    const double points = static_cast<double>( cloud.size );
+    std::cout << std::fixed << std::setprecision( 1 );
+
+    // Measure [ms per Frame] and [Mpts/s]
+    PointCloud centroid;
+    PointCloud first;
+    PointCloud strided;
+    PointCloud inliers;
+    PointCloud filtered;
+    const double centroidTime = Test::measure( iterations, [&](){ filter.voxelGrid( cloud, 0.01f, VoxelGridMode_Centroid, centroid ); } );
+    const double firstTime = Test::measure( iterations, [&](){ filter.voxelGrid( cloud, 0.01f, VoxelGridMode_First, first ); } );
+    const double strideTime = Test::measure( iterations, [&](){ filter.stride( cloud, 2, strided ); } );
+    const double radiusTime = Test::measure( iterations, [&](){ filter.radiusOutlier( cloud, 0.02f, 4, inliers ); } );
+    const double pipelineTime = Test::measure( iterations, [&](){
+        filter.voxelGrid( cloud, 0.01f, VoxelGridMode_Centroid, centroid );
+        filter.radiusOutlier( centroid, 0.02f, 4, filtered );
+    } );
+
+    std::cout << cloud.size << " points" << std::endl;
+    std::cout << "Voxel Grid 1 cm Centroid : " << centroidTime << " ms, " << points / centroidTime / 1000.0 << " Mpts/s -> " << centroid.size << " points" << std::endl;
+    std::cout << "Voxel Grid 1 cm First : " << firstTime << " ms, " << points / firstTime / 1000.0 << " Mpts/s -> " << first.size << " points" << std::endl;
+    std::cout << "Stride 2 : " << strideTime << " ms, " << points / strideTime / 1000.0 << " Mpts/s -> " << strided.size << " points" << std::endl;
+    std::cout << "Radius Outlier 2 cm / 4 : " << radiusTime << " ms, " << points / radiusTime / 1000.0 << " Mpts/s -> " << inliers.size << " points" << std::endl;
+    std::cout << "Viewer Pipeline ( Voxel Grid 1 cm, Radius Outlier 2 cm / 4 ) : " << pipelineTime << " ms -> " << filtered.size << " points" << std::endl;
+
+    CHECK( strided.size == static_cast<size_t>( ( width / 2 ) * ( height / 2 ) ) );
+    CHECK( first.size == centroid.size && centroid.size < cloud.size );
+    CHECK( inliers.size < cloud.size && inliers.size > cloud.size * 9 / 10 );
+
+    // Deterministic ( Same Output in Every Run )
+    PointCloud again;
+    filter.voxelGrid( cloud, 0.01f, VoxelGridMode_Centroid, again );
+    CHECK( same( again, centroid ) );
+    filter.radiusOutlier( centroid, 0.02f, 4, again );
+    CHECK( same( again, filtered ) );
+
+    return Test::result( "Point Cloud Filter Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "Test.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <random>
+
+// Each Code Path of PointCloudGenerator ( PointCloud.h is Included in Namespace with AVX2 Disabled )
+#include "simd.h"
+#include "PointCloud.h"
+
+namespace Scalar
+{
+#undef __POINT_CLOUD__
+#define IsSupportedAVX2() false
+#include "PointCloud.h"
+#undef IsSupportedAVX2
+}
+
+// Ray of Depth to Camera Space Table ( Same Members as PointF )
+struct Ray
+{
+    float X;
+    float Y;
+};
+
+// Check Points are Same Bit by Bit ( NaN of Invalid Pixels Included )
+bool same( const std::vector<float>& a, const std::vector<float>& b )
+{
+    return a.size() == b.size() && std::memcmp( &a[0], &b[0], a.size() * sizeof( float ) ) == 0;
+}
+
+// Point Cloud ( AVX2 and Scalar Organized and Compacted Point Clouds are Same, Pixels without Ray are Invalid )
+int main()
+{
+    // Frame Size is not Multiple of 8 to Cover Remainder Pixels
+    const int width = 517;
+    const int height = 13;
+    const int size = width * height;
+
+    // Ray Table with NaN and Infinite Rays ( Corners of Kinect v2 Table have no Ray )
+    std::mt19937 random( 0 );
+    std::uniform_real_distribution<float> uniform( -0.7f, 0.7f );
+    std::vector<Ray> table( size );
+    for( int index = 0; index < size; index++ ){
+        table[index].X = uniform( random );
+        table[index].Y = uniform( random );
+        if( random() % 5 == 0 ){
+            table[index].X = table[index].Y = std::numeric_limits<float>::quiet_NaN();
+        }
+        else if( random() % 50 == 0 ){
+            table[index].X = std::numeric_limits<float>::infinity();
+        }
+    }
+
+    // Depth with Invalid, Out of Range and Boundary Values
+    std::vector<uint16_t> depth( size );
+    const uint16_t boundaries[] = { 0, 499, 500, 7999, 8000, 65535 };
+    for( int index = 0; index < size; index++ ){
+        depth[index] = ( random() % 4 == 0 ) ? boundaries[random() % 6] : static_cast<uint16_t>( 500 + random() % 7500 );
+    }
+
+    PointCloudGenerator generator;
+    Scalar::PointCloudGenerator scalarGenerator;
+    CHECK( generator.initialize( width, height, &table[0] ) );
+    CHECK( scalarGenerator.initialize( width, height, &table[0] ) );
+
+    // Organized ( Invalid Pixels are NaN in All Coordinates )
+    std::vector<float> points( static_cast<size_t>( size ) * 3 );
+    std::vector<float> scalarPoints( points.size() );
+    generator.generateOrganized( &depth[0], &points[0] );
+    scalarGenerator.generateOrganized( &depth[0], &scalarPoints[0] );
+    CHECK( same( points, scalarPoints ) );
+
+    size_t valid = 0;
+    size_t mismatches = 0;
+    for( int index = 0; index < size; index++ ){
+        const bool expected = 500 <= depth[index] && depth[index] < 8000 && std::isfinite( table[index].X ) && std::isfinite( table[index].Y );
+        const float* point = &scalarPoints[static_cast<size_t>( index ) * 3];
+        const bool invalid = std::isnan( point[0] ) && std::isnan( point[1] ) && std::isnan( point[2] );
+        const bool finite = std::isfinite( point[0] ) && std::isfinite( point[1] ) && std::isfinite( point[2] );
+        mismatches += ( expected ? finite : invalid ) ? 0 : 1;
+        valid += expected ? 1 : 0;
+    }
+    CHECK( mismatches == 0 );
+
+    // Compacted ( Valid Pixels Only, in Pixel Order )
+    std::vector<uint32_t> color( size );
+    for( uint32_t& value : color ){
+        value = static_cast<uint32_t>( random() );
+    }
+    PointCloud cloud;
+    Scalar::PointCloud scalarCloud;
+    CHECK( generator.generateCompact( &depth[0], &color[0], cloud ) == valid );
+    CHECK( scalarGenerator.generateCompact( &depth[0], &color[0], scalarCloud ) == valid );
+    mismatches = 0;
+    for( size_t i = 0; i < valid; i++ ){
+        const uint32_t index = scalarCloud.indices[i];
+        const float* point = &points[static_cast<size_t>( index ) * 3];
+        mismatches += ( cloud.indices[i] == index && cloud.color[i] == color[index] && scalarCloud.color[i] == color[index]
+                        && cloud.x[i] == point[0] && cloud.y[i] == point[1] && cloud.z[i] == point[2]
+                        && scalarCloud.x[i] == point[0] && scalarCloud.y[i] == point[1] && scalarCloud.z[i] == point[2] ) ? 0 : 1;
+    }
+    CHECK( mismatches == 0 );
+
+    return Test::result( "Point Cloud" );
+}
\ No newline at end of file
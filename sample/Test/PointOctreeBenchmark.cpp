@@ -0,0 +1,219 @@
+#include "Test.h"
+#include "PointOctree.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <chrono>
+#include <iomanip>
+
+// Synthetic Frame of Moving Sensor ( 512 x 424 Surface with Noise, Shifted Frame by Frame )
+void generateFrame( const int frame, std::mt19937& random, PointCloud& cloud )
+{
+    const int width = 512;
+    const int height = 424;
+    cloud.allocate( width, height );
+    std::normal_distribution<float> noise( 0.0f, 0.003f );
+    const float offsetX = frame * 0.05f;
+    const float offsetZ = std::sin( frame * 0.1f ) * 0.5f;
+    for( int v = 0; v < height; v++ ){
+        for( int u = 0; u < width; u++ ){
+            const float z = 2.0f + 0.5f * std::sin( u * 0.01f + frame * 0.02f ) + 0.3f * std::cos( v * 0.013f );
+            const size_t i = cloud.size++;
+            cloud.x[i] = ( u - width / 2 ) / 365.5f * z + offsetX + noise( random );
+            cloud.y[i] = ( height / 2 - v ) / 365.5f * z + noise( random );
+            cloud.z[i] = z + offsetZ + noise( random );
+            cloud.color[i] = static_cast<uint32_t>( random() ) | 0xff000000;
+            cloud.indices[i] = static_cast<uint32_t>( v * width + u );
+        }
+    }
+}
+
+// Squared Distance of Points
+float squaredDistance( const OctreePoint& point, const float x, const float y, const float z )
+{
+    const float dx = point.x - x;
+    const float dy = point.y - y;
+    const float dz = point.z - z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Brute Force Radius Search ( Number of Points within Radius )
+size_t bruteRadius( const std::vector<OctreePoint>& points, const float x, const float y, const float z, const float radius )
+{
+    size_t count = 0;
+    for( const OctreePoint& point : points ){
+        count += ( squaredDistance( point, x, y, z ) <= radius * radius ) ? 1 : 0;
+    }
+    return count;
+}
+
+// Brute Force k-NN ( Ascending Squared Distances )
+std::vector<float> bruteNearest( const std::vector<OctreePoint>& points, const float x, const float y, const float z, const size_t k, std::vector<float>& distances )
+{
+    distances.clear();
+    for( const OctreePoint& point : points ){
+        distances.push_back( squaredDistance( point, x, y, z ) );
+    }
+    const size_t size = std::min( k, distances.size() );
+    std::partial_sort( distances.begin(), distances.begin() + size, distances.end() );
+    return std::vector<float>( distances.begin(), distances.begin() + size );
+}
+
+// Elapsed Time [ms]
+double elapsed( const std::chrono::steady_clock::time_point begin )
+{
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin ).count();
+}
+
+// Point Octree Benchmark ( Usage : PointOctreeBenchmark [frames] )
+// Accumulates synthetic frames of moving sensor into octree with 1 cm leaves, and measures insert, level of detail, radius and k-NN queries.
+// Queries are checked against and timed with brute force over all accumulated points, and incremental level of detail against rebuilt tree.
+int main( int argc, char* argv[] )
+{
+    const int frames = Test::iterations( argc, argv, 10 );
+    std::mt19937 random( 1 );
+    std::cout << std::fixed << std::setprecision( 2 );
+
+    // Insert Frames ( Level of Detail after Each Frame as Viewer )
+    PointOctree octree( 0.01f );
+    PointCloud cloud;
+    std::vector<OctreePoint> points;
+    std::vector<OctreePoint> levelOfDetail;
+    double insertTime = 0.0;
+    double levelOfDetailTime = 0.0;
+    for( int frame = 0; frame < frames; frame++ ){
+        generateFrame( frame, random, cloud );
+        for( size_t i = 0; i < cloud.size; i++ ){
+            const OctreePoint point = { cloud.x[i], cloud.y[i], cloud.z[i], cloud.color[i] };
+            points.push_back( point );
+        }
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        CHECK( octree.insert( cloud ) == cloud.size );
+        insertTime += elapsed( begin );
+
+        begin = std::chrono::steady_clock::now();
+        octree.extractLevelOfDetail( 2, levelOfDetail );
+        levelOfDetailTime += elapsed( begin );
+    }
+    CHECK( octree.size() == points.size() );
+    std::cout << octree.size() << " points, " << octree.getLeafCount() << " leaves, " << octree.getNodeCount() << " nodes, depth " << octree.getDepth()
+              << ", " << octree.getMemoryBytes() / ( 1024 * 1024 ) << " MB" << std::endl;
+    std::cout << "Insert : " << insertTime / frames << " ms/frame, " << octree.size() / insertTime / 1000.0 << " Mpts/s" << std::endl;
+    std::cout << "Level of Detail 2 after Each Frame : " << levelOfDetailTime / frames << " ms ( " << levelOfDetail.size() << " points )" << std::endl;
+
+    // Changed Only Level of Detail after One Frame
+    {
+        const uint32_t revision = octree.getRevision();
+        generateFrame( frames, random, cloud );
+        octree.insert( cloud );
+        for( size_t i = 0; i < cloud.size; i++ ){
+            const OctreePoint point = { cloud.x[i], cloud.y[i], cloud.z[i], cloud.color[i] };
+            points.push_back( point );
+        }
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        octree.extractLevelOfDetail( 1, levelOfDetail, revision );
+        std::cout << "Changed Level of Detail 1 after One Frame : " << elapsed( begin ) << " ms ( " << levelOfDetail.size() << " points )" << std::endl;
+        CHECK( !levelOfDetail.empty() );
+    }
+
+    // Queries against Brute Force ( Query Positions off Points )
+    const int queries = 20;
+    std::uniform_int_distribution<size_t> pick( 0, points.size() - 1 );
+    std::vector<OctreePoint> result;
+    std::vector<float> squaredDistances;
+    std::vector<float> distances;
+    const float radii[] = { 0.02f, 0.05f, 0.1f };
+    for( const float radius : radii ){
+        double octreeTime = 0.0;
+        double bruteTime = 0.0;
+        size_t found = 0;
+        size_t mismatches = 0;
+        for( int query = 0; query < queries; query++ ){
+            const OctreePoint& point = points[pick( random )];
+            const float x = point.x + 0.0013f;
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            octree.radiusSearch( x, point.y, point.z, radius, result );
+            octreeTime += elapsed( begin );
+
+            begin = std::chrono::steady_clock::now();
+            const size_t expected = bruteRadius( points, x, point.y, point.z, radius );
+            bruteTime += elapsed( begin );
+
+            size_t outside = 0;
+            for( const OctreePoint& neighbor : result ){
+                outside += ( squaredDistance( neighbor, x, point.y, point.z ) <= radius * radius ) ? 0 : 1;
+            }
+            mismatches += ( result.size() == expected && outside == 0 ) ? 0 : 1;
+            found += result.size();
+        }
+        std::cout << "Radius " << radius * 100.0f << " cm : " << octreeTime * 1000.0 / queries << " us ( brute force " << bruteTime * 1000.0 / queries << " us ), "
+                  << found / queries << " points" << std::endl;
+        CHECK( mismatches == 0 );
+    }
+
+    const int ks[] = { 1, 10, 50 };
+    for( const int k : ks ){
+        double octreeTime = 0.0;
+        double bruteTime = 0.0;
+        size_t mismatches = 0;
+        for( int query = 0; query < queries; query++ ){
+            const OctreePoint& point = points[pick( random )];
+            const float x = point.x + 0.0013f;
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            octree.nearestKSearch( x, point.y, point.z, k, result, squaredDistances );
+            octreeTime += elapsed( begin );
+
+            begin = std::chrono::steady_clock::now();
+            const std::vector<float> expected = bruteNearest( points, x, point.y, point.z, k, distances );
+            bruteTime += elapsed( begin );
+
+            mismatches += ( squaredDistances == expected && result.size() == expected.size() ) ? 0 : 1;
+        }
+        std::cout << "k-NN " << k << " : " << octreeTime * 1000.0 / queries << " us ( brute force " << bruteTime * 1000.0 / queries << " us )" << std::endl;
+        CHECK( mismatches == 0 );
+    }
+
+    // Level of Detail 0 is Leaves
+    octree.extractLevelOfDetail( 0, levelOfDetail );
+    CHECK( levelOfDetail.size() == octree.getLeafCount() );
+
+    // Incremental Level of Detail against Rebuilt Tree
+    {
+        std::vector<OctreePoint> incremental;
+        octree.extractLevelOfDetail( 3, incremental );
+        PointOctree rebuilt( 0.01f );
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        rebuilt.insert( &points[0], points.size() );
+        const double rebuiltTime = elapsed( begin );
+        std::vector<OctreePoint> expected;
+        rebuilt.extractLevelOfDetail( 3, expected );
+        std::cout << "Bulk Insert : " << points.size() / rebuiltTime / 1000.0 << " Mpts/s" << std::endl;
+
+        size_t mismatches = 0;
+        for( size_t i = 0; i < std::min( incremental.size(), expected.size() ); i++ ){
+            mismatches += ( std::fabs( incremental[i].x - expected[i].x ) <= 1e-4f && std::fabs( incremental[i].y - expected[i].y ) <= 1e-4f
+                            && std::fabs( incremental[i].z - expected[i].z ) <= 1e-4f && incremental[i].color == expected[i].color ) ? 0 : 1;
+        }
+        CHECK( incremental.size() == expected.size() );
+        CHECK( mismatches == 0 );
+    }
+
+    // Non-Finite Points are Skipped, Far Points Grow Root
+    {
+        PointOctree small( 0.05f );
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const OctreePoint edge[] = { { 0.01f, 0.01f, 0.01f, 0 }, { -100.0f, 3.0f, -7.0f, 0 }, { nan, 0.0f, 0.0f, 0 }, { 250.0f, -250.0f, 80.0f, 0 } };
+        CHECK( small.insert( edge, 4 ) == 3 );
+        small.nearestKSearch( 240.0f, -240.0f, 80.0f, 1, result, squaredDistances );
+        CHECK( result.size() == 1 && result[0].x == 250.0f );
+        small.radiusSearch( 0.0f, 0.0f, 0.0f, 0.1f, result );
+        CHECK( result.size() == 1 );
+    }
+
+    return Test::result( "Point Octree Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "Test.h"
+#include "SyntheticDepth.h"
+#include "TsdfVolume.h"
+#include "HashedTsdfVolume.h"
+#include "Raycaster.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <memory>
+#include <iomanip>
+#include <thread>
+
+// Depth Frame ( Kinect v2 Depth Resolution, Camera Normalized by Image Size )
+const int width = 512;
+const int height = 424;
+const FusionCamera camera = { 365.5f / width, 365.5f / height, 0.5f, 0.5f };
+
+// Raycast Frame of Camera at World Origin
+struct Output
+{
+    std::vector<float> pointCloud;
+    std::vector<uint32_t> shaded;
+
+    Output()
+        : pointCloud( width * height * 6 ),
+          shaded( width * height )
+    {
+    }
+
+    RaycastFrame frame()
+    {
+        RaycastFrame raycastFrame;
+        raycastFrame.pointCloud = &pointCloud[0];
+        raycastFrame.shaded = &shaded[0];
+        raycastFrame.width = width;
+        raycastFrame.height = height;
+        raycastFrame.camera = camera;
+        raycastFrame.worldToCamera = IdentityMatrix4f();
+        return raycastFrame;
+    }
+};
+
+// Measure Raycast with and without Empty Space Skipping, and Check Surface against Integrated Depth
+void measure( const std::string& name, TsdfGrid& grid, const std::vector<float>& depth, const int iterations )
+{
+    // Integrate Noise Free Frame ( Camera at World Origin )
+    TsdfFrame frame;
+    frame.depth = &depth[0];
+    frame.color = nullptr;
+    frame.width = width;
+    frame.height = height;
+    frame.camera = camera;
+    frame.worldToCamera = IdentityMatrix4f();
+    for( int i = 0; i < 3; i++ ){
+        grid.integrate( frame );
+    }
+
+    // Update ( First Scans All Bricks, then Only Changed Bricks )
+    Raycaster raycaster;
+    Raycaster denseRaycaster( false );
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    raycaster.update( grid );
+    const double firstUpdate = std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - begin ).count();
+    const double update = Test::measure( iterations, [&](){ raycaster.update( grid ); } );
+    denseRaycaster.update( grid );
+
+    // Raycast
+    Output skipped;
+    Output marched;
+    const double skippedTime = Test::measure( iterations, [&](){ raycaster.raycast( skipped.frame() ); } );
+    const double marchedTime = Test::measure( iterations, [&](){ denseRaycaster.raycast( marched.frame() ); } );
+
+    // Silhouettes of Input Depth ( Within 2 Pixels of Depth Discontinuity, Grazing Rays may Step over Thin Band of Distance )
+    std::vector<bool> silhouettes( width * height, false );
+    for( int v = 0; v < height; v++ ){
+        for( int u = 0; u < width; u++ ){
+            for( int dv = -2; dv <= 2; dv++ ){
+                for( int du = -2; du <= 2; du++ ){
+                    const int x = std::min( std::max( u + du, 0 ), width - 1 );
+                    const int y = std::min( std::max( v + dv, 0 ), height - 1 );
+                    if( std::fabs( depth[y * width + x] - depth[v * width + u] ) > 0.05f ){
+                        silhouettes[v * width + u] = true;
+                    }
+                }
+            }
+        }
+    }
+
+    // Surface Depth against Input Depth, and Skipped against Marched ( Same Hit within 2 Voxels )
+    const float tolerance = 2.0f / grid.getParameters().voxelsPerMeter;
+    size_t hits = 0;
+    size_t differences = 0;
+    size_t silhouetteDifferences = 0;
+    double totalError = 0.0;
+    float maxError = 0.0f;
+    for( int i = 0; i < width * height; i++ ){
+        const float a = skipped.pointCloud[i * 6 + 2];
+        const float b = marched.pointCloud[i * 6 + 2];
+        if( ( a > 0.0f ) != ( b > 0.0f ) || std::fabs( a - b ) > tolerance ){
+            ( silhouettes[i] ? silhouetteDifferences : differences )++;
+        }
+        if( a > 0.0f && depth[i] > 0.0f ){
+            const float error = std::fabs( a - depth[i] );
+            totalError += error;
+            maxError = std::max( maxError, error );
+            hits++;
+        }
+    }
+    const double meanError = ( hits > 0 ) ? totalError / hits : 0.0;
+
+    std::cout << name << " : " << skippedTime << " ms/frame ( " << marchedTime << " ms/frame without skipping, x" << marchedTime / skippedTime << " ), "
+              << "update " << firstUpdate << " ms first / " << update << " ms unchanged" << std::endl;
+    std::cout << name << " : " << hits << " hits, depth error mean " << meanError * 1000.0 << " mm / max " << maxError * 1000.0 << " mm, "
+              << differences << " pixels differ from marched ( " << silhouetteDifferences << " at silhouettes )" << std::endl;
+
+    CHECK( hits > static_cast<size_t>( width * height / 20 ) );
+    CHECK( meanError < 0.001 );
+    CHECK( differences <= static_cast<size_t>( width * height / 1000 ) );
+}
+
+// Raycast Benchmark ( Usage : RaycastBenchmark [iterations] )
+// Raycasts 512 x 424 point cloud and shaded image of synthetic depth integrated into dense volume of Fusion sample and into hashed volume,
+// with min/max pyramid skipping and with marching every node.
+int main( int argc, char* argv[] )
+{
+    const int iterations = Test::iterations( argc, argv, 3 );
+
+    // Noise Free Synthetic Depth [m]
+    SyntheticDepth synthetic( width, height, 0.0f );
+    const std::vector<uint16_t> millimeters = synthetic.generate( 135 );
+    std::vector<float> depth( millimeters.size() );
+    for( size_t i = 0; i < depth.size(); i++ ){
+        depth[i] = millimeters[i] * 0.001f;
+    }
+
+    std::cout << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision( 2 );
+
+    // Dense Volume ( Same as Fusion Sample, 512 x 384 x 512 Voxels at 256 Voxels per Meter )
+    {
+        std::unique_ptr<TsdfVolume> volume( new TsdfVolume( 512, 384, 512, DefaultTsdfParameters( 256.0f ) ) );
+        measure( "Dense 512x384x512", *volume, depth, iterations );
+    }
+
+    // Hashed Volume ( Whole Room, No Swapping )
+    {
+        HashedTsdfVolume volume( DefaultTsdfParameters( 256.0f ), 1 << 20, "RaycastBenchmark.swap" );
+        measure( "Hashed", volume, depth, iterations );
+    }
+
+    return Test::result( "Raycast Benchmark" );
+}
\ No newline at end of file
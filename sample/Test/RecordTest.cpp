@@ -0,0 +1,210 @@
+#include "Test.h"
+#include "Record.h"
+#include "DepthCodec.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+// Synthetic Frame Size ( Small Frames Keep Recording Small )
+const int width = 64;
+const int height = 48;
+const int frames = 40;
+
+// Generate Depth ( Moving Step and Invalid Border )
+std::vector<uint16_t> generateDepth( const int frame )
+{
+    std::vector<uint16_t> depth( width * height );
+    for( int y = 0; y < height; y++ ){
+        for( int x = 0; x < width; x++ ){
+            const bool border = x < 2 || width - 2 <= x;
+            const bool step = ( x + frame ) % width < width / 3;
+            depth[y * width + x] = border ? 0 : static_cast<uint16_t>( ( step ? 1200 : 2500 ) + x * 3 + y );
+        }
+    }
+    return depth;
+}
+
+// Generate YUY2 Color ( Gradient )
+std::vector<uint8_t> generateColor( const int frame )
+{
+    std::vector<uint8_t> color( width * height * 2 );
+    for( size_t index = 0; index < color.size(); index++ ){
+        color[index] = static_cast<uint8_t>( index * 7 + frame );
+    }
+    return color;
+}
+
+// Read File
+std::vector<char> readFile( const std::string& path )
+{
+    std::ifstream stream( path, std::ios::binary );
+    return std::vector<char>( std::istreambuf_iterator<char>( stream ), std::istreambuf_iterator<char>() );
+}
+
+// Write File
+void writeFile( const std::string& path, const std::vector<char>& data, const size_t bytes )
+{
+    std::ofstream stream( path, std::ios::binary );
+    stream.write( &data[0], bytes );
+}
+
+// Write Recording ( Compressed Depth, Raw Infrared, YUY2 Color and Body )
+void writeRecording( const std::string& path )
+{
+    RecordWriter writer;
+    writer.open( path );
+
+    DepthEncoder encoder( width, height, 10 );
+    std::vector<uint8_t> encoded;
+    for( int frame = 0; frame < frames; frame++ ){
+        const int64_t timestamp = frame * 333333;
+        const std::vector<uint16_t> depth = generateDepth( frame );
+        encoder.encode( &depth[0], encoded );
+        writer.write( RecordStream_Depth, RecordFormat_DepthCodec, width, height, timestamp, &encoded[0], encoded.size() );
+        writer.write( RecordStream_Infrared, RecordFormat_UInt16, width, height, timestamp, &depth[0], depth.size() * sizeof( uint16_t ) );
+
+        const std::vector<uint8_t> color = generateColor( frame );
+        writer.write( RecordStream_Color, RecordFormat_Yuy2, width, height, timestamp, &color[0], color.size() );
+
+        RecordBody bodies[6];
+        std::memset( bodies, 0, sizeof( bodies ) );
+        bodies[0].tracked = 1;
+        bodies[0].trackingId = 1000 + frame;
+        writer.write( RecordStream_Body, RecordFormat_Body, 6, 1, timestamp, bodies, sizeof( bodies ) );
+    }
+
+    writer.close();
+}
+
+// Check Every Frame of Recording has Payload that Matches its Format
+void checkFrames( const RecordReader& reader )
+{
+    for( int stream = 0; stream < RecordStream_Count; stream++ ){
+        for( size_t i = 0; i < reader.count( static_cast<RecordStream>( stream ) ); i++ ){
+            const RecordFrame frame = reader.frame( static_cast<RecordStream>( stream ), i );
+            CHECK( frame.valid() );
+            if( frame.header->format == RecordFormat_UInt16 || frame.header->format == RecordFormat_Yuy2 ){
+                CHECK( frame.size() == static_cast<size_t>( frame.width() ) * frame.height() * 2 );
+            }
+            if( frame.header->format == RecordFormat_Body ){
+                CHECK( frame.size() == static_cast<size_t>( frame.width() ) * sizeof( RecordBody ) );
+            }
+        }
+    }
+}
+
+// Check Recording Replays Same Frames as Written
+void checkReplay( const std::string& path )
+{
+    RecordReader reader;
+    reader.open( path );
+    CHECK( reader.count( RecordStream_Depth ) == frames );
+    CHECK( reader.count( RecordStream_Infrared ) == frames );
+    CHECK( reader.count( RecordStream_Color ) == frames );
+    CHECK( reader.count( RecordStream_Body ) == frames );
+    CHECK( reader.count( RecordStream_BodyIndex ) == 0 );
+    checkFrames( reader );
+
+    // Sequential Replay
+    RecordDepthDecoder decoder;
+    size_t mismatches = 0;
+    for( int frame = 0; frame < frames; frame++ ){
+        const std::vector<uint16_t> depth = generateDepth( frame );
+        const uint16_t* decoded = decoder.decode( reader, RecordStream_Depth, frame );
+        const uint16_t* infrared = decoder.decode( reader, RecordStream_Infrared, frame );
+        mismatches += ( decoded == nullptr || std::memcmp( decoded, &depth[0], depth.size() * sizeof( uint16_t ) ) != 0 ) ? 1 : 0;
+        mismatches += ( infrared == nullptr || std::memcmp( infrared, &depth[0], depth.size() * sizeof( uint16_t ) ) != 0 ) ? 1 : 0;
+
+        const std::vector<uint8_t> color = generateColor( frame );
+        const RecordFrame colorFrame = reader.frame( RecordStream_Color, frame );
+        mismatches += ( std::memcmp( colorFrame.data, &color[0], color.size() ) != 0 ) ? 1 : 0;
+        mismatches += ( reader.frame( RecordStream_Body, frame ).ptr<RecordBody>()[0].trackingId != 1000u + frame ) ? 1 : 0;
+    }
+    CHECK( mismatches == 0 );
+
+    // Random Access ( Backward Seek Decodes from Key Frame )
+    for( int frame = frames - 1; frame >= 0; frame -= 7 ){
+        const std::vector<uint16_t> depth = generateDepth( frame );
+        const uint16_t* decoded = decoder.seek( reader, RecordStream_Depth, frame * 333333 + 1 );
+        CHECK( decoded != nullptr && std::memcmp( decoded, &depth[0], depth.size() * sizeof( uint16_t ) ) == 0 );
+    }
+}
+
+// Find Offset of n-th Chunk of Stream in File
+size_t findChunk( const std::vector<char>& file, const RecordStream stream, const int n )
+{
+    size_t offset = sizeof( RecordFileHeader );
+    int found = 0;
+    while( offset + sizeof( RecordChunkHeader ) <= file.size() ){
+        RecordChunkHeader chunk;
+        std::memcpy( &chunk, &file[offset], sizeof( chunk ) );
+        if( chunk.stream == stream && found++ == n ){
+            return offset;
+        }
+        offset += ( sizeof( RecordChunkHeader ) + chunk.bytes + 63 ) & ~static_cast<uint64_t>( 63 );
+    }
+    return 0;
+}
+
+// Check Corrupted Chunk Header is Rejected ( Index is Recovered up to Corrupted Chunk )
+void checkCorrupted( const std::string& path, const std::vector<char>& original, const RecordStream stream, const size_t field, const uint32_t value )
+{
+    std::vector<char> file = original;
+    const size_t offset = findChunk( file, stream, frames / 2 );
+    CHECK( offset != 0 );
+    std::memcpy( &file[offset + field], &value, sizeof( value ) );
+    writeFile( path, file, file.size() );
+
+    RecordReader reader;
+    reader.open( path );
+    CHECK( reader.count( stream ) == frames / 2 );
+    checkFrames( reader );
+}
+
+// Check Truncated Recording is Recovered up to Last Complete Chunk
+void checkTruncated( const std::string& path, const std::vector<char>& original )
+{
+    const size_t offset = findChunk( original, RecordStream_Color, frames / 2 );
+    CHECK( offset != 0 );
+    writeFile( path, original, offset + sizeof( RecordChunkHeader ) + 100 );
+
+    RecordReader reader;
+    reader.open( path );
+    CHECK( reader.count( RecordStream_Color ) == frames / 2 );
+    CHECK( reader.count( RecordStream_Depth ) == frames / 2 + 1 );
+    checkFrames( reader );
+
+    RecordDepthDecoder decoder;
+    const std::vector<uint16_t> depth = generateDepth( frames / 2 );
+    const uint16_t* decoded = decoder.decode( reader, RecordStream_Depth, frames / 2 );
+    CHECK( decoded != nullptr && std::memcmp( decoded, &depth[0], depth.size() * sizeof( uint16_t ) ) == 0 );
+}
+
+int main()
+{
+    const std::string path = "RecordTest.k2rec";
+    const std::string corruptedPath = "RecordTestCorrupted.k2rec";
+
+    // Write and Replay Recording
+    writeRecording( path );
+    checkReplay( path );
+
+    // Corrupted Frame Size of Raw and Compressed Chunks, and Truncated File
+    const std::vector<char> original = readFile( path );
+    checkCorrupted( corruptedPath, original, RecordStream_Color, offsetof( RecordChunkHeader, width ), width * 4 );
+    checkCorrupted( corruptedPath, original, RecordStream_Infrared, offsetof( RecordChunkHeader, height ), height + 1 );
+    checkCorrupted( corruptedPath, original, RecordStream_Body, offsetof( RecordChunkHeader, width ), 1000 );
+    checkCorrupted( corruptedPath, original, RecordStream_Depth, offsetof( RecordChunkHeader, width ), width / 2 );
+    checkTruncated( corruptedPath, original );
+
+    std::remove( path.c_str() );
+    std::remove( corruptedPath.c_str() );
+
+    return Test::result( "Record Test" );
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "Test.h"
+#include "Registration.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <iomanip>
+
+#ifdef REGISTRATION_BENCHMARK_KINECT
+#include <Windows.h>
+#include <Kinect.h>
+#include <wrl/client.h>
+#include <thread>
+#include "util.h"
+using namespace Microsoft::WRL;
+#endif
+
+// Point of Color Space
+struct Point
+{
+    float X;
+    float Y;
+};
+
+// Exact Mapping ( Projects Each Depth Pixel through Extrinsics and Color Distortion every Frame, Rays of Depth Pixels are Cached )
+class ExactMapping
+{
+private:
+    RegistrationIntrinsics color;
+    RegistrationExtrinsics extrinsics;
+    std::vector<float> rayX;
+    std::vector<float> rayY;
+
+public:
+    // Constructor
+    ExactMapping( const int depthWidth, const int depthHeight, const RegistrationIntrinsics& depth, const RegistrationIntrinsics& color, const RegistrationExtrinsics& extrinsics )
+        : color( color ), extrinsics( extrinsics )
+    {
+        const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+        rayX.resize( size );
+        rayY.resize( size );
+        for( int depthY = 0; depthY < depthHeight; depthY++ ){
+            for( int depthX = 0; depthX < depthWidth; depthX++ ){
+                const size_t index = static_cast<size_t>( depthY ) * depthWidth + depthX;
+                const float distortedX = ( depthX - depth.principalPointX ) / depth.focalLengthX;
+                const float distortedY = ( depthY - depth.principalPointY ) / depth.focalLengthY;
+                float x = distortedX;
+                float y = distortedY;
+                for( int iteration = 0; iteration < 10; iteration++ ){
+                    const float r2 = x * x + y * y;
+                    const float factor = 1.0f + r2 * ( depth.radialDistortionSecondOrder + r2 * ( depth.radialDistortionFourthOrder + r2 * depth.radialDistortionSixthOrder ) );
+                    x = distortedX / factor;
+                    y = distortedY / factor;
+                }
+                rayX[index] = x;
+                rayY[index] = y;
+            }
+        }
+    }
+
+    // Map Depth Frame to Color Space ( Invalid Depth is Mapped to -Infinity )
+    void mapDepthFrameToColorSpace( const uint16_t* depth, Point* points ) const
+    {
+        const float invalid = -std::numeric_limits<float>::infinity();
+        const float* r = extrinsics.rotation;
+        const float* t = extrinsics.translation;
+        for( size_t index = 0; index < rayX.size(); index++ ){
+            if( depth[index] == 0 ){
+                points[index].X = points[index].Y = invalid;
+                continue;
+            }
+
+            const float z = depth[index] * 0.001f;
+            const float pointX = ( r[0] * rayX[index] + r[1] * rayY[index] + r[2] ) * z + t[0];
+            const float pointY = ( r[3] * rayX[index] + r[4] * rayY[index] + r[5] ) * z + t[1];
+            const float pointZ = ( r[6] * rayX[index] + r[7] * rayY[index] + r[8] ) * z + t[2];
+            const float x = pointX / pointZ;
+            const float y = pointY / pointZ;
+            const float r2 = x * x + y * y;
+            const float factor = 1.0f + r2 * ( color.radialDistortionSecondOrder + r2 * ( color.radialDistortionFourthOrder + r2 * color.radialDistortionSixthOrder ) );
+            points[index].X = x * factor * color.focalLengthX + color.principalPointX;
+            points[index].Y = y * factor * color.focalLengthY + color.principalPointY;
+        }
+    }
+};
+
+#ifdef REGISTRATION_BENCHMARK_KINECT
+// Measure ICoordinateMapper::MapDepthFrameToColorSpace [ms] ( Requires Connected Sensor, Returns Negative if Calibration was not Received )
+double measureCoordinateMapper( const int iterations, const std::vector<uint16_t>& depthBuffer )
+{
+    ComPtr<IKinectSensor> kinect;
+    ERROR_CHECK( GetDefaultKinectSensor( &kinect ) );
+    ERROR_CHECK( kinect->Open() );
+
+    ComPtr<ICoordinateMapper> coordinateMapper;
+    ERROR_CHECK( kinect->get_CoordinateMapper( &coordinateMapper ) );
+
+    // Wait until Coordinate Mapper Received Calibration from Sensor
+    std::vector<ColorSpacePoint> points( depthBuffer.size() );
+    double time = -1.0;
+    for( int retry = 0; retry < 50; retry++ ){
+        ERROR_CHECK( coordinateMapper->MapDepthFrameToColorSpace( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0], static_cast<UINT>( points.size() ), &points[0] ) );
+        if( std::isfinite( points[points.size() / 2].X ) ){
+            time = Test::measure( iterations, [&](){
+                coordinateMapper->MapDepthFrameToColorSpace( static_cast<UINT>( depthBuffer.size() ), &depthBuffer[0], static_cast<UINT>( points.size() ), &points[0] );
+            } );
+            break;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    }
+
+    kinect->Close();
+    return time;
+}
+#endif
+
+int main( int argc, char* argv[] )
+{
+    const int iterations = Test::iterations( argc, argv, 100 );
+
+    const int depthWidth = 512;
+    const int depthHeight = 424;
+    const int colorWidth = 1920;
+    const int colorHeight = 1080;
+    const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+
+    // Synthetic Calibration ( Similar to Kinect v2, Rotation of about 0.5 deg )
+    const RegistrationIntrinsics depthIntrinsics = { 365.5f, 365.5f, 257.0f, 204.5f, 0.092f, -0.271f, 0.095f };
+    const RegistrationIntrinsics colorIntrinsics = { 1062.0f, 1062.0f, 963.0f, 534.0f, 0.025f, -0.020f, 0.0f };
+    const RegistrationExtrinsics extrinsics = {
+        { 0.99996f, -0.00349f, 0.00873f, 0.00354f, 0.99998f, -0.00523f, -0.00871f, 0.00526f, 0.99995f },
+        { 0.052f, 0.0005f, 0.002f }
+    };
+
+    Registration registration;
+    CHECK( registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, depthIntrinsics, colorIntrinsics, extrinsics ) );
+    const ExactMapping exact( depthWidth, depthHeight, depthIntrinsics, colorIntrinsics, extrinsics );
+
+    // Random Depth ( 500-4500 mm, 5% Invalid )
+    std::mt19937 random( 0 );
+    std::uniform_int_distribution<int> distribution( 0, 4500 );
+    std::vector<uint16_t> depthBuffer( size );
+    for( uint16_t& depth : depthBuffer ){
+        const int value = distribution( random );
+        depth = static_cast<uint16_t>( ( value < 225 ) ? 0 : std::max( value, 500 ) );
+    }
+    std::vector<uint8_t> colorBuffer( static_cast<size_t>( colorWidth ) * colorHeight * 4, 128 );
+    std::vector<uint8_t> registeredBuffer( size * 4 );
+    std::vector<Point> exactPoints( size );
+    std::vector<Point> tablePoints( size );
+
+    // Measure
+    const double exactTime = Test::measure( iterations, [&](){ exact.mapDepthFrameToColorSpace( &depthBuffer[0], &exactPoints[0] ); } );
+    const double tableTime = Test::measure( iterations, [&](){ registration.mapDepthFrameToColorSpace( &depthBuffer[0], &tablePoints[0] ); } );
+    const double registerTime = Test::measure( iterations, [&](){ registration.registerColor( &depthBuffer[0], &colorBuffer[0], &registeredBuffer[0] ); } );
+
+    // Check Table Remap Agrees with Exact Mapping ( Error Bound of Two-Depth Fit is Checked by Registration Test )
+    double maximum = 0.0;
+    for( size_t index = 0; index < size; index++ ){
+        if( depthBuffer[index] != 0 ){
+            maximum = std::max( maximum, static_cast<double>( std::hypot( exactPoints[index].X - tablePoints[index].X, exactPoints[index].Y - tablePoints[index].Y ) ) );
+        }
+    }
+    CHECK( maximum < 0.5 );
+
+    std::cout << std::fixed << std::setprecision( 3 );
+    std::cout << "Exact Mapping per Frame : " << exactTime << " ms" << std::endl;
+    std::cout << "Table Remap per Frame : " << tableTime << " ms ( x" << exactTime / tableTime << " )" << std::endl;
+    std::cout << "Register Color per Frame : " << registerTime << " ms" << std::endl;
+    std::cout << "Max Difference of Table Remap : " << maximum << " px" << std::endl;
+
+#ifdef REGISTRATION_BENCHMARK_KINECT
+    // Measure Coordinate Mapper of Kinect SDK ( Mapping that Samples Used Every Frame )
+    try{
+        const double mapperTime = measureCoordinateMapper( iterations, depthBuffer );
+        if( mapperTime < 0.0 ){
+            std::cout << "ICoordinateMapper : skipped ( calibration was not received )" << std::endl;
+        }
+        else{
+            std::cout << "ICoordinateMapper::MapDepthFrameToColorSpace per Frame : " << mapperTime << " ms ( Table Remap x" << mapperTime / tableTime << " )" << std::endl;
+        }
+    } catch( std::exception& ex ){
+        std::cout << "ICoordinateMapper : skipped ( " << ex.what() << ")" << std::endl;
+    }
+#endif
+
+    return Test::result( "Registration Benchmark" );
+}
\ No newline at end of file
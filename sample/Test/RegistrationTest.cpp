@@ -0,0 +1,248 @@
+#include "Test.h"
+#include "Registration.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <iomanip>
+
+// Calibration of Synthetic Sensor
+struct Calibration
+{
+    const char* name;
+    RegistrationIntrinsics depth;
+    RegistrationIntrinsics color;
+    RegistrationExtrinsics extrinsics;
+    double bound; // Maximum Reprojection Error [pixel]
+};
+
+// Create Extrinsics from Rotation Angles around X, Y and Z Axis [deg] and Translation [m]
+RegistrationExtrinsics createExtrinsics( const double angleX, const double angleY, const double angleZ, const float translationX, const float translationY, const float translationZ )
+{
+    const double radian = 3.14159265358979323846 / 180.0;
+    const double cx = std::cos( angleX * radian ), sx = std::sin( angleX * radian );
+    const double cy = std::cos( angleY * radian ), sy = std::sin( angleY * radian );
+    const double cz = std::cos( angleZ * radian ), sz = std::sin( angleZ * radian );
+
+    // R = Rz * Ry * Rx
+    const double rotation[9] = {
+        cz * cy, cz * sy * sx - sz * cx, cz * sy * cx + sz * sx,
+        sz * cy, sz * sy * sx + cz * cx, sz * sy * cx - cz * sx,
+            -sy,                cy * sx,                cy * cx
+    };
+
+    RegistrationExtrinsics extrinsics;
+    for( int index = 0; index < 9; index++ ){
+        extrinsics.rotation[index] = static_cast<float>( rotation[index] );
+    }
+    extrinsics.translation[0] = translationX;
+    extrinsics.translation[1] = translationY;
+    extrinsics.translation[2] = translationZ;
+    return extrinsics;
+}
+
+// Normalized Ray of Depth Pixel
+struct Ray
+{
+    double x;
+    double y;
+};
+
+// Compute Rays of Depth Pixels ( Reference, Double Precision, Fixed-Point Iteration until Converged )
+std::vector<Ray> computeRays( const RegistrationIntrinsics& intrinsics, const int depthWidth, const int depthHeight )
+{
+    std::vector<Ray> rays( static_cast<size_t>( depthWidth ) * depthHeight );
+    for( int depthY = 0; depthY < depthHeight; depthY++ ){
+        for( int depthX = 0; depthX < depthWidth; depthX++ ){
+            const double distortedX = ( depthX - intrinsics.principalPointX ) / static_cast<double>( intrinsics.focalLengthX );
+            const double distortedY = ( depthY - intrinsics.principalPointY ) / static_cast<double>( intrinsics.focalLengthY );
+            Ray& ray = rays[static_cast<size_t>( depthY ) * depthWidth + depthX];
+            ray.x = distortedX;
+            ray.y = distortedY;
+            for( int iteration = 0; iteration < 100; iteration++ ){
+                const double r2 = ray.x * ray.x + ray.y * ray.y;
+                const double factor = 1.0 + r2 * ( intrinsics.radialDistortionSecondOrder + r2 * ( intrinsics.radialDistortionFourthOrder + r2 * intrinsics.radialDistortionSixthOrder ) );
+                ray.x = distortedX / factor;
+                ray.y = distortedY / factor;
+            }
+        }
+    }
+    return rays;
+}
+
+// Exact Mapping of Depth Ray to Color Pixel at Depth [mm] ( Reference, Double Precision )
+void projectExact( const Calibration& calibration, const Ray& ray, const double depth, double& colorX, double& colorY )
+{
+    // Depth Camera Space -> Color Camera Space
+    const float* r = calibration.extrinsics.rotation;
+    const float* t = calibration.extrinsics.translation;
+    const double z = depth * 0.001;
+    const double pointX = ( r[0] * ray.x + r[1] * ray.y + r[2] ) * z + t[0];
+    const double pointY = ( r[3] * ray.x + r[4] * ray.y + r[5] ) * z + t[1];
+    const double pointZ = ( r[6] * ray.x + r[7] * ray.y + r[8] ) * z + t[2];
+
+    // Color Camera Space -> Color Pixel
+    const RegistrationIntrinsics& c = calibration.color;
+    const double x = pointX / pointZ;
+    const double y = pointY / pointZ;
+    const double r2 = x * x + y * y;
+    const double factor = 1.0 + r2 * ( c.radialDistortionSecondOrder + r2 * ( c.radialDistortionFourthOrder + r2 * c.radialDistortionSixthOrder ) );
+    colorX = x * factor * c.focalLengthX + c.principalPointX;
+    colorY = y * factor * c.focalLengthY + c.principalPointY;
+}
+
+// Reprojection Error of Registration Tables against Exact Mapping
+struct ReprojectionError
+{
+    double maximum; // [pixel]
+    double mean;    // [pixel]
+};
+
+// Measure Reprojection Error at Constant Depths in Range [mm] ( Pixels Mapped inside of Color Frame )
+ReprojectionError measureError( const Calibration& calibration, const Registration& registration, const int beginDepth, const int endDepth, const int stepDepth )
+{
+    struct Point{ float X; float Y; };
+
+    const int depthWidth = registration.getDepthWidth();
+    const int depthHeight = registration.getDepthHeight();
+    const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+    std::vector<uint16_t> depthBuffer( size );
+    std::vector<Point> points( size );
+    const std::vector<Ray> rays = computeRays( calibration.depth, depthWidth, depthHeight );
+
+    ReprojectionError error = { 0.0, 0.0 };
+    size_t count = 0;
+    for( int depth = beginDepth; depth <= endDepth; depth += stepDepth ){
+        std::fill( depthBuffer.begin(), depthBuffer.end(), static_cast<uint16_t>( depth ) );
+        registration.mapDepthFrameToColorSpace( &depthBuffer[0], &points[0] );
+
+        for( int depthY = 0; depthY < depthHeight; depthY++ ){
+            for( int depthX = 0; depthX < depthWidth; depthX++ ){
+                const size_t index = static_cast<size_t>( depthY ) * depthWidth + depthX;
+                double colorX, colorY;
+                projectExact( calibration, rays[index], depth, colorX, colorY );
+                if( colorX < 0.0 || registration.getColorWidth() <= colorX || colorY < 0.0 || registration.getColorHeight() <= colorY ){
+                    continue;
+                }
+
+                const Point& point = points[index];
+                const double distance = std::hypot( point.X - colorX, point.Y - colorY );
+                error.maximum = std::max( error.maximum, distance );
+                error.mean += distance;
+                count++;
+            }
+        }
+    }
+
+    error.mean = ( count > 0 ) ? error.mean / count : 0.0;
+    return error;
+}
+
+// Check Registration of Color ( Nearest Color Pixel of Mapped Coordinate, Dispatched SIMD Path against Scalar Reference )
+void checkRegisterColor( const Registration& registration )
+{
+    struct Point{ float X; float Y; };
+
+    const int depthWidth = registration.getDepthWidth();
+    const int depthHeight = registration.getDepthHeight();
+    const int colorWidth = registration.getColorWidth();
+    const int colorHeight = registration.getColorHeight();
+    const size_t size = static_cast<size_t>( depthWidth ) * depthHeight;
+
+    // Random Depth including Invalid Depth, and Color that Encodes Pixel Position
+    std::mt19937 random( 0 );
+    std::uniform_int_distribution<int> distribution( 0, 8000 );
+    std::vector<uint16_t> depthBuffer( size );
+    for( size_t index = 0; index < size; index++ ){
+        const int depth = distribution( random );
+        depthBuffer[index] = static_cast<uint16_t>( ( depth < 400 ) ? 0 : depth );
+    }
+
+    std::vector<uint32_t> colorBuffer( static_cast<size_t>( colorWidth ) * colorHeight );
+    for( size_t index = 0; index < colorBuffer.size(); index++ ){
+        colorBuffer[index] = static_cast<uint32_t>( index ) | 0xff000000u;
+    }
+
+    std::vector<uint32_t> registeredBuffer( size, 0xdeadbeefu );
+    registration.registerColor( &depthBuffer[0], reinterpret_cast<const uint8_t*>( &colorBuffer[0] ), reinterpret_cast<uint8_t*>( &registeredBuffer[0] ) );
+
+    // Scalar Reference from Mapped Coordinates ( Truncation of x + 0.5, Same as Registration::registerColorScalar )
+    // SIMD paths may contract multiply-add into FMA, so coordinates within rounding error of a pixel boundary may select the neighbour pixel.
+    std::vector<Point> points( size );
+    registration.mapDepthFrameToColorSpace( &depthBuffer[0], &points[0] );
+    size_t mismatches = 0;
+    size_t boundaries = 0;
+    for( size_t index = 0; index < size; index++ ){
+        const float x = points[index].X + 0.5f;
+        const float y = points[index].Y + 0.5f;
+        uint32_t expected = 0;
+        if( depthBuffer[index] != 0 && -1.0f < x && x < colorWidth && -1.0f < y && y < colorHeight ){
+            expected = colorBuffer[static_cast<int>( y ) * colorWidth + static_cast<int>( x )];
+        }
+        if( registeredBuffer[index] == expected ){
+            continue;
+        }
+
+        const float epsilon = 1e-3f;
+        const bool boundary = std::abs( x - std::round( x ) ) < epsilon || std::abs( y - std::round( y ) ) < epsilon;
+        if( boundary ){
+            boundaries++;
+        }
+        else{
+            mismatches++;
+        }
+    }
+
+    std::cout << "Register Color : " << mismatches << " mismatches, " << boundaries << " at pixel boundary in " << size << " pixels";
+#ifdef SIMD_X86
+    std::cout << " ( " << ( IsSupportedAVX2() ? "AVX2" : IsSupportedSSE41() ? "SSE4.1" : "Scalar" ) << " )";
+#endif
+    std::cout << std::endl;
+    CHECK( mismatches == 0 );
+}
+
+int main()
+{
+    const int depthWidth = 512;
+    const int depthHeight = 424;
+    const int colorWidth = 1920;
+    const int colorHeight = 1080;
+
+    // Synthetic Calibrations ( Similar to Kinect v2, and Larger Rotation, Baseline along Z and Distortion )
+    // Base + shift / depth is exact only for pure X/Y baseline without color distortion, so the error of two-depth fit is bounded here.
+    const Calibration calibrations[] = {
+        {
+            "Kinect v2",
+            { 365.5f, 365.5f, 257.0f, 204.5f, 0.092f, -0.271f, 0.095f },
+            { 1062.0f, 1062.0f, 963.0f, 534.0f, 0.025f, -0.020f, 0.0f },
+            createExtrinsics( 0.3, 0.5, 0.2, 0.052f, 0.0005f, 0.002f ),
+            0.5
+        },
+        {
+            "Stress",
+            { 365.5f, 365.5f, 257.0f, 204.5f, 0.092f, -0.271f, 0.095f },
+            { 1062.0f, 1062.0f, 963.0f, 534.0f, 0.100f, -0.100f, 0.02f },
+            createExtrinsics( 2.0, 3.0, 1.0, 0.052f, 0.005f, 0.010f ),
+            1.0
+        }
+    };
+
+    for( const Calibration& calibration : calibrations ){
+        Registration registration;
+        CHECK( registration.initialize( depthWidth, depthHeight, colorWidth, colorHeight, calibration.depth, calibration.color, calibration.extrinsics ) );
+
+        // Reprojection Error inside of Fitted Range ( 500-4500 mm ) and beyond ( 4500-8000 mm )
+        const ReprojectionError inside = measureError( calibration, registration, 500, 4500, 100 );
+        const ReprojectionError outside = measureError( calibration, registration, 4500, 8000, 250 );
+        std::cout << std::fixed << std::setprecision( 4 );
+        std::cout << calibration.name << " : Reprojection Error 500-4500 mm : max " << inside.maximum << " px, mean " << inside.mean << " px" << std::endl;
+        std::cout << calibration.name << " : Reprojection Error 4500-8000 mm : max " << outside.maximum << " px, mean " << outside.mean << " px" << std::endl;
+        CHECK( inside.maximum < calibration.bound );
+        CHECK( outside.maximum < calibration.bound );
+
+        checkRegisterColor( registration );
+    }
+
+    return Test::result( "Registration Test" );
+}
\ No newline at end of file
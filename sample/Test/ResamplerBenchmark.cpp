@@ -0,0 +1,346 @@
+#include "Test.h"
+#include "SyntheticDepth.h"
+#include "Resampler.h"
+#include "ThreadPool.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <random>
+#include <iomanip>
+
+#ifdef RESAMPLER_BENCHMARK_OPENCV
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#endif
+
+// Legacy Functions ( Nearest Neighbor Helpers of KinectFusionHelper on Buffers, Concurrency::parallel_for is Replaced by Thread Pool )
+namespace Legacy
+{
+    const unsigned int NUI_DEPTH_RAW_WIDTH = 512;
+    const unsigned int NUI_DEPTH_RAW_HEIGHT = 424;
+
+    void DownsampleColorFrameToDepthResolution( const uint32_t* srcValues, uint32_t* downsampledDestValues )
+    {
+        const float factor = 1080.0f / NUI_DEPTH_RAW_HEIGHT;
+        const unsigned int downsampledWidth = NUI_DEPTH_RAW_WIDTH;
+        const unsigned int srcImageWidth = 1920;
+
+        std::memset( downsampledDestValues, 0, NUI_DEPTH_RAW_WIDTH * NUI_DEPTH_RAW_HEIGHT * sizeof( uint32_t ) );
+        ThreadPool::global().parallelFor( NUI_DEPTH_RAW_HEIGHT, [&]( const size_t y ){
+            unsigned int index = static_cast<unsigned int>( downsampledWidth * y );
+            for( unsigned int x = 0; x < downsampledWidth; ++x, ++index ){
+                int srcX = (int)( x * factor );
+                int srcY = (int)( y * factor );
+                int srcIndex = srcY * srcImageWidth + srcX;
+                downsampledDestValues[index] = srcValues[srcIndex];
+            }
+        } );
+    }
+
+    void DownsampleFrameNearestNeighbor( const float* srcValues, const unsigned int srcImageWidth, const unsigned int srcImageHeight, float* downsampledDestValues, const unsigned int factor, const unsigned int step )
+    {
+        const unsigned int downsampledWidth = srcImageWidth / factor;
+        const unsigned int downsampleHeight = srcImageHeight / factor;
+        const unsigned int factorStep = factor * step;
+
+        ThreadPool::global().parallelFor( downsampleHeight, [&]( const size_t y ){
+            unsigned int index = static_cast<unsigned int>( downsampledWidth * y * step );
+            unsigned int srcIndex = static_cast<unsigned int>( srcImageWidth * y * factorStep );
+
+            for( unsigned int x = 0; x < downsampledWidth; ++x, srcIndex += factorStep ){
+                for( unsigned int s = 0, localSourceIndex = srcIndex; s < step; ++s, ++index, ++localSourceIndex ){
+                    downsampledDestValues[index] = srcValues[localSourceIndex];
+                }
+            }
+        } );
+    }
+
+    void UpsampleFrameNearestNeighbor( const uint32_t* srcValues, const unsigned int srcImageWidth, const unsigned int srcImageHeight, uint32_t* upsampledDestValues, const unsigned int factor )
+    {
+        const unsigned int upsampledWidth = srcImageWidth * factor;
+        const unsigned int upsampleRowMultiplier = upsampledWidth * factor;
+
+        // Note we run this only for the source image height pixels to sparsely fill the destination with rows
+        ThreadPool::global().parallelFor( srcImageHeight, [&]( const size_t y ){
+            unsigned int index = static_cast<unsigned int>( upsampleRowMultiplier * y );
+            unsigned int srcIndex = static_cast<unsigned int>( srcImageWidth * y );
+
+            // Fill row
+            for( unsigned int x = 0; x < srcImageWidth; ++x, ++srcIndex ){
+                unsigned int color = srcValues[srcIndex];
+
+                // Replicate pixels horizontally
+                for( unsigned int s = 0; s < factor; ++s, ++index ){
+                    upsampledDestValues[index] = color;
+                }
+            }
+        } );
+
+        const unsigned int rowByteSize = upsampledWidth * sizeof( unsigned int );
+
+        // Duplicate the remaining rows with memcpy
+        for( unsigned int y = 0; y < srcImageHeight; ++y ){
+            const unsigned int srcRowIndex = upsampleRowMultiplier * y;
+            for( unsigned int r = 1; r < factor; ++r ){
+                const unsigned int index = upsampledWidth * ( ( y * factor ) + r );
+                std::memcpy( &upsampledDestValues[index], &upsampledDestValues[srcRowIndex], rowByteSize );
+            }
+        }
+    }
+}
+
+// Color Sizes ( 1920 x 1080 Frame, Left 1304 x 1080 is Sampled by DownsampleColorFrameToDepthResolution )
+const int colorWidth = 1920;
+const int colorHeight = 1080;
+const int cropWidth = 1304;
+const int depthWidth = 512;
+const int depthHeight = 424;
+
+// RMS Deviation of Gray Channel from Value
+double rmsDeviation( const std::vector<uint32_t>& image, const double value )
+{
+    double sum = 0.0;
+    for( const uint32_t color : image ){
+        const double difference = static_cast<double>( color & 0xff ) - value;
+        sum += difference * difference;
+    }
+    return std::sqrt( sum / image.size() );
+}
+
+// Maximum Channel Difference of Colors
+int maxDifference( const uint32_t* a, const uint32_t* b, const size_t count )
+{
+    int difference = 0;
+    for( size_t i = 0; i < count; i++ ){
+        for( int shift = 0; shift < 32; shift += 8 ){
+            difference = std::max( difference, std::abs( static_cast<int>( ( a[i] >> shift ) & 0xff ) - static_cast<int>( ( b[i] >> shift ) & 0xff ) ) );
+        }
+    }
+    return difference;
+}
+
+// Reference Box Filter of Color ( Exact Area Average in Double )
+std::vector<uint32_t> referenceBox( const std::vector<uint32_t>& source, const int sourcePitch, const int sourceWidth, const int sourceHeight, const int width, const int height )
+{
+    const double scaleX = static_cast<double>( sourceWidth ) / width;
+    const double scaleY = static_cast<double>( sourceHeight ) / height;
+    std::vector<uint32_t> destination( static_cast<size_t>( width ) * height );
+    for( int y = 0; y < height; y++ ){
+        for( int x = 0; x < width; x++ ){
+            double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+            for( int sy = static_cast<int>( y * scaleY ); sy < std::min( static_cast<int>( std::ceil( ( y + 1 ) * scaleY ) ), sourceHeight ); sy++ ){
+                const double wy = std::min( ( y + 1 ) * scaleY, sy + 1.0 ) - std::max( y * scaleY, static_cast<double>( sy ) );
+                for( int sx = static_cast<int>( x * scaleX ); sx < std::min( static_cast<int>( std::ceil( ( x + 1 ) * scaleX ) ), sourceWidth ); sx++ ){
+                    const double wx = std::min( ( x + 1 ) * scaleX, sx + 1.0 ) - std::max( x * scaleX, static_cast<double>( sx ) );
+                    const uint32_t color = source[static_cast<size_t>( sy ) * sourcePitch + sx];
+                    for( int channel = 0; channel < 4; channel++ ){
+                        sum[channel] += ( ( color >> ( channel * 8 ) ) & 0xff ) * wx * wy;
+                    }
+                }
+            }
+            uint32_t color = 0;
+            for( int channel = 0; channel < 4; channel++ ){
+                color |= static_cast<uint32_t>( std::lround( sum[channel] / ( scaleX * scaleY ) ) ) << ( channel * 8 );
+            }
+            destination[static_cast<size_t>( y ) * width + x] = color;
+        }
+    }
+    return destination;
+}
+
+// Resampler Benchmark ( Usage : ResamplerBenchmark [iterations] )
+// Resamples color, depth and point cloud frames of Fusion sample with Resampler and with legacy nearest neighbor helpers of KinectFusionHelper,
+// and with cv::resize if OpenCV is found. Times are per frame on thread pool.
+int main( int argc, char* argv[] )
+{
+    const int iterations = Test::iterations( argc, argv, 50 );
+    std::cout << std::fixed << std::setprecision( 1 );
+    std::mt19937 random( 0 );
+
+    // Random Color
+    std::vector<uint32_t> color( static_cast<size_t>( colorWidth ) * colorHeight );
+    for( uint32_t& value : color ){
+        value = static_cast<uint32_t>( random() ) | 0xff000000;
+    }
+
+    // Color Crop 1304 x 1080 -> 512 x 424
+    std::vector<uint32_t> downsampled( depthWidth * depthHeight );
+    const size_t colorPitch = colorWidth * sizeof( uint32_t );
+    const size_t depthColorPitch = depthWidth * sizeof( uint32_t );
+    Resampler colorNearest( cropWidth, colorHeight, depthWidth, depthHeight, ResampleFilter_Nearest );
+    Resampler colorBilinear( cropWidth, colorHeight, depthWidth, depthHeight, ResampleFilter_Bilinear );
+    Resampler colorBox( cropWidth, colorHeight, depthWidth, depthHeight, ResampleFilter_Box );
+    {
+        const double legacyTime = Test::measure( iterations, [&](){ Legacy::DownsampleColorFrameToDepthResolution( &color[0], &downsampled[0] ); } ) * 1000.0;
+        const double nearestTime = Test::measure( iterations, [&](){ colorNearest.resampleColor( &color[0], colorPitch, &downsampled[0], depthColorPitch ); } ) * 1000.0;
+        const double bilinearTime = Test::measure( iterations, [&](){ colorBilinear.resampleColor( &color[0], colorPitch, &downsampled[0], depthColorPitch ); } ) * 1000.0;
+        const double boxTime = Test::measure( iterations, [&](){ colorBox.resampleColor( &color[0], colorPitch, &downsampled[0], depthColorPitch ); } ) * 1000.0;
+        std::cout << "Color 1304x1080 -> 512x424 : legacy nearest " << legacyTime << " us, nearest " << nearestTime << " us, bilinear " << bilinearTime << " us, box " << boxTime << " us" << std::endl;
+
+        // Box against Exact Area Average ( Rounding of Float Weights )
+        const std::vector<uint32_t> reference = referenceBox( color, colorWidth, cropWidth, colorHeight, depthWidth, depthHeight );
+        CHECK( maxDifference( &downsampled[0], &reference[0], reference.size() ) <= 1 );
+
+#ifdef RESAMPLER_BENCHMARK_OPENCV
+        // cv::resize ( INTER_AREA is Area Average, INTER_LINEAR is Bilinear at Pixel Centers, 8 bits Fixed Point Weights )
+        const cv::Mat sourceMat( colorHeight, cropWidth, CV_8UC4, &color[0], colorPitch );
+        cv::Mat resizedMat( depthHeight, depthWidth, CV_8UC4 );
+        const int interpolations[] = { cv::INTER_NEAREST, cv::INTER_LINEAR, cv::INTER_AREA };
+        const Resampler* resamplers[] = { &colorNearest, &colorBilinear, &colorBox };
+        const char* names[] = { "nearest", "bilinear", "area" };
+        for( int i = 0; i < 3; i++ ){
+            const double time = Test::measure( iterations, [&](){ cv::resize( sourceMat, resizedMat, resizedMat.size(), 0.0, 0.0, interpolations[i] ); } ) * 1000.0;
+            resamplers[i]->resampleColor( &color[0], colorPitch, &downsampled[0], depthColorPitch );
+            const int difference = maxDifference( &downsampled[0], reinterpret_cast<const uint32_t*>( resizedMat.data ), downsampled.size() );
+            std::cout << "cv::resize " << names[i] << " : " << time << " us, max difference " << difference << std::endl;
+            if( interpolations[i] != cv::INTER_NEAREST ){
+                CHECK( difference <= 1 );
+            }
+        }
+#endif
+    }
+
+    // Aliasing of 2.2 Pixels Grating ( Above Nyquist of Destination, Ideal Result is Flat Mean Gray )
+    {
+        std::vector<uint32_t> grating( color.size() );
+        for( int y = 0; y < colorHeight; y++ ){
+            for( int x = 0; x < colorWidth; x++ ){
+                const uint32_t gray = static_cast<uint32_t>( std::lround( 127.5 + 127.5 * std::sin( 2.0 * 3.14159265358979 * x / 2.2 ) ) );
+                grating[static_cast<size_t>( y ) * colorWidth + x] = 0xff000000 | ( gray << 16 ) | ( gray << 8 ) | gray;
+            }
+        }
+        double mean = 0.0;
+        for( int x = 0; x < cropWidth; x++ ){
+            mean += grating[x] & 0xff;
+        }
+        mean /= cropWidth;
+
+        Legacy::DownsampleColorFrameToDepthResolution( &grating[0], &downsampled[0] );
+        const double legacyError = rmsDeviation( downsampled, mean );
+        colorNearest.resampleColor( &grating[0], colorPitch, &downsampled[0], depthColorPitch );
+        const double nearestError = rmsDeviation( downsampled, mean );
+        colorBilinear.resampleColor( &grating[0], colorPitch, &downsampled[0], depthColorPitch );
+        const double bilinearError = rmsDeviation( downsampled, mean );
+        colorBox.resampleColor( &grating[0], colorPitch, &downsampled[0], depthColorPitch );
+        const double boxError = rmsDeviation( downsampled, mean );
+        std::cout << "RMS Aliasing of 2.2 px Grating : legacy nearest " << legacyError << ", nearest " << nearestError << ", bilinear " << bilinearError << ", box " << boxError << std::endl;
+        CHECK( boxError < bilinearError && bilinearError < nearestError );
+        CHECK( boxError * 4.0 < nearestError );
+    }
+
+    // Depth 512 x 424 -> 256 x 212 ( Synthetic Scene with Invalid Pixels and Discontinuities )
+    {
+        SyntheticDepth synthetic( depthWidth, depthHeight, 0.0f );
+        const std::vector<uint16_t> millimeters = synthetic.generate( 135 );
+        std::vector<float> depth( millimeters.size() );
+        for( size_t i = 0; i < depth.size(); i++ ){
+            depth[i] = millimeters[i] * 0.001f;
+        }
+        const int width = depthWidth / 2;
+        const int height = depthHeight / 2;
+        const size_t pitch = depthWidth * sizeof( float );
+        const size_t halfPitch = width * sizeof( float );
+        std::vector<float> half( static_cast<size_t>( width ) * height );
+
+        Resampler depthNearest( depthWidth, depthHeight, width, height, ResampleFilter_Nearest );
+        Resampler depthBox( depthWidth, depthHeight, width, height, ResampleFilter_Box );
+        const double legacyTime = Test::measure( iterations, [&](){ Legacy::DownsampleFrameNearestNeighbor( &depth[0], depthWidth, depthHeight, &half[0], 2, 1 ); } ) * 1000.0;
+        const double nearestTime = Test::measure( iterations, [&](){ depthNearest.resampleFloat( &depth[0], pitch, &half[0], halfPitch ); } ) * 1000.0;
+        const double boxTime = Test::measure( iterations, [&](){ depthBox.resampleFloat( &depth[0], pitch, &half[0], halfPitch ); } ) * 1000.0;
+
+        // Mixed Pixels ( Not within Discontinuity of any Valid Source Pixel of 2 x 2 Footprint )
+        auto mixedPixels = [&](){
+            size_t count = 0;
+            for( int y = 0; y < height; y++ ){
+                for( int x = 0; x < width; x++ ){
+                    const float value = half[y * width + x];
+                    bool near = ( value == 0.0f );
+                    for( int i = 0; i < 4 && !near; i++ ){
+                        const float sample = depth[( y * 2 + i / 2 ) * depthWidth + x * 2 + i % 2];
+                        near = ( sample > 0.0f && std::fabs( sample - value ) <= 0.1f );
+                    }
+                    count += near ? 0 : 1;
+                }
+            }
+            return count;
+        };
+        const size_t boxMixed = mixedPixels();
+
+        const double depthTime = Test::measure( iterations, [&](){ depthBox.resampleDepth( &depth[0], pitch, &half[0], halfPitch ); } ) * 1000.0;
+        const size_t depthMixed = mixedPixels();
+        std::cout << "Depth 512x424 -> 256x212 : legacy nearest " << legacyTime << " us, nearest " << nearestTime << " us, box " << boxTime << " us ( "
+                  << boxMixed << " mixed pixels ), depth-aware box " << depthTime << " us ( " << depthMixed << " mixed pixels )" << std::endl;
+        CHECK( boxMixed > 0 );
+        CHECK( depthMixed == 0 );
+
+        // Invalid Pixels are Preserved ( Nearest Source Pixel of Destination is at Center of 2 x 2 Footprint, Rounded to Bottom Right )
+        size_t invalidMismatches = 0;
+        for( int y = 0; y < height; y++ ){
+            for( int x = 0; x < width; x++ ){
+                invalidMismatches += ( ( half[y * width + x] == 0.0f ) != ( depth[( y * 2 + 1 ) * depthWidth + x * 2 + 1] == 0.0f ) ) ? 1 : 0;
+            }
+        }
+        CHECK( invalidMismatches == 0 );
+
+#ifdef RESAMPLER_BENCHMARK_OPENCV
+        const cv::Mat depthMat( depthHeight, depthWidth, CV_32FC1, &depth[0] );
+        cv::Mat halfMat( height, width, CV_32FC1 );
+        const double areaTime = Test::measure( iterations, [&](){ cv::resize( depthMat, halfMat, halfMat.size(), 0.0, 0.0, cv::INTER_AREA ); } ) * 1000.0;
+        std::cout << "cv::resize area ( depth ) : " << areaTime << " us" << std::endl;
+#endif
+    }
+
+    // Point Cloud 512 x 424 -> 256 x 212 ( 6 Floats per Pixel )
+    {
+        std::vector<float> pointCloud( static_cast<size_t>( depthWidth ) * depthHeight * 6 );
+        std::uniform_real_distribution<float> uniform( -1.0f, 1.0f );
+        for( float& value : pointCloud ){
+            value = uniform( random );
+        }
+        std::vector<float> half( pointCloud.size() / 4 );
+        Resampler nearest( depthWidth, depthHeight, depthWidth / 2, depthHeight / 2, ResampleFilter_Nearest );
+        const double legacyTime = Test::measure( iterations, [&](){ Legacy::DownsampleFrameNearestNeighbor( &pointCloud[0], depthWidth, depthHeight, &half[0], 2, 6 ); } ) * 1000.0;
+        const double nearestTime = Test::measure( iterations, [&](){ nearest.resampleFloat( &pointCloud[0], depthWidth * 6 * sizeof( float ), &half[0], depthWidth / 2 * 6 * sizeof( float ), 6 ); } ) * 1000.0;
+        std::cout << "Point Cloud 512x424 -> 256x212 : legacy nearest " << legacyTime << " us, nearest " << nearestTime << " us" << std::endl;
+    }
+
+    // Color 512 x 424 -> 1024 x 848 ( Nearest Upsampling Replicates Pixels as Legacy )
+    {
+        std::vector<uint32_t> legacy( depthWidth * depthHeight * 4 );
+        std::vector<uint32_t> upsampled( legacy.size(), 0 );
+        Resampler nearest( depthWidth, depthHeight, depthWidth * 2, depthHeight * 2, ResampleFilter_Nearest );
+        const double legacyTime = Test::measure( iterations, [&](){ Legacy::UpsampleFrameNearestNeighbor( &color[0], depthWidth, depthHeight, &legacy[0], 2 ); } ) * 1000.0;
+        const double nearestTime = Test::measure( iterations, [&](){ nearest.resampleColor( &color[0], depthColorPitch, &upsampled[0], depthColorPitch * 2 ); } ) * 1000.0;
+        std::cout << "Color 512x424 -> 1024x848 : legacy nearest " << legacyTime << " us, nearest " << nearestTime << " us" << std::endl;
+        CHECK( upsampled == legacy );
+    }
+
+    // Box Preserves Mean ( 512 x 424 -> 333 x 277, Non-integer Scale )
+    {
+        std::vector<float> image( depthWidth * depthHeight );
+        std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+        double sourceMean = 0.0;
+        for( float& value : image ){
+            value = uniform( random );
+            sourceMean += value;
+        }
+        sourceMean /= image.size();
+
+        const int width = 333;
+        const int height = 277;
+        std::vector<float> resized( width * height );
+        Resampler box( depthWidth, depthHeight, width, height, ResampleFilter_Box );
+        box.resampleFloat( &image[0], depthWidth * sizeof( float ), &resized[0], width * sizeof( float ) );
+        double mean = 0.0;
+        for( const float value : resized ){
+            mean += value;
+        }
+        mean /= resized.size();
+        std::cout << "Box Mean 512x424 -> 333x277 : " << std::setprecision( 7 ) << sourceMean << " -> " << mean << std::endl;
+        CHECK( std::fabs( mean - sourceMean ) < 1e-5 );
+    }
+
+    return Test::result( "Resampler Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+#include "Test.h"
+#include "ResidualStatistics.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <iomanip>
+
+// Scalar Path of ResidualStatistics ( ResidualStatisticsScalar.cpp )
+namespace Scalar
+{
+#undef __RESIDUAL_STATISTICS__
+#include "ResidualStatistics.h"
+}
+
+// Legacy Functions ( ColorResiduals and CalculateResidualStatistics of KinectFusionHelper on Buffers, Concurrency::parallel_for is Replaced by Thread Pool )
+namespace Legacy
+{
+    template <typename T>
+    inline T clamp( const T& x, const T& a, const T& b )
+    {
+        if( x < a ){
+            return a;
+        }
+        else if( x > b ){
+            return b;
+        }
+        else{
+            return x;
+        }
+    }
+
+    void ColorResiduals( const float* pFloatBuffer, unsigned int* pColorBuffer, const unsigned int width, const unsigned int height )
+    {
+        ThreadPool::global().parallelFor( height, [&]( const size_t y ){
+            unsigned int* pColorRow = pColorBuffer + y * width;
+            const float* pFloatRow = pFloatBuffer + y * width;
+
+            for( unsigned int x = 0; x < width; ++x ){
+                float residue = pFloatRow[x];
+                unsigned int color = 0;
+
+                if( residue <= 1.0f ){ // Pixel byte ordering: ARGB
+                    color |= ( 255 << 24 );                                                                               // a
+                    color |= ( static_cast<unsigned char>( 255.0f * clamp( 1.0f + residue, 0.0f, 1.0f ) ) << 16 );           // r
+                    color |= ( static_cast<unsigned char>( 255.0f * clamp( 1.0f - std::abs( residue ), 0.0f, 1.0f ) ) << 8 ); // g
+                    color |= ( static_cast<unsigned char>( 255.0f * clamp( 1.0f - residue, 0.0f, 1.0f ) ) );                 // b
+                }
+
+                pColorRow[x] = color;
+            }
+        } );
+    }
+
+    void CalculateResidualStatistics( const float* pFloatBuffer, const unsigned int width, const unsigned int height, ResidualStatistics* stats )
+    {
+        // Measurement stats
+        std::vector<unsigned int> zeroPixelsRow;
+        std::vector<unsigned int> validPixelsRow;
+        std::vector<unsigned int> invalidDepthOutsideVolumePixelsRow;
+        std::vector<float> validPixelDistanceRow;
+
+        zeroPixelsRow.resize( height, 0 );
+        validPixelsRow.resize( height, 0 );
+        invalidDepthOutsideVolumePixelsRow.resize( height, 0 );
+        validPixelDistanceRow.resize( height, 0 );
+
+        ThreadPool::global().parallelFor( height, [&]( const size_t y ){
+            const float* pFloatRow = pFloatBuffer + y * width;
+
+            for( unsigned int x = 0; x < width; ++x ){
+                float residue = pFloatRow[x];
+
+                if( residue == 0.0f ){
+                    ++zeroPixelsRow[y];
+                }
+                else if( residue == 2.0f ){
+                    ++invalidDepthOutsideVolumePixelsRow[y];
+                }
+                else if( residue <= 1.0f ){
+                    ++validPixelsRow[y];
+                    validPixelDistanceRow[y] += residue;
+                }
+            }
+        } );
+
+        stats->validPixels = stats->zeroPixels = stats->invalidDepthOutsideVolumePixels = 0;
+        stats->totalValidPixelsDistance = 0;
+        stats->totalPixels = width * height;
+
+        for( unsigned int y = 0; y < height; ++y ){
+            stats->zeroPixels += zeroPixelsRow[y];
+            stats->validPixels += validPixelsRow[y];
+            stats->invalidDepthOutsideVolumePixels += invalidDepthOutsideVolumePixelsRow[y];
+            stats->totalValidPixelsDistance += validPixelDistanceRow[y];
+        }
+    }
+}
+
+// Synthetic Residual Frame ( Mix of Valid Residuals, 0, 2 for Invalid Depth, Values between 1 and 2, and NaN, like AlignDepthFloatToReconstruction )
+std::vector<float> generateResidual( const int width, const int height, const unsigned int seed )
+{
+    std::mt19937 random( seed );
+    std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+    std::vector<float> residual( static_cast<size_t>( width ) * height );
+    for( float& value : residual ){
+        const float kind = uniform( random );
+        if( kind < 0.6f ){
+            value = uniform( random ) * 2.0f - 1.0f;
+        }
+        else if( kind < 0.7f ){
+            value = ( uniform( random ) < 0.5f ) ? 0.0f : -0.0f;
+        }
+        else if( kind < 0.85f ){
+            value = 2.0f;
+        }
+        else if( kind < 0.95f ){
+            value = 1.0f + uniform( random );
+        }
+        else{
+            value = std::numeric_limits<float>::quiet_NaN();
+        }
+    }
+
+    // Boundaries of Classes and Clamping
+    const float boundaries[] = { 1.0f, -1.0f, 0.5f, -0.5f, 1.0f / 255.0f, -1.0f / 255.0f, std::nextafter( 1.0f, 2.0f ), -2.0f };
+    for( size_t i = 0; i < sizeof( boundaries ) / sizeof( boundaries[0] ); i++ ){
+        residual[i * 37] = boundaries[i];
+    }
+
+    // Infinities in First Frame Only ( -inf is Valid, so Distance is -inf )
+    if( seed == 0 ){
+        residual[1] = -std::numeric_limits<float>::infinity();
+        residual[2] = std::numeric_limits<float>::infinity();
+    }
+    return residual;
+}
+
+// Check Counts are Same and Distance is Same up to Order of Float Summation ( -inf Residual is Valid, then Both are -inf )
+template<typename Statistics>
+void checkStatistics( const ResidualStatistics& expected, const Statistics& actual )
+{
+    CHECK( actual.totalPixels == expected.totalPixels );
+    CHECK( actual.zeroPixels == expected.zeroPixels );
+    CHECK( actual.validPixels == expected.validPixels );
+    CHECK( actual.invalidDepthOutsideVolumePixels == expected.invalidDepthOutsideVolumePixels );
+    CHECK( actual.totalValidPixelsDistance == expected.totalValidPixelsDistance || std::fabs( actual.totalValidPixelsDistance - expected.totalValidPixelsDistance ) <= 0.01f + 1e-4f * std::fabs( expected.totalValidPixelsDistance ) );
+}
+
+// Residual Benchmark ( Usage : ResidualBenchmark [iterations] )
+// Classifies and shades synthetic 512 x 424 residual frames with legacy functions of KinectFusionHelper ( Two Passes ),
+// and with fused ShadeResiduals of AVX2 and scalar paths. Colors have to be bit-identical and counts have to match.
+int main( int argc, char* argv[] )
+{
+    const int iterations = Test::iterations( argc, argv, 200 );
+    const int width = 512;
+    const int height = 424;
+    const size_t pitch = width * sizeof( float );
+    const size_t shadedPitch = width * sizeof( uint32_t );
+
+    // Frames
+    const int frameCount = 8;
+    std::vector<std::vector<float>> residuals;
+    for( int frame = 0; frame < frameCount; frame++ ){
+        residuals.push_back( generateResidual( width, height, frame ) );
+    }
+
+    // Check against Legacy Functions
+    std::vector<uint32_t> expectedColors( static_cast<size_t>( width ) * height );
+    std::vector<uint32_t> colors( expectedColors.size() );
+    for( const std::vector<float>& residual : residuals ){
+        ResidualStatistics expected;
+        Legacy::ColorResiduals( &residual[0], &expectedColors[0], width, height );
+        Legacy::CalculateResidualStatistics( &residual[0], width, height, &expected );
+
+        ResidualStatistics statistics;
+        if( IsSupportedAVX2() ){
+            std::fill( colors.begin(), colors.end(), 0xcdcdcdcd );
+            ShadeResiduals( &residual[0], pitch, &colors[0], shadedPitch, width, height, &statistics );
+            CHECK( colors == expectedColors );
+            checkStatistics( expected, statistics );
+        }
+
+        Scalar::ResidualStatistics scalarStatistics;
+        std::fill( colors.begin(), colors.end(), 0xcdcdcdcd );
+        Scalar::ShadeResiduals( &residual[0], pitch, &colors[0], shadedPitch, width, height, &scalarStatistics );
+        CHECK( colors == expectedColors );
+        checkStatistics( expected, scalarStatistics );
+
+        // Statistics Only ( Odd Width, Remainder Pixels of AVX2 Path )
+        Legacy::CalculateResidualStatistics( &residual[0], width - 3, height, &expected );
+        ShadeResiduals( &residual[0], ( width - 3 ) * sizeof( float ), nullptr, 0, width - 3, height, &statistics );
+        checkStatistics( expected, statistics );
+    }
+
+    // Measure [us per Frame]
+    int frame = 0;
+    ResidualStatistics statistics;
+    const double legacyTime = Test::measure( iterations, [&](){
+        const std::vector<float>& residual = residuals[frame++ % frameCount];
+        Legacy::ColorResiduals( &residual[0], &colors[0], width, height );
+        Legacy::CalculateResidualStatistics( &residual[0], width, height, &statistics );
+    } ) * 1000.0;
+    const double legacyStatisticsTime = Test::measure( iterations, [&](){
+        Legacy::CalculateResidualStatistics( &residuals[frame++ % frameCount][0], width, height, &statistics );
+    } ) * 1000.0;
+    const double fusedTime = Test::measure( iterations, [&](){
+        ShadeResiduals( &residuals[frame++ % frameCount][0], pitch, &colors[0], shadedPitch, width, height, &statistics );
+    } ) * 1000.0;
+    const double statisticsTime = Test::measure( iterations, [&](){
+        ShadeResiduals( &residuals[frame++ % frameCount][0], pitch, nullptr, 0, width, height, &statistics );
+    } ) * 1000.0;
+    Scalar::ResidualStatistics scalarStatistics;
+    const double scalarTime = Test::measure( iterations, [&](){
+        Scalar::ShadeResiduals( &residuals[frame++ % frameCount][0], pitch, &colors[0], shadedPitch, width, height, &scalarStatistics );
+    } ) * 1000.0;
+
+    std::cout << std::fixed << std::setprecision( 1 );
+    std::cout << "Legacy ColorResiduals + CalculateResidualStatistics : " << legacyTime << " us" << std::endl;
+    std::cout << "Fused " << ( IsSupportedAVX2() ? "AVX2" : "Scalar" ) << " : " << fusedTime << " us ( Scalar Path " << scalarTime << " us )" << std::endl;
+    std::cout << "Statistics Only : " << legacyStatisticsTime << " us -> " << statisticsTime << " us" << std::endl;
+
+    return Test::result( "Residual Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+// Scalar Path of ResidualStatistics ( ResidualStatistics.cpp is Compiled in Namespace Scalar with AVX2 Disabled, for Comparison with AVX2 Path )
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Scalar
+{
+#define IsSupportedAVX2() false
+#include "ResidualStatistics.h"
+#include "ResidualStatistics.cpp"
+#undef IsSupportedAVX2
+}
\ No newline at end of file
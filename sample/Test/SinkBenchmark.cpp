@@ -0,0 +1,89 @@
+#include "Test.h"
+#include "Pipeline.h"
+#include "SyntheticSource.h"
+#include "FrameSink.h"
+#include "Yuy2.h"
+
+#include <opencv2/core.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <string>
+#include <memory>
+#include <iomanip>
+
+// Sink Benchmark
+// Runs the frame loop of Color sample ( Synthetic YUY2 1920 x 1080 -> Half Resolution BGR -> Frame Sink ) on Pipeline
+// as fast as possible, and measures throughput of presented frames. Default sink is null, that measures frame processing without GUI.
+class SinkBenchmark
+{
+private:
+    // Synthetic Source ( As Fast As Possible )
+    SyntheticSource synthetic;
+
+    // Frame Sink
+    std::unique_ptr<FrameSink> sink;
+
+    // Frame
+    struct Frame
+    {
+        std::vector<uint8_t> colorBuffer;
+        cv::Mat colorMat;
+    };
+
+    // Pipeline
+    Pipeline<Frame> pipeline;
+
+    // Number of Frames
+    uint64_t frames;
+
+public:
+    // Constructor ( Frame Sink Specification, see CreateFrameSink(), and Number of Frames )
+    SinkBenchmark( const std::string& sink, const uint64_t frames )
+        : synthetic( 0.0 ),
+          sink( CreateFrameSink( sink ) ),
+          frames( frames )
+    {
+        pipeline.forEachFrame( [&]( Frame& frame ){
+            frame.colorBuffer.resize( SyntheticSource::colorWidth * SyntheticSource::colorHeight * 2 );
+            frame.colorMat.create( SyntheticSource::colorHeight / 2, SyntheticSource::colorWidth / 2, CV_8UC3 );
+        } );
+    }
+
+    // Processing ( Returns Presented Frames per Second )
+    double run()
+    {
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        pipeline.run(
+            // Update Data
+            [&]( Frame& frame ){ return synthetic.acquireColor( &frame.colorBuffer[0] ); },
+            // Draw Data
+            [&]( Frame& frame ){ Yuy2::convertToHalfBGR( &frame.colorBuffer[0], SyntheticSource::colorWidth, SyntheticSource::colorHeight, frame.colorMat.data ); },
+            // Show Data
+            [&]( Frame& frame ){ sink->write( "Color", frame.colorMat ); },
+            // Poll Sink and Check Number of Frames
+            [&](){ return sink->poll() && pipeline.statistics( PipelineStage_Present ).frames < frames; }
+        );
+        const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+
+        pipeline.printStatistics( std::cout );
+        std::cout << "Sink : " << sink->images() << " images, " << sink->size() / ( 1024.0 * 1024.0 ) << " MB" << std::endl;
+
+        CHECK( sink->images() == pipeline.statistics( PipelineStage_Present ).frames );
+        return pipeline.statistics( PipelineStage_Present ).frames / seconds;
+    }
+};
+
+// Sink Benchmark ( Usage : SinkBenchmark [frames] [sink], e.g. SinkBenchmark 1000 shm:bench )
+int main( int argc, char* argv[] )
+{
+    const int frames = Test::iterations( argc, argv, 300 );
+    const std::string sink = ( argc > 2 ) ? argv[2] : "null";
+
+    SinkBenchmark benchmark( sink, frames );
+    const double fps = benchmark.run();
+    std::cout << std::fixed << std::setprecision( 1 );
+    std::cout << "Throughput ( " << sink << " sink ) : " << fps << " frames/s" << std::endl;
+
+    return Test::result( "Sink Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef __SYNTHETIC_DEPTH__
+#define __SYNTHETIC_DEPTH__
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+// Synthetic Depth
+// Kinect v2 like depth sequence of a room ( floor, back wall and box ) with a sphere moving in front of it.
+// Depth has noise that grows with distance, and invalid ( 0 ) pixels at the shadow of the sphere, out of range and random dropouts.
+class SyntheticDepth
+{
+private:
+    int width;
+    int height;
+    float focalLength;
+    float noise;
+    std::mt19937 random;
+
+public:
+    // Constructor ( Noise Scale 0 = Noise Free )
+    SyntheticDepth( const int width = 512, const int height = 424, const float noise = 1.0f, const unsigned int seed = 0 )
+        : width( width ), height( height ), focalLength( 365.5f * width / 512.0f ), noise( noise ), random( seed )
+    {
+    }
+
+    // Generate Depth of Frame [mm]
+    void generate( const int frame, uint16_t* depth )
+    {
+        std::normal_distribution<float> gaussian( 0.0f, 1.0f );
+        std::uniform_real_distribution<float> uniform( 0.0f, 1.0f );
+
+        // Sphere ( Moving Left and Right at 1.5-2.5 m )
+        const float time = frame / 30.0f;
+        const float sphereX = 0.6f * std::sin( time );
+        const float sphereY = 0.1f;
+        const float sphereZ = 2.0f + 0.5f * std::cos( time * 0.7f );
+        const float sphereRadius = 0.35f;
+
+        for( int y = 0; y < height; y++ ){
+            for( int x = 0; x < width; x++ ){
+                const float rayX = ( x - width * 0.5f ) / focalLength;
+                const float rayY = ( y - height * 0.5f ) / focalLength;
+
+                // Back Wall ( 4.2 m ), Floor ( 1.0 m below Sensor ) and Box on Floor
+                float z = 4.2f;
+                if( rayY > 0.0f ){
+                    z = std::min( z, 1.0f / rayY );
+                }
+                const float boxZ = 3.0f;
+                if( -0.9f < rayX * boxZ && rayX * boxZ < -0.3f && 0.6f < rayY * boxZ && rayY * boxZ < 1.0f ){
+                    z = std::min( z, boxZ );
+                }
+
+                // Sphere ( Nearest Intersection of Ray )
+                const float b = rayX * sphereX + rayY * sphereY + sphereZ;
+                const float a = rayX * rayX + rayY * rayY + 1.0f;
+                const float c = sphereX * sphereX + sphereY * sphereY + sphereZ * sphereZ - sphereRadius * sphereRadius;
+                const float discriminant = b * b - a * c;
+                bool sphere = false;
+                if( discriminant > 0.0f ){
+                    const float t = ( b - std::sqrt( discriminant ) ) / a;
+                    if( t < z ){
+                        z = t;
+                        sphere = true;
+                    }
+                }
+
+                // Shadow of Sphere ( Emitter is 5 cm Left of Sensor ), Out of Range and Dropouts
+                const float shadowX = rayX - 0.05f / z + 0.05f / sphereZ;
+                const float shadowB = shadowX * sphereX + rayY * sphereY + sphereZ;
+                const float shadowA = shadowX * shadowX + rayY * rayY + 1.0f;
+                const bool shadow = !sphere && shadowB * shadowB - shadowA * c > 0.0f;
+                const bool dropout = uniform( random ) < 0.01f;
+                if( shadow || dropout || 4.5f < z ){
+                    depth[y * width + x] = 0;
+                    continue;
+                }
+
+                // Noise ( Standard Deviation about 1 mm at 1 m and 5 mm at 4 m )
+                const float deviation = noise * ( 0.5f + 0.3f * z * z );
+                const float value = z * 1000.0f + deviation * gaussian( random );
+                depth[y * width + x] = static_cast<uint16_t>( std::max( 500.0f, std::round( value ) ) );
+            }
+        }
+    }
+
+    // Generate Depth of Frame [mm]
+    std::vector<uint16_t> generate( const int frame )
+    {
+        std::vector<uint16_t> depth( static_cast<size_t>( width ) * height );
+        generate( frame, &depth[0] );
+        return depth;
+    }
+
+    // Retrieve Frame Size
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+#endif // __SYNTHETIC_DEPTH__
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef __TEST__
+#define __TEST__
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+// Check Condition ( Failed Condition is Printed with Location, and Fails the Test at End )
+#define CHECK( condition ) Test::check( ( condition ), #condition, __FILE__, __LINE__ )
+
+// Test
+// Tests and benchmarks compile the helpers of the sample directories, and run on synthetic data without sensor.
+// Each test is an executable registered to CTest, that returns non-zero if any check failed.
+namespace Test
+{
+    // Number of Failed Checks
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    // Check Condition
+    inline bool check( const bool condition, const char* expression, const char* file, const int line )
+    {
+        if( !condition ){
+            std::cout << file << "(" << line << ") : check failed : " << expression << std::endl;
+            failures()++;
+        }
+        return condition;
+    }
+
+    // Retrieve Result ( Exit Code of Test )
+    inline int result( const std::string& name )
+    {
+        std::cout << name << " : " << ( ( failures() == 0 ) ? "passed" : "failed" ) << std::endl;
+        return ( failures() == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    // Retrieve Number of Iterations of Benchmark ( Command Line Argument, Default is Short Enough for CTest )
+    inline int iterations( const int argc, char* argv[], const int iterations )
+    {
+        return ( argc > 1 ) ? std::max( std::atoi( argv[1] ), 1 ) : iterations;
+    }
+
+    // Measure Average Time of Function [ms] ( after One Warm-up Call )
+    template<typename Function>
+    double measure( const int iterations, Function function )
+    {
+        function();
+
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        for( int iteration = 0; iteration < iterations; iteration++ ){
+            function();
+        }
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        return std::chrono::duration<double, std::milli>( end - begin ).count() / iterations;
+    }
+}
+
+#endif // __TEST__
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "Test.h"
+#include "SyntheticDepth.h"
+#include "TsdfVolume.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <memory>
+#include <iomanip>
+#include <thread>
+
+#ifdef TSDF_BENCHMARK_NUIFUSION
+#include <Windows.h>
+#include <NuiKinectFusionApi.h>
+#include <cstring>
+#include "KinectFusionHelper.h"
+#include "util.h"
+#endif
+
+// Scalar Path of TsdfVolume ( TsdfVolumeScalar.cpp )
+namespace Scalar
+{
+#undef __TSDF_VOLUME__
+#include "TsdfVolume.h"
+}
+
+// Volume ( Same as Fusion Sample, 512 x 384 x 512 Voxels at 256 Voxels per Meter )
+const int voxelCountX = 512;
+const int voxelCountY = 384;
+const int voxelCountZ = 512;
+const float voxelsPerMeter = 256.0f;
+
+// Depth Frame ( Kinect v2 Depth Resolution, Camera Normalized by Image Size as NUI_FUSION_CAMERA_PARAMETERS )
+const int width = 512;
+const int height = 424;
+const FusionCamera camera = { 365.5f / width, 365.5f / height, 0.5f, 0.5f };
+
+// Measure Integration of Frames [ms per Frame]
+template<typename Volume, typename Frame>
+double measure( Volume& volume, const std::vector<std::vector<float>>& frames )
+{
+    Frame frame;
+    frame.color = nullptr;
+    frame.width = width;
+    frame.height = height;
+    frame.camera = camera;
+    frame.worldToCamera = IdentityMatrix4f();
+
+    size_t index = 0;
+    return Test::measure( static_cast<int>( frames.size() ), [&](){
+        frame.depth = &frames[index++ % frames.size()][0];
+        volume.integrate( frame );
+    } );
+}
+
+#ifdef TSDF_BENCHMARK_NUIFUSION
+// Measure Integration of Kinect Fusion ( NuiFusionCreateColorReconstruction, Same Volume and Frames ) [ms per Frame]
+double measureKinectFusion( const NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE processor, const std::vector<std::vector<float>>& frames )
+{
+    NUI_FUSION_RECONSTRUCTION_PARAMETERS reconstructionParameters;
+    reconstructionParameters.voxelsPerMeter = voxelsPerMeter;
+    reconstructionParameters.voxelCountX = voxelCountX;
+    reconstructionParameters.voxelCountY = voxelCountY;
+    reconstructionParameters.voxelCountZ = voxelCountZ;
+
+    Matrix4 worldToCameraTransform;
+    SetIdentityMatrix( worldToCameraTransform );
+
+    INuiFusionColorReconstruction* reconstruction;
+    ERROR_CHECK( NuiFusionCreateColorReconstruction( &reconstructionParameters, processor, -1, &worldToCameraTransform, &reconstruction ) );
+
+    NUI_FUSION_CAMERA_PARAMETERS cameraParameters;
+    cameraParameters.focalLengthX = camera.focalLengthX;
+    cameraParameters.focalLengthY = camera.focalLengthY;
+    cameraParameters.principalPointX = camera.principalPointX;
+    cameraParameters.principalPointY = camera.principalPointY;
+
+    std::vector<NUI_FUSION_IMAGE_FRAME*> depthImageFrames( frames.size() );
+    for( size_t i = 0; i < frames.size(); i++ ){
+        ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_FLOAT, width, height, &cameraParameters, &depthImageFrames[i] ) );
+        std::memcpy( depthImageFrames[i]->pFrameBuffer->pBits, &frames[i][0], frames[i].size() * sizeof( float ) );
+    }
+    NUI_FUSION_IMAGE_FRAME* colorImageFrame;
+    ERROR_CHECK( NuiFusionCreateImageFrame( NUI_FUSION_IMAGE_TYPE::NUI_FUSION_IMAGE_TYPE_COLOR, width, height, &cameraParameters, &colorImageFrame ) );
+
+    size_t index = 0;
+    const double time = Test::measure( static_cast<int>( frames.size() ), [&](){
+        ERROR_CHECK( reconstruction->IntegrateFrame( depthImageFrames[index++ % frames.size()], colorImageFrame, NUI_FUSION_DEFAULT_INTEGRATION_WEIGHT, NUI_FUSION_DEFAULT_COLOR_INTEGRATION_OF_ALL_ANGLES, &worldToCameraTransform ) );
+    } );
+
+    for( NUI_FUSION_IMAGE_FRAME* depthImageFrame : depthImageFrames ){
+        NuiFusionReleaseImageFrame( depthImageFrame );
+    }
+    NuiFusionReleaseImageFrame( colorImageFrame );
+    reconstruction->Release();
+    return time;
+}
+#endif
+
+// TSDF Benchmark ( Usage : TsdfBenchmark [frames] )
+// Integrates synthetic depth into the dense volume of Fusion sample with AVX2 and scalar paths, and with Kinect Fusion if available.
+// Throughput is voxels of whole volume per second ( Same Measure as Kinect Fusion ), both paths have to produce same volume.
+int main( int argc, char* argv[] )
+{
+    const int count = Test::iterations( argc, argv, 5 );
+    const double voxelCount = static_cast<double>( voxelCountX ) * voxelCountY * voxelCountZ;
+
+    // Synthetic Depth [m]
+    SyntheticDepth synthetic( width, height );
+    std::vector<std::vector<float>> frames( count );
+    for( int i = 0; i < count; i++ ){
+        const std::vector<uint16_t> depth = synthetic.generate( i );
+        frames[i].resize( depth.size() );
+        for( size_t index = 0; index < depth.size(); index++ ){
+            frames[i][index] = depth[index] * 0.001f;
+        }
+    }
+
+    std::cout << "Volume : " << voxelCountX << " x " << voxelCountY << " x " << voxelCountZ << " at " << voxelsPerMeter << " voxels/m, "
+              << std::thread::hardware_concurrency() << " threads" << std::endl;
+    std::cout << std::fixed << std::setprecision( 3 );
+
+    // Dispatched Path ( AVX2 if Supported )
+    std::unique_ptr<TsdfVolume> volume( new TsdfVolume( voxelCountX, voxelCountY, voxelCountZ, DefaultTsdfParameters( voxelsPerMeter ) ) );
+    const double time = measure<TsdfVolume, TsdfFrame>( *volume, frames );
+    std::cout << ( IsSupportedAVX2() ? "AVX2" : "Scalar" ) << " : " << time << " ms/frame, " << voxelCount / time * 1e-6 << " Gvoxel/s" << std::endl;
+
+    // Scalar Path
+    if( IsSupportedAVX2() ){
+        std::unique_ptr<Scalar::TsdfVolume> scalarVolume( new Scalar::TsdfVolume( voxelCountX, voxelCountY, voxelCountZ, Scalar::DefaultTsdfParameters( voxelsPerMeter ) ) );
+        const double scalarTime = measure<Scalar::TsdfVolume, Scalar::TsdfFrame>( *scalarVolume, frames );
+        std::cout << "Scalar : " << scalarTime << " ms/frame, " << voxelCount / scalarTime * 1e-6 << " Gvoxel/s ( AVX2 x" << scalarTime / time << " )" << std::endl;
+
+        // Compare Volumes ( Same Math, Bit-exact with -ffp-contract=off )
+        // AVX2 path may contract multiply-add into FMA, so voxels projected within rounding error of a pixel boundary may select the neighbour pixel.
+        int maxDifference = 0;
+        uint64_t weightDifferences = 0;
+        uint64_t observed = 0;
+        volume->forEachBrick( [&]( const int x, const int y, const int z, const TsdfBrick& brick ){
+            const Scalar::TsdfBrick* scalarBrick = scalarVolume->findBrick( x, y, z );
+            for( int i = 0; i < TsdfBrick::voxelCount; i++ ){
+                maxDifference = std::max( maxDifference, std::abs( brick.tsdf[i] - scalarBrick->tsdf[i] ) );
+                weightDifferences += ( brick.weight[i] != scalarBrick->weight[i] ) ? 1 : 0;
+                observed += ( brick.weight[i] != 0 ) ? 1 : 0;
+            }
+        } );
+        CHECK( observed > 0 );
+        CHECK( weightDifferences <= observed / 10000 );
+        CHECK( maxDifference <= 64 );
+        std::cout << "Observed Voxels : " << observed << ", Max Distance Difference : " << maxDifference << " / 32767, Weight Differences : " << weightDifferences << std::endl;
+    }
+
+#ifdef TSDF_BENCHMARK_NUIFUSION
+    // Kinect Fusion ( AMP as Fusion Sample, and CPU )
+    const NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE processors[] = { NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE_AMP, NUI_FUSION_RECONSTRUCTION_PROCESSOR_TYPE_CPU };
+    const char* names[] = { "AMP", "CPU" };
+    for( int i = 0; i < 2; i++ ){
+        try{
+            const double fusionTime = measureKinectFusion( processors[i], frames );
+            std::cout << "Kinect Fusion ( " << names[i] << " ) : " << fusionTime << " ms/frame, " << voxelCount / fusionTime * 1e-6 << " Gvoxel/s" << std::endl;
+        } catch( std::exception& ex ){
+            std::cout << "Kinect Fusion ( " << names[i] << " ) : skipped ( " << ex.what() << " )" << std::endl;
+        }
+    }
+#endif
+
+    return Test::result( "TSDF Benchmark" );
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+// Scalar Path of TsdfVolume ( TsdfVolume.cpp is Compiled in Namespace Scalar with AVX2 Disabled, for Comparison with AVX2 Path )
+#include "FusionMath.h"
+#include "ThreadPool.h"
+#include "simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+namespace Scalar
+{
+#define IsSupportedAVX2() false
+#include "TsdfVolume.h"
+#include "TsdfVolume.cpp"
+#undef IsSupportedAVX2
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "Test.h"
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+// Each Code Path of Yuy2 ( Yuy2.h is Included in Namespace with Higher Instruction Sets Disabled )
+#include "simd.h"
+#include "Yuy2.h"
+
+namespace SSE41
+{
+#undef __YUY2__
+#define IsSupportedAVX2() false
+#include "Yuy2.h"
+#undef IsSupportedAVX2
+}
+
+namespace Scalar
+{
+#undef __YUY2__
+#define IsSupportedAVX2() false
+#define IsSupportedSSE41() false
+#include "Yuy2.h"
+#undef IsSupportedAVX2
+#undef IsSupportedSSE41
+}
+
+// Reference Conversion ( Formula of Yuy2.h, Pixel by Pixel )
+namespace Reference
+{
+    uint8_t clip( const int value )
+    {
+        return static_cast<uint8_t>( std::min( std::max( value, 0 ), 255 ) );
+    }
+
+    void convertPixel( const int y, const int u, const int v, uint8_t* bgr )
+    {
+        bgr[0] = clip( ( 298 * ( y - 16 ) + 516 * ( u - 128 ) + 128 ) >> 8 );
+        bgr[1] = clip( ( 298 * ( y - 16 ) - 100 * ( u - 128 ) - 208 * ( v - 128 ) + 128 ) >> 8 );
+        bgr[2] = clip( ( 298 * ( y - 16 ) + 409 * ( v - 128 ) + 128 ) >> 8 );
+    }
+
+    std::vector<uint8_t> convertToBGRA( const std::vector<uint8_t>& yuy2, const int width, const int x, const int y, const int roiWidth, const int roiHeight )
+    {
+        std::vector<uint8_t> bgra( static_cast<size_t>( roiWidth ) * roiHeight * 4 );
+        for( int row = 0; row < roiHeight; row++ ){
+            for( int column = 0; column < roiWidth; column++ ){
+                const uint8_t* pair = &yuy2[( static_cast<size_t>( y + row ) * width + ( ( x + column ) & ~1 ) ) * 2];
+                uint8_t* dst = &bgra[( static_cast<size_t>( row ) * roiWidth + column ) * 4];
+                convertPixel( pair[( ( x + column ) & 1 ) * 2], pair[1], pair[3], dst );
+                dst[3] = 255;
+            }
+        }
+        return bgra;
+    }
+
+    std::vector<uint8_t> convertToGray( const std::vector<uint8_t>& yuy2, const int width, const int x, const int y, const int roiWidth, const int roiHeight )
+    {
+        std::vector<uint8_t> gray( static_cast<size_t>( roiWidth ) * roiHeight );
+        for( int row = 0; row < roiHeight; row++ ){
+            for( int column = 0; column < roiWidth; column++ ){
+                gray[static_cast<size_t>( row ) * roiWidth + column] = yuy2[( static_cast<size_t>( y + row ) * width + x + column ) * 2];
+            }
+        }
+        return gray;
+    }
+
+    std::vector<uint8_t> convertToHalfBGR( const std::vector<uint8_t>& yuy2, const int width, const int height )
+    {
+        const int halfWidth = width / 2;
+        const int halfHeight = height / 2;
+        std::vector<uint8_t> bgr( static_cast<size_t>( halfWidth ) * halfHeight * 3 );
+        for( int row = 0; row < halfHeight; row++ ){
+            for( int column = 0; column < halfWidth; column++ ){
+                const uint8_t* a = &yuy2[( static_cast<size_t>( row * 2 ) * width + column * 2 ) * 2];
+                const uint8_t* b = a + static_cast<size_t>( width ) * 2;
+                const int y = ( a[0] + a[2] + b[0] + b[2] + 2 ) >> 2;
+                const int u = ( a[1] + b[1] + 1 ) >> 1;
+                const int v = ( a[3] + b[3] + 1 ) >> 1;
+                convertPixel( y, u, v, &bgr[( static_cast<size_t>( row ) * halfWidth + column ) * 3] );
+            }
+        }
+        return bgr;
+    }
+}
+
+// Check Conversions of Code Path against Reference ( Destination has Guard Bytes to Detect Overrun )
+template<typename Converter>
+void checkPath( const std::vector<uint8_t>& yuy2, const int width, const int height, const int x, const int y, const int roiWidth, const int roiHeight )
+{
+    const size_t guard = 64;
+    const uint8_t pattern = 0xcd;
+
+    std::vector<uint8_t> bgra( static_cast<size_t>( roiWidth ) * roiHeight * 4 + guard, pattern );
+    Converter::convertToBGRA( &yuy2[0], width, height, x, y, roiWidth, roiHeight, &bgra[0] );
+    const std::vector<uint8_t> referenceBGRA = Reference::convertToBGRA( yuy2, width, x, y, roiWidth, roiHeight );
+    CHECK( std::equal( referenceBGRA.begin(), referenceBGRA.end(), bgra.begin() ) );
+    CHECK( std::all_of( bgra.end() - guard, bgra.end(), [&]( const uint8_t value ){ return value == pattern; } ) );
+
+    std::vector<uint8_t> gray( static_cast<size_t>( roiWidth ) * roiHeight + guard, pattern );
+    Converter::convertToGray( &yuy2[0], width, height, x, y, roiWidth, roiHeight, &gray[0] );
+    const std::vector<uint8_t> referenceGray = Reference::convertToGray( yuy2, width, x, y, roiWidth, roiHeight );
+    CHECK( std::equal( referenceGray.begin(), referenceGray.end(), gray.begin() ) );
+    CHECK( std::all_of( gray.end() - guard, gray.end(), [&]( const uint8_t value ){ return value == pattern; } ) );
+
+    std::vector<uint8_t> bgr( static_cast<size_t>( width / 2 ) * ( height / 2 ) * 3 + guard, pattern );
+    Converter::convertToHalfBGR( &yuy2[0], width, height, &bgr[0] );
+    const std::vector<uint8_t> referenceBGR = Reference::convertToHalfBGR( yuy2, width, height );
+    CHECK( std::equal( referenceBGR.begin(), referenceBGR.end(), bgr.begin() ) );
+    CHECK( std::all_of( bgr.end() - guard, bgr.end(), [&]( const uint8_t value ){ return value == pattern; } ) );
+}
+
+// Check All Code Paths Supported by CPU
+void check( const std::vector<uint8_t>& yuy2, const int width, const int height, const int x, const int y, const int roiWidth, const int roiHeight )
+{
+    if( IsSupportedAVX2() ){
+        checkPath<Yuy2>( yuy2, width, height, x, y, roiWidth, roiHeight );
+    }
+    if( IsSupportedSSE41() ){
+        checkPath<SSE41::Yuy2>( yuy2, width, height, x, y, roiWidth, roiHeight );
+    }
+    checkPath<Scalar::Yuy2>( yuy2, width, height, x, y, roiWidth, roiHeight );
+}
+
+int main()
+{
+    std::cout << "Code Paths : " << ( IsSupportedAVX2() ? "AVX2, " : "" ) << ( IsSupportedSSE41() ? "SSE4.1, " : "" ) << "Scalar" << std::endl;
+
+    // All Combinations of Y, U and V ( Each Pair has Y0 = 2n and Y1 = 2n + 1 )
+    {
+        const int width = 4096;
+        const int height = 4096;
+        std::vector<uint8_t> yuy2( static_cast<size_t>( width ) * height * 2 );
+        for( size_t pair = 0; pair < yuy2.size() / 4; pair++ ){
+            yuy2[pair * 4 + 0] = static_cast<uint8_t>( ( pair >> 16 ) << 1 );
+            yuy2[pair * 4 + 1] = static_cast<uint8_t>( pair );
+            yuy2[pair * 4 + 2] = static_cast<uint8_t>( ( ( pair >> 16 ) << 1 ) | 1 );
+            yuy2[pair * 4 + 3] = static_cast<uint8_t>( pair >> 8 );
+        }
+        check( yuy2, width, height, 0, 0, width, height );
+    }
+
+    // Random Frames and ROIs ( Odd Origin, Widths not Multiple of SIMD Width, Empty ROI )
+    std::mt19937 random( 0 );
+    for( int iteration = 0; iteration < 200; iteration++ ){
+        const int width = 2 * ( 1 + random() % 80 );
+        const int height = 1 + random() % 9;
+        std::vector<uint8_t> yuy2( static_cast<size_t>( width ) * height * 2 );
+        for( uint8_t& value : yuy2 ){
+            value = static_cast<uint8_t>( random() );
+        }
+
+        const int x = random() % width;
+        const int y = random() % height;
+        const int roiWidth = random() % ( width - x + 1 );
+        const int roiHeight = random() % ( height - y + 1 );
+        check( yuy2, width, height, x, y, roiWidth, roiHeight );
+    }
+
+    // Invalid Frame and ROI
+    {
+        std::vector<uint8_t> yuy2( 16 * 4 * 2 );
+        std::vector<uint8_t> bgra( 16 * 4 * 4 );
+        int thrown = 0;
+        const int rois[][6] = { { 15, 4, 0, 0, 15, 4 }, { 16, 4, -1, 0, 4, 4 }, { 16, 4, 0, 0, 17, 4 }, { 16, 4, 8, 2, 9, 2 }, { 16, 4, 0, 3, 16, 2 } };
+        for( const auto& roi : rois ){
+            try{
+                Yuy2::convertToBGRA( &yuy2[0], roi[0], roi[1], roi[2], roi[3], roi[4], roi[5], &bgra[0] );
+            } catch( std::invalid_argument& ){
+                thrown++;
+            }
+        }
+        CHECK( thrown == 5 );
+    }
+
+    return Test::result( "Yuy2 Test" );
+}
\ No newline at end of file